@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Texel throughput benchmark of color space conversion kernels in image-util.
+//
+// Each kernel is also compared against a naive per-texel reference
+// implementation and the max absolute error is reported.
+//
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "image-util.hh"
+#include "value-types.hh"
+
+namespace {
+
+float RefSrgbToLinear(float x) {
+  if (x <= 0.0f) {
+    return 0.0f;
+  } else if (x >= 1.0f) {
+    return 1.0f;
+  } else if (x < 0.04045f) {
+    return x / 12.92f;
+  }
+  return std::pow((x + 0.055f) / 1.055f, 2.4f);
+}
+
+float RefRec709ToLinear(float V) {
+  if (V < 0.081f) {
+    return V / 4.5f;
+  }
+  return std::pow((V + 0.099f) / 1.099f, (1.0f / 0.45f));
+}
+
+struct KernelResult {
+  std::string name;
+  bool ok{false};
+  double min_ms{0.0};
+  double max_abs_err{0.0};
+};
+
+template <typename F>
+double MeasureMinMs(uint32_t iterations, F &&f, bool *ok) {
+  double min_ms = 0.0;
+  (*ok) = true;
+  for (uint32_t i = 0; i < iterations; i++) {
+    auto s = std::chrono::steady_clock::now();
+    if (!f()) {
+      (*ok) = false;
+      return 0.0;
+    }
+    auto e = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(e - s).count();
+    min_ms = (i == 0) ? ms : (std::min)(min_ms, ms);
+  }
+  return min_ms;
+}
+
+template <typename T, typename U>
+double MaxAbsError(const std::vector<T> &a, const std::vector<U> &b) {
+  double err = 0.0;
+  size_t n = (std::min)(a.size(), b.size());
+  for (size_t i = 0; i < n; i++) {
+    err = (std::max)(err, std::fabs(double(a[i]) - double(b[i])));
+  }
+  return err;
+}
+
+void print_help() {
+  std::cout << "Usage: image_benchmark_tinyusdz [options]\n";
+  std::cout << "  --width N         Image width(default 4096)\n";
+  std::cout << "  --height N        Image height(default 4096)\n";
+  std::cout << "  --iterations N    # of iterations for each kernel(default 3)\n";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t width = 4096;
+  size_t height = 4096;
+  uint32_t iterations = 3;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if ((arg == "-h") || (arg == "--help")) {
+      print_help();
+      return EXIT_SUCCESS;
+    } else if ((arg == "--width") && ((i + 1) < argc)) {
+      width = (std::max)(size_t(1), size_t(std::strtoul(argv[++i], nullptr, 10)));
+    } else if ((arg == "--height") && ((i + 1) < argc)) {
+      height = (std::max)(size_t(1), size_t(std::strtoul(argv[++i], nullptr, 10)));
+    } else if ((arg == "--iterations") && ((i + 1) < argc)) {
+      iterations = (std::max)(1u, uint32_t(std::strtoul(argv[++i], nullptr, 10)));
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      print_help();
+      return EXIT_FAILURE;
+    }
+  }
+
+  const size_t channels = 4;
+  const size_t num_texels = width * height * channels;
+
+  // Synthetic RGBA images.
+  std::vector<uint8_t> img_u8(num_texels);
+  std::vector<float> img_f32(num_texels);
+  std::vector<tinyusdz::value::half> img_f16(num_texels);
+  for (size_t i = 0; i < num_texels; i++) {
+    uint8_t v = uint8_t((i * 2654435761ull) >> 24);
+    img_u8[i] = v;
+    img_f32[i] = float(v) / 255.0f;
+    img_f16[i] = tinyusdz::value::float_to_half_full(img_f32[i]);
+  }
+
+  std::vector<KernelResult> results;
+  std::string err;
+
+  {
+    KernelResult r;
+    r.name = "srgb_8bit_to_linear_f32";
+    std::vector<float> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::srgb_8bit_to_linear_f32(img_u8, width, height, 3, 4, &out, &err);
+    }, &r.ok);
+    std::vector<float> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i++) {
+      float f = float(img_u8[i]) / 255.0f;
+      ref[i] = ((i % 4) == 3) ? f : RefSrgbToLinear(f);
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  {
+    KernelResult r;
+    r.name = "srgb_8bit_to_linear_8bit";
+    std::vector<uint8_t> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::srgb_8bit_to_linear_8bit(img_u8, width, height, 3, 4, &out, &err);
+    }, &r.ok);
+    std::vector<uint8_t> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i++) {
+      float f = RefSrgbToLinear(float(img_u8[i]) / 255.0f);
+      ref[i] = ((i % 4) == 3) ? img_u8[i] : uint8_t((std::max)(0, (std::min)(int(f * 255.0f), 255)));
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  {
+    KernelResult r;
+    r.name = "rec709_8bit_to_linear_f32";
+    std::vector<float> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::rec709_8bit_to_linear_f32(img_u8, width, 0, height, 3, 4, &out, &err);
+    }, &r.ok);
+    std::vector<float> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i++) {
+      float f = float(img_u8[i]) / 255.0f;
+      ref[i] = ((i % 4) == 3) ? f : RefRec709ToLinear(f);
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  {
+    KernelResult r;
+    r.name = "linear_f32_to_srgb_8bit";
+    std::vector<uint8_t> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::linear_f32_to_srgb_8bit(img_f32, width, height, 3, 4, &out, &err);
+    }, &r.ok);
+    std::vector<float> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i++) {
+      float x = img_f32[i];
+      float v = (x < 0.0031308f) ? x * 12.92f : std::pow(x, 1.0f / 2.4f) * 1.055f - 0.055f;
+      ref[i] = ((i % 4) == 3) ? float(int(x * 255.0f)) : std::round(v * 255.0f);
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  {
+    KernelResult r;
+    r.name = "displayp3_f16_to_linear_f32";
+    std::vector<float> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::displayp3_f16_to_linear_f32(img_f16, width, height, 3, 4, &out, 1.0f, 0.0f, 1.0f, 0.0f, &err);
+    }, &r.ok);
+    std::vector<float> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i++) {
+      float f = tinyusdz::value::half_to_float(img_f16[i]);
+      ref[i] = ((i % 4) == 3) ? f : RefSrgbToLinear(f);
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  {
+    KernelResult r;
+    r.name = "linear_sRGB_to_ACEScg";
+    std::vector<float> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::linear_sRGB_to_ACEScg(img_f32, width, height, channels, &out, &err);
+    }, &r.ok);
+    std::vector<float> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i += 4) {
+      float cr = img_f32[i + 0], cg = img_f32[i + 1], cb = img_f32[i + 2];
+      ref[i + 0] = (std::max)(0.0f, 0.6130973f * cr + 0.33952285f * cg + 0.04737928f * cb);
+      ref[i + 1] = (std::max)(0.0f, 0.07019422f * cr + 0.91635557f * cg + 0.01345259f * cb);
+      ref[i + 2] = (std::max)(0.0f, 0.0206156f * cr + 0.10956983f * cg + 0.86981512f * cb);
+      ref[i + 3] = img_f32[i + 3];
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  {
+    KernelResult r;
+    r.name = "linear_displayp3_to_linear_sRGB";
+    std::vector<float> out;
+    r.min_ms = MeasureMinMs(iterations, [&]() {
+      return tinyusdz::linear_displayp3_to_linear_sRGB(img_f32, width, height, channels, &out, &err);
+    }, &r.ok);
+    std::vector<float> ref(num_texels);
+    for (size_t i = 0; i < num_texels; i += 4) {
+      float cr = img_f32[i + 0], cg = img_f32[i + 1], cb = img_f32[i + 2];
+      ref[i + 0] = (std::max)(0.0f, 1.2249f * cr - 0.2247f * cg);
+      ref[i + 1] = (std::max)(0.0f, -0.0420f * cr + 1.0419f * cg);
+      ref[i + 2] = (std::max)(0.0f, -0.0197f * cr - 0.0786f * cg + 1.0979f * cb);
+      ref[i + 3] = img_f32[i + 3];
+    }
+    r.max_abs_err = MaxAbsError(out, ref);
+    results.push_back(r);
+  }
+
+  if (err.size()) {
+    std::cerr << err << "\n";
+  }
+
+  std::cout << "# image " << width << " x " << height << " x " << channels
+            << ", iterations " << iterations << "\n";
+  for (const auto &r : results) {
+    std::cout << "[" << r.name << "] ";
+    if (!r.ok) {
+      std::cout << "FAILED\n";
+      continue;
+    }
+    double mtexels = (r.min_ms > 0.0)
+                         ? (double(num_texels) / 1.0e6) / (r.min_ms / 1000.0)
+                         : 0.0;
+    std::cout << "min " << r.min_ms << " ms, " << mtexels
+              << " Mtexels/s, max abs err " << r.max_abs_err << "\n";
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,481 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// End-to-end load/convert benchmark.
+//
+// Generates synthetic scene, writes it as USDA(and USDC when the writer is
+// available), then measures LoadUSDFromFile, composition,
+// Tydra ConvertToRenderScene and SaveAsUSDA.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "composition.hh"
+#include "io-util.hh"
+#include "scene-generator.hh"
+#include "str-util.hh"
+#include "tinyusdz.hh"
+#include "usda-writer.hh"
+#include "usdc-writer.hh"
+#include "tydra/render-data.hh"
+
+namespace {
+
+// Reset the peak resident set size of the process, so that the next
+// `GetPeakRSS` returns the peak since this call. Linux only(clear_refs `5`
+// resets VmHWM). Returns false when not supported; `GetPeakRSS` then returns
+// the peak over the whole process lifetime.
+bool ResetPeakRSS() {
+#if defined(__linux__)
+  std::ofstream ofs("/proc/self/clear_refs");
+  if (!ofs) {
+    return false;
+  }
+  ofs << "5";
+  ofs.flush();
+  return bool(ofs);
+#else
+  return false;
+#endif
+}
+
+// Peak resident set size in [bytes]. 0 when not available.
+uint64_t GetPeakRSS() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS info;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info))) {
+    return uint64_t(info.PeakWorkingSetSize);
+  }
+  return 0;
+#else
+#if defined(__linux__)
+  {
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+      if (line.compare(0, 6, "VmHWM:") == 0) {
+        // "VmHWM:    1234 kB"
+        return uint64_t(std::strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+      }
+    }
+  }
+#endif
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return uint64_t(usage.ru_maxrss);  // bytes
+#else
+    return uint64_t(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+  }
+  return 0;
+#endif
+}
+
+uint64_t GetFileSize(const std::string &filename) {
+  std::ifstream ifs(filename.c_str(), std::ifstream::binary | std::ifstream::ate);
+  if (!ifs) {
+    return 0;
+  }
+  return uint64_t(ifs.tellg());
+}
+
+struct PhaseResult {
+  std::string name;
+  bool ok{false};
+  std::string message;  // error or skip reason
+  std::vector<double> times_ms;
+  uint64_t bytes{0};  // input/output bytes(for throughput)
+  uint64_t prims{0};  // # of Prims processed(for throughput)
+  uint64_t peak_rss{0};
+  bool peak_rss_cumulative{true};  // true: peak since the process start.
+
+  double min_ms() const {
+    return times_ms.empty() ? 0.0 : *std::min_element(times_ms.begin(), times_ms.end());
+  }
+
+  double avg_ms() const {
+    if (times_ms.empty()) {
+      return 0.0;
+    }
+    double sum = 0.0;
+    for (double t : times_ms) {
+      sum += t;
+    }
+    return sum / double(times_ms.size());
+  }
+
+  double mb_per_sec() const {
+    double t = min_ms();
+    if ((t <= 0.0) || (bytes == 0)) {
+      return 0.0;
+    }
+    return (double(bytes) / (1024.0 * 1024.0)) / (t / 1000.0);
+  }
+
+  double prims_per_sec() const {
+    double t = min_ms();
+    if ((t <= 0.0) || (prims == 0)) {
+      return 0.0;
+    }
+    return double(prims) / (t / 1000.0);
+  }
+};
+
+template <typename F>
+PhaseResult RunPhase(const std::string &name, uint32_t iterations, F &&f) {
+  PhaseResult result;
+  result.name = name;
+  result.ok = true;
+  result.peak_rss_cumulative = !ResetPeakRSS();
+
+  for (uint32_t i = 0; i < iterations; i++) {
+    auto s = std::chrono::steady_clock::now();
+    if (!f(&result)) {
+      result.ok = false;
+      break;
+    }
+    auto e = std::chrono::steady_clock::now();
+    result.times_ms.push_back(
+        std::chrono::duration<double, std::milli>(e - s).count());
+  }
+
+  result.peak_rss = GetPeakRSS();
+
+  return result;
+}
+
+std::string EscapeJSON(const std::string &s) {
+  std::string out;
+  for (char c : s) {
+    if ((c == '"') || (c == '\\')) {
+      out += '\\';
+      out += c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += ' ';
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+void PrintResult(const PhaseResult &r) {
+  std::cout << "[" << r.name << "] ";
+  if (!r.ok) {
+    std::cout << "FAILED/SKIPPED: " << r.message << "\n";
+    return;
+  }
+  std::cout << "min " << r.min_ms() << " ms, avg " << r.avg_ms() << " ms";
+  if (r.bytes) {
+    std::cout << ", " << r.mb_per_sec() << " MB/s";
+  }
+  if (r.prims) {
+    std::cout << ", " << r.prims_per_sec() << " prims/s";
+  }
+  std::cout << (r.peak_rss_cumulative ? ", peak RSS(cumulative) " : ", peak RSS ")
+            << (double(r.peak_rss) / (1024.0 * 1024.0)) << " MB\n";
+}
+
+void print_help() {
+  std::cout << "Usage: load_benchmark_tinyusdz [options]\n";
+  std::cout << "  --meshes N        # of GeomMesh prims(default 1000)\n";
+  std::cout << "  --depth N         Depth of Xform hierarchy(default 4)\n";
+  std::cout << "  --mesh-res N      Each mesh is NxN quad grid(default 16)\n";
+  std::cout << "  --timesamples N   # of time samples of xformOp:translate per Xform(default 0)\n";
+  std::cout << "  --references N    # of Prims with `references`(default 0)\n";
+  std::cout << "  --iterations N    # of iterations for each phase(default 3)\n";
+  std::cout << "  --outdir DIR      Directory to write generated files(default `.`)\n";
+  std::cout << "  --json FILE       Write machine readable summary to FILE\n";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  tinyusdz::bench::SceneGeneratorConfig config;
+  uint32_t iterations = 3;
+  std::string outdir = ".";
+  std::string json_filename;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto next_uint = [&](uint32_t *dst) {
+      if ((i + 1) >= argc) {
+        std::cerr << arg << " requires an argument.\n";
+        exit(EXIT_FAILURE);
+      }
+      i++;
+      (*dst) = uint32_t(std::strtoul(argv[i], nullptr, 10));
+    };
+
+    if ((arg == "-h") || (arg == "--help")) {
+      print_help();
+      return EXIT_SUCCESS;
+    } else if (arg == "--meshes") {
+      next_uint(&config.num_meshes);
+    } else if (arg == "--depth") {
+      next_uint(&config.depth);
+    } else if (arg == "--mesh-res") {
+      next_uint(&config.mesh_resolution);
+    } else if (arg == "--timesamples") {
+      next_uint(&config.num_timesamples);
+    } else if (arg == "--references") {
+      next_uint(&config.num_references);
+    } else if (arg == "--iterations") {
+      next_uint(&iterations);
+      iterations = (std::max)(1u, iterations);
+    } else if ((arg == "--outdir") && ((i + 1) < argc)) {
+      outdir = argv[++i];
+    } else if ((arg == "--json") && ((i + 1) < argc)) {
+      json_filename = argv[++i];
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      print_help();
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::string usda_filename = tinyusdz::io::JoinPath(outdir, "bench_scene.usda");
+  const std::string usdc_filename = tinyusdz::io::JoinPath(outdir, "bench_scene.usdc");
+  const std::string asset_filename = tinyusdz::io::JoinPath(outdir, "bench_asset.usda");
+  const std::string resave_filename = tinyusdz::io::JoinPath(outdir, "bench_resave.usda");
+
+  // Path is resolved relative to the referencing layer.
+  config.reference_asset_path = "./bench_asset.usda";
+
+  std::vector<PhaseResult> results;
+
+  tinyusdz::Stage gen_stage;
+  tinyusdz::bench::SceneStats stats;
+
+  results.push_back(RunPhase("generate", 1, [&](PhaseResult *r) {
+    gen_stage = tinyusdz::Stage();
+    tinyusdz::bench::GenerateScene(config, &gen_stage, &stats);
+    r->prims = stats.num_prims;
+    return true;
+  }));
+
+  if (config.num_references > 0) {
+    tinyusdz::Stage asset_stage;
+    tinyusdz::bench::GenerateReferencedAsset(config, &asset_stage);
+    std::string warn, err;
+    if (!tinyusdz::usda::SaveAsUSDA(asset_filename, asset_stage, &warn, &err)) {
+      std::cerr << "Failed to write referenced asset: " << err << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  results.push_back(RunPhase("write_usda", 1, [&](PhaseResult *r) {
+    std::string warn, err;
+    if (!tinyusdz::usda::SaveAsUSDA(usda_filename, gen_stage, &warn, &err)) {
+      r->message = err;
+      return false;
+    }
+    r->bytes = GetFileSize(usda_filename);
+    r->prims = stats.num_prims;
+    return true;
+  }));
+
+  bool has_usdc = false;
+  results.push_back(RunPhase("write_usdc", 1, [&](PhaseResult *r) {
+    std::string warn, err;
+    if (!tinyusdz::usdc::SaveAsUSDCToFile(usdc_filename, gen_stage, &warn, &err)) {
+      r->message = err;
+      return false;
+    }
+    r->bytes = GetFileSize(usdc_filename);
+    r->prims = stats.num_prims;
+    has_usdc = true;
+    return true;
+  }));
+
+  // Free memory of the generated scene before measuring loaders.
+  gen_stage = tinyusdz::Stage();
+
+  tinyusdz::Stage stage;
+
+  results.push_back(RunPhase("load_usda", iterations, [&](PhaseResult *r) {
+    std::string warn, err;
+    stage = tinyusdz::Stage();
+    if (!tinyusdz::LoadUSDFromFile(usda_filename, &stage, &warn, &err)) {
+      r->message = err;
+      return false;
+    }
+    r->bytes = GetFileSize(usda_filename);
+    r->prims = stats.num_prims;
+    return true;
+  }));
+
+  if (has_usdc) {
+    results.push_back(RunPhase("load_usdc", iterations, [&](PhaseResult *r) {
+      std::string warn, err;
+      tinyusdz::Stage usdc_stage;
+      if (!tinyusdz::LoadUSDFromFile(usdc_filename, &usdc_stage, &warn, &err)) {
+        r->message = err;
+        return false;
+      }
+      r->bytes = GetFileSize(usdc_filename);
+      r->prims = stats.num_prims;
+      return true;
+    }));
+  }
+
+  // Parse the root layer outside of the timed region, so that "composition"
+  // only measures the composition(the parse is measured by "load_usda").
+  tinyusdz::Layer root_layer;
+  std::string root_layer_err;
+  bool has_root_layer = false;
+  {
+    std::string warn;
+    has_root_layer = tinyusdz::LoadLayerFromFile(usda_filename, &root_layer,
+                                                 &warn, &root_layer_err);
+  }
+
+  // Composited Stage. Used for the convert and save phases, so that
+  // referenced meshes are also processed.
+  tinyusdz::Stage comp_stage;
+
+  if (has_root_layer) {
+    results.push_back(RunPhase("composition", iterations, [&](PhaseResult *r) {
+      std::string warn, err;
+      tinyusdz::AssetResolutionResolver resolver;
+      std::string base_dir = tinyusdz::io::GetBaseDir(usda_filename);
+      resolver.set_current_working_path(base_dir);
+      resolver.set_search_paths({base_dir});
+
+      tinyusdz::Layer src_layer;
+      if (!tinyusdz::CompositeSublayers(resolver, root_layer, &src_layer, &warn, &err)) {
+        r->message = err;
+        return false;
+      }
+
+      if (src_layer.check_unresolved_references()) {
+        tinyusdz::Layer composited_layer;
+        if (!tinyusdz::CompositeReferences(resolver, src_layer, &composited_layer, &warn, &err)) {
+          r->message = err;
+          return false;
+        }
+        src_layer = std::move(composited_layer);
+      }
+
+      comp_stage = tinyusdz::Stage();
+      if (!tinyusdz::LayerToStage(src_layer, &comp_stage, &warn, &err)) {
+        r->message = err;
+        return false;
+      }
+
+      r->prims = stats.num_prims;
+      return true;
+    }));
+  } else {
+    PhaseResult r;
+    r.name = "composition";
+    r.message = "Failed to load root layer: " + root_layer_err;
+    results.push_back(r);
+  }
+
+  // Free memory of the uncomposited scene before measuring the remaining
+  // phases.
+  stage = tinyusdz::Stage();
+  root_layer = tinyusdz::Layer();
+
+  if (results.back().ok) {
+    results.push_back(RunPhase("convert_to_render_scene", iterations, [&](PhaseResult *r) {
+      tinyusdz::tydra::RenderSceneConverter converter;
+      tinyusdz::tydra::RenderSceneConverterEnv env(comp_stage);
+      env.set_search_paths({tinyusdz::io::GetBaseDir(usda_filename)});
+
+      tinyusdz::tydra::RenderScene render_scene;
+      if (!converter.ConvertToRenderScene(env, &render_scene)) {
+        r->message = converter.GetError();
+        return false;
+      }
+      r->prims = stats.num_prims;
+      return true;
+    }));
+
+    results.push_back(RunPhase("save_usda", iterations, [&](PhaseResult *r) {
+      std::string warn, err;
+      if (!tinyusdz::usda::SaveAsUSDA(resave_filename, comp_stage, &warn, &err)) {
+        r->message = err;
+        return false;
+      }
+      r->bytes = GetFileSize(resave_filename);
+      r->prims = stats.num_prims;
+      return true;
+    }));
+  } else {
+    for (const char *name : {"convert_to_render_scene", "save_usda"}) {
+      PhaseResult r;
+      r.name = name;
+      r.message = "Skipped since composition failed.";
+      results.push_back(r);
+    }
+  }
+
+  std::cout << "# prims " << stats.num_prims << ", meshes " << stats.num_meshes
+            << ", points " << stats.num_points << ", faces " << stats.num_faces
+            << "\n";
+  for (const auto &r : results) {
+    PrintResult(r);
+  }
+
+  if (json_filename.size()) {
+    std::stringstream ss;
+    ss << "{\n";
+    ss << "  \"config\": {\"meshes\": " << config.num_meshes
+       << ", \"depth\": " << config.depth
+       << ", \"mesh_res\": " << config.mesh_resolution
+       << ", \"timesamples\": " << config.num_timesamples
+       << ", \"references\": " << config.num_references
+       << ", \"iterations\": " << iterations << "},\n";
+    ss << "  \"scene\": {\"prims\": " << stats.num_prims
+       << ", \"meshes\": " << stats.num_meshes
+       << ", \"points\": " << stats.num_points
+       << ", \"faces\": " << stats.num_faces << "},\n";
+    ss << "  \"phases\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+      const PhaseResult &r = results[i];
+      ss << "    {\"name\": \"" << r.name << "\", \"ok\": " << (r.ok ? "true" : "false")
+         << ", \"min_ms\": " << r.min_ms() << ", \"avg_ms\": " << r.avg_ms()
+         << ", \"bytes\": " << r.bytes << ", \"mb_per_sec\": " << r.mb_per_sec()
+         << ", \"prims_per_sec\": " << r.prims_per_sec()
+         << ", \"peak_rss_bytes\": " << r.peak_rss
+         << ", \"peak_rss_cumulative\": " << (r.peak_rss_cumulative ? "true" : "false")
+         << ", \"message\": \"" << EscapeJSON(r.message) << "\"}";
+      if (i != (results.size() - 1)) {
+        ss << ",";
+      }
+      ss << "\n";
+    }
+    ss << "  ]\n";
+    ss << "}\n";
+
+    std::ofstream ofs(json_filename.c_str());
+    if (!ofs) {
+      std::cerr << "Failed to open " << json_filename << "\n";
+      return EXIT_FAILURE;
+    }
+    ofs << ss.str();
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "scene-generator.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "prim-types.hh"
+#include "usdGeom.hh"
+
+namespace tinyusdz {
+namespace bench {
+
+namespace {
+
+void BuildGridMesh(const std::string &name, uint32_t res, float offset,
+                   GeomMesh *mesh, SceneStats *stats) {
+  mesh->name = name;
+
+  res = (std::max)(1u, res);
+
+  std::vector<value::point3f> points;
+  std::vector<value::texcoord2f> uvs;
+  points.reserve(size_t(res + 1) * size_t(res + 1));
+  uvs.reserve(size_t(res + 1) * size_t(res + 1));
+
+  for (uint32_t y = 0; y <= res; y++) {
+    for (uint32_t x = 0; x <= res; x++) {
+      float u = float(x) / float(res);
+      float v = float(y) / float(res);
+      // Add some waviness so that normals/triangulation is not trivial.
+      float h = 0.1f * std::sin(6.28318f * (u + offset)) * std::cos(6.28318f * v);
+      points.push_back({u, h, v});
+      uvs.push_back({u, v});
+    }
+  }
+
+  std::vector<int> counts(size_t(res) * size_t(res), 4);
+  std::vector<int> indices;
+  indices.reserve(counts.size() * 4);
+
+  for (uint32_t y = 0; y < res; y++) {
+    for (uint32_t x = 0; x < res; x++) {
+      int i0 = int(y * (res + 1) + x);
+      int i1 = i0 + 1;
+      int i2 = i1 + int(res + 1);
+      int i3 = i0 + int(res + 1);
+      indices.push_back(i0);
+      indices.push_back(i3);
+      indices.push_back(i2);
+      indices.push_back(i1);
+    }
+  }
+
+  if (stats) {
+    stats->num_points += points.size();
+    stats->num_faces += counts.size();
+    stats->num_meshes++;
+    stats->num_prims++;
+  }
+
+  mesh->points.set_value(points);
+  mesh->faceVertexCounts.set_value(counts);
+  mesh->faceVertexIndices.set_value(indices);
+
+  Attribute uvAttr;
+  uvAttr.set_value(uvs);
+  uvAttr.metas().interpolation = Interpolation::Vertex;
+  mesh->props.emplace("primvars:st", Property(uvAttr, /* custom */ false));
+}
+
+void AddTranslateOp(uint32_t num_timesamples, float offset, Xform *xform) {
+  XformOp op;
+  op.op_type = XformOp::OpType::Translate;
+
+  if (num_timesamples == 0) {
+    op.set_value(value::double3{double(offset), 0.0, 0.0});
+  } else {
+    for (uint32_t t = 0; t < num_timesamples; t++) {
+      op.set_timesample(float(t),
+                        value::double3{double(offset), double(t) * 0.01, 0.0});
+    }
+  }
+
+  xform->xformOps.push_back(op);
+}
+
+// Distribute meshes [start, start + count) under `parent` through `level`
+// levels of Xform groups.
+void BuildGroupRec(const SceneGeneratorConfig &config, uint32_t level,
+                   uint32_t fanout, uint64_t start, uint64_t count,
+                   Prim *parent, SceneStats *stats) {
+  if ((level >= config.depth) || (count <= fanout)) {
+    for (uint64_t i = start; i < start + count; i++) {
+      GeomMesh mesh;
+      BuildGridMesh("Mesh_" + std::to_string(i), config.mesh_resolution,
+                    float(i) * 0.01f, &mesh, stats);
+      parent->children().emplace_back(Prim(mesh));
+    }
+    return;
+  }
+
+  uint64_t per_group = (count + fanout - 1) / fanout;
+  for (uint64_t g = 0; g < fanout; g++) {
+    uint64_t s = start + g * per_group;
+    if (s >= start + count) {
+      break;
+    }
+    uint64_t n = (std::min)(per_group, start + count - s);
+
+    Xform xform;
+    xform.name = "Group_" + std::to_string(level) + "_" + std::to_string(s);
+    AddTranslateOp(config.num_timesamples, float(g), &xform);
+
+    Prim groupPrim(xform);
+    if (stats) {
+      stats->num_prims++;
+    }
+
+    BuildGroupRec(config, level + 1, fanout, s, n, &groupPrim, stats);
+
+    parent->children().emplace_back(std::move(groupPrim));
+  }
+}
+
+}  // namespace
+
+void GenerateScene(const SceneGeneratorConfig &config, Stage *stage,
+                   SceneStats *stats) {
+  if (!stage) {
+    return;
+  }
+
+  SceneStats local_stats;
+
+  Xform world;
+  world.name = "World";
+  Prim worldPrim(world);
+  local_stats.num_prims++;
+
+  // fanout^depth ~= num_meshes
+  uint32_t fanout = 2;
+  if (config.depth > 0) {
+    double f = std::pow(double((std::max)(1u, config.num_meshes)),
+                        1.0 / double(config.depth));
+    fanout = (std::max)(2u, uint32_t(std::ceil(f)));
+  }
+
+  BuildGroupRec(config, 0, fanout, 0, config.num_meshes, &worldPrim,
+                &local_stats);
+
+  if (config.num_references > 0) {
+    Xform refs;
+    refs.name = "Refs";
+    Prim refsPrim(refs);
+    local_stats.num_prims++;
+
+    for (uint32_t i = 0; i < config.num_references; i++) {
+      Xform xform;
+      xform.name = "Ref_" + std::to_string(i);
+      AddTranslateOp(0, float(i), &xform);
+      Prim xformPrim(xform);
+
+      // Typeless Prim so that it becomes GeomMesh of the referenced asset
+      // after the composition.
+      Model model;
+      model.name = "Asset";
+
+      Reference ref;
+      ref.asset_path = value::AssetPath(config.reference_asset_path);
+      ref.prim_path = Path("/Asset", "");
+      std::vector<Reference> ref_list{ref};
+      model.meta.references =
+          std::make_pair(ListEditQual::Prepend, ref_list);
+
+      xformPrim.children().emplace_back(Prim(model));
+      refsPrim.children().emplace_back(std::move(xformPrim));
+      local_stats.num_prims += 2;
+    }
+
+    worldPrim.children().emplace_back(std::move(refsPrim));
+  }
+
+  stage->metas().defaultPrim = value::token("World");
+  stage->metas().upAxis = Axis::Y;
+  stage->root_prims().emplace_back(std::move(worldPrim));
+
+  if (stats) {
+    (*stats) = local_stats;
+  }
+}
+
+void GenerateReferencedAsset(const SceneGeneratorConfig &config,
+                             Stage *stage) {
+  if (!stage) {
+    return;
+  }
+
+  GeomMesh mesh;
+  BuildGridMesh("Asset", config.mesh_resolution, 0.0f, &mesh, nullptr);
+
+  stage->metas().defaultPrim = value::token("Asset");
+  stage->root_prims().emplace_back(Prim(mesh));
+}
+
+}  // namespace bench
+}  // namespace tinyusdz
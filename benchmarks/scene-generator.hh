@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Procedural scene generator for end-to-end load/convert benchmarks.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "stage.hh"
+
+namespace tinyusdz {
+namespace bench {
+
+struct SceneGeneratorConfig {
+  uint32_t num_meshes{1000};     // # of GeomMesh prims
+  uint32_t depth{4};             // depth of Xform hierarchy above meshes
+  uint32_t mesh_resolution{16};  // Each mesh is a NxN quad grid
+  uint32_t num_timesamples{0};   // # of time samples of xformOp:translate on each Xform
+  uint32_t num_references{0};    // # of Prims referencing `reference_asset_path`
+
+  // Asset path of the referenced layer(generated by GenerateReferencedAsset)
+  std::string reference_asset_path{"./bench_asset.usda"};
+};
+
+struct SceneStats {
+  uint64_t num_prims{0};
+  uint64_t num_meshes{0};
+  uint64_t num_points{0};
+  uint64_t num_faces{0};
+};
+
+///
+/// Generate synthetic scene.
+///
+/// Layout:
+///   /World                        (Xform)
+///     /Group_*/.../Group_*        (Xform, `depth` levels)
+///       /Mesh_*                   (GeomMesh)
+///     /Refs/Ref_*                 (Xform)
+///       /Asset                    (typeless Prim with `references`)
+///
+void GenerateScene(const SceneGeneratorConfig &config, Stage *stage,
+                   SceneStats *stats);
+
+///
+/// Generate the layer referenced from the scene(a single mesh Prim `/Asset`).
+///
+void GenerateReferencedAsset(const SceneGeneratorConfig &config, Stage *stage);
+
+}  // namespace bench
+}  // namespace tinyusdz
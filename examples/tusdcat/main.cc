@@ -8,6 +8,7 @@
 #include "pprinter.hh"
 #include "str-util.hh"
 #include "io-util.hh"
+#include "performance.hh"
 
 #include "tydra/scene-access.hh"
 
@@ -34,7 +35,7 @@ static std::string str_tolower(std::string s) {
 }
 
 void print_help() {
-    std::cout << "Usage tusdcat [--flatten] [--loadOnly] [--composition=STRLIST] [--relative] [--extract-variants] input.usda/usdc/usdz\n";
+    std::cout << "Usage tusdcat [--flatten] [--loadOnly] [--composition=STRLIST] [--relative] [--extract-variants] [--trace=FILE] [--memstat] input.usda/usdc/usdz\n";
     std::cout << "\n --flatten (not fully implemented yet) Do composition(load sublayers, refences, payload, evaluate `over`, inherit, variants..)";
     std::cout << "  --composition: Specify which composition feature to be "
                  "enabled(valid when `--flatten` is supplied). Comma separated "
@@ -45,6 +46,8 @@ void print_help() {
     std::cout << "\n --extract-variants (w.i.p) Dump variants information to .json\n";
     std::cout << "\n --relative (not implemented yet) Print Path as relative Path\n";
     std::cout << "\n -l, --loadOnly Load(Parse) USD file only(Check if input USD is valid or not)\n";
+    std::cout << "\n --trace=FILE Write Chrome trace event JSON of USD loading to FILE(TinyUSDZ must be built with `TINYUSDZ_WITH_TRACE`)\n";
+    std::cout << "\n --memstat Print the breakdown of(approximated) memory usage of USD loading\n";
 
 }
 
@@ -58,10 +61,12 @@ int main(int argc, char **argv) {
   bool has_relative{false};
   bool has_extract_variants{false};
   bool load_only{false};
+  bool print_memstat{false};
 
   constexpr int kMaxIteration = 128;
 
   std::string filepath;
+  std::string trace_filepath;
 
   int input_index = -1;
   CompositionFeatures comp_features;
@@ -79,6 +84,10 @@ int main(int argc, char **argv) {
       load_only = true;
     } else if (arg.compare("--extract-variants") == 0) {
       has_extract_variants = true;
+    } else if (arg.compare("--memstat") == 0) {
+      print_memstat = true;
+    } else if (tinyusdz::startsWith(arg, "--trace=")) {
+      trace_filepath = tinyusdz::removePrefix(arg, "--trace=");
     } else if (tinyusdz::startsWith(arg, "--composition=")) {
       std::string value_str = tinyusdz::removePrefix(arg, "--composition=");
       if (value_str.empty()) {
@@ -365,8 +374,32 @@ int main(int argc, char **argv) {
 
     tinyusdz::USDLoadOptions options;
 
+    auto memory_budget = std::make_shared<tinyusdz::MemoryBudget>(
+        uint64_t(options.max_memory_limit_in_mb) * 1024ull * 1024ull);
+    options.memory_budget = memory_budget;
+
+    if (trace_filepath.size()) {
+      if (!tinyusdz::performance::StartTraceCapture()) {
+        std::cerr << "Trace is not available. Rebuild TinyUSDZ with `TINYUSDZ_WITH_TRACE`.\n";
+      }
+    }
+
     // auto detect format.
     bool ret = tinyusdz::LoadUSDFromFile(filepath, &stage, &warn, &err, options);
+
+    if (tinyusdz::performance::IsTraceCapturing()) {
+      tinyusdz::performance::StopTraceCapture();
+      std::string trace_err;
+      if (!tinyusdz::performance::WriteChromeTrace(trace_filepath, &trace_err)) {
+        std::cerr << "Failed to write trace: " << trace_err << "\n";
+      } else {
+        std::cerr << "Wrote trace to " << trace_filepath << "\n";
+      }
+    }
+
+    if (print_memstat) {
+      std::cerr << tinyusdz::to_string(*memory_budget);
+    }
     if (!warn.empty()) {
       std::cerr << "WARN : " << warn << "\n";
     }
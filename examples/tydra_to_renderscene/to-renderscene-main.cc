@@ -35,6 +35,11 @@ int main(int argc, char **argv) {
     std::cout
         << "  --dumpobj: Dump mesh as wavefront .obj(for visual debugging)\n";
     std::cout << "  --dumpusd: Dump scene as USD(USDA Ascii)\n";
+    std::cout << "  --partex: Decode texture images in parallel\n";
+    std::cout << "  --texcomp FORMAT: Compress texture images(bc1, bc3, bc4, "
+                 "bc5 or bc7)\n";
+    std::cout << "  --maxtexsize N: Downscale texture images to fit in N x N\n";
+    std::cout << "  --mipmap: Generate mipmaps for texture images\n";
     return EXIT_FAILURE;
   }
 
@@ -48,6 +53,11 @@ int main(int argc, char **argv) {
   bool export_obj = false;
   bool export_usd = false;
   bool no_usdprint = false;
+  bool parallel_texture_loading = false;
+  tinyusdz::tydra::TextureCompressionFormat texture_compression_format =
+      tinyusdz::tydra::TextureCompressionFormat::None;
+  uint32_t max_texture_size = 0;
+  bool generate_texture_mipmaps = false;
 
   std::string filepath;
   for (int i = 1; i < argc; i++) {
@@ -61,6 +71,41 @@ int main(int argc, char **argv) {
       export_obj = true;
     } else if (strcmp(argv[i], "--dumpusd") == 0) {
       export_usd = true;
+    } else if (strcmp(argv[i], "--partex") == 0) {
+      parallel_texture_loading = true;
+    } else if (strcmp(argv[i], "--mipmap") == 0) {
+      generate_texture_mipmaps = true;
+    } else if (strcmp(argv[i], "--maxtexsize") == 0) {
+      if ((i + 1) >= argc) {
+        std::cerr << "arg is missing for --maxtexsize flag.\n";
+        return -1;
+      }
+      max_texture_size = uint32_t(std::stoul(argv[i + 1]));
+      i++;
+    } else if (strcmp(argv[i], "--texcomp") == 0) {
+      if ((i + 1) >= argc) {
+        std::cerr << "arg is missing for --texcomp flag.\n";
+        return -1;
+      }
+      const tinyusdz::tydra::TextureCompressionFormat kFormats[] = {
+          tinyusdz::tydra::TextureCompressionFormat::BC1,
+          tinyusdz::tydra::TextureCompressionFormat::BC3,
+          tinyusdz::tydra::TextureCompressionFormat::BC4,
+          tinyusdz::tydra::TextureCompressionFormat::BC5,
+          tinyusdz::tydra::TextureCompressionFormat::BC7};
+      bool found = false;
+      for (const auto cfmt : kFormats) {
+        if (tinyusdz::tydra::to_string(cfmt) == argv[i + 1]) {
+          texture_compression_format = cfmt;
+          found = true;
+        }
+      }
+      if (!found) {
+        std::cerr << "Unknown texture compression format: " << argv[i + 1]
+                  << "\n";
+        return -1;
+      }
+      i++;
     } else if (strcmp(argv[i], "--timecode") == 0) {
       if ((i + 1) >= argc) {
         std::cerr << "arg is missing for --timecode flag.\n";
@@ -116,6 +161,10 @@ int main(int argc, char **argv) {
   std::cout << "Rebuild vertex indices : " << (build_indices ? "true" : "false")
             << "\n";
   env.mesh_config.build_vertex_indices = build_indices;
+  env.scene_config.parallel_texture_loading = parallel_texture_loading;
+  env.material_config.texture_compression_format = texture_compression_format;
+  env.material_config.max_texture_size = max_texture_size;
+  env.material_config.generate_texture_mipmaps = generate_texture_mipmaps;
 
   // Add base directory of .usd file to search path.
   std::string usd_basedir = tinyusdz::io::GetBaseDir(filepath);
@@ -6,6 +6,7 @@
 // structure)
 //
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -19,6 +20,7 @@
 
 #include "tinyusdz.hh"
 #include "io-util.hh"
+#include "tydra/gltf-export.hh"
 #include "tydra/render-data.hh"
 #include "tydra/scene-access.hh"
 #include "tydra/shader-network.hh"
@@ -92,11 +94,16 @@ bool to_gltf(const tinyusdz::tydra::RenderScene &rscene, const std::string &gltf
 int main(int argc, char **argv) {
   if (argc < 2) {
     std::cout << "Need USD file.\n"
+              << "Usage: usd_to_gltf input.usd [output.glb|output.gltf]\n"
               << std::endl;
     return EXIT_FAILURE;
   }
 
   std::string filepath = argv[1];
+  std::string output_filename = "output.glb";
+  if (argc > 2) {
+    output_filename = argv[2];
+  }
   std::string warn;
   std::string err;
 
@@ -198,7 +205,25 @@ int main(int argc, char **argv) {
 
   std::cout << DumpRenderScene(render_scene) << "\n";
 
-  if (!to_gltf(render_scene, "output.gltf")) {
+  if (str_tolower(GetFileExtension(output_filename)) == "glb") {
+    std::vector<uint8_t> glb;
+    std::string export_warn;
+    std::string export_err;
+    if (!tinyusdz::tydra::export_to_glb(render_scene, glb, &export_warn, &export_err)) {
+      std::cerr << "Failed to export scene as GLB: " << export_err << "\n";
+      return EXIT_FAILURE;
+    }
+    if (export_warn.size()) {
+      std::cout << "GLB export warn: " << export_warn << "\n";
+    }
+
+    std::ofstream ofs(output_filename, std::ios::binary);
+    if (!ofs) {
+      std::cerr << "Failed to open file to write: " << output_filename << "\n";
+      return EXIT_FAILURE;
+    }
+    ofs.write(reinterpret_cast<const char *>(glb.data()), std::streamsize(glb.size()));
+  } else if (!to_gltf(render_scene, output_filename)) {
     std::cerr << "Failed to save scene as glTF\n";
     return EXIT_FAILURE;
   } 
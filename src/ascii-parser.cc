@@ -32,6 +32,7 @@
 
 #include "ascii-parser.hh"
 #include "path-util.hh"
+#include "performance.hh"
 #include "str-util.hh"
 #include "tiny-format.hh"
 
@@ -4557,6 +4558,249 @@ std::string AsciiParser::GetCurrentPrimPath() {
   return _path_stack.top();
 }
 
+bool AsciiParser::LookAheadPrimBlockName(std::string *prim_name) {
+  uint64_t loc = CurrLoc();
+
+  bool ok = [&]() {
+    Identifier def;
+    if (!ReadIdentifier(&def)) {
+      return false;
+    }
+
+    if (!SkipWhitespaceAndNewline()) {
+      return false;
+    }
+
+    char c;
+    if (!LookChar1(&c)) {
+      return false;
+    }
+
+    if (c != '"') {
+      Identifier prim_type;
+      if (!ReadIdentifier(&prim_type)) {
+        return false;
+      }
+
+      if (!SkipWhitespaceAndNewline()) {
+        return false;
+      }
+    }
+
+    return ReadBasicType(prim_name);
+  }();
+
+  if (!SeekTo(loc)) {
+    return false;
+  }
+
+  return ok;
+}
+
+bool AsciiParser::IsPrimBlockMaskedOut() {
+  if (_option.population_mask.empty()) {
+    return false;
+  }
+
+  std::string prim_name;
+  if (!LookAheadPrimBlockName(&prim_name)) {
+    // Let ParseBlock() report an error.
+    return false;
+  }
+
+  std::string full_path = GetCurrentPrimPath();
+  if (full_path == "/") {
+    full_path += prim_name;
+  } else {
+    full_path += "/" + prim_name;
+  }
+
+  return !pathutil::IsPathInPopulationMask(Path(full_path, ""),
+                                           _option.population_mask);
+}
+
+bool AsciiParser::SkipPrimBlock() {
+  std::string prim_name;
+  if (!LookAheadPrimBlockName(&prim_name)) {
+    PUSH_ERROR_AND_RETURN("Failed to parse the header of Prim block.");
+  }
+
+  // Move to the end of the header(`def Xform "name"`).
+  {
+    Identifier def;
+    if (!ReadIdentifier(&def)) {
+      return false;
+    }
+
+    if (!SkipWhitespaceAndNewline()) {
+      return false;
+    }
+
+    char c;
+    if (!LookChar1(&c)) {
+      return false;
+    }
+
+    if (c != '"') {
+      Identifier prim_type;
+      if (!ReadIdentifier(&prim_type)) {
+        return false;
+      }
+      if (!SkipWhitespaceAndNewline()) {
+        return false;
+      }
+    }
+
+    if (!ReadBasicType(&prim_name)) {
+      return false;
+    }
+  }
+
+  DCOUT("Skip Prim block: " << prim_name);
+
+  if (!SkipCommentAndWhitespaceAndNewline()) {
+    return false;
+  }
+
+  char c;
+  if (!LookChar1(&c)) {
+    return false;
+  }
+
+  if (c == '(') {
+    // metas
+    if (!SkipBalancedBlock('(', ')')) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to find the end of metadata of Prim `{}`.", prim_name));
+    }
+
+    if (!SkipCommentAndWhitespaceAndNewline()) {
+      return false;
+    }
+  }
+
+  if (!SkipBalancedBlock('{', '}')) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Failed to find the end of Prim block `{}`.", prim_name));
+  }
+
+  return true;
+}
+
+bool AsciiParser::SkipQuotedString(const char quote_c) {
+  // Opening quote is already consumed.
+  bool triple_quoted = false;
+  {
+    std::vector<char> cs;
+    if (LookCharN(2, &cs) && (cs[0] == quote_c) && (cs[1] == quote_c)) {
+      std::vector<char> tmp;
+      if (!CharN(2, &tmp)) {
+        return false;
+      }
+      triple_quoted = true;
+    }
+  }
+
+  size_t num_quotes = 0;
+  while (!Eof()) {
+    char c;
+    if (!Char1(&c)) {
+      return false;
+    }
+
+    if (c == '\\') {
+      // escape
+      if (!Char1(&c)) {
+        return false;
+      }
+      num_quotes = 0;
+      continue;
+    }
+
+    if (c == quote_c) {
+      if (!triple_quoted) {
+        return true;
+      }
+
+      num_quotes++;
+      if (num_quotes == 3) {
+        return true;
+      }
+    } else {
+      num_quotes = 0;
+    }
+  }
+
+  PUSH_ERROR_AND_RETURN("String literal is not terminated.");
+}
+
+bool AsciiParser::SkipBalancedBlock(const char open_c, const char close_c) {
+  if (!Expect(open_c)) {
+    return false;
+  }
+
+  size_t depth = 1;
+
+  while (!Eof()) {
+    char c;
+    if (!Char1(&c)) {
+      return false;
+    }
+
+    if ((c == '"') || (c == '\'')) {
+      if (!SkipQuotedString(c)) {
+        return false;
+      }
+    } else if (c == '@') {
+      // asset path. `@...@` or `@@@...@@@`
+      std::vector<char> cs;
+      bool triple = LookCharN(2, &cs) && (cs[0] == '@') && (cs[1] == '@');
+      if (triple) {
+        if (!CharN(2, &cs)) {
+          return false;
+        }
+      }
+
+      size_t num_ats = 0;
+      bool terminated = false;
+      while (!Eof()) {
+        char d;
+        if (!Char1(&d)) {
+          return false;
+        }
+        if (d == '@') {
+          num_ats++;
+          if (!triple || (num_ats == 3)) {
+            terminated = true;
+            break;
+          }
+        } else {
+          num_ats = 0;
+        }
+      }
+
+      if (!terminated) {
+        PUSH_ERROR_AND_RETURN("Asset path is not terminated.");
+      }
+    } else if (c == '#') {
+      // comment
+      if (!SkipUntilNewline()) {
+        return false;
+      }
+    } else if (c == open_c) {
+      depth++;
+    } else if (c == close_c) {
+      depth--;
+      if (depth == 0) {
+        return true;
+      }
+    }
+  }
+
+  PUSH_ERROR_AND_RETURN(
+      fmt::format("Unexpected EOF. `{}` is not closed.", std::string(1, open_c)));
+}
+
 //
 // -- ctor, dtor
 //
@@ -4711,7 +4955,12 @@ bool AsciiParser::ParseVariantSet(
 
       // No specifier => Assume properties only.
       // Has specifier => Prim
-      if (child_spec != Specifier::Invalid) {
+      if ((child_spec != Specifier::Invalid) && IsPrimBlockMaskedOut()) {
+        if (!SkipPrimBlock()) {
+          PUSH_ERROR_AND_RETURN(
+              fmt::format("Failed to skip `{}` block.", to_string(child_spec)));
+        }
+      } else if (child_spec != Specifier::Invalid) {
         // FIXME: Assign idx dedicated for variant.
         int64_t idx = _prim_idx_assign_fun(parentPrimIdx);
         DCOUT("enter parseBlock in variantSet. spec = "
@@ -4997,7 +5246,12 @@ bool AsciiParser::ParseBlock(const Specifier spec, const int64_t primIdx,
         child_spec = Specifier::Class;
       }
 
-      if (child_spec != Specifier::Invalid) {
+      if ((child_spec != Specifier::Invalid) && IsPrimBlockMaskedOut()) {
+        if (!SkipPrimBlock()) {
+          PUSH_ERROR_AND_RETURN(
+              fmt::format("Failed to skip `{}` block.", to_string(child_spec)));
+        }
+      } else if (child_spec != Specifier::Invalid) {
         int64_t idx = _prim_idx_assign_fun(parentPrimIdx);
         DCOUT("enter parseDef. spec = " << to_string(child_spec) << ", idx = "
                                         << idx << ", rootIdx = " << primIdx);
@@ -5096,6 +5350,7 @@ bool AsciiParser::ParseBlock(const Specifier spec, const int64_t primIdx,
 ///
 bool AsciiParser::Parse(const uint32_t load_states,
                         const AsciiParserOption &parser_option) {
+  TINYUSDZ_TRACE_ZONE("AsciiParser::Parse");
   _toplevel = (load_states & static_cast<uint32_t>(LoadState::Toplevel));
   _sub_layered = (load_states & static_cast<uint32_t>(LoadState::Sublayer));
   _referenced = (load_states & static_cast<uint32_t>(LoadState::Reference));
@@ -5176,6 +5431,13 @@ bool AsciiParser::Parse(const uint32_t load_states,
       PUSH_ERROR_AND_RETURN("Invalid specifier token '" + tok + "'");
     }
 
+    if (IsPrimBlockMaskedOut()) {
+      if (!SkipPrimBlock()) {
+        PUSH_ERROR_AND_RETURN("Failed to skip `" + tok + "` block.");
+      }
+      continue;
+    }
+
     int64_t primIdx = _prim_idx_assign_fun(-1);
     DCOUT("Enter parseDef. primIdx = " << primIdx
                                        << ", parentPrimIdx = root(-1)");
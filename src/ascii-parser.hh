@@ -59,6 +59,11 @@ struct AsciiParserOption {
   bool allow_unknown_prim{true};
   bool allow_unknown_apiSchema{true};
   bool strict_allowedToken_check{false};
+
+  // Population mask(list of absolute Prim paths). `def`/`over`/`class` blocks
+  // outside of the mask are skipped by brace matching(not parsed).
+  // Empty = parse all blocks.
+  std::vector<Path> population_mask;
 };
 
 ///
@@ -805,6 +810,30 @@ class AsciiParser {
   nonstd::optional<VariableDef> GetPrimMetaDefinition(const std::string &arg);
   nonstd::optional<VariableDef> GetPropMetaDefinition(const std::string &arg);
 
+  ///
+  /// Look ahead the header of `def`/`over`/`class` block and return Prim's
+  /// element name. Stream position is not changed.
+  ///
+  bool LookAheadPrimBlockName(std::string *prim_name);
+
+  ///
+  /// Test if `def`/`over`/`class` block at the current stream position is
+  /// outside of the population mask.
+  ///
+  bool IsPrimBlockMaskedOut();
+
+  ///
+  /// Skip `def`/`over`/`class` block without parsing its content.
+  ///
+  bool SkipPrimBlock();
+
+  ///
+  /// Skip chars until the matching `close_c`. Stream must be positioned at
+  /// `open_c`. String literals, asset paths and comments are taken into account.
+  ///
+  bool SkipBalancedBlock(const char open_c, const char close_c);
+  bool SkipQuotedString(const char quote_c);
+
   std::string GetCurrentPrimPath();
   bool PrimPathStackDepth() { return _path_stack.size(); }
   void PushPrimPath(const std::string &abs_path) {
@@ -136,6 +136,25 @@ bool AssetResolutionResolver::open_asset(const std::string &resolvedPath, const
   std::string ext = io::GetFileExtension(resolvedPath);
 
   if (_asset_resolution_handlers.count(ext)) {
+    if (_asset_resolution_handlers.at(ext).view_fun) {
+      // Try zero-copy view first.
+      const uint8_t *addr{nullptr};
+      uint64_t nbytes{0};
+      std::string view_err;
+      int ret = _asset_resolution_handlers.at(ext).view_fun(
+          resolvedPath.c_str(), &addr, &nbytes, &view_err,
+          _asset_resolution_handlers.at(ext).userdata);
+      if ((ret == 0) && addr) {
+        DCOUT("asset view: " << nbytes << " bytes");
+        tinyusdz::Asset asset;
+        asset.set_view(addr, size_t(nbytes));
+        (*asset_out) = std::move(asset);
+        return true;
+      }
+
+      DCOUT("View of asset is not available. Fallback to read function: " << view_err);
+    }
+
     if (_asset_resolution_handlers.at(ext).size_fun && _asset_resolution_handlers.at(ext).read_fun) {
 
       // Use custom handler's userdata
@@ -158,7 +177,7 @@ bool AssetResolutionResolver::open_asset(const std::string &resolvedPath, const
 
       uint64_t read_size{0};
 
-      ret = _asset_resolution_handlers.at(ext).read_fun(resolvedPath.c_str(), /* req_size */asset.size(), asset.data(), &read_size, err, userdata);
+      ret = _asset_resolution_handlers.at(ext).read_fun(resolvedPath.c_str(), /* req_size */asset.size(), asset.mutable_data(), &read_size, err, userdata);
 
       if (ret != 0) {
         if (err) {
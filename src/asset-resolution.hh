@@ -21,22 +21,78 @@ namespace tinyusdz {
 /// Abstract class for asset(e.g. file, memory, uri, ...)
 /// Similar to ArAsset in pxrUSD.
 ///
+/// Asset either owns its data or is a read-only view to memory owned by
+/// others(e.g. asset in mmapped USDZ). A view is set through `set_view`.
+/// Use the const accessor to read the view without copying.
+///
 class Asset {
  public:
-  size_t size() const { return buf_.size(); }
+  size_t size() const { return view_addr_ ? view_size_ : buf_.size(); }
+
+  ///
+  /// Read-only access. Never copies viewed data.
+  ///
+  const uint8_t *data() const { return view_addr_ ? view_addr_ : buf_.data(); }
 
-  const uint8_t *data() const { return buf_.data(); }
+  ///
+  /// Writable access to the owned buffer.
+  /// @return nullptr when the Asset is a view. Call `materialize()` first to
+  /// get a writable copy of viewed data.
+  ///
+  uint8_t *mutable_data() { return view_addr_ ? nullptr : buf_.data(); }
+
+  ///
+  /// Deprecated. Use `mutable_data()`(or const `data()` for read access).
+  /// Writable access to the owned buffer. Viewed data is materialized(copied)
+  /// first.
+  ///
+  uint8_t *data() {
+    materialize();
+    return buf_.data();
+  }
 
-  uint8_t *data() { return buf_.data(); }
+  ///
+  /// Copy viewed data to the owned buffer(no-op when the Asset already owns
+  /// its data).
+  ///
+  void materialize() {
+    if (view_addr_) {
+      buf_.assign(view_addr_, view_addr_ + view_size_);
+      view_addr_ = nullptr;
+      view_size_ = 0;
+    }
+  }
 
-  void resize(size_t sz) { buf_.resize(sz); }
+  /// Resize the owned buffer. Viewed data is materialized first.
+  void resize(size_t sz) {
+    materialize();
+    buf_.resize(sz);
+  }
 
   void shrink_to_fit() { buf_.shrink_to_fit(); }
 
   void set_data(const std::vector<uint8_t> &&rhs) {
+    view_addr_ = nullptr;
+    view_size_ = 0;
     buf_ = rhs;
   }
 
+  ///
+  /// Set read-only view to external memory(no copy).
+  /// `addr` must be valid while the Asset(and its copy) is accessed.
+  ///
+  void set_view(const uint8_t *addr, size_t sz) {
+    buf_.clear();
+    buf_.shrink_to_fit();
+    view_addr_ = addr;
+    view_size_ = addr ? sz : 0;
+  }
+
+  ///
+  /// @return true when the Asset is a view to external memory.
+  ///
+  bool is_view() const { return view_addr_ != nullptr; }
+
   void set_name(const std::string &name) {
     name_ = name;
   }
@@ -66,6 +122,8 @@ class Asset {
   std::string name_;
   std::string resolved_name_;
   std::vector<uint8_t> buf_;
+  const uint8_t *view_addr_{nullptr};
+  size_t view_size_{0};
 };
 
 
@@ -114,6 +172,21 @@ typedef int (*FSSizeAsset)(const char *resolved_asset_name, uint64_t *nbytes,
 typedef int (*FSReadAsset)(const char *resolved_asset_name, uint64_t req_nbytes, uint8_t *out_buf,
                           uint64_t *nbytes, std::string *err, void *userdata);
 
+// Optional. Get read-only view of asset data without copying(e.g. asset in
+// mmapped USDZ).
+//
+// @param[in] resolved_asset_name Resolved Asset name or filepath
+// @param[out] addr Address of asset data. Must be valid while the handler's
+// data(e.g. `userdata`) is valid.
+// @param[out] nbytes Bytes of this asset.
+// @param[out] err Error message.
+// @param[inout] userdata Userdata.
+//
+// @return 0 upon success. negative value = error or view is not available(the
+// resolver falls back to `FSReadAsset`).
+typedef int (*FSViewAsset)(const char *resolved_asset_name, const uint8_t **addr,
+                          uint64_t *nbytes, std::string *err, void *userdata);
+
 // @param[in] asset_name Asset name or filepath(could be empty)
 // @param[in] resolved_asset_name Resolved Asset name or filepath
 // @param[in] buffer Data.
@@ -130,6 +203,7 @@ struct AssetResolutionHandler {
   FSSizeAsset size_fun{nullptr};
   FSReadAsset read_fun{nullptr};
   FSWriteAsset write_fun{nullptr};
+  FSViewAsset view_fun{nullptr};  // optional
   void *userdata{nullptr};
 };
 
@@ -261,6 +335,10 @@ class AssetResolutionResolver {
   ///
   /// Open asset from the resolved Path.
   ///
+  /// When the asset resolution handler provides `view_fun`, `asset` becomes a
+  /// view to the handler's memory(no copy). Otherwise asset data is copied to
+  /// `asset`.
+  ///
   /// @param[in] resolvedPath Resolved path(through `resolve()`)
   /// @param[in] assetPath Asset path(could be empty)
   /// @param[out] asset Asset.
@@ -3,84 +3,189 @@
 
 #include "c-tinyusd.h"
 
+#include <limits>
+
 #include "tinyusdz.hh"
+#include "io-util.hh"
+#include "tydra/render-data.hh"
 #include "tydra/scene-access.hh"
 #include "usdLux.hh"
 #include "prim-pprint.hh"
 #include "value-pprint.hh"
 #include "common-macros.inc"
+#include "prim-type-macros.inc"
 #include "str-util.hh"
 #include "value-types.hh"
 
 // TODO:
 // - [ ] Implement our own `strlen`
 
-CTinyUSDValueType c_tinyusd_value_type(const CTinyUSDValue *value) {
-  if (!value) {
-    return C_TINYUSD_VALUE_UNKNOWN;
-  }
+namespace {
 
-  const tinyusdz::value::Value *pv = reinterpret_cast<const tinyusdz::value::Value *>(value);
-  uint32_t tyid = pv->type_id();
+// Numeric types whose values can be viewed as contiguous memory.
+// (C++ type, TypeId, CTinyUSDValueType)
+#define C_TINYUSD_FOREACH_NUMERIC_TYPE(__FUNC)                                 \
+  __FUNC(uint8_t, TYPE_ID_UCHAR, C_TINYUSD_VALUE_UCHAR)                        \
+  __FUNC(int32_t, TYPE_ID_INT32, C_TINYUSD_VALUE_INT)                          \
+  __FUNC(value::int2, TYPE_ID_INT2, C_TINYUSD_VALUE_INT2)                      \
+  __FUNC(value::int3, TYPE_ID_INT3, C_TINYUSD_VALUE_INT3)                      \
+  __FUNC(value::int4, TYPE_ID_INT4, C_TINYUSD_VALUE_INT4)                      \
+  __FUNC(uint32_t, TYPE_ID_UINT32, C_TINYUSD_VALUE_UINT)                       \
+  __FUNC(value::uint2, TYPE_ID_UINT2, C_TINYUSD_VALUE_UINT2)                   \
+  __FUNC(value::uint3, TYPE_ID_UINT3, C_TINYUSD_VALUE_UINT3)                   \
+  __FUNC(value::uint4, TYPE_ID_UINT4, C_TINYUSD_VALUE_UINT4)                   \
+  __FUNC(int64_t, TYPE_ID_INT64, C_TINYUSD_VALUE_INT64)                        \
+  __FUNC(uint64_t, TYPE_ID_UINT64, C_TINYUSD_VALUE_UINT64)                     \
+  __FUNC(value::half, TYPE_ID_HALF, C_TINYUSD_VALUE_HALF)                      \
+  __FUNC(value::half2, TYPE_ID_HALF2, C_TINYUSD_VALUE_HALF2)                   \
+  __FUNC(value::half3, TYPE_ID_HALF3, C_TINYUSD_VALUE_HALF3)                   \
+  __FUNC(value::half4, TYPE_ID_HALF4, C_TINYUSD_VALUE_HALF4)                   \
+  __FUNC(float, TYPE_ID_FLOAT, C_TINYUSD_VALUE_FLOAT)                          \
+  __FUNC(value::float2, TYPE_ID_FLOAT2, C_TINYUSD_VALUE_FLOAT2)                \
+  __FUNC(value::float3, TYPE_ID_FLOAT3, C_TINYUSD_VALUE_FLOAT3)                \
+  __FUNC(value::float4, TYPE_ID_FLOAT4, C_TINYUSD_VALUE_FLOAT4)                \
+  __FUNC(double, TYPE_ID_DOUBLE, C_TINYUSD_VALUE_DOUBLE)                       \
+  __FUNC(value::double2, TYPE_ID_DOUBLE2, C_TINYUSD_VALUE_DOUBLE2)             \
+  __FUNC(value::double3, TYPE_ID_DOUBLE3, C_TINYUSD_VALUE_DOUBLE3)             \
+  __FUNC(value::double4, TYPE_ID_DOUBLE4, C_TINYUSD_VALUE_DOUBLE4)             \
+  __FUNC(value::quath, TYPE_ID_QUATH, C_TINYUSD_VALUE_QUATH)                   \
+  __FUNC(value::quatf, TYPE_ID_QUATF, C_TINYUSD_VALUE_QUATF)                   \
+  __FUNC(value::quatd, TYPE_ID_QUATD, C_TINYUSD_VALUE_QUATD)                   \
+  __FUNC(value::color3h, TYPE_ID_COLOR3H, C_TINYUSD_VALUE_COLOR3H)             \
+  __FUNC(value::color3f, TYPE_ID_COLOR3F, C_TINYUSD_VALUE_COLOR3F)             \
+  __FUNC(value::color3d, TYPE_ID_COLOR3D, C_TINYUSD_VALUE_COLOR3D)             \
+  __FUNC(value::color4h, TYPE_ID_COLOR4H, C_TINYUSD_VALUE_COLOR4H)             \
+  __FUNC(value::color4f, TYPE_ID_COLOR4F, C_TINYUSD_VALUE_COLOR4F)             \
+  __FUNC(value::color4d, TYPE_ID_COLOR4D, C_TINYUSD_VALUE_COLOR4D)             \
+  __FUNC(value::texcoord2h, TYPE_ID_TEXCOORD2H, C_TINYUSD_VALUE_TEXCOORD2H)    \
+  __FUNC(value::texcoord2f, TYPE_ID_TEXCOORD2F, C_TINYUSD_VALUE_TEXCOORD2F)    \
+  __FUNC(value::texcoord2d, TYPE_ID_TEXCOORD2D, C_TINYUSD_VALUE_TEXCOORD2D)    \
+  __FUNC(value::texcoord3h, TYPE_ID_TEXCOORD3H, C_TINYUSD_VALUE_TEXCOORD3H)    \
+  __FUNC(value::texcoord3f, TYPE_ID_TEXCOORD3F, C_TINYUSD_VALUE_TEXCOORD3F)    \
+  __FUNC(value::texcoord3d, TYPE_ID_TEXCOORD3D, C_TINYUSD_VALUE_TEXCOORD3D)    \
+  __FUNC(value::normal3h, TYPE_ID_NORMAL3H, C_TINYUSD_VALUE_NORMAL3H)          \
+  __FUNC(value::normal3f, TYPE_ID_NORMAL3F, C_TINYUSD_VALUE_NORMAL3F)          \
+  __FUNC(value::normal3d, TYPE_ID_NORMAL3D, C_TINYUSD_VALUE_NORMAL3D)          \
+  __FUNC(value::vector3h, TYPE_ID_VECTOR3H, C_TINYUSD_VALUE_VECTOR3H)          \
+  __FUNC(value::vector3f, TYPE_ID_VECTOR3F, C_TINYUSD_VALUE_VECTOR3F)          \
+  __FUNC(value::vector3d, TYPE_ID_VECTOR3D, C_TINYUSD_VALUE_VECTOR3D)          \
+  __FUNC(value::point3h, TYPE_ID_POINT3H, C_TINYUSD_VALUE_POINT3H)             \
+  __FUNC(value::point3f, TYPE_ID_POINT3F, C_TINYUSD_VALUE_POINT3F)             \
+  __FUNC(value::point3d, TYPE_ID_POINT3D, C_TINYUSD_VALUE_POINT3D)             \
+  __FUNC(value::matrix2d, TYPE_ID_MATRIX2D, C_TINYUSD_VALUE_MATRIX2D)          \
+  __FUNC(value::matrix3d, TYPE_ID_MATRIX3D, C_TINYUSD_VALUE_MATRIX3D)          \
+  __FUNC(value::matrix4d, TYPE_ID_MATRIX4D, C_TINYUSD_VALUE_MATRIX4D)          \
+  __FUNC(value::frame4d, TYPE_ID_FRAME4D, C_TINYUSD_VALUE_FRAME4D)
+
+// `tyid` must not have array bit.
+CTinyUSDValueType ToCValueType(uint32_t tyid) {
+  using namespace tinyusdz::value;
 
-  bool is_array = false;
-  if (tyid & tinyusdz::value::TYPE_ID_1D_ARRAY_BIT) {
-    is_array = true;
-    // turn of array bit
-    tyid = tyid & (~tinyusdz::value::TYPE_ID_1D_ARRAY_BIT);
+  switch (tyid) {
+#define TO_C_VALUE_TYPE(__ty, __tyid, __cty) \
+  case __tyid: {                             \
+    return __cty;                            \
   }
 
-  using namespace tinyusdz::value;
+    C_TINYUSD_FOREACH_NUMERIC_TYPE(TO_C_VALUE_TYPE)
 
-  uint32_t basety = C_TINYUSD_VALUE_UNKNOWN;
+#undef TO_C_VALUE_TYPE
 
-  switch (tyid) {
     case TYPE_ID_BOOL: {
-      basety = C_TINYUSD_VALUE_BOOL;
-      break;
-    }
-    case TYPE_ID_INT32: {
-      basety = C_TINYUSD_VALUE_INT;
-      break;
-    }
-    case TYPE_ID_INT2: {
-      basety = C_TINYUSD_VALUE_INT2;
-      break;
-    }
-    case TYPE_ID_INT3: {
-      basety = C_TINYUSD_VALUE_INT3;
-      break;
+      return C_TINYUSD_VALUE_BOOL;
     }
-    case TYPE_ID_INT4: {
-      basety = C_TINYUSD_VALUE_INT4;
-      break;
-    }
-    case TYPE_ID_UINT32: {
-      basety = C_TINYUSD_VALUE_UINT;
-      break;
-    }
-    case TYPE_ID_UINT2: {
-      basety = C_TINYUSD_VALUE_UINT2;
-      break;
-    }
-    case TYPE_ID_UINT3: {
-      basety = C_TINYUSD_VALUE_UINT3;
-      break;
+    case TYPE_ID_CUSTOMDATA: {
+      return C_TINYUSD_VALUE_DICTIONARY;
     }
-    case TYPE_ID_UINT4: {
-      basety = C_TINYUSD_VALUE_UINT4;
+    // TODO: token, string
+    default: {
       break;
     }
-    case TYPE_ID_CUSTOMDATA: {
-      basety = C_TINYUSD_VALUE_DICTIONARY;
-      break;
+  }
+
+  return C_TINYUSD_VALUE_UNKNOWN;
+}
+
+template <typename T>
+void SetArrayView(const T *data, size_t n, CTinyUSDValueType value_type,
+                  c_tinyusd_array_view_t *view) {
+  view->data = n ? reinterpret_cast<const void *>(data) : nullptr;
+  view->count = uint64_t(n);
+  view->stride = uint32_t(sizeof(T));
+  view->value_type = value_type;
+}
+
+// View of numeric(array or scalar) value. No copy.
+bool GetValueView(const tinyusdz::value::Value &v,
+                  c_tinyusd_array_view_t *view) {
+  using namespace tinyusdz;
+
+  uint32_t tyid = v.type_id();
+  bool is_array = tyid & value::TYPE_ID_1D_ARRAY_BIT;
+  tyid = tyid & (~value::TYPE_ID_1D_ARRAY_BIT);
+
+  switch (tyid) {
+#define VALUE_VIEW(__ty, __tyid, __cty)                     \
+  case value::__tyid: {                                     \
+    if (is_array) {                                         \
+      const auto *pv = v.as<std::vector<__ty>>();           \
+      if (!pv) {                                            \
+        return false;                                       \
+      }                                                     \
+      SetArrayView(pv->data(), pv->size(), __cty, view);    \
+    } else {                                                \
+      const auto *pv = v.as<__ty>();                        \
+      if (!pv) {                                            \
+        return false;                                       \
+      }                                                     \
+      SetArrayView(pv, 1, __cty, view);                     \
+    }                                                       \
+    return true;                                            \
+  }
+
+    C_TINYUSD_FOREACH_NUMERIC_TYPE(VALUE_VIEW)
+
+#undef VALUE_VIEW
+
+    case value::TYPE_ID_BOOL: {
+      // std::vector<bool> is not contiguous.
+      if (is_array) {
+        return false;
+      }
+      const bool *pv = v.as<bool>();
+      if (!pv) {
+        return false;
+      }
+      SetArrayView(pv, 1, C_TINYUSD_VALUE_BOOL, view);
+      return true;
     }
-    // TODO
     default: {
       break;
     }
   }
 
+  return false;
+}
+
+}  // namespace
+
+CTinyUSDValueType c_tinyusd_value_type(const CTinyUSDValue *value) {
+  if (!value) {
+    return C_TINYUSD_VALUE_UNKNOWN;
+  }
+
+  const tinyusdz::value::Value *pv = reinterpret_cast<const tinyusdz::value::Value *>(value);
+  uint32_t tyid = pv->type_id();
+
+  bool is_array = false;
+  if (tyid & tinyusdz::value::TYPE_ID_1D_ARRAY_BIT) {
+    is_array = true;
+    // turn of array bit
+    tyid = tyid & (~tinyusdz::value::TYPE_ID_1D_ARRAY_BIT);
+  }
+
+  uint32_t basety = ToCValueType(tyid);
+
   if (is_array) {
     return static_cast<CTinyUSDValueType>(basety | C_TINYUSD_VALUE_1D_BIT);
   } else {
@@ -88,6 +193,26 @@ CTinyUSDValueType c_tinyusd_value_type(const CTinyUSDValue *value) {
   }
 }
 
+int c_tinyusd_value_get_array_view(const CTinyUSDValue *value,
+                                   c_tinyusd_array_view_t *view) {
+  if (!value) {
+    return 0;
+  }
+
+  if (!view) {
+    return 0;
+  }
+
+  const tinyusdz::value::Value *pv =
+      reinterpret_cast<const tinyusdz::value::Value *>(value);
+
+  if (!GetValueView(*pv, view)) {
+    return 0;
+  }
+
+  return 1;
+}
+
 const char *c_tinyusd_value_type_name(CTinyUSDValueType value_type) {
   // 32 should be enough length to support all C_TINYUSD_VALUE_* type name +
   // '[]'
@@ -182,6 +307,10 @@ const char *c_tinyusd_value_type_name(CTinyUSDValueType value_type) {
       tyname = "uint64";
       break;
     }
+    case C_TINYUSD_VALUE_UCHAR: {
+      tyname = "uchar";
+      break;
+    }
     case C_TINYUSD_VALUE_FLOAT: {
       tyname = "float";
       break;
@@ -427,6 +556,9 @@ uint32_t c_tinyusd_value_type_components(CTinyUSDValueType value_type) {
     case C_TINYUSD_VALUE_UINT64: {
       return 1;
     }
+    case C_TINYUSD_VALUE_UCHAR: {
+      return 1;
+    }
     case C_TINYUSD_VALUE_FLOAT: {
       return 1;
     }
@@ -612,6 +744,9 @@ uint32_t c_tinyusd_value_type_is_numeric(CTinyUSDValueType value_type) {
     case C_TINYUSD_VALUE_UINT64: {
       return 1;
     }
+    case C_TINYUSD_VALUE_UCHAR: {
+      return 1;
+    }
     case C_TINYUSD_VALUE_FLOAT: {
       return 1;
     }
@@ -797,6 +932,9 @@ uint32_t c_tinyusd_value_type_sizeof(CTinyUSDValueType value_type) {
     case C_TINYUSD_VALUE_UINT64: {
       return sizeof(uint64_t);
     }
+    case C_TINYUSD_VALUE_UCHAR: {
+      return sizeof(uint8_t);
+    }
     case C_TINYUSD_VALUE_FLOAT: {
       return sizeof(float);
     }
@@ -1993,6 +2131,539 @@ int c_tinyusd_stage_traverse(const CTinyUSDStage *_stage,
   return 1;
 }
 
+int c_tinyusd_stage_get_prim_at_path(const CTinyUSDStage *_stage,
+                                     const char *abs_path,
+                                     const CTinyUSDPrim **prim) {
+  if (!_stage || !abs_path || !prim) {
+    return 0;
+  }
+
+  const tinyusdz::Stage *pstage =
+      reinterpret_cast<const tinyusdz::Stage *>(_stage);
+
+  tinyusdz::Path path(abs_path, "");
+  if (!path.is_valid()) {
+    return 0;
+  }
+
+  auto ret = pstage->GetPrimAtPath(path);
+  if (!ret) {
+    return 0;
+  }
+
+  (*prim) = reinterpret_cast<const CTinyUSDPrim *>(ret.value());
+
+  return 1;
+}
+
+namespace {
+
+struct AttributeViewQuery {
+  int64_t sample_index{-1};  // -1 = default value.
+  double time{0.0};          // [out] time of the sample
+  uint64_t num_samples{0};   // [out]
+};
+
+template <typename T>
+bool AnimatableArrayView(
+    const TypedAttribute<Animatable<std::vector<T>>> &attr,
+    CTinyUSDValueType value_type, AttributeViewQuery *q,
+    c_tinyusd_array_view_t *view) {
+  const Animatable<std::vector<T>> *pa = attr.get_value_ptr();
+  if (!pa) {
+    return false;
+  }
+
+  const auto &samples = pa->get_timesamples().get_samples();
+  q->num_samples = samples.size();
+
+  if (q->sample_index < 0) {
+    const std::vector<T> *pv = pa->get_scalar_ptr();
+    if (!pv) {
+      return false;
+    }
+    SetArrayView(pv->data(), pv->size(), value_type, view);
+    return true;
+  }
+
+  if (uint64_t(q->sample_index) >= samples.size()) {
+    return false;
+  }
+
+  const auto &sample = samples[size_t(q->sample_index)];
+  q->time = sample.t;
+  if (sample.blocked) {
+    return false;
+  }
+
+  SetArrayView(sample.value.data(), sample.value.size(), value_type, view);
+  return true;
+}
+
+bool PrimVarView(const primvar::PrimVar &var, AttributeViewQuery *q,
+                 c_tinyusd_array_view_t *view) {
+  const auto &samples = var.ts_raw().get_samples();
+  q->num_samples = samples.size();
+
+  if (q->sample_index < 0) {
+    if (!var.has_default() || var.is_blocked()) {
+      return false;
+    }
+    return GetValueView(var.value_raw(), view);
+  }
+
+  if (uint64_t(q->sample_index) >= samples.size()) {
+    return false;
+  }
+
+  const auto &sample = samples[size_t(q->sample_index)];
+  q->time = sample.t;
+  if (sample.blocked) {
+    return false;
+  }
+
+  return GetValueView(sample.value, view);
+}
+
+const Property *FindProperty(const Prim &prim, const std::string &name) {
+  const std::map<std::string, Property> *props = nullptr;
+
+#define PRIM_PROPS(__ty)                     \
+  if (const __ty *pp = prim.as<__ty>()) {    \
+    props = &pp->props;                      \
+  } else
+
+  APPLY_FUNC_TO_PRIM_TYPES(PRIM_PROPS) {
+    // Unknown Prim type.
+    return nullptr;
+  }
+
+#undef PRIM_PROPS
+
+  auto it = props->find(name);
+  if (it == props->end()) {
+    return nullptr;
+  }
+
+  return &(it->second);
+}
+
+bool GetAttributeView(const Prim &prim, const std::string &name,
+                      AttributeViewQuery *q, c_tinyusd_array_view_t *view) {
+  if (const GeomMesh *mesh = prim.as<GeomMesh>()) {
+    if (name == "points") {
+      return AnimatableArrayView(mesh->points, C_TINYUSD_VALUE_POINT3F, q,
+                                 view);
+    } else if (name == "normals") {
+      return AnimatableArrayView(mesh->normals, C_TINYUSD_VALUE_NORMAL3F, q,
+                                 view);
+    } else if (name == "velocities") {
+      return AnimatableArrayView(mesh->velocities, C_TINYUSD_VALUE_VECTOR3F,
+                                 q, view);
+    } else if (name == "faceVertexCounts") {
+      return AnimatableArrayView(mesh->faceVertexCounts, C_TINYUSD_VALUE_INT,
+                                 q, view);
+    } else if (name == "faceVertexIndices") {
+      return AnimatableArrayView(mesh->faceVertexIndices, C_TINYUSD_VALUE_INT,
+                                 q, view);
+    }
+  }
+
+  const Property *prop = FindProperty(prim, name);
+  if (!prop || !prop->is_attribute()) {
+    return false;
+  }
+
+  return PrimVarView(prop->get_attribute().get_var(), q, view);
+}
+
+}  // namespace
+
+int c_tinyusd_prim_get_attribute_array_view(const CTinyUSDPrim *prim,
+                                            const char *attr_name,
+                                            c_tinyusd_array_view_t *view) {
+  if (!prim || !attr_name || !view) {
+    return 0;
+  }
+
+  const Prim *p = reinterpret_cast<const Prim *>(prim);
+
+  AttributeViewQuery q;
+  if (!GetAttributeView(*p, attr_name, &q, view)) {
+    return 0;
+  }
+
+  return 1;
+}
+
+uint64_t c_tinyusd_prim_get_attribute_num_timesamples(const CTinyUSDPrim *prim,
+                                                      const char *attr_name) {
+  if (!prim || !attr_name) {
+    return 0;
+  }
+
+  const Prim *p = reinterpret_cast<const Prim *>(prim);
+
+  AttributeViewQuery q;
+  c_tinyusd_array_view_t view;
+  // Return value is not used. `num_samples` is set when the attribute exists.
+  GetAttributeView(*p, attr_name, &q, &view);
+
+  return q.num_samples;
+}
+
+int c_tinyusd_prim_get_attribute_timesample_view(const CTinyUSDPrim *prim,
+                                                 const char *attr_name,
+                                                 uint64_t sample_index,
+                                                 double *time,
+                                                 c_tinyusd_array_view_t *view) {
+  if (!prim || !attr_name || !view) {
+    return 0;
+  }
+
+  if (sample_index > uint64_t((std::numeric_limits<int64_t>::max)())) {
+    return 0;
+  }
+
+  const Prim *p = reinterpret_cast<const Prim *>(prim);
+
+  AttributeViewQuery q;
+  q.sample_index = int64_t(sample_index);
+  if (!GetAttributeView(*p, attr_name, &q, view)) {
+    return 0;
+  }
+
+  if (time) {
+    (*time) = q.time;
+  }
+
+  return 1;
+}
+
+CTinyUSDRenderScene *c_tinyusd_render_scene_new() {
+  auto *scene = new tinyusdz::tydra::RenderScene();
+  return reinterpret_cast<CTinyUSDRenderScene *>(scene);
+}
+
+int c_tinyusd_render_scene_free(CTinyUSDRenderScene *scene) {
+  if (!scene) {
+    return 0;
+  }
+
+  tinyusdz::tydra::RenderScene *ptr =
+      reinterpret_cast<tinyusdz::tydra::RenderScene *>(scene);
+  delete ptr;
+
+  return 1;
+}
+
+int c_tinyusd_render_scene_convert(const CTinyUSDStage *_stage,
+                                   const char *usd_filename,
+                                   CTinyUSDRenderScene *scene,
+                                   c_tinyusd_string_t *warn,
+                                   c_tinyusd_string_t *err) {
+  if (!_stage) {
+    if (err) {
+      c_tinyusd_string_replace(err, "`stage` argument is null.\n");
+    }
+    return 0;
+  }
+
+  if (!scene) {
+    if (err) {
+      c_tinyusd_string_replace(err, "`scene` argument is null.\n");
+    }
+    return 0;
+  }
+
+  const Stage *pstage = reinterpret_cast<const Stage *>(_stage);
+  tydra::RenderScene *pscene = reinterpret_cast<tydra::RenderScene *>(scene);
+
+  tydra::RenderSceneConverter converter;
+  tydra::RenderSceneConverterEnv env(*pstage);
+
+  // NOTE: Must be valid until the end of the conversion.
+  USDZAsset usdz_asset;
+
+  std::string filename = usd_filename ? usd_filename : "";
+  if (filename.size()) {
+    if (io::GetFileExtension(filename) == "usdz") {
+      std::string _warn;
+      std::string _err;
+      if (!ReadUSDZAssetInfoFromFile(filename, &usdz_asset, &_warn, &_err)) {
+        if (err) {
+          c_tinyusd_string_replace(
+              err, ("Failed to read USDZ assetInfo: " + _err).c_str());
+        }
+        return 0;
+      }
+
+      if (!SetupUSDZAssetResolution(env.asset_resolver, &usdz_asset)) {
+        if (err) {
+          c_tinyusd_string_replace(
+              err, "Failed to setup AssetResolution for USDZ asset.\n");
+        }
+        return 0;
+      }
+    } else {
+      env.set_search_paths({io::GetBaseDir(filename)});
+    }
+  }
+
+  bool ret = converter.ConvertToRenderScene(env, pscene);
+
+  if (warn) {
+    c_tinyusd_string_replace(warn, converter.GetWarning().c_str());
+  }
+
+  if (!ret) {
+    if (err) {
+      c_tinyusd_string_replace(err, converter.GetError().c_str());
+    }
+    return 0;
+  }
+
+  return 1;
+}
+
+uint64_t c_tinyusd_render_scene_num_meshes(const CTinyUSDRenderScene *scene) {
+  if (!scene) {
+    return 0;
+  }
+
+  const auto *pscene = reinterpret_cast<const tydra::RenderScene *>(scene);
+  return pscene->meshes.size();
+}
+
+uint64_t c_tinyusd_render_scene_num_buffers(const CTinyUSDRenderScene *scene) {
+  if (!scene) {
+    return 0;
+  }
+
+  const auto *pscene = reinterpret_cast<const tydra::RenderScene *>(scene);
+  return pscene->buffers.size();
+}
+
+namespace {
+
+// Element type of VertexAttributeFormat.
+CTinyUSDValueType ToCValueType(tydra::VertexAttributeFormat fmt) {
+  using tydra::VertexAttributeFormat;
+
+  switch (fmt) {
+    case VertexAttributeFormat::Byte: return C_TINYUSD_VALUE_UCHAR;
+    case VertexAttributeFormat::Half: return C_TINYUSD_VALUE_HALF;
+    case VertexAttributeFormat::Half2: return C_TINYUSD_VALUE_HALF2;
+    case VertexAttributeFormat::Half3: return C_TINYUSD_VALUE_HALF3;
+    case VertexAttributeFormat::Half4: return C_TINYUSD_VALUE_HALF4;
+    case VertexAttributeFormat::Float: return C_TINYUSD_VALUE_FLOAT;
+    case VertexAttributeFormat::Vec2: return C_TINYUSD_VALUE_FLOAT2;
+    case VertexAttributeFormat::Vec3: return C_TINYUSD_VALUE_FLOAT3;
+    case VertexAttributeFormat::Vec4: return C_TINYUSD_VALUE_FLOAT4;
+    case VertexAttributeFormat::Int: return C_TINYUSD_VALUE_INT;
+    case VertexAttributeFormat::Ivec2: return C_TINYUSD_VALUE_INT2;
+    case VertexAttributeFormat::Ivec3: return C_TINYUSD_VALUE_INT3;
+    case VertexAttributeFormat::Ivec4: return C_TINYUSD_VALUE_INT4;
+    case VertexAttributeFormat::Uint: return C_TINYUSD_VALUE_UINT;
+    case VertexAttributeFormat::Uvec2: return C_TINYUSD_VALUE_UINT2;
+    case VertexAttributeFormat::Uvec3: return C_TINYUSD_VALUE_UINT3;
+    case VertexAttributeFormat::Uvec4: return C_TINYUSD_VALUE_UINT4;
+    case VertexAttributeFormat::Double: return C_TINYUSD_VALUE_DOUBLE;
+    case VertexAttributeFormat::Dvec2: return C_TINYUSD_VALUE_DOUBLE2;
+    case VertexAttributeFormat::Dvec3: return C_TINYUSD_VALUE_DOUBLE3;
+    case VertexAttributeFormat::Dvec4: return C_TINYUSD_VALUE_DOUBLE4;
+    case VertexAttributeFormat::Dmat2: return C_TINYUSD_VALUE_MATRIX2D;
+    case VertexAttributeFormat::Dmat3: return C_TINYUSD_VALUE_MATRIX3D;
+    case VertexAttributeFormat::Dmat4: return C_TINYUSD_VALUE_MATRIX4D;
+    case VertexAttributeFormat::Bool: return C_TINYUSD_VALUE_BOOL;
+    default: break;
+  }
+
+  return C_TINYUSD_VALUE_UNKNOWN;
+}
+
+bool VertexAttributeView(const tydra::VertexAttribute &attr,
+                         c_tinyusd_array_view_t *view) {
+  if (attr.empty()) {
+    return false;
+  }
+
+  // Tydra does not produce interleaved vertex data, so `attr.stride` is not
+  // considered here.
+  uint32_t elem_bytes =
+      uint32_t(tydra::VertexAttributeFormatSize(attr.format));
+  if (elem_bytes == 0) {
+    return false;
+  }
+
+  view->data = attr.data.data();
+  view->count = attr.data.size() / elem_bytes;
+  view->stride = elem_bytes;
+  view->value_type = ToCValueType(attr.format);
+
+  return true;
+}
+
+const tydra::RenderMesh *GetRenderMesh(const CTinyUSDRenderScene *scene,
+                                       uint64_t mesh_id) {
+  if (!scene) {
+    return nullptr;
+  }
+
+  const auto *pscene = reinterpret_cast<const tydra::RenderScene *>(scene);
+  if (mesh_id >= pscene->meshes.size()) {
+    return nullptr;
+  }
+
+  return &pscene->meshes[size_t(mesh_id)];
+}
+
+}  // namespace
+
+int c_tinyusd_render_mesh_get_array_view(const CTinyUSDRenderScene *scene,
+                                         uint64_t mesh_id,
+                                         CTinyUSDRenderMeshArray array,
+                                         c_tinyusd_array_view_t *view) {
+  if (!view) {
+    return 0;
+  }
+
+  const tydra::RenderMesh *mesh = GetRenderMesh(scene, mesh_id);
+  if (!mesh) {
+    return 0;
+  }
+
+  switch (array) {
+    case C_TINYUSD_RENDER_MESH_POINTS: {
+      if (mesh->points.empty()) {
+        return 0;
+      }
+      SetArrayView(mesh->points.data(), mesh->points.size(),
+                   C_TINYUSD_VALUE_FLOAT3, view);
+      return 1;
+    }
+    case C_TINYUSD_RENDER_MESH_FACE_VERTEX_INDICES: {
+      const std::vector<uint32_t> &v = mesh->faceVertexIndices();
+      if (v.empty()) {
+        return 0;
+      }
+      SetArrayView(v.data(), v.size(), C_TINYUSD_VALUE_UINT, view);
+      return 1;
+    }
+    case C_TINYUSD_RENDER_MESH_FACE_VERTEX_COUNTS: {
+      const std::vector<uint32_t> &v = mesh->faceVertexCounts();
+      if (v.empty()) {
+        return 0;
+      }
+      SetArrayView(v.data(), v.size(), C_TINYUSD_VALUE_UINT, view);
+      return 1;
+    }
+    case C_TINYUSD_RENDER_MESH_NORMALS: {
+      return VertexAttributeView(mesh->normals, view) ? 1 : 0;
+    }
+    case C_TINYUSD_RENDER_MESH_TANGENTS: {
+      return VertexAttributeView(mesh->tangents, view) ? 1 : 0;
+    }
+    case C_TINYUSD_RENDER_MESH_BINORMALS: {
+      return VertexAttributeView(mesh->binormals, view) ? 1 : 0;
+    }
+    case C_TINYUSD_RENDER_MESH_VERTEX_COLORS: {
+      return VertexAttributeView(mesh->vertex_colors, view) ? 1 : 0;
+    }
+    case C_TINYUSD_RENDER_MESH_VERTEX_OPACITIES: {
+      return VertexAttributeView(mesh->vertex_opacities, view) ? 1 : 0;
+    }
+  }
+
+  return 0;
+}
+
+int c_tinyusd_render_mesh_get_texcoord_view(const CTinyUSDRenderScene *scene,
+                                            uint64_t mesh_id, uint32_t slot_id,
+                                            c_tinyusd_array_view_t *view) {
+  if (!view) {
+    return 0;
+  }
+
+  const tydra::RenderMesh *mesh = GetRenderMesh(scene, mesh_id);
+  if (!mesh) {
+    return 0;
+  }
+
+  auto it = mesh->texcoords.find(slot_id);
+  if (it == mesh->texcoords.end()) {
+    return 0;
+  }
+
+  return VertexAttributeView(it->second, view) ? 1 : 0;
+}
+
+int c_tinyusd_render_scene_get_buffer_view(const CTinyUSDRenderScene *scene,
+                                           uint64_t buffer_id,
+                                           c_tinyusd_array_view_t *view) {
+  if (!scene || !view) {
+    return 0;
+  }
+
+  const auto *pscene = reinterpret_cast<const tydra::RenderScene *>(scene);
+  if (buffer_id >= pscene->buffers.size()) {
+    return 0;
+  }
+
+  const tydra::BufferData &buf = pscene->buffers[size_t(buffer_id)];
+
+  CTinyUSDValueType value_type{C_TINYUSD_VALUE_UNKNOWN};
+  uint32_t stride{1};
+  switch (buf.componentType) {
+    case tydra::ComponentType::UInt8: {
+      value_type = C_TINYUSD_VALUE_UCHAR;
+      stride = 1;
+      break;
+    }
+    case tydra::ComponentType::Int8: {
+      stride = 1;
+      break;
+    }
+    case tydra::ComponentType::UInt16:
+    case tydra::ComponentType::Int16: {
+      stride = 2;
+      break;
+    }
+    case tydra::ComponentType::Half: {
+      value_type = C_TINYUSD_VALUE_HALF;
+      stride = 2;
+      break;
+    }
+    case tydra::ComponentType::UInt32: {
+      value_type = C_TINYUSD_VALUE_UINT;
+      stride = 4;
+      break;
+    }
+    case tydra::ComponentType::Int32: {
+      value_type = C_TINYUSD_VALUE_INT;
+      stride = 4;
+      break;
+    }
+    case tydra::ComponentType::Float: {
+      value_type = C_TINYUSD_VALUE_FLOAT;
+      stride = 4;
+      break;
+    }
+    case tydra::ComponentType::Double: {
+      value_type = C_TINYUSD_VALUE_DOUBLE;
+      stride = 8;
+      break;
+    }
+  }
+
+  view->data = buf.data.empty() ? nullptr : buf.data.data();
+  view->count = buf.data.size() / stride;
+  view->stride = stride;
+  view->value_type = value_type;
+
+  return 1;
+}
+
 CTinyUSDValue *c_tinyusd_value_new_null() {
 
   auto *pv = new tinyusdz::value::Value(nullptr);
@@ -184,6 +184,7 @@ typedef enum {
   C_TINYUSD_VALUE_MATRIX4D,
   C_TINYUSD_VALUE_FRAME4D,
   C_TINYUSD_VALUE_DICTIONARY, /* tinyusdz::value::CustomData. VtDictionary equivalent in pxrUSD */
+  C_TINYUSD_VALUE_UCHAR, /* uint8_t. e.g. 8bit texel data of RenderScene */
   C_TINYUSD_VALUE_END, /* terminator */
 } CTinyUSDValueType;
 
@@ -639,6 +640,37 @@ C_TINYUSD_EXPORT CTinyUSDValue *c_tinyusd_value_new_array_float4(
     uint64_t n, const c_tinyusd_float4_t *vals);
 /*   TODO: List up other types... */
 
+/*
+   Borrowed view of (1D array) data.
+
+   `data` points to the internal storage of the owner object(e.g. Stage,
+   RenderScene), so no per-element conversion is involved and an App can copy
+   `count * stride` bytes at once with `memcpy`.
+   The view is valid until the owner object is modified or free'ed. Do not
+   free `data`.
+
+   - `count`: The number of elements.
+   - `stride`: Size of each element in bytes.
+   - `value_type`: Element type(without C_TINYUSD_VALUE_1D_BIT).
+     C_TINYUSD_VALUE_UNKNOWN when the element does not have corresponding
+     CTinyUSDValueType(e.g. int16 buffer). Use `stride` in this case.
+ */
+typedef struct {
+  const void *data;
+  uint64_t count;
+  uint32_t stride;
+  CTinyUSDValueType value_type;
+} c_tinyusd_array_view_t;
+
+/*
+   Get the view of numeric array(or scalar. `count` is 1) value in Value.
+   The view is valid until `value` is modified or free'ed.
+
+   Returns 0 when `value` is not a numeric type(e.g. token, string) or bool[].
+ */
+C_TINYUSD_EXPORT int c_tinyusd_value_get_array_view(
+    const CTinyUSDValue *value, c_tinyusd_array_view_t *view);
+
 /* opaque pointer to tinyusdz::Path */
 typedef struct CTinyUSDPath CTinyUSDPath;
 
@@ -690,7 +722,7 @@ C_TINYUSD_EXPORT int c_tinyusd_attribute_meta_get(
 
 
 #if 0
-   Get i'th targetPaths
+   Get i-th targetPaths
 C_TINYUSD_EXPORT int c_tinyusd_attribute_connection_get(CTinyUSDAttribute *attr, uint32_t n, const CTinyUSDPath *connectionPaths);
 #endif
 
@@ -895,6 +927,126 @@ C_TINYUSD_EXPORT int c_tinyusd_stage_traverse(
     const CTinyUSDStage *stage, CTinyUSDTraversalFunction callback_fun,
     c_tinyusd_string_t *err);
 
+/*
+   Find Prim at absolute path(e.g. "/root/mesh").
+
+   `prim` is just a pointer(valid until the Stage is modified or free'ed), so
+   please do not call Prim deleter(`c_tinyusd_prim_free`) to it.
+
+   Return 0 when the Prim is not found.
+ */
+C_TINYUSD_EXPORT int c_tinyusd_stage_get_prim_at_path(
+    const CTinyUSDStage *stage, const char *abs_path,
+    const CTinyUSDPrim **prim);
+
+/*
+   Bulk array access to Prim attributes.
+
+   Supported attributes are builtin array attributes of GeomMesh(`points`,
+   `normals`, `velocities`, `faceVertexCounts` and `faceVertexIndices`), and
+   attributes stored as generic properties of a Prim of any type(e.g.
+   `primvars:st`, custom attributes). Other builtin attributes(e.g. `radius`
+   of Sphere) are not supported.
+
+   The view borrows the memory of the Prim, and is valid until the Prim(or
+   the Stage owning it) is modified or free'ed.
+   Connected attributes are not resolved.
+ */
+
+/*
+   Get the view of default(non-timesampled) value of the attribute.
+
+   Return 0 when the attribute does not exist, does not have default value,
+   or is not a numeric type.
+ */
+C_TINYUSD_EXPORT int c_tinyusd_prim_get_attribute_array_view(
+    const CTinyUSDPrim *prim, const char *attr_name,
+    c_tinyusd_array_view_t *view);
+
+/*
+   Return the number of time samples of the attribute.
+   Return 0 when the attribute does not exist or has no time samples.
+ */
+C_TINYUSD_EXPORT uint64_t c_tinyusd_prim_get_attribute_num_timesamples(
+    const CTinyUSDPrim *prim, const char *attr_name);
+
+/*
+   Get the view of `sample_index`'th time sample of the attribute. Time
+   samples are sorted by time.
+
+   @param[out] time Time(TimeCode) of the sample.
+
+   Return 0 when `sample_index` is out-of-range, the sample is blocked(None)
+   or the value is not a numeric type.
+ */
+C_TINYUSD_EXPORT int c_tinyusd_prim_get_attribute_timesample_view(
+    const CTinyUSDPrim *prim, const char *attr_name, uint64_t sample_index,
+    double *time, c_tinyusd_array_view_t *view);
+
+/* opaque pointer to tinyusdz::tydra::RenderScene */
+typedef struct CTinyUSDRenderScene CTinyUSDRenderScene;
+
+C_TINYUSD_EXPORT CTinyUSDRenderScene *c_tinyusd_render_scene_new();
+C_TINYUSD_EXPORT int c_tinyusd_render_scene_free(CTinyUSDRenderScene *scene);
+
+/*
+   Convert Stage to RenderScene(renderer-friendly mesh, material and texture
+   data) with default settings.
+
+   @param[in] usd_filename Optional. Filename of the Stage. Used to resolve
+   asset paths(e.g. textures). USDZ assets are resolved when the extension is
+   `.usdz`.
+
+   Return 0 when failed(and `err` will be set).
+ */
+C_TINYUSD_EXPORT int c_tinyusd_render_scene_convert(
+    const CTinyUSDStage *stage, const char *usd_filename,
+    CTinyUSDRenderScene *scene, c_tinyusd_string_t *warn,
+    c_tinyusd_string_t *err);
+
+C_TINYUSD_EXPORT uint64_t
+c_tinyusd_render_scene_num_meshes(const CTinyUSDRenderScene *scene);
+C_TINYUSD_EXPORT uint64_t
+c_tinyusd_render_scene_num_buffers(const CTinyUSDRenderScene *scene);
+
+typedef enum {
+  C_TINYUSD_RENDER_MESH_POINTS,
+  C_TINYUSD_RENDER_MESH_FACE_VERTEX_INDICES, /* triangulated when enabled */
+  C_TINYUSD_RENDER_MESH_FACE_VERTEX_COUNTS,
+  C_TINYUSD_RENDER_MESH_NORMALS,
+  C_TINYUSD_RENDER_MESH_TANGENTS,
+  C_TINYUSD_RENDER_MESH_BINORMALS,
+  C_TINYUSD_RENDER_MESH_VERTEX_COLORS,
+  C_TINYUSD_RENDER_MESH_VERTEX_OPACITIES,
+} CTinyUSDRenderMeshArray;
+
+/*
+   Get the view of RenderMesh's array. For vertex attributes with
+   `elementSize` > 1, `count` is the number of vertices x `elementSize`.
+   The view is valid until `scene` is modified or free'ed.
+
+   Return 0 when `mesh_id` is out-of-range or the array is empty.
+ */
+C_TINYUSD_EXPORT int c_tinyusd_render_mesh_get_array_view(
+    const CTinyUSDRenderScene *scene, uint64_t mesh_id,
+    CTinyUSDRenderMeshArray array, c_tinyusd_array_view_t *view);
+
+/*
+   Get the view of RenderMesh's texcoord of slot `slot_id`(usually 0 =
+   primary).
+ */
+C_TINYUSD_EXPORT int c_tinyusd_render_mesh_get_texcoord_view(
+    const CTinyUSDRenderScene *scene, uint64_t mesh_id, uint32_t slot_id,
+    c_tinyusd_array_view_t *view);
+
+/*
+   Get the view of RenderScene's buffer(e.g. texel data of TextureImage).
+   `value_type` is the component type of the buffer.
+ */
+C_TINYUSD_EXPORT int c_tinyusd_render_scene_get_buffer_view(
+    const CTinyUSDRenderScene *scene, uint64_t buffer_id,
+    c_tinyusd_array_view_t *view);
+
 /*
    Detect file format of input file.
  */
@@ -13,6 +13,7 @@
 #include "asset-resolution.hh"
 #include "common-macros.inc"
 #include "io-util.hh"
+#include "performance.hh"
 #include "pprinter.hh"
 #include "prim-pprint.hh"
 #include "prim-reconstruct.hh"
@@ -287,7 +288,9 @@ bool LoadAsset(AssetResolutionResolver &resolver,
   std::string _err;
 
   if (IsUSDFileFormat(asset_path)) {
-    if (!LoadLayerFromMemory(asset.data(), asset.size(), asset_path, &layer,
+    // Read through const accessor so that a view Asset is not copied.
+    const Asset &casset = asset;
+    if (!LoadLayerFromMemory(casset.data(), casset.size(), asset_path, &layer,
                              &_warn, &_err)) {
       PUSH_ERROR_AND_RETURN(
           fmt::format("Failed to open `{}` as Layer: {}", asset_path, _err));
@@ -511,6 +514,7 @@ bool CompositeSublayers(AssetResolutionResolver &resolver,
                         const Layer &in_layer, Layer *composited_layer,
                         std::string *warn, std::string *err,
                         SublayersCompositionOptions options) {
+  TINYUSDZ_TRACE_ZONE("CompositeSublayers");
   if (!composited_layer) {
     return false;
   }
@@ -1044,6 +1048,7 @@ bool CompositeReferences(AssetResolutionResolver &resolver,
                          const Layer &in_layer, Layer *composited_layer,
                          std::string *warn, std::string *err,
                          ReferencesCompositionOptions options) {
+  TINYUSDZ_TRACE_ZONE("CompositeReferences");
   if (!composited_layer) {
     return false;
   }
@@ -1068,6 +1073,7 @@ bool CompositeReferences(AssetResolutionResolver &resolver,
 bool CompositePayload(AssetResolutionResolver &resolver, const Layer &in_layer,
                       Layer *composited_layer, std::string *warn,
                       std::string *err, PayloadCompositionOptions options) {
+  TINYUSDZ_TRACE_ZONE("CompositePayload");
   if (!composited_layer) {
     return false;
   }
@@ -1090,6 +1096,7 @@ bool CompositePayload(AssetResolutionResolver &resolver, const Layer &in_layer,
 
 bool CompositeVariant(const Layer &in_layer, Layer *composited_layer,
                       std::string *warn, std::string *err) {
+  TINYUSDZ_TRACE_ZONE("CompositeVariant");
   if (!composited_layer) {
     return false;
   }
@@ -1110,6 +1117,7 @@ bool CompositeVariant(const Layer &in_layer, Layer *composited_layer,
 
 bool CompositeInherits(const Layer &in_layer, Layer *composited_layer,
                        std::string *warn, std::string *err) {
+  TINYUSDZ_TRACE_ZONE("CompositeInherits");
   if (!composited_layer) {
     return false;
   }
@@ -1213,6 +1221,30 @@ static nonstd::optional<Prim> ReconstructPrimFromPrimSpec(
 #undef RECONSTRUCT_PRIM
 }
 
+// Reconstruct Prim and its descendants.
+static nonstd::optional<Prim> ReconstructPrimTreeFromPrimSpec(
+    uint32_t depth, const PrimSpec &primspec, std::string *warn,
+    std::string *err) {
+  if (depth > (1024 * 1024 * 128)) {
+    PUSH_ERROR("PrimSpec tree too deep.");
+    return nonstd::nullopt;
+  }
+
+  auto pv = ReconstructPrimFromPrimSpec(primspec, warn, err);
+  if (!pv) {
+    return nonstd::nullopt;
+  }
+
+  for (const auto &child : primspec.children()) {
+    if (auto cv =
+            ReconstructPrimTreeFromPrimSpec(depth + 1, child, warn, err)) {
+      pv.value().add_child(std::move(cv.value()));
+    }
+  }
+
+  return pv;
+}
+
 static bool OverridePrimSpecRec(uint32_t depth, PrimSpec &dst,
                                 const PrimSpec &src, std::string *warn,
                                 std::string *err) {
@@ -1329,13 +1361,16 @@ bool LayerToStage(const Layer &layer, Stage *stage_out, std::string *warn,
 
   // TODO: primChildren metadatum
   for (const auto &primspec : layer.primspecs()) {
-    if (auto pv =
-            detail::ReconstructPrimFromPrimSpec(primspec.second, warn, err)) {
+    if (auto pv = detail::ReconstructPrimTreeFromPrimSpec(
+            /* depth */ 0, primspec.second, warn, err)) {
       stage.add_root_prim(std::move(pv.value()));
     }
   }
 
-  (*stage_out) = stage;
+  // Assign absolute paths and Prim ids of the reconstructed Prims.
+  stage.commit();
+
+  (*stage_out) = std::move(stage);
 
   return true;
 }
@@ -29,6 +29,7 @@
 #include "integerCoding.h"
 #include "lz4-compression.hh"
 #include "path-util.hh"
+#include "performance.hh"
 #include "pprinter.hh"
 #include "prim-types.hh"
 #include "stream-reader.hh"
@@ -63,16 +64,27 @@ namespace crate {
 
 #define kTag "[Crate]"
 
+// `_memoryUsage` only counts bytes reserved in `memoryBudget`(released in
+// ~CrateReader), so it is incremented after both checks succeeded.
 #define CHECK_MEMORY_USAGE(__nbytes) do { \
-  _memoryUsage += (__nbytes); \
-  if (_memoryUsage > _config.maxMemoryBudget) { \
+  if ((_memoryUsage + (__nbytes)) > _config.maxMemoryBudget) { \
     PUSH_ERROR_AND_RETURN_TAG(kTag, "Reached to max memory budget."); \
   }  \
+  if (_config.memoryBudget) { \
+    std::string _budget_err; \
+    if (!_config.memoryBudget->reserve(MemoryCategory::CrateTables, (__nbytes), &_budget_err)) { \
+      PUSH_ERROR_AND_RETURN_TAG(kTag, _budget_err); \
+    } \
+  } \
+  _memoryUsage += (__nbytes); \
   } while(0)
 
 #define REDUCE_MEMORY_USAGE(__nbytes) do { \
-  if (_memoryUsage < (__nbytes)) { \
+  if (_memoryUsage >= (__nbytes)) { \
     _memoryUsage -= (__nbytes); \
+    if (_config.memoryBudget) { \
+      _config.memoryBudget->release(MemoryCategory::CrateTables, (__nbytes)); \
+    } \
   } \
   } while(0)
 
@@ -108,6 +120,10 @@ CrateReader::CrateReader(StreamReader *sr, const CrateReaderConfig &config) : _s
 }
 
 CrateReader::~CrateReader() {
+  if (_config.memoryBudget) {
+    _config.memoryBudget->release(MemoryCategory::CrateTables, _memoryUsage);
+  }
+
   //delete _impl;
   //_impl = nullptr;
 }
@@ -761,6 +777,7 @@ bool CrateReader::ReadDoubleArray(bool is_compressed, std::vector<double> *d) {
 }
 
 bool CrateReader::ReadTimeSamples(value::TimeSamples *d) {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadTimeSamples");
 
   // Layout
   //
@@ -2307,6 +2324,7 @@ CrateReader::UnpackArrayValue(CrateDataTypeId dty, crate::CrateValue *value_out)
 
 bool CrateReader::UnpackValueRep(const crate::ValueRep &rep,
                                  crate::CrateValue *value) {
+  TINYUSDZ_TRACE_ZONE("CrateReader::UnpackValueRep");
   if (rep.IsInlined()) {
     return UnpackInlinedValueRep(rep, value);
   }
@@ -5140,6 +5158,7 @@ bool CrateReader::BuildNodeHierarchy(
 #endif
 
 bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadCompressedPaths");
   std::vector<uint32_t> pathIndexes;
   std::vector<int32_t> elementTokenIndexes;
   std::vector<int32_t> jumps;
@@ -5406,6 +5425,7 @@ bool CrateReader::ReadSection(crate::Section *s) {
 }
 
 bool CrateReader::ReadTokens() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadTokens");
   if ((_tokens_index < 0) || (_tokens_index >= int64_t(_toc.sections.size()))) {
     PUSH_ERROR_AND_RETURN_TAG(kTag, "Invalid index for `TOKENS` section.");
   }
@@ -5583,6 +5603,7 @@ bool CrateReader::ReadTokens() {
 }
 
 bool CrateReader::ReadStrings() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadStrings");
   if ((_strings_index < 0) ||
       (_strings_index >= int64_t(_toc.sections.size()))) {
     _err += "Invalid index for `STRINGS` section.\n";
@@ -5615,6 +5636,7 @@ bool CrateReader::ReadStrings() {
 }
 
 bool CrateReader::ReadFields() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadFields");
   if ((_fields_index < 0) || (_fields_index >= int64_t(_toc.sections.size()))) {
     _err += "Invalid index for `FIELDS` section.\n";
     return false;
@@ -5747,6 +5769,7 @@ bool CrateReader::ReadFields() {
 }
 
 bool CrateReader::ReadFieldSets() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadFieldSets");
   if ((_fieldsets_index < 0) ||
       (_fieldsets_index >= int64_t(_toc.sections.size()))) {
     _err += "Invalid index for `FIELDSETS` section.\n";
@@ -5852,13 +5875,42 @@ bool CrateReader::ReadFieldSets() {
 }
 
 bool CrateReader::BuildLiveFieldSets() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::BuildLiveFieldSets");
+
+  // FieldSets referenced from Specs within the population mask.
+  const bool use_population_mask = !_config.populationMask.empty();
+  std::unordered_set<uint32_t> masked_fieldsets;
+  if (use_population_mask) {
+    for (const auto &spec : _specs) {
+      if (spec.path_index.value >= _paths.size()) {
+        continue;
+      }
+
+      if (pathutil::IsPathInPopulationMask(_paths[spec.path_index.value],
+                                           _config.populationMask)) {
+        masked_fieldsets.insert(spec.fieldset_index.value);
+      }
+    }
+    DCOUT("# of FieldSets in population mask = " << masked_fieldsets.size());
+  }
+
   for (auto fsBegin = _fieldset_indices.begin(),
             fsEnd = std::find(fsBegin, _fieldset_indices.end(), crate::Index());
        fsBegin != _fieldset_indices.end();
        fsBegin = fsEnd + 1, fsEnd = std::find(fsBegin, _fieldset_indices.end(),
                                               crate::Index())) {
-    auto &pairs = _live_fieldsets[crate::Index(
-        uint32_t(fsBegin - _fieldset_indices.begin()))];
+    const uint32_t fieldset_index =
+        uint32_t(fsBegin - _fieldset_indices.begin());
+
+    if (use_population_mask && !masked_fieldsets.count(fieldset_index)) {
+      // Skip unpacking values.
+      if (fsEnd == _fieldset_indices.end()) {
+        break;
+      }
+      continue;
+    }
+
+    auto &pairs = _live_fieldsets[crate::Index(fieldset_index)];
 
     pairs.resize(size_t(fsEnd - fsBegin));
     DCOUT("range size = " << (fsEnd - fsBegin));
@@ -5907,6 +5959,7 @@ bool CrateReader::BuildLiveFieldSets() {
 }
 
 bool CrateReader::ReadSpecs() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadSpecs");
   if ((_specs_index < 0) || (_specs_index >= int64_t(_toc.sections.size()))) {
     PUSH_ERROR("Invalid index for `SPECS` section.");
     return false;
@@ -6093,6 +6146,7 @@ bool CrateReader::ReadSpecs() {
 }
 
 bool CrateReader::ReadPaths() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadPaths");
   if ((_paths_index < 0) || (_paths_index >= int64_t(_toc.sections.size()))) {
     PUSH_ERROR("Invalid index for `PATHS` section.");
     return false;
@@ -6213,6 +6267,7 @@ bool CrateReader::ReadBootStrap() {
 }
 
 bool CrateReader::ReadTOC() {
+  TINYUSDZ_TRACE_ZONE("CrateReader::ReadTOC");
 
   DCOUT(fmt::format("Memory budget: {} bytes", _config.maxMemoryBudget));
 
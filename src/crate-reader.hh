@@ -10,6 +10,7 @@
 #include "nonstd/optional.hpp"
 //
 #include "crate-format.hh"
+#include "memory-budget.hh"
 #include "prim-types.hh"
 #include "stream-reader.hh"
 
@@ -54,6 +55,16 @@ struct CrateReaderConfig {
   // Total memory budget for uncompressed USD data(vertices, `tokens`, ...)` in
   // [bytes].
   size_t maxMemoryBudget = std::numeric_limits<int32_t>::max();  // Default 2GB
+
+  // Optional. Memory usage is also accounted to `MemoryCategory::CrateTables`
+  // of this budget(shared with other loaders), and reading fails when the
+  // budget is exceeded. Reserved memory is released in ~CrateReader().
+  MemoryBudget *memoryBudget{nullptr};
+
+  // Optional. Population mask(list of absolute Prim paths).
+  // When non-empty, values of Specs outside of the mask are not unpacked.
+  // See `pathutil::IsPathInPopulationMask` for details.
+  std::vector<Path> populationMask;
 };
 
 ///
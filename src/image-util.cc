@@ -1,12 +1,22 @@
 // SPDX-License-Identifier: Apache 2.0
 // Copyright 2023-Present, Light Transport Entertainment Inc.
 //
-// TODO
-// - [ ] Optimize Rec.709 conversion
+// Color space conversion kernels use 256/65536-entry LUTs for 8bit/16bit
+// inputs(LUT entries are computed with the same scalar transfer functions, so
+// results are bit-identical to per-texel evaluation), SSE2 for 3x3 color
+// matrices(RGBA) and process rows in parallel for large images.
 //
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TINYUSDZ_IMAGE_UTIL_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Weverything"
@@ -36,6 +46,7 @@
 #endif
 
 #include "image-util.hh"
+#include "parallel-for.hh"
 #include "value-types.hh"
 #include "common-macros.inc"
 #include "tiny-format.hh"
@@ -341,7 +352,7 @@ float Rec709ToLinear(uint8_t v) {
   float V = v / 255.0f;
 
   float L;
-  if (V > 0.081f) {
+  if (V < 0.081f) {
     L = V / 4.5f;
   } else {
     L = std::pow((V + 0.099f)/1.099f, (1.0f/0.45f));
@@ -351,6 +362,213 @@ float Rec709ToLinear(uint8_t v) {
 
 }
 
+//
+// Lookup tables for 8bit input. Initialized once(thread-safe).
+//
+
+const float *GetU8ToF32Table() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> t;
+    for (size_t u = 0; u < 256; u++) {
+      t[u] = float(u) / 255.0f;
+    }
+    return t;
+  }();
+  return table.data();
+}
+
+const float *GetSrgb8ToLinearF32Table() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> t;
+    for (size_t u = 0; u < 256; u++) {
+      t[u] = SrgbTransform::srgbToLinear(float(u) / 255.0f);
+    }
+    return t;
+  }();
+  return table.data();
+}
+
+const uint8_t *GetSrgb8ToLinear8Table() {
+  static const std::array<uint8_t, 256> table = [] {
+    std::array<uint8_t, 256> t;
+    for (size_t u = 0; u < 256; u++) {
+      t[u] = f32_to_u8(SrgbTransform::srgbToLinear(float(u) / 255.0f));
+    }
+    return t;
+  }();
+  return table.data();
+}
+
+const float *GetRec709_8ToLinearF32Table() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> t;
+    for (size_t u = 0; u < 256; u++) {
+      t[u] = Rec709ToLinear(uint8_t(u));
+    }
+    return t;
+  }();
+  return table.data();
+}
+
+//
+// fp32 linear -> 8bit sRGB.
+//
+// Float bits of x in [0.0, 1.0) are bucketed by exponent and upper 8 bits of
+// mantissa. Each bucket stores the largest sRGB value `y` such that
+// SRGB_8BIT_TO_LINEAR_FLOAT[y] <= (the smallest x in the bucket), so only a few
+// steps are required to reach the result of the binary search in
+// SrgbTransform::linearToSrgb8bit. The result is identical except for NaN
+// input(0 is returned).
+//
+constexpr uint32_t kLinearToSrgb8BucketShift = 15;
+constexpr uint32_t kLinearToSrgb8NumBuckets =
+    (0x3f800000u >> kLinearToSrgb8BucketShift) + 1;
+
+const uint8_t *GetLinearToSrgb8BucketTable() {
+  static const std::vector<uint8_t> table = [] {
+    const float *TABLE = SrgbTransform::SRGB_8BIT_TO_LINEAR_FLOAT;
+    std::vector<uint8_t> t(kLinearToSrgb8NumBuckets);
+    uint32_t y = 0;
+    for (uint32_t k = 0; k < kLinearToSrgb8NumBuckets; k++) {
+      uint32_t bits = k << kLinearToSrgb8BucketShift;
+      float lo;
+      memcpy(&lo, &bits, sizeof(float));
+      while ((y < 255) && (TABLE[y + 1] <= lo)) {
+        y++;
+      }
+      t[k] = uint8_t(y);
+    }
+    return t;
+  }();
+  return table.data();
+}
+
+inline uint8_t LinearToSrgb8bit(const uint8_t *bucket_table, float x) {
+  if (!(x > 0.0f)) {
+    return 0;
+  }
+  if (x >= 1.0f) {
+    return 255;
+  }
+
+  const float *TABLE = SrgbTransform::SRGB_8BIT_TO_LINEAR_FLOAT;
+
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(float));
+  uint32_t y = bucket_table[bits >> kLinearToSrgb8BucketShift];
+  while ((y < 255) && (TABLE[y + 1] <= x)) {
+    y++;
+  }
+
+  // y < 255 since x < 1.0
+  if (x - TABLE[y] <= TABLE[y + 1] - x) {
+    return uint8_t(y);
+  }
+  return uint8_t(y + 1);
+}
+
+// Build 16bit LUT only when the image has enough texels to amortize the cost
+// of building the table.
+constexpr size_t kHalfLUTMinTexels = 4 * 65536;
+
+// Minimum # of texels processed per parallel task.
+constexpr size_t kParallelGrainTexels = 64 * 1024;
+
+///
+/// Call `f(y_begin, y_end)` for row ranges of the image.
+/// Rows are processed in parallel for large images.
+///
+template <typename F>
+void ForEachRowRange(size_t width, size_t height, size_t channels, F &&f) {
+  size_t row_texels = (std::max)(size_t(1), width * channels);
+  size_t grain = (std::max)(size_t(1), kParallelGrainTexels / row_texels);
+  parallel::ParallelForChunked(
+      height,
+      [&f](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        f(begin, end);
+      },
+      -1, grain);
+}
+
+///
+/// out = max(M * in.rgb, 0) for `num_pixels` pixels. M is row-major 3x3 matrix.
+/// Alpha(channels = 4) is copied as-is.
+///
+/// SSE2 path evaluates the same arithmetic in the same order as the scalar path,
+/// so results are identical except for NaN input(SSE2 path produces 0).
+///
+void ApplyColorMatrix3x3(const float *in, float *out, size_t num_pixels,
+                         size_t channels, const float M[9]) {
+  if (channels == 4) {
+#if defined(TINYUSDZ_IMAGE_UTIL_USE_SSE2)
+    const __m128 c0 = _mm_setr_ps(M[0], M[3], M[6], 0.0f);
+    const __m128 c1 = _mm_setr_ps(M[1], M[4], M[7], 0.0f);
+    const __m128 c2 = _mm_setr_ps(M[2], M[5], M[8], 0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 alpha_mask =
+        _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+    for (size_t i = 0; i < num_pixels; i++) {
+      __m128 p = _mm_loadu_ps(in + 4 * i);
+      __m128 r = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+      __m128 g = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+      __m128 b = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+
+      __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, r), _mm_mul_ps(c1, g)),
+                            _mm_mul_ps(c2, b));
+      v = _mm_max_ps(v, zero);
+
+      // restore alpha
+      v = _mm_or_ps(_mm_andnot_ps(alpha_mask, v), _mm_and_ps(alpha_mask, p));
+
+      _mm_storeu_ps(out + 4 * i, v);
+    }
+    return;
+#endif
+  }
+
+  for (size_t i = 0; i < num_pixels; i++) {
+    const float *src = in + channels * i;
+    float *dst = out + channels * i;
+
+    float r = src[0];
+    float g = src[1];
+    float b = src[2];
+
+    float out_rgb[3];
+    out_rgb[0] = M[0] * r + M[1] * g + M[2] * b;
+    out_rgb[1] = M[3] * r + M[4] * g + M[5] * b;
+    out_rgb[2] = M[6] * r + M[7] * g + M[8] * b;
+
+    // clamp negative value
+    dst[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
+    dst[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
+    dst[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
+
+    if (channels == 4) {
+      dst[3] = src[3];
+    }
+  }
+}
+
+void ApplyColorMatrix3x3Parallel(const std::vector<float> &in_img,
+                                 size_t channels, const float M[9],
+                                 std::vector<float> *out_img) {
+  size_t num_pixels = in_img.size() / channels;
+  const float *src = in_img.data();
+  float *dst = out_img->data();
+
+  parallel::ParallelForChunked(
+      num_pixels,
+      [=](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        ApplyColorMatrix3x3(src + channels * begin, dst + channels * begin,
+                            end - begin, channels, M);
+      },
+      -1, kParallelGrainTexels);
+}
+
 } // namespace detail
 
 bool linear_f32_to_srgb_8bit(const std::vector<float> &in_img, size_t width,
@@ -389,21 +607,28 @@ bool linear_f32_to_srgb_8bit(const std::vector<float> &in_img, size_t width,
 
   out_img->resize(dest_size);
 
-  for (size_t y = 0; y < height; y++) {
-    for (size_t x = 0; x < width; x++) {
-      for (size_t c = 0; c < channels; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        (*out_img)[idx] = SrgbTransform::linearToSrgb8bit(in_img[idx]);
-      }
+  const uint8_t *bucket_table = detail::GetLinearToSrgb8BucketTable();
+
+  const float *src = in_img.data();
+  uint8_t *dst = out_img->data();
 
-      // remainder(usually alpha channel)
-      // Apply linear conversion.
-      for (size_t c = channels; c < channel_stride; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        (*out_img)[idx] = detail::f32_to_u8(in_img[idx]);
+  detail::ForEachRowRange(width, height, channel_stride, [=](size_t y_begin, size_t y_end) {
+    for (size_t y = y_begin; y < y_end; y++) {
+      size_t row_offset = channel_stride * width * y;
+      for (size_t x = 0; x < width; x++) {
+        size_t offset = row_offset + channel_stride * x;
+        for (size_t c = 0; c < channels; c++) {
+          dst[offset + c] = detail::LinearToSrgb8bit(bucket_table, src[offset + c]);
+        }
+
+        // remainder(usually alpha channel)
+        // Apply linear conversion.
+        for (size_t c = channels; c < channel_stride; c++) {
+          dst[offset + c] = detail::f32_to_u8(src[offset + c]);
+        }
       }
     }
-  }
+  });
 
   return true;
 }
@@ -444,23 +669,29 @@ bool srgb_8bit_to_linear_f32(const std::vector<uint8_t> &in_img, size_t width,
 
   out_img->resize(dest_size);
 
-  // TODO: Use table approach for larger image size?
+  const float *linearlization_table = detail::GetSrgb8ToLinearF32Table();
+  const float *u8_to_f32_table = detail::GetU8ToF32Table();
 
-  for (size_t y = 0; y < height; y++) {
-    for (size_t x = 0; x < width; x++) {
-      for (size_t c = 0; c < channels; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        (*out_img)[idx] = SrgbTransform::srgbToLinear(float(in_img[idx]) / 255.0f);
-      }
+  const uint8_t *src = in_img.data();
+  float *dst = out_img->data();
 
-      // remainder(usually alpha channel)
-      // Apply linear conversion.
-      for (size_t c = channels; c < channel_stride; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        (*out_img)[idx] = float(in_img[idx]) / 255.0f;
+  detail::ForEachRowRange(width, height, channel_stride, [=](size_t y_begin, size_t y_end) {
+    for (size_t y = y_begin; y < y_end; y++) {
+      size_t row_offset = channel_stride * width * y;
+      for (size_t x = 0; x < width; x++) {
+        size_t offset = row_offset + channel_stride * x;
+        for (size_t c = 0; c < channels; c++) {
+          dst[offset + c] = linearlization_table[src[offset + c]];
+        }
+
+        // remainder(usually alpha channel)
+        // Apply linear conversion.
+        for (size_t c = channels; c < channel_stride; c++) {
+          dst[offset + c] = u8_to_f32_table[src[offset + c]];
+        }
       }
     }
-  }
+  });
 
   return true;
 }
@@ -501,24 +732,29 @@ bool srgb_f32_to_linear_f32(const std::vector<float> &in_img, size_t width,
 
   out_img->resize(dest_size);
 
-  // assume input is in [0.0, 1.0]
-  for (size_t y = 0; y < height; y++) {
-    for (size_t x = 0; x < width; x++) {
-      for (size_t c = 0; c < channels; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        float f = in_img[idx] * scale_factor + bias;
-        (*out_img)[idx] = SrgbTransform::srgbToLinear(f);
-      }
+  const float *src = in_img.data();
+  float *dst = out_img->data();
 
-      // remainder(usually alpha channel)
-      // Apply linear conversion.
-      for (size_t c = channels; c < channel_stride; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        float f = in_img[idx] * alpha_scale_factor + alpha_bias;
-        (*out_img)[idx] = f;
+  // assume input is in [0.0, 1.0]
+  detail::ForEachRowRange(width, height, channel_stride, [=](size_t y_begin, size_t y_end) {
+    for (size_t y = y_begin; y < y_end; y++) {
+      size_t row_offset = channel_stride * width * y;
+      for (size_t x = 0; x < width; x++) {
+        size_t offset = row_offset + channel_stride * x;
+        for (size_t c = 0; c < channels; c++) {
+          float f = src[offset + c] * scale_factor + bias;
+          dst[offset + c] = SrgbTransform::srgbToLinear(f);
+        }
+
+        // remainder(usually alpha channel)
+        // Apply linear conversion.
+        for (size_t c = channels; c < channel_stride; c++) {
+          float f = src[offset + c] * alpha_scale_factor + alpha_bias;
+          dst[offset + c] = f;
+        }
       }
     }
-  }
+  });
 
   return true;
 }
@@ -559,29 +795,102 @@ bool srgb_8bit_to_linear_8bit(const std::vector<uint8_t> &in_img, size_t width,
 
   out_img->resize(dest_size);
 
-  // TODO: Precompute table.
-  uint8_t linearlization_table[256];
-  for (size_t u = 0; u < 256; u++) {
-    float f = float(u) / 255.0f;
-    linearlization_table[u] = detail::f32_to_u8(SrgbTransform::srgbToLinear(f));
-  }
+  const uint8_t *linearlization_table = detail::GetSrgb8ToLinear8Table();
 
-  for (size_t y = 0; y < height; y++) {
-    for (size_t x = 0; x < width; x++) {
-      for (size_t c = 0; c < channels; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        (*out_img)[idx] = linearlization_table[in_img[idx]];
-      }
+  const uint8_t *src = in_img.data();
+  uint8_t *dst = out_img->data();
 
-      // remainder(usually alpha channel)
-      // no op.
-      for (size_t c = channels; c < channel_stride; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        (*out_img)[idx] = in_img[idx];
+  detail::ForEachRowRange(width, height, channel_stride, [=](size_t y_begin, size_t y_end) {
+    for (size_t y = y_begin; y < y_end; y++) {
+      size_t row_offset = channel_stride * width * y;
+      for (size_t x = 0; x < width; x++) {
+        size_t offset = row_offset + channel_stride * x;
+        for (size_t c = 0; c < channels; c++) {
+          dst[offset + c] = linearlization_table[src[offset + c]];
+        }
+
+        // remainder(usually alpha channel)
+        // no op.
+        for (size_t c = channels; c < channel_stride; c++) {
+          dst[offset + c] = src[offset + c];
+        }
       }
     }
+  });
+
+  return true;
+}
+
+bool rec709_8bit_to_linear_f32(const std::vector<uint8_t> &in_img, size_t width,
+                         size_t width_byte_stride, size_t height,
+                         size_t channels, size_t channel_stride,
+                         std::vector<float> *out_img, std::string *err) {
+
+  if (width == 0) {
+    PUSH_ERROR_AND_RETURN("width is zero.");
+  }
+
+  if (height == 0) {
+    PUSH_ERROR_AND_RETURN("height is zero.");
+  }
+
+  if (channels == 0) {
+    PUSH_ERROR_AND_RETURN("channels is zero.");
+  }
+
+  if (out_img == nullptr) {
+    PUSH_ERROR_AND_RETURN("`out_img` is nullptr.");
   }
 
+  if (channel_stride == 0) {
+    channel_stride = channels;
+  } else {
+    if (channel_stride < channels) {
+      PUSH_ERROR_AND_RETURN(fmt::format("channel_stride {} is smaller than input channels {}", channel_stride, channels));
+    }
+  }
+
+  if (width_byte_stride == 0) {
+    width_byte_stride = width * channel_stride;
+  } else {
+    if (width_byte_stride < (width * channel_stride)) {
+      PUSH_ERROR_AND_RETURN(fmt::format("width_byte_stride {} is smaller than width * channel_stride {}", width_byte_stride, width * channel_stride));
+    }
+  }
+
+  size_t src_size = width_byte_stride * (height - 1) + width * channel_stride;
+  if (src_size > in_img.size()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Insufficient input buffer size. must be the same or larger than {} but has {}", src_size, in_img.size()));
+  }
+
+  size_t dest_size = size_t(width) * size_t(height) * channel_stride;
+  out_img->resize(dest_size);
+
+  const float *linearlization_table = detail::GetRec709_8ToLinearF32Table();
+  const float *u8_to_f32_table = detail::GetU8ToF32Table();
+
+  const uint8_t *src = in_img.data();
+  float *dst = out_img->data();
+
+  detail::ForEachRowRange(width, height, channel_stride, [=](size_t y_begin, size_t y_end) {
+    for (size_t y = y_begin; y < y_end; y++) {
+      const uint8_t *src_row = src + width_byte_stride * y;
+      float *dst_row = dst + channel_stride * width * y;
+      for (size_t x = 0; x < width; x++) {
+        size_t offset = channel_stride * x;
+        for (size_t c = 0; c < channels; c++) {
+          dst_row[offset + c] = linearlization_table[src_row[offset + c]];
+        }
+
+        // remainder(usually alpha channel)
+        // Apply linear conversion.
+        for (size_t c = channels; c < channel_stride; c++) {
+          dst_row[offset + c] = u8_to_f32_table[src_row[offset + c]];
+        }
+      }
+    }
+  });
+
   return true;
 }
 
@@ -612,9 +921,19 @@ bool u8_to_f32_image(const std::vector<uint8_t> &in_img, size_t width,
 
   out_img->resize(num_pixels);
 
-  for (size_t i = 0; i < num_pixels; i++) {
-    (*out_img)[i] = float(in_img[i]) / 255.0f;
-  }
+  const float *table = detail::GetU8ToF32Table();
+  const uint8_t *src = in_img.data();
+  float *dst = out_img->data();
+
+  parallel::ParallelForChunked(
+      num_pixels,
+      [=](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        for (size_t i = begin; i < end; i++) {
+          dst[i] = table[src[i]];
+        }
+      },
+      -1, detail::kParallelGrainTexels);
 
   return true;
 }
@@ -646,10 +965,19 @@ bool f32_to_u8_image(const std::vector<float> &in_img, size_t width,
 
   out_img->resize(num_pixels);
 
-  for (size_t i = 0; i < num_pixels; i++) {
-    float f = scale * in_img[i] + bias;
-    (*out_img)[i] = detail::f32_to_u8(f);
-  }
+  const float *src = in_img.data();
+  uint8_t *dst = out_img->data();
+
+  parallel::ParallelForChunked(
+      num_pixels,
+      [=](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        for (size_t i = begin; i < end; i++) {
+          float f = scale * src[i] + bias;
+          dst[i] = detail::f32_to_u8(f);
+        }
+      },
+      -1, detail::kParallelGrainTexels);
 
   return true;
 }
@@ -689,56 +1017,12 @@ bool linear_displayp3_to_linear_sRGB(const std::vector<float> &in_img, size_t wi
 
 
 
-  if (channels == 3) {
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b;
-        r = in_img[3 * (y * width + x) + 0];
-        g = in_img[3 * (y * width + x) + 1];
-        b = in_img[3 * (y * width + x) + 2];
-
-        float out_rgb[3];
-        out_rgb[0] = 1.2249f * r - 0.2247f * g;
-        out_rgb[1] = -0.0420f * r + 1.0419f * g;
-        out_rgb[2] = -0.0197f * r - 0.0786f * g + 1.0979f * b;
-
-        // clamp
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[3 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[3 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[3 * (y * width + x) + 2] = out_rgb[2];
-      }
-    }
+  static const float kLinearDisplayP3ToLinearSRGB[9] = {
+      1.2249f, -0.2247f, 0.0f,
+      -0.0420f, 1.0419f, 0.0f,
+      -0.0197f, -0.0786f, 1.0979f};
 
-  } else { // rgba
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b, a;
-        r = in_img[4 * (y * width + x) + 0];
-        g = in_img[4 * (y * width + x) + 1];
-        b = in_img[4 * (y * width + x) + 2];
-        a = in_img[4 * (y * width + x) + 3];
-
-        float out_rgb[3];
-        out_rgb[0] = 1.2249f * r - 0.2247f * g;
-        out_rgb[1] = -0.0420f * r + 1.0419f * g;
-        out_rgb[2] = -0.0197f * r - 0.0786f * g + 1.0979f * b;
-
-        // clamp
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[4 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[4 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[4 * (y * width + x) + 2] = out_rgb[2];
-        (*out_img)[4 * (y * width + x) + 3] = a;
-      }
-    }
-  }
+  detail::ApplyColorMatrix3x3Parallel(in_img, channels, kLinearDisplayP3ToLinearSRGB, out_img);
 
   return true;
 }
@@ -777,56 +1061,12 @@ bool linear_sRGB_to_linear_displayp3(const std::vector<float> &in_img, size_t wi
   // http://endavid.com/index.php?entry=79
   // https://tech.metail.com/introduction-colour-spaces-dci-p3/
 
-  if (channels == 3) {
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b;
-        r = in_img[3 * (y * width + x) + 0];
-        g = in_img[3 * (y * width + x) + 1];
-        b = in_img[3 * (y * width + x) + 2];
-
-        float out_rgb[3];
-        out_rgb[0] = 0.8225f * r + 0.1774f * g;
-        out_rgb[1] = 0.0332f * r + 0.9669f * g;
-        out_rgb[2] = 0.0171f * r + 0.0724f * g + 0.9108f * b;
-
-        // clamp for just in case.
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[3 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[3 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[3 * (y * width + x) + 2] = out_rgb[2];
-      }
-    }
+  static const float kLinearSRGBToLinearDisplayP3[9] = {
+      0.8225f, 0.1774f, 0.0f,
+      0.0332f, 0.9669f, 0.0f,
+      0.0171f, 0.0724f, 0.9108f};
 
-  } else { // rgba
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b, a;
-        r = in_img[4 * (y * width + x) + 0];
-        g = in_img[4 * (y * width + x) + 1];
-        b = in_img[4 * (y * width + x) + 2];
-        a = in_img[4 * (y * width + x) + 3];
-
-        float out_rgb[3];
-        out_rgb[0] = 0.8225f * r + 0.1774f * g;
-        out_rgb[1] = 0.0332f * r + 0.9669f * g;
-        out_rgb[2] = 0.0171f * r + 0.0724f * g + 0.9108f * b;
-
-        // clamp for just in case.
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[4 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[4 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[4 * (y * width + x) + 2] = out_rgb[2];
-        (*out_img)[4 * (y * width + x) + 3] = a;
-      }
-    }
-  }
+  detail::ApplyColorMatrix3x3Parallel(in_img, channels, kLinearSRGBToLinearDisplayP3, out_img);
 
   return true;
 }
@@ -868,56 +1108,12 @@ bool linear_sRGB_to_ACEScg(const std::vector<float> &in_img, size_t width,
   // https://computergraphics.stackexchange.com/questions/9834/how-to-convert-from-xyz-or-srgb-to-acescg-ap1
   // https://gist.github.com/Opioid/442d4975a23eed9a9e129bc3de97ea2a
 
-  if (channels == 3) {
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b;
-        r = in_img[3 * (y * width + x) + 0];
-        g = in_img[3 * (y * width + x) + 1];
-        b = in_img[3 * (y * width + x) + 2];
-
-        float out_rgb[3];
-        out_rgb[0] = 0.6130973f * r + 0.33952285f * g +  0.04737928f * b;
-        out_rgb[1] = 0.07019422f * r + 0.91635557f * g + 0.01345259f * b;
-        out_rgb[2] = 0.0206156f * r + 0.10956983f * g + 0.86981512f  *b;
-
-        // clamp negative value just in case.
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[3 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[3 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[3 * (y * width + x) + 2] = out_rgb[2];
-      }
-    }
+  static const float kLinearSRGBToACEScg[9] = {
+      0.6130973f, 0.33952285f, 0.04737928f,
+      0.07019422f, 0.91635557f, 0.01345259f,
+      0.0206156f, 0.10956983f, 0.86981512f};
 
-  } else { // rgba
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b, a;
-        r = in_img[4 * (y * width + x) + 0];
-        g = in_img[4 * (y * width + x) + 1];
-        b = in_img[4 * (y * width + x) + 2];
-        a = in_img[4 * (y * width + x) + 3];
-
-        float out_rgb[3];
-        out_rgb[0] = 0.6130973f * r + 0.33952285f * g +  0.04737928f * b;
-        out_rgb[1] = 0.07019422f * r + 0.91635557f * g + 0.01345259f * b;
-        out_rgb[2] = 0.0206156f * r + 0.10956983f * g + 0.86981512f  *b;
-
-        // clamp for just in case.
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[4 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[4 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[4 * (y * width + x) + 2] = out_rgb[2];
-        (*out_img)[4 * (y * width + x) + 3] = a;
-      }
-    }
-  }
+  detail::ApplyColorMatrix3x3Parallel(in_img, channels, kLinearSRGBToACEScg, out_img);
 
   return true;
 }
@@ -957,56 +1153,12 @@ bool ACEScg_to_linear_sRGB(const std::vector<float> &in_img, size_t width,
   // 
   // https://www.shadertoy.com/view/WltSRB
 
-  if (channels == 3) {
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b;
-        r = in_img[3 * (y * width + x) + 0];
-        g = in_img[3 * (y * width + x) + 1];
-        b = in_img[3 * (y * width + x) + 2];
-
-        float out_rgb[3];
-        out_rgb[0] =  1.705052f * r -0.621792f * g   -0.083258f * b;
-        out_rgb[1] = -0.130257f * r + 1.140805f *  -0.010548f * b;
-        out_rgb[2] = -0.024004f * r -0.128969f *g + 1.152972f * b;
-
-        // clamp negative
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[3 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[3 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[3 * (y * width + x) + 2] = out_rgb[2];
-      }
-    }
+  static const float kACEScgToLinearSRGB[9] = {
+      1.705052f, -0.621792f, -0.083258f,
+      -0.130257f, 1.140805f, -0.010548f,
+      -0.024004f, -0.128969f, 1.152972f};
 
-  } else { // rgba
-    for (size_t y = 0; y < height; y++) {
-      for (size_t x = 0; x < width; x++) {
-        float r, g, b, a;
-        r = in_img[4 * (y * width + x) + 0];
-        g = in_img[4 * (y * width + x) + 1];
-        b = in_img[4 * (y * width + x) + 2];
-        a = in_img[4 * (y * width + x) + 3];
-
-        float out_rgb[3];
-        out_rgb[0] =  1.705052f * r -0.621792f * g   -0.083258f * b;
-        out_rgb[1] = -0.130257f * r + 1.140805f *  -0.010548f * b;
-        out_rgb[2] = -0.024004f * r -0.128969f *g + 1.152972f * b;
-
-        // clamp negative value
-        out_rgb[0] = (out_rgb[0] < 0.0f) ? 0.0f : out_rgb[0];
-        out_rgb[1] = (out_rgb[1] < 0.0f) ? 0.0f : out_rgb[1];
-        out_rgb[2] = (out_rgb[2] < 0.0f) ? 0.0f : out_rgb[2];
-
-        (*out_img)[4 * (y * width + x) + 0] = out_rgb[0];
-        (*out_img)[4 * (y * width + x) + 1] = out_rgb[1];
-        (*out_img)[4 * (y * width + x) + 2] = out_rgb[2];
-        (*out_img)[4 * (y * width + x) + 3] = a;
-      }
-    }
-  }
+  detail::ApplyColorMatrix3x3Parallel(in_img, channels, kACEScgToLinearSRGB, out_img);
 
   return true;
 }
@@ -1047,28 +1199,197 @@ bool displayp3_f16_to_linear_f32(const std::vector<value::half> &in_img, size_t
 
   out_img->resize(dest_size);
 
-  // assume input is in [0.0, 1.0]
-  for (size_t y = 0; y < height; y++) {
-    for (size_t x = 0; x < width; x++) {
-      for (size_t c = 0; c < channels; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        float in_val = value::half_to_float(in_img[idx]);
-        float f = in_val * scale_factor + bias;
-        (*out_img)[idx] = SrgbTransform::srgbToLinear(f); // Display P3 use the same transfer function with sRGB
-      }
+  // Display P3 use the same transfer function with sRGB
+  auto linearlize = [&](value::half h) {
+    float in_val = value::half_to_float(h);
+    float f = in_val * scale_factor + bias;
+    return SrgbTransform::srgbToLinear(f);
+  };
+
+  // 65536 entry LUT indexed by fp16 bits for large image.
+  std::vector<float> linearlization_table;
+  if ((width * height * channels) >= detail::kHalfLUTMinTexels) {
+    linearlization_table.resize(65536);
+    float *table = linearlization_table.data();
+    parallel::ParallelForChunked(
+        65536,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          for (size_t i = begin; i < end; i++) {
+            value::half h;
+            h.value = uint16_t(i);
+            table[i] = linearlize(h);
+          }
+        },
+        -1, 16384);
+  }
+
+  const float *table = linearlization_table.empty() ? nullptr : linearlization_table.data();
+  const value::half *src = in_img.data();
+  float *dst = out_img->data();
 
-      // remainder(usually alpha channel)
-      // Apply linear conversion.
-      for (size_t c = channels; c < channel_stride; c++) {
-        size_t idx = channel_stride * width * y + channel_stride * x + c;
-        float in_val = value::half_to_float(in_img[idx]);
-        float f = in_val * alpha_scale_factor + alpha_bias;
-        (*out_img)[idx] = f;
+  // assume input is in [0.0, 1.0]
+  detail::ForEachRowRange(width, height, channel_stride, [=](size_t y_begin, size_t y_end) {
+    for (size_t y = y_begin; y < y_end; y++) {
+      size_t row_offset = channel_stride * width * y;
+      for (size_t x = 0; x < width; x++) {
+        size_t offset = row_offset + channel_stride * x;
+        if (table) {
+          for (size_t c = 0; c < channels; c++) {
+            dst[offset + c] = table[src[offset + c].value];
+          }
+        } else {
+          for (size_t c = 0; c < channels; c++) {
+            dst[offset + c] = linearlize(src[offset + c]);
+          }
+        }
+
+        // remainder(usually alpha channel)
+        // Apply linear conversion.
+        for (size_t c = channels; c < channel_stride; c++) {
+          float in_val = value::half_to_float(src[offset + c]);
+          float f = in_val * alpha_scale_factor + alpha_bias;
+          dst[offset + c] = f;
+        }
       }
     }
+  });
+
+  return true;
+}
+
+namespace {
+
+// Resize through stb_image_resize2. Output rows are split across threads for
+// large images.
+bool ResizeImageSTB(const void *src, size_t src_width, size_t src_stride,
+                    size_t src_height, void *dst, size_t dest_width,
+                    size_t dest_stride, size_t dest_height, size_t channels,
+                    stbir_datatype datatype, std::string *err) {
+  if ((src_width == 0) || (src_height == 0) || (dest_width == 0) ||
+      (dest_height == 0)) {
+    PUSH_ERROR_AND_RETURN("Invalid image size.");
+  }
+
+  stbir_pixel_layout layout;
+  if (channels == 1) {
+    layout = STBIR_1CHANNEL;
+  } else if (channels == 2) {
+    layout = STBIR_2CHANNEL;
+  } else if (channels == 3) {
+    layout = STBIR_RGB;
+  } else if (channels == 4) {
+    // Non-premultiplied alpha. Color is weighted by alpha when resampled.
+    layout = STBIR_RGBA;
+  } else {
+    PUSH_ERROR_AND_RETURN("channels must be 1, 2, 3 or 4.");
+  }
+
+  STBIR_RESIZE resize;
+  stbir_resize_init(&resize, src, int(src_width), int(src_height),
+                    int(src_stride), dst, int(dest_width), int(dest_height),
+                    int(dest_stride), layout, datatype);
+
+  int num_threads = 1;
+  if (dest_width * dest_height * channels >= detail::kParallelGrainTexels) {
+    num_threads = parallel::GetNumThreads();
+  }
+
+  int splits = stbir_build_samplers_with_splits(&resize, num_threads);
+  if (splits <= 0) {
+    PUSH_ERROR_AND_RETURN("Failed to setup image resampler.");
+  }
+
+  std::atomic<bool> ok(true);
+  parallel::ParallelFor(
+      size_t(splits),
+      [&resize, &ok](size_t i, int thread_id) {
+        (void)thread_id;
+        if (!stbir_resize_extended_split(&resize, int(i), 1)) {
+          ok = false;
+        }
+      },
+      splits);
+
+  stbir_free_samplers(&resize);
+
+  if (!ok) {
+    PUSH_ERROR_AND_RETURN("Failed to resize image.");
   }
 
   return true;
 }
 
+template <typename T>
+bool ResizeImage(const std::vector<T> &src_img, size_t src_width,
+                 size_t src_width_byte_stride, size_t src_height,
+                 size_t dest_width, size_t dest_width_byte_stride,
+                 size_t dest_height, size_t channels, stbir_datatype datatype,
+                 std::vector<T> *dest_img, std::string *err) {
+  if (!dest_img) {
+    PUSH_ERROR_AND_RETURN("`dest_img` is nullptr.");
+  }
+
+  if (src_width_byte_stride == 0) {
+    src_width_byte_stride = src_width * channels * sizeof(T);
+  }
+
+  if (dest_width_byte_stride == 0) {
+    dest_width_byte_stride = dest_width * channels * sizeof(T);
+  }
+
+  if ((src_width_byte_stride < src_width * channels * sizeof(T)) ||
+      (dest_width_byte_stride < dest_width * channels * sizeof(T)) ||
+      (dest_width_byte_stride % sizeof(T))) {
+    PUSH_ERROR_AND_RETURN("Invalid byte stride.");
+  }
+
+  if (src_img.size() * sizeof(T) <
+      src_width_byte_stride * (src_height - 1) +
+          src_width * channels * sizeof(T)) {
+    PUSH_ERROR_AND_RETURN("Insufficient input image data.");
+  }
+
+  dest_img->resize(dest_width_byte_stride / sizeof(T) * dest_height);
+
+  return ResizeImageSTB(src_img.data(), src_width, src_width_byte_stride,
+                        src_height, dest_img->data(), dest_width,
+                        dest_width_byte_stride, dest_height, channels, datatype,
+                        err);
+}
+
+}  // namespace
+
+bool resize_image_f32(const std::vector<float> &src_img, size_t src_width,
+                      size_t src_width_byte_stride, size_t src_height,
+                      size_t dest_width, size_t dest_width_byte_stride,
+                      size_t dest_height, size_t channels,
+                      std::vector<float> *dest_img, std::string *err) {
+  return ResizeImage(src_img, src_width, src_width_byte_stride, src_height,
+                     dest_width, dest_width_byte_stride, dest_height, channels,
+                     STBIR_TYPE_FLOAT, dest_img, err);
+}
+
+bool resize_image_u8_srgb(const std::vector<uint8_t> &src_img,
+                          size_t src_width, size_t src_width_byte_stride,
+                          size_t src_height, size_t dest_width,
+                          size_t dest_width_byte_stride, size_t dest_height,
+                          size_t channels, std::vector<uint8_t> *dest_img,
+                          std::string *err) {
+  // Alpha channel is treated as linear.
+  return ResizeImage(src_img, src_width, src_width_byte_stride, src_height,
+                     dest_width, dest_width_byte_stride, dest_height, channels,
+                     STBIR_TYPE_UINT8_SRGB, dest_img, err);
+}
+
+bool resize_image_u8(const std::vector<uint8_t> &src_img, size_t src_width,
+                     size_t src_width_byte_stride, size_t src_height,
+                     size_t dest_width, size_t dest_width_byte_stride,
+                     size_t dest_height, size_t channels,
+                     std::vector<uint8_t> *dest_img, std::string *err) {
+  return ResizeImage(src_img, src_width, src_width_byte_stride, src_height,
+                     dest_width, dest_width_byte_stride, dest_height, channels,
+                     STBIR_TYPE_UINT8, dest_img, err);
+}
+
 } // namespace tinyusdz
@@ -4,8 +4,14 @@
 // Image utilities.
 // Currently sRGB color space conversion feature is provided.
 //
+// Conversion functions process large images in parallel(rows are split across
+// threads), so they are not required to be called from multiple threads.
+// Results of LUT paths(8bit/16bit input, fp32 -> 8bit sRGB) are identical to
+// per-texel evaluation, and so are 3x3 color matrix conversions(Display P3,
+// ACEScg), except for NaN input(converted to 0).
+// Image resize(stb_image_resize2) also splits output rows across threads.
+//
 // TODO
-// - [ ] Image resize using stb_image_resize2
 // - [ ] OIIO 3D LUT support through tinycolorio
 //
 #pragma once
@@ -243,8 +249,8 @@ bool ACEScg_to_linear_sRGB(const std::vector<float> &in_img, size_t width,
 /// @param[in] src_height Source image height pixels
 /// @param[in] dest_width Dest image width pixels
 /// @param[in] dest_width_byte_stride Dest image width byte stride. 0 = Use
-/// `src_width` * channels
-/// @param[in] src_height Dest image height pixels
+/// `dest_width` * channels
+/// @param[in] dest_height Dest image height pixels
 //
 /// @param[in] chanels Pixel channels both src and dest image.
 /// @param[out] dest_img Resized image in linear color space(memory is allocated
@@ -269,8 +275,8 @@ bool resize_image_f32(const std::vector<float> &src_img, size_t src_width,
 /// @param[in] src_height Source image height pixels
 /// @param[in] dest_width Dest image width pixels
 /// @param[in] dest_width_byte_stride Dest image width byte stride. 0 = Use
-/// `src_width` * channels
-/// @param[in] src_height Dest image height pixels
+/// `dest_width` * channels
+/// @param[in] dest_height Dest image height pixels
 //
 /// @param[in] chanels Pixel channels both src and dest image.
 /// @param[out] dest_img Resized image in sRGB color space(memory is allocated
@@ -285,4 +291,17 @@ bool resize_image_u8_srgb(const std::vector<uint8_t> &src_img, size_t src_width,
 
                           size_t channels, std::vector<uint8_t> *dest_img, std::string *err =nullptr);
 
+///
+/// Resize uint8 image in linear color space(or non-color data. e.g. normal
+/// map). Parameters are same with `resize_image_u8_srgb`.
+///
+/// @return true upon success. false when any parameter is invalid.
+bool resize_image_u8(const std::vector<uint8_t> &src_img, size_t src_width,
+                     size_t src_width_byte_stride, size_t src_height,
+
+                     size_t dest_width, size_t dest_width_byte_stride,
+                     size_t dest_height,
+
+                     size_t channels, std::vector<uint8_t> *dest_img, std::string *err = nullptr);
+
 }  // namespace tinyusdz
@@ -116,15 +116,60 @@ nonstd::expected<bool, std::string> WriteImageToFile(
 nonstd::expected<std::vector<uint8_t>, std::string> WriteImageToMemory(
     const Image &image, const WriteOption option)
 {
-  (void)image;
-  (void)option;
-
   // TODO: Autodetect format
   if (option.format == tinyusdz::image::WriteImageFormat::Autodetect) {
     return nonstd::make_unexpected("TODO: Autodetect image format.");
   }
 
-  return nonstd::make_unexpected("TODO: Implement WriteImageToFile");
+  if ((option.format != tinyusdz::image::WriteImageFormat::PNG) &&
+      (option.format != tinyusdz::image::WriteImageFormat::BMP) &&
+      (option.format != tinyusdz::image::WriteImageFormat::JPEG)) {
+    return nonstd::make_unexpected("TODO: Implement WriteImageToMemory for EXR/TIFF/DNG.");
+  }
+
+  // Currently LDR only
+  if ((image.bpp != 8) || (image.format != Image::PixelFormat::UInt)) {
+    return nonstd::make_unexpected("8bit only for PNG/BMP/JPEG output.");
+  }
+
+  if ((image.width < 1) || (image.height < 1) || (image.channels < 1) ||
+      (image.channels > 4)) {
+    return nonstd::make_unexpected("Invalid image width, height or channels.");
+  }
+
+  size_t nbytes = size_t(image.width) * size_t(image.height) *
+                  size_t(image.channels);
+  if (image.data.size() < nbytes) {
+    return nonstd::make_unexpected("Insufficient image data.");
+  }
+
+  std::vector<uint8_t> dst;
+
+  auto write_fn = [](void *context, void *data, int size) {
+    std::vector<uint8_t> *buf = reinterpret_cast<std::vector<uint8_t> *>(context);
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    buf->insert(buf->end(), p, p + size);
+  };
+
+  int ret{0};
+  if (option.format == tinyusdz::image::WriteImageFormat::PNG) {
+    ret = stbi_write_png_to_func(write_fn, &dst, image.width, image.height,
+                                 image.channels, image.data.data(),
+                                 image.width * image.channels);
+  } else if (option.format == tinyusdz::image::WriteImageFormat::BMP) {
+    ret = stbi_write_bmp_to_func(write_fn, &dst, image.width, image.height,
+                                 image.channels, image.data.data());
+  } else {
+    ret = stbi_write_jpg_to_func(write_fn, &dst, image.width, image.height,
+                                 image.channels, image.data.data(),
+                                 /* quality */ 90);
+  }
+
+  if (!ret) {
+    return nonstd::make_unexpected("Failed to encode image.");
+  }
+
+  return dst;
 }
 
 } // namespace image
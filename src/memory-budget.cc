@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "memory-budget.hh"
+
+#include <algorithm>
+#include <sstream>
+
+#include "prim-types.hh"
+
+namespace tinyusdz {
+
+namespace {
+
+void AtomicMax(std::atomic<uint64_t> &dst, uint64_t v) {
+  uint64_t prev = dst.load();
+  while ((prev < v) && !dst.compare_exchange_weak(prev, v)) {
+  }
+}
+
+// Subtract `v` from `dst`, clamping to zero. Returns the amount subtracted.
+uint64_t AtomicSubClamped(std::atomic<uint64_t> &dst, uint64_t v) {
+  uint64_t prev = dst.load();
+  uint64_t n = 0;
+  do {
+    n = (prev < v) ? prev : v;
+  } while (!dst.compare_exchange_weak(prev, prev - n));
+  return n;
+}
+
+std::string FormatBytes(uint64_t nbytes) {
+  std::stringstream ss;
+  if (nbytes >= 1024ull * 1024ull) {
+    ss << double(nbytes) / (1024.0 * 1024.0) << " MB";
+  } else if (nbytes >= 1024ull) {
+    ss << double(nbytes) / 1024.0 << " KB";
+  } else {
+    ss << nbytes << " bytes";
+  }
+  return ss.str();
+}
+
+}  // namespace
+
+std::string to_string(MemoryCategory cat) {
+  switch (cat) {
+    case MemoryCategory::CrateTables:
+      return "crate_tables";
+    case MemoryCategory::Prims:
+      return "prims";
+    case MemoryCategory::TimeSamples:
+      return "timesamples";
+    case MemoryCategory::Assets:
+      return "assets";
+    case MemoryCategory::TydraBuffers:
+      return "tydra_buffers";
+    case MemoryCategory::NumCategories:
+      break;
+  }
+  return "[[InvalidMemoryCategory]]";
+}
+
+MemoryBudget::MemoryBudget(uint64_t limit_in_bytes) : _limit(limit_in_bytes) {
+  reset();
+}
+
+void MemoryBudget::reset() {
+  _total.store(0);
+  _peak_total.store(0);
+  for (uint32_t i = 0; i < kNumMemoryCategories; i++) {
+    _usage[i].store(0);
+    _peak[i].store(0);
+  }
+}
+
+bool MemoryBudget::reserve(MemoryCategory cat, uint64_t nbytes,
+                           std::string *err) {
+  uint32_t idx = static_cast<uint32_t>(cat);
+  if (idx >= kNumMemoryCategories) {
+    if (err) {
+      (*err) += "Invalid MemoryCategory.\n";
+    }
+    return false;
+  }
+
+  const uint64_t limit = _limit.load();
+
+  uint64_t total = _total.load();
+  uint64_t new_total = 0;
+  do {
+    if ((nbytes > limit) || (total > (limit - nbytes))) {
+      if (err) {
+        (*err) += "Memory budget exceeded: requested " + FormatBytes(nbytes) +
+                  " for `" + to_string(cat) + "`, but current usage is " +
+                  FormatBytes(total) + " and limit is " + FormatBytes(limit) +
+                  ".\n";
+      }
+      return false;
+    }
+    new_total = total + nbytes;
+  } while (!_total.compare_exchange_weak(total, new_total));
+
+  AtomicMax(_peak_total, new_total);
+
+  uint64_t usage = _usage[idx].fetch_add(nbytes) + nbytes;
+  AtomicMax(_peak[idx], usage);
+
+  return true;
+}
+
+void MemoryBudget::release(MemoryCategory cat, uint64_t nbytes) {
+  uint32_t idx = static_cast<uint32_t>(cat);
+  if (idx >= kNumMemoryCategories) {
+    return;
+  }
+
+  uint64_t n = AtomicSubClamped(_usage[idx], nbytes);
+  AtomicSubClamped(_total, n);
+}
+
+uint64_t MemoryBudget::usage(MemoryCategory cat) const {
+  uint32_t idx = static_cast<uint32_t>(cat);
+  if (idx >= kNumMemoryCategories) {
+    return 0;
+  }
+  return _usage[idx].load();
+}
+
+uint64_t MemoryBudget::peak_usage(MemoryCategory cat) const {
+  uint32_t idx = static_cast<uint32_t>(cat);
+  if (idx >= kNumMemoryCategories) {
+    return 0;
+  }
+  return _peak[idx].load();
+}
+
+MemoryReservation::MemoryReservation(MemoryReservation &&rhs) noexcept
+    : _budget(std::move(rhs._budget)) {
+  for (uint32_t i = 0; i < kNumMemoryCategories; i++) {
+    _nbytes[i] = rhs._nbytes[i];
+    rhs._nbytes[i] = 0;
+  }
+  rhs._budget = nullptr;
+}
+
+MemoryReservation &MemoryReservation::operator=(
+    MemoryReservation &&rhs) noexcept {
+  if (this != &rhs) {
+    release();
+    _budget = std::move(rhs._budget);
+    for (uint32_t i = 0; i < kNumMemoryCategories; i++) {
+      _nbytes[i] = rhs._nbytes[i];
+      rhs._nbytes[i] = 0;
+    }
+    rhs._budget = nullptr;
+  }
+  return *this;
+}
+
+bool MemoryReservation::reserve(MemoryCategory cat, uint64_t nbytes,
+                                std::string *err) {
+  if (!_budget) {
+    return true;
+  }
+
+  if (!_budget->reserve(cat, nbytes, err)) {
+    return false;
+  }
+
+  _nbytes[static_cast<uint32_t>(cat)] += nbytes;
+  return true;
+}
+
+void MemoryReservation::release(MemoryCategory cat, uint64_t nbytes) {
+  uint32_t idx = static_cast<uint32_t>(cat);
+  if (!_budget || (idx >= kNumMemoryCategories)) {
+    return;
+  }
+
+  uint64_t n = (std::min)(nbytes, _nbytes[idx]);
+  _budget->release(cat, n);
+  _nbytes[idx] -= n;
+}
+
+void MemoryReservation::release() {
+  for (uint32_t i = 0; i < kNumMemoryCategories; i++) {
+    if (_budget && _nbytes[i]) {
+      _budget->release(static_cast<MemoryCategory>(i), _nbytes[i]);
+    }
+    _nbytes[i] = 0;
+  }
+}
+
+uint64_t MemoryReservation::reserved(MemoryCategory cat) const {
+  uint32_t idx = static_cast<uint32_t>(cat);
+  if (idx >= kNumMemoryCategories) {
+    return 0;
+  }
+  return _nbytes[idx];
+}
+
+uint64_t MemoryReservation::total_reserved() const {
+  uint64_t n = 0;
+  for (uint32_t i = 0; i < kNumMemoryCategories; i++) {
+    n += _nbytes[i];
+  }
+  return n;
+}
+
+std::string to_string(const MemoryBudget &budget) {
+  std::stringstream ss;
+
+  ss << "memory usage(current / peak):\n";
+  for (uint32_t i = 0; i < kNumMemoryCategories; i++) {
+    MemoryCategory cat = static_cast<MemoryCategory>(i);
+    ss << "  " << to_string(cat) << " : " << FormatBytes(budget.usage(cat))
+       << " / " << FormatBytes(budget.peak_usage(cat)) << "\n";
+  }
+  ss << "  total : " << FormatBytes(budget.total_usage()) << " / "
+     << FormatBytes(budget.peak_total_usage()) << "\n";
+
+  if (budget.limit() == (std::numeric_limits<uint64_t>::max)()) {
+    ss << "  limit : unlimited\n";
+  } else {
+    ss << "  limit : " << FormatBytes(budget.limit()) << "\n";
+  }
+
+  return ss.str();
+}
+
+uint64_t EstimatePropertyMemoryUsage(const std::string &name,
+                                     const Property &prop,
+                                     uint64_t *timesamples_bytes) {
+  // map node + key
+  uint64_t nbytes =
+      sizeof(Property) + sizeof(std::string) + name.size() + 4 * sizeof(void *);
+  uint64_t ts_bytes = 0;
+
+  if (prop.is_attribute()) {
+    const primvar::PrimVar &var = prop.get_attribute().get_var();
+    if (var.has_value()) {
+      nbytes += var.value_raw().estimate_memory_usage();
+    }
+
+    if (var.has_timesamples()) {
+      for (const auto &sample : var.ts_raw().get_samples()) {
+        ts_bytes += sizeof(value::TimeSamples::Sample) - sizeof(value::Value) +
+                    sample.value.estimate_memory_usage();
+      }
+    }
+  }
+
+  if (timesamples_bytes) {
+    (*timesamples_bytes) = ts_bytes;
+  }
+
+  return nbytes;
+}
+
+uint64_t EstimatePropertiesMemoryUsage(
+    const std::map<std::string, Property> &props, uint64_t *timesamples_bytes) {
+  uint64_t nbytes = 0;
+  uint64_t ts_bytes = 0;
+
+  for (const auto &item : props) {
+    uint64_t prop_ts_bytes = 0;
+    nbytes += EstimatePropertyMemoryUsage(item.first, item.second, &prop_ts_bytes);
+    ts_bytes += prop_ts_bytes;
+  }
+
+  if (timesamples_bytes) {
+    (*timesamples_bytes) = ts_bytes;
+  }
+
+  return nbytes;
+}
+
+namespace {
+
+bool ReserveWithTimeSamples(MemoryReservation *reservation, uint64_t nbytes,
+                            uint64_t ts_bytes, std::string *err) {
+  if (!reservation->reserve(MemoryCategory::Prims, nbytes, err)) {
+    return false;
+  }
+
+  if (ts_bytes) {
+    if (!reservation->reserve(MemoryCategory::TimeSamples, ts_bytes, err)) {
+      // Roll back
+      reservation->release(MemoryCategory::Prims, nbytes);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+bool ReservePropertyMemory(MemoryReservation *reservation,
+                           const std::string &name, const Property &prop,
+                           std::string *err) {
+  if (!reservation || !reservation->budget()) {
+    return true;
+  }
+
+  uint64_t ts_bytes = 0;
+  uint64_t prop_bytes = EstimatePropertyMemoryUsage(name, prop, &ts_bytes);
+
+  return ReserveWithTimeSamples(reservation, prop_bytes, ts_bytes, err);
+}
+
+bool ReservePrimMemory(MemoryReservation *reservation,
+                       const std::map<std::string, Property> &props,
+                       std::string *err) {
+  if (!reservation || !reservation->budget()) {
+    return true;
+  }
+
+  uint64_t ts_bytes = 0;
+  uint64_t prop_bytes = EstimatePropertiesMemoryUsage(props, &ts_bytes);
+
+  return ReserveWithTimeSamples(reservation, sizeof(Prim) + prop_bytes,
+                                ts_bytes, err);
+}
+
+}  // namespace tinyusdz
@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Memory accounting and budget enforcement shared by USD loaders and Tydra.
+//
+// Memory usage is approximated(counted manually at major allocation sites), so
+// actual process memory usage may be larger than the reported value.
+//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace tinyusdz {
+
+class Property;  // prim-types.hh
+
+enum class MemoryCategory : uint32_t {
+  CrateTables = 0,  // USDC(Crate) tables(tokens, paths, fields, specs, ...) and unpacked values
+  Prims,            // Reconstructed Prim/PrimSpec and its Property values(except TimeSamples)
+  TimeSamples,      // TimeSamples of reconstructed Property
+  Assets,           // Asset buffers(USD file data, texture file data, decoded texture image)
+  TydraBuffers,     // Tydra RenderScene `BufferData`
+  NumCategories
+};
+
+constexpr uint32_t kNumMemoryCategories =
+    static_cast<uint32_t>(MemoryCategory::NumCategories);
+
+std::string to_string(MemoryCategory cat);
+
+///
+/// Thread-safe memory budget.
+///
+/// `reserve` fails(and nothing is accounted) when the reservation would exceed
+/// the limit, so that loaders can fail fast before allocating memory.
+/// Current and peak usage are tracked for each category.
+///
+class MemoryBudget {
+ public:
+  ///
+  /// @param[in] limit_in_bytes Memory limit in [bytes]. Default = no limit.
+  ///
+  explicit MemoryBudget(
+      uint64_t limit_in_bytes = (std::numeric_limits<uint64_t>::max)());
+
+  MemoryBudget(const MemoryBudget &) = delete;
+  MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+  void set_limit(uint64_t limit_in_bytes) { _limit.store(limit_in_bytes); }
+  uint64_t limit() const { return _limit.load(); }
+
+  ///
+  /// Reserve `nbytes` for `cat`.
+  ///
+  /// @param[in] cat Memory category.
+  /// @param[in] nbytes Bytes to reserve.
+  /// @param[out] err Optional. Error message when the budget is exceeded.
+  ///
+  /// @return false when the reservation exceeds the limit.
+  ///
+  bool reserve(MemoryCategory cat, uint64_t nbytes, std::string *err = nullptr);
+
+  ///
+  /// Release `nbytes` reserved for `cat`. Usage is clamped to zero.
+  ///
+  void release(MemoryCategory cat, uint64_t nbytes);
+
+  uint64_t usage(MemoryCategory cat) const;
+  uint64_t peak_usage(MemoryCategory cat) const;
+
+  uint64_t total_usage() const { return _total.load(); }
+  uint64_t peak_total_usage() const { return _peak_total.load(); }
+
+  ///
+  /// Clear usage counters(limit is kept).
+  ///
+  void reset();
+
+ private:
+  std::atomic<uint64_t> _limit;
+  std::atomic<uint64_t> _total{0};
+  std::atomic<uint64_t> _peak_total{0};
+  std::atomic<uint64_t> _usage[kNumMemoryCategories];
+  std::atomic<uint64_t> _peak[kNumMemoryCategories];
+};
+
+///
+/// Release reserved memory at the end of scope.
+/// Use this for transient buffers(e.g. file data read for parsing).
+///
+class ScopedMemoryReservation {
+ public:
+  ScopedMemoryReservation(MemoryBudget *budget, MemoryCategory cat)
+      : _budget(budget), _cat(cat) {}
+
+  ~ScopedMemoryReservation() {
+    if (_budget) {
+      _budget->release(_cat, _nbytes);
+    }
+  }
+
+  ScopedMemoryReservation(const ScopedMemoryReservation &) = delete;
+  ScopedMemoryReservation &operator=(const ScopedMemoryReservation &) = delete;
+
+  ///
+  /// Always succeeds when `budget` is nullptr.
+  ///
+  bool reserve(uint64_t nbytes, std::string *err = nullptr) {
+    if (!_budget) {
+      return true;
+    }
+    if (!_budget->reserve(_cat, nbytes, err)) {
+      return false;
+    }
+    _nbytes += nbytes;
+    return true;
+  }
+
+  ///
+  /// Take over `nbytes` already reserved in the budget for `cat`(e.g. by the
+  /// previous owner of a buffer), so that they are released by this object.
+  ///
+  void adopt(uint64_t nbytes) {
+    if (_budget) {
+      _nbytes += nbytes;
+    }
+  }
+
+  ///
+  /// Release all reserved memory now.
+  ///
+  void release() {
+    if (_budget) {
+      _budget->release(_cat, _nbytes);
+    }
+    _nbytes = 0;
+  }
+
+ private:
+  MemoryBudget *_budget{nullptr};
+  MemoryCategory _cat;
+  uint64_t _nbytes{0};
+};
+
+///
+/// Memory reserved for data owned by an object(e.g. Prims of a Stage).
+/// Reservations of all categories are released when destroyed, so
+/// reservations of a failed load or a destroyed Stage are returned to the
+/// budget. The budget is shared with the reservation, so it is kept alive
+/// until all reservations are released. Move only.
+///
+class MemoryReservation {
+ public:
+  MemoryReservation() = default;
+  explicit MemoryReservation(std::shared_ptr<MemoryBudget> budget)
+      : _budget(std::move(budget)) {}
+
+  ~MemoryReservation() { release(); }
+
+  MemoryReservation(const MemoryReservation &) = delete;
+  MemoryReservation &operator=(const MemoryReservation &) = delete;
+
+  MemoryReservation(MemoryReservation &&rhs) noexcept;
+  MemoryReservation &operator=(MemoryReservation &&rhs) noexcept;
+
+  const std::shared_ptr<MemoryBudget> &budget() const { return _budget; }
+
+  ///
+  /// Always succeeds when `budget` is nullptr.
+  ///
+  bool reserve(MemoryCategory cat, uint64_t nbytes, std::string *err = nullptr);
+
+  ///
+  /// Release `nbytes` of `cat`(clamped to the reserved bytes).
+  ///
+  void release(MemoryCategory cat, uint64_t nbytes);
+
+  ///
+  /// Release all reserved memory now.
+  ///
+  void release();
+
+  uint64_t reserved(MemoryCategory cat) const;
+  uint64_t total_reserved() const;
+
+ private:
+  std::shared_ptr<MemoryBudget> _budget;
+  uint64_t _nbytes[kNumMemoryCategories]{};
+};
+
+///
+/// Breakdown of memory usage as human-readable string.
+///
+std::string to_string(const MemoryBudget &budget);
+
+///
+/// Approximated memory usage of a Property(and its map node) in [bytes].
+///
+/// @param[in] name Property name.
+/// @param[in] prop Property.
+/// @param[out] timesamples_bytes Bytes used by TimeSamples(not included in the
+/// return value).
+///
+/// @return Bytes used by the Property, except for TimeSamples.
+///
+uint64_t EstimatePropertyMemoryUsage(const std::string &name,
+                                     const Property &prop,
+                                     uint64_t *timesamples_bytes);
+
+///
+/// Approximated memory usage of Properties of a Prim(or PrimSpec) in [bytes].
+///
+/// @param[in] props Properties.
+/// @param[out] timesamples_bytes Bytes used by TimeSamples(not included in the
+/// return value).
+///
+/// @return Bytes used by Properties, except for TimeSamples.
+///
+uint64_t EstimatePropertiesMemoryUsage(
+    const std::map<std::string, Property> &props, uint64_t *timesamples_bytes);
+
+///
+/// Reserve memory for a parsed Property to `reservation`. Call this before
+/// the Property is stored to the Prim(or PrimSpec). Nothing is reserved when
+/// the reservation fails.
+/// Do nothing and return true when `reservation` has no budget.
+///
+bool ReservePropertyMemory(MemoryReservation *reservation,
+                           const std::string &name, const Property &prop,
+                           std::string *err);
+
+///
+/// Reserve memory for a Prim(or PrimSpec) and its parsed Properties to
+/// `reservation`. Call this before the Prim is reconstructed from `props`.
+/// Nothing is reserved when the reservation fails.
+/// Do nothing and return true when `reservation` has no budget.
+///
+bool ReservePrimMemory(MemoryReservation *reservation,
+                       const std::map<std::string, Property> &props,
+                       std::string *err);
+
+}  // namespace tinyusdz
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Simple parallel-for utility.
+//
+// Uses std::thread, independent of `TINYUSDZ_ENABLE_THREAD`(which enables
+// thread-safe Stage/Prim modification). On platforms without thread
+// support(WASI, Emscripten without pthreads) all functions here run serially
+// on the calling thread, so callers can use them unconditionally.
+//
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__wasi__)
+// no thread support
+#elif defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+// no thread support
+#else
+#define TINYUSDZ_PARALLEL_FOR_USE_THREAD
+#include <thread>
+#endif
+
+namespace tinyusdz {
+namespace parallel {
+
+///
+/// Resolve the number of threads to use.
+///
+/// @param[in] num_threads Requested # of threads. -1 = use all hardware threads.
+/// @return # of threads(>= 1). Always 1 when threading is disabled in the build.
+///
+inline int GetNumThreads(int num_threads = -1) {
+#if defined(TINYUSDZ_PARALLEL_FOR_USE_THREAD)
+  if (num_threads <= 0) {
+    num_threads = (std::max)(1, int(std::thread::hardware_concurrency()));
+  }
+  // Limit to 1024 threads(same limit as CrateReader)
+  return (std::min)(1024, num_threads);
+#else
+  (void)num_threads;
+  return 1;
+#endif
+}
+
+///
+/// Call `f(begin, end, thread_id)` for each chunk of [0, n).
+/// Chunks are dynamically scheduled, so `f` must be safe to be called
+/// concurrently for disjoint ranges. `thread_id` is in [0, GetNumThreads()) and
+/// can be used to index per-thread scratch buffers.
+///
+/// @param[in] n Number of items.
+/// @param[in] f Functor `void(size_t begin, size_t end, int thread_id)`
+/// @param[in] num_threads # of threads. -1 = use all hardware threads.
+/// @param[in] grain_size Minimum # of items processed per chunk.
+///
+template <typename F>
+void ParallelForChunked(size_t n, F &&f, int num_threads = -1,
+                        size_t grain_size = 1) {
+  if (n == 0) {
+    return;
+  }
+
+  grain_size = (std::max)(size_t(1), grain_size);
+
+  int nthreads = GetNumThreads(num_threads);
+
+  // Do not spawn more threads than chunks.
+  size_t num_chunks = (n + grain_size - 1) / grain_size;
+  nthreads = int((std::min)(size_t(nthreads), num_chunks));
+
+  if (nthreads <= 1) {
+    f(size_t(0), n, 0);
+    return;
+  }
+
+#if defined(TINYUSDZ_PARALLEL_FOR_USE_THREAD)
+  std::atomic<size_t> counter(0);
+
+  auto worker = [&](int thread_id) {
+    while (true) {
+      size_t begin = counter.fetch_add(grain_size);
+      if (begin >= n) {
+        break;
+      }
+      size_t end = (std::min)(n, begin + grain_size);
+      f(begin, end, thread_id);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(size_t(nthreads - 1));
+  for (int t = 1; t < nthreads; t++) {
+    workers.emplace_back(worker, t);
+  }
+
+  // Calling thread also participates.
+  worker(0);
+
+  for (auto &w : workers) {
+    w.join();
+  }
+#endif
+}
+
+///
+/// Call `f(i, thread_id)` for each i in [0, n).
+///
+template <typename F>
+void ParallelFor(size_t n, F &&f, int num_threads = -1, size_t grain_size = 1) {
+  ParallelForChunked(
+      n,
+      [&f](size_t begin, size_t end, int thread_id) {
+        for (size_t i = begin; i < end; i++) {
+          f(i, thread_id);
+        }
+      },
+      num_threads, grain_size);
+}
+
+}  // namespace parallel
+}  // namespace tinyusdz
@@ -30,8 +30,83 @@ std::string RemoveRelativePrefix(const std::string &in_str, size_t &num) {
   return ret;
 }
 
+// true when `prefix` equals to `s` or `prefix` is an ancestor Prim path of `s`.
+bool IsPrimPathPrefix(const std::string &prefix, const std::string &s) {
+  if (prefix == "/") {
+    return !s.empty() && (s[0] == '/');
+  }
+
+  if (s.size() < prefix.size()) {
+    return false;
+  }
+
+  if (s.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+
+  if (s.size() == prefix.size()) {
+    return true;
+  }
+
+  char c = s[prefix.size()];
+  return c == '/';
+}
+
+// Remove variant selections from Prim path, so that a Prim defined in a
+// variant is compared with its namespace path.
+// e.g. `/bora{v=a}dora` => `/bora/dora`, `/bora{v=a}` => `/bora`
+std::string StripVariantSelections(const std::string &s) {
+  if (s.find('{') == std::string::npos) {
+    return s;
+  }
+
+  std::string ret;
+  ret.reserve(s.size());
+
+  size_t i = 0;
+  while (i < s.size()) {
+    if (s[i] != '{') {
+      ret.push_back(s[i]);
+      i++;
+      continue;
+    }
+
+    size_t e = s.find('}', i);
+    if (e == std::string::npos) {
+      // Invalid path. Keep as-is.
+      ret.append(s, i, std::string::npos);
+      break;
+    }
+
+    i = e + 1;
+    if ((i < s.size()) && (s[i] != '{') && (s[i] != '/')) {
+      ret.push_back('/');
+    }
+  }
+
+  return ret;
+}
+
 } // namespace
 
+bool IsPathInPopulationMask(const Path &path, const std::vector<Path> &mask) {
+  if (mask.empty()) {
+    return true;
+  }
+
+  const std::string prim_path = StripVariantSelections(path.prim_part());
+
+  for (const auto &m : mask) {
+    const std::string mask_path = StripVariantSelections(m.prim_part());
+    if (IsPrimPathPrefix(mask_path, prim_path) ||
+        IsPrimPathPrefix(prim_path, mask_path)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 Path FromString(const std::string &_path_str) {
 
   std::string path_str = _path_str;
@@ -74,5 +74,25 @@ bool ResolveRelativePath(const Path &base_prim_path, const Path &relative_path,
 ///
 Path ToUnixishPath(const Path &path);
 
+///
+/// Test if the Prim of `path` is within the population mask(list of absolute
+/// Prim paths).
+///
+/// A Prim is within the mask when its path is a mask path, a descendant of a
+/// mask path, or an ancestor of a mask path(ancestors are required to reach
+/// masked subtrees). Property part of `path` is ignored.
+/// Variant selections are ignored, so a Prim defined in a variant is tested
+/// with its namespace path(e.g. `/bora{v=a}dora` is tested as `/bora/dora`).
+///
+/// /bora/dora in mask [/bora] => true
+/// /bora in mask [/bora/dora] => true
+/// /muda in mask [/bora/dora] => false
+/// /bora{v=a}dora in mask [/bora/dora] => true
+/// /bora{v=a}muda in mask [/bora/dora] => false
+///
+/// Empty mask includes all Prims.
+///
+bool IsPathInPopulationMask(const Path &path, const std::vector<Path> &mask);
+
 }  // namespace pathutil
 }  // namespace tinyusdz
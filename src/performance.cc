@@ -4,6 +4,16 @@
 
 #include <chrono>
 
+#if defined(TINYUSDZ_WITH_TRACE)
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#endif
+
 namespace tinyusdz {
 namespace performance {
 
@@ -11,10 +21,309 @@ double now() {
   auto t = std::chrono::system_clock::now();
 
   // to milliseconds.
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()); 
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch());
 
   return double(ms.count());
 }
 
+#if defined(TINYUSDZ_WITH_TRACE)
+
+namespace {
+
+constexpr size_t kDefaultTraceBufferCapacity = 1024 * 1024;
+
+struct TraceEvent {
+  const char *name{nullptr};
+  int64_t begin{0};  // [us] relative to capture start
+  int64_t duration{0};  // [us]
+};
+
+// Events are recorded to the thread local buffer. `mutex` is only contended
+// when exporting(or clearing) events.
+struct ThreadTraceBuffer {
+  uint32_t tid{0};
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+};
+
+struct TraceContext {
+  std::atomic<bool> capturing{false};
+
+  // Incremented for each capture. Used to discard zones which began in the
+  // previous capture.
+  std::atomic<uint32_t> generation{0};
+
+  // Capture start time. [us] from `TraceClockBase`.
+  std::atomic<int64_t> start{0};
+
+  // Max # of events per thread. Events exceeding it are dropped.
+  std::atomic<size_t> capacity{kDefaultTraceBufferCapacity};
+  std::atomic<size_t> num_dropped{0};
+
+  std::mutex capture_mutex;  // serializes Start/Clear
+
+  std::mutex mutex;  // guards `buffers` and `next_tid`
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+  uint32_t next_tid{0};
+};
+
+TraceContext &GetTraceContext() {
+  static TraceContext ctx;
+  return ctx;
+}
+
+// Initialized once(thread-safe) on the first use.
+std::chrono::steady_clock::time_point TraceClockBase() {
+  static const std::chrono::steady_clock::time_point base =
+      std::chrono::steady_clock::now();
+  return base;
+}
+
+int64_t TraceClockMicroseconds() {
+  return int64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - TraceClockBase())
+                     .count());
+}
+
+ThreadTraceBuffer &GetThreadTraceBuffer() {
+  thread_local std::shared_ptr<ThreadTraceBuffer> buf;
+
+  if (!buf) {
+    buf = std::make_shared<ThreadTraceBuffer>();
+
+    TraceContext &ctx = GetTraceContext();
+    std::lock_guard<std::mutex> lock(ctx.mutex);
+    buf->tid = ctx.next_tid++;
+    ctx.buffers.push_back(buf);
+  }
+
+  return *buf;
+}
+
+int64_t ElapsedMicroseconds(const TraceContext &ctx) {
+  return TraceClockMicroseconds() - ctx.start.load(std::memory_order_acquire);
+}
+
+void ClearTraceBuffers(TraceContext &ctx) {
+  std::lock_guard<std::mutex> lock(ctx.mutex);
+  for (auto &buf : ctx.buffers) {
+    std::lock_guard<std::mutex> buf_lock(buf->mutex);
+    buf->events.clear();
+    buf->events.shrink_to_fit();
+  }
+
+  // Release buffers of exited threads.
+  ctx.buffers.erase(
+      std::remove_if(ctx.buffers.begin(), ctx.buffers.end(),
+                     [](const std::shared_ptr<ThreadTraceBuffer> &buf) {
+                       return buf.use_count() == 1;
+                     }),
+      ctx.buffers.end());
+
+  ctx.num_dropped.store(0);
+}
+
+void EscapeJSONString(const char *s, std::ostream &os) {
+  for (const char *p = s; *p; p++) {
+    char c = *p;
+    if ((c == '"') || (c == '\\')) {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << ' ';
+    } else {
+      os << c;
+    }
+  }
+}
+
+}  // namespace
+
+bool IsTraceEnabled() { return true; }
+
+bool StartTraceCapture() {
+  TraceContext &ctx = GetTraceContext();
+  std::lock_guard<std::mutex> lock(ctx.capture_mutex);
+
+  ctx.capturing.store(false, std::memory_order_release);
+
+  // Bump the generation before clearing the buffers. A zone of the previous
+  // capture checks the generation under the buffer's mutex, so its event is
+  // either pushed before the buffer is cleared or discarded.
+  ctx.generation.fetch_add(1);
+  ClearTraceBuffers(ctx);
+
+  ctx.start.store(TraceClockMicroseconds(), std::memory_order_release);
+  ctx.capturing.store(true, std::memory_order_release);
+
+  return true;
+}
+
+bool StopTraceCapture() {
+  GetTraceContext().capturing.store(false, std::memory_order_release);
+  return true;
+}
+
+bool IsTraceCapturing() {
+  return GetTraceContext().capturing.load(std::memory_order_acquire);
+}
+
+void ClearTraceCapture() {
+  TraceContext &ctx = GetTraceContext();
+  std::lock_guard<std::mutex> lock(ctx.capture_mutex);
+  ClearTraceBuffers(ctx);
+}
+
+void SetTraceBufferCapacity(size_t max_events_per_thread) {
+  GetTraceContext().capacity.store(max_events_per_thread);
+}
+
+size_t GetTraceBufferCapacity() { return GetTraceContext().capacity.load(); }
+
+size_t GetNumDroppedTraceEvents() {
+  return GetTraceContext().num_dropped.load();
+}
+
+size_t GetNumTraceEvents() {
+  TraceContext &ctx = GetTraceContext();
+  std::lock_guard<std::mutex> lock(ctx.mutex);
+  size_t n = 0;
+  for (auto &buf : ctx.buffers) {
+    std::lock_guard<std::mutex> buf_lock(buf->mutex);
+    n += buf->events.size();
+  }
+  return n;
+}
+
+std::string ExportChromeTrace() {
+  TraceContext &ctx = GetTraceContext();
+
+  std::stringstream ss;
+  ss << "{\"traceEvents\":[\n";
+
+  bool first = true;
+
+  std::lock_guard<std::mutex> lock(ctx.mutex);
+  for (auto &buf : ctx.buffers) {
+    std::lock_guard<std::mutex> buf_lock(buf->mutex);
+
+    if (buf->events.empty()) {
+      continue;
+    }
+
+    // Thread name metadata event.
+    if (!first) {
+      ss << ",\n";
+    }
+    first = false;
+    ss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+       << buf->tid << ",\"args\":{\"name\":\"thread " << buf->tid << "\"}}";
+
+    for (const auto &ev : buf->events) {
+      ss << ",\n{\"name\":\"";
+      EscapeJSONString(ev.name, ss);
+      ss << "\",\"cat\":\"tinyusdz\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buf->tid
+         << ",\"ts\":" << ev.begin << ",\"dur\":" << ev.duration << "}";
+    }
+  }
+
+  ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  return ss.str();
+}
+
+bool WriteChromeTrace(const std::string &filename, std::string *err) {
+  std::ofstream ofs(filename.c_str(), std::ofstream::binary);
+  if (!ofs) {
+    if (err) {
+      (*err) += "File open error for writing : " + filename + "\n";
+    }
+    return false;
+  }
+
+  std::string s = ExportChromeTrace();
+  ofs.write(s.data(), static_cast<std::streamsize>(s.size()));
+  if (!ofs) {
+    if (err) {
+      (*err) += "File write error: " + filename + "\n";
+    }
+    return false;
+  }
+
+  return true;
+}
+
+ScopedTraceZone::ScopedTraceZone(const char *name) : _name(name) {
+  const TraceContext &ctx = GetTraceContext();
+  if (ctx.capturing.load(std::memory_order_relaxed)) {
+    _generation = ctx.generation.load(std::memory_order_relaxed);
+    _begin = ElapsedMicroseconds(ctx);
+  }
+}
+
+ScopedTraceZone::~ScopedTraceZone() {
+  if (_begin < 0) {
+    return;
+  }
+
+  TraceContext &ctx = GetTraceContext();
+  if (!ctx.capturing.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  int64_t end = ElapsedMicroseconds(ctx);
+
+  ThreadTraceBuffer &buf = GetThreadTraceBuffer();
+  std::lock_guard<std::mutex> lock(buf.mutex);
+
+  // Check again under the lock: `StartTraceCapture` may have started a new
+  // capture(and cleared this buffer) since the check above.
+  if (_generation != ctx.generation.load(std::memory_order_acquire)) {
+    // Zone began in the previous capture.
+    return;
+  }
+
+  if (buf.events.size() >= ctx.capacity.load(std::memory_order_relaxed)) {
+    ctx.num_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buf.events.push_back({_name, _begin, end - _begin});
+}
+
+#else
+
+bool IsTraceEnabled() { return false; }
+bool StartTraceCapture() { return false; }
+bool StopTraceCapture() { return false; }
+bool IsTraceCapturing() { return false; }
+void ClearTraceCapture() {}
+void SetTraceBufferCapacity(size_t max_events_per_thread) {
+  (void)max_events_per_thread;
+}
+size_t GetTraceBufferCapacity() { return 0; }
+size_t GetNumDroppedTraceEvents() { return 0; }
+size_t GetNumTraceEvents() { return 0; }
+
+std::string ExportChromeTrace() {
+  return "{\"traceEvents\":[]}\n";
+}
+
+bool WriteChromeTrace(const std::string &filename, std::string *err) {
+  (void)filename;
+  if (err) {
+    (*err) += "Trace feature is disabled in this build. Rebuild TinyUSDZ with `TINYUSDZ_WITH_TRACE`.\n";
+  }
+  return false;
+}
+
+ScopedTraceZone::ScopedTraceZone(const char *name) : _name(name) {
+  (void)_name;
+  (void)_begin;
+  (void)_generation;
+}
+
+ScopedTraceZone::~ScopedTraceZone() {}
+
+#endif
+
 } // namespace performance
 } // namespace tinyusdz
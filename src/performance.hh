@@ -1,15 +1,115 @@
 // SPDX-License-Identifier: Apache 2.0
 // Copyright 2022 - Present, Light Transport Entertainment, Inc.
-// 
+//
 // Simple timing utility
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
 namespace tinyusdz {
 namespace performance {
 
 // Return current time in [ms]
 double now();
 
+///
+/// Trace instrumentation.
+///
+/// Scoped trace zones are compiled into TinyUSDZ only when built with
+/// `TINYUSDZ_WITH_TRACE`(cmake option `TINYUSDZ_WITH_TRACE`). Without it,
+/// `TINYUSDZ_TRACE_ZONE` expands to nothing and capture API below returns
+/// false.
+///
+/// Captured zones are exported as Chrome trace event JSON
+/// (chrome://tracing or https://ui.perfetto.dev), with one track per thread.
+///
+
+///
+/// @return true when trace instrumentation is compiled in.
+///
+bool IsTraceEnabled();
+
+///
+/// Start capturing trace zones. Previously captured events are discarded.
+///
+/// @return false when trace instrumentation is not compiled in.
+///
+bool StartTraceCapture();
+
+///
+/// Stop capturing trace zones. Captured events are kept until the next
+/// `StartTraceCapture` or `ClearTraceCapture`.
+///
+bool StopTraceCapture();
+
+bool IsTraceCapturing();
+
+///
+/// Discard captured trace events. Buffers of exited threads are released.
+///
+void ClearTraceCapture();
+
+///
+/// Max # of trace events recorded per thread(default 1M). Events exceeding
+/// it are dropped until the next `StartTraceCapture`/`ClearTraceCapture`, so
+/// memory usage of a long capture is bounded.
+///
+void SetTraceBufferCapacity(size_t max_events_per_thread);
+size_t GetTraceBufferCapacity();
+
+///
+/// Number of trace events dropped due to the buffer capacity.
+///
+size_t GetNumDroppedTraceEvents();
+
+///
+/// Number of captured trace events(for all threads).
+///
+size_t GetNumTraceEvents();
+
+///
+/// Export captured trace events as Chrome `trace_event` JSON string.
+///
+std::string ExportChromeTrace();
+
+///
+/// Write captured trace events to a file as Chrome `trace_event` JSON.
+///
+/// @param[in] filename Output filename.
+/// @param[out] err Error message.
+///
+bool WriteChromeTrace(const std::string &filename, std::string *err);
+
+///
+/// Scoped trace zone. `name` must be a string literal(or string with static
+/// storage duration), since only the pointer is recorded.
+///
+class ScopedTraceZone {
+ public:
+  explicit ScopedTraceZone(const char *name);
+  ~ScopedTraceZone();
+
+  ScopedTraceZone(const ScopedTraceZone &) = delete;
+  ScopedTraceZone &operator=(const ScopedTraceZone &) = delete;
+
+ private:
+  const char *_name{nullptr};
+  int64_t _begin{-1};  // [us]. -1 = not capturing.
+  uint32_t _generation{0};
+};
+
 } // performance
 } // namespace tinyusdz
 
+#define TINYUSDZ_TRACE_CONCAT_IMPL(__a, __b) __a##__b
+#define TINYUSDZ_TRACE_CONCAT(__a, __b) TINYUSDZ_TRACE_CONCAT_IMPL(__a, __b)
+
+#if defined(TINYUSDZ_WITH_TRACE)
+#define TINYUSDZ_TRACE_ZONE(__name) \
+  ::tinyusdz::performance::ScopedTraceZone TINYUSDZ_TRACE_CONCAT(_tinyusdz_trace_zone_, __LINE__)(__name)
+#else
+#define TINYUSDZ_TRACE_ZONE(__name)
+#endif
+
@@ -4627,7 +4627,7 @@ std::string print_layer(const Layer &layer, const uint32_t indent) {
 // prim-pprint.hh
 namespace prim {
 
-std::string print_prim(const Prim &prim, const uint32_t indent) {
+std::string print_prim_head(const Prim &prim, const uint32_t indent) {
   std::stringstream ss;
 
   // Currently, Prim's elementName is read from name variable in concrete Prim
@@ -4718,49 +4718,78 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
     }
   }
 
-  //
-  // primChildren
-  //
   if (prim.children().size()) {
     if (require_newline) {
       ss << "\n";
-      require_newline = false;
     }
-    if (prim.metas().primChildren.size() == prim.children().size()) {
-      // Use primChildren info to determine the order of the traversal.
+  }
 
-      std::map<std::string, const Prim *> primNameTable;
-      for (size_t i = 0; i < prim.children().size(); i++) {
-        primNameTable.emplace(prim.children()[i].element_name(),
-                              &prim.children()[i]);
-      }
+  return ss.str();
+}
 
-      for (size_t i = 0; i < prim.metas().primChildren.size(); i++) {
-        if (i > 0) {
-          ss << "\n";
-        }
-        value::token nameTok = prim.metas().primChildren[i];
-        DCOUT(fmt::format("primChildren  {}/{} = {}", i,
-                          prim.metas().primChildren.size(), nameTok.str()));
-        const auto it = primNameTable.find(nameTok.str());
-        if (it != primNameTable.end()) {
-          ss << print_prim(*(it->second), indent + 1);
-        } else {
-          // TODO: Report warning?
-        }
-      }
+void get_ordered_children(const Prim &prim,
+                          std::vector<const Prim *> *children) {
+  if (!children) {
+    return;
+  }
 
-    } else {
-      for (size_t i = 0; i < prim.children().size(); i++) {
-        if (i > 0) {
-          ss << "\n";
-        }
-        ss << print_prim(prim.children()[i], indent + 1);
+  children->clear();
+
+  if (prim.metas().primChildren.size() == prim.children().size()) {
+    // Use primChildren info to determine the order of the traversal.
+
+    std::map<std::string, const Prim *> primNameTable;
+    for (size_t i = 0; i < prim.children().size(); i++) {
+      primNameTable.emplace(prim.children()[i].element_name(),
+                            &prim.children()[i]);
+    }
+
+    for (size_t i = 0; i < prim.metas().primChildren.size(); i++) {
+      value::token nameTok = prim.metas().primChildren[i];
+      DCOUT(fmt::format("primChildren  {}/{} = {}", i,
+                        prim.metas().primChildren.size(), nameTok.str()));
+      const auto it = primNameTable.find(nameTok.str());
+      if (it != primNameTable.end()) {
+        children->push_back(it->second);
+      } else {
+        // TODO: Report warning?
+        children->push_back(nullptr);
       }
     }
+
+  } else {
+    for (size_t i = 0; i < prim.children().size(); i++) {
+      children->push_back(&prim.children()[i]);
+    }
   }
+}
 
-  ss << pprint::Indent(indent) << "}\n";
+std::string print_prim_tail(const Prim &prim, const uint32_t indent) {
+  (void)prim;
+  return pprint::Indent(indent) + "}\n";
+}
+
+std::string print_prim(const Prim &prim, const uint32_t indent) {
+  std::stringstream ss;
+
+  ss << print_prim_head(prim, indent);
+
+  //
+  // primChildren
+  //
+  std::vector<const Prim *> children;
+  get_ordered_children(prim, &children);
+
+  for (size_t i = 0; i < children.size(); i++) {
+    if (i > 0) {
+      ss << "\n";
+    }
+    if (children[i]) {
+      ss << print_prim(*children[i], indent + 1);
+    }
+  }
+
+  ss << print_prim_tail(prim, indent);
 
   return ss.str();
 }
@@ -6,6 +6,7 @@
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 #include "prim-types.hh"
 
@@ -22,6 +23,19 @@ std::string print_layeroffset(const LayerOffset &layeroffset, const uint32_t ind
 std::string print_prim(const Prim &prim, const uint32_t indent=0);
 std::string print_primspec(const PrimSpec &primspec, const uint32_t indent=0);
 
+//
+// Building blocks of print_prim() for streaming output(e.g. usda-writer).
+// print_prim() = print_prim_head() + (child Prims separated by "\n") + print_prim_tail()
+//
+
+// Prim specifier, metadatum, properties and variantSets. Does not include child Prims.
+std::string print_prim_head(const Prim &prim, const uint32_t indent=0);
+std::string print_prim_tail(const Prim &prim, const uint32_t indent=0);
+
+// Child Prims in printing order(`primChildren` order when authored).
+// nullptr is stored when `primChildren` contains a name which is not found in children.
+void get_ordered_children(const Prim &prim, std::vector<const Prim *> *children);
+
 } // namespace prim
 
 inline std::string to_string(const Prim &prim) {
@@ -2686,15 +2686,12 @@ bool ReconstructCollectionProperties(
 
       } else if (names[1] == "expansionRule") {
 
-        TypedAttributeWithFallback<CollectionInstance::ExpansionRule> r{CollectionInstance::ExpansionRule::ExpandPrims};
+        // NOTE: PARSE_UNIFORM_ENUM_PROPERTY `continue`s the loop, so parse
+        // into the instance directly.
+        CollectionInstance &coll_instance = coll->get_or_add_instance(instance_name);
 
         PARSE_UNIFORM_ENUM_PROPERTY(table, prop, prop.first, CollectionInstance::ExpansionRule, ExpansionRuleEnumHandler, CollectionInstance,
-                       r, strict_allowedToken_check)
-
-        if (table.count(prop.first)) {
-          CollectionInstance &coll_instance = coll->get_or_add_instance(instance_name);
-          coll_instance.expansionRule = r.get_value();
-        }
+                       coll_instance.expansionRule, strict_allowedToken_check)
       } else if (names[1] == "includeRoot") {
 
         TypedAttributeWithFallback<Animatable<bool>> includeRoot{false};
@@ -1299,12 +1299,14 @@ struct TypedTimeSamples {
         (*dst) = std::move(p);
         return true;
       } else {
-        if (it == _samples.end()) {
-          // ???
-          return false;
-        }
+        // Held = nearest preceding value for a given time.
+        auto uit = std::upper_bound(
+          _samples.begin(), _samples.end(), t,
+          [](double tval, const Sample &a) { return tval < a.t; });
 
-        (*dst) = it->value;
+        const auto uit_minus_1 = (uit == _samples.begin()) ? _samples.begin() : (uit - 1);
+
+        (*dst) = uit_minus_1->value;
         return true;
       }
     }
@@ -1502,6 +1504,17 @@ struct Animatable {
     return get_scalar(v);
   }
 
+  ///
+  /// Pointer to the scalar(default) value(no copy). nullptr when the value is
+  /// blocked or not authored. Valid until this Animatable is modified.
+  ///
+  const T *get_scalar_ptr() const {
+    if (is_blocked() || !has_value()) {
+      return nullptr;
+    }
+    return &_value;
+  }
+
   // TimeSamples
   // void set(double t, const T &v);
 
@@ -1627,6 +1640,14 @@ class TypedAttribute {
     return false;
   }
 
+  // Pointer to the value(no copy). nullptr when no value assigned.
+  const T *get_value_ptr() const {
+    if (_attrib) {
+      return &(*_attrib);
+    }
+    return nullptr;
+  }
+
   bool is_blocked() const { return _blocked; }
 
   // for `uniform` attribute only
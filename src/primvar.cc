@@ -51,7 +51,7 @@ bool PrimVar::get_interpolated_value(const double t, const value::TimeSampleInte
       return true;
     } else {
 
-      if (tinterp == value::TimeSampleInterpolationType::Held || !value::IsLerpSupportedType(_value.type_id())) {
+      if (tinterp == value::TimeSampleInterpolationType::Held || !value::IsLerpSupportedType(type_id())) {
 
         auto it = std::upper_bound(
           samples.begin(), samples.end(), t,
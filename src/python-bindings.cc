@@ -5,8 +5,10 @@
 
 #include "tiny-format.hh"
 #include "tinyusdz.hh"
+#include "io-util.hh"
 #include "prim-pprint.hh"
 #include "tydra/render-data.hh"
+#include "tydra/scene-access.hh"
 //
 #include "value-type-macros.inc"
 
@@ -16,6 +18,7 @@
 //   - so implement dedicated binding for array data through `vector<T>` stl binding.
 //   - Converting `numpy`, `array.array` and other Python array/list types must be converted at Python layer, not here(C++ binding).
 // - Memory management: TinyUSDZ does not use smart pointer, so use `return_value_policy::reference` or `return_value_policy::reference_internal` as much as posssible.
+//   - Array data(e.g. RenderMesh points, BufferData, PrimVar array) is exposed as numpy array which aliases C++ memory(no copy). The Python object owning the C++ memory is set to the `base` of numpy array, so it is kept alive while the numpy array is alive.
 //   - For methods returning a const pointer(doe not dynamically allocate memory)(e.g. `Stage::GetPrimAtPath`) 
 // - Use return_value_policy::reference_internal for a method which returns const/nonconst lvalue reference
 //   - e.g. `const StageMeta &Stage::metas() const`, `StageMeta &Stage::metas()`
@@ -121,7 +124,12 @@ tinyusdz::Stage load_usd(const std::string &filename) {
 
   std::string warn;
   std::string err;
-  bool ret = tinyusdz::LoadUSDFromFile(filename, &stage, &warn, &err);
+  bool ret{false};
+  {
+    // Allow other Python threads to run while loading.
+    py::gil_scoped_release release;
+    ret = tinyusdz::LoadUSDFromFile(filename, &stage, &warn, &err);
+  }
 
   if (warn.size()) {
     py::print("[ctinyusdz::load_usd] ", warn);
@@ -151,6 +159,293 @@ std::string detect_usd_format(const std::string &filename) {
   return format;  // empty
 }
 
+///
+/// Create numpy array which aliases `ptr`(no copy).
+/// `owner` is kept alive while the numpy array is alive.
+///
+py::array make_array_view(const py::dtype &dt, const void *ptr, size_t n,
+                          size_t ncomps, py::handle owner) {
+  std::vector<py::ssize_t> shape;
+  std::vector<py::ssize_t> strides;
+  const py::ssize_t itemsize = dt.itemsize();
+  shape.push_back(py::ssize_t(n));
+  if (ncomps > 1) {
+    shape.push_back(py::ssize_t(ncomps));
+    strides.push_back(itemsize * py::ssize_t(ncomps));
+    strides.push_back(itemsize);
+  } else {
+    strides.push_back(itemsize);
+  }
+
+  if (n == 0) {
+    // Empty array. `ptr` may be nullptr.
+    return py::array(dt, shape, strides);
+  }
+
+  return py::array(dt, shape, strides, ptr, owner);
+}
+
+template <typename T>
+py::array make_array_view(const std::vector<T> &v, size_t ncomps,
+                          py::handle owner) {
+  return make_array_view(py::dtype::of<T>(), v.data(), v.size() / ncomps, ncomps,
+                         owner);
+}
+
+py::dtype to_dtype(tinyusdz::tydra::ComponentType ty) {
+  using tinyusdz::tydra::ComponentType;
+
+  switch (ty) {
+    case ComponentType::UInt8:
+      return py::dtype::of<uint8_t>();
+    case ComponentType::Int8:
+      return py::dtype::of<int8_t>();
+    case ComponentType::UInt16:
+      return py::dtype::of<uint16_t>();
+    case ComponentType::Int16:
+      return py::dtype::of<int16_t>();
+    case ComponentType::UInt32:
+      return py::dtype::of<uint32_t>();
+    case ComponentType::Int32:
+      return py::dtype::of<int32_t>();
+    case ComponentType::Half:
+      return py::dtype("float16");
+    case ComponentType::Float:
+      return py::dtype::of<float>();
+    case ComponentType::Double:
+      return py::dtype::of<double>();
+  }
+
+  return py::dtype::of<uint8_t>();
+}
+
+// dtype and # of components of VertexAttributeFormat.
+py::dtype to_dtype(tinyusdz::tydra::VertexAttributeFormat fmt,
+                   size_t *ncomps) {
+  using tinyusdz::tydra::VertexAttributeFormat;
+
+  switch (fmt) {
+#define FORMAT_CASE(__fmt, __ty, __n) \
+  case VertexAttributeFormat::__fmt:   \
+    (*ncomps) = __n;                   \
+    return py::dtype::of<__ty>();
+    FORMAT_CASE(Bool, bool, 1)
+    FORMAT_CASE(Char, int8_t, 1)
+    FORMAT_CASE(Char2, int8_t, 2)
+    FORMAT_CASE(Char3, int8_t, 3)
+    FORMAT_CASE(Char4, int8_t, 4)
+    FORMAT_CASE(Byte, uint8_t, 1)
+    FORMAT_CASE(Byte2, uint8_t, 2)
+    FORMAT_CASE(Byte3, uint8_t, 3)
+    FORMAT_CASE(Byte4, uint8_t, 4)
+    FORMAT_CASE(Short, int16_t, 1)
+    FORMAT_CASE(Short2, int16_t, 2)
+    FORMAT_CASE(Short3, int16_t, 3)
+    FORMAT_CASE(Short4, int16_t, 4)
+    FORMAT_CASE(Ushort, uint16_t, 1)
+    FORMAT_CASE(Ushort2, uint16_t, 2)
+    FORMAT_CASE(Ushort3, uint16_t, 3)
+    FORMAT_CASE(Ushort4, uint16_t, 4)
+    FORMAT_CASE(Float, float, 1)
+    FORMAT_CASE(Vec2, float, 2)
+    FORMAT_CASE(Vec3, float, 3)
+    FORMAT_CASE(Vec4, float, 4)
+    FORMAT_CASE(Int, int32_t, 1)
+    FORMAT_CASE(Ivec2, int32_t, 2)
+    FORMAT_CASE(Ivec3, int32_t, 3)
+    FORMAT_CASE(Ivec4, int32_t, 4)
+    FORMAT_CASE(Uint, uint32_t, 1)
+    FORMAT_CASE(Uvec2, uint32_t, 2)
+    FORMAT_CASE(Uvec3, uint32_t, 3)
+    FORMAT_CASE(Uvec4, uint32_t, 4)
+    FORMAT_CASE(Double, double, 1)
+    FORMAT_CASE(Dvec2, double, 2)
+    FORMAT_CASE(Dvec3, double, 3)
+    FORMAT_CASE(Dvec4, double, 4)
+    FORMAT_CASE(Mat2, float, 4)
+    FORMAT_CASE(Mat3, float, 9)
+    FORMAT_CASE(Mat4, float, 16)
+    FORMAT_CASE(Dmat2, double, 4)
+    FORMAT_CASE(Dmat3, double, 9)
+    FORMAT_CASE(Dmat4, double, 16)
+#undef FORMAT_CASE
+    case VertexAttributeFormat::Half:
+      (*ncomps) = 1;
+      return py::dtype("float16");
+    case VertexAttributeFormat::Half2:
+      (*ncomps) = 2;
+      return py::dtype("float16");
+    case VertexAttributeFormat::Half3:
+      (*ncomps) = 3;
+      return py::dtype("float16");
+    case VertexAttributeFormat::Half4:
+      (*ncomps) = 4;
+      return py::dtype("float16");
+  }
+
+  (*ncomps) = 1;
+  return py::dtype::of<uint8_t>();
+}
+
+py::array vertex_attribute_view(const tinyusdz::tydra::VertexAttribute &attr,
+                                py::handle owner) {
+  size_t ncomps{1};
+  py::dtype dt = to_dtype(attr.format, &ncomps);
+
+  // Interleaved(strided) data is not supported in Tydra, so `stride` is not
+  // considered here.
+  ncomps *= size_t(attr.elementSize);
+  size_t item_bytes = size_t(dt.itemsize()) * ncomps;
+  size_t n = (item_bytes > 0) ? (attr.data.size() / item_bytes) : 0;
+
+  return make_array_view(dt, attr.data.data(), n, ncomps, owner);
+}
+
+///
+/// Return numpy view of PrimVar's array value. None when PrimVar does not
+/// hold numeric array value(e.g. timesampled, token[]).
+///
+py::object primvar_array_view(py::object self) {
+  using namespace tinyusdz;
+
+  primvar::PrimVar &p = self.cast<primvar::PrimVar &>();
+  if (!p.has_default()) {
+    return py::none();
+  }
+
+  value::Value &v = p.value_raw();
+
+#define ARRAY_VIEW(__ty, __comp_ty, __n, __dt)                          \
+  if (auto pv = v.as<std::vector<__ty>>()) {                            \
+    static_assert(sizeof(__ty) == sizeof(__comp_ty) * __n, "");        \
+    return make_array_view(__dt, pv->data(), pv->size(), __n, self);    \
+  }
+
+  ARRAY_VIEW(uint8_t, uint8_t, 1, py::dtype::of<uint8_t>())
+  ARRAY_VIEW(int32_t, int32_t, 1, py::dtype::of<int32_t>())
+  ARRAY_VIEW(value::int2, int32_t, 2, py::dtype::of<int32_t>())
+  ARRAY_VIEW(value::int3, int32_t, 3, py::dtype::of<int32_t>())
+  ARRAY_VIEW(value::int4, int32_t, 4, py::dtype::of<int32_t>())
+  ARRAY_VIEW(uint32_t, uint32_t, 1, py::dtype::of<uint32_t>())
+  ARRAY_VIEW(value::uint2, uint32_t, 2, py::dtype::of<uint32_t>())
+  ARRAY_VIEW(value::uint3, uint32_t, 3, py::dtype::of<uint32_t>())
+  ARRAY_VIEW(value::uint4, uint32_t, 4, py::dtype::of<uint32_t>())
+  ARRAY_VIEW(int64_t, int64_t, 1, py::dtype::of<int64_t>())
+  ARRAY_VIEW(uint64_t, uint64_t, 1, py::dtype::of<uint64_t>())
+  ARRAY_VIEW(value::half, uint16_t, 1, py::dtype("float16"))
+  ARRAY_VIEW(value::half2, uint16_t, 2, py::dtype("float16"))
+  ARRAY_VIEW(value::half3, uint16_t, 3, py::dtype("float16"))
+  ARRAY_VIEW(value::half4, uint16_t, 4, py::dtype("float16"))
+  ARRAY_VIEW(float, float, 1, py::dtype::of<float>())
+  ARRAY_VIEW(value::float2, float, 2, py::dtype::of<float>())
+  ARRAY_VIEW(value::float3, float, 3, py::dtype::of<float>())
+  ARRAY_VIEW(value::float4, float, 4, py::dtype::of<float>())
+  ARRAY_VIEW(double, double, 1, py::dtype::of<double>())
+  ARRAY_VIEW(value::double2, double, 2, py::dtype::of<double>())
+  ARRAY_VIEW(value::double3, double, 3, py::dtype::of<double>())
+  ARRAY_VIEW(value::double4, double, 4, py::dtype::of<double>())
+  ARRAY_VIEW(value::matrix2d, double, 4, py::dtype::of<double>())
+  ARRAY_VIEW(value::matrix3d, double, 9, py::dtype::of<double>())
+  ARRAY_VIEW(value::matrix4d, double, 16, py::dtype::of<double>())
+
+  // Role types(e.g. `point3f[] points`)
+  ARRAY_VIEW(value::quath, uint16_t, 4, py::dtype("float16"))
+  ARRAY_VIEW(value::quatf, float, 4, py::dtype::of<float>())
+  ARRAY_VIEW(value::quatd, double, 4, py::dtype::of<double>())
+  ARRAY_VIEW(value::point3h, uint16_t, 3, py::dtype("float16"))
+  ARRAY_VIEW(value::point3f, float, 3, py::dtype::of<float>())
+  ARRAY_VIEW(value::point3d, double, 3, py::dtype::of<double>())
+  ARRAY_VIEW(value::normal3h, uint16_t, 3, py::dtype("float16"))
+  ARRAY_VIEW(value::normal3f, float, 3, py::dtype::of<float>())
+  ARRAY_VIEW(value::normal3d, double, 3, py::dtype::of<double>())
+  ARRAY_VIEW(value::vector3h, uint16_t, 3, py::dtype("float16"))
+  ARRAY_VIEW(value::vector3f, float, 3, py::dtype::of<float>())
+  ARRAY_VIEW(value::vector3d, double, 3, py::dtype::of<double>())
+  ARRAY_VIEW(value::color3h, uint16_t, 3, py::dtype("float16"))
+  ARRAY_VIEW(value::color3f, float, 3, py::dtype::of<float>())
+  ARRAY_VIEW(value::color3d, double, 3, py::dtype::of<double>())
+  ARRAY_VIEW(value::color4h, uint16_t, 4, py::dtype("float16"))
+  ARRAY_VIEW(value::color4f, float, 4, py::dtype::of<float>())
+  ARRAY_VIEW(value::color4d, double, 4, py::dtype::of<double>())
+  ARRAY_VIEW(value::texcoord2h, uint16_t, 2, py::dtype("float16"))
+  ARRAY_VIEW(value::texcoord2f, float, 2, py::dtype::of<float>())
+  ARRAY_VIEW(value::texcoord2d, double, 2, py::dtype::of<double>())
+  ARRAY_VIEW(value::texcoord3h, uint16_t, 3, py::dtype("float16"))
+  ARRAY_VIEW(value::texcoord3f, float, 3, py::dtype::of<float>())
+  ARRAY_VIEW(value::texcoord3d, double, 3, py::dtype::of<double>())
+
+#undef ARRAY_VIEW
+
+  return py::none();
+}
+
+///
+/// Python list of references to `v`'s elements. Each element keeps `owner`
+/// alive.
+///
+template <typename T>
+py::list make_list_view(std::vector<T> &v, py::handle owner) {
+  py::list l;
+  for (auto &item : v) {
+    l.append(py::cast(&item, py::return_value_policy::reference_internal,
+                      owner));
+  }
+  return l;
+}
+
+tinyusdz::tydra::RenderScene to_render_scene(
+    const tinyusdz::Stage &stage,
+    const tinyusdz::tydra::RenderSceneConverterConfig &config,
+    const std::string &usd_filename) {
+  using namespace tinyusdz;
+
+  tydra::RenderScene render_scene;
+  tydra::RenderSceneConverter converter;
+  tydra::RenderSceneConverterEnv env(stage);
+  env.scene_config = config;
+
+  // NOTE: Must be valid until the end of the conversion.
+  USDZAsset usdz_asset;
+
+  std::string err;
+  bool ret{false};
+  {
+    // Allow other Python threads to run while converting.
+    py::gil_scoped_release release;
+
+    if (usd_filename.empty()) {
+      ret = true;
+    } else if (io::GetFileExtension(usd_filename) == "usdz") {
+      std::string warn;
+      if (!ReadUSDZAssetInfoFromFile(usd_filename, &usdz_asset, &warn, &err)) {
+        err = "Failed to read USDZ assetInfo: " + err;
+      } else if (!SetupUSDZAssetResolution(env.asset_resolver, &usdz_asset)) {
+        err = "Failed to setup AssetResolution for USDZ asset.";
+      } else {
+        ret = true;
+      }
+    } else {
+      env.set_search_paths({io::GetBaseDir(usd_filename)});
+      ret = true;
+    }
+
+    if (ret) {
+      ret = converter.ConvertToRenderScene(env, &render_scene);
+      if (!ret) {
+        err = converter.GetError();
+      }
+    }
+  }
+
+  if (!ret) {
+    std::string msg = "Failed to convert Stage to RenderScene: " + err;
+    PyErr_SetString(PyExc_RuntimeError, msg.c_str());
+    throw py::error_already_set();
+  }
+
+  return render_scene;
+}
+
 }  // namespace internal
 
 PYBIND11_MODULE(ctinyusdz, m) {
@@ -221,13 +516,9 @@ PYBIND11_MODULE(ctinyusdz, m) {
     .def("set_array", [](primvar::PrimVar &p, const py::array_t<int32_t> v) {
       py::print("set_arr int[]");
     })
-    .def("get_array", [](primvar::PrimVar &p) -> py::array_t<float> {
-      std::vector<float> v;
-
-      auto result = py::array_t<float>(16);
-      
-      return result;
-    })
+    // numpy array which aliases the array value(no copy). None when PrimVar
+    // does not hold numeric array value.
+    .def("get_array", &internal::primvar_array_view)
     ;
 
   py::class_<Prim>(m, "Prim")
@@ -254,6 +545,17 @@ PYBIND11_MODULE(ctinyusdz, m) {
       //  py::print("setter");
       //  p.children() = v;
       //})
+      // PrimVar(copy of the value) of the Attribute. None when the Prim does
+      // not have the Attribute.
+      .def("get_attribute",
+           [](const Prim &p, const std::string &attr_name) -> py::object {
+             Attribute attr;
+             std::string err;
+             if (!tydra::GetAttribute(p, attr_name, &attr, &err)) {
+               return py::none();
+             }
+             return py::cast(std::move(attr.get_var()));
+           })
       .def("__str__", [](const Prim &p) {
         return to_string(p);       
       })
@@ -283,11 +585,16 @@ PYBIND11_MODULE(ctinyusdz, m) {
           [](Stage &stage) -> std::vector<Prim> & { return stage.root_prims(); },
           py::return_value_policy::reference)
       .def("GetPrimAtPath",
-           [](const Stage &s, const std::string &path_str) -> py::object {
+           [](py::object self, const std::string &path_str) -> py::object {
+             const Stage &s = self.cast<const Stage &>();
              Path path(path_str, "");
 
              if (auto p = s.GetPrimAtPath(path)) {
-               return py::cast(*p);
+               // Prim is owned by the Stage. Keep the Stage alive while the
+               // Prim is referenced.
+               return py::cast(p.value(),
+                               py::return_value_policy::reference_internal,
+                               self);
              }
 
              return py::none();
@@ -503,10 +810,100 @@ PYBIND11_MODULE(ctinyusdz, m) {
     py::class_<tydra::RenderSceneConverterConfig>(m_tydra, "RenderSceneConverterConfig")
       .def(py::init<>())
       .def_readwrite("load_texture_assets", &tydra::RenderSceneConverterConfig::load_texture_assets)
+      .def_readwrite("parallel_texture_loading", &tydra::RenderSceneConverterConfig::parallel_texture_loading)
+      .def_readwrite("texture_loading_num_threads", &tydra::RenderSceneConverterConfig::texture_loading_num_threads)
+    ;
+
+    py::enum_<tydra::ComponentType>(m_tydra, "ComponentType")
+      .value("UInt8", tydra::ComponentType::UInt8)
+      .value("Int8", tydra::ComponentType::Int8)
+      .value("UInt16", tydra::ComponentType::UInt16)
+      .value("Int16", tydra::ComponentType::Int16)
+      .value("UInt32", tydra::ComponentType::UInt32)
+      .value("Int32", tydra::ComponentType::Int32)
+      .value("Half", tydra::ComponentType::Half)
+      .value("Float", tydra::ComponentType::Float)
+      .value("Double", tydra::ComponentType::Double)
+    ;
+
+    // Array properties return numpy arrays which alias C++ memory. Modifying
+    // the numpy array modifies RenderScene data.
+    py::class_<tydra::BufferData>(m_tydra, "BufferData")
+      .def_readonly("component_type", &tydra::BufferData::componentType)
+      .def_property_readonly("data", [](py::object self) {
+        const tydra::BufferData &b = self.cast<const tydra::BufferData &>();
+        py::dtype dt = internal::to_dtype(b.componentType);
+        return internal::make_array_view(dt, b.data.data(), b.data.size() / size_t(dt.itemsize()), 1, self);
+      })
+    ;
+
+    py::class_<tydra::VertexAttribute>(m_tydra, "VertexAttribute")
+      .def_readonly("name", &tydra::VertexAttribute::name)
+      .def_property_readonly("format", [](const tydra::VertexAttribute &a) { return tydra::to_string(a.format); })
+      .def_readonly("element_size", &tydra::VertexAttribute::elementSize)
+      .def_property_readonly("variability", [](const tydra::VertexAttribute &a) { return tydra::to_string(a.variability); })
+      .def_property_readonly("data", [](py::object self) {
+        return internal::vertex_attribute_view(self.cast<const tydra::VertexAttribute &>(), self);
+      })
+      .def_property_readonly("indices", [](py::object self) {
+        return internal::make_array_view(self.cast<const tydra::VertexAttribute &>().indices, 1, self);
+      })
+    ;
+
+    py::class_<tydra::RenderMesh>(m_tydra, "RenderMesh")
+      .def_readonly("prim_name", &tydra::RenderMesh::prim_name)
+      .def_readonly("abs_path", &tydra::RenderMesh::abs_path)
+      .def_readonly("material_id", &tydra::RenderMesh::material_id)
+      .def_readonly("is_single_indexable", &tydra::RenderMesh::is_single_indexable)
+      .def_property_readonly("points", [](py::object self) {
+        const tydra::RenderMesh &mesh = self.cast<const tydra::RenderMesh &>();
+        return internal::make_array_view(py::dtype::of<float>(), mesh.points.data(), mesh.points.size(), 3, self);
+      })
+      .def_property_readonly("face_vertex_indices", [](py::object self) {
+        return internal::make_array_view(self.cast<const tydra::RenderMesh &>().faceVertexIndices(), 1, self);
+      })
+      .def_property_readonly("face_vertex_counts", [](py::object self) {
+        return internal::make_array_view(self.cast<const tydra::RenderMesh &>().faceVertexCounts(), 1, self);
+      })
+      .def_readonly("normals", &tydra::RenderMesh::normals, py::return_value_policy::reference_internal)
+      .def_readonly("tangents", &tydra::RenderMesh::tangents, py::return_value_policy::reference_internal)
+      .def_readonly("binormals", &tydra::RenderMesh::binormals, py::return_value_policy::reference_internal)
+      .def_property_readonly("texcoords", [](py::object self) {
+        // key: texcoord slot ID
+        tydra::RenderMesh &mesh = self.cast<tydra::RenderMesh &>();
+        py::dict d;
+        for (auto &it : mesh.texcoords) {
+          d[py::int_(it.first)] = py::cast(&it.second, py::return_value_policy::reference_internal, self);
+        }
+        return d;
+      })
+    ;
+
+    py::class_<tydra::TextureImage>(m_tydra, "TextureImage")
+      .def_readonly("asset_identifier", &tydra::TextureImage::asset_identifier)
+      .def_readonly("texel_component_type", &tydra::TextureImage::texelComponentType)
+      .def_readonly("width", &tydra::TextureImage::width)
+      .def_readonly("height", &tydra::TextureImage::height)
+      .def_readonly("channels", &tydra::TextureImage::channels)
+      .def_readonly("buffer_id", &tydra::TextureImage::buffer_id)
+    ;
+
+    py::class_<tydra::RenderScene>(m_tydra, "RenderScene")
+      .def_readonly("usd_filename", &tydra::RenderScene::usd_filename)
+      .def_property_readonly("meshes", [](py::object self) {
+        return internal::make_list_view(self.cast<tydra::RenderScene &>().meshes, self);
+      })
+      .def_property_readonly("images", [](py::object self) {
+        return internal::make_list_view(self.cast<tydra::RenderScene &>().images, self);
+      })
+      .def_property_readonly("buffers", [](py::object self) {
+        return internal::make_list_view(self.cast<tydra::RenderScene &>().buffers, self);
+      })
     ;
 
-    m_tydra.def("to_render_scene", [](const Stage &stage) {
-      py::print("TODO");
-    }, py::arg("config") = tydra::RenderSceneConverterConfig());
+    // GIL is released during the conversion.
+    m_tydra.def("to_render_scene", &internal::to_render_scene,
+      "Convert Stage to RenderScene. `usd_filename` is used to resolve asset(e.g. texture) paths.",
+      py::arg("stage"), py::arg("config") = tydra::RenderSceneConverterConfig(), py::arg("usd_filename") = "");
   }
 }
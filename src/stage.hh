@@ -4,7 +4,10 @@
 // Stage: Similar to Scene or Scene graph
 #pragma once
 
+#include <memory>
+
 #include "composition.hh"
+#include "memory-budget.hh"
 #include "prim-types.hh"
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
@@ -242,6 +245,21 @@ class Stage {
     return _err;
   }
 
+  ///
+  /// Memory reserved in `USDLoadOptions::memory_budget` for Prims of this
+  /// Stage. Set by the loader. Copies of the Stage share the reservation, and
+  /// it is released when the last Stage sharing it is destroyed(or
+  /// overwritten). The reservation shares the budget, so the budget outlives
+  /// the Stage.
+  ///
+  void set_memory_reservation(std::shared_ptr<MemoryReservation> reservation) {
+    _memory_reservation = std::move(reservation);
+  }
+
+  const std::shared_ptr<MemoryReservation> &get_memory_reservation() const {
+    return _memory_reservation;
+  }
+
  private:
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
@@ -308,6 +326,8 @@ class Stage {
   mutable bool _prim_id_dirty{true}; // True when Prim Id assignent changed(TODO: Unify with `_dirty` flag)
 
   mutable HandleAllocator<uint64_t> _prim_id_allocator;
+
+  std::shared_ptr<MemoryReservation> _memory_reservation;
 };
 
 inline std::string to_string(const Stage &stage, bool relative_path = false) {
@@ -8,14 +8,19 @@
 #endif
 #endif
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <string>
 
 #include "subdiv.hh"
 
 #include "common-macros.inc"
+#include "parallel-for.hh"
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -23,6 +28,7 @@
 #endif
 
 #include <opensubdiv/far/primvarRefiner.h>
+#include <opensubdiv/far/stencilTableFactory.h>
 #include <opensubdiv/far/topologyDescriptor.h>
 
 #ifdef __clang__
@@ -318,4 +324,334 @@ bool subdivide(int subd_level, const ControlQuadMesh &in_mesh, SubdividedMesh *o
   return true;
 }
 
+//------------------------------------------------------------------------------
+// Subdivider
+//
+
+namespace {
+
+// Stencils in plain arrays(CSR).
+struct Stencils {
+  std::vector<int> sizes;
+  std::vector<int> offsets;
+  std::vector<int> indices;
+  std::vector<float> weights;
+
+  void Set(const Far::StencilTable &table) {
+    sizes = table.GetSizes();
+    offsets = table.GetOffsets();
+    indices = table.GetControlIndices();
+    weights = table.GetWeights();
+  }
+
+  size_t size() const { return sizes.size(); }
+
+  void Apply(const float *src, size_t num_components, float *dst,
+             int num_threads) const {
+    parallel::ParallelForChunked(
+        sizes.size(),
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          for (size_t i = begin; i < end; i++) {
+            const int *idx = indices.data() + offsets[i];
+            const float *w = weights.data() + offsets[i];
+            const size_t n = size_t(sizes[i]);
+            float *d = dst + i * num_components;
+
+            if (num_components == 3) {
+              float x = 0.0f, y = 0.0f, z = 0.0f;
+              for (size_t k = 0; k < n; k++) {
+                const float *s = src + size_t(idx[k]) * 3;
+                x += w[k] * s[0];
+                y += w[k] * s[1];
+                z += w[k] * s[2];
+              }
+              d[0] = x;
+              d[1] = y;
+              d[2] = z;
+            } else {
+              for (size_t c = 0; c < num_components; c++) {
+                d[c] = 0.0f;
+              }
+              for (size_t k = 0; k < n; k++) {
+                const float *s = src + size_t(idx[k]) * num_components;
+                for (size_t c = 0; c < num_components; c++) {
+                  d[c] += w[k] * s[c];
+                }
+              }
+            }
+          }
+        },
+        num_threads, 1024);
+  }
+};
+
+}  // namespace
+
+#define PushError(msg) \
+  if (err) {           \
+    (*err) += msg;     \
+  }
+
+class Subdivider::Impl {
+ public:
+  bool valid{false};
+
+  SubdividerOptions options;
+  size_t num_vertices{0};
+  std::vector<uint32_t> face_vertex_counts;
+  std::vector<uint32_t> face_vertex_indices;
+
+  std::vector<uint32_t> refined_face_vertex_counts;
+  std::vector<uint32_t> refined_face_vertex_indices;
+  std::vector<uint32_t> refined_face_parents;
+
+  Stencils vertex_stencils;
+  Stencils fvar_stencils;
+
+  // Refined fvar value index for each refined face-vertex.
+  std::vector<uint32_t> refined_fvar_indices;
+};
+
+Subdivider::Subdivider() : _impl(new Impl()) {}
+
+Subdivider::~Subdivider() = default;
+
+bool Subdivider::valid() const { return _impl->valid; }
+
+size_t Subdivider::num_control_vertices() const { return _impl->num_vertices; }
+
+size_t Subdivider::num_refined_vertices() const {
+  return _impl->vertex_stencils.size();
+}
+
+const std::vector<uint32_t> &Subdivider::refined_face_vertex_counts() const {
+  return _impl->refined_face_vertex_counts;
+}
+
+const std::vector<uint32_t> &Subdivider::refined_face_vertex_indices() const {
+  return _impl->refined_face_vertex_indices;
+}
+
+const std::vector<uint32_t> &Subdivider::refined_face_parents() const {
+  return _impl->refined_face_parents;
+}
+
+bool Subdivider::IsSameTopology(
+    const SubdividerOptions &options, size_t num_vertices,
+    const std::vector<uint32_t> &face_vertex_counts,
+    const std::vector<uint32_t> &face_vertex_indices) const {
+  const Impl &impl = *_impl;
+  return impl.valid && (impl.options.scheme == options.scheme) &&
+         (impl.options.level == options.level) &&
+         (impl.options.boundary_interpolation ==
+          options.boundary_interpolation) &&
+         (impl.num_vertices == num_vertices) &&
+         (impl.face_vertex_counts == face_vertex_counts) &&
+         (impl.face_vertex_indices == face_vertex_indices);
+}
+
+bool Subdivider::Setup(const SubdividerOptions &_options, size_t num_vertices,
+                       const std::vector<uint32_t> &face_vertex_counts,
+                       const std::vector<uint32_t> &face_vertex_indices,
+                       std::string *err) {
+  SubdividerOptions options = _options;
+  options.level = (std::max)(1, (std::min)(8, options.level));
+
+  if (IsSameTopology(options, num_vertices, face_vertex_counts,
+                     face_vertex_indices)) {
+    return true;
+  }
+
+  Impl &impl = *_impl;
+  impl = Impl();
+
+  //
+  // Validate topology.
+  //
+  size_t sum_counts = 0;
+  for (uint32_t c : face_vertex_counts) {
+    if (c < 3) {
+      PUSH_ERROR_AND_RETURN("faceVertexCounts must be >= 3.");
+    }
+    if ((options.scheme == SubdivisionScheme::Loop) && (c != 3)) {
+      PUSH_ERROR_AND_RETURN("Loop subdivision requires a triangle mesh.");
+    }
+    sum_counts += c;
+  }
+  if (sum_counts != face_vertex_indices.size()) {
+    PUSH_ERROR_AND_RETURN("sum(faceVertexCounts) must be equal to faceVertexIndices.size.");
+  }
+  for (uint32_t idx : face_vertex_indices) {
+    if (idx >= num_vertices) {
+      PUSH_ERROR_AND_RETURN("faceVertexIndices contains out-of-range index.");
+    }
+  }
+  if (face_vertex_counts.empty() || (num_vertices > size_t((std::numeric_limits<int>::max)())) ||
+      (sum_counts > size_t((std::numeric_limits<int>::max)()))) {
+    PUSH_ERROR_AND_RETURN("Empty or too large mesh.");
+  }
+
+  //
+  // Refine topology.
+  //
+  typedef Far::TopologyDescriptor Descriptor;
+
+  Sdc::SchemeType type = Sdc::SCHEME_CATMARK;
+  if (options.scheme == SubdivisionScheme::Loop) {
+    type = Sdc::SCHEME_LOOP;
+  } else if (options.scheme == SubdivisionScheme::Bilinear) {
+    type = Sdc::SCHEME_BILINEAR;
+  }
+
+  Sdc::Options sdc_options;
+  if (options.boundary_interpolation == BoundaryInterpolation::None) {
+    sdc_options.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_NONE);
+  } else if (options.boundary_interpolation ==
+             BoundaryInterpolation::EdgeOnly) {
+    sdc_options.SetVtxBoundaryInterpolation(
+        Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+  } else {
+    sdc_options.SetVtxBoundaryInterpolation(
+        Sdc::Options::VTX_BOUNDARY_EDGE_AND_CORNER);
+  }
+  sdc_options.SetFVarLinearInterpolation(Sdc::Options::FVAR_LINEAR_ALL);
+
+  std::vector<int> num_verts_per_face(face_vertex_counts.begin(),
+                                      face_vertex_counts.end());
+  std::vector<int> vert_indices_per_face(face_vertex_indices.begin(),
+                                         face_vertex_indices.end());
+
+  // Face-varying values are given per face-vertex.
+  std::vector<int> fvar_indices(sum_counts);
+  for (size_t i = 0; i < sum_counts; i++) {
+    fvar_indices[i] = int(i);
+  }
+
+  Descriptor::FVarChannel channel;
+  channel.numValues = int(sum_counts);
+  channel.valueIndices = fvar_indices.data();
+
+  Descriptor desc;
+  desc.numVertices = int(num_vertices);
+  desc.numFaces = int(num_verts_per_face.size());
+  desc.numVertsPerFace = num_verts_per_face.data();
+  desc.vertIndicesPerFace = vert_indices_per_face.data();
+  desc.numFVarChannels = 1;
+  desc.fvarChannels = &channel;
+
+  std::unique_ptr<Far::TopologyRefiner> refiner(
+      Far::TopologyRefinerFactory<Descriptor>::Create(
+          desc,
+          Far::TopologyRefinerFactory<Descriptor>::Options(type, sdc_options)));
+  if (!refiner) {
+    PUSH_ERROR_AND_RETURN("Failed to create TopologyRefiner.");
+  }
+
+  {
+    Far::TopologyRefiner::UniformOptions refine_options(options.level);
+    refine_options.fullTopologyInLastLevel = true;
+    refiner->RefineUniform(refine_options);
+  }
+
+  //
+  // Stencil tables for the last level.
+  //
+  {
+    Far::StencilTableFactory::Options st_options;
+    st_options.generateOffsets = true;
+    st_options.generateIntermediateLevels = false;
+
+    st_options.interpolationMode = Far::StencilTableFactory::INTERPOLATE_VERTEX;
+    std::unique_ptr<const Far::StencilTable> vtable(
+        Far::StencilTableFactory::Create(*refiner, st_options));
+
+    st_options.interpolationMode =
+        Far::StencilTableFactory::INTERPOLATE_FACE_VARYING;
+    st_options.fvarChannel = 0;
+    std::unique_ptr<const Far::StencilTable> ftable(
+        Far::StencilTableFactory::Create(*refiner, st_options));
+
+    if (!vtable || !ftable) {
+      PUSH_ERROR_AND_RETURN("Failed to create StencilTable.");
+    }
+
+    impl.vertex_stencils.Set(*vtable);
+    impl.fvar_stencils.Set(*ftable);
+  }
+
+  //
+  // Refined topology.
+  //
+  const int max_level = refiner->GetMaxLevel();
+  const Far::TopologyLevel &last = refiner->GetLevel(max_level);
+  const int nfaces = last.GetNumFaces();
+
+  impl.refined_face_vertex_counts.reserve(size_t(nfaces));
+  impl.refined_face_parents.reserve(size_t(nfaces));
+  for (int f = 0; f < nfaces; f++) {
+    // Boundary faces are holes with `BoundaryInterpolation::None`.
+    if (last.IsFaceHole(f)) {
+      continue;
+    }
+
+    Far::ConstIndexArray fverts = last.GetFaceVertices(f);
+    Far::ConstIndexArray fvals = last.GetFaceFVarValues(f, 0);
+    impl.refined_face_vertex_counts.push_back(uint32_t(fverts.size()));
+    for (int k = 0; k < fverts.size(); k++) {
+      impl.refined_face_vertex_indices.push_back(uint32_t(fverts[k]));
+      impl.refined_fvar_indices.push_back(uint32_t(fvals[k]));
+    }
+
+    int parent = f;
+    for (int level = max_level; level > 0; level--) {
+      parent = refiner->GetLevel(level).GetFaceParentFace(parent);
+    }
+    impl.refined_face_parents.push_back(uint32_t(parent));
+  }
+
+  impl.options = options;
+  impl.num_vertices = num_vertices;
+  impl.face_vertex_counts = face_vertex_counts;
+  impl.face_vertex_indices = face_vertex_indices;
+  impl.valid = true;
+
+  return true;
+}
+
+#undef PushError
+
+bool Subdivider::RefineVertex(const float *src, size_t num_components,
+                              std::vector<float> *dst, int num_threads) const {
+  if (!_impl->valid || !src || !dst || (num_components == 0)) {
+    return false;
+  }
+
+  const Stencils &stencils = _impl->vertex_stencils;
+  dst->resize(stencils.size() * num_components);
+  stencils.Apply(src, num_components, dst->data(), num_threads);
+  return true;
+}
+
+bool Subdivider::RefineFaceVarying(const float *src, size_t num_components,
+                                   std::vector<float> *dst,
+                                   int num_threads) const {
+  if (!_impl->valid || !src || !dst || (num_components == 0)) {
+    return false;
+  }
+
+  const Stencils &stencils = _impl->fvar_stencils;
+  std::vector<float> values(stencils.size() * num_components);
+  stencils.Apply(src, num_components, values.data(), num_threads);
+
+  const std::vector<uint32_t> &fvar_indices = _impl->refined_fvar_indices;
+  dst->resize(fvar_indices.size() * num_components);
+  for (size_t i = 0; i < fvar_indices.size(); i++) {
+    memcpy(dst->data() + i * num_components,
+           values.data() + size_t(fvar_indices[i]) * num_components,
+           sizeof(float) * num_components);
+  }
+  return true;
+}
+
 }  // namespace tinyusdz
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace tinyusdz {
@@ -106,4 +108,107 @@ struct Vertex {
 bool subdivide(int level, const ControlQuadMesh &in_mesh,
                SubdividedMesh *out_mesh, std::string *err, bool dump = false);
 
+enum class SubdivisionScheme {
+  CatmullClark,
+  Loop,  // Triangle mesh only
+  Bilinear,
+};
+
+// USD `interpolateBoundary`
+enum class BoundaryInterpolation {
+  None,           // "none". Boundary faces are not refined(treated as holes).
+  EdgeOnly,       // "edgeOnly"
+  EdgeAndCorner,  // "edgeAndCorner"(USD default)
+};
+
+struct SubdividerOptions {
+  SubdivisionScheme scheme{SubdivisionScheme::CatmullClark};
+
+  int level{1};  // Uniform subdivision level. Clamped to [1, 8]
+
+  BoundaryInterpolation boundary_interpolation{
+      BoundaryInterpolation::EdgeAndCorner};
+};
+
+///
+/// Uniform subdivision with cached topology refiner and stencil tables.
+///
+/// `Setup` refines the topology and builds stencil tables once. After that,
+/// `RefineVertex`/`RefineFaceVarying` only apply precomputed stencils to the
+/// control values, so evaluating a deforming mesh(topology does not change
+/// over time) per frame is cheap. Stencils are applied in parallel.
+///
+/// Face-varying values are given per control face-vertex(i.e. flattened
+/// `facevarying`), and interpolated linearly in each face.
+///
+class Subdivider {
+ public:
+  Subdivider();
+  ~Subdivider();
+  Subdivider(const Subdivider &rhs) = delete;
+  Subdivider &operator=(const Subdivider &rhs) = delete;
+
+  ///
+  /// Build the refiner and stencil tables. Does nothing when the topology and
+  /// options are the same as the current ones.
+  ///
+  /// @param[in] options Subdivision options.
+  /// @param[in] num_vertices # of control vertices.
+  /// @param[in] face_vertex_counts faceVertexCounts of the control mesh.
+  /// @param[in] face_vertex_indices faceVertexIndices of the control mesh.
+  /// @param[out] err Error message.
+  ///
+  bool Setup(const SubdividerOptions &options, size_t num_vertices,
+             const std::vector<uint32_t> &face_vertex_counts,
+             const std::vector<uint32_t> &face_vertex_indices,
+             std::string *err);
+
+  bool IsSameTopology(const SubdividerOptions &options, size_t num_vertices,
+                      const std::vector<uint32_t> &face_vertex_counts,
+                      const std::vector<uint32_t> &face_vertex_indices) const;
+
+  bool valid() const;
+
+  size_t num_control_vertices() const;
+  size_t num_refined_vertices() const;
+
+  // Topology of the refined mesh(quads for CatmullClark and Bilinear, triangles
+  // for Loop).
+  const std::vector<uint32_t> &refined_face_vertex_counts() const;
+  const std::vector<uint32_t> &refined_face_vertex_indices() const;
+
+  // Index of the control face for each refined face.
+  const std::vector<uint32_t> &refined_face_parents() const;
+
+  ///
+  /// Apply vertex stencils.
+  ///
+  /// @param[in] src Control values. `num_control_vertices() * num_components`
+  /// floats.
+  /// @param[in] num_components # of floats per value.
+  /// @param[out] dst Refined values. `num_refined_vertices() * num_components`
+  /// floats.
+  /// @param[in] num_threads # of threads. -1 = use all hardware threads.
+  ///
+  bool RefineVertex(const float *src, size_t num_components,
+                    std::vector<float> *dst, int num_threads = -1) const;
+
+  ///
+  /// Apply face-varying stencils.
+  ///
+  /// @param[in] src Values per control face-vertex.
+  /// `sum(face_vertex_counts) * num_components` floats.
+  /// @param[in] num_components # of floats per value.
+  /// @param[out] dst Values per refined face-vertex.
+  /// `refined_face_vertex_indices().size() * num_components` floats.
+  /// @param[in] num_threads # of threads. -1 = use all hardware threads.
+  ///
+  bool RefineFaceVarying(const float *src, size_t num_components,
+                         std::vector<float> *dst, int num_threads = -1) const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
 }  // namespace tinyusdz
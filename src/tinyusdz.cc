@@ -26,6 +26,7 @@
 #include "integerCoding.h"
 #include "io-util.hh"
 #include "lz4-compression.hh"
+#include "performance.hh"
 #include "pprinter.hh"
 #include "str-util.hh"
 #include "stream-reader.hh"
@@ -78,10 +79,37 @@ namespace tinyusdz {
   }
 //#define PushWarn(s) if (warn) { (*warn) += s; }
 
+namespace {
+
+uint64_t GetMemoryLimitInBytes(const USDLoadOptions &options) {
+  if (options.max_memory_limit_in_mb < 0) {
+    return (std::numeric_limits<uint64_t>::max)();
+  }
+  return uint64_t(options.max_memory_limit_in_mb) * 1024ull * 1024ull;
+}
+
+// Return a copy of `options` whose `memory_budget` is set, so that nested
+// loaders share the same budget. A budget limited by `max_memory_limit_in_mb`
+// is created when `options.memory_budget` is nullptr. The Stage keeps the
+// budget alive through its MemoryReservation.
+USDLoadOptions ResolveMemoryBudget(const USDLoadOptions &options) {
+  USDLoadOptions ret = options;
+  if (!ret.memory_budget) {
+    ret.memory_budget =
+        std::make_shared<MemoryBudget>(GetMemoryLimitInBytes(options));
+  }
+  return ret;
+}
+
+}  // namespace
+
 bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
                         const std::string &filename, Stage *stage,
                         std::string *warn, std::string *err,
-                        const USDLoadOptions &options) {
+                        const USDLoadOptions &_options) {
+  TINYUSDZ_TRACE_ZONE("LoadUSDCFromMemory");
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   if (stage == nullptr) {
     if (err) {
       (*err) = "null pointer for `stage` argument.\n";
@@ -125,6 +153,8 @@ bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
   usdc::USDCReaderConfig config;
   config.numThreads = options.num_threads;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
+  config.memory_budget = options.memory_budget;
+  config.population_mask = options.population_mask;
   usdc::USDCReader reader(&sr, config);
 
   if (!reader.ReadUSDC()) {
@@ -173,7 +203,9 @@ bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
 
 bool LoadUSDCFromFile(const std::string &_filename, Stage *stage,
                       std::string *warn, std::string *err,
-                      const USDLoadOptions &options) {
+                      const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   std::string filepath = io::ExpandFilePath(_filename, /* userdata */ nullptr);
 
   std::vector<uint8_t> data;
@@ -187,6 +219,12 @@ bool LoadUSDCFromFile(const std::string &_filename, Stage *stage,
     return false;
   }
 
+  ScopedMemoryReservation data_reservation(options.memory_budget.get(),
+                                           MemoryCategory::Assets);
+  if (!data_reservation.reserve(data.size(), err)) {
+    return false;
+  }
+
   DCOUT("File size: " + std::to_string(data.size()) + " bytes.");
 
   if (data.size() < (11 * 8)) {
@@ -350,7 +388,10 @@ bool ParseUSDZHeader(const uint8_t *addr, const size_t length,
 bool LoadUSDZFromMemory(const uint8_t *addr, const size_t length,
                         const std::string &filename, Stage *stage,
                         std::string *warn, std::string *err,
-                        const USDLoadOptions &options) {
+                        const USDLoadOptions &_options) {
+  TINYUSDZ_TRACE_ZONE("LoadUSDZFromMemory");
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   std::vector<USDZAssetInfo> assets;
   if (!ParseUSDZHeader(addr, length, &assets, warn, err)) {
     return false;
@@ -593,7 +634,9 @@ bool LoadUSDZFromMemory(const uint8_t *addr, const size_t length,
 
 bool LoadUSDZFromFile(const std::string &_filename, Stage *stage,
                       std::string *warn, std::string *err,
-                      const USDLoadOptions &options) {
+                      const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   // <filename, byte_begin, byte_end>
   std::vector<std::tuple<std::string, size_t, size_t>> assets;
 
@@ -606,6 +649,12 @@ bool LoadUSDZFromFile(const std::string &_filename, Stage *stage,
     return false;
   }
 
+  ScopedMemoryReservation data_reservation(options.memory_budget.get(),
+                                           MemoryCategory::Assets);
+  if (!data_reservation.reserve(data.size(), err)) {
+    return false;
+  }
+
   if (data.size() < (11 * 8) + 30) {  // 88 for USDC header, 30 for ZIP header
     // ???
     if (err) {
@@ -631,7 +680,10 @@ bool LoadUSDZFromFile(const std::wstring &_filename, Stage *stage,
 bool LoadUSDAFromMemory(const uint8_t *addr, const size_t length,
                         const std::string &base_dir, Stage *stage,
                         std::string *warn, std::string *err,
-                        const USDLoadOptions &options) {
+                        const USDLoadOptions &_options) {
+  TINYUSDZ_TRACE_ZONE("LoadUSDAFromMemory");
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   if (addr == nullptr) {
     if (err) {
       (*err) = "null pointer for `addr` argument.\n";
@@ -652,6 +704,8 @@ bool LoadUSDAFromMemory(const uint8_t *addr, const size_t length,
   tinyusdz::usda::USDAReaderConfig config;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
   config.allow_unknown_apiSchema = !options.strict_apiSchema_check;
+  config.memory_budget = options.memory_budget;
+  config.population_mask = options.population_mask;
   reader.set_reader_config(config);
 
   reader.SetBaseDir(base_dir);
@@ -691,7 +745,9 @@ bool LoadUSDAFromMemory(const uint8_t *addr, const size_t length,
 
 bool LoadUSDAFromFile(const std::string &_filename, Stage *stage,
                       std::string *warn, std::string *err,
-                      const USDLoadOptions &options) {
+                      const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   std::string filepath = io::ExpandFilePath(_filename, /* userdata */ nullptr);
   std::string base_dir = io::GetBaseDir(_filename);
 
@@ -704,13 +760,21 @@ bool LoadUSDAFromFile(const std::string &_filename, Stage *stage,
     }
   }
 
+  ScopedMemoryReservation data_reservation(options.memory_budget.get(),
+                                           MemoryCategory::Assets);
+  if (!data_reservation.reserve(data.size(), err)) {
+    return false;
+  }
+
   return LoadUSDAFromMemory(data.data(), data.size(), base_dir, stage, warn,
                             err, options);
 }
 
 bool LoadUSDFromFile(const std::string &_filename, Stage *stage,
                      std::string *warn, std::string *err,
-                     const USDLoadOptions &options) {
+                     const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   std::string filepath = io::ExpandFilePath(_filename, /* userdata */ nullptr);
   std::string base_dir = io::GetBaseDir(_filename);
 
@@ -721,6 +785,12 @@ bool LoadUSDFromFile(const std::string &_filename, Stage *stage,
     return false;
   }
 
+  ScopedMemoryReservation data_reservation(options.memory_budget.get(),
+                                           MemoryCategory::Assets);
+  if (!data_reservation.reserve(data.size(), err)) {
+    return false;
+  }
+
   return LoadUSDFromMemory(data.data(), data.size(), base_dir, stage, warn, err,
                            options);
 }
@@ -944,7 +1014,9 @@ bool IsUSD(const uint8_t *addr, const size_t length, std::string *detected_forma
 bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
                         const std::string &filename, Layer *layer,
                         std::string *warn, std::string *err,
-                        const USDLoadOptions &options) {
+                        const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
   if (layer == nullptr) {
     if (err) {
       (*err) = "null pointer for `layer` argument.\n";
@@ -989,6 +1061,8 @@ bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
   config.numThreads = options.num_threads;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
   config.allow_unknown_apiSchemas = !options.strict_apiSchema_check;
+  config.memory_budget = options.memory_budget;
+  config.population_mask = options.population_mask;
   usdc::USDCReader reader(&sr, config);
 
   if (!reader.ReadUSDC()) {
@@ -1037,7 +1111,9 @@ bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
 bool LoadUSDALayerFromMemory(const uint8_t *addr, const size_t length,
                        const std::string &asset_name, Layer *dst_layer,
                        std::string *warn, std::string *err,
-                       const USDLoadOptions &options) {
+                       const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
 
   // TODO: options
   (void)options;
@@ -1068,6 +1144,8 @@ bool LoadUSDALayerFromMemory(const uint8_t *addr, const size_t length,
 
   tinyusdz::usda::USDAReaderConfig config;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
+  config.memory_budget = options.memory_budget;
+  config.population_mask = options.population_mask;
   reader.set_reader_config(config);
 
   uint32_t load_states = static_cast<uint32_t>(tinyusdz::LoadState::Toplevel);
@@ -1134,6 +1212,7 @@ bool LoadLayerFromMemory(const uint8_t *addr, const size_t length,
                        const std::string &asset_name, Layer *layer,
                        std::string *warn, std::string *err,
                        const USDLoadOptions &options) {
+  TINYUSDZ_TRACE_ZONE("LoadLayerFromMemory");
 
   bool ret{false};
 
@@ -1185,7 +1264,9 @@ bool LoadLayerFromMemory(const uint8_t *addr, const size_t length,
 
 bool LoadLayerFromFile(const std::string &_filename, Layer *stage,
                      std::string *warn, std::string *err,
-                     const USDLoadOptions &options) {
+                     const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
 
   if (_filename.empty()) {
     PUSH_ERROR_AND_RETURN("Input filename is empty.");
@@ -1202,13 +1283,21 @@ bool LoadLayerFromFile(const std::string &_filename, Layer *stage,
     return false;
   }
 
+  ScopedMemoryReservation data_reservation(options.memory_budget.get(),
+                                           MemoryCategory::Assets);
+  if (!data_reservation.reserve(data.size(), err)) {
+    return false;
+  }
+
   return LoadLayerFromMemory(data.data(), data.size(), filepath, stage, warn, err,
                            options);
 }
 
 bool LoadLayerFromAsset(AssetResolutionResolver &resolver, const std::string &resolved_asset_name, Layer *layer,
                      std::string *warn, std::string *err,
-                     const USDLoadOptions &options) {
+                     const USDLoadOptions &_options) {
+  const USDLoadOptions options = ResolveMemoryBudget(_options);
+
 
   if (resolved_asset_name.empty()) {
     PUSH_ERROR_AND_RETURN("Input asset name is empty.");
@@ -1221,7 +1310,15 @@ bool LoadLayerFromAsset(AssetResolutionResolver &resolver, const std::string &re
     PUSH_ERROR_AND_RETURN(fmt::format("Failed to open asset `{}`.", resolved_asset_name));
   }
 
-  return LoadLayerFromMemory(asset.data(), asset.size(), resolved_asset_name, layer, warn, err,
+  // No extra memory is used when the asset is a view(e.g. USD in USDZ).
+  ScopedMemoryReservation asset_reservation(options.memory_budget.get(),
+                                            MemoryCategory::Assets);
+  if (!asset.is_view() && !asset_reservation.reserve(asset.size(), err)) {
+    return false;
+  }
+
+  const Asset &casset = asset;  // read through const accessor to avoid copying the view.
+  return LoadLayerFromMemory(casset.data(), casset.size(), resolved_asset_name, layer, warn, err,
                            options);
 }
 
@@ -1373,19 +1470,65 @@ int USDZReadAsset(const char *resolved_asset_name, uint64_t req_bytes, uint8_t *
     return -2;
   }
 
-  if (byte_range.first + sz > passet->data.size()) {
+  if (byte_range.first + sz > passet->usdz_size()) {
     if (err) {
       (*err) += "Invalid USDZAsset size: " + std::string(resolved_asset_name) + "\n";
     }
     return -2;
   }
 
-  memcpy(out_buf, passet->data.data() + byte_range.first, sz);
+  memcpy(out_buf, passet->usdz_data() + byte_range.first, sz);
   (*nbytes) = sz;
 
   return 0;
 }
 
+int USDZViewAsset(const char *resolved_asset_name, const uint8_t **addr, uint64_t *nbytes, std::string *err, void *userdata) {
+  if (!userdata) {
+    if (err) {
+      (*err) += "`userdata` must be non-null.\n";
+    }
+    return -1;
+  }
+
+  if (!resolved_asset_name) {
+    if (err) {
+      (*err) += "`resolved_asset_name` must be non-null.\n";
+    }
+    return -2;
+  }
+
+  if (!addr || !nbytes) {
+    if (err) {
+      (*err) += "`addr` and `nbytes` must be non-null.\n";
+    }
+    return -2;
+  }
+
+  const USDZAsset *passet = reinterpret_cast<const USDZAsset *>(userdata);
+
+  if (!passet->asset_map.count(resolved_asset_name)) {
+    if (err) {
+      (*err) += "resolved_asset_name `" + std::string(resolved_asset_name) + "` not found in USDZAsset.\n";
+    }
+    return -1;
+  }
+
+  std::pair<size_t, size_t> byte_range = passet->asset_map.at(resolved_asset_name);
+
+  if ((byte_range.first >= byte_range.second) || (byte_range.second > passet->usdz_size())) {
+    if (err) {
+      (*err) += "Invalid USDZAsset byte range: " + std::string(resolved_asset_name) + "\n";
+    }
+    return -2;
+  }
+
+  (*addr) = passet->usdz_data() + byte_range.first;
+  (*nbytes) = byte_range.second - byte_range.first;
+
+  return 0;
+}
+
 bool SetupUSDZAssetResolution(
   AssetResolutionResolver &resolver,
   const USDZAsset *pusdzAsset)
@@ -1408,6 +1551,7 @@ bool SetupUSDZAssetResolution(
   handler.resolve_fun = USDZResolveAsset;
   handler.size_fun = USDZSizeAsset;
   handler.read_fun = USDZReadAsset;
+  handler.view_fun = USDZViewAsset;
   handler.write_fun = nullptr;
   handler.userdata = reinterpret_cast<void *>(const_cast<USDZAsset *>(pusdzAsset));
 
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -41,6 +42,7 @@
 //#include "usdVox.hh"
 #include "stage.hh"
 #include "asset-resolution.hh"
+#include "memory-budget.hh"
 
 
 namespace tinyusdz {
@@ -57,11 +59,39 @@ struct USDLoadOptions {
   ///
   int num_threads{-1};
 
-  // Set the maximum memory limit advisorily(including image data).
+  // Set the maximum memory limit(including image data).
   // This feature would be helpful if you want to load USDZ model in mobile
   // device.
+  // Used when `memory_budget` is nullptr. Memory usage is approximated, so
+  // the actual memory usage may exceed this limit.
   int32_t max_memory_limit_in_mb{16384};  // in [mb] Default 16GB
 
+  ///
+  /// Optional. Memory budget shared across loaders(and Tydra).
+  /// Memory for Crate tables, reconstructed Prims, TimeSamples and asset
+  /// buffers is accounted to this budget, and loading fails as soon as the
+  /// budget's limit would be exceeded. The breakdown of memory usage can be
+  /// inspected after the load(e.g. `to_string(*memory_budget)`).
+  /// When nullptr, an internal budget limited by `max_memory_limit_in_mb` is
+  /// used.
+  ///
+  /// The loaded Stage shares the budget, and memory reserved for its Prims is
+  /// returned to the budget when the last copy of the Stage is destroyed.
+  /// Prim memory is reserved as each Property is parsed and before the Prim is
+  /// reconstructed, so the memory of the Property being checked has already
+  /// been allocated when the limit is exceeded.
+  ///
+  std::shared_ptr<MemoryBudget> memory_budget;
+
+  ///
+  /// Population mask for partial loading. List of absolute Prim paths(e.g.
+  /// `/World/Characters/Hero`). When non-empty, only Prims in the masked
+  /// subtrees and their ancestors are loaded. Other Prims are skipped without
+  /// unpacking(USDC) or parsing(USDA) their content.
+  /// Empty = load all Prims.
+  ///
+  std::vector<Path> population_mask;
+
   ///
   /// TODO: Deprecate
   /// Loads asset data(e.g. texture image, audio). Default is true.
@@ -228,7 +258,16 @@ struct USDZAsset
   size_t size{0}; // in bytes.
   
   bool is_mmaped() const {
-    return !data.empty();
+    return addr != nullptr;
+  }
+
+  // Address and size of USDZ data(regardless of mmapped or not)
+  const uint8_t *usdz_data() const {
+    return addr ? addr : data.data();
+  }
+
+  size_t usdz_size() const {
+    return addr ? size : data.size();
   }
 };
 
@@ -283,6 +322,13 @@ int USDZResolveAsset(const char *asset_name, const std::vector<std::string> &sea
 int USDZSizeAsset(const char *resolved_asset_name, uint64_t *nbytes, std::string *err, void *userdata);
 int USDZReadAsset(const char *resolved_asset_name, uint64_t req_bytes, uint8_t *out_buf, uint64_t *nbytes, std::string *err, void *userdata);
 
+///
+/// Zero-copy view of an asset in USDZ container. Returned address points into
+/// USDZAsset data, so USDZAsset(and mmapped USDZ data) must be retained while
+/// the asset is accessed.
+///
+int USDZViewAsset(const char *resolved_asset_name, const uint8_t **addr, uint64_t *nbytes, std::string *err, void *userdata);
+
 ///
 /// Load USDC(binary) from a file.
 ///
@@ -0,0 +1,759 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Animation sampling and fixed-rate animation clip baking.
+//
+#include "animation-clip.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "common-macros.inc"
+#include "parallel-for.hh"
+#include "tiny-format.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+#define PushError(msg) \
+  {                    \
+    if (err) {         \
+      (*err) += msg;   \
+    }                  \
+  }
+
+inline float Dot(const quat &a, const quat &b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+inline quat Normalize(const quat &q) {
+  float len = std::sqrt(Dot(q, q));
+  if (len > 0.0f) {
+    return {q[0] / len, q[1] / len, q[2] / len, q[3] / len};
+  }
+  return {0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+inline float Interpolate(const float &a, const float &b, float f) {
+  return a + (b - a) * f;
+}
+
+inline vec3 Interpolate(const vec3 &a, const vec3 &b, float f) {
+  return {a[0] + (b[0] - a[0]) * f, a[1] + (b[1] - a[1]) * f,
+          a[2] + (b[2] - a[2]) * f};
+}
+
+// Shortest path slerp. Falls back to nlerp for nearly identical quaternions.
+inline quat Interpolate(const quat &a, const quat &b, float f) {
+  float d = Dot(a, b);
+  quat bb = b;
+  if (d < 0.0f) {
+    d = -d;
+    bb = {-b[0], -b[1], -b[2], -b[3]};
+  }
+
+  float s0, s1;
+  if (d > 0.9995f) {
+    s0 = 1.0f - f;
+    s1 = f;
+  } else {
+    float theta = std::acos(d);
+    float sin_theta = std::sin(theta);
+    s0 = std::sin((1.0f - f) * theta) / sin_theta;
+    s1 = std::sin(f * theta) / sin_theta;
+  }
+
+  return Normalize({s0 * a[0] + s1 * bb[0], s0 * a[1] + s1 * bb[1],
+                    s0 * a[2] + s1 * bb[2], s0 * a[3] + s1 * bb[3]});
+}
+
+template <typename T>
+bool EvaluateSampler(const AnimationSampler<T> &sampler, double t, T *dst) {
+  if (!dst) {
+    return false;
+  }
+
+  if (sampler.samples.empty() || value::TimeCode(t).is_default()) {
+    if (sampler.static_value) {
+      (*dst) = sampler.static_value.value();
+      return true;
+    }
+    if (sampler.samples.empty()) {
+      return false;
+    }
+    (*dst) = sampler.samples.front().value;
+    return true;
+  }
+
+  const auto &samples = sampler.samples;
+  if (t <= double(samples.front().t)) {
+    (*dst) = samples.front().value;
+    return true;
+  }
+  if (t >= double(samples.back().t)) {
+    (*dst) = samples.back().value;
+    return true;
+  }
+
+  auto it = std::upper_bound(
+      samples.begin(), samples.end(), t,
+      [](double tc, const AnimationSample<T> &s) { return tc < double(s.t); });
+  // samples.front().t < t < samples.back().t, so `it` is valid and not the first.
+  const AnimationSample<T> &s1 = *it;
+  const AnimationSample<T> &s0 = *(it - 1);
+
+  if (sampler.interpolation == AnimationSampler<T>::Interpolation::Step) {
+    (*dst) = s0.value;
+    return true;
+  }
+
+  double dt = double(s1.t) - double(s0.t);
+  float f = (dt > 0.0) ? float((t - double(s0.t)) / dt) : 0.0f;
+  (*dst) = Interpolate(s0.value, s1.value, f);
+  return true;
+}
+
+template <typename T>
+bool HasValue(const AnimationSampler<T> &sampler) {
+  return sampler.static_value || !sampler.samples.empty();
+}
+
+template <typename T>
+void UpdateTimeRange(const AnimationSampler<T> *sampler, double *tmin,
+                     double *tmax) {
+  if (!sampler || sampler->samples.empty()) {
+    return;
+  }
+  (*tmin) = (std::min)(*tmin, double(sampler->samples.front().t));
+  (*tmax) = (std::max)(*tmax, double(sampler->samples.back().t));
+}
+
+//
+// Error metrics for keyframe reduction.
+//
+inline float Error(const vec3 &a, const vec3 &b) {
+  float dx = a[0] - b[0];
+  float dy = a[1] - b[1];
+  float dz = a[2] - b[2];
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+inline float ScaleError(const vec3 &a, const vec3 &b) {
+  return (std::max)({std::fabs(a[0] - b[0]), std::fabs(a[1] - b[1]),
+                     std::fabs(a[2] - b[2])});
+}
+
+// Rotation angle between two quaternions.
+inline float Error(const quat &a, const quat &b) {
+  float d = (std::min)(1.0f, std::fabs(Dot(a, b)));
+  return 2.0f * std::acos(d);
+}
+
+//
+// Error-bounded keyframe reduction.
+//
+// Keys are greedily extended: the segment [i, j] is accepted when linear
+// interpolation(slerp for rotations) between frame i and frame j reproduces
+// all frames in between within `tolerance`. The segment length is searched
+// with galloping + bisection, so long linear(or constant) ranges are reduced
+// in O(n log n).
+//
+template <typename T, typename ErrorFn>
+std::vector<uint32_t> ReduceKeys(const std::vector<T> &values, float tolerance,
+                                 ErrorFn error_fn) {
+  const size_t n = values.size();
+  std::vector<uint32_t> keys;
+  if (n == 0) {
+    return keys;
+  }
+
+  keys.push_back(0);
+  if (n == 1) {
+    return keys;
+  }
+
+  // Constant track
+  {
+    bool constant = true;
+    for (size_t i = 1; i < n; i++) {
+      if (error_fn(values[i], values[0]) > tolerance) {
+        constant = false;
+        break;
+      }
+    }
+    if (constant) {
+      return keys;
+    }
+  }
+
+  auto segment_ok = [&](size_t i, size_t j) {
+    const float inv_len = 1.0f / float(j - i);
+    for (size_t m = i + 1; m < j; m++) {
+      T v = Interpolate(values[i], values[j], float(m - i) * inv_len);
+      if (error_fn(v, values[m]) > tolerance) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  size_t i = 0;
+  while (i + 1 < n) {
+    // Galloping
+    size_t good = i + 1;
+    size_t step = 2;
+    size_t bad = n;  // exclusive
+    while (true) {
+      size_t j = i + step;
+      if (j >= n) {
+        if (segment_ok(i, n - 1)) {
+          good = n - 1;
+        } else {
+          bad = n - 1;
+        }
+        break;
+      }
+      if (!segment_ok(i, j)) {
+        bad = j;
+        break;
+      }
+      good = j;
+      step *= 2;
+    }
+
+    // Bisection in (good, bad)
+    while ((good < n - 1) && (good + 1 < bad)) {
+      size_t mid = good + (bad - good) / 2;
+      if (segment_ok(i, mid)) {
+        good = mid;
+      } else {
+        bad = mid;
+      }
+    }
+
+    keys.push_back(uint32_t(good));
+    i = good;
+  }
+
+  return keys;
+}
+
+struct TrackSource {
+  std::string target;
+  const AnimationSampler<vec3> *translations{nullptr};
+  const AnimationSampler<quat> *rotations{nullptr};
+  const AnimationSampler<vec3> *scales{nullptr};
+};
+
+template <typename T>
+struct BakedKeys {
+  std::vector<uint32_t> frames;
+  std::vector<T> values;
+};
+
+struct BakedTarget {
+  BakedKeys<vec3> translations;
+  BakedKeys<quat> rotations;
+  BakedKeys<vec3> scales;
+};
+
+template <typename T, typename ErrorFn>
+void BakeTrack(const AnimationSampler<T> *sampler, const AnimationClip &clip,
+               bool reduce, float tolerance, ErrorFn error_fn,
+               BakedKeys<T> *dst) {
+  if (!sampler) {
+    return;
+  }
+
+  std::vector<T> values(clip.num_frames);
+  for (uint32_t f = 0; f < clip.num_frames; f++) {
+    double t = clip.start_time + double(f) * clip.time_codes_per_frame;
+    EvaluateSampler(*sampler, t, &values[f]);
+  }
+
+  if (reduce) {
+    dst->frames = ReduceKeys(values, tolerance, error_fn);
+  } else {
+    dst->frames.resize(values.size());
+    for (size_t f = 0; f < values.size(); f++) {
+      dst->frames[f] = uint32_t(f);
+    }
+  }
+
+  dst->values.resize(dst->frames.size());
+  for (size_t k = 0; k < dst->frames.size(); k++) {
+    dst->values[k] = values[dst->frames[k]];
+  }
+}
+
+// Make quaternions sign-continuous so that keys can be interpolated without
+// the shortest path check.
+void MakeContinuous(std::vector<quat> *values) {
+  for (size_t i = 1; i < values->size(); i++) {
+    quat &q = (*values)[i];
+    if (Dot((*values)[i - 1], q) < 0.0f) {
+      q = {-q[0], -q[1], -q[2], -q[3]};
+    }
+  }
+}
+
+template <typename T>
+void AppendKeys(const BakedKeys<T> &keys, AnimationClipTrack *track,
+                std::vector<uint32_t> *frames, std::vector<T> *values) {
+  track->offset = uint32_t(frames->size());
+  track->count = uint32_t(keys.frames.size());
+  frames->insert(frames->end(), keys.frames.begin(), keys.frames.end());
+  values->insert(values->end(), keys.values.begin(), keys.values.end());
+}
+
+uint16_t QuantizeUnorm16(float v, float vmin, float extent) {
+  if (!(extent > 0.0f)) {
+    return 0;
+  }
+  float f = (v - vmin) / extent;
+  f = (std::min)(1.0f, (std::max)(0.0f, f));
+  return uint16_t(std::lround(f * 65535.0f));
+}
+
+int16_t QuantizeSnorm16(float v) {
+  v = (std::min)(1.0f, (std::max)(-1.0f, v));
+  return int16_t(std::lround(v * 32767.0f));
+}
+
+void QuantizeVec3Tracks(std::vector<AnimationClipTrack> &tracks,
+                        const std::vector<vec3> &values,
+                        std::vector<uint16_t> *qvalues) {
+  qvalues->resize(values.size() * 3);
+  for (auto &track : tracks) {
+    if (track.count == 0) {
+      continue;
+    }
+    vec3 vmin = values[track.offset];
+    vec3 vmax = values[track.offset];
+    for (uint32_t k = 1; k < track.count; k++) {
+      const vec3 &v = values[track.offset + k];
+      for (size_t c = 0; c < 3; c++) {
+        vmin[c] = (std::min)(vmin[c], v[c]);
+        vmax[c] = (std::max)(vmax[c], v[c]);
+      }
+    }
+    track.range_min = vmin;
+    track.range_extent = {vmax[0] - vmin[0], vmax[1] - vmin[1],
+                          vmax[2] - vmin[2]};
+
+    for (uint32_t k = 0; k < track.count; k++) {
+      const vec3 &v = values[track.offset + k];
+      for (size_t c = 0; c < 3; c++) {
+        (*qvalues)[(track.offset + k) * 3 + c] =
+            QuantizeUnorm16(v[c], vmin[c], track.range_extent[c]);
+      }
+    }
+  }
+}
+
+bool BakeClip(const std::vector<TrackSource> &sources, const RenderScene &scene,
+              const AnimationClipBakeConfig &config, AnimationClip *clip,
+              std::string *err) {
+  //
+  // Frame rate and time range
+  //
+  double fps = (config.frames_per_second > 0.0) ? config.frames_per_second
+                                                : scene.meta.framesPerSecond;
+  if (!(fps > 0.0)) {
+    fps = 24.0;
+  }
+  double tcps = scene.meta.timeCodesPerSecond;
+  if (!(tcps > 0.0)) {
+    tcps = 24.0;
+  }
+
+  double tmin = std::numeric_limits<double>::infinity();
+  double tmax = -std::numeric_limits<double>::infinity();
+  for (const auto &src : sources) {
+    UpdateTimeRange(src.translations, &tmin, &tmax);
+    UpdateTimeRange(src.rotations, &tmin, &tmax);
+    UpdateTimeRange(src.scales, &tmin, &tmax);
+  }
+  if (tmin > tmax) {
+    // No timesamples(static values only)
+    tmin = tmax = 0.0;
+  }
+
+  double start_time = std::isnan(config.start_time) ? tmin : config.start_time;
+  double end_time = std::isnan(config.end_time) ? tmax : config.end_time;
+  if (!std::isfinite(start_time) || !std::isfinite(end_time) ||
+      (start_time > end_time)) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Invalid time range [{}, {}]", start_time, end_time));
+  }
+
+  clip->frames_per_second = fps;
+  clip->time_codes_per_frame = tcps / fps;
+  clip->start_time = start_time;
+
+  double nframes = std::ceil((end_time - start_time) / clip->time_codes_per_frame - 1e-6) + 1.0;
+  if (nframes > double((std::numeric_limits<uint32_t>::max)())) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Too many frames to bake: {}", nframes));
+  }
+  clip->num_frames = uint32_t(nframes);
+
+  //
+  // Bake each target in parallel.
+  //
+  std::vector<BakedTarget> baked(sources.size());
+  const bool reduce = config.reduce_keyframes;
+  parallel::ParallelFor(
+      sources.size(),
+      [&](size_t i, int thread_id) {
+        (void)thread_id;
+        const TrackSource &src = sources[i];
+        BakedTarget &dst = baked[i];
+
+        BakeTrack(src.translations, *clip, reduce,
+                  config.translation_tolerance,
+                  [](const vec3 &a, const vec3 &b) { return Error(a, b); },
+                  &dst.translations);
+
+        if (src.rotations) {
+          // Sample, make continuous, then reduce.
+          BakedKeys<quat> dense;
+          BakeTrack(src.rotations, *clip, /* reduce */ false, 0.0f,
+                    [](const quat &a, const quat &b) { return Error(a, b); },
+                    &dense);
+          for (auto &q : dense.values) {
+            q = Normalize(q);
+          }
+          MakeContinuous(&dense.values);
+          if (reduce) {
+            dst.rotations.frames = ReduceKeys(
+                dense.values, config.rotation_tolerance,
+                [](const quat &a, const quat &b) { return Error(a, b); });
+            for (uint32_t f : dst.rotations.frames) {
+              dst.rotations.values.push_back(dense.values[f]);
+            }
+          } else {
+            dst.rotations = std::move(dense);
+          }
+        }
+
+        BakeTrack(src.scales, *clip, reduce, config.scale_tolerance,
+                  [](const vec3 &a, const vec3 &b) { return ScaleError(a, b); },
+                  &dst.scales);
+      },
+      config.num_threads);
+
+  //
+  // Pack to SoA arrays.
+  //
+  const size_t n = sources.size();
+  clip->targets.resize(n);
+  clip->translation_tracks.assign(n, AnimationClipTrack());
+  clip->rotation_tracks.assign(n, AnimationClipTrack());
+  clip->scale_tracks.assign(n, AnimationClipTrack());
+  clip->translation_frames.clear();
+  clip->rotation_frames.clear();
+  clip->scale_frames.clear();
+  clip->translations.clear();
+  clip->rotations.clear();
+  clip->scales.clear();
+  clip->quantized = false;
+  clip->quantized_translations.clear();
+  clip->quantized_rotations.clear();
+  clip->quantized_scales.clear();
+
+  for (size_t i = 0; i < n; i++) {
+    clip->targets[i] = sources[i].target;
+    AppendKeys(baked[i].translations, &clip->translation_tracks[i],
+               &clip->translation_frames, &clip->translations);
+    AppendKeys(baked[i].rotations, &clip->rotation_tracks[i],
+               &clip->rotation_frames, &clip->rotations);
+    AppendKeys(baked[i].scales, &clip->scale_tracks[i], &clip->scale_frames,
+               &clip->scales);
+  }
+
+  if (config.quantize) {
+    QuantizeVec3Tracks(clip->translation_tracks, clip->translations,
+                       &clip->quantized_translations);
+    QuantizeVec3Tracks(clip->scale_tracks, clip->scales,
+                       &clip->quantized_scales);
+    clip->quantized_rotations.resize(clip->rotations.size() * 4);
+    for (size_t k = 0; k < clip->rotations.size(); k++) {
+      for (size_t c = 0; c < 4; c++) {
+        clip->quantized_rotations[k * 4 + c] =
+            QuantizeSnorm16(clip->rotations[k][c]);
+      }
+    }
+
+    clip->quantized = true;
+    std::vector<vec3>().swap(clip->translations);
+    std::vector<quat>().swap(clip->rotations);
+    std::vector<vec3>().swap(clip->scales);
+  }
+
+  return true;
+}
+
+void CollectNodeTrackSources(const Node &node,
+                             std::vector<TrackSource> *sources) {
+  if (!node.node_animations.empty()) {
+    TrackSource src;
+    src.target = node.abs_path;
+    for (const auto &ch : node.node_animations) {
+      switch (ch.type) {
+        case AnimationChannel::ChannelType::Translation:
+          if (HasValue(ch.translations)) {
+            src.translations = &ch.translations;
+          }
+          break;
+        case AnimationChannel::ChannelType::Rotation:
+          if (HasValue(ch.rotations)) {
+            src.rotations = &ch.rotations;
+          }
+          break;
+        case AnimationChannel::ChannelType::Scale:
+          if (HasValue(ch.scales)) {
+            src.scales = &ch.scales;
+          }
+          break;
+        case AnimationChannel::ChannelType::Transform:
+        case AnimationChannel::ChannelType::Weight:
+          break;
+      }
+    }
+    if (src.translations || src.rotations || src.scales) {
+      sources->push_back(src);
+    }
+  }
+
+  for (const auto &child : node.children) {
+    CollectNodeTrackSources(child, sources);
+  }
+}
+
+//
+// Key access(float or quantized)
+//
+inline vec3 GetVec3Key(const AnimationClipTrack &track, uint32_t k,
+                       const std::vector<vec3> &values,
+                       const std::vector<uint16_t> &qvalues, bool quantized) {
+  if (!quantized) {
+    return values[track.offset + k];
+  }
+  const uint16_t *q = &qvalues[(track.offset + k) * 3];
+  constexpr float kInv = 1.0f / 65535.0f;
+  return {track.range_min[0] + float(q[0]) * kInv * track.range_extent[0],
+          track.range_min[1] + float(q[1]) * kInv * track.range_extent[1],
+          track.range_min[2] + float(q[2]) * kInv * track.range_extent[2]};
+}
+
+inline quat GetQuatKey(const AnimationClipTrack &track, uint32_t k,
+                       const AnimationClip &clip) {
+  if (!clip.quantized) {
+    return clip.rotations[track.offset + k];
+  }
+  const int16_t *q = &clip.quantized_rotations[(track.offset + k) * 4];
+  constexpr float kInv = 1.0f / 32767.0f;
+  return Normalize({float(q[0]) * kInv, float(q[1]) * kInv, float(q[2]) * kInv,
+                    float(q[3]) * kInv});
+}
+
+// Find the key segment for frame position `f`.
+// Returns key index `k0` and interpolation factor between k0 and k0 + 1.
+inline uint32_t FindKey(const AnimationClipTrack &track,
+                        const std::vector<uint32_t> &frames, double f,
+                        float *factor) {
+  (*factor) = 0.0f;
+  const uint32_t *begin = frames.data() + track.offset;
+  const uint32_t *end = begin + track.count;
+
+  if ((track.count == 1) || (f <= double(begin[0]))) {
+    return 0;
+  }
+  if (f >= double(end[-1])) {
+    return track.count - 1;
+  }
+
+  const uint32_t *it = std::upper_bound(
+      begin, end, f, [](double v, uint32_t frame) { return v < double(frame); });
+  uint32_t k0 = uint32_t(it - begin) - 1;
+  double f0 = double(begin[k0]);
+  double f1 = double(begin[k0 + 1]);
+  (*factor) = float((f - f0) / (f1 - f0));
+  return k0;
+}
+
+}  // namespace
+
+bool EvaluateAnimationSampler(const AnimationSampler<float> &sampler, double t,
+                              float *dst) {
+  return EvaluateSampler(sampler, t, dst);
+}
+
+bool EvaluateAnimationSampler(const AnimationSampler<vec3> &sampler, double t,
+                              vec3 *dst) {
+  return EvaluateSampler(sampler, t, dst);
+}
+
+bool EvaluateAnimationSampler(const AnimationSampler<quat> &sampler, double t,
+                              quat *dst) {
+  return EvaluateSampler(sampler, t, dst);
+}
+
+size_t AnimationClip::memory_usage() const {
+  size_t sz = 0;
+  sz += (translation_tracks.size() + rotation_tracks.size() +
+         scale_tracks.size()) *
+        sizeof(AnimationClipTrack);
+  sz += (translation_frames.size() + rotation_frames.size() +
+         scale_frames.size()) *
+        sizeof(uint32_t);
+  sz += translations.size() * sizeof(vec3);
+  sz += rotations.size() * sizeof(quat);
+  sz += scales.size() * sizeof(vec3);
+  sz += quantized_translations.size() * sizeof(uint16_t);
+  sz += quantized_rotations.size() * sizeof(int16_t);
+  sz += quantized_scales.size() * sizeof(uint16_t);
+  return sz;
+}
+
+bool BakeAnimationClip(const RenderScene &scene, size_t anim_id,
+                       AnimationClip *clip, std::string *err,
+                       const AnimationClipBakeConfig &config) {
+  if (!clip) {
+    PUSH_ERROR_AND_RETURN("`clip` is nullptr.");
+  }
+
+  if (anim_id >= scene.animations.size()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("anim_id {} is out-of-range. animations.size {}", anim_id, scene.animations.size()));
+  }
+
+  const Animation &anim = scene.animations[anim_id];
+
+  std::vector<TrackSource> sources;
+  for (const auto &it : anim.channels_map) {
+    TrackSource src;
+    src.target = it.first;
+    for (const auto &cit : it.second) {
+      const AnimationChannel &ch = cit.second;
+      switch (cit.first) {
+        case AnimationChannel::ChannelType::Translation:
+          if (HasValue(ch.translations)) {
+            src.translations = &ch.translations;
+          }
+          break;
+        case AnimationChannel::ChannelType::Rotation:
+          if (HasValue(ch.rotations)) {
+            src.rotations = &ch.rotations;
+          }
+          break;
+        case AnimationChannel::ChannelType::Scale:
+          if (HasValue(ch.scales)) {
+            src.scales = &ch.scales;
+          }
+          break;
+        case AnimationChannel::ChannelType::Transform:
+        case AnimationChannel::ChannelType::Weight:
+          break;
+      }
+    }
+    sources.push_back(src);
+  }
+
+  clip->prim_name = anim.prim_name;
+  clip->abs_path = anim.abs_path;
+
+  return BakeClip(sources, scene, config, clip, err);
+}
+
+bool BakeNodeAnimationClip(const RenderScene &scene, AnimationClip *clip,
+                           std::string *err,
+                           const AnimationClipBakeConfig &config) {
+  if (!clip) {
+    PUSH_ERROR_AND_RETURN("`clip` is nullptr.");
+  }
+
+  std::vector<TrackSource> sources;
+  for (const auto &node : scene.nodes) {
+    CollectNodeTrackSources(node, &sources);
+  }
+
+  clip->prim_name.clear();
+  clip->abs_path.clear();
+
+  return BakeClip(sources, scene, config, clip, err);
+}
+
+void SampleAnimationClip(const AnimationClip &clip, double t,
+                         AnimationClipPose *pose) {
+  if (!pose) {
+    return;
+  }
+
+  const size_t n = clip.targets.size();
+  pose->translations.assign(n, {0.0f, 0.0f, 0.0f});
+  pose->rotations.assign(n, {0.0f, 0.0f, 0.0f, 1.0f});
+  pose->scales.assign(n, {1.0f, 1.0f, 1.0f});
+  pose->channels.assign(n, 0);
+
+  double f = 0.0;
+  if ((clip.num_frames > 1) && (clip.time_codes_per_frame > 0.0)) {
+    f = (t - clip.start_time) / clip.time_codes_per_frame;
+    f = (std::min)(double(clip.num_frames - 1), (std::max)(0.0, f));
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (i < clip.translation_tracks.size()) {
+      const AnimationClipTrack &track = clip.translation_tracks[i];
+      if (track.count) {
+        float factor;
+        uint32_t k = FindKey(track, clip.translation_frames, f, &factor);
+        vec3 v0 = GetVec3Key(track, k, clip.translations,
+                             clip.quantized_translations, clip.quantized);
+        if (factor > 0.0f) {
+          vec3 v1 = GetVec3Key(track, k + 1, clip.translations,
+                               clip.quantized_translations, clip.quantized);
+          v0 = Interpolate(v0, v1, factor);
+        }
+        pose->translations[i] = v0;
+        pose->channels[i] |= AnimationClipPose::kTranslation;
+      }
+    }
+
+    if (i < clip.rotation_tracks.size()) {
+      const AnimationClipTrack &track = clip.rotation_tracks[i];
+      if (track.count) {
+        float factor;
+        uint32_t k = FindKey(track, clip.rotation_frames, f, &factor);
+        quat q0 = GetQuatKey(track, k, clip);
+        if (factor > 0.0f) {
+          quat q1 = GetQuatKey(track, k + 1, clip);
+          q0 = Interpolate(q0, q1, factor);
+        }
+        pose->rotations[i] = q0;
+        pose->channels[i] |= AnimationClipPose::kRotation;
+      }
+    }
+
+    if (i < clip.scale_tracks.size()) {
+      const AnimationClipTrack &track = clip.scale_tracks[i];
+      if (track.count) {
+        float factor;
+        uint32_t k = FindKey(track, clip.scale_frames, f, &factor);
+        vec3 v0 = GetVec3Key(track, k, clip.scales, clip.quantized_scales,
+                             clip.quantized);
+        if (factor > 0.0f) {
+          vec3 v1 = GetVec3Key(track, k + 1, clip.scales,
+                               clip.quantized_scales, clip.quantized);
+          v0 = Interpolate(v0, v1, factor);
+        }
+        pose->scales[i] = v0;
+        pose->channels[i] |= AnimationClipPose::kScale;
+      }
+    }
+  }
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
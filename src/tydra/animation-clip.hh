@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Animation sampling and fixed-rate animation clip baking.
+//
+// `Animation`(and `Node::node_animations`) in RenderScene stores timesamples
+// per joint and channel(AoS). `AnimationClip` stores resampled keys of all
+// joints(or nodes) in a few contiguous arrays(SoA), with optional keyframe
+// reduction and quantization, for cache-friendly playback.
+//
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "render-data.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+///
+/// Evaluate AnimationSampler at time code `t`.
+///
+/// Values are clamped outside of the sample range. Rotations are interpolated
+/// with slerp(shortest path). `value::TimeCode::Default()` = use static value
+/// (the first sample when no static value is authored).
+///
+/// @return false when the sampler has no value.
+///
+bool EvaluateAnimationSampler(const AnimationSampler<float> &sampler, double t,
+                              float *dst);
+bool EvaluateAnimationSampler(const AnimationSampler<vec3> &sampler, double t,
+                              vec3 *dst);
+bool EvaluateAnimationSampler(const AnimationSampler<quat> &sampler, double t,
+                              quat *dst);
+
+struct AnimationClipBakeConfig {
+  // Sampling rate in frames per second. 0 = use
+  // `RenderScene::meta.framesPerSecond`.
+  double frames_per_second{0.0};
+
+  // Time range to bake in time codes. NaN = use the range of timesamples.
+  double start_time{std::numeric_limits<double>::quiet_NaN()};
+  double end_time{std::numeric_limits<double>::quiet_NaN()};
+
+  // Remove keys which can be reconstructed by interpolating neighboring keys
+  // within the tolerance.
+  bool reduce_keyframes{true};
+  float translation_tolerance{1e-4f};  // distance
+  float rotation_tolerance{1e-4f};     // angle in radians
+  float scale_tolerance{1e-4f};        // per component
+
+  // Quantize keys(16bit per component). Float key arrays are cleared.
+  // Translations and scales are quantized in the value range of each track,
+  // rotations as signed normalized int16.
+  bool quantize{false};
+
+  // # of threads. -1 = use all hardware threads.
+  int num_threads{-1};
+};
+
+///
+/// Keys of single channel of single target, stored in
+/// `AnimationClip::xxx_frames` and `AnimationClip::xxx` arrays(or quantized
+/// arrays) at [offset, offset + count).
+///
+struct AnimationClipTrack {
+  uint32_t offset{0};
+  uint32_t count{0};  // 0 = not animated.
+
+  // Dequantization of translations/scales: value = range_min + q / 65535 *
+  // range_extent
+  vec3 range_min{0.0f, 0.0f, 0.0f};
+  vec3 range_extent{0.0f, 0.0f, 0.0f};
+};
+
+struct AnimationClip {
+  std::string prim_name;  // Source SkelAnimation Prim name(empty for node animation)
+  std::string abs_path;   // Source SkelAnimation Prim path(empty for node animation)
+
+  double frames_per_second{24.0};
+  double start_time{0.0};             // time code of frame 0
+  double time_codes_per_frame{1.0};
+  uint32_t num_frames{0};
+
+  // Joint paths(SkelAnimation) or absolute Prim paths of Nodes.
+  std::vector<std::string> targets;
+
+  // Tracks. size = targets.size()
+  std::vector<AnimationClipTrack> translation_tracks;
+  std::vector<AnimationClipTrack> rotation_tracks;
+  std::vector<AnimationClipTrack> scale_tracks;
+
+  // Frame index of each key(ascending in a track).
+  std::vector<uint32_t> translation_frames;
+  std::vector<uint32_t> rotation_frames;
+  std::vector<uint32_t> scale_frames;
+
+  // Key values(empty when quantized)
+  std::vector<vec3> translations;
+  std::vector<quat> rotations;
+  std::vector<vec3> scales;
+
+  bool quantized{false};
+  std::vector<uint16_t> quantized_translations;  // 3 per key
+  std::vector<int16_t> quantized_rotations;      // 4 per key
+  std::vector<uint16_t> quantized_scales;        // 3 per key
+
+  double duration() const {
+    return (num_frames > 1) ? double(num_frames - 1) * time_codes_per_frame
+                            : 0.0;
+  }
+
+  // # of bytes of track and key arrays.
+  size_t memory_usage() const;
+};
+
+///
+/// Bake `scene.animations[anim_id]`(SkelAnimation) to AnimationClip.
+/// Blendshape weights are not baked.
+///
+bool BakeAnimationClip(const RenderScene &scene, size_t anim_id,
+                       AnimationClip *clip, std::string *err,
+                       const AnimationClipBakeConfig &config =
+                           AnimationClipBakeConfig());
+
+///
+/// Bake xform animations of Nodes(`Node::node_animations`) in
+/// `scene.nodes` to AnimationClip. `Transform`(matrix) channels are not
+/// supported and ignored.
+///
+bool BakeNodeAnimationClip(const RenderScene &scene, AnimationClip *clip,
+                           std::string *err,
+                           const AnimationClipBakeConfig &config =
+                               AnimationClipBakeConfig());
+
+///
+/// Pose of all targets of AnimationClip.
+///
+struct AnimationClipPose {
+  enum ChannelBit : uint8_t {
+    kTranslation = 1,
+    kRotation = 2,
+    kScale = 4,
+  };
+
+  std::vector<vec3> translations;
+  std::vector<quat> rotations;
+  std::vector<vec3> scales;
+  std::vector<uint8_t> channels;  // ChannelBit mask of animated channels.
+};
+
+///
+/// Sample all tracks of AnimationClip at time code `t`(clamped to the clip
+/// range). Channels not animated are set to identity(zero translation, unit
+/// rotation and scale).
+///
+void SampleAnimationClip(const AnimationClip &clip, double t,
+                         AnimationClipPose *pose);
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -144,8 +144,7 @@ bool EvaluateTypedAnimatableAttribute(
     return false;
   } else if (tattr.has_value()) {
     const Animatable<T> &value = tattr.get_value();
-    T v;
-    if (value.get(t, &v, tinterp)) {
+    if (value.get(t, value_out, tinterp)) {
       return true;
     } else {
       if (err) {
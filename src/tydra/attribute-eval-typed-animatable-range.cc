@@ -0,0 +1,441 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024-Present Light Transport Entertainment, Inc.
+//
+// Evaluate TypedAttribute at multiple time codes.
+//
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "attribute-eval.hh"
+#include "scene-access.hh"
+
+#include "common-macros.inc"
+#include "parallel-for.hh"
+#include "tiny-format.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+// For PUSH_ERROR_AND_RETURN
+#define PushError(msg) \
+  if (err) {           \
+    (*err) +=  msg;     \
+  }
+
+namespace {
+
+// Moving cursor over sorted timeSamples.
+struct SampleCursor {
+  size_t index{0};
+  double t{-std::numeric_limits<double>::infinity()};
+};
+
+// Returns the index of the first sample whose time is > t(`upper` = true, same
+// as std::upper_bound) or >= t(`upper` = false, same as std::lower_bound).
+// The cursor moves forward while time codes are increasing, and falls back to
+// binary search when time goes backward.
+template <typename S>
+size_t SeekSample(const std::vector<S> &samples, const double t,
+                  const bool upper, SampleCursor *cursor) {
+  if (t < cursor->t) {
+    if (upper) {
+      cursor->index = size_t(std::distance(
+          samples.begin(),
+          std::upper_bound(
+              samples.begin(), samples.end(), t,
+              [](double tval, const S &a) { return tval < a.t; })));
+    } else {
+      cursor->index = size_t(std::distance(
+          samples.begin(),
+          std::lower_bound(
+              samples.begin(), samples.end(), t,
+              [](const S &a, double tval) { return a.t < tval; })));
+    }
+  } else {
+    while ((cursor->index < samples.size()) &&
+           (upper ? (samples[cursor->index].t <= t)
+                  : (samples[cursor->index].t < t))) {
+      cursor->index++;
+    }
+  }
+
+  cursor->t = t;
+  return cursor->index;
+}
+
+// Held = nearest preceding sample. Same as `TypedTimeSamples::get`.
+template <typename T>
+void SampleTimeSamplesHeld(const TypedTimeSamples<T> &ts, const T *default_value,
+                           const std::vector<double> &times, T *values) {
+  const auto &samples = ts.get_samples();
+
+  SampleCursor cursor;
+  for (size_t i = 0; i < times.size(); i++) {
+    const double t = times[i];
+    if (value::TimeCode(t).is_default()) {
+      values[i] = default_value ? (*default_value) : samples[0].value;
+      continue;
+    }
+
+    size_t idx = SeekSample(samples, t, /* upper */ true, &cursor);
+    values[i] = samples[(idx == 0) ? 0 : (idx - 1)].value;
+  }
+}
+
+template <typename T, std::enable_if_t<!value::LerpTraits<T>::supported(),
+                                       std::nullptr_t> = nullptr>
+void SampleTimeSamples(const TypedTimeSamples<T> &ts, const T *default_value,
+                       const std::vector<double> &times, T *values,
+                       const value::TimeSampleInterpolationType tinterp) {
+  (void)tinterp;
+  SampleTimeSamplesHeld(ts, default_value, times, values);
+}
+
+// Linear interpolation. Same as `TypedTimeSamples::get`.
+template <typename T, std::enable_if_t<value::LerpTraits<T>::supported(),
+                                       std::nullptr_t> = nullptr>
+void SampleTimeSamples(const TypedTimeSamples<T> &ts, const T *default_value,
+                       const std::vector<double> &times, T *values,
+                       const value::TimeSampleInterpolationType tinterp) {
+  if (tinterp == value::TimeSampleInterpolationType::Held) {
+    SampleTimeSamplesHeld(ts, default_value, times, values);
+    return;
+  }
+
+  const auto &samples = ts.get_samples();
+  const size_t n = samples.size();
+
+  SampleCursor cursor;
+  for (size_t i = 0; i < times.size(); i++) {
+    const double t = times[i];
+    if (value::TimeCode(t).is_default()) {
+      values[i] = default_value ? (*default_value) : samples[0].value;
+      continue;
+    }
+
+    if (n == 1) {
+      values[i] = samples[0].value;
+      continue;
+    }
+
+    size_t idx = SeekSample(samples, t, /* upper */ false, &cursor);
+
+    size_t idx0 = (idx == 0) ? 0 : (idx - 1);
+    size_t idx1 = (std::min)(n - 1, idx0 + 1);
+
+    double tl = samples[idx0].t;
+    double tu = samples[idx1].t;
+
+    double dt = (t - tl);
+    if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
+      // slope is zero.
+      dt = 0.0;
+    } else {
+      dt /= (tu - tl);
+    }
+
+    dt = (std::max)(0.0, (std::min)(1.0, dt));
+
+    values[i] = lerp(samples[idx0].value, samples[idx1].value, dt);
+  }
+}
+
+// Same as `Animatable::get` for each time code.
+template <typename T>
+bool SampleAnimatable(const Animatable<T> &animatable,
+                      const std::vector<double> &times, T *values,
+                      const value::TimeSampleInterpolationType tinterp) {
+  if (animatable.is_blocked()) {
+    return false;
+  }
+
+  const T *default_value = animatable.get_scalar_ptr();
+
+  if (animatable.has_timesamples()) {
+    SampleTimeSamples(animatable.get_timesamples(), default_value, times,
+                      values, tinterp);
+    return true;
+  }
+
+  if (default_value) {
+    std::fill(values, values + times.size(), *default_value);
+    return true;
+  }
+
+  return false;
+}
+
+//
+// Animatable value to evaluate. Refers the value of TypedAttribute, or owns the
+// value of the connection target(terminal) Attribute.
+//
+template <typename T>
+struct AnimatableSource {
+  const Animatable<T> *animatable{nullptr};
+  Animatable<T> connected;
+  bool is_connection{false};
+
+  const Animatable<T> &get() const {
+    return is_connection ? connected : (*animatable);
+  }
+};
+
+// Convert the terminal Attribute to Animatable. Value type is checked here.
+template <typename T>
+bool ToAnimatable(const Attribute &attr, const std::string &attr_name,
+                  Animatable<T> *dst, std::string *err) {
+  if (attr.is_blocked()) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "Value producing attribute of `{}` is None(Value Blocked).",
+        attr_name));
+  }
+
+  const primvar::PrimVar &var = attr.get_var();
+
+  if (var.has_default()) {
+    if (const T *pv = var.value_raw().as<T>()) {
+      dst->set(*pv);
+    } else {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Type mismatch. Value producing attribute has type {}, but "
+          "requested type is {}. Attribute: {}",
+          var.value_raw().type_name(), value::TypeTraits<T>::type_name(),
+          attr_name));
+    }
+  }
+
+  if (var.has_timesamples()) {
+    TypedTimeSamples<T> ts;
+    for (const auto &s : var.ts_raw().get_samples()) {
+      if (s.blocked) {
+        ts.add_blocked_sample(s.t);
+      } else if (const T *pv = s.value.as<T>()) {
+        ts.add_sample(s.t, *pv);
+      } else {
+        PUSH_ERROR_AND_RETURN(fmt::format(
+            "Type mismatch. Value producing attribute has type {}, but "
+            "requested type is {}. Attribute: {}",
+            s.value.type_name(), value::TypeTraits<T>::type_name(),
+            attr_name));
+      }
+    }
+    dst->set(std::move(ts));
+  }
+
+  return true;
+}
+
+template <typename T>
+bool ResolveConnection(const Stage &stage, const std::vector<Path> &paths,
+                       const std::string &attr_name, AnimatableSource<T> *src,
+                       std::string *err) {
+  Attribute input;
+  input.set_connections(paths);
+
+  Attribute terminal;
+  if (!GetTerminalAttribute(stage, input, attr_name, &terminal, err)) {
+    return false;
+  }
+
+  if (!ToAnimatable(terminal, attr_name, &src->connected, err)) {
+    return false;
+  }
+
+  src->is_connection = true;
+  return true;
+}
+
+// Eval order is same as `EvaluateTypedAnimatableAttribute`.
+template <typename T>
+bool ResolveAnimatable(const Stage &stage,
+                       const TypedAttribute<Animatable<T>> &tattr,
+                       const std::string &attr_name, AnimatableSource<T> *src,
+                       std::string *err) {
+  if (tattr.is_blocked()) {
+    PUSH_ERROR_AND_RETURN("Attribute is Blocked.\n");
+  } else if (tattr.has_value()) {
+    src->animatable = tattr.get_value_ptr();
+    return true;
+  } else if (tattr.has_connections()) {
+    return ResolveConnection(stage, tattr.connections(), attr_name, src, err);
+  } else if (tattr.is_value_empty()) {
+    PUSH_ERROR_AND_RETURN("Attribute value is empty.\n");
+  }
+
+  PUSH_ERROR_AND_RETURN(fmt::format(
+      "[Internal error] Invalid TypedAttribute? : {} \n", attr_name));
+}
+
+template <typename T>
+bool ResolveAnimatable(const Stage &stage,
+                       const TypedAttributeWithFallback<Animatable<T>> &tattr,
+                       const std::string &attr_name, AnimatableSource<T> *src,
+                       std::string *err) {
+  if (tattr.is_blocked()) {
+    PUSH_ERROR_AND_RETURN("Attribute is Blocked.\n");
+  } else if (tattr.has_value()) {
+    src->animatable = &tattr.get_value();
+    return true;
+  } else if (tattr.is_value_empty()) {
+    PUSH_ERROR_AND_RETURN("Attribute value is empty.\n");
+  } else if (tattr.has_connections()) {
+    return ResolveConnection(stage, tattr.connections(), attr_name, src, err);
+  }
+
+  PUSH_ERROR_AND_RETURN(fmt::format(
+      "Unsupported/Invalid TypedAnimatableAttribute value: {}", attr_name));
+}
+
+template <typename T, typename A>
+bool EvaluateAnimatableAttributeImpl(
+    const Stage &stage, const A &tattr, const std::string &attr_name,
+    const std::vector<double> &times, T *values, std::string *err,
+    const value::TimeSampleInterpolationType tinterp) {
+  if (!values && !times.empty()) {
+    PUSH_ERROR_AND_RETURN("`values` param is nullptr.");
+  }
+
+  AnimatableSource<T> src;
+  if (!ResolveAnimatable(stage, tattr, attr_name, &src, err)) {
+    return false;
+  }
+
+  if (!SampleAnimatable(src.get(), times, values, tinterp)) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "Failed to get TypedAnimatableAttribute value: {} \n", attr_name));
+  }
+
+  return true;
+}
+
+template <typename T, typename A>
+bool EvaluateAnimatableAttributesImpl(
+    const Stage &stage, const std::vector<const A *> &attrs,
+    const std::vector<std::string> &attr_names,
+    const std::vector<double> &times, T *values, std::string *err,
+    const value::TimeSampleInterpolationType tinterp, const int num_threads) {
+  if (!values && !attrs.empty() && !times.empty()) {
+    PUSH_ERROR_AND_RETURN("`values` param is nullptr.");
+  }
+
+  if (!attr_names.empty() && (attr_names.size() != attrs.size())) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "`attr_names` must be empty or have the same size with `attrs`. {} "
+        "vs {}",
+        attr_names.size(), attrs.size()));
+  }
+
+  const std::string empty_name;
+  auto name_of = [&](size_t i) -> const std::string & {
+    return attr_names.empty() ? empty_name : attr_names[i];
+  };
+
+  std::vector<AnimatableSource<T>> sources(attrs.size());
+  std::vector<std::string> errs(attrs.size());
+  std::vector<uint8_t> results(attrs.size(), 0);
+
+  // Resolve connections sequentially, since Prim lookup in Stage is not
+  // thread-safe. `TypedTimeSamples` sorts its samples lazily, so do it here as
+  // well.
+  for (size_t i = 0; i < attrs.size(); i++) {
+    if (!attrs[i]) {
+      errs[i] = "nullptr Attribute.";
+      continue;
+    }
+
+    if (ResolveAnimatable(stage, *attrs[i], name_of(i), &sources[i],
+                          &errs[i])) {
+      sources[i].get().get_timesamples().get_samples();
+      results[i] = 1;
+    }
+  }
+
+  parallel::ParallelFor(
+      attrs.size(),
+      [&](size_t i, int thread_id) {
+        (void)thread_id;
+        if (!results[i]) {
+          return;
+        }
+
+        if (!SampleAnimatable(sources[i].get(), times,
+                              values + i * times.size(), tinterp)) {
+          errs[i] = fmt::format(
+              "Failed to get TypedAnimatableAttribute value: {} \n",
+              name_of(i));
+          results[i] = 0;
+        }
+      },
+      num_threads, 1);
+
+  bool ok = true;
+  for (size_t i = 0; i < attrs.size(); i++) {
+    if (!results[i]) {
+      PushError(fmt::format("Failed to evaluate attrs[{}] `{}`: {}", i,
+                            name_of(i), errs[i]));
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+}  // namespace
+
+template <typename T>
+bool EvaluateTypedAnimatableAttribute(
+    const tinyusdz::Stage &stage, const TypedAttribute<Animatable<T>> &tattr,
+    const std::string &attr_name, const std::vector<double> &times,
+    T *values, std::string *err,
+    const value::TimeSampleInterpolationType tinterp) {
+  return EvaluateAnimatableAttributeImpl(stage, tattr, attr_name, times,
+                                         values, err, tinterp);
+}
+
+template <typename T>
+bool EvaluateTypedAnimatableAttribute(
+    const tinyusdz::Stage &stage,
+    const TypedAttributeWithFallback<Animatable<T>> &tattr,
+    const std::string &attr_name, const std::vector<double> &times,
+    T *values, std::string *err,
+    const value::TimeSampleInterpolationType tinterp) {
+  return EvaluateAnimatableAttributeImpl(stage, tattr, attr_name, times,
+                                         values, err, tinterp);
+}
+
+template <typename T>
+bool EvaluateTypedAnimatableAttributes(
+    const tinyusdz::Stage &stage,
+    const std::vector<const TypedAttribute<Animatable<T>> *> &attrs,
+    const std::vector<std::string> &attr_names,
+    const std::vector<double> &times, T *values, std::string *err,
+    const value::TimeSampleInterpolationType tinterp, const int num_threads) {
+  return EvaluateAnimatableAttributesImpl(stage, attrs, attr_names, times,
+                                          values, err, tinterp, num_threads);
+}
+
+template <typename T>
+bool EvaluateTypedAnimatableAttributes(
+    const tinyusdz::Stage &stage,
+    const std::vector<const TypedAttributeWithFallback<Animatable<T>> *> &attrs,
+    const std::vector<std::string> &attr_names,
+    const std::vector<double> &times, T *values, std::string *err,
+    const value::TimeSampleInterpolationType tinterp, const int num_threads) {
+  return EvaluateAnimatableAttributesImpl(stage, attrs, attr_names, times,
+                                          values, err, tinterp, num_threads);
+}
+
+// template instanciations
+#define EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE(__ty) \
+template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttribute<Animatable<__ty>> &attr, const std::string &attr_name, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp); \
+template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttributeWithFallback<Animatable<__ty>> &attr, const std::string &attr_name, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp); \
+template bool EvaluateTypedAnimatableAttributes(const tinyusdz::Stage &stage, const std::vector<const TypedAttribute<Animatable<__ty>> *> &attrs, const std::vector<std::string> &attr_names, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp, const int num_threads); \
+template bool EvaluateTypedAnimatableAttributes(const tinyusdz::Stage &stage, const std::vector<const TypedAttributeWithFallback<Animatable<__ty>> *> &attrs, const std::vector<std::string> &attr_names, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp, const int num_threads);
+
+APPLY_FUNC_TO_VALUE_TYPES_NO_STRING(EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE)
+
+#undef EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE
+
+}  // namespace tydra
+}  // namespace tinyusdz
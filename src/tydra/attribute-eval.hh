@@ -9,6 +9,8 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include "prim-types.hh"
 #include "stage.hh"
@@ -254,5 +256,104 @@ template<> bool EvaluateTypedAnimatableAttribute(
 
 #undef EXTERN_EVALUATE_TYPED_ATTRIBUTE
 
+//
+// Batch(time range) version
+//
+
+///
+/// Evaluate TypedAttribute at multiple time codes in one call.
+///
+/// Gives the same result as calling `EvaluateTypedAnimatableAttribute` for
+/// each time code, but the connection is resolved and the value type is
+/// checked only once, and timeSamples are walked with a moving cursor instead
+/// of a binary search at each time code(fast path when `times` is sorted in
+/// ascending order. Unsorted `times` are also accepted).
+///
+/// @param[in] stage Stage
+/// @param[in] attr Attribute
+/// @param[in] attr_name Attribute name. This is only used in error message, so it can be empty.
+/// @param[in] times Time codes.
+/// @param[out] values Caller-provided buffer with `times.size()` elements.
+/// @param[out] err Error message(filled when false returned). Set nullptr if you don't need error message.
+/// @param[in] tinterp (optional) Interpolation type for timeSamples value
+///
+/// NOTE: std::string is not supported.
+///
+template<typename T>
+bool EvaluateTypedAnimatableAttribute(
+    const tinyusdz::Stage &stage,
+    const TypedAttribute<Animatable<T>> &attr,
+    const std::string &attr_name,
+    const std::vector<double> &times,
+    T *values,
+    std::string *err,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear);
+
+template<typename T>
+bool EvaluateTypedAnimatableAttribute(
+    const tinyusdz::Stage &stage,
+    const TypedAttributeWithFallback<Animatable<T>> &attr,
+    const std::string &attr_name,
+    const std::vector<double> &times,
+    T *values,
+    std::string *err,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear);
+
+///
+/// Evaluate a set of TypedAttributes at multiple time codes in one call.
+///
+/// Connections are resolved sequentially, then attributes are evaluated in
+/// parallel(each attribute is evaluated in single thread).
+///
+/// @param[in] stage Stage
+/// @param[in] attrs Attributes
+/// @param[in] attr_names Attribute names for error message. Can be empty.
+/// @param[in] times Time codes.
+/// @param[out] values Caller-provided buffer with `attrs.size() * times.size()`
+/// elements. Values of `attrs[i]` are stored to `values[i * times.size() + j]`.
+/// @param[out] err Error message(filled when false returned). Set nullptr if you don't need error message.
+/// @param[in] tinterp (optional) Interpolation type for timeSamples value
+/// @param[in] num_threads (optional) # of threads. -1 = use all hardware
+/// threads.
+///
+/// @return false when any of the attributes failed to evaluate. Values of
+/// the succeeded attributes are still written.
+///
+template<typename T>
+bool EvaluateTypedAnimatableAttributes(
+    const tinyusdz::Stage &stage,
+    const std::vector<const TypedAttribute<Animatable<T>> *> &attrs,
+    const std::vector<std::string> &attr_names,
+    const std::vector<double> &times,
+    T *values,
+    std::string *err,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear,
+    const int num_threads = -1);
+
+template<typename T>
+bool EvaluateTypedAnimatableAttributes(
+    const tinyusdz::Stage &stage,
+    const std::vector<const TypedAttributeWithFallback<Animatable<T>> *> &attrs,
+    const std::vector<std::string> &attr_names,
+    const std::vector<double> &times,
+    T *values,
+    std::string *err,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear,
+    const int num_threads = -1);
+
+#define EXTERN_EVALUATE_TYPED_ATTRIBUTE(__ty) \
+extern template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttribute<Animatable<__ty>> &attr, const std::string &attr_name, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp); \
+extern template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttributeWithFallback<Animatable<__ty>> &attr, const std::string &attr_name, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp); \
+extern template bool EvaluateTypedAnimatableAttributes(const tinyusdz::Stage &stage, const std::vector<const TypedAttribute<Animatable<__ty>> *> &attrs, const std::vector<std::string> &attr_names, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp, const int num_threads); \
+extern template bool EvaluateTypedAnimatableAttributes(const tinyusdz::Stage &stage, const std::vector<const TypedAttributeWithFallback<Animatable<__ty>> *> &attrs, const std::vector<std::string> &attr_names, const std::vector<double> &times, __ty *values, std::string *err, const value::TimeSampleInterpolationType tinterp, const int num_threads);
+
+APPLY_FUNC_TO_VALUE_TYPES_NO_STRING(EXTERN_EVALUATE_TYPED_ATTRIBUTE)
+
+#undef EXTERN_EVALUATE_TYPED_ATTRIBUTE
+
 }  // namespace tydra
 }  // namespace tinyusdz
@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// BlendShape(UsdSkel) evaluation of RenderMesh
+//
+#include "blendshape.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TINYUSDZ_BLENDSHAPE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "animation-clip.hh"
+#include "common-macros.inc"
+#include "parallel-for.hh"
+#include "tiny-format.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+#define PushError(msg) \
+  {                    \
+    if (err) {         \
+      (*err) += msg;   \
+    }                  \
+  }
+
+// Offsets of the ShapeTarget at given weight = coeffs[0] * offsets[0] +
+// coeffs[1] * offsets[1]. nullptr offsets = zero(rest shape).
+struct ShapeTerm {
+  const std::vector<vec3> *point_offsets[2]{nullptr, nullptr};
+  const std::vector<vec3> *normal_offsets[2]{nullptr, nullptr};
+  float coeffs[2]{0.0f, 0.0f};
+};
+
+ShapeTerm EvaluateShapeTerm(const ShapeTarget &target, float weight) {
+  struct Shape {
+    float weight;
+    const std::vector<vec3> *point_offsets;
+    const std::vector<vec3> *normal_offsets;
+  };
+
+  const size_t n = target.pointOffsets.size();
+
+  std::vector<Shape> shapes;
+  shapes.push_back({0.0f, nullptr, nullptr});
+  shapes.push_back({1.0f, &target.pointOffsets, &target.normalOffsets});
+  for (const auto &it : target.inbetweens) {
+    const InbetweenShapeTarget &ib = it.second;
+    // In-between at weight 0 or 1 is invalid in UsdSkel.
+    if ((ib.weight == 0.0f) || (ib.weight == 1.0f) ||
+        !std::isfinite(ib.weight)) {
+      continue;
+    }
+    if (ib.pointOffsets.size() != n) {
+      continue;
+    }
+    shapes.push_back({ib.weight, &ib.pointOffsets, &ib.normalOffsets});
+  }
+
+  ShapeTerm term;
+
+  if (shapes.size() == 2) {
+    term.point_offsets[0] = &target.pointOffsets;
+    term.normal_offsets[0] = &target.normalOffsets;
+    term.coeffs[0] = weight;
+    return term;
+  }
+
+  std::sort(shapes.begin(), shapes.end(),
+            [](const Shape &a, const Shape &b) { return a.weight < b.weight; });
+
+  // Find the segment. Extrapolate with the outermost segment.
+  size_t k = 0;
+  while ((k + 2 < shapes.size()) && (weight >= shapes[k + 1].weight)) {
+    k++;
+  }
+
+  const Shape &s0 = shapes[k];
+  const Shape &s1 = shapes[k + 1];
+  float f = (weight - s0.weight) / (s1.weight - s0.weight);
+
+  term.point_offsets[0] = s0.point_offsets;
+  term.point_offsets[1] = s1.point_offsets;
+  term.normal_offsets[0] = s0.normal_offsets;
+  term.normal_offsets[1] = s1.normal_offsets;
+  term.coeffs[0] = 1.0f - f;
+  term.coeffs[1] = f;
+
+  return term;
+}
+
+//
+// acc[4 * indices[i]] += coeff * offsets[i]
+//
+// `acc` has 4 floats per point(4th element is padding) so that single
+// point can be accumulated with 4-wide SIMD.
+//
+void ScatterAccumulate(const uint32_t *indices, const vec3 *offsets, size_t n,
+                       float coeff, float *acc) {
+  if (n == 0) {
+    return;
+  }
+
+#if defined(TINYUSDZ_BLENDSHAPE_USE_SSE2)
+  const __m128 c = _mm_set1_ps(coeff);
+  // Load 4 floats from `offsets[i]`. The 4th element(x of `offsets[i+1]`) goes
+  // to the padding element of `acc`. The last element is loaded separately to
+  // avoid reading past the end.
+  for (size_t i = 0; i + 1 < n; i++) {
+    float *dst = acc + 4 * (indices ? size_t(indices[i]) : i);
+    __m128 o = _mm_loadu_ps(&offsets[i][0]);
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(c, o)));
+  }
+  {
+    size_t i = n - 1;
+    float *dst = acc + 4 * (indices ? size_t(indices[i]) : i);
+    __m128 o = _mm_set_ps(0.0f, offsets[i][2], offsets[i][1], offsets[i][0]);
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(c, o)));
+  }
+#else
+  for (size_t i = 0; i < n; i++) {
+    float *dst = acc + 4 * (indices ? size_t(indices[i]) : i);
+    dst[0] += coeff * offsets[i][0];
+    dst[1] += coeff * offsets[i][1];
+    dst[2] += coeff * offsets[i][2];
+  }
+#endif
+}
+
+}  // namespace
+
+void GetBlendShapeWeights(const RenderMesh &mesh, const Animation *anim,
+                          double t, std::vector<float> *weights) {
+  if (!weights) {
+    return;
+  }
+
+  weights->assign(mesh.targets.size(), 0.0f);
+  if (!anim) {
+    return;
+  }
+
+  size_t i = 0;
+  for (const auto &it : mesh.targets) {
+    auto wit = anim->blendshape_weights_map.find(it.first);
+    if (wit != anim->blendshape_weights_map.end()) {
+      EvaluateAnimationSampler(wit->second, t, &(*weights)[i]);
+    }
+    i++;
+  }
+}
+
+void EvaluateShapeTarget(const ShapeTarget &target, float weight,
+                         std::vector<vec3> *offsets) {
+  if (!offsets) {
+    return;
+  }
+
+  const size_t n = target.pointOffsets.size();
+  offsets->assign(n, {0.0f, 0.0f, 0.0f});
+
+  ShapeTerm term = EvaluateShapeTerm(target, weight);
+  for (size_t k = 0; k < 2; k++) {
+    const std::vector<vec3> *src = term.point_offsets[k];
+    if (!src || (term.coeffs[k] == 0.0f)) {
+      continue;
+    }
+    for (size_t i = 0; i < n; i++) {
+      (*offsets)[i][0] += term.coeffs[k] * (*src)[i][0];
+      (*offsets)[i][1] += term.coeffs[k] * (*src)[i][1];
+      (*offsets)[i][2] += term.coeffs[k] * (*src)[i][2];
+    }
+  }
+}
+
+bool ApplyBlendShapes(const RenderMesh &mesh, const std::vector<float> &weights,
+                      std::vector<vec3> *points, std::vector<vec3> *normals,
+                      std::string *err, const BlendShapeConfig &config) {
+  if (!points) {
+    PUSH_ERROR_AND_RETURN("`points` is nullptr.");
+  }
+
+  if (weights.size() != mesh.targets.size()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("weights.size {} must be equal to the number of blendshape targets {}: {}", weights.size(), mesh.targets.size(), mesh.abs_path));
+  }
+
+  const size_t num_points = mesh.points.size();
+
+  //
+  // Collect active targets.
+  //
+  struct ActiveTarget {
+    const ShapeTarget *target;
+    ShapeTerm term;
+  };
+
+  std::vector<ActiveTarget> actives;
+  size_t total_offsets = 0;
+  bool has_normal_offsets{false};
+  {
+    size_t i = 0;
+    for (const auto &it : mesh.targets) {
+      const float w = weights[i++];
+      if (!(std::fabs(w) >= config.weight_epsilon)) {
+        continue;
+      }
+
+      const ShapeTarget &target = it.second;
+      const size_t n = target.pointOffsets.size();
+      if (n == 0) {
+        continue;
+      }
+
+      if (target.pointIndices.empty()) {
+        // Dense target
+        if (n != num_points) {
+          PUSH_ERROR_AND_RETURN(fmt::format("pointOffsets.size {} must be equal to points.size {} when pointIndices is empty. BlendShape: {}", n, num_points, target.abs_path));
+        }
+      } else {
+        if (target.pointIndices.size() != n) {
+          PUSH_ERROR_AND_RETURN(fmt::format("pointOffsets.size {} must be equal to pointIndices.size {}. BlendShape: {}", n, target.pointIndices.size(), target.abs_path));
+        }
+        for (uint32_t idx : target.pointIndices) {
+          if (idx >= num_points) {
+            PUSH_ERROR_AND_RETURN(fmt::format("pointIndices contains out-of-range index {}(points.size {}). BlendShape: {}", idx, num_points, target.abs_path));
+          }
+        }
+      }
+
+      ActiveTarget active;
+      active.target = &target;
+      active.term = EvaluateShapeTerm(target, w);
+      for (size_t k = 0; k < 2; k++) {
+        if (active.term.normal_offsets[k] &&
+            (active.term.normal_offsets[k]->size() == n)) {
+          has_normal_offsets = true;
+        }
+      }
+      actives.push_back(active);
+      total_offsets += n;
+    }
+  }
+
+  const bool do_normals = normals && config.apply_normals &&
+                          has_normal_offsets && !mesh.normals.empty() &&
+                          (mesh.normals.elementSize == 1) &&
+                          (mesh.normals.format == VertexAttributeFormat::Vec3);
+
+  //
+  // Accumulate offsets to per-thread buffers.
+  //
+  int nthreads = (total_offsets > config.parallel_threshold)
+                     ? parallel::GetNumThreads(config.num_threads)
+                     : 1;
+  nthreads = int((std::min)(size_t(nthreads), (std::max)(size_t(1), actives.size())));
+
+  std::vector<std::vector<float>> point_acc(static_cast<size_t>(nthreads));
+  std::vector<std::vector<float>> normal_acc(static_cast<size_t>(nthreads));
+
+  parallel::ParallelForChunked(
+      actives.size(),
+      [&](size_t begin, size_t end, int thread_id) {
+        std::vector<float> &pacc = point_acc[size_t(thread_id)];
+        if (pacc.empty()) {
+          pacc.assign(4 * num_points, 0.0f);
+        }
+
+        for (size_t a = begin; a < end; a++) {
+          const ActiveTarget &active = actives[a];
+          const ShapeTarget &target = *active.target;
+          const size_t n = target.pointOffsets.size();
+          const uint32_t *indices =
+              target.pointIndices.empty() ? nullptr : target.pointIndices.data();
+
+          for (size_t k = 0; k < 2; k++) {
+            const std::vector<vec3> *offsets = active.term.point_offsets[k];
+            if (offsets && (active.term.coeffs[k] != 0.0f)) {
+              ScatterAccumulate(indices, offsets->data(), n,
+                                active.term.coeffs[k], pacc.data());
+            }
+          }
+
+          if (do_normals) {
+            std::vector<float> &nacc = normal_acc[size_t(thread_id)];
+            if (nacc.empty()) {
+              nacc.assign(4 * num_points, 0.0f);
+            }
+            for (size_t k = 0; k < 2; k++) {
+              const std::vector<vec3> *offsets = active.term.normal_offsets[k];
+              if (offsets && (offsets->size() == n) &&
+                  (active.term.coeffs[k] != 0.0f)) {
+                ScatterAccumulate(indices, offsets->data(), n,
+                                  active.term.coeffs[k], nacc.data());
+              }
+            }
+          }
+        }
+      },
+      nthreads, /* grain_size */ 1);
+
+  //
+  // Reduce
+  //
+  auto reduce = [&](const std::vector<std::vector<float>> &accs, size_t p,
+                    float *delta) {
+    delta[0] = delta[1] = delta[2] = 0.0f;
+    for (const auto &acc : accs) {
+      if (acc.empty()) {
+        continue;
+      }
+      delta[0] += acc[4 * p + 0];
+      delta[1] += acc[4 * p + 1];
+      delta[2] += acc[4 * p + 2];
+    }
+  };
+
+  points->resize(num_points);
+  parallel::ParallelForChunked(
+      num_points,
+      [&](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        for (size_t p = begin; p < end; p++) {
+          float d[3];
+          reduce(point_acc, p, d);
+          (*points)[p] = {mesh.points[p][0] + d[0], mesh.points[p][1] + d[1],
+                          mesh.points[p][2] + d[2]};
+        }
+      },
+      nthreads, 4096);
+
+  if (normals) {
+    normals->clear();
+  }
+
+  if (do_normals) {
+    const VertexAttribute &attr = mesh.normals;
+    const size_t count = attr.vertex_count();
+    const uint32_t *point_indices{nullptr};
+    if ((attr.variability == VertexVariability::Vertex) ||
+        (attr.variability == VertexVariability::Varying)) {
+      if (count != num_points) {
+        PUSH_ERROR_AND_RETURN(fmt::format("normals.size {} must be equal to points.size {}: {}", count, num_points, mesh.abs_path));
+      }
+    } else if (attr.variability == VertexVariability::FaceVarying) {
+      const std::vector<uint32_t> &fvIndices = mesh.faceVertexIndices();
+      if (count != fvIndices.size()) {
+        PUSH_ERROR_AND_RETURN(fmt::format("normals.size {} must be equal to faceVertexIndices.size {}: {}", count, fvIndices.size(), mesh.abs_path));
+      }
+      for (uint32_t idx : fvIndices) {
+        if (idx >= num_points) {
+          PUSH_ERROR_AND_RETURN(fmt::format("faceVertexIndices contains out-of-range index {}: {}", idx, mesh.abs_path));
+        }
+      }
+      point_indices = fvIndices.data();
+    } else {
+      // Normals are not affected.
+      return true;
+    }
+
+    const vec3 *src = reinterpret_cast<const vec3 *>(attr.get_data().data());
+    normals->resize(count);
+    parallel::ParallelForChunked(
+        count,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          for (size_t i = begin; i < end; i++) {
+            float d[3];
+            reduce(normal_acc, point_indices ? point_indices[i] : i, d);
+            float n[3] = {src[i][0] + d[0], src[i][1] + d[1], src[i][2] + d[2]};
+            float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (len > 0.0f) {
+              n[0] /= len;
+              n[1] /= len;
+              n[2] /= len;
+            }
+            (*normals)[i] = {n[0], n[1], n[2]};
+          }
+        },
+        nthreads, 4096);
+  }
+
+  return true;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
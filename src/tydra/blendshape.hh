@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// BlendShape(UsdSkel) evaluation of RenderMesh
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "render-data.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+struct BlendShapeConfig {
+  // Targets whose |weight| is less than this value are skipped.
+  float weight_epsilon{1e-6f};
+
+  // Apply `normalOffsets` to `RenderMesh::normals`.
+  bool apply_normals{true};
+
+  // # of threads. -1 = use all hardware threads.
+  int num_threads{-1};
+
+  // Targets are evaluated in parallel when the total # of sparse offsets of
+  // active targets exceeds this value.
+  size_t parallel_threshold{16384};
+};
+
+///
+/// Get blendshape weights of `mesh` at time `t` from the Animation
+/// (`Animation::blendshape_weights_map`).
+///
+/// `weights` is ordered in the same order as `RenderMesh::targets`. Weight of
+/// the target not animated by `anim` is 0.
+///
+/// @param[in] mesh RenderMesh
+/// @param[in] anim Animation. Can be nullptr(all weights are 0).
+/// @param[in] t Time code. `value::TimeCode::Default()` = use static value.
+/// @param[out] weights Weights
+///
+void GetBlendShapeWeights(const RenderMesh &mesh, const Animation *anim,
+                          double t, std::vector<float> *weights);
+
+///
+/// Evaluate the weight of single ShapeTarget. In-between shapes are
+/// interpolated piecewise linearly between the neighboring in-between(or the
+/// rest shape at weight 0 and the primary shape at weight 1), as done in
+/// UsdSkelBlendShape.
+///
+/// @param[in] target ShapeTarget
+/// @param[in] weight Weight
+/// @param[out] offsets Dense offsets(size = `target.pointIndices.size()`)
+///
+void EvaluateShapeTarget(const ShapeTarget &target, float weight,
+                         std::vector<vec3> *offsets);
+
+///
+/// Apply blendshapes of `mesh` with weight vector `weights`.
+///
+/// Sparse offsets are scatter-accumulated to per-thread point buffers, and
+/// targets are processed in parallel.
+///
+/// @param[in] mesh RenderMesh
+/// @param[in] weights Weights(in the order of `RenderMesh::targets`)
+/// @param[out] points Deformed points
+/// @param[out] normals Deformed normals. Same variability as
+/// `RenderMesh::normals`. Empty when normals are not affected(no normals in
+/// the mesh, no `normalOffsets` in active targets or `apply_normals` is false).
+/// @param[out] err Error message
+/// @param[in] config Config
+///
+bool ApplyBlendShapes(const RenderMesh &mesh, const std::vector<float> &weights,
+                      std::vector<vec3> *points, std::vector<vec3> *normals,
+                      std::string *err,
+                      const BlendShapeConfig &config = BlendShapeConfig());
+
+}  // namespace tydra
+}  // namespace tinyusdz
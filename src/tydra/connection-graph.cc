@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024-Present Light Transport Entertainment, Inc.
+//
+#include "connection-graph.hh"
+
+#include <set>
+
+#include "common-macros.inc"
+#include "scene-access.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+// For PUSH_ERROR_AND_RETURN
+#define PushError(msg) \
+  if (err) {           \
+    (*err) += msg;     \
+  }
+
+bool CollectPrimsVisitor(const Path &abs_path, const Prim &prim,
+                         const int32_t level, void *userdata,
+                         std::string *err) {
+  (void)level;
+  (void)err;
+
+  std::unordered_map<std::string, const Prim *> *prims =
+      reinterpret_cast<std::unordered_map<std::string, const Prim *> *>(
+          userdata);
+  (*prims)[abs_path.prim_part()] = &prim;
+
+  return true;
+}
+
+}  // namespace
+
+void ConnectionGraph::clear() {
+  _stage = nullptr;
+  _prims.clear();
+  _terminals.clear();
+  _value_cache.clear();
+}
+
+bool ConnectionGraph::Build(const Stage &stage, std::string *err) {
+  clear();
+
+  std::string visit_err;
+  if (!VisitPrims(stage, CollectPrimsVisitor, &_prims, &visit_err)) {
+    _prims.clear();
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Failed to traverse Prims: {}", visit_err));
+  }
+
+  _stage = &stage;
+
+  return true;
+}
+
+const Prim *ConnectionGraph::GetPrim(const Path &prim_path) const {
+  auto it = _prims.find(prim_path.prim_part());
+  if (it == _prims.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+bool ConnectionGraph::Walk(const Path &attr_path, Path *terminal_path,
+                           std::string *err) {
+  // Attributes in the connection chain. All of them have the same terminal.
+  // Also used to detect circular referencing.
+  std::vector<std::string> chain;
+  std::set<std::string> visited_paths;
+
+  Terminal result;
+
+  Path path = attr_path;
+  while (true) {
+    const std::string key = path.full_path_name();
+
+    auto tit = _terminals.find(key);
+    if (tit != _terminals.end()) {
+      result = tit->second;
+      break;
+    }
+
+    if (visited_paths.count(key)) {
+      result.error = fmt::format(
+          "Circular referencing detected. connectionTargetPath = {}", key);
+      break;
+    }
+    visited_paths.insert(key);
+    chain.push_back(key);
+
+    const Prim *prim = GetPrim(path);
+    if (!prim) {
+      result.error =
+          fmt::format("Prim not found in the Stage: {}", path.prim_part());
+      break;
+    }
+
+    Attribute attr;
+    if (!GetAttribute(*prim, path.prop_part(), &attr, nullptr) ||
+        !attr.has_connections()) {
+      // Not a connection(or not an Attribute. It is reported when the value
+      // is evaluated).
+      result.path = path;
+      break;
+    }
+
+    // Single targetPath only.
+    const std::vector<Path> pv = attr.connections();
+    if (pv.empty()) {
+      result.error = fmt::format(
+          "Connection targetPath is empty for Attribute {}.", key);
+      break;
+    } else if (pv.size() > 1) {
+      result.error = fmt::format(
+          "Multiple targetPaths assigned to .connection of {}.", key);
+      break;
+    }
+
+    path = pv[0];
+  }
+
+  for (const auto &item : chain) {
+    _terminals[item] = result;
+  }
+
+  if (!result.error.empty()) {
+    PUSH_ERROR_AND_RETURN(result.error);
+  }
+
+  (*terminal_path) = result.path;
+  return true;
+}
+
+bool ConnectionGraph::GetTerminalAttributePath(const Path &attr_path,
+                                               Path *terminal_path,
+                                               std::string *err) {
+  if (!_stage) {
+    PUSH_ERROR_AND_RETURN("ConnectionGraph is not built.");
+  }
+
+  if (!terminal_path) {
+    PUSH_ERROR_AND_RETURN("`terminal_path` arg is nullptr.");
+  }
+
+  return Walk(attr_path, terminal_path, err);
+}
+
+bool ConnectionGraph::GetTerminalAttribute(const Path &attr_path,
+                                           Attribute *attr,
+                                           std::string *err) {
+  if (!attr) {
+    PUSH_ERROR_AND_RETURN("`attr` arg is nullptr.");
+  }
+
+  Path terminal_path;
+  if (!GetTerminalAttributePath(attr_path, &terminal_path, err)) {
+    return false;
+  }
+
+  const Prim *prim = GetPrim(terminal_path);
+  if (!prim) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Prim not found in the Stage: {}",
+                                      terminal_path.prim_part()));
+  }
+
+  return GetAttribute(*prim, terminal_path.prop_part(), attr, err);
+}
+
+bool ConnectionGraph::EvaluateAttribute(
+    const Path &prim_path, const std::string &attr_name,
+    TerminalAttributeValue *value, std::string *err, const double t,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp) {
+  if (!value) {
+    PUSH_ERROR_AND_RETURN("`value` arg is nullptr.");
+  }
+
+  Path terminal_path;
+  if (!GetTerminalAttributePath(Path(prim_path.prim_part(), attr_name),
+                                &terminal_path, err)) {
+    return false;
+  }
+
+  const std::string key = terminal_path.full_path_name();
+  auto vit = _value_cache.find(key);
+  if (vit != _value_cache.end()) {
+    (*value) = vit->second;
+    return true;
+  }
+
+  const Prim *prim = GetPrim(terminal_path);
+  if (!prim) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Prim not found in the Stage: {}",
+                                      terminal_path.prim_part()));
+  }
+
+  Attribute attr;
+  if (!GetAttribute(*prim, terminal_path.prop_part(), &attr, err)) {
+    return false;
+  }
+
+  // `attr` is not a connection, so no Prim lookup happens here.
+  if (!tydra::EvaluateAttribute(*_stage, attr, terminal_path.prop_part(), value,
+                                err, t, tinterp)) {
+    return false;
+  }
+
+  if (!attr.get_var().is_timesamples()) {
+    _value_cache[key] = (*value);
+  }
+
+  return true;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024-Present Light Transport Entertainment, Inc.
+//
+// Attribute connection graph of the Stage.
+//
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "attribute-eval.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+///
+/// Attribute connection graph of the Stage.
+///
+/// `Build` traverses the Stage once and builds a Prim path -> Prim table, so
+/// following a connection does not need `GetPrimAtPath` at every hop.
+/// Connections(`.connect`) are resolved to the terminal(value producing)
+/// attribute with circular referencing detection on the first query, and the
+/// result is memoized for every attribute in the connection chain. Repeated
+/// queries are O(1) lookups.
+///
+/// Evaluated values of time-independent(not timeSampled) terminal attributes
+/// are cached as well.
+///
+/// ConnectionGraph refers Prims in the Stage, so rebuild it when the Stage is
+/// modified. Queries of the terminal attribute and attribute value update
+/// the internal caches(thus non-const), so they are not thread-safe.
+///
+class ConnectionGraph {
+ public:
+  ///
+  /// @param[in] stage Stage
+  /// @param[out] err Error message
+  /// @return true upon success. Invalid connections(e.g. circular
+  /// referencing) are reported when they are queried.
+  ///
+  bool Build(const Stage &stage, std::string *err = nullptr);
+
+  // Stage used in `Build`. nullptr when not built.
+  const Stage *stage() const { return _stage; }
+
+  void clear();
+
+  ///
+  /// Find Prim by absolute Prim path.
+  ///
+  /// @return nullptr when not found.
+  ///
+  const Prim *GetPrim(const Path &prim_path) const;
+
+  ///
+  /// Get terminal(value producing) attribute path. When the attribute is not
+  /// a connection, `attr_path` itself is returned.
+  ///
+  /// @param[in] attr_path Absolute attribute path(e.g.
+  /// `/mat/pbr.inputs:diffuseColor`)
+  /// @param[out] terminal_path Terminal attribute path.
+  /// @param[out] err Error message
+  /// @return false when the connection is invalid(circular referencing,
+  /// multiple targets, target Prim not found).
+  ///
+  bool GetTerminalAttributePath(const Path &attr_path, Path *terminal_path,
+                                std::string *err = nullptr);
+
+  ///
+  /// Get terminal(value producing) Attribute. Same as `GetTerminalAttribute`
+  /// in scene-access.hh.
+  ///
+  bool GetTerminalAttribute(const Path &attr_path, Attribute *attr,
+                            std::string *err = nullptr);
+
+  ///
+  /// Evaluate Attribute of the Prim. Same as `EvaluateAttribute` in
+  /// attribute-eval.hh.
+  ///
+  /// @param[in] prim_path Absolute Prim path
+  /// @param[in] attr_name Attribute name
+  /// @param[out] value Evaluated terminal attribute value.
+  /// @param[out] err Error message
+  /// @param[in] t (optional) TimeCode(for timeSamples Attribute)
+  /// @param[in] tinterp (optional) Interpolation type for timeSamples value
+  ///
+  bool EvaluateAttribute(
+      const Path &prim_path, const std::string &attr_name,
+      TerminalAttributeValue *value, std::string *err = nullptr,
+      const double t = tinyusdz::value::TimeCode::Default(),
+      const tinyusdz::value::TimeSampleInterpolationType tinterp =
+          tinyusdz::value::TimeSampleInterpolationType::Linear);
+
+  // # of attributes whose terminal attribute is resolved.
+  size_t num_resolved() const { return _terminals.size(); }
+
+  // # of cached attribute values.
+  size_t num_cached_values() const { return _value_cache.size(); }
+
+ private:
+  // Terminal attribute of a connection chain. `error` is set for invalid
+  // connection.
+  struct Terminal {
+    Path path;
+    std::string error;
+  };
+
+  bool Walk(const Path &attr_path, Path *terminal_path, std::string *err);
+
+  const Stage *_stage{nullptr};
+
+  // key = Prim path
+  std::unordered_map<std::string, const Prim *> _prims;
+
+  // key = attribute path
+  std::unordered_map<std::string, Terminal> _terminals;
+
+  // key = terminal attribute path
+  std::unordered_map<std::string, TerminalAttributeValue> _value_cache;
+};
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,1910 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// RenderScene -> glTF 2.0 binary(GLB) exporter
+//
+// TODO:
+// - [ ] BlendShapes(morph targets)
+// - [ ] Cameras, lights(KHR_lights_punctual)
+// - [ ] Pass-through of PNG/JPEG asset data(no re-encoding)
+//
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <sstream>
+
+#include "gltf-export.hh"
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#endif
+
+#include "external/jsonhpp/nlohmann/json.hpp"
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#include "common-macros.inc"
+#include "image-writer.hh"
+#include "tiny-format.hh"
+#include "xform.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+using json = nlohmann::json;
+
+#define PushError(msg) \
+  {                    \
+    if (err) {         \
+      (*err) += msg;   \
+    }                  \
+  }
+
+#define PushWarn(msg) \
+  {                   \
+    if (warn) {       \
+      (*warn) += msg; \
+    }                 \
+  }
+
+constexpr uint32_t kGLBMagic = 0x46546C67;       // "glTF"
+constexpr uint32_t kGLBVersion = 2;
+constexpr uint32_t kGLBChunkJSON = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kGLBChunkBIN = 0x004E4942;   // "BIN\0"
+
+constexpr int kGLTFByte = 5120;
+constexpr int kGLTFUnsignedByte = 5121;
+constexpr int kGLTFShort = 5122;
+constexpr int kGLTFUnsignedShort = 5123;
+constexpr int kGLTFUnsignedInt = 5125;
+constexpr int kGLTFFloat = 5126;
+
+constexpr int kGLTFArrayBuffer = 34962;
+constexpr int kGLTFElementArrayBuffer = 34963;
+
+constexpr int kGLTFLinear = 9729;
+constexpr int kGLTFLinearMipmapLinear = 9987;
+constexpr int kGLTFClampToEdge = 33071;
+constexpr int kGLTFMirroredRepeat = 33648;
+constexpr int kGLTFRepeat = 10497;
+
+inline size_t Align4(size_t n) { return (n + 3) & ~size_t(3); }
+
+template <typename T>
+inline void StoreAt(std::vector<uint8_t> &buf, size_t byte_offset,
+                    const T &v) {
+  memcpy(buf.data() + byte_offset, &v, sizeof(T));
+}
+
+template <typename T>
+inline T LoadAt(const uint8_t *p, size_t byte_offset) {
+  T v;
+  memcpy(&v, p + byte_offset, sizeof(T));
+  return v;
+}
+
+inline int8_t QuantizeSnorm8(float v) {
+  v = std::max(-1.0f, std::min(1.0f, v));
+  return int8_t(std::lround(v * 127.0f));
+}
+
+///
+/// Packs bufferViews into the single BIN chunk.
+///
+/// Data is either borrowed(memory owned by RenderScene) or owned by the
+/// builder(converted data). In both cases, data is copied into the GLB only
+/// once in `CopyTo`.
+///
+class BinaryChunkBuilder {
+ public:
+  // @return bufferView id
+  int AddBufferView(const uint8_t *data, size_t nbytes, int target,
+                    uint32_t byte_stride = 0) {
+    Segment seg;
+    seg.data = data;
+    seg.nbytes = nbytes;
+    return AddSegment(std::move(seg), target, byte_stride);
+  }
+
+  int AddBufferView(std::vector<uint8_t> &&data, int target,
+                    uint32_t byte_stride = 0) {
+    Segment seg;
+    seg.nbytes = data.size();
+    seg.owned = std::move(data);
+    return AddSegment(std::move(seg), target, byte_stride);
+  }
+
+  size_t byte_length() const { return _byte_length; }
+
+  json &buffer_views() { return _buffer_views; }
+
+  // `dst` must have `byte_length()` bytes and be zero-initialized(padding).
+  void CopyTo(uint8_t *dst) const {
+    for (const auto &seg : _segments) {
+      const uint8_t *src = seg.owned.size() ? seg.owned.data() : seg.data;
+      memcpy(dst + seg.offset, src, seg.nbytes);
+    }
+  }
+
+ private:
+  struct Segment {
+    const uint8_t *data{nullptr};
+    size_t nbytes{0};
+    std::vector<uint8_t> owned;
+    size_t offset{0};
+  };
+
+  int AddSegment(Segment &&seg, int target, uint32_t byte_stride) {
+    // Align to 4 bytes so that any accessor componentType is aligned.
+    seg.offset = Align4(_byte_length);
+    _byte_length = seg.offset + seg.nbytes;
+
+    json bv;
+    bv["buffer"] = 0;
+    bv["byteOffset"] = seg.offset;
+    bv["byteLength"] = seg.nbytes;
+    if (byte_stride > 0) {
+      bv["byteStride"] = byte_stride;
+    }
+    if (target > 0) {
+      bv["target"] = target;
+    }
+
+    _segments.emplace_back(std::move(seg));
+    _buffer_views.push_back(bv);
+
+    return int(_buffer_views.size()) - 1;
+  }
+
+  std::vector<Segment> _segments;
+  json _buffer_views = json::array();
+  size_t _byte_length{0};
+};
+
+struct GLTFNode {
+  std::string name;
+
+  bool has_matrix{false};
+  std::array<double, 16> matrix;
+
+  bool has_trs{false};
+  std::array<double, 3> translation{{0.0, 0.0, 0.0}};
+  std::array<double, 4> rotation{{0.0, 0.0, 0.0, 1.0}};
+  std::array<double, 3> scale{{1.0, 1.0, 1.0}};
+
+  int mesh{-1};
+  int skin{-1};
+  std::vector<int> children;
+};
+
+// Dequantization transform for quantized positions.
+struct MeshDequantization {
+  bool enabled{false};
+  std::array<double, 3> translation{{0.0, 0.0, 0.0}};
+  double scale{1.0};
+};
+
+// USD matrix is row-major with row vectors, so flattened USD matrix is
+// identical to glTF's column-major matrix with column vectors.
+std::array<double, 16> ToGLTFMatrix(const value::matrix4d &m) {
+  std::array<double, 16> dst;
+  for (size_t i = 0; i < 4; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      dst[i * 4 + j] = m.m[i][j];
+    }
+  }
+  return dst;
+}
+
+// Decompose affine matrix(no shear) into TRS.
+void DecomposeTRS(const value::matrix4d &m, GLTFNode *node) {
+  node->has_trs = true;
+
+  for (size_t i = 0; i < 3; i++) {
+    node->translation[i] = m.m[3][i];
+  }
+
+  double s[3];
+  for (size_t i = 0; i < 3; i++) {
+    s[i] = std::sqrt(m.m[i][0] * m.m[i][0] + m.m[i][1] * m.m[i][1] +
+                     m.m[i][2] * m.m[i][2]);
+  }
+
+  value::matrix3d m3;
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      m3.m[i][j] = m.m[i][j];
+    }
+  }
+  if (determinant(m3) < 0.0) {
+    s[0] = -s[0];
+  }
+
+  // r[i][j] = Rotation matrix in column-vector convention(= transpose of USD
+  // matrix).
+  double r[3][3];
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      double sj = (std::fabs(s[j]) > 0.0) ? s[j] : 1.0;
+      r[i][j] = m.m[j][i] / sj;
+    }
+  }
+
+  double x, y, z, w;
+  double trace = r[0][0] + r[1][1] + r[2][2];
+  if (trace > 0.0) {
+    double k = std::sqrt(trace + 1.0) * 2.0;
+    w = 0.25 * k;
+    x = (r[2][1] - r[1][2]) / k;
+    y = (r[0][2] - r[2][0]) / k;
+    z = (r[1][0] - r[0][1]) / k;
+  } else if ((r[0][0] > r[1][1]) && (r[0][0] > r[2][2])) {
+    double k = std::sqrt(1.0 + r[0][0] - r[1][1] - r[2][2]) * 2.0;
+    w = (r[2][1] - r[1][2]) / k;
+    x = 0.25 * k;
+    y = (r[0][1] + r[1][0]) / k;
+    z = (r[0][2] + r[2][0]) / k;
+  } else if (r[1][1] > r[2][2]) {
+    double k = std::sqrt(1.0 + r[1][1] - r[0][0] - r[2][2]) * 2.0;
+    w = (r[0][2] - r[2][0]) / k;
+    x = (r[0][1] + r[1][0]) / k;
+    y = 0.25 * k;
+    z = (r[1][2] + r[2][1]) / k;
+  } else {
+    double k = std::sqrt(1.0 + r[2][2] - r[0][0] - r[1][1]) * 2.0;
+    w = (r[1][0] - r[0][1]) / k;
+    x = (r[0][2] + r[2][0]) / k;
+    y = (r[1][2] + r[2][1]) / k;
+    z = 0.25 * k;
+  }
+
+  double len = std::sqrt(x * x + y * y + z * z + w * w);
+  if (len > 0.0) {
+    x /= len;
+    y /= len;
+    z /= len;
+    w /= len;
+  } else {
+    x = y = z = 0.0;
+    w = 1.0;
+  }
+
+  node->rotation = {{x, y, z, w}};
+  node->scale = {{s[0], s[1], s[2]}};
+}
+
+json ToJSON(const GLTFNode &node) {
+  json j;
+  if (node.name.size()) {
+    j["name"] = node.name;
+  }
+  if (node.has_trs) {
+    j["translation"] = node.translation;
+    j["rotation"] = node.rotation;
+    j["scale"] = node.scale;
+  } else if (node.has_matrix) {
+    j["matrix"] = node.matrix;
+  }
+  if (node.mesh >= 0) {
+    j["mesh"] = node.mesh;
+  }
+  if (node.skin >= 0) {
+    j["skin"] = node.skin;
+  }
+  if (node.children.size()) {
+    j["children"] = node.children;
+  }
+  return j;
+}
+
+int ToGLTFWrapMode(UVTexture::WrapMode mode) {
+  switch (mode) {
+    case UVTexture::WrapMode::REPEAT:
+      return kGLTFRepeat;
+    case UVTexture::WrapMode::MIRROR:
+      return kGLTFMirroredRepeat;
+    case UVTexture::WrapMode::CLAMP_TO_EDGE:
+    case UVTexture::WrapMode::CLAMP_TO_BORDER:  // no border color in glTF
+      return kGLTFClampToEdge;
+  }
+  return kGLTFClampToEdge;
+}
+
+///
+/// Vertex layout of the exported mesh.
+///
+/// glTF requires single-indexable vertex attributes. When any of vertex
+/// attribute is `facevarying`(or `uniform`) variability, each face-vertex
+/// becomes a glTF vertex(`expanded`).
+///
+struct VertexLayout {
+  bool expanded{false};
+  size_t num_vertices{0};
+  size_t num_points{0};
+  size_t num_faces{0};
+  const std::vector<uint32_t> *face_vertex_indices{nullptr};
+  std::vector<uint32_t> corner_to_face;  // Filled when `expanded`
+
+  // Index to `points`(and joint weights) for glTF vertex `v`.
+  size_t point_index(size_t v) const {
+    return expanded ? size_t((*face_vertex_indices)[v]) : v;
+  }
+};
+
+///
+/// Gather vertex attribute data in glTF vertex order.
+///
+/// `borrowed` is set when `src` can be used as-is. Otherwise `gathered` is
+/// filled.
+///
+bool GatherVertexData(const uint8_t *src, size_t src_count, size_t elem_bytes,
+                      VertexVariability variability, const VertexLayout &layout,
+                      const uint8_t **borrowed, std::vector<uint8_t> *gathered,
+                      std::string *reason) {
+  (*borrowed) = nullptr;
+
+  auto gather = [&](const std::function<size_t(size_t)> &src_index) {
+    gathered->resize(layout.num_vertices * elem_bytes);
+    for (size_t v = 0; v < layout.num_vertices; v++) {
+      memcpy(gathered->data() + v * elem_bytes,
+             src + src_index(v) * elem_bytes, elem_bytes);
+    }
+  };
+
+  switch (variability) {
+    case VertexVariability::Vertex:
+    case VertexVariability::Varying: {
+      if (src_count != layout.num_points) {
+        (*reason) = fmt::format("# of elements {} must be equal to # of points {}", src_count, layout.num_points);
+        return false;
+      }
+      if (!layout.expanded) {
+        (*borrowed) = src;
+      } else {
+        gather([&layout](size_t v) { return layout.point_index(v); });
+      }
+      return true;
+    }
+    case VertexVariability::FaceVarying: {
+      if (!layout.expanded ||
+          (src_count != layout.face_vertex_indices->size())) {
+        (*reason) = fmt::format("# of elements {} must be equal to # of face-vertices {}", src_count, layout.face_vertex_indices->size());
+        return false;
+      }
+      (*borrowed) = src;
+      return true;
+    }
+    case VertexVariability::Uniform: {
+      if (!layout.expanded || (src_count != layout.num_faces)) {
+        (*reason) = fmt::format("# of elements {} must be equal to # of faces {}", src_count, layout.num_faces);
+        return false;
+      }
+      gather([&layout](size_t v) { return size_t(layout.corner_to_face[v]); });
+      return true;
+    }
+    case VertexVariability::Constant: {
+      if (src_count < 1) {
+        (*reason) = "Empty `constant` attribute.";
+        return false;
+      }
+      gather([](size_t v) {
+        (void)v;
+        return size_t(0);
+      });
+      return true;
+    }
+    case VertexVariability::Indexed: {
+      (*reason) = "`Indexed` variability is not supported.";
+      return false;
+    }
+  }
+
+  (*reason) = "Unknown variability.";
+  return false;
+}
+
+class GLBExporter {
+ public:
+  GLBExporter(const RenderScene &scene, const GLBExportConfig &config)
+      : _scene(scene), _config(config) {}
+
+  bool Export(std::vector<uint8_t> &glb);
+
+  const std::string &GetWarning() const { return _warn; }
+  const std::string &GetError() const { return _err; }
+
+ private:
+  int AddAccessor(int buffer_view, int component_type, bool normalized,
+                  size_t count, const char *type,
+                  const std::vector<double> *min_values = nullptr,
+                  const std::vector<double> *max_values = nullptr);
+
+  // Add VertexAttribute as glTF vertex data. Returns accessor id(-1 = not
+  // exported).
+  int AddVertexAttribute(const RenderMesh &mesh, const VertexAttribute &attr,
+                         const char *attr_name, const VertexLayout &layout,
+                         VertexAttributeFormat expected_format);
+
+  bool ExportImages();
+  bool ExportTextures();
+  bool ExportMaterials();
+  bool ExportMesh(size_t mesh_id);
+  int ExportNode(const Node &node, int parent);
+  int GetOrCreateSkin(int skel_id, int parent);
+  int CreateJointNode(const SkelNode &skel_node, std::vector<int> &joints,
+                      std::map<std::string, int> &joint_map, bool *ok);
+  void AddAnimationChannels(const AnimationChannel &channel, int node,
+                            json &samplers, json &channels);
+  void AddChildNode(int parent, int child);
+
+  json TextureInfo(int texture_id, size_t material_id);
+
+  const RenderScene &_scene;
+  const GLBExportConfig &_config;
+
+  BinaryChunkBuilder _bin;
+
+  json _accessors = json::array();
+  json _meshes = json::array();
+  json _materials = json::array();
+  json _textures = json::array();
+  json _samplers = json::array();
+  json _images = json::array();
+  json _skins = json::array();
+  json _animations = json::array();
+
+  std::vector<GLTFNode> _nodes;
+  std::vector<int> _scene_roots;
+  int _root_node{-1};  // Y-up/meters conversion node
+
+  std::vector<int> _image_map;    // TextureImage id -> glTF image id
+  std::vector<int> _mesh_map;     // RenderMesh id -> glTF mesh id
+  std::vector<MeshDequantization> _mesh_dequant;  // per RenderMesh
+  std::map<int, int> _skin_map;  // skel_id -> glTF skin id
+  std::map<std::string, int> _node_path_map;  // abs_path -> glTF node id
+
+  struct SkinnedNode {
+    int node;
+    int parent;
+    int skel_id;
+  };
+  std::vector<SkinnedNode> _skinned_nodes;
+  std::vector<bool> _material_double_sided;
+  // per RenderMaterial. key = texcoord primvar name, value = TEXCOORD_n index
+  std::vector<std::map<std::string, int>> _material_texcoords;
+
+  // Node animations
+  json _node_anim_samplers = json::array();
+  json _node_anim_channels = json::array();
+
+  bool _use_mesh_quantization{false};
+  bool _use_texture_transform{false};
+  bool _use_materials_ior{false};
+
+  std::string _warn;
+  std::string _err;
+};
+
+int GLBExporter::AddAccessor(int buffer_view, int component_type,
+                             bool normalized, size_t count, const char *type,
+                             const std::vector<double> *min_values,
+                             const std::vector<double> *max_values) {
+  json acc;
+  acc["bufferView"] = buffer_view;
+  acc["componentType"] = component_type;
+  if (normalized) {
+    acc["normalized"] = true;
+  }
+  acc["count"] = count;
+  acc["type"] = type;
+  if (min_values && max_values) {
+    acc["min"] = *min_values;
+    acc["max"] = *max_values;
+  }
+
+  _accessors.push_back(acc);
+  return int(_accessors.size()) - 1;
+}
+
+bool GLBExporter::ExportImages() {
+  std::string *warn = &_warn;
+
+  _image_map.assign(_scene.images.size(), -1);
+
+  if (!_config.export_images) {
+    return true;
+  }
+
+  for (size_t i = 0; i < _scene.images.size(); i++) {
+    const TextureImage &texImage = _scene.images[i];
+
+    if (texImage.compressionFormat != TextureCompressionFormat::None) {
+      PUSH_WARN(fmt::format("Block compressed texture image is not supported in glTF. Skip exporting image[{}]: {}", i, texImage.asset_identifier));
+      continue;
+    }
+
+    if (texImage.texelComponentType != ComponentType::UInt8) {
+      PUSH_WARN(fmt::format("Only 8bit texture image is supported. Skip exporting image[{}]: {}", i, texImage.asset_identifier));
+      continue;
+    }
+
+    if ((texImage.buffer_id < 0) ||
+        (size_t(texImage.buffer_id) >= _scene.buffers.size())) {
+      PUSH_WARN(fmt::format("Invalid buffer_id {} in image[{}]", texImage.buffer_id, i));
+      continue;
+    }
+
+    const BufferData &buffer = _scene.buffers[size_t(texImage.buffer_id)];
+
+    // Use the first mip level.
+    Image image;
+    image.width = texImage.width;
+    image.height = texImage.height;
+    image.channels = texImage.channels;
+    image.bpp = 8;
+    image.format = Image::PixelFormat::UInt;
+
+    uint64_t byte_offset = 0;
+    uint64_t byte_length = buffer.data.size();
+    if (texImage.mipLevels.size()) {
+      image.width = texImage.mipLevels[0].width;
+      image.height = texImage.mipLevels[0].height;
+      byte_offset = texImage.mipLevels[0].byte_offset;
+      byte_length = texImage.mipLevels[0].byte_length;
+    }
+
+    if ((byte_offset + byte_length) > buffer.data.size()) {
+      PUSH_WARN(fmt::format("Invalid mip level data in image[{}]", i));
+      continue;
+    }
+
+    image.data.assign(buffer.data.begin() + std::ptrdiff_t(byte_offset),
+                      buffer.data.begin() + std::ptrdiff_t(byte_offset + byte_length));
+
+    image::WriteOption option;
+    option.format = image::WriteImageFormat::PNG;
+    auto ret = image::WriteImageToMemory(image, option);
+    if (!ret) {
+      PUSH_WARN(fmt::format("Failed to encode image[{}] as PNG: {}", i, ret.error()));
+      continue;
+    }
+
+    int bv = _bin.AddBufferView(std::move(ret.value()), /* target */ 0);
+
+    json img;
+    img["bufferView"] = bv;
+    img["mimeType"] = "image/png";
+    if (texImage.asset_identifier.size()) {
+      img["name"] = texImage.asset_identifier;
+    }
+
+    _image_map[i] = int(_images.size());
+    _images.push_back(img);
+  }
+
+  return true;
+}
+
+bool GLBExporter::ExportTextures() {
+  // key = (wrapS, wrapT)
+  std::map<std::pair<int, int>, int> sampler_map;
+
+  for (const auto &tex : _scene.textures) {
+    std::pair<int, int> wrap(ToGLTFWrapMode(tex.wrapS),
+                             ToGLTFWrapMode(tex.wrapT));
+    if (!sampler_map.count(wrap)) {
+      json sampler;
+      sampler["magFilter"] = kGLTFLinear;
+      sampler["minFilter"] = kGLTFLinearMipmapLinear;
+      sampler["wrapS"] = wrap.first;
+      sampler["wrapT"] = wrap.second;
+      sampler_map[wrap] = int(_samplers.size());
+      _samplers.push_back(sampler);
+    }
+
+    json t;
+    if (tex.prim_name.size()) {
+      t["name"] = tex.prim_name;
+    }
+    t["sampler"] = sampler_map.at(wrap);
+
+    if ((tex.texture_image_id >= 0) &&
+        (size_t(tex.texture_image_id) < _image_map.size()) &&
+        (_image_map[size_t(tex.texture_image_id)] >= 0)) {
+      t["source"] = _image_map[size_t(tex.texture_image_id)];
+    }
+
+    _textures.push_back(t);
+  }
+
+  return true;
+}
+
+json GLBExporter::TextureInfo(int texture_id, size_t material_id) {
+  json info;
+  info["index"] = texture_id;
+
+  const UVTexture &tex = _scene.textures[size_t(texture_id)];
+
+  // TEXCOORD_n of `varname_uv` in the meshes which use this material.
+  int texcoord = 0;
+  if (material_id < _material_texcoords.size()) {
+    const auto &texcoords = _material_texcoords[material_id];
+    auto it = texcoords.find(tex.varname_uv);
+    if (it != texcoords.end()) {
+      texcoord = it->second;
+    }
+  }
+  info["texCoord"] = texcoord;
+
+  if (tex.has_transform2d) {
+    // UsdTransform2d: uv' = uv * scale * rotate(degree, counter-clockwise) +
+    // translation
+    double theta = double(tex.tx_rotation) * 3.141592653589793 / 180.0;
+    double sx = double(tex.tx_scale[0]);
+    double sy = double(tex.tx_scale[1]);
+    double tx = double(tex.tx_translation[0]);
+    double ty = double(tex.tx_translation[1]);
+
+    json tt;
+    tt["scale"] = {sx, sy};
+    if (_config.flip_texcoord_v) {
+      // Conjugate the transform with the V flip(v' = 1 - v).
+      tt["rotation"] = theta;
+      tt["offset"] = {tx - sy * std::sin(theta), 1.0 - ty - sy * std::cos(theta)};
+    } else {
+      tt["rotation"] = -theta;
+      tt["offset"] = {tx, ty};
+    }
+    info["extensions"]["KHR_texture_transform"] = tt;
+    _use_texture_transform = true;
+  }
+
+  return info;
+}
+
+bool GLBExporter::ExportMaterials() {
+  std::string *warn = &_warn;
+
+  auto valid_texture = [this](int texture_id) {
+    return (texture_id >= 0) && (size_t(texture_id) < _scene.textures.size());
+  };
+
+  for (size_t i = 0; i < _scene.materials.size(); i++) {
+    const RenderMaterial &material = _scene.materials[i];
+    const PreviewSurfaceShader &shader = material.surfaceShader;
+
+    if (shader.useSpecularWorkflow) {
+      PUSH_WARN(fmt::format("Specular workflow is not supported. Material is exported as metallic-roughness workflow: {}", material.abs_path));
+    }
+
+    json m;
+    m["name"] = material.name;
+
+    json pbr;
+    pbr["baseColorFactor"] = {shader.diffuseColor.value[0],
+                              shader.diffuseColor.value[1],
+                              shader.diffuseColor.value[2],
+                              shader.opacity.is_texture() ? 1.0f : shader.opacity.value};
+    if (valid_texture(shader.diffuseColor.texture_id)) {
+      pbr["baseColorFactor"] = {1.0, 1.0, 1.0, shader.opacity.is_texture() ? 1.0f : shader.opacity.value};
+      pbr["baseColorTexture"] = TextureInfo(shader.diffuseColor.texture_id, i);
+    }
+
+    pbr["metallicFactor"] = shader.metallic.value;
+    pbr["roughnessFactor"] = shader.roughness.value;
+
+    if (shader.metallic.is_texture() || shader.roughness.is_texture()) {
+      // glTF requires metallic(B) and roughness(G) to be packed into single
+      // texture.
+      if (shader.metallic.is_texture() && shader.roughness.is_texture() &&
+          valid_texture(shader.metallic.texture_id) &&
+          valid_texture(shader.roughness.texture_id) &&
+          (_scene.textures[size_t(shader.metallic.texture_id)].texture_image_id ==
+           _scene.textures[size_t(shader.roughness.texture_id)].texture_image_id)) {
+        pbr["metallicFactor"] = 1.0;
+        pbr["roughnessFactor"] = 1.0;
+        pbr["metallicRoughnessTexture"] = TextureInfo(shader.metallic.texture_id, i);
+      } else {
+        PUSH_WARN(fmt::format("metallic and roughness texture must be the same image to export it to glTF. metallicRoughnessTexture is not exported: {}", material.abs_path));
+      }
+    }
+
+    m["pbrMetallicRoughness"] = pbr;
+
+    if (valid_texture(shader.normal.texture_id)) {
+      m["normalTexture"] = TextureInfo(shader.normal.texture_id, i);
+    }
+
+    if (valid_texture(shader.occlusion.texture_id)) {
+      m["occlusionTexture"] = TextureInfo(shader.occlusion.texture_id, i);
+    }
+
+    if (valid_texture(shader.emissiveColor.texture_id)) {
+      m["emissiveFactor"] = {1.0, 1.0, 1.0};
+      m["emissiveTexture"] = TextureInfo(shader.emissiveColor.texture_id, i);
+    } else {
+      m["emissiveFactor"] = {shader.emissiveColor.value[0],
+                             shader.emissiveColor.value[1],
+                             shader.emissiveColor.value[2]};
+    }
+
+    if (shader.opacity.is_texture() &&
+        (shader.opacity.texture_id != shader.diffuseColor.texture_id)) {
+      PUSH_WARN(fmt::format("glTF uses alpha channel of baseColorTexture for opacity. opacity texture is not exported: {}", material.abs_path));
+    }
+
+    if (shader.opacityThreshold.value > 0.0f) {
+      m["alphaMode"] = "MASK";
+      m["alphaCutoff"] = shader.opacityThreshold.value;
+    } else if (shader.opacity.is_texture() || (shader.opacity.value < 1.0f)) {
+      m["alphaMode"] = "BLEND";
+    }
+
+    if ((i < _material_double_sided.size()) && _material_double_sided[i]) {
+      m["doubleSided"] = true;
+    }
+
+    if (std::fabs(shader.ior.value - 1.5f) >
+        std::numeric_limits<float>::epsilon()) {
+      m["extensions"]["KHR_materials_ior"]["ior"] = shader.ior.value;
+      _use_materials_ior = true;
+    }
+
+    _materials.push_back(m);
+  }
+
+  return true;
+}
+
+int GLBExporter::AddVertexAttribute(const RenderMesh &mesh,
+                                    const VertexAttribute &attr,
+                                    const char *attr_name,
+                                    const VertexLayout &layout,
+                                    VertexAttributeFormat expected_format) {
+  std::string *warn = &_warn;
+
+  if (attr.empty()) {
+    return -1;
+  }
+
+  size_t elem_bytes = VertexAttributeFormatSize(attr.format);
+  if ((attr.format != expected_format) || (attr.elementSize != 1) ||
+      ((attr.stride != 0) && (attr.stride != elem_bytes))) {
+    PUSH_WARN(fmt::format("Unsupported format {}(elementSize {}) for {}. Skip exporting it: {}", to_string(attr.format), attr.elementSize, attr_name, mesh.abs_path));
+    return -1;
+  }
+
+  const uint8_t *borrowed{nullptr};
+  std::vector<uint8_t> gathered;
+  std::string reason;
+  if (!GatherVertexData(attr.data.data(), attr.vertex_count(), elem_bytes,
+                        attr.variability, layout, &borrowed, &gathered,
+                        &reason)) {
+    PUSH_WARN(fmt::format("Skip exporting {}. {}: {}", attr_name, reason, mesh.abs_path));
+    return -1;
+  }
+
+  const char *type = (expected_format == VertexAttributeFormat::Float)  ? "SCALAR"
+                     : (expected_format == VertexAttributeFormat::Vec2) ? "VEC2"
+                     : (expected_format == VertexAttributeFormat::Vec3) ? "VEC3"
+                                                                        : "VEC4";
+
+  int bv{-1};
+  if (borrowed) {
+    bv = _bin.AddBufferView(borrowed, layout.num_vertices * elem_bytes,
+                            kGLTFArrayBuffer);
+  } else {
+    bv = _bin.AddBufferView(std::move(gathered), kGLTFArrayBuffer);
+  }
+
+  return AddAccessor(bv, kGLTFFloat, false, layout.num_vertices, type);
+}
+
+bool GLBExporter::ExportMesh(size_t mesh_id) {
+  std::string *warn = &_warn;
+
+  const RenderMesh &mesh = _scene.meshes[mesh_id];
+
+  const std::vector<uint32_t> &fvIndices = mesh.faceVertexIndices();
+  const std::vector<uint32_t> &fvCounts = mesh.faceVertexCounts();
+
+  if (mesh.points.empty() || fvIndices.empty()) {
+    PUSH_WARN(fmt::format("Empty mesh. Skip exporting it: {}", mesh.abs_path));
+    return true;
+  }
+
+  // face offsets(prefix sum of faceVertexCounts)
+  std::vector<size_t> faceOffsets(fvCounts.size());
+  {
+    size_t offset = 0;
+    for (size_t f = 0; f < fvCounts.size(); f++) {
+      faceOffsets[f] = offset;
+      offset += fvCounts[f];
+    }
+    if (offset != fvIndices.size()) {
+      PUSH_WARN(fmt::format("Sum of faceVertexCounts {} must be equal to faceVertexIndices.size {}. Skip exporting it: {}", offset, fvIndices.size(), mesh.abs_path));
+      return true;
+    }
+  }
+
+  for (size_t i = 0; i < fvIndices.size(); i++) {
+    if (fvIndices[i] >= mesh.points.size()) {
+      PUSH_WARN(fmt::format("faceVertexIndices[{}] {} is out-of-range. Skip exporting it: {}", i, fvIndices[i], mesh.abs_path));
+      return true;
+    }
+  }
+
+  VertexLayout layout;
+  layout.num_points = mesh.points.size();
+  layout.num_faces = fvCounts.size();
+  layout.face_vertex_indices = &fvIndices;
+
+  auto needs_expand = [](const VertexAttribute &attr) {
+    return !attr.empty() && ((attr.variability == VertexVariability::FaceVarying) ||
+                             (attr.variability == VertexVariability::Uniform));
+  };
+
+  layout.expanded = needs_expand(mesh.normals) || needs_expand(mesh.tangents) ||
+                    needs_expand(mesh.vertex_colors) ||
+                    needs_expand(mesh.vertex_opacities);
+  for (const auto &it : mesh.texcoords) {
+    layout.expanded |= needs_expand(it.second);
+  }
+
+  layout.num_vertices = layout.expanded ? fvIndices.size() : mesh.points.size();
+
+  if (layout.expanded) {
+    layout.corner_to_face.resize(fvIndices.size());
+    for (size_t f = 0; f < fvCounts.size(); f++) {
+      for (size_t k = 0; k < fvCounts[f]; k++) {
+        layout.corner_to_face[faceOffsets[f] + k] = uint32_t(f);
+      }
+    }
+  }
+
+  const size_t nverts = layout.num_vertices;
+
+  const bool skinned = _config.export_skins && (mesh.skel_id >= 0) &&
+                       (size_t(mesh.skel_id) < _scene.skeletons.size());
+
+  // geomBindTransform has no equivalent in glTF. Bake it into vertex data.
+  const bool bake_geom_bind =
+      skinned && !is_identity(mesh.joint_and_weights.geomBindTransform);
+  const value::matrix4d &geomBind = mesh.joint_and_weights.geomBindTransform;
+
+  json attributes;
+
+  //
+  // POSITION
+  //
+  {
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(mesh.points.data());
+    const uint8_t *borrowed{nullptr};
+    std::vector<uint8_t> gathered;
+    std::string reason;
+    if (!GatherVertexData(src, mesh.points.size(), sizeof(vec3),
+                          VertexVariability::Vertex, layout, &borrowed,
+                          &gathered, &reason)) {
+      PUSH_WARN(fmt::format("Skip exporting mesh. {}: {}", reason, mesh.abs_path));
+      return true;
+    }
+
+    if (bake_geom_bind) {
+      if (borrowed) {
+        gathered.assign(borrowed, borrowed + nverts * sizeof(vec3));
+        borrowed = nullptr;
+      }
+      for (size_t v = 0; v < nverts; v++) {
+        vec3 p = LoadAt<vec3>(gathered.data(), v * sizeof(vec3));
+        vec3 q;
+        for (size_t k = 0; k < 3; k++) {
+          q[k] = float(double(p[0]) * geomBind.m[0][k] +
+                       double(p[1]) * geomBind.m[1][k] +
+                       double(p[2]) * geomBind.m[2][k] + geomBind.m[3][k]);
+        }
+        StoreAt(gathered, v * sizeof(vec3), q);
+      }
+    }
+
+    const uint8_t *pdata = borrowed ? borrowed : gathered.data();
+
+    std::vector<double> bmin(3, std::numeric_limits<double>::infinity());
+    std::vector<double> bmax(3, -std::numeric_limits<double>::infinity());
+    for (size_t v = 0; v < nverts; v++) {
+      vec3 p = LoadAt<vec3>(pdata, v * sizeof(vec3));
+      for (size_t k = 0; k < 3; k++) {
+        bmin[k] = std::min(bmin[k], double(p[k]));
+        bmax[k] = std::max(bmax[k], double(p[k]));
+      }
+    }
+
+    int acc{-1};
+    if (_config.quantize_positions && !skinned) {
+      // int16 positions with uniform scale(keeps normals valid).
+      MeshDequantization &dq = _mesh_dequant[mesh_id];
+      double extent = 0.0;
+      for (size_t k = 0; k < 3; k++) {
+        dq.translation[k] = 0.5 * (bmin[k] + bmax[k]);
+        extent = std::max(extent, 0.5 * (bmax[k] - bmin[k]));
+      }
+      dq.scale = (extent > 0.0) ? (extent / 32767.0) : 1.0;
+      dq.enabled = true;
+
+      std::vector<uint8_t> qdata(nverts * 8, 0);  // 4 bytes aligned
+      std::vector<double> qmin(3, 32767.0);
+      std::vector<double> qmax(3, -32767.0);
+      for (size_t v = 0; v < nverts; v++) {
+        vec3 p = LoadAt<vec3>(pdata, v * sizeof(vec3));
+        for (size_t k = 0; k < 3; k++) {
+          double q = std::round((double(p[k]) - dq.translation[k]) / dq.scale);
+          q = std::max(-32767.0, std::min(32767.0, q));
+          qmin[k] = std::min(qmin[k], q);
+          qmax[k] = std::max(qmax[k], q);
+          StoreAt(qdata, v * 8 + k * 2, int16_t(q));
+        }
+      }
+
+      int bv = _bin.AddBufferView(std::move(qdata), kGLTFArrayBuffer, 8);
+      acc = AddAccessor(bv, kGLTFShort, false, nverts, "VEC3", &qmin, &qmax);
+      _use_mesh_quantization = true;
+    } else {
+      int bv{-1};
+      if (borrowed) {
+        bv = _bin.AddBufferView(borrowed, nverts * sizeof(vec3), kGLTFArrayBuffer);
+      } else {
+        bv = _bin.AddBufferView(std::move(gathered), kGLTFArrayBuffer);
+      }
+      acc = AddAccessor(bv, kGLTFFloat, false, nverts, "VEC3", &bmin, &bmax);
+    }
+
+    attributes["POSITION"] = acc;
+  }
+
+  //
+  // NORMAL, TANGENT
+  //
+  std::vector<uint8_t> normals;  // float3 x nverts. Used to compute tangent.w
+  if (!mesh.normals.empty()) {
+    const VertexAttribute &attr = mesh.normals;
+    const uint8_t *borrowed{nullptr};
+    std::string reason;
+    if ((attr.format != VertexAttributeFormat::Vec3) || (attr.elementSize != 1)) {
+      PUSH_WARN(fmt::format("normals must be float3. Skip exporting it: {}", mesh.abs_path));
+    } else if (!GatherVertexData(attr.data.data(), attr.vertex_count(), sizeof(vec3), attr.variability, layout, &borrowed, &normals, &reason)) {
+      PUSH_WARN(fmt::format("Skip exporting normals. {}: {}", reason, mesh.abs_path));
+      normals.clear();
+    } else {
+      if (borrowed) {
+        normals.assign(borrowed, borrowed + nverts * sizeof(vec3));
+      }
+
+      if (bake_geom_bind) {
+        // Assume geomBindTransform has no non-uniform scale.
+        for (size_t v = 0; v < nverts; v++) {
+          vec3 n = LoadAt<vec3>(normals.data(), v * sizeof(vec3));
+          double q[3];
+          for (size_t k = 0; k < 3; k++) {
+            q[k] = double(n[0]) * geomBind.m[0][k] +
+                   double(n[1]) * geomBind.m[1][k] +
+                   double(n[2]) * geomBind.m[2][k];
+          }
+          double len = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+          if (len > 0.0) {
+            n = {float(q[0] / len), float(q[1] / len), float(q[2] / len)};
+          }
+          StoreAt(normals, v * sizeof(vec3), n);
+        }
+      }
+
+      if (_config.quantize_normals) {
+        std::vector<uint8_t> qdata(nverts * 4, 0);  // 4 bytes aligned
+        for (size_t v = 0; v < nverts; v++) {
+          vec3 n = LoadAt<vec3>(normals.data(), v * sizeof(vec3));
+          for (size_t k = 0; k < 3; k++) {
+            qdata[v * 4 + k] = uint8_t(QuantizeSnorm8(n[k]));
+          }
+        }
+        int bv = _bin.AddBufferView(std::move(qdata), kGLTFArrayBuffer, 4);
+        attributes["NORMAL"] = AddAccessor(bv, kGLTFByte, true, nverts, "VEC3");
+        _use_mesh_quantization = true;
+      } else if (borrowed && !bake_geom_bind) {
+        int bv = _bin.AddBufferView(borrowed, nverts * sizeof(vec3), kGLTFArrayBuffer);
+        attributes["NORMAL"] = AddAccessor(bv, kGLTFFloat, false, nverts, "VEC3");
+      } else {
+        std::vector<uint8_t> ndata(normals);
+        int bv = _bin.AddBufferView(std::move(ndata), kGLTFArrayBuffer);
+        attributes["NORMAL"] = AddAccessor(bv, kGLTFFloat, false, nverts, "VEC3");
+      }
+    }
+  }
+
+  if (!mesh.tangents.empty() && normals.size()) {
+    const uint8_t *borrowed{nullptr};
+    std::vector<uint8_t> tangents;
+    std::vector<uint8_t> binormals;
+    std::string reason;
+    bool ok = (mesh.tangents.format == VertexAttributeFormat::Vec3) &&
+              (mesh.tangents.elementSize == 1);
+    if (ok) {
+      ok = GatherVertexData(mesh.tangents.data.data(), mesh.tangents.vertex_count(), sizeof(vec3), mesh.tangents.variability, layout, &borrowed, &tangents, &reason);
+      if (ok && borrowed) {
+        tangents.assign(borrowed, borrowed + nverts * sizeof(vec3));
+      }
+    }
+
+    if (ok && !mesh.binormals.empty() &&
+        (mesh.binormals.format == VertexAttributeFormat::Vec3) &&
+        (mesh.binormals.elementSize == 1)) {
+      std::string breason;
+      if (GatherVertexData(mesh.binormals.data.data(), mesh.binormals.vertex_count(), sizeof(vec3), mesh.binormals.variability, layout, &borrowed, &binormals, &breason)) {
+        if (borrowed) {
+          binormals.assign(borrowed, borrowed + nverts * sizeof(vec3));
+        }
+      } else {
+        binormals.clear();
+      }
+    }
+
+    if (ok) {
+      // glTF tangent is float4. w = handedness(sign of bitangent).
+      const bool quantize = _config.quantize_normals;
+      const size_t item_bytes = quantize ? 4 : sizeof(vec4);
+      std::vector<uint8_t> tdata(nverts * item_bytes);
+      for (size_t v = 0; v < nverts; v++) {
+        vec3 n = LoadAt<vec3>(normals.data(), v * sizeof(vec3));
+        vec3 t = LoadAt<vec3>(tangents.data(), v * sizeof(vec3));
+        float w = 1.0f;
+        if (binormals.size()) {
+          vec3 b = LoadAt<vec3>(binormals.data(), v * sizeof(vec3));
+          vec3 c = {n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2],
+                    n[0] * t[1] - n[1] * t[0]};
+          w = ((c[0] * b[0] + c[1] * b[1] + c[2] * b[2]) < 0.0f) ? -1.0f : 1.0f;
+        }
+        if (quantize) {
+          tdata[v * 4 + 0] = uint8_t(QuantizeSnorm8(t[0]));
+          tdata[v * 4 + 1] = uint8_t(QuantizeSnorm8(t[1]));
+          tdata[v * 4 + 2] = uint8_t(QuantizeSnorm8(t[2]));
+          tdata[v * 4 + 3] = uint8_t(QuantizeSnorm8(w));
+        } else {
+          vec4 t4 = {t[0], t[1], t[2], w};
+          StoreAt(tdata, v * sizeof(vec4), t4);
+        }
+      }
+      int bv = _bin.AddBufferView(std::move(tdata), kGLTFArrayBuffer);
+      attributes["TANGENT"] = AddAccessor(bv, quantize ? kGLTFByte : kGLTFFloat, quantize, nverts, "VEC4");
+    } else {
+      PUSH_WARN(fmt::format("Skip exporting tangents. {}: {}", reason, mesh.abs_path));
+    }
+  }
+
+  //
+  // TEXCOORD_n
+  //
+  // key = texcoord primvar name, value = TEXCOORD_n index
+  std::map<std::string, int> texcoord_indices;
+  {
+    // Sort by slot id, and assign contiguous TEXCOORD_n.
+    std::vector<uint32_t> slots;
+    for (const auto &it : mesh.texcoords) {
+      slots.push_back(it.first);
+    }
+    std::sort(slots.begin(), slots.end());
+
+    uint32_t n = 0;
+    for (uint32_t slot : slots) {
+      const VertexAttribute &attr = mesh.texcoords.at(slot);
+      const uint8_t *borrowed{nullptr};
+      std::vector<uint8_t> texcoords;
+      std::string reason;
+      if ((attr.format != VertexAttributeFormat::Vec2) || (attr.elementSize != 1)) {
+        PUSH_WARN(fmt::format("texcoord must be float2. Skip exporting texcoord slot {}: {}", slot, mesh.abs_path));
+        continue;
+      }
+      if (!GatherVertexData(attr.data.data(), attr.vertex_count(), sizeof(vec2), attr.variability, layout, &borrowed, &texcoords, &reason)) {
+        PUSH_WARN(fmt::format("Skip exporting texcoord slot {}. {}: {}", slot, reason, mesh.abs_path));
+        continue;
+      }
+
+      std::string name = "TEXCOORD_" + std::to_string(n);
+      if (mesh.texcoordSlotIdMap.count(uint64_t(slot))) {
+        texcoord_indices[mesh.texcoordSlotIdMap.at(uint64_t(slot))] = int(n);
+      }
+
+      if (!_config.flip_texcoord_v && !_config.quantize_texcoords && borrowed) {
+        int bv = _bin.AddBufferView(borrowed, nverts * sizeof(vec2), kGLTFArrayBuffer);
+        attributes[name] = AddAccessor(bv, kGLTFFloat, false, nverts, "VEC2");
+        n++;
+        continue;
+      }
+
+      if (borrowed) {
+        texcoords.assign(borrowed, borrowed + nverts * sizeof(vec2));
+      }
+
+      bool in_unit_range = true;
+      for (size_t v = 0; v < nverts; v++) {
+        vec2 uv = LoadAt<vec2>(texcoords.data(), v * sizeof(vec2));
+        if (_config.flip_texcoord_v) {
+          uv[1] = 1.0f - uv[1];
+          StoreAt(texcoords, v * sizeof(vec2), uv);
+        }
+        in_unit_range &= (uv[0] >= 0.0f) && (uv[0] <= 1.0f) &&
+                         (uv[1] >= 0.0f) && (uv[1] <= 1.0f);
+      }
+
+      if (_config.quantize_texcoords && in_unit_range) {
+        std::vector<uint8_t> qdata(nverts * 4);
+        for (size_t v = 0; v < nverts; v++) {
+          vec2 uv = LoadAt<vec2>(texcoords.data(), v * sizeof(vec2));
+          StoreAt(qdata, v * 4, uint16_t(std::lround(uv[0] * 65535.0f)));
+          StoreAt(qdata, v * 4 + 2, uint16_t(std::lround(uv[1] * 65535.0f)));
+        }
+        int bv = _bin.AddBufferView(std::move(qdata), kGLTFArrayBuffer);
+        attributes[name] = AddAccessor(bv, kGLTFUnsignedShort, true, nverts, "VEC2");
+        _use_mesh_quantization = true;
+      } else {
+        int bv = _bin.AddBufferView(std::move(texcoords), kGLTFArrayBuffer);
+        attributes[name] = AddAccessor(bv, kGLTFFloat, false, nverts, "VEC2");
+      }
+      n++;
+    }
+  }
+
+  //
+  // COLOR_0
+  //
+  if (!mesh.vertex_colors.empty()) {
+    if (mesh.vertex_opacities.empty()) {
+      int acc = AddVertexAttribute(mesh, mesh.vertex_colors, "vertex_colors", layout, VertexAttributeFormat::Vec3);
+      if (acc >= 0) {
+        attributes["COLOR_0"] = acc;
+      }
+    } else {
+      // Combine colors and opacities into float4.
+      const uint8_t *cborrowed{nullptr};
+      const uint8_t *oborrowed{nullptr};
+      std::vector<uint8_t> colors;
+      std::vector<uint8_t> opacities;
+      std::string reason;
+      if ((mesh.vertex_colors.format == VertexAttributeFormat::Vec3) &&
+          (mesh.vertex_opacities.format == VertexAttributeFormat::Float) &&
+          GatherVertexData(mesh.vertex_colors.data.data(), mesh.vertex_colors.vertex_count(), sizeof(vec3), mesh.vertex_colors.variability, layout, &cborrowed, &colors, &reason) &&
+          GatherVertexData(mesh.vertex_opacities.data.data(), mesh.vertex_opacities.vertex_count(), sizeof(float), mesh.vertex_opacities.variability, layout, &oborrowed, &opacities, &reason)) {
+        const uint8_t *cdata = cborrowed ? cborrowed : colors.data();
+        const uint8_t *odata = oborrowed ? oborrowed : opacities.data();
+        std::vector<uint8_t> rgba(nverts * sizeof(vec4));
+        for (size_t v = 0; v < nverts; v++) {
+          vec3 c = LoadAt<vec3>(cdata, v * sizeof(vec3));
+          float o = LoadAt<float>(odata, v * sizeof(float));
+          vec4 c4 = {c[0], c[1], c[2], o};
+          StoreAt(rgba, v * sizeof(vec4), c4);
+        }
+        int bv = _bin.AddBufferView(std::move(rgba), kGLTFArrayBuffer);
+        attributes["COLOR_0"] = AddAccessor(bv, kGLTFFloat, false, nverts, "VEC4");
+      } else {
+        PUSH_WARN(fmt::format("Skip exporting vertex colors. {}: {}", reason, mesh.abs_path));
+      }
+    }
+  }
+
+  //
+  // JOINTS_n, WEIGHTS_n
+  //
+  if (skinned) {
+    const JointAndWeight &jw = mesh.joint_and_weights;
+    const size_t elementSize = size_t(std::max(1, jw.elementSize));
+    if ((jw.jointIndices.size() != layout.num_points * elementSize) ||
+        (jw.jointWeights.size() != layout.num_points * elementSize)) {
+      PUSH_WARN(fmt::format("jointIndices/jointWeights size mismatch. Skip exporting skin weights: {}", mesh.abs_path));
+    } else {
+      int max_joint = 0;
+      for (int j : jw.jointIndices) {
+        max_joint = std::max(max_joint, j);
+      }
+      const bool u8 = max_joint < 256;
+      const size_t joint_bytes = u8 ? 1 : 2;
+
+      const size_t num_sets = (elementSize + 3) / 4;
+      std::vector<std::vector<uint8_t>> joints(num_sets);
+      std::vector<std::vector<uint8_t>> weights(num_sets);
+      for (size_t s = 0; s < num_sets; s++) {
+        joints[s].assign(nverts * 4 * joint_bytes, 0);
+        weights[s].assign(nverts * 4 * sizeof(float), 0);
+      }
+
+      for (size_t v = 0; v < nverts; v++) {
+        size_t p = layout.point_index(v);
+
+        // glTF requires normalized weights.
+        double sum = 0.0;
+        for (size_t k = 0; k < elementSize; k++) {
+          if (jw.jointIndices[p * elementSize + k] >= 0) {
+            sum += double(std::max(0.0f, jw.jointWeights[p * elementSize + k]));
+          }
+        }
+
+        for (size_t k = 0; k < elementSize; k++) {
+          int j = jw.jointIndices[p * elementSize + k];
+          float w = (j >= 0) ? std::max(0.0f, jw.jointWeights[p * elementSize + k]) : 0.0f;
+          if (sum > 0.0) {
+            w = float(double(w) / sum);
+          } else {
+            w = (k == 0) ? 1.0f : 0.0f;
+          }
+          if (j < 0) {
+            j = 0;
+          }
+
+          size_t s = k / 4;
+          size_t c = k % 4;
+          if (u8) {
+            joints[s][(v * 4 + c)] = uint8_t(j);
+          } else {
+            StoreAt(joints[s], (v * 4 + c) * 2, uint16_t(j));
+          }
+          StoreAt(weights[s], (v * 4 + c) * sizeof(float), w);
+        }
+      }
+
+      for (size_t s = 0; s < num_sets; s++) {
+        int jbv = _bin.AddBufferView(std::move(joints[s]), kGLTFArrayBuffer);
+        attributes["JOINTS_" + std::to_string(s)] =
+            AddAccessor(jbv, u8 ? kGLTFUnsignedByte : kGLTFUnsignedShort, false, nverts, "VEC4");
+        int wbv = _bin.AddBufferView(std::move(weights[s]), kGLTFArrayBuffer);
+        attributes["WEIGHTS_" + std::to_string(s)] =
+            AddAccessor(wbv, kGLTFFloat, false, nverts, "VEC4");
+      }
+    }
+  }
+
+  //
+  // Primitives. One primitive per GeomSubset(per-face material) and one for
+  // the remaining faces.
+  //
+  std::vector<int> faceToPrim(fvCounts.size(), -1);
+  std::vector<int> primMaterials;
+  std::vector<std::string> primNames;
+
+  for (const auto &it : mesh.material_subsetMap) {
+    const MaterialSubset &subset = it.second;
+
+    std::vector<int> faces;
+    if (mesh.is_triangulated() && subset.triangulatedIndices.empty() &&
+        (mesh.triangulatedFaceCounts.size() > 0)) {
+      // Map USD face indices to triangulated face indices.
+      std::vector<size_t> triOffsets(mesh.triangulatedFaceCounts.size() + 1, 0);
+      for (size_t f = 0; f < mesh.triangulatedFaceCounts.size(); f++) {
+        triOffsets[f + 1] = triOffsets[f] + mesh.triangulatedFaceCounts[f];
+      }
+      for (int f : subset.usdIndices) {
+        if ((f >= 0) && (size_t(f) < mesh.triangulatedFaceCounts.size())) {
+          for (size_t t = triOffsets[size_t(f)]; t < triOffsets[size_t(f) + 1]; t++) {
+            faces.push_back(int(t));
+          }
+        }
+      }
+    } else {
+      faces = subset.indices();
+    }
+
+    int prim_id = int(primMaterials.size());
+    bool used = false;
+    for (int f : faces) {
+      if ((f >= 0) && (size_t(f) < faceToPrim.size()) && (faceToPrim[size_t(f)] < 0)) {
+        faceToPrim[size_t(f)] = prim_id;
+        used = true;
+      }
+    }
+
+    if (used) {
+      primMaterials.push_back(subset.material_id);
+      primNames.push_back(it.first);
+    }
+  }
+
+  bool has_remaining = false;
+  for (size_t f = 0; f < faceToPrim.size(); f++) {
+    if (faceToPrim[f] < 0) {
+      faceToPrim[f] = int(primMaterials.size());
+      has_remaining = true;
+    }
+  }
+  if (has_remaining) {
+    primMaterials.push_back(mesh.material_id);
+    primNames.push_back(std::string());
+  }
+
+  std::vector<std::vector<uint32_t>> primIndices(primMaterials.size());
+  for (size_t f = 0; f < fvCounts.size(); f++) {
+    // Fan triangulation for non-triangle faces.
+    std::vector<uint32_t> &dst = primIndices[size_t(faceToPrim[f])];
+    size_t offset = faceOffsets[f];
+    for (size_t k = 1; (k + 1) < fvCounts[f]; k++) {
+      size_t corners[3] = {offset, offset + k, offset + k + 1};
+      for (size_t c : corners) {
+        dst.push_back(layout.expanded ? uint32_t(c) : fvIndices[c]);
+      }
+    }
+  }
+
+  // Index value must not be the maximum value of the component type.
+  const bool u16_indices = nverts < 65535;
+
+  json primitives = json::array();
+  for (size_t p = 0; p < primIndices.size(); p++) {
+    const std::vector<uint32_t> &indices = primIndices[p];
+    if (indices.empty()) {
+      continue;
+    }
+
+    int bv{-1};
+    if (u16_indices) {
+      std::vector<uint8_t> idata(indices.size() * sizeof(uint16_t));
+      for (size_t i = 0; i < indices.size(); i++) {
+        StoreAt(idata, i * sizeof(uint16_t), uint16_t(indices[i]));
+      }
+      bv = _bin.AddBufferView(std::move(idata), kGLTFElementArrayBuffer);
+    } else {
+      std::vector<uint8_t> idata(indices.size() * sizeof(uint32_t));
+      memcpy(idata.data(), indices.data(), idata.size());
+      bv = _bin.AddBufferView(std::move(idata), kGLTFElementArrayBuffer);
+    }
+
+    json prim;
+    prim["attributes"] = attributes;
+    prim["indices"] = AddAccessor(bv, u16_indices ? kGLTFUnsignedShort : kGLTFUnsignedInt, false, indices.size(), "SCALAR");
+    if ((primMaterials[p] >= 0) && (size_t(primMaterials[p]) < _scene.materials.size())) {
+      prim["material"] = primMaterials[p];
+      if (mesh.doubleSided) {
+        _material_double_sided[size_t(primMaterials[p])] = true;
+      }
+
+      // glTF material refers TEXCOORD_n by index, so it cannot differ
+      // between meshes which share the material.
+      auto &material_texcoords = _material_texcoords[size_t(primMaterials[p])];
+      for (const auto &it : texcoord_indices) {
+        auto mit = material_texcoords.find(it.first);
+        if (mit == material_texcoords.end()) {
+          material_texcoords[it.first] = it.second;
+        } else if (mit->second != it.second) {
+          PUSH_WARN(fmt::format("texcoord `{}` is TEXCOORD_{} in the mesh, but TEXCOORD_{} in other mesh which uses the same material: {}", it.first, it.second, mit->second, mesh.abs_path));
+        }
+      }
+    }
+    if (primNames[p].size()) {
+      prim["extras"]["name"] = primNames[p];
+    }
+    primitives.push_back(prim);
+  }
+
+  if (primitives.empty()) {
+    PUSH_WARN(fmt::format("No triangles in the mesh. Skip exporting it: {}", mesh.abs_path));
+    return true;
+  }
+
+  json m;
+  m["name"] = mesh.prim_name;
+  m["primitives"] = primitives;
+
+  _mesh_map[mesh_id] = int(_meshes.size());
+  _meshes.push_back(m);
+
+  return true;
+}
+
+void GLBExporter::AddChildNode(int parent, int child) {
+  if (parent >= 0) {
+    _nodes[size_t(parent)].children.push_back(child);
+  } else if (_root_node >= 0) {
+    _nodes[size_t(_root_node)].children.push_back(child);
+  } else {
+    _scene_roots.push_back(child);
+  }
+}
+
+int GLBExporter::CreateJointNode(const SkelNode &skel_node,
+                                 std::vector<int> &joints,
+                                 std::map<std::string, int> &joint_map,
+                                 bool *ok) {
+  int idx = int(_nodes.size());
+  _nodes.emplace_back();
+
+  GLTFNode &node = _nodes.back();
+  if (skel_node.joint_name.size()) {
+    node.name = skel_node.joint_name;
+  } else {
+    // Use the leaf of joint path(e.g. "root/head" -> "head")
+    size_t pos = skel_node.joint_path.find_last_of('/');
+    node.name = (pos == std::string::npos) ? skel_node.joint_path
+                                           : skel_node.joint_path.substr(pos + 1);
+  }
+  // Joints may be animated, so use TRS.
+  DecomposeTRS(skel_node.rest_transform, &node);
+
+  if ((skel_node.joint_id < 0) || (size_t(skel_node.joint_id) >= joints.size()) ||
+      (joints[size_t(skel_node.joint_id)] >= 0)) {
+    (*ok) = false;
+  } else {
+    joints[size_t(skel_node.joint_id)] = idx;
+  }
+  joint_map[skel_node.joint_path] = idx;
+
+  for (const auto &child : skel_node.children) {
+    int child_idx = CreateJointNode(child, joints, joint_map, ok);
+    _nodes[size_t(idx)].children.push_back(child_idx);
+  }
+
+  return idx;
+}
+
+void GLBExporter::AddAnimationChannels(const AnimationChannel &channel,
+                                       int node, json &samplers,
+                                       json &channels) {
+  std::string *warn = &_warn;
+
+  const double tcps = (_scene.meta.timeCodesPerSecond > 0.0)
+                          ? _scene.meta.timeCodesPerSecond
+                          : 24.0;
+
+  // Returns input accessor id.
+  auto add_times = [&](const std::vector<float> &times) {
+    std::vector<uint8_t> data(times.size() * sizeof(float));
+    std::vector<double> tmin(1, std::numeric_limits<double>::infinity());
+    std::vector<double> tmax(1, -std::numeric_limits<double>::infinity());
+    for (size_t i = 0; i < times.size(); i++) {
+      float t = float(double(times[i]) / tcps);
+      StoreAt(data, i * sizeof(float), t);
+      tmin[0] = std::min(tmin[0], double(t));
+      tmax[0] = std::max(tmax[0], double(t));
+    }
+    int bv = _bin.AddBufferView(std::move(data), 0);
+    return AddAccessor(bv, kGLTFFloat, false, times.size(), "SCALAR", &tmin, &tmax);
+  };
+
+  auto add_channel = [&](int input, int output, bool step, const char *path) {
+    json sampler;
+    sampler["input"] = input;
+    sampler["output"] = output;
+    sampler["interpolation"] = step ? "STEP" : "LINEAR";
+    samplers.push_back(sampler);
+
+    json ch;
+    ch["sampler"] = int(samplers.size()) - 1;
+    ch["target"]["node"] = node;
+    ch["target"]["path"] = path;
+    channels.push_back(ch);
+  };
+
+  GLTFNode &gnode = _nodes[size_t(node)];
+
+  // static value overrides the rest pose.
+  if (channel.translations.static_value) {
+    const vec3 &t = channel.translations.static_value.value();
+    gnode.translation = {{double(t[0]), double(t[1]), double(t[2])}};
+  }
+  if (channel.rotations.static_value) {
+    const quat &r = channel.rotations.static_value.value();
+    gnode.rotation = {{double(r[0]), double(r[1]), double(r[2]), double(r[3])}};
+  }
+  if (channel.scales.static_value) {
+    const vec3 &s = channel.scales.static_value.value();
+    gnode.scale = {{double(s[0]), double(s[1]), double(s[2])}};
+  }
+
+  if (channel.translations.samples.size()) {
+    std::vector<float> times;
+    std::vector<uint8_t> values(channel.translations.samples.size() * sizeof(vec3));
+    for (size_t i = 0; i < channel.translations.samples.size(); i++) {
+      times.push_back(channel.translations.samples[i].t);
+      StoreAt(values, i * sizeof(vec3), channel.translations.samples[i].value);
+    }
+    int input = add_times(times);
+    int bv = _bin.AddBufferView(std::move(values), 0);
+    int output = AddAccessor(bv, kGLTFFloat, false, times.size(), "VEC3");
+    add_channel(input, output, channel.translations.interpolation == AnimationSampler<vec3>::Interpolation::Step, "translation");
+  }
+
+  if (channel.rotations.samples.size()) {
+    std::vector<float> times;
+    std::vector<uint8_t> values(channel.rotations.samples.size() * sizeof(quat));
+    for (size_t i = 0; i < channel.rotations.samples.size(); i++) {
+      times.push_back(channel.rotations.samples[i].t);
+      StoreAt(values, i * sizeof(quat), channel.rotations.samples[i].value);
+    }
+    int input = add_times(times);
+    int bv = _bin.AddBufferView(std::move(values), 0);
+    int output = AddAccessor(bv, kGLTFFloat, false, times.size(), "VEC4");
+    add_channel(input, output, channel.rotations.interpolation == AnimationSampler<quat>::Interpolation::Step, "rotation");
+  }
+
+  if (channel.scales.samples.size()) {
+    std::vector<float> times;
+    std::vector<uint8_t> values(channel.scales.samples.size() * sizeof(vec3));
+    for (size_t i = 0; i < channel.scales.samples.size(); i++) {
+      times.push_back(channel.scales.samples[i].t);
+      StoreAt(values, i * sizeof(vec3), channel.scales.samples[i].value);
+    }
+    int input = add_times(times);
+    int bv = _bin.AddBufferView(std::move(values), 0);
+    int output = AddAccessor(bv, kGLTFFloat, false, times.size(), "VEC3");
+    add_channel(input, output, channel.scales.interpolation == AnimationSampler<vec3>::Interpolation::Step, "scale");
+  }
+
+  if (channel.transforms.samples.size() || channel.transforms.static_value) {
+    PUSH_WARN("Matrix animation channel is not supported in glTF export.");
+  }
+}
+
+int GLBExporter::GetOrCreateSkin(int skel_id, int parent) {
+  std::string *warn = &_warn;
+
+  if (_skin_map.count(skel_id)) {
+    return _skin_map.at(skel_id);
+  }
+
+  const SkelHierarchy &skel = _scene.skeletons[size_t(skel_id)];
+
+  // Count joints.
+  size_t num_joints = 0;
+  {
+    std::vector<const SkelNode *> stack{&skel.root_node};
+    while (!stack.empty()) {
+      const SkelNode *n = stack.back();
+      stack.pop_back();
+      num_joints++;
+      for (const auto &c : n->children) {
+        stack.push_back(&c);
+      }
+    }
+  }
+
+  std::vector<int> joints(num_joints, -1);
+  std::map<std::string, int> joint_map;
+  bool ok = true;
+  int root_joint = CreateJointNode(skel.root_node, joints, joint_map, &ok);
+  AddChildNode(parent, root_joint);
+
+  if (!ok || (std::find(joints.begin(), joints.end(), -1) != joints.end())) {
+    PUSH_WARN(fmt::format("Invalid joint ids in Skeleton. Skin is not exported: {}", skel.abs_path));
+    _skin_map[skel_id] = -1;
+    return -1;
+  }
+
+  // inverseBindMatrices
+  std::vector<uint8_t> ibm(num_joints * 16 * sizeof(float));
+  {
+    std::vector<const SkelNode *> stack{&skel.root_node};
+    while (!stack.empty()) {
+      const SkelNode *n = stack.back();
+      stack.pop_back();
+
+      std::array<double, 16> m = ToGLTFMatrix(inverse(n->bind_transform));
+      for (size_t k = 0; k < 16; k++) {
+        StoreAt(ibm, (size_t(n->joint_id) * 16 + k) * sizeof(float), float(m[k]));
+      }
+
+      for (const auto &c : n->children) {
+        stack.push_back(&c);
+      }
+    }
+  }
+  int bv = _bin.AddBufferView(std::move(ibm), 0);
+  int ibm_acc = AddAccessor(bv, kGLTFFloat, false, num_joints, "MAT4");
+
+  json skin;
+  skin["name"] = skel.prim_name;
+  skin["joints"] = joints;
+  skin["skeleton"] = root_joint;
+  skin["inverseBindMatrices"] = ibm_acc;
+
+  int skin_id = int(_skins.size());
+  _skins.push_back(skin);
+  _skin_map[skel_id] = skin_id;
+
+  if (_config.export_animations && (skel.anim_id >= 0) &&
+      (size_t(skel.anim_id) < _scene.animations.size())) {
+    const Animation &anim = _scene.animations[size_t(skel.anim_id)];
+
+    json samplers = json::array();
+    json channels = json::array();
+    for (const auto &it : anim.channels_map) {
+      if (!joint_map.count(it.first)) {
+        PUSH_WARN(fmt::format("Joint `{}` not found in Skeleton: {}", it.first, skel.abs_path));
+        continue;
+      }
+      int node = joint_map.at(it.first);
+      for (const auto &ch : it.second) {
+        AddAnimationChannels(ch.second, node, samplers, channels);
+      }
+    }
+
+    if (anim.blendshape_weights_map.size()) {
+      PUSH_WARN(fmt::format("BlendShape animation is not exported: {}", anim.abs_path));
+    }
+
+    if (channels.size()) {
+      json a;
+      a["name"] = anim.prim_name;
+      a["samplers"] = samplers;
+      a["channels"] = channels;
+      _animations.push_back(a);
+    }
+  }
+
+  return skin_id;
+}
+
+int GLBExporter::ExportNode(const Node &node, int parent) {
+  int idx = int(_nodes.size());
+  _nodes.emplace_back();
+  AddChildNode(parent, idx);
+
+  _node_path_map[node.abs_path] = idx;
+
+  {
+    GLTFNode &gnode = _nodes.back();
+    gnode.name = node.prim_name;
+
+    bool animated = _config.export_animations && node.node_animations.size();
+    if (animated) {
+      DecomposeTRS(node.local_matrix, &gnode);
+    } else if (!is_identity(node.local_matrix)) {
+      gnode.has_matrix = true;
+      gnode.matrix = ToGLTFMatrix(node.local_matrix);
+    }
+  }
+
+  if ((node.nodeType == NodeType::Mesh) && (node.id >= 0) &&
+      (size_t(node.id) < _mesh_map.size()) && (_mesh_map[size_t(node.id)] >= 0)) {
+    const RenderMesh &mesh = _scene.meshes[size_t(node.id)];
+    const MeshDequantization &dq = _mesh_dequant[size_t(node.id)];
+
+    if (dq.enabled) {
+      int qidx = int(_nodes.size());
+      _nodes.emplace_back();
+      GLTFNode &qnode = _nodes.back();
+      qnode.name = node.prim_name + "_dequantize";
+      qnode.has_trs = true;
+      qnode.translation = dq.translation;
+      qnode.scale = {{dq.scale, dq.scale, dq.scale}};
+      qnode.mesh = _mesh_map[size_t(node.id)];
+      _nodes[size_t(idx)].children.push_back(qidx);
+    } else {
+      _nodes[size_t(idx)].mesh = _mesh_map[size_t(node.id)];
+    }
+
+    if (_config.export_skins && (mesh.skel_id >= 0) &&
+        (size_t(mesh.skel_id) < _scene.skeletons.size())) {
+      // Skin is created after all nodes are exported, since the Skeleton
+      // node may appear after the skinned mesh node.
+      _skinned_nodes.push_back({idx, parent, mesh.skel_id});
+    }
+  }
+
+  if (_config.export_animations) {
+    for (const auto &channel : node.node_animations) {
+      AddAnimationChannels(channel, idx, _node_anim_samplers, _node_anim_channels);
+    }
+  }
+
+  for (const auto &child : node.children) {
+    ExportNode(child, idx);
+  }
+
+  return idx;
+}
+
+bool GLBExporter::Export(std::vector<uint8_t> &glb) {
+  std::string *err = &_err;
+
+  if (!ExportImages()) {
+    return false;
+  }
+
+  if (!ExportTextures()) {
+    return false;
+  }
+
+  _mesh_map.assign(_scene.meshes.size(), -1);
+  _mesh_dequant.assign(_scene.meshes.size(), MeshDequantization());
+  _material_double_sided.assign(_scene.materials.size(), false);
+  _material_texcoords.assign(_scene.materials.size(), std::map<std::string, int>());
+  for (size_t i = 0; i < _scene.meshes.size(); i++) {
+    if (!ExportMesh(i)) {
+      return false;
+    }
+  }
+
+  // After ExportMesh to know doubleSided and TEXCOORD_n.
+  if (!ExportMaterials()) {
+    return false;
+  }
+
+  if (_config.convert_to_y_up_meters) {
+    bool z_up = (_scene.meta.upAxis == "Z");
+    bool scaled = (_scene.meta.metersPerUnit > 0.0) &&
+                  (std::fabs(_scene.meta.metersPerUnit - 1.0) >
+                   std::numeric_limits<double>::epsilon());
+    if (z_up || scaled) {
+      _root_node = int(_nodes.size());
+      _nodes.emplace_back();
+      _scene_roots.push_back(_root_node);
+
+      GLTFNode &root = _nodes.back();
+      root.name = "StageRoot";
+      root.has_trs = true;
+      if (z_up) {
+        // Rotate -90 degree around X axis(Z-up -> Y-up)
+        root.rotation = {{-std::sqrt(0.5), 0.0, 0.0, std::sqrt(0.5)}};
+      }
+      if (scaled) {
+        double s = _scene.meta.metersPerUnit;
+        root.scale = {{s, s, s}};
+      }
+    }
+  }
+
+  for (const auto &node : _scene.nodes) {
+    ExportNode(node, -1);
+  }
+
+  for (const auto &skinned : _skinned_nodes) {
+    // Place joints under the Skeleton node. When the Skeleton node is not
+    // found, joints are placed as the sibling of the skinned mesh node(i.e.
+    // assume Skeleton and skinned mesh are under the same parent).
+    const SkelHierarchy &skel = _scene.skeletons[size_t(skinned.skel_id)];
+    int parent = skinned.parent;
+    if (_node_path_map.count(skel.abs_path)) {
+      parent = _node_path_map.at(skel.abs_path);
+    }
+
+    int skin = GetOrCreateSkin(skinned.skel_id, parent);
+    if (skin >= 0) {
+      _nodes[size_t(skinned.node)].skin = skin;
+    }
+  }
+
+  if (_node_anim_channels.size()) {
+    json a;
+    a["name"] = "node_animations";
+    a["samplers"] = _node_anim_samplers;
+    a["channels"] = _node_anim_channels;
+    _animations.push_back(a);
+  }
+
+  //
+  // Build JSON
+  //
+  json j;
+  j["asset"]["version"] = "2.0";
+  j["asset"]["generator"] = "TinyUSDZ Tydra";
+  if (_scene.meta.copyright.size()) {
+    j["asset"]["copyright"] = _scene.meta.copyright;
+  }
+
+  std::vector<std::string> extensionsUsed;
+  std::vector<std::string> extensionsRequired;
+  if (_use_mesh_quantization) {
+    extensionsUsed.push_back("KHR_mesh_quantization");
+    extensionsRequired.push_back("KHR_mesh_quantization");
+  }
+  if (_use_texture_transform) {
+    extensionsUsed.push_back("KHR_texture_transform");
+  }
+  if (_use_materials_ior) {
+    extensionsUsed.push_back("KHR_materials_ior");
+  }
+  if (extensionsUsed.size()) {
+    j["extensionsUsed"] = extensionsUsed;
+  }
+  if (extensionsRequired.size()) {
+    j["extensionsRequired"] = extensionsRequired;
+  }
+
+  j["scene"] = 0;
+  j["scenes"] = json::array();
+  {
+    json s;
+    s["nodes"] = _scene_roots;
+    j["scenes"].push_back(s);
+  }
+
+  if (_nodes.size()) {
+    json nodes = json::array();
+    for (const auto &node : _nodes) {
+      nodes.push_back(ToJSON(node));
+    }
+    j["nodes"] = nodes;
+  }
+
+  auto set_if_not_empty = [&j](const char *key, const json &arr) {
+    if (arr.size()) {
+      j[key] = arr;
+    }
+  };
+
+  set_if_not_empty("meshes", _meshes);
+  set_if_not_empty("materials", _materials);
+  set_if_not_empty("textures", _textures);
+  set_if_not_empty("samplers", _samplers);
+  set_if_not_empty("images", _images);
+  set_if_not_empty("skins", _skins);
+  set_if_not_empty("animations", _animations);
+  set_if_not_empty("accessors", _accessors);
+  set_if_not_empty("bufferViews", _bin.buffer_views());
+
+  const size_t bin_length = Align4(_bin.byte_length());
+  if (bin_length > 0) {
+    json buffer;
+    buffer["byteLength"] = bin_length;
+    j["buffers"] = json::array({buffer});
+  }
+
+  std::string json_str = j.dump();
+  // Pad with spaces.
+  json_str.resize(Align4(json_str.size()), ' ');
+
+  //
+  // Assemble GLB
+  //
+  const size_t total = 12 + 8 + json_str.size() + ((bin_length > 0) ? (8 + bin_length) : 0);
+  if (total > size_t((std::numeric_limits<uint32_t>::max)())) {
+    PUSH_ERROR_AND_RETURN(fmt::format("GLB size {} exceeds 4GB.", total));
+  }
+
+  glb.assign(total, 0);
+
+  auto write_u32 = [&glb](size_t offset, uint32_t v) {
+    memcpy(glb.data() + offset, &v, sizeof(uint32_t));
+  };
+
+  write_u32(0, kGLBMagic);
+  write_u32(4, kGLBVersion);
+  write_u32(8, uint32_t(total));
+
+  write_u32(12, uint32_t(json_str.size()));
+  write_u32(16, kGLBChunkJSON);
+  memcpy(glb.data() + 20, json_str.data(), json_str.size());
+
+  if (bin_length > 0) {
+    size_t offset = 20 + json_str.size();
+    write_u32(offset, uint32_t(bin_length));
+    write_u32(offset + 4, kGLBChunkBIN);
+    _bin.CopyTo(glb.data() + offset + 8);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+bool export_to_glb(const RenderScene &scene, std::vector<uint8_t> &glb,
+                   std::string *warn, std::string *err,
+                   const GLBExportConfig &config) {
+  GLBExporter exporter(scene, config);
+
+  bool ret = exporter.Export(glb);
+
+  if (warn) {
+    (*warn) += exporter.GetWarning();
+  }
+
+  if (err) {
+    (*err) += exporter.GetError();
+  }
+
+  return ret;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// RenderScene -> glTF 2.0 binary(GLB) exporter
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "render-data.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+struct GLBExportConfig {
+  // Encode TextureImage(8bit, uncompressed) as PNG and store it in the BIN
+  // chunk. When false, no glTF image is exported(textures have no `source`).
+  bool export_images{true};
+
+  // USD's texture coordinate origin is bottom-left, whereas glTF's is
+  // top-left. Flip V(v' = 1 - v) of texcoords(and UsdTransform2d).
+  bool flip_texcoord_v{true};
+
+  bool export_skins{true};
+  bool export_animations{true};
+
+  // Add a root node which converts Z-up scene to Y-up(glTF) when
+  // `RenderScene::meta.upAxis` is "Z", and scales the scene to meters by
+  // `RenderScene::meta.metersPerUnit`.
+  bool convert_to_y_up_meters{true};
+
+  //
+  // Vertex attribute quantization(KHR_mesh_quantization, meshoptimizer-like
+  // encoding). `KHR_mesh_quantization` is added to `extensionsRequired` when
+  // any of the attribute is quantized.
+  //
+
+  // int16 positions. Dequantization transform is stored to the node which
+  // instantiates the mesh. Skinned mesh is not quantized(glTF ignores the
+  // transform of the skinned mesh node).
+  bool quantize_positions{false};
+
+  // Normalized int8 normals/tangents.
+  bool quantize_normals{false};
+
+  // Normalized uint16 texcoords. Only applied when all texcoords are in [0, 1].
+  bool quantize_texcoords{false};
+};
+
+///
+/// Export RenderScene to glTF 2.0 binary(GLB).
+///
+/// Nodes, meshes(per-face materials by GeomSubset are exported as primitives),
+/// materials(UsdPreviewSurface -> pbrMetallicRoughness), textures, images,
+/// skins and joint animations are exported.
+///
+/// All buffer data are packed into the single BIN chunk(each bufferView is 4
+/// bytes aligned). Vertex data which can be used as-is(e.g. `vertex`-varying
+/// points) is referenced from RenderScene and copied only once when
+/// assembling the GLB.
+///
+/// NOTE: BlendShapes, cameras and lights are not exported yet.
+///
+/// @param[in] scene RenderScene
+/// @param[out] glb GLB data
+/// @param[out] warn warning message
+/// @param[out] err error message
+/// @param[in] config Export config
+///
+/// @return true upon success.
+///
+bool export_to_glb(const RenderScene &scene, std::vector<uint8_t> &glb,
+                   std::string *warn, std::string *err,
+                   const GLBExportConfig &config = GLBExportConfig());
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,905 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// NURBS patch tessellation.
+//
+// Basis functions are evaluated once per parameter line(batch), and each row
+// of the grid is evaluated by contracting control points in v first, then in
+// u. Parameter lines are placed per knot span by recursive bisection with
+// chord and normal angle tolerance.
+//
+#include "nurbs-tess.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+
+#include "common-macros.inc"
+#include "parallel-for.hh"
+#include "tiny-format.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+#define PushError(msg) \
+  {                    \
+    if (err) {         \
+      (*err) += msg;   \
+    }                  \
+  }
+
+// Max order(degree + 1) supported.
+constexpr uint32_t kMaxOrder = 16;
+
+struct dvec3 {
+  double x{0.0}, y{0.0}, z{0.0};
+};
+
+inline dvec3 operator-(const dvec3 &a, const dvec3 &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline double dot(const dvec3 &a, const dvec3 &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline dvec3 cross(const dvec3 &a, const dvec3 &b) {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline dvec3 lerp(const dvec3 &a, const dvec3 &b, double t) {
+  return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+}
+
+// Returns false when the vector is degenerated.
+inline bool normalize(dvec3 &v) {
+  double len = std::sqrt(dot(v, v));
+  if (len < std::numeric_limits<double>::min() * 1e4) {
+    v = dvec3();
+    return false;
+  }
+  v.x /= len;
+  v.y /= len;
+  v.z /= len;
+  return true;
+}
+
+///
+/// Find the knot span index of `u`(Piegl and Tiller, A2.1).
+/// `n` = # of control points.
+///
+size_t FindSpan(size_t n, uint32_t degree, double u, const double *knots) {
+  if (u >= knots[n]) {
+    // Last non-empty span
+    size_t span = n - 1;
+    while ((span > degree) && (knots[span] >= knots[span + 1])) {
+      span--;
+    }
+    return span;
+  }
+  if (u <= knots[degree]) {
+    size_t span = degree;
+    while ((span < n - 1) && (knots[span + 1] <= u)) {
+      span++;
+    }
+    return span;
+  }
+
+  size_t low = degree;
+  size_t high = n;
+  size_t mid = (low + high) / 2;
+  while ((u < knots[mid]) || (u >= knots[mid + 1])) {
+    if (u < knots[mid]) {
+      high = mid;
+    } else {
+      low = mid;
+    }
+    mid = (low + high) / 2;
+  }
+  return mid;
+}
+
+///
+/// Non-zero basis functions N[0..degree] at `span`(Piegl and Tiller, A2.2).
+///
+void BasisFuns(size_t span, double u, uint32_t degree, const double *knots,
+               double *N) {
+  double left[kMaxOrder];
+  double right[kMaxOrder];
+
+  N[0] = 1.0;
+  for (uint32_t j = 1; j <= degree; j++) {
+    left[j] = u - knots[span + 1 - j];
+    right[j] = knots[span + j] - u;
+    double saved = 0.0;
+    for (uint32_t r = 0; r < j; r++) {
+      double denom = right[r + 1] + left[j - r];
+      double temp = (denom != 0.0) ? (N[r] / denom) : 0.0;
+      N[r] = saved + right[r + 1] * temp;
+      saved = left[j - r] * temp;
+    }
+    N[j] = saved;
+  }
+}
+
+///
+/// Non-zero basis functions and their first derivatives.
+///
+void BasisFunsDerivs(size_t span, double u, uint32_t degree,
+                     const double *knots, double *N, double *dN) {
+  BasisFuns(span, u, degree, knots, N);
+
+  if (degree == 0) {
+    dN[0] = 0.0;
+    return;
+  }
+
+  // Basis of degree - 1
+  double Nl[kMaxOrder];
+  BasisFuns(span, u, degree - 1, knots, Nl);
+
+  const double p = double(degree);
+  for (uint32_t k = 0; k <= degree; k++) {
+    size_t i = span - degree + k;
+    double a = (k >= 1) ? Nl[k - 1] : 0.0;
+    double b = (k < degree) ? Nl[k] : 0.0;
+    double d1 = knots[i + degree] - knots[i];
+    double d2 = knots[i + degree + 1] - knots[i + 1];
+    dN[k] = p * (((d1 > 0.0) ? (a / d1) : 0.0) - ((d2 > 0.0) ? (b / d2) : 0.0));
+  }
+}
+
+///
+/// Basis functions of parameter lines.
+///
+struct ParamBasis {
+  uint32_t order{0};
+  std::vector<size_t> spans;
+  std::vector<double> N;   // order * # of params
+  std::vector<double> dN;  // order * # of params
+};
+
+void ComputeParamBasis(const std::vector<double> &params, size_t n,
+                       uint32_t degree, const double *knots,
+                       ParamBasis *basis) {
+  basis->order = degree + 1;
+  basis->spans.resize(params.size());
+  basis->N.resize(params.size() * basis->order);
+  basis->dN.resize(params.size() * basis->order);
+  for (size_t i = 0; i < params.size(); i++) {
+    basis->spans[i] = FindSpan(n, degree, params[i], knots);
+    BasisFunsDerivs(basis->spans[i], params[i], degree, knots,
+                    &basis->N[i * basis->order], &basis->dN[i * basis->order]);
+  }
+}
+
+struct Patch {
+  size_t nu{0};
+  size_t nv{0};
+  uint32_t pu{0};  // degree
+  uint32_t pv{0};
+  const double *uknots{nullptr};
+  const double *vknots{nullptr};
+  double u0{0.0}, u1{0.0};
+  double v0{0.0}, v1{0.0};
+
+  // Homogeneous control points(xw, yw, zw, w)
+  std::vector<double> cw;
+};
+
+///
+/// Position and normal from the homogeneous point and its derivatives.
+/// Returns false when the normal is degenerated.
+///
+bool ProjectRational(const double A[4], const double Au[4], const double Av[4],
+                     dvec3 *P, dvec3 *N) {
+  double iw = 1.0 / A[3];
+  P->x = A[0] * iw;
+  P->y = A[1] * iw;
+  P->z = A[2] * iw;
+
+  dvec3 Su{(Au[0] - Au[3] * P->x) * iw, (Au[1] - Au[3] * P->y) * iw,
+           (Au[2] - Au[3] * P->z) * iw};
+  dvec3 Sv{(Av[0] - Av[3] * P->x) * iw, (Av[1] - Av[3] * P->y) * iw,
+           (Av[2] - Av[3] * P->z) * iw};
+  *N = cross(Su, Sv);
+  return normalize(*N);
+}
+
+bool EvalPatch(const Patch &patch, double u, double v, dvec3 *P, dvec3 *N) {
+  double Nu[kMaxOrder], dNu[kMaxOrder];
+  double Nv[kMaxOrder], dNv[kMaxOrder];
+
+  size_t su = FindSpan(patch.nu, patch.pu, u, patch.uknots);
+  size_t sv = FindSpan(patch.nv, patch.pv, v, patch.vknots);
+  BasisFunsDerivs(su, u, patch.pu, patch.uknots, Nu, dNu);
+  BasisFunsDerivs(sv, v, patch.pv, patch.vknots, Nv, dNv);
+
+  double A[4] = {0.0, 0.0, 0.0, 0.0};
+  double Au[4] = {0.0, 0.0, 0.0, 0.0};
+  double Av[4] = {0.0, 0.0, 0.0, 0.0};
+  for (uint32_t l = 0; l <= patch.pv; l++) {
+    size_t row = sv - patch.pv + l;
+    for (uint32_t k = 0; k <= patch.pu; k++) {
+      const double *c = &patch.cw[4 * (row * patch.nu + su - patch.pu + k)];
+      double w = Nu[k] * Nv[l];
+      double wu = dNu[k] * Nv[l];
+      double wv = Nu[k] * dNv[l];
+      for (size_t c4 = 0; c4 < 4; c4++) {
+        A[c4] += w * c[c4];
+        Au[c4] += wu * c[c4];
+        Av[c4] += wv * c[c4];
+      }
+    }
+  }
+
+  return ProjectRational(A, Au, Av, P, N);
+}
+
+///
+/// Evaluate one row(v = const) of the grid.
+///
+void EvalRow(const Patch &patch, const ParamBasis &ub, const ParamBasis &vb,
+             size_t j, std::vector<double> &R, std::vector<double> &Rv,
+             dvec3 *P, dvec3 *N, uint8_t *valid) {
+  // Contract control points in v.
+  R.assign(patch.nu * 4, 0.0);
+  Rv.assign(patch.nu * 4, 0.0);
+  size_t sv = vb.spans[j];
+  const double *Nv = &vb.N[j * vb.order];
+  const double *dNv = &vb.dN[j * vb.order];
+  for (uint32_t l = 0; l <= patch.pv; l++) {
+    const double *c = &patch.cw[4 * ((sv - patch.pv + l) * patch.nu)];
+    for (size_t i = 0; i < patch.nu * 4; i++) {
+      R[i] += Nv[l] * c[i];
+      Rv[i] += dNv[l] * c[i];
+    }
+  }
+
+  // Then in u.
+  for (size_t i = 0; i < ub.spans.size(); i++) {
+    size_t su = ub.spans[i];
+    const double *Nu = &ub.N[i * ub.order];
+    const double *dNu = &ub.dN[i * ub.order];
+    double A[4] = {0.0, 0.0, 0.0, 0.0};
+    double Au[4] = {0.0, 0.0, 0.0, 0.0};
+    double Av[4] = {0.0, 0.0, 0.0, 0.0};
+    for (uint32_t k = 0; k <= patch.pu; k++) {
+      const double *r = &R[4 * (su - patch.pu + k)];
+      const double *rv = &Rv[4 * (su - patch.pu + k)];
+      for (size_t c4 = 0; c4 < 4; c4++) {
+        A[c4] += Nu[k] * r[c4];
+        Au[c4] += dNu[k] * r[c4];
+        Av[c4] += Nu[k] * rv[c4];
+      }
+    }
+    valid[i] = ProjectRational(A, Au, Av, &P[i], &N[i]) ? 1 : 0;
+  }
+}
+
+bool ValidateKnots(const std::vector<double> &knots, size_t n, uint32_t order,
+                   const char *name, std::string *err) {
+  if ((order < 2) || (order > kMaxOrder)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("{}Order must be in range [2, {}], but got {}.", name,
+                    kMaxOrder, order));
+  }
+  if (n < order) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "{}VertexCount must be >= {}Order, but got {}.", name, name, n));
+  }
+  if (knots.size() != (n + order)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("{}Knots.size must be {}, but got {}.", name, n + order,
+                    knots.size()));
+  }
+  for (size_t i = 1; i < knots.size(); i++) {
+    if (!std::isfinite(knots[i]) || (knots[i] < knots[i - 1])) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("{}Knots must be finite and non-decreasing.", name));
+    }
+  }
+  if (!(knots[order - 1] < knots[n])) {
+    PUSH_ERROR_AND_RETURN(fmt::format("{}Knots has empty range.", name));
+  }
+  return true;
+}
+
+bool SetupPatch(const Nurbs &nurbs, Patch *patch, std::string *err) {
+  if (!ValidateKnots(nurbs.u_knots, nurbs.u_vertex_count, nurbs.u_order, "u",
+                     err)) {
+    return false;
+  }
+  if (!ValidateKnots(nurbs.v_knots, nurbs.v_vertex_count, nurbs.v_order, "v",
+                     err)) {
+    return false;
+  }
+
+  size_t n = size_t(nurbs.u_vertex_count) * size_t(nurbs.v_vertex_count);
+  if (nurbs.points.size() != n) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "points.size must be uVertexCount * vVertexCount({}), but got {}.", n,
+        nurbs.points.size()));
+  }
+  if (nurbs.point_weights.size() && (nurbs.point_weights.size() != n)) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "pointWeights.size must be {}, but got {}.", n,
+        nurbs.point_weights.size()));
+  }
+
+  patch->nu = nurbs.u_vertex_count;
+  patch->nv = nurbs.v_vertex_count;
+  patch->pu = nurbs.u_order - 1;
+  patch->pv = nurbs.v_order - 1;
+  patch->uknots = nurbs.u_knots.data();
+  patch->vknots = nurbs.v_knots.data();
+
+  patch->u0 = nurbs.u_knots[patch->pu];
+  patch->u1 = nurbs.u_knots[patch->nu];
+  if (nurbs.u_range[0] < nurbs.u_range[1]) {
+    patch->u0 = (std::max)(patch->u0, nurbs.u_range[0]);
+    patch->u1 = (std::min)(patch->u1, nurbs.u_range[1]);
+  }
+  patch->v0 = nurbs.v_knots[patch->pv];
+  patch->v1 = nurbs.v_knots[patch->nv];
+  if (nurbs.v_range[0] < nurbs.v_range[1]) {
+    patch->v0 = (std::max)(patch->v0, nurbs.v_range[0]);
+    patch->v1 = (std::min)(patch->v1, nurbs.v_range[1]);
+  }
+  if (!(patch->u0 < patch->u1) || !(patch->v0 < patch->v1)) {
+    PUSH_ERROR_AND_RETURN("Parameter range is empty.");
+  }
+
+  patch->cw.resize(n * 4);
+  for (size_t i = 0; i < n; i++) {
+    double w = nurbs.point_weights.size() ? nurbs.point_weights[i] : 1.0;
+    if (!(w > 0.0)) {
+      PUSH_ERROR_AND_RETURN("pointWeights must be positive.");
+    }
+    patch->cw[4 * i + 0] = double(nurbs.points[i][0]) * w;
+    patch->cw[4 * i + 1] = double(nurbs.points[i][1]) * w;
+    patch->cw[4 * i + 2] = double(nurbs.points[i][2]) * w;
+    patch->cw[4 * i + 3] = w;
+  }
+
+  return true;
+}
+
+// Distinct knots in the range(including range ends).
+std::vector<double> SpanBoundaries(const double *knots, size_t num_knots,
+                                   double t0, double t1) {
+  std::vector<double> ts;
+  ts.push_back(t0);
+  for (size_t i = 0; i < num_knots; i++) {
+    if ((knots[i] > ts.back()) && (knots[i] < t1)) {
+      ts.push_back(knots[i]);
+    }
+  }
+  ts.push_back(t1);
+  return ts;
+}
+
+std::vector<double> UniformParams(double t0, double t1, uint32_t divs) {
+  divs = (std::max)(1u, divs);
+  std::vector<double> ts(divs + 1);
+  for (uint32_t i = 0; i <= divs; i++) {
+    ts[i] = t0 + (t1 - t0) * (double(i) / double(divs));
+  }
+  ts[divs] = t1;
+  return ts;
+}
+
+///
+/// Adaptive parameter lines in one direction(`dir` = 0: u, 1: v).
+///
+/// Each knot span is bisected while the surface between two parameter lines
+/// deviates from the linear interpolation more than the chord tolerance, or
+/// the normal turns more than the angle tolerance, on any of iso lines in the
+/// other direction.
+///
+class AdaptiveParams {
+ public:
+  AdaptiveParams(const Patch &patch, int dir, double chord_tol, double cos_tol,
+                 uint32_t max_depth)
+      : _patch(patch),
+        _dir(dir),
+        _chord_tol2(chord_tol * chord_tol),
+        _cos_tol(cos_tol),
+        _max_depth(max_depth) {
+    // Iso lines in the other direction: span boundaries and midpoints.
+    std::vector<double> bs =
+        (dir == 0) ? SpanBoundaries(patch.vknots, patch.nv + patch.pv + 1,
+                                    patch.v0, patch.v1)
+                   : SpanBoundaries(patch.uknots, patch.nu + patch.pu + 1,
+                                    patch.u0, patch.u1);
+    for (size_t i = 0; i < bs.size(); i++) {
+      _iso.push_back(bs[i]);
+      if ((i + 1) < bs.size()) {
+        _iso.push_back(0.5 * (bs[i] + bs[i + 1]));
+      }
+    }
+  }
+
+  std::vector<double> Compute() {
+    std::vector<double> bs =
+        (_dir == 0) ? SpanBoundaries(_patch.uknots, _patch.nu + _patch.pu + 1,
+                                     _patch.u0, _patch.u1)
+                    : SpanBoundaries(_patch.vknots, _patch.nv + _patch.pv + 1,
+                                     _patch.v0, _patch.v1);
+
+    _params.clear();
+    _params.push_back(bs[0]);
+    for (size_t i = 0; (i + 1) < bs.size(); i++) {
+      Subdivide(bs[i], bs[i + 1], 0);
+    }
+    return _params;
+  }
+
+ private:
+  bool Eval(double t, double iso, dvec3 *P, dvec3 *N) const {
+    return (_dir == 0) ? EvalPatch(_patch, t, iso, P, N)
+                       : EvalPatch(_patch, iso, t, P, N);
+  }
+
+  bool NeedsSplit(double a, double b) const {
+    for (double iso : _iso) {
+      dvec3 Pa, Na, Pb, Nb;
+      bool va = Eval(a, iso, &Pa, &Na);
+      bool vb = Eval(b, iso, &Pb, &Nb);
+      if (va && vb && (dot(Na, Nb) < _cos_tol)) {
+        return true;
+      }
+
+      for (double f : {0.25, 0.5, 0.75}) {
+        dvec3 Pm, Nm;
+        Eval(a + (b - a) * f, iso, &Pm, &Nm);
+        dvec3 d = Pm - lerp(Pa, Pb, f);
+        if (dot(d, d) > _chord_tol2) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void Subdivide(double a, double b, uint32_t depth) {
+    if ((depth < _max_depth) && NeedsSplit(a, b)) {
+      double m = 0.5 * (a + b);
+      Subdivide(a, m, depth + 1);
+      Subdivide(m, b, depth + 1);
+    } else {
+      _params.push_back(b);
+    }
+  }
+
+  const Patch &_patch;
+  int _dir;
+  double _chord_tol2;
+  double _cos_tol;
+  uint32_t _max_depth;
+  std::vector<double> _iso;
+  std::vector<double> _params;
+};
+
+struct TrimEdge {
+  double u0, v0, u1, v1;
+};
+
+///
+/// Sample trimming curves to closed polylines in the parameter space.
+///
+bool BuildTrimEdges(const NurbsTrimCurves &trim, uint32_t segments_per_span,
+                    std::vector<TrimEdge> *edges, std::string *err) {
+  size_t num_curves = trim.orders.size();
+  if (trim.vertex_counts.size() != num_curves) {
+    PUSH_ERROR_AND_RETURN(
+        "trimCurve:orders and trimCurve:vertexCounts must have the same size.");
+  }
+  size_t sum_counts = 0;
+  for (int c : trim.counts) {
+    if (c < 1) {
+      PUSH_ERROR_AND_RETURN("trimCurve:counts must be >= 1.");
+    }
+    sum_counts += size_t(c);
+  }
+  if (sum_counts != num_curves) {
+    PUSH_ERROR_AND_RETURN(
+        "sum(trimCurve:counts) must be equal to the number of trim curves.");
+  }
+  if (trim.ranges.size() && (trim.ranges.size() != num_curves)) {
+    PUSH_ERROR_AND_RETURN(
+        "trimCurve:ranges.size must be equal to the number of trim curves.");
+  }
+
+  segments_per_span = (std::max)(1u, segments_per_span);
+
+  size_t curve = 0;
+  size_t point_offset = 0;
+  size_t knot_offset = 0;
+  for (int count : trim.counts) {
+    std::vector<value::double2> loop;
+
+    for (int c = 0; c < count; c++, curve++) {
+      int order = trim.orders[curve];
+      int n = trim.vertex_counts[curve];
+      if ((order < 2) || (order > int(kMaxOrder)) || (n < order)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Invalid order or vertexCount of trim curve[{}].",
+                        curve));
+      }
+      if (((point_offset + size_t(n)) > trim.points.size()) ||
+          ((knot_offset + size_t(n + order)) > trim.knots.size())) {
+        PUSH_ERROR_AND_RETURN("Insufficient trimCurve:points or trimCurve:knots.");
+      }
+
+      const double *knots = &trim.knots[knot_offset];
+      const value::double3 *cps = &trim.points[point_offset];
+      uint32_t degree = uint32_t(order - 1);
+
+      for (int i = 1; i < n + order; i++) {
+        if (knots[i] < knots[i - 1]) {
+          PUSH_ERROR_AND_RETURN("trimCurve:knots must be non-decreasing.");
+        }
+      }
+
+      double t0 = knots[degree];
+      double t1 = knots[n];
+      if (trim.ranges.size() &&
+          (trim.ranges[curve][0] < trim.ranges[curve][1])) {
+        t0 = (std::max)(t0, trim.ranges[curve][0]);
+        t1 = (std::min)(t1, trim.ranges[curve][1]);
+      }
+      if (!(t0 < t1)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Trim curve[{}] has empty range.", curve));
+      }
+
+      std::vector<double> bs =
+          SpanBoundaries(knots, size_t(n + order), t0, t1);
+      for (size_t s = 0; (s + 1) < bs.size(); s++) {
+        for (uint32_t k = 0; k <= segments_per_span; k++) {
+          if ((k == 0) && ((s > 0) || loop.size())) {
+            // Shared with the previous sample.
+            continue;
+          }
+          double t = bs[s] + (bs[s + 1] - bs[s]) *
+                                 (double(k) / double(segments_per_span));
+          double N[kMaxOrder];
+          size_t span = FindSpan(size_t(n), degree, t, knots);
+          BasisFuns(span, t, degree, knots, N);
+          double cu = 0.0, cv = 0.0, cw = 0.0;
+          for (uint32_t j = 0; j <= degree; j++) {
+            const value::double3 &cp = cps[span - degree + j];
+            double w = N[j] * cp[2];
+            cu += w * cp[0];
+            cv += w * cp[1];
+            cw += w;
+          }
+          if (!(std::fabs(cw) > 0.0)) {
+            PUSH_ERROR_AND_RETURN("Trim curve has zero weight.");
+          }
+          loop.push_back({cu / cw, cv / cw});
+        }
+      }
+
+      point_offset += size_t(n);
+      knot_offset += size_t(n + order);
+    }
+
+    // Close the loop.
+    for (size_t i = 0; i < loop.size(); i++) {
+      const value::double2 &a = loop[i];
+      const value::double2 &b = loop[(i + 1) % loop.size()];
+      edges->push_back({a[0], a[1], b[0], b[1]});
+    }
+  }
+
+  return true;
+}
+
+struct TessOptions {
+  bool adaptive{true};
+  uint32_t u_divs{0};
+  uint32_t v_divs{0};
+  NurbsTesselatorConfig config;
+};
+
+bool TesselatePatch(const Nurbs &nurbs, const TessOptions &opts,
+                    int num_threads, RenderMesh *dst, std::string *err) {
+  Patch patch;
+  if (!SetupPatch(nurbs, &patch, err)) {
+    return false;
+  }
+
+  //
+  // 1. Parameter lines.
+  //
+  // Bounding box diagonal of control points.
+  double diag_len = 0.0;
+  {
+    dvec3 bmin{std::numeric_limits<double>::max(),
+               std::numeric_limits<double>::max(),
+               std::numeric_limits<double>::max()};
+    dvec3 bmax{-bmin.x, -bmin.y, -bmin.z};
+    for (const auto &p : nurbs.points) {
+      bmin.x = (std::min)(bmin.x, double(p[0]));
+      bmin.y = (std::min)(bmin.y, double(p[1]));
+      bmin.z = (std::min)(bmin.z, double(p[2]));
+      bmax.x = (std::max)(bmax.x, double(p[0]));
+      bmax.y = (std::max)(bmax.y, double(p[1]));
+      bmax.z = (std::max)(bmax.z, double(p[2]));
+    }
+    dvec3 diag = bmax - bmin;
+    diag_len = std::sqrt(dot(diag, diag));
+  }
+
+  std::vector<double> us, vs;
+  if (opts.adaptive) {
+    double tol = double(opts.config.chord_tolerance);
+    if (opts.config.relative_chord_tolerance) {
+      tol *= diag_len;
+    }
+    const double kPi = 3.14159265358979323846;
+    double cos_tol =
+        std::cos((std::min)(180.0, (std::max)(0.0, double(opts.config.angle_tolerance))) *
+                 kPi / 180.0);
+    uint32_t max_depth = (std::min)(16u, opts.config.max_subdivision_depth);
+
+    us = AdaptiveParams(patch, 0, tol, cos_tol, max_depth).Compute();
+    vs = AdaptiveParams(patch, 1, tol, cos_tol, max_depth).Compute();
+  } else {
+    us = UniformParams(patch.u0, patch.u1, opts.u_divs);
+    vs = UniformParams(patch.v0, patch.v1, opts.v_divs);
+  }
+
+  const size_t nu = us.size();
+  const size_t nv = vs.size();
+
+  //
+  // 2. Evaluate the grid. Basis functions are computed once per parameter
+  // line.
+  //
+  ParamBasis ub, vb;
+  ComputeParamBasis(us, patch.nu, patch.pu, patch.uknots, &ub);
+  ComputeParamBasis(vs, patch.nv, patch.pv, patch.vknots, &vb);
+
+  std::vector<dvec3> P(nu * nv);
+  std::vector<dvec3> N(nu * nv);
+  std::vector<uint8_t> valid_normals(nu * nv);
+
+  parallel::ParallelForChunked(
+      nv,
+      [&](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        std::vector<double> R, Rv;
+        for (size_t j = begin; j < end; j++) {
+          EvalRow(patch, ub, vb, j, R, Rv, &P[j * nu], &N[j * nu],
+                  &valid_normals[j * nu]);
+        }
+      },
+      num_threads, 4);
+
+  //
+  // 3. Classify grid cells with trimming curves(scanline at the middle of
+  // each row, even-odd rule).
+  //
+  std::vector<uint8_t> keep((nu - 1) * (nv - 1), 1);
+  if (!nurbs.trim_curves.empty()) {
+    std::vector<TrimEdge> edges;
+    if (!BuildTrimEdges(nurbs.trim_curves,
+                        opts.config.trim_curve_segments_per_span, &edges,
+                        err)) {
+      return false;
+    }
+
+    std::vector<double> xs;
+    for (size_t j = 0; (j + 1) < nv; j++) {
+      double vm = 0.5 * (vs[j] + vs[j + 1]);
+      xs.clear();
+      for (const TrimEdge &e : edges) {
+        if ((e.v0 > vm) != (e.v1 > vm)) {
+          xs.push_back(e.u0 + (vm - e.v0) * (e.u1 - e.u0) / (e.v1 - e.v0));
+        }
+      }
+      std::sort(xs.begin(), xs.end());
+
+      size_t crossings = 0;
+      for (size_t i = 0; (i + 1) < nu; i++) {
+        double um = 0.5 * (us[i] + us[i + 1]);
+        while ((crossings < xs.size()) && (xs[crossings] < um)) {
+          crossings++;
+        }
+        keep[j * (nu - 1) + i] = (crossings & 1) ? 1 : 0;
+      }
+    }
+  }
+
+  //
+  // 4. Triangles. Quads are split along the shorter diagonal. Degenerated
+  // triangles(e.g. at poles) are removed.
+  //
+  const double area_eps = 1e-24 * diag_len * diag_len * diag_len * diag_len;
+
+  std::vector<uint32_t> tris;
+  for (size_t j = 0; (j + 1) < nv; j++) {
+    for (size_t i = 0; (i + 1) < nu; i++) {
+      if (!keep[j * (nu - 1) + i]) {
+        continue;
+      }
+      uint32_t a = uint32_t(j * nu + i);
+      uint32_t b = uint32_t(j * nu + i + 1);
+      uint32_t c = uint32_t((j + 1) * nu + i + 1);
+      uint32_t d = uint32_t((j + 1) * nu + i);
+
+      dvec3 ac = P[c] - P[a];
+      dvec3 bd = P[d] - P[b];
+      uint32_t quad_tris[6];
+      if (dot(ac, ac) <= dot(bd, bd)) {
+        uint32_t t[6] = {a, b, c, a, c, d};
+        memcpy(quad_tris, t, sizeof(t));
+      } else {
+        uint32_t t[6] = {a, b, d, b, c, d};
+        memcpy(quad_tris, t, sizeof(t));
+      }
+
+      for (size_t t = 0; t < 2; t++) {
+        const uint32_t *tri = &quad_tris[3 * t];
+        dvec3 n = cross(P[tri[1]] - P[tri[0]], P[tri[2]] - P[tri[0]]);
+        if (dot(n, n) <= area_eps) {
+          continue;
+        }
+        tris.insert(tris.end(), tri, tri + 3);
+      }
+    }
+  }
+
+  // Degenerated normals(e.g. at poles): average normals of adjacent triangles.
+  for (size_t t = 0; t < tris.size(); t += 3) {
+    const uint32_t *tri = &tris[t];
+    if (valid_normals[tri[0]] && valid_normals[tri[1]] &&
+        valid_normals[tri[2]]) {
+      continue;
+    }
+    dvec3 n = cross(P[tri[1]] - P[tri[0]], P[tri[2]] - P[tri[0]]);
+    normalize(n);
+    for (size_t k = 0; k < 3; k++) {
+      if (!valid_normals[tri[k]]) {
+        N[tri[k]].x += n.x;
+        N[tri[k]].y += n.y;
+        N[tri[k]].z += n.z;
+      }
+    }
+  }
+
+  //
+  // 5. Compact vertices and build RenderMesh.
+  //
+  constexpr uint32_t kUnused = (std::numeric_limits<uint32_t>::max)();
+  std::vector<uint32_t> remap(nu * nv, kUnused);
+  uint32_t num_verts = 0;
+  for (uint32_t &idx : tris) {
+    if (remap[idx] == kUnused) {
+      remap[idx] = num_verts++;
+    }
+    idx = remap[idx];
+  }
+
+  const float nsign = nurbs.is_rightHanded ? 1.0f : -1.0f;
+  const double du = 1.0 / (patch.u1 - patch.u0);
+  const double dv = 1.0 / (patch.v1 - patch.v0);
+
+  std::vector<vec3> points(num_verts);
+  std::vector<vec3> normals(num_verts);
+  std::vector<vec2> uvs(num_verts);
+  for (size_t j = 0; j < nv; j++) {
+    for (size_t i = 0; i < nu; i++) {
+      uint32_t dst_idx = remap[j * nu + i];
+      if (dst_idx == kUnused) {
+        continue;
+      }
+      const dvec3 &p = P[j * nu + i];
+      dvec3 n = N[j * nu + i];
+      normalize(n);
+      points[dst_idx] = {float(p.x), float(p.y), float(p.z)};
+      normals[dst_idx] = {nsign * float(n.x), nsign * float(n.y),
+                          nsign * float(n.z)};
+      uvs[dst_idx] = {float((us[i] - patch.u0) * du),
+                      float((vs[j] - patch.v0) * dv)};
+    }
+  }
+
+  RenderMesh mesh;
+  mesh.prim_name = nurbs.prim_name;
+  mesh.abs_path = nurbs.abs_path;
+  mesh.is_rightHanded = nurbs.is_rightHanded;
+  mesh.doubleSided = nurbs.doubleSided;
+  mesh.points = std::move(points);
+  mesh.usdFaceVertexCounts.assign(tris.size() / 3, 3);
+  mesh.usdFaceVertexIndices = std::move(tris);
+
+  mesh.normals.name = "normals";
+  mesh.normals.format = VertexAttributeFormat::Vec3;
+  mesh.normals.variability = VertexVariability::Vertex;
+  mesh.normals.set_buffer(reinterpret_cast<const uint8_t *>(normals.data()),
+                          normals.size() * sizeof(vec3));
+
+  VertexAttribute texcoords;
+  texcoords.name = "st";
+  texcoords.format = VertexAttributeFormat::Vec2;
+  texcoords.variability = VertexVariability::Vertex;
+  texcoords.set_buffer(reinterpret_cast<const uint8_t *>(uvs.data()),
+                       uvs.size() * sizeof(vec2));
+  mesh.texcoords[0] = std::move(texcoords);
+  mesh.texcoordSlotIdMap.add("st", 0);
+
+  (*dst) = std::move(mesh);
+
+  return true;
+}
+
+#undef PushError
+
+}  // namespace
+
+bool NurbsTesselator::tesselate(const Nurbs &nurbs, uint32_t u_divs,
+                                uint32_t v_divs, RenderMesh &dst) {
+  _err.clear();
+
+  TessOptions opts;
+  opts.adaptive = false;
+  opts.u_divs = u_divs;
+  opts.v_divs = v_divs;
+  return TesselatePatch(nurbs, opts, opts.config.num_threads, &dst, &_err);
+}
+
+bool NurbsTesselator::tesselate(const Nurbs &nurbs,
+                                const NurbsTesselatorConfig &config,
+                                RenderMesh &dst) {
+  _err.clear();
+
+  TessOptions opts;
+  opts.config = config;
+  return TesselatePatch(nurbs, opts, config.num_threads, &dst, &_err);
+}
+
+bool NurbsTesselator::tesselate(const std::vector<Nurbs> &patches,
+                                const NurbsTesselatorConfig &config,
+                                std::vector<RenderMesh> &dst) {
+  _err.clear();
+
+  TessOptions opts;
+  opts.config = config;
+
+  dst.clear();
+  dst.resize(patches.size());
+  std::vector<std::string> errs(patches.size());
+  std::vector<uint8_t> results(patches.size(), 0);
+
+  // Parallelize across patches. Each patch is evaluated in single thread.
+  parallel::ParallelFor(
+      patches.size(),
+      [&](size_t i, int thread_id) {
+        (void)thread_id;
+        results[i] =
+            TesselatePatch(patches[i], opts, 1, &dst[i], &errs[i]) ? 1 : 0;
+      },
+      config.num_threads, 1);
+
+  bool ok = true;
+  for (size_t i = 0; i < patches.size(); i++) {
+    if (!results[i]) {
+      _err += fmt::format("Failed to tessellate NurbsPatch[{}] `{}`: {}", i,
+                          patches[i].abs_path, errs[i]);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -1,19 +1,129 @@
 // SPDX-License-Identifier: Apache 2.0
 // Simple NURBS tesselation
+//
+// Tessellates NURBS patch(UsdGeomNurbsPatch) to a triangle RenderMesh with
+// normals and texcoords. Parameter lines are placed adaptively(chord and
+// normal angle tolerance), and trimming curves are supported.
+//
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "render-data.hh"
 
 namespace tinyusdz {
 
 namespace tydra {
 
-struct Nurbs;
+///
+/// Trimming curves of NurbsPatch(`trimCurve:*` attributes of
+/// UsdGeomNurbsPatch). Curves are defined in the (u, v) parameter space of the
+/// patch.
+///
+/// Curves in a loop are connected to form a closed loop. A point on the patch
+/// is kept when it is inside of odd number of loops(even-odd rule), so an
+/// outer loop and hole loops can be given in any orientation.
+///
+struct NurbsTrimCurves {
+  std::vector<int> counts;         // # of curves in each loop.
+  std::vector<int> orders;         // Order of each curve.
+  std::vector<int> vertex_counts;  // # of control points of each curve.
+  std::vector<double> knots;       // Concatenated knots of all curves.
+
+  // Parameter range of each curve. Empty = use the full knot range.
+  std::vector<value::double2> ranges;
+
+  // Control points of all curves. (u, v, w). w is the rational weight(u, v
+  // are not premultiplied by w).
+  std::vector<value::double3> points;
+
+  bool empty() const { return counts.empty(); }
+};
+
+///
+/// NURBS patch. Attribute names follow UsdGeomNurbsPatch.
+///
+struct Nurbs {
+  std::string prim_name;
+  std::string abs_path;
 
+  uint32_t u_vertex_count{0};
+  uint32_t v_vertex_count{0};
+  uint32_t u_order{4};  // degree + 1
+  uint32_t v_order{4};
+  std::vector<double> u_knots;  // size = u_vertex_count + u_order
+  std::vector<double> v_knots;  // size = v_vertex_count + v_order
+
+  // Parameter range to tessellate. Invalid range(min >= max) = use the full
+  // knot range.
+  value::double2 u_range{0.0, 0.0};
+  value::double2 v_range{0.0, 0.0};
+
+  // `u_vertex_count * v_vertex_count` control points. u varies fastest.
+  std::vector<vec3> points;
+
+  // Rational weights. Empty = non-rational(all weights are 1).
+  std::vector<double> point_weights;
+
+  NurbsTrimCurves trim_curves;
+
+  bool is_rightHanded{true};  // orientation
+  bool doubleSided{false};
+};
+
+struct NurbsTesselatorConfig {
+  // Max distance between the surface and the tessellated triangles. Relative
+  // to the bounding box diagonal of control points when
+  // `relative_chord_tolerance` is true.
+  float chord_tolerance{1e-3f};
+  bool relative_chord_tolerance{true};
+
+  // Max angle(in degree) between normals of neighboring parameter lines.
+  float angle_tolerance{10.0f};
+
+  // Each knot span is subdivided up to 2^max_subdivision_depth segments.
+  uint32_t max_subdivision_depth{6};
+
+  // # of line segments per knot span of a trimming curve.
+  uint32_t trim_curve_segments_per_span{16};
+
+  // # of threads. -1 = use all hardware threads.
+  int num_threads{-1};
+};
+
+///
+/// Output RenderMesh is a triangle mesh(`usdFaceVertexCounts` are all 3's)
+/// with `vertex` variability normals and texcoords(texcoords[0]).
+/// Texcoords are the (u, v) parameters normalized to [0, 1] in the
+/// tessellated range.
+///
 class NurbsTesselator
 {
+ public:
+  ///
+  /// Tessellate with uniform `u_divs` x `v_divs` grid in the parameter range.
+  ///
   bool tesselate(const Nurbs &nurbs, uint32_t u_divs, uint32_t v_divs, RenderMesh &dst );
+
+  ///
+  /// Adaptive tessellation with chord and angle tolerance.
+  ///
+  bool tesselate(const Nurbs &nurbs, const NurbsTesselatorConfig &config,
+                 RenderMesh &dst);
+
+  ///
+  /// Tessellate multiple patches in parallel.
+  ///
+  bool tesselate(const std::vector<Nurbs> &patches,
+                 const NurbsTesselatorConfig &config,
+                 std::vector<RenderMesh> &dst);
+
+  const std::string &GetError() const { return _err; }
+
+ private:
+  std::string _err;
 };
 
 } // namespace tydra
@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Progressive(incremental) loader.
+//
+#include "progressive-loader.hh"
+
+#include <type_traits>
+
+#include "io-util.hh"
+#include "parallel-for.hh"
+#include "tydra/scene-access.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+// Texel pointers in events must survive the reallocation of
+// RenderSceneConverter::buffers.
+static_assert(std::is_nothrow_move_constructible<BufferData>::value,
+              "BufferData must be nothrow move constructible.");
+
+bool CountMeshFunction(const Path &abs_path, const Prim &prim,
+                       const int32_t tree_depth, void *userdata,
+                       std::string *err) {
+  (void)abs_path;
+  (void)tree_depth;
+  (void)err;
+
+  uint64_t *count = reinterpret_cast<uint64_t *>(userdata);
+  if (prim.is<GeomMesh>()) {
+    (*count)++;
+  }
+
+  return true;  // continue traversal
+}
+
+}  // namespace
+
+std::string to_string(ProgressiveLoaderState state) {
+  switch (state) {
+    case ProgressiveLoaderState::Idle:
+      return "idle";
+    case ProgressiveLoaderState::Parsing:
+      return "parsing";
+    case ProgressiveLoaderState::Converting:
+      return "converting";
+    case ProgressiveLoaderState::Done:
+      return "done";
+    case ProgressiveLoaderState::Failed:
+      return "failed";
+    case ProgressiveLoaderState::Cancelled:
+      return "cancelled";
+  }
+
+  return "[[InvalidProgressiveLoaderState]]";
+}
+
+ProgressiveLoader::~ProgressiveLoader() {
+  Cancel();
+  Wait();
+}
+
+bool ProgressiveLoader::Start(std::vector<uint8_t> &&data,
+                              const std::string &filename,
+                              const ProgressiveLoaderConfig &config,
+                              std::string *err) {
+  bool expected = false;
+  if (!_started.compare_exchange_strong(expected, true)) {
+    if (err) {
+      (*err) += "ProgressiveLoader has already been started.\n";
+    }
+    return false;
+  }
+
+  _data = std::move(data);
+  _filename = filename;
+  _config = config;
+
+  _state = int(ProgressiveLoaderState::Parsing);
+
+#if defined(TINYUSDZ_PARALLEL_FOR_USE_THREAD)
+  if (_config.use_worker_thread) {
+    _worker = std::thread([this]() { Run(); });
+    return true;
+  }
+#endif
+
+  Run();
+
+  return true;
+}
+
+void ProgressiveLoader::Run() {
+  const uint8_t *addr = _data.data();
+  const size_t length = _data.size();
+
+  if (!LoadUSDFromMemory(addr, length, _filename, &_stage, &_warn, &_err)) {
+    _state = int(ProgressiveLoaderState::Failed);
+    return;
+  }
+
+  {
+    uint64_t count{0};
+    std::string err;
+    if (!VisitPrims(_stage, CountMeshFunction, &count, &err)) {
+      _err += err;
+      _state = int(ProgressiveLoaderState::Failed);
+      return;
+    }
+    _num_meshes_total = count;
+  }
+
+  if (_cancel_requested) {
+    _state = int(ProgressiveLoaderState::Cancelled);
+    return;
+  }
+
+  _state = int(ProgressiveLoaderState::Converting);
+
+  RenderSceneConverterEnv env(_stage);
+  env.mesh_config = _config.mesh_config;
+  env.material_config = _config.material_config;
+  env.scene_config = _config.scene_config;
+  env.usd_filename = _filename;
+
+  env.scene_config.mesh_converted_callback = OnMeshConverted;
+  env.scene_config.texture_image_loaded_callback = OnTextureImageLoaded;
+  env.scene_config.progress_callback_userdata = this;
+
+  if (IsUSDZ(addr, length)) {
+    // Assets are read from `_data`, so no need to copy them.
+    bool asset_on_memory = false;
+    if (!ReadUSDZAssetInfoFromMemory(addr, length, asset_on_memory,
+                                     &_usdz_asset, &_warn, &_err)) {
+      _err += "Failed to read USDZ assetInfo.\n";
+      _state = int(ProgressiveLoaderState::Failed);
+      return;
+    }
+
+    // NOTE: `_usdz_asset` must be valid until the end of the conversion.
+    if (!SetupUSDZAssetResolution(env.asset_resolver, &_usdz_asset)) {
+      _err += "Failed to setup AssetResolution for USDZ asset.\n";
+      _state = int(ProgressiveLoaderState::Failed);
+      return;
+    }
+  } else if (!_filename.empty()) {
+    env.set_search_paths({io::GetBaseDir(_filename)});
+  }
+
+  // Mesh events point into `_converter.meshes`, so it must not be
+  // reallocated during the conversion. The converter appends exactly one
+  // RenderMesh per GeomMesh Prim(counted above with the same traversal), so
+  // reserving `_num_meshes_total` is enough. The storage is moved to
+  // `_render_scene` at the end, which keeps the address of each element.
+  _converter.meshes.reserve(size_t(_num_meshes_total));
+  _mesh_capacity = _converter.meshes.capacity();
+
+  bool ret = _converter.ConvertToRenderScene(env, &_render_scene);
+
+  _warn += _converter.GetWarning();
+
+  if (!ret) {
+    if (_cancel_requested) {
+      _state = int(ProgressiveLoaderState::Cancelled);
+    } else {
+      _err += _converter.GetError();
+      _state = int(ProgressiveLoaderState::Failed);
+    }
+    return;
+  }
+
+  _state = int(ProgressiveLoaderState::Done);
+}
+
+bool ProgressiveLoader::OnMeshConverted(uint64_t mesh_id,
+                                        const RenderMesh &mesh,
+                                        void *userdata) {
+  ProgressiveLoader *loader = reinterpret_cast<ProgressiveLoader *>(userdata);
+
+  // Invariant: # of RenderMeshes <= # of GeomMesh Prims(= reserved
+  // capacity). Violating it means the append of this mesh reallocated the
+  // storage and the pointers of the previous events are invalidated.
+  if ((mesh_id >= loader->_num_meshes_total) ||
+      (loader->_converter.meshes.capacity() != loader->_mesh_capacity)) {
+    loader->_err += "Internal error: RenderMesh[" + std::to_string(mesh_id) +
+                    "] exceeds the reserved storage for " +
+                    std::to_string(loader->_num_meshes_total.load()) +
+                    " GeomMesh Prims.\n";
+    return false;
+  }
+
+  ProgressiveLoaderEvent ev;
+  ev.type = ProgressiveLoaderEvent::Type::Mesh;
+  ev.id = mesh_id;
+  ev.mesh = &mesh;
+
+  {
+    std::lock_guard<std::mutex> lock(loader->_queue_mutex);
+    loader->_queue.emplace_back(std::move(ev));
+  }
+  loader->_num_meshes_converted++;
+
+  return !loader->_cancel_requested;
+}
+
+bool ProgressiveLoader::OnTextureImageLoaded(uint64_t image_id,
+                                             const TextureImage &image,
+                                             const BufferData &buffer,
+                                             void *userdata) {
+  ProgressiveLoader *loader = reinterpret_cast<ProgressiveLoader *>(userdata);
+
+  ProgressiveLoaderEvent ev;
+  ev.type = ProgressiveLoaderEvent::Type::TextureImage;
+  ev.id = image_id;
+  ev.image = image;
+  ev.texels = buffer.data.data();
+  ev.texels_size = buffer.data.size();
+
+  {
+    std::lock_guard<std::mutex> lock(loader->_queue_mutex);
+    loader->_queue.emplace_back(std::move(ev));
+  }
+  loader->_num_images_loaded++;
+
+  return !loader->_cancel_requested;
+}
+
+bool ProgressiveLoader::PollEvent(ProgressiveLoaderEvent *event) {
+  if (!event) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(_queue_mutex);
+  if (_queue.empty()) {
+    return false;
+  }
+
+  (*event) = std::move(_queue.front());
+  _queue.pop_front();
+
+  return true;
+}
+
+ProgressiveLoaderProgress ProgressiveLoader::GetProgress() const {
+  ProgressiveLoaderProgress progress;
+  progress.state = ProgressiveLoaderState(_state.load());
+  progress.input_bytes = _data.size();
+  progress.num_meshes_total = _num_meshes_total;
+  progress.num_meshes_converted = _num_meshes_converted;
+  progress.num_images_loaded = _num_images_loaded;
+
+  return progress;
+}
+
+void ProgressiveLoader::Cancel() { _cancel_requested = true; }
+
+bool ProgressiveLoader::Wait() {
+#if defined(TINYUSDZ_PARALLEL_FOR_USE_THREAD)
+  if (_worker.joinable()) {
+    _worker.join();
+  }
+#endif
+
+  return ProgressiveLoaderState(_state.load()) == ProgressiveLoaderState::Done;
+}
+
+bool ProgressiveLoader::IsFinished() const {
+  ProgressiveLoaderState state = ProgressiveLoaderState(_state.load());
+  return (state == ProgressiveLoaderState::Done) ||
+         (state == ProgressiveLoaderState::Failed) ||
+         (state == ProgressiveLoaderState::Cancelled);
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
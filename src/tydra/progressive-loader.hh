@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Progressive(incremental) loader: Parse USD and convert it to RenderScene on
+// a worker thread, and receive converted meshes and texture images through a
+// queue while the conversion is running.
+//
+// Intended for the environment where blocking the main thread is not
+// acceptable(e.g. Browser with Emscripten pthreads).
+//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "parallel-for.hh"
+#include "render-data.hh"
+#include "tinyusdz.hh"
+
+#if defined(TINYUSDZ_PARALLEL_FOR_USE_THREAD)
+#include <thread>
+#endif
+
+namespace tinyusdz {
+namespace tydra {
+
+struct ProgressiveLoaderConfig {
+  MeshConverterConfig mesh_config;
+  MaterialConverterConfig material_config;
+
+  // NOTE: Progress callbacks in `scene_config` are overwritten by the loader.
+  RenderSceneConverterConfig scene_config;
+
+  // Run parsing and conversion on a worker thread.
+  // When false, or the platform does not support threads(WASI, Emscripten
+  // without pthreads), `ProgressiveLoader::Start` does the whole loading on
+  // the calling thread(events are queued in the same way).
+  bool use_worker_thread{true};
+};
+
+enum class ProgressiveLoaderState {
+  Idle,
+  Parsing,
+  Converting,
+  Done,
+  Failed,
+  Cancelled,
+};
+
+std::string to_string(ProgressiveLoaderState state);
+
+struct ProgressiveLoaderProgress {
+  ProgressiveLoaderState state{ProgressiveLoaderState::Idle};
+  uint64_t input_bytes{0};
+  uint64_t num_meshes_total{0};  // # of GeomMesh Prims. Known after parsing.
+  uint64_t num_meshes_converted{0};
+  uint64_t num_images_loaded{0};
+};
+
+struct ProgressiveLoaderEvent {
+  enum class Type {
+    Mesh,
+    TextureImage,
+  };
+
+  Type type{Type::Mesh};
+  uint64_t id{0};  // Index to RenderScene::meshes or RenderScene::images
+
+  // Mesh and texel data are not copied. Pointers refer to the data owned by
+  // the loader, which is not modified after the event is emitted. They are
+  // valid until the loader is destroyed(also after Cancel or failure).
+  // `mesh` points to `GetRenderScene().meshes[id]` once the loading is Done.
+
+  const RenderMesh *mesh{nullptr};  // Type::Mesh
+
+  TextureImage image;               // Type::TextureImage
+  const uint8_t *texels{nullptr};   // Type::TextureImage. Texel data of `image`.
+  size_t texels_size{0};            // Type::TextureImage. In bytes.
+};
+
+///
+/// Usage:
+///
+///   ProgressiveLoader loader;
+///   loader.Start(std::move(data), "scene.usdz", config, &err);
+///
+///   // e.g. in the render loop.
+///   ProgressiveLoaderEvent ev;
+///   while (loader.PollEvent(&ev)) { /* upload mesh/texture */ }
+///   if (loader.IsFinished()) { ... }
+///
+class ProgressiveLoader {
+ public:
+  ProgressiveLoader() = default;
+  ProgressiveLoader(const ProgressiveLoader &rhs) = delete;
+  ProgressiveLoader(ProgressiveLoader &&rhs) = delete;
+  ProgressiveLoader &operator=(const ProgressiveLoader &rhs) = delete;
+
+  // Cancel and wait for the worker thread.
+  ~ProgressiveLoader();
+
+  ///
+  /// Start loading USD(USDA, USDC or USDZ) data.
+  ///
+  /// @param[in] data USD data. Moved into the loader since USDZ assets are
+  /// referenced from it during the conversion.
+  /// @param[in] filename Filename of `data`. Used for the error message, and
+  /// as the base directory to resolve assets of non-USDZ data.
+  /// @param[in] config Loader config.
+  /// @param[out] err Error message.
+  ///
+  /// @return false when the loader has already been started. Parse and
+  /// conversion errors are reported through `GetProgress` and `GetError`.
+  ///
+  bool Start(std::vector<uint8_t> &&data, const std::string &filename,
+             const ProgressiveLoaderConfig &config, std::string *err);
+
+  ///
+  /// Pop an event(converted mesh or texture image) from the queue.
+  /// Non-blocking. Events are popped in the conversion order.
+  ///
+  /// @return false when the queue is empty.
+  ///
+  bool PollEvent(ProgressiveLoaderEvent *event);
+
+  ProgressiveLoaderProgress GetProgress() const;
+
+  ///
+  /// Request cancellation. The conversion stops at the next mesh or texture
+  /// image boundary(parsing cannot be interrupted).
+  ///
+  void Cancel();
+
+  ///
+  /// Wait for the worker thread to finish.
+  ///
+  /// @return true when the loading succeeded.
+  ///
+  bool Wait();
+
+  ///
+  /// @return true when the loading has been finished(Done, Failed or
+  /// Cancelled).
+  ///
+  bool IsFinished() const;
+
+  ///
+  /// RenderScene(includes all meshes and images emitted as events).
+  /// Valid after the loading has been finished with `Done` state.
+  ///
+  const RenderScene &GetRenderScene() const { return _render_scene; }
+  RenderScene &GetRenderScene() { return _render_scene; }
+
+  // Valid after the loading has been finished.
+  const std::string &GetWarning() const { return _warn; }
+  const std::string &GetError() const { return _err; }
+
+ private:
+  void Run();
+
+  static bool OnMeshConverted(uint64_t mesh_id, const RenderMesh &mesh,
+                              void *userdata);
+  static bool OnTextureImageLoaded(uint64_t image_id,
+                                   const TextureImage &image,
+                                   const BufferData &buffer, void *userdata);
+
+  std::vector<uint8_t> _data;
+  std::string _filename;
+  ProgressiveLoaderConfig _config;
+
+  Stage _stage;
+  USDZAsset _usdz_asset;
+  RenderSceneConverter _converter;  // Owns the data referenced by events.
+  size_t _mesh_capacity{0};
+  RenderScene _render_scene;
+  std::string _warn;
+  std::string _err;
+
+  std::atomic<bool> _started{false};
+  std::atomic<bool> _cancel_requested{false};
+  std::atomic<int> _state{int(ProgressiveLoaderState::Idle)};
+  std::atomic<uint64_t> _num_meshes_total{0};
+  std::atomic<uint64_t> _num_meshes_converted{0};
+  std::atomic<uint64_t> _num_images_loaded{0};
+
+  mutable std::mutex _queue_mutex;
+  std::deque<ProgressiveLoaderEvent> _queue;
+
+#if defined(TINYUSDZ_PARALLEL_FOR_USE_THREAD)
+  std::thread _worker;
+#endif
+};
+
+}  // namespace tydra
+}  // namespace tinyusdz
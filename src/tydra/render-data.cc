@@ -3,8 +3,8 @@
 // Copyright 2023 - Present, Light Transport Entertainment Inc.
 //
 // TODO:
-//   - [ ] Subdivision surface to polygon mesh conversion.
-//     - [ ] Correctly handle primvar with 'vertex' interpolation(Use the basis
+//   - [x] Subdivision surface to polygon mesh conversion.
+//     - [x] Correctly handle primvar with 'vertex' interpolation(Use the basis
 //     function of subd surface)
 //   - [x] Support time-varying shader attribute(timeSamples)
 //   - [ ] Wide gamut colorspace conversion support
@@ -15,7 +15,7 @@
 //   - [ ] Support SkelAnimation
 //     - [x] joint animation
 //     - [x] blendshape animation
-//   - [ ] Support Inbetween BlendShape
+//   - [x] Support Inbetween BlendShape
 //   - [ ] Support material binding collection(Collection API)
 //   - [ ] Support multiple skel animation
 //   https://github.com/PixarAnimationStudios/OpenUSD/issues/2246
@@ -26,13 +26,18 @@
 //     indices/weights, BlendShape points, ...) as much as possible.
 //     - Implement spatial hash
 //
+#include <functional>
+#include <memory>
 #include <numeric>
+#include <set>
 
 #include "image-loader.hh"
 #include "image-util.hh"
 #include "image-types.hh"
 #include "linear-algebra.hh"
+#include "parallel-for.hh"
 #include "math-util.inc"
+#include "performance.hh"
 #include "pprinter.hh"
 #include "prim-types.hh"
 #include "str-util.hh"
@@ -42,6 +47,10 @@
 #include "usdShade.hh"
 #include "value-pprint.hh"
 
+#if defined(TINYUSDZ_WITH_OPENSUBDIV)
+#include "subdiv.hh"
+#endif
+
 #if defined(TINYUSDZ_WITH_COLORIO)
 #include "external/tiny-color-io.h"
 #endif
@@ -75,6 +84,8 @@
 #include "tydra/render-data.hh"
 #include "tydra/scene-access.hh"
 #include "tydra/shader-network.hh"
+#include "tydra/texture-compress.hh"
+#include "tydra/texture-util.hh"
 
 namespace tinyusdz {
 
@@ -103,6 +114,25 @@ inline std::string to_string(const UVTexture::Channel channel) {
   return "[[InternalError. Invalid UVTexture::Channel]]";
 }
 
+//
+// Call the function at the end of scope(including early return paths).
+//
+class ScopeExit {
+ public:
+  explicit ScopeExit(std::function<void()> f) : _f(std::move(f)) {}
+  ~ScopeExit() {
+    if (_f) {
+      _f();
+    }
+  }
+
+  ScopeExit(const ScopeExit &) = delete;
+  ScopeExit &operator=(const ScopeExit &) = delete;
+
+ private:
+  std::function<void()> _f;
+};
+
 //
 // Convert vertex attribute with Uniform variability(interpolation) to
 // facevarying variability, by replicating uniform value per face over face
@@ -1053,6 +1083,98 @@ static bool TriangulateVertexAttribute(
   return true;
 }
 
+#if defined(TINYUSDZ_WITH_OPENSUBDIV)
+///
+/// Subdivide VertexAttribute data with the refined topology of `subdivider`.
+///
+static bool SubdivideVertexAttribute(VertexAttribute &vattr,
+                                     const Subdivider &subdivider,
+                                     size_t num_face_vertices,
+                                     std::string *err) {
+  if (vattr.vertex_count() == 0) {
+    return true;
+  }
+
+  if (vattr.is_constant()) {
+    return true;
+  }
+
+  if (vattr.variability == VertexVariability::Uniform) {
+    const std::vector<uint32_t> &parents = subdivider.refined_face_parents();
+    const size_t stride = vattr.stride_bytes();
+    if (vattr.vertex_count() < num_face_vertices) {
+      // # of faces is less than # of face-vertices, so just check the bound.
+      for (uint32_t parent : parents) {
+        if (parent >= vattr.vertex_count()) {
+          PUSH_ERROR_AND_RETURN(fmt::format(
+              "Too few `uniform` values in `{}` attribute.", vattr.name));
+        }
+      }
+    }
+
+    std::vector<uint8_t> buf(parents.size() * stride);
+    for (size_t f = 0; f < parents.size(); f++) {
+      memcpy(buf.data() + f * stride,
+             vattr.get_data().data() + size_t(parents[f]) * stride, stride);
+    }
+    vattr.data = std::move(buf);
+    return true;
+  }
+
+  if (vattr.is_indexed()) {
+    PUSH_ERROR_AND_RETURN("Indexed VertexAttribute is not supported.");
+  }
+
+  if ((vattr.format != VertexAttributeFormat::Float) &&
+      (vattr.format != VertexAttributeFormat::Vec2) &&
+      (vattr.format != VertexAttributeFormat::Vec3) &&
+      (vattr.format != VertexAttributeFormat::Vec4)) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "Subdivision of `{}` attribute with format {} is not supported.",
+        vattr.name, to_string(vattr.format)));
+  }
+
+  if (vattr.stride_bytes() !=
+      (vattr.element_size() * vattr.format_size())) {
+    PUSH_ERROR_AND_RETURN("Packed VertexAttribute is not supported.");
+  }
+
+  const size_t num_components = vattr.stride_bytes() / sizeof(float);
+
+  std::vector<float> src(vattr.vertex_count() * num_components);
+  memcpy(src.data(), vattr.get_data().data(), src.size() * sizeof(float));
+
+  std::vector<float> refined;
+  if (vattr.is_facevarying()) {
+    if (vattr.vertex_count() != num_face_vertices) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("# of `facevarying` values in `{}` attribute must be {}, "
+                      "but got {}.",
+                      vattr.name, num_face_vertices, vattr.vertex_count()));
+    }
+    if (!subdivider.RefineFaceVarying(src.data(), num_components, &refined)) {
+      PUSH_ERROR_AND_RETURN("Failed to subdivide `facevarying` attribute.");
+    }
+  } else {
+    if (vattr.vertex_count() != subdivider.num_control_vertices()) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("# of `vertex` values in `{}` attribute must be {}, "
+                      "but got {}.",
+                      vattr.name, subdivider.num_control_vertices(),
+                      vattr.vertex_count()));
+    }
+    if (!subdivider.RefineVertex(src.data(), num_components, &refined)) {
+      PUSH_ERROR_AND_RETURN("Failed to subdivide `vertex` attribute.");
+    }
+  }
+
+  vattr.data.resize(refined.size() * sizeof(float));
+  memcpy(vattr.data.data(), refined.data(), vattr.data.size());
+
+  return true;
+}
+#endif
+
 std::vector<const tinyusdz::GeomSubset *> GetMaterialBindGeomSubsets(
     const tinyusdz::Prim &prim) {
   std::vector<const tinyusdz::GeomSubset *> dst;
@@ -1495,6 +1617,13 @@ nonstd::expected<VertexAttribute, std::string> TriangulateGeomPrimvar(
 ///   - triangulatedFaceVertexIndices = [0, 1, 3, 0, 3, 2]
 ///   - triangulatedToOrigFaceVertexIndexMap = [0, 1, 2, 0, 2, 3]
 ///
+/// Triangulation is done in two passes. The first pass computes the output
+/// offset of each face(prefix sum of `faceVertexCounts - 2`), and the second
+/// pass emits triangles of faces in parallel. Triangles and convex polygons
+/// are fan-triangulated without memory allocation. Concave quads are split at
+/// the reflex vertex, and earcut is used only for concave n-gons(with
+/// per-thread scratch buffers).
+///
 /// T = value::float3 or value::double3
 /// BaseTy = float or double
 template <typename T, typename BaseTy>
@@ -1504,16 +1633,25 @@ bool TriangulatePolygon(
     std::vector<uint32_t> &triangulatedFaceVertexCounts,
     std::vector<uint32_t> &triangulatedFaceVertexIndices,
     std::vector<size_t> &triangulatedToOrigFaceVertexIndexMap,
-    std::vector<uint32_t> &triangulatedFaceCounts, std::string &err) {
+    std::vector<uint32_t> &triangulatedFaceCounts, std::string &err,
+    int num_threads = -1) {
   triangulatedFaceVertexCounts.clear();
   triangulatedFaceVertexIndices.clear();
 
   triangulatedToOrigFaceVertexIndexMap.clear();
+  triangulatedFaceCounts.clear();
 
-  size_t faceIndexOffset = 0;
+  const size_t num_faces = faceVertexCounts.size();
 
-  // For each polygon(face)
-  for (size_t i = 0; i < faceVertexCounts.size(); i++) {
+  //
+  // 1. Offsets of input face-vertices and output triangles.
+  //
+  std::vector<size_t> faceIndexOffsets(num_faces);
+  std::vector<size_t> triOffsets(num_faces);
+
+  size_t faceIndexOffset = 0;
+  size_t numTris = 0;
+  for (size_t i = 0; i < num_faces; i++) {
     uint32_t npolys = faceVertexCounts[i];
 
     if (npolys < 3) {
@@ -1532,177 +1670,250 @@ bool TriangulatePolygon(
       return false;
     }
 
-    if (npolys == 3) {
-      // No need for triangulation.
-      triangulatedFaceVertexCounts.push_back(3);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 1]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 1);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedFaceCounts.push_back(1);
-#if 1
-    } else if (npolys == 4) {
-      // Use simple split
-      // TODO: Split at shortest edge for better triangulation.
-      triangulatedFaceVertexCounts.push_back(3);
-      triangulatedFaceVertexCounts.push_back(3);
-
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 1]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 3]);
-
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 1);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 3);
-      triangulatedFaceCounts.push_back(2);
-#endif
-    } else {
-      // Use double for accuracy. `float` precision may classify small-are polygon as degenerated.
-      // Find the normal axis of the polygon using Newell's method
-      value::double3 n = {0, 0, 0};
+    faceIndexOffsets[i] = faceIndexOffset;
+    triOffsets[i] = numTris;
 
-      size_t vi0;
-      size_t vi0_2;
+    faceIndexOffset += npolys;
+    numTris += npolys - 2;
+  }
 
-      for (size_t k = 0; k < npolys; ++k) {
-        vi0 = faceVertexIndices[faceIndexOffset + k];
+  // Up to 2GB tris.
+  if (numTris > size_t((std::numeric_limits<int32_t>::max)())) {
+    err = "Too many triangles are generated.\n";
+    return false;
+  }
 
-        size_t j = (k + 1) % npolys;
-        vi0_2 = faceVertexIndices[faceIndexOffset + j];
+  triangulatedFaceVertexCounts.assign(numTris, 3);
+  triangulatedFaceVertexIndices.resize(numTris * 3);
+  triangulatedToOrigFaceVertexIndexMap.resize(numTris * 3);
+  triangulatedFaceCounts.resize(num_faces);
 
-        if (vi0 >= points.size()) {
-          err = fmt::format("Invalid vertex index.\n");
-          return false;
-        }
+  //
+  // 2. Emit triangles.
+  //
+  using Point2D = std::array<BaseTy, 2>;
 
-        if (vi0_2 >= points.size()) {
-          err = fmt::format("Invalid vertex index.\n");
-          return false;
-        }
+  struct Scratch {
+    std::vector<std::vector<Point2D>> polygon_2d;
+    mapbox::detail::Earcut<uint32_t> earcut;
+  };
 
-        T v0 = points[vi0];
-        T v1 = points[vi0_2];
+  const int nthreads = parallel::GetNumThreads(num_threads);
+  std::vector<std::unique_ptr<Scratch>> scratches(static_cast<size_t>(nthreads));
+  std::vector<size_t> errFaces(size_t(nthreads),
+                               (std::numeric_limits<size_t>::max)());
+  std::vector<std::string> errs(static_cast<size_t>(nthreads));
+  std::vector<uint8_t> needsCompaction(size_t(nthreads), 0);
+
+  // Emit triangle with local corner indices.
+  auto emit = [&](size_t i, size_t t, uint32_t a, uint32_t b, uint32_t c) {
+    size_t dst = 3 * (triOffsets[i] + t);
+    size_t src = faceIndexOffsets[i];
+    triangulatedFaceVertexIndices[dst + 0] = faceVertexIndices[src + a];
+    triangulatedFaceVertexIndices[dst + 1] = faceVertexIndices[src + b];
+    triangulatedFaceVertexIndices[dst + 2] = faceVertexIndices[src + c];
+    triangulatedToOrigFaceVertexIndexMap[dst + 0] = src + a;
+    triangulatedToOrigFaceVertexIndexMap[dst + 1] = src + b;
+    triangulatedToOrigFaceVertexIndexMap[dst + 2] = src + c;
+  };
 
-        const T point1 = {v0[0], v0[1], v0[2]};
-        const T point2 = {v1[0], v1[1], v1[2]};
+  // Returns false when the face fails to triangulate.
+  auto triangulateFace = [&](size_t i, int thread_id) -> bool {
+    const uint32_t npolys = faceVertexCounts[i];
+    const uint32_t *fvIndices = &faceVertexIndices[faceIndexOffsets[i]];
 
-        T a = {point1[0] - point2[0], point1[1] - point2[1],
-               point1[2] - point2[2]};
-        T b = {point1[0] + point2[0], point1[1] + point2[1],
-               point1[2] + point2[2]};
+    if (npolys == 3) {
+      // No need for triangulation.
+      emit(i, 0, 0, 1, 2);
+      triangulatedFaceCounts[i] = 1;
+      return true;
+    }
 
-        n[0] += double(a[1] * b[2]);
-        n[1] += double(a[2] * b[0]);
-        n[2] += double(a[0] * b[1]);
-        DCOUT("v0 " << v0);
-        DCOUT("v1 " << v1);
-        DCOUT("n " << n);
+    for (uint32_t k = 0; k < npolys; k++) {
+      if (fvIndices[k] >= points.size()) {
+        errs[size_t(thread_id)] = fmt::format("Invalid vertex index.\n");
+        return false;
       }
-      //BaseTy length_n = vlength(n);
-      double length_n = vlength(n);
+    }
 
-      // Check if zero length normal
-      if (std::fabs(length_n) < std::numeric_limits<double>::epsilon()) {
-        DCOUT("length_n " << length_n);
-        err = "Degenerated polygon found.\n";
-        return false;
+    // Use double for accuracy. `float` precision may classify small-are
+    // polygon as degenerated. Find the normal axis of the polygon using
+    // Newell's method
+    value::double3 n = {0, 0, 0};
+    for (uint32_t k = 0; k < npolys; ++k) {
+      const T &point1 = points[fvIndices[k]];
+      const T &point2 = points[fvIndices[(k + 1) % npolys]];
+
+      double a[3] = {double(point1[0]) - double(point2[0]),
+                     double(point1[1]) - double(point2[1]),
+                     double(point1[2]) - double(point2[2])};
+      double b[3] = {double(point1[0]) + double(point2[0]),
+                     double(point1[1]) + double(point2[1]),
+                     double(point1[2]) + double(point2[2])};
+
+      n[0] += a[1] * b[2];
+      n[1] += a[2] * b[0];
+      n[2] += a[0] * b[1];
+    }
+
+    // Convexity: every corner turns in the direction of the normal.
+    uint32_t numReflex = 0;
+    uint32_t reflexCorner = 0;
+    for (uint32_t k = 0; k < npolys; k++) {
+      const T &p0 = points[fvIndices[(k + npolys - 1) % npolys]];
+      const T &p1 = points[fvIndices[k]];
+      const T &p2 = points[fvIndices[(k + 1) % npolys]];
+      value::double3 e0 = {double(p1[0]) - double(p0[0]),
+                           double(p1[1]) - double(p0[1]),
+                           double(p1[2]) - double(p0[2])};
+      value::double3 e1 = {double(p2[0]) - double(p1[0]),
+                           double(p2[1]) - double(p1[1]),
+                           double(p2[2]) - double(p1[2])};
+      if (vdot(vcross(e0, e1), n) < 0.0) {
+        numReflex++;
+        reflexCorner = k;
+      }
+    }
+
+    if (npolys == 4) {
+      if ((numReflex == 1) && (reflexCorner & 1)) {
+        // Concave at corner 1 or 3. Split along 1-3.
+        emit(i, 0, 0, 1, 3);
+        emit(i, 1, 1, 2, 3);
+      } else {
+        // Use simple split
+        // TODO: Split at shortest edge for better triangulation.
+        emit(i, 0, 0, 1, 2);
+        emit(i, 1, 0, 2, 3);
       }
+      triangulatedFaceCounts[i] = 2;
+      return true;
+    }
 
-      // Negative is to flip the normal to the correct direction
-      n = vnormalize(n);
+    double length_n = vlength(n);
 
-      T axis_w, axis_v, axis_u;
-      axis_w[0] = BaseTy(n[0]);
-      axis_w[1] = BaseTy(n[1]);
-      axis_w[2] = BaseTy(n[2]);
-      T a;
-      if (std::fabs(axis_w[0]) > BaseTy(0.9999999)) {  // TODO: use 1.0 - eps?
-        a = {BaseTy(0), BaseTy(1), BaseTy(0)};
-      } else {
-        a = {BaseTy(1), BaseTy(0), BaseTy(0)};
+    // Check if zero length normal
+    if (std::fabs(length_n) < std::numeric_limits<double>::epsilon()) {
+      DCOUT("length_n " << length_n);
+      errs[size_t(thread_id)] = "Degenerated polygon found.\n";
+      return false;
+    }
+
+    if (numReflex == 0) {
+      // Convex polygon. Fan triangulation.
+      for (uint32_t k = 0; k < (npolys - 2); k++) {
+        emit(i, k, 0, k + 1, k + 2);
       }
-      axis_v = vnormalize(vcross(axis_w, a));
-      axis_u = vcross(axis_w, axis_v);
+      triangulatedFaceCounts[i] = npolys - 2;
+      return true;
+    }
 
-      using Point3D = std::array<BaseTy, 3>;
-      using Point2D = std::array<BaseTy, 2>;
-      std::vector<Point2D> polyline;
+    // Concave polygon. Project to the plane and use earcut.
+    n = vnormalize(n);
 
-      // TMW change: Find best normal and project v0x and v0y to those
-      // coordinates, instead of picking a plane aligned with an axis (which
-      // can flip polygons).
+    T axis_w, axis_v, axis_u;
+    axis_w[0] = BaseTy(n[0]);
+    axis_w[1] = BaseTy(n[1]);
+    axis_w[2] = BaseTy(n[2]);
+    T a;
+    if (std::fabs(axis_w[0]) > BaseTy(0.9999999)) {  // TODO: use 1.0 - eps?
+      a = {BaseTy(0), BaseTy(1), BaseTy(0)};
+    } else {
+      a = {BaseTy(1), BaseTy(0), BaseTy(0)};
+    }
+    axis_v = vnormalize(vcross(axis_w, a));
+    axis_u = vcross(axis_w, axis_v);
 
-      // Fill polygon data.
-      for (size_t k = 0; k < npolys; k++) {
-        size_t vidx = faceVertexIndices[faceIndexOffset + k];
+    std::unique_ptr<Scratch> &scratch = scratches[size_t(thread_id)];
+    if (!scratch) {
+      scratch.reset(new Scratch());
+      scratch->polygon_2d.resize(1);  // Single polygon only(no holes)
+    }
 
-        value::float3 v = points[vidx];
-        // Point3 polypoint = {v0[0],v0[1],v0[2]};
+    // TMW change: Find best normal and project v0x and v0y to those
+    // coordinates, instead of picking a plane aligned with an axis (which
+    // can flip polygons).
+    std::vector<Point2D> &polyline = scratch->polygon_2d[0];
+    polyline.clear();
+    for (uint32_t k = 0; k < npolys; k++) {
+      const T &v = points[fvIndices[k]];
 
-        // world to local
-        Point3D loc = {vdot(v, axis_u), vdot(v, axis_v), vdot(v, axis_w)};
+      // world to local
+      polyline.push_back({vdot(v, axis_u), vdot(v, axis_v)});
+    }
 
-        polyline.push_back({loc[0], loc[1]});
-      }
+    scratch->earcut(scratch->polygon_2d);
+    const std::vector<uint32_t> &indices = scratch->earcut.indices;
+    //  => result = 3 * faces, clockwise in (axis_u, axis_v), i.e. reversed
+    //  winding of the polygon.
 
-      std::vector<std::vector<Point2D>> polygon_2d;
-      // Single polygon only(no holes)
+    size_t ntris = indices.size() / 3;
+    if (((indices.size() % 3) != 0) || (ntris > (npolys - 2))) {
+      // This should not be happen, though.
+      errs[size_t(thread_id)] = "Failed to triangulate.\n";
+      return false;
+    }
 
-      std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon_2d);
-      //  => result = 3 * faces, clockwise
+    for (size_t k = 0; k < ntris; k++) {
+      emit(i, k, indices[3 * k + 0], indices[3 * k + 2], indices[3 * k + 1]);
+    }
+    triangulatedFaceCounts[i] = uint32_t(ntris);
 
-      if ((indices.size() % 3) != 0) {
-        // This should not be happen, though.
-        err = "Failed to triangulate.\n";
-        return false;
-      }
+    if (ntris < (npolys - 2)) {
+      // Degenerated vertices are removed by earcut.
+      needsCompaction[size_t(thread_id)] = 1;
+    }
 
-      size_t ntris = indices.size() / 3;
+    return true;
+  };
 
-      // Up to 2GB tris.
-      if (ntris > size_t((std::numeric_limits<int32_t>::max)())) {
-        err = "Too many triangles are generated.\n";
-        return false;
-      }
+  parallel::ParallelForChunked(
+      num_faces,
+      [&](size_t begin, size_t end, int thread_id) {
+        for (size_t i = begin; i < end; i++) {
+          if (i > errFaces[size_t(thread_id)]) {
+            // Only the first error(per thread) is reported.
+            break;
+          }
+          if (!triangulateFace(i, thread_id)) {
+            errFaces[size_t(thread_id)] = i;
+            break;
+          }
+        }
+      },
+      num_threads, 1024);
 
-      for (size_t k = 0; k < ntris; k++) {
-        triangulatedFaceVertexCounts.push_back(3);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 0]]);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 1]]);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 2]]);
+  // Report the error of the first failed face.
+  size_t errThread = 0;
+  for (size_t t = 1; t < errFaces.size(); t++) {
+    if (errFaces[t] < errFaces[errThread]) {
+      errThread = t;
+    }
+  }
+  if (errFaces[errThread] != (std::numeric_limits<size_t>::max)()) {
+    err = errs[errThread];
+    return false;
+  }
 
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 0]);
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 1]);
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 2]);
+  //
+  // 3. Remove unused triangle slots(rare).
+  //
+  if (std::find(needsCompaction.begin(), needsCompaction.end(), uint8_t(1)) !=
+      needsCompaction.end()) {
+    size_t dst = 0;
+    for (size_t i = 0; i < num_faces; i++) {
+      size_t src = triOffsets[i];
+      for (size_t k = 0; k < 3 * size_t(triangulatedFaceCounts[i]); k++) {
+        triangulatedFaceVertexIndices[3 * dst + k] =
+            triangulatedFaceVertexIndices[3 * src + k];
+        triangulatedToOrigFaceVertexIndexMap[3 * dst + k] =
+            triangulatedToOrigFaceVertexIndexMap[3 * src + k];
       }
-      triangulatedFaceCounts.push_back(uint32_t(ntris));
+      dst += triangulatedFaceCounts[i];
     }
-
-    faceIndexOffset += npolys;
+    triangulatedFaceVertexCounts.resize(dst);
+    triangulatedFaceVertexIndices.resize(3 * dst);
+    triangulatedToOrigFaceVertexIndexMap.resize(3 * dst);
   }
 
   return true;
@@ -2742,6 +2953,7 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
         std::vector<value::float3> tmpPointOffsets;
         std::vector<value::float3> tmpNormalOffsets;
         std::vector<uint32_t> tmpPointIndices;
+        std::unordered_map<float, InbetweenShapeTarget> tmpInbetweens;
 
         for (size_t i = 0; i < target.second.pointIndices.size(); i++) {
 
@@ -2765,6 +2977,18 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
               tmpNormalOffsets.push_back(target.second.normalOffsets[i]);
             }
 
+            // In-between offsets are parallel to pointIndices.
+            for (const auto &ib : target.second.inbetweens) {
+              InbetweenShapeTarget &tmpIb = tmpInbetweens[ib.first];
+              tmpIb.weight = ib.second.weight;
+              if (i < ib.second.pointOffsets.size()) {
+                tmpIb.pointOffsets.push_back(ib.second.pointOffsets[i]);
+              }
+              if (i < ib.second.normalOffsets.size()) {
+                tmpIb.normalOffsets.push_back(ib.second.normalOffsets[i]);
+              }
+            }
+
             tmpPointIndices.push_back(dstPointIndices[k]);
           }
         }
@@ -2772,11 +2996,10 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
         target.second.pointIndices.swap(tmpPointIndices);
         target.second.pointOffsets.swap(tmpPointOffsets);
         target.second.normalOffsets.swap(tmpNormalOffsets);
+        target.second.inbetweens.swap(tmpInbetweens);
 
       }
 
-      // TODO: Inbetween BlendShapes
-
     }
 
   }
@@ -2844,6 +3067,7 @@ bool RenderSceneConverter::ConvertMesh(
     const std::vector<std::pair<std::string, const tinyusdz::BlendShape *>>
         &blendshapes,
     RenderMesh *dstMesh) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::ConvertMesh");
   //
   // Steps:
   //
@@ -3408,6 +3632,135 @@ bool RenderSceneConverter::ConvertMesh(
     }
   }
 
+#if defined(TINYUSDZ_WITH_OPENSUBDIV)
+  ///
+  /// 3.5. Subdivide
+  ///  - Refine points and vertex attributes with cached stencil tables.
+  ///  - Remap faceIndex in MaterialSubset(GeomSubset).
+  ///
+  if ((env.mesh_config.subdivision_level > 0) &&
+      (mesh.subdivisionScheme.get_value() !=
+       GeomMesh::SubdivisionScheme::SubdivisionSchemeNone)) {
+    if (blendshapes.size() || mesh.has_primvar("skel:jointIndices")) {
+      PUSH_WARN(fmt::format(
+          "Subdivision of skinned Mesh or Mesh with BlendShapes is not "
+          "supported. Mesh `{}` is not subdivided.",
+          abs_path.prim_part()));
+    } else {
+      SubdividerOptions options;
+      options.level = env.mesh_config.subdivision_level;
+      if (mesh.subdivisionScheme.get_value() ==
+          GeomMesh::SubdivisionScheme::Loop) {
+        options.scheme = SubdivisionScheme::Loop;
+      } else if (mesh.subdivisionScheme.get_value() ==
+                 GeomMesh::SubdivisionScheme::Bilinear) {
+        options.scheme = SubdivisionScheme::Bilinear;
+      }
+      GeomMesh::InterpolateBoundary boundary;
+      if (mesh.interpolateBoundary.get_value().get(env.timecode, &boundary)) {
+        if (boundary ==
+            GeomMesh::InterpolateBoundary::InterpolateBoundaryNone) {
+          options.boundary_interpolation = BoundaryInterpolation::None;
+        } else if (boundary == GeomMesh::InterpolateBoundary::EdgeOnly) {
+          options.boundary_interpolation = BoundaryInterpolation::EdgeOnly;
+        } else {
+          options.boundary_interpolation =
+              BoundaryInterpolation::EdgeAndCorner;
+        }
+      }
+
+      std::shared_ptr<Subdivider> &subdivider =
+          _subdivider_cache[abs_path.prim_part()];
+      if (!subdivider) {
+        subdivider = std::make_shared<Subdivider>();
+      }
+
+      std::string err;
+      if (!subdivider->Setup(options, dst.points.size(),
+                             dst.usdFaceVertexCounts, dst.usdFaceVertexIndices,
+                             &err)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to setup subdivision for Mesh `{}`: {}",
+                        abs_path.prim_part(), err));
+      }
+
+      const size_t num_face_vertices = dst.usdFaceVertexIndices.size();
+
+      std::vector<float> refined;
+      if (!subdivider->RefineVertex(
+              reinterpret_cast<const float *>(dst.points.data()), 3,
+              &refined)) {
+        PUSH_ERROR_AND_RETURN("Failed to subdivide points.");
+      }
+      dst.points.resize(refined.size() / 3);
+      memcpy(dst.points.data(), refined.data(), sizeof(float) * refined.size());
+
+      if (!SubdivideVertexAttribute(dst.normals, *subdivider,
+                                    num_face_vertices, &_err)) {
+        return false;
+      }
+      // Interpolated normals are not unit length.
+      if (dst.normals.format == VertexAttributeFormat::Vec3) {
+        vec3 *normals = reinterpret_cast<vec3 *>(dst.normals.data.data());
+        for (size_t i = 0; i < dst.normals.vertex_count(); i++) {
+          normals[i] = vnormalize(normals[i]);
+        }
+      }
+
+      if (!SubdivideVertexAttribute(dst.tangents, *subdivider,
+                                    num_face_vertices, &_err)) {
+        return false;
+      }
+      if (!SubdivideVertexAttribute(dst.binormals, *subdivider,
+                                    num_face_vertices, &_err)) {
+        return false;
+      }
+      for (auto &it : dst.texcoords) {
+        if (!SubdivideVertexAttribute(it.second, *subdivider,
+                                      num_face_vertices, &_err)) {
+          return false;
+        }
+      }
+      if (!SubdivideVertexAttribute(dst.vertex_colors, *subdivider,
+                                    num_face_vertices, &_err)) {
+        return false;
+      }
+      if (!SubdivideVertexAttribute(dst.vertex_opacities, *subdivider,
+                                    num_face_vertices, &_err)) {
+        return false;
+      }
+
+      // Refined faces of each GeomSubset. Refined faces are not contiguous for
+      // the parent face in general, so scan all refined faces.
+      if (dst.material_subsetMap.size()) {
+        const std::vector<uint32_t> &parents =
+            subdivider->refined_face_parents();
+        std::vector<uint8_t> in_subset(dst.usdFaceVertexCounts.size());
+        for (auto &it : dst.material_subsetMap) {
+          std::fill(in_subset.begin(), in_subset.end(), uint8_t(0));
+          for (int32_t idx : it.second.usdIndices) {
+            if ((idx < 0) || (size_t(idx) >= in_subset.size())) {
+              PUSH_ERROR_AND_RETURN("Invalid index value in GeomSubset.");
+            }
+            in_subset[size_t(idx)] = 1;
+          }
+
+          std::vector<int> refined_indices;
+          for (size_t f = 0; f < parents.size(); f++) {
+            if (in_subset[parents[f]]) {
+              refined_indices.push_back(int(f));
+            }
+          }
+          it.second.usdIndices = std::move(refined_indices);
+        }
+      }
+
+      dst.usdFaceVertexCounts = subdivider->refined_face_vertex_counts();
+      dst.usdFaceVertexIndices = subdivider->refined_face_vertex_indices();
+    }
+  }
+#endif
+
   ///
   /// 4. Triangulate
   ///  - triangulate faceVertexCounts, faceVertexIndices
@@ -3765,10 +4118,6 @@ bool RenderSceneConverter::ConvertMesh(
       continue;
     }
 
-    //
-    // TODO: in-between attribs
-    //
-
     std::vector<int> vertex_indices;
     std::vector<value::vector3f> normal_offsets;
     std::vector<value::vector3f> vertex_offsets;
@@ -3799,7 +4148,7 @@ bool RenderSceneConverter::ConvertMesh(
             "negative index in `pointIndices`. Prim path: `{}`", bs_path));
       }
 
-      if (uint32_t(vertex_indices[i]) > dst.points.size()) {
+      if (uint32_t(vertex_indices[i]) >= dst.points.size()) {
         PUSH_ERROR_AND_RETURN(
             fmt::format("pointIndices[{}] {} exceeds the number of points in "
                         "GeomMesh {}. Prim path: `{}`",
@@ -3824,7 +4173,55 @@ bool RenderSceneConverter::ConvertMesh(
              sizeof(value::normal3f) * normal_offsets.size());
     }
 
-    // TODO inbetweens
+    // In-betweens: `inbetweens:NAME`(with `weight` metadata) and
+    // `inbetweens:NAME:normalOffsets`
+    for (const auto &pit : bs->props) {
+      const std::string &prop_name = pit.first;
+      if (!startsWith(prop_name, "inbetweens:")) {
+        continue;
+      }
+      std::string ib_name = removePrefix(prop_name, "inbetweens:");
+      if (ib_name.empty() || contains(ib_name, ':')) {
+        continue;
+      }
+
+      if (!pit.second.is_attribute()) {
+        continue;
+      }
+      const Attribute &ib_attr = pit.second.get_attribute();
+
+      if (!ib_attr.metas().weight) {
+        PUSH_WARN(fmt::format("`weight` metadata is not authored for in-between `{}`. Skipping. Prim path: `{}`", prop_name, bs_path));
+        continue;
+      }
+      float ib_weight = float(ib_attr.metas().weight.value());
+
+      std::vector<value::vector3f> ib_offsets;
+      if (!ib_attr.get_value(&ib_offsets) ||
+          (ib_offsets.size() != vertex_offsets.size())) {
+        PUSH_WARN(fmt::format("In-between `{}` must be vector3f[] with the same length as `offsets`. Skipping. Prim path: `{}`", prop_name, bs_path));
+        continue;
+      }
+
+      InbetweenShapeTarget ib;
+      ib.weight = ib_weight;
+      ib.pointOffsets.resize(ib_offsets.size());
+      memcpy(ib.pointOffsets.data(), ib_offsets.data(),
+             sizeof(value::vector3f) * ib_offsets.size());
+
+      auto nit = bs->props.find(prop_name + ":normalOffsets");
+      if ((nit != bs->props.end()) && nit->second.is_attribute()) {
+        std::vector<value::vector3f> ib_normal_offsets;
+        if (nit->second.get_attribute().get_value(&ib_normal_offsets) &&
+            (ib_normal_offsets.size() == ib_offsets.size())) {
+          ib.normalOffsets.resize(ib_normal_offsets.size());
+          memcpy(ib.normalOffsets.data(), ib_normal_offsets.data(),
+                 sizeof(value::vector3f) * ib_normal_offsets.size());
+        }
+      }
+
+      shapeTarget.inbetweens[ib_weight] = std::move(ib);
+    }
 
     // TODO: key duplicate check
     dst.targets[bs->name] = shapeTarget;
@@ -3979,7 +4376,7 @@ namespace {
 // Convert UsdTransform2d -> PrimvarReader_float2 shader network.
 nonstd::expected<bool, std::string> ConvertTexTransform2d(
     const Stage &stage, const Path &tx_abs_path, const UsdTransform2d &tx,
-    UVTexture *tex_out, double timecode) {
+    UVTexture *tex_out, double timecode, ConnectionGraph *graph = nullptr) {
   float rotation;  // in angles
   if (!tx.rotation.get_value().get(timecode, &rotation)) {
     return nonstd::make_unexpected(
@@ -4028,7 +4425,14 @@ nonstd::expected<bool, std::string> ConvertTexTransform2d(
   std::string err;
 
   const Prim *pprim{nullptr};
-  if (!stage.find_prim_at_path(Path(prim_part, ""), pprim, &err)) {
+  if (graph) {
+    pprim = graph->GetPrim(Path(prim_part, ""));
+    if (!pprim) {
+      return nonstd::make_unexpected(fmt::format(
+          "`inputs:in` connection Path not found in the Stage. {}\n",
+          prim_part));
+    }
+  } else if (!stage.find_prim_at_path(Path(prim_part, ""), pprim, &err)) {
     return nonstd::make_unexpected(fmt::format(
         "`inputs:in` connection Path not found in the Stage. {}\n", prim_part));
   }
@@ -4069,7 +4473,12 @@ nonstd::expected<bool, std::string> ConvertTexTransform2d(
   }
 #else
   TerminalAttributeValue attr;
-  if (!tydra::EvaluateAttribute(stage, *pprim, "inputs:varname", &attr, &err)) {
+  bool varname_ret =
+      graph ? graph->EvaluateAttribute(Path(prim_part, ""), "inputs:varname",
+                                       &attr, &err)
+            : tydra::EvaluateAttribute(stage, *pprim, "inputs:varname", &attr,
+                                       &err);
+  if (!varname_ret) {
     return nonstd::make_unexpected(
         "`inputs:varname` evaluation failed: " + err + "\n");
   }
@@ -4127,7 +4536,8 @@ nonstd::expected<bool, std::string> ConvertTexTransform2d(
 template <typename T>
 nonstd::expected<bool, std::string> GetConnectedUVTexture(
     const Stage &stage, const TypedAnimatableAttributeWithFallback<T> &src,
-    Path *tex_abs_path, const UsdUVTexture **dst, const Shader **shader_out) {
+    Path *tex_abs_path, const UsdUVTexture **dst, const Shader **shader_out,
+    ConnectionGraph *graph = nullptr) {
   if (!dst) {
     return nonstd::make_unexpected("[InternalError] dst is nullptr.\n");
   }
@@ -4148,7 +4558,18 @@ nonstd::expected<bool, std::string> GetConnectedUVTexture(
   // => path.prop_part : outputs:rgb
   //
 
-  const Path &path = src.get_connections()[0];
+  Path path = src.get_connections()[0];
+
+  // Follow connections through NodeGraph/Material interface inputs.
+  if (graph) {
+    std::string terminal_err;
+    Path terminal_path;
+    if (!graph->GetTerminalAttributePath(path, &terminal_path,
+                                         &terminal_err)) {
+      return nonstd::make_unexpected(terminal_err + "\n");
+    }
+    path = terminal_path;
+  }
 
   const std::string prim_part = path.prim_part();
   const std::string prop_part = path.prop_part();
@@ -4180,7 +4601,13 @@ nonstd::expected<bool, std::string> GetConnectedUVTexture(
 
   const Prim *prim{nullptr};
   std::string err;
-  if (!stage.find_prim_at_path(Path(prim_part, ""), prim, &err)) {
+  if (graph) {
+    prim = graph->GetPrim(Path(prim_part, ""));
+    if (!prim) {
+      return nonstd::make_unexpected(
+          fmt::format("Prim {} not found in the Stage.\n", prim_part));
+    }
+  } else if (!stage.find_prim_at_path(Path(prim_part, ""), prim, &err)) {
     return nonstd::make_unexpected(
         fmt::format("Prim {} not found in the Stage: {}\n", prim_part, err));
   }
@@ -4211,6 +4638,108 @@ nonstd::expected<bool, std::string> GetConnectedUVTexture(
                   prim->prim_type_name()));
 }
 
+///
+/// Whether texels decoded for `texture` are sRGB encoded 8bit texels. Same rule
+/// as the colorSpace inference in ConvertUVTexture. Used to filter texels in
+/// linear space when they are resized before the color space conversion.
+///
+bool IsSRGBTexels(const UsdUVTexture &texture, double timecode,
+                  const TextureImage &image) {
+  if (image.assetTexelComponentType != ComponentType::UInt8) {
+    return false;
+  }
+
+  if (texture.file.metas().has_colorSpace()) {
+    ColorSpace cs;
+    if (InferColorSpace(texture.file.metas().get_colorSpace(), &cs)) {
+      return cs == tydra::ColorSpace::sRGB;
+    }
+  }
+
+  if (texture.sourceColorSpace.authored()) {
+    UsdUVTexture::SourceColorSpace cs;
+    if (texture.sourceColorSpace.get_value().get(timecode, &cs)) {
+      if (cs == UsdUVTexture::SourceColorSpace::SRGB) {
+        return true;
+      } else if (cs == UsdUVTexture::SourceColorSpace::Raw) {
+        return false;
+      } else if (cs == UsdUVTexture::SourceColorSpace::Auto) {
+        return (image.channels == 3) || (image.channels == 4);
+      }
+    }
+  }
+
+  return image.usdColorSpace == tydra::ColorSpace::sRGB;
+}
+
+///
+/// Downscale decoded texels and build their mip chain(before the color space
+/// conversion). Done per asset, so that PrefetchTextureImages workers run it
+/// in parallel.
+///
+/// @param[in] srgb Texels are sRGB encoded(filtered in linear space).
+/// @param[inout] image Decoded TextureImage. Size and `mipLevels` are updated.
+/// @param[inout] data Decoded texels.
+///
+bool ProcessDecodedTexels(const MaterialConverterConfig &config, bool srgb,
+                          TextureImage *image, std::vector<uint8_t> *data,
+                          std::string *warn, std::string *err) {
+  const bool supported =
+      (image->assetTexelComponentType == ComponentType::UInt8) ||
+      (image->assetTexelComponentType == ComponentType::Float);
+
+  if (config.max_texture_size > 0) {
+    size_t width = size_t(image->width);
+    size_t height = size_t(image->height);
+    size_t dst_width, dst_height;
+    ComputeDownscaledTextureSize(width, height, config.max_texture_size,
+                                 &dst_width, &dst_height);
+
+    if ((dst_width != width) || (dst_height != height)) {
+      if (supported) {
+        std::vector<uint8_t> resized;
+        std::string resize_err;
+        if (!ResizeTexels(*data, image->assetTexelComponentType, width, height,
+                          size_t(image->channels), dst_width, dst_height, srgb,
+                          &resized, &resize_err)) {
+          if (err) {
+            (*err) += "Failed to downscale texture image: " + resize_err;
+          }
+          return false;
+        }
+
+        (*data) = std::move(resized);
+        image->width = int32_t(dst_width);
+        image->height = int32_t(dst_height);
+      } else if (warn) {
+        (*warn) += fmt::format("Texture image is not downscaled since its texel format is {}.\n", to_string(image->assetTexelComponentType));
+      }
+    }
+  }
+
+  if (config.generate_texture_mipmaps) {
+    if (supported) {
+      BufferData src;
+      src.componentType = image->assetTexelComponentType;
+      src.data = std::move(*data);
+
+      BufferData mipBuffer;
+      std::string mip_err;
+      if (!BuildTextureMipChain(src, srgb, image, &mipBuffer, &mip_err)) {
+        if (err) {
+          (*err) += "Failed to generate mipmaps: " + mip_err;
+        }
+        return false;
+      }
+      (*data) = std::move(mipBuffer.data);
+    } else if (warn) {
+      (*warn) += fmt::format("Mipmaps are not generated since its texel format is {}.\n", to_string(image->assetTexelComponentType));
+    }
+  }
+
+  return true;
+}
+
 }  // namespace
 
 // Convert UsdUVTexture shader node.
@@ -4226,6 +4755,7 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
                                             const AssetInfo &assetInfo,
                                             const UsdUVTexture &texture,
                                             UVTexture *tex_out) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::ConvertUVTexture");
   DCOUT("ConvertUVTexture " << tex_abs_path);
 
   if (!tex_out) {
@@ -4261,24 +4791,73 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
     // Texel data is treated as byte array
     assetImageBuffer.componentType = ComponentType::UInt8;
 
+    // Decoded texel data is transient(released at the end of this scope).
+    ScopedMemoryReservation asset_reservation(env.scene_config.memory_budget.get(),
+                                              MemoryCategory::Assets);
+
     bool tex_loaded{false};
 
+    // Decoded texture image(shared among UVTextures using the same asset).
+    PrefetchedTextureImage *prefetched{nullptr};
+    std::string resolved_path;
+
+    TextureImageLoaderFunction tex_loader_fun =
+        env.material_config.texture_image_loader_function;
+
+    if (!tex_loader_fun) {
+      tex_loader_fun = DefaultTextureImageLoaderFunction;
+    }
+
     if (env.scene_config.load_texture_assets) {
       DCOUT("load texture : " << assetPath.GetAssetPath());
       std::string warn;
 
-      TextureImageLoaderFunction tex_loader_fun =
-          env.material_config.texture_image_loader_function;
+      resolved_path = env.asset_resolver.resolve(assetPath.GetAssetPath());
+      if (resolved_path.empty()) {
+        resolved_path = assetPath.GetAssetPath();
+      }
+
+      auto it = _prefetched_texture_images.find(resolved_path);
+      if (it == _prefetched_texture_images.end()) {
+        // Not prefetched. Decode it now and cache it, so that other UVTextures
+        // using the same asset do not decode it again.
+        PrefetchedTextureImage decoded;
+        decoded.loaded = tex_loader_fun(
+            assetPath, assetInfo, env.asset_resolver, &decoded.image,
+            &decoded.data,
+            env.material_config.texture_image_loader_function_userdata,
+            &decoded.warn, &decoded.err);
+
+        if (decoded.loaded) {
+          decoded.srgb = IsSRGBTexels(texture, env.timecode, decoded.image);
+          if (!ProcessDecodedTexels(env.material_config, decoded.srgb,
+                                    &decoded.image, &decoded.data,
+                                    &decoded.warn, &decoded.err)) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Texture image `{}`: {}", assetPath.GetAssetPath(), decoded.err));
+          }
+        }
+
+        if (decoded.loaded && env.scene_config.memory_budget) {
+          std::string budget_err;
+          if (!env.scene_config.memory_budget->reserve(
+                  MemoryCategory::Assets, decoded.data.size(), &budget_err)) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", assetPath.GetAssetPath(), budget_err));
+          }
+          _prefetch_memory_budget = env.scene_config.memory_budget;
+          _prefetch_memory_bytes += decoded.data.size();
+        }
 
-      if (!tex_loader_fun) {
-        tex_loader_fun = DefaultTextureImageLoaderFunction;
+        it = _prefetched_texture_images
+                 .emplace(resolved_path, std::move(decoded))
+                 .first;
       }
+      prefetched = &(it->second);
 
-      tex_loaded = tex_loader_fun(
-          assetPath, assetInfo, env.asset_resolver, &texImage,
-          &assetImageBuffer.data,
-          env.material_config.texture_image_loader_function_userdata, &warn,
-          &err);
+      // Texel data is moved later(only when the image is not shared).
+      tex_loaded = prefetched->loaded;
+      texImage = prefetched->image;
+      warn = prefetched->warn;
+      err = prefetched->err;
 
       if (warn.size()) {
         DCOUT("WARN: " << warn);
@@ -4289,7 +4868,6 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
         PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", assetPath.GetAssetPath(), err));
       }
 
-
       if (err.size()) {
         // report as warn.
         PUSH_WARN(fmt::format("Failed to load texture image: `{}`. Skip loading. reason = {} ", assetPath.GetAssetPath(), err));
@@ -4370,15 +4948,97 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
                       cs_token.str()));
     }
 
+    // Share TextureImage/BufferData among UVTextures which use the same
+    // asset and colorSpace.
+    std::string shared_image_key;
+    int64_t shared_image_id{-1};
     if (tex_loaded) {
+      shared_image_key =
+          resolved_path + "#" + to_string(texImage.usdColorSpace);
+      const auto it = _shared_texture_image_ids.find(shared_image_key);
+      if (it != _shared_texture_image_ids.end()) {
+        shared_image_id = it->second;
+      } else {
+        // Resized texels are filtered according to the colorSpace, so they
+        // can be used only when the colorSpace agrees.
+        const bool srgb =
+            (texImage.assetTexelComponentType == ComponentType::UInt8) &&
+            (texImage.usdColorSpace == tydra::ColorSpace::sRGB);
+        const bool filtered = (env.material_config.max_texture_size > 0) ||
+                              env.material_config.generate_texture_mipmaps;
+
+        if (!prefetched->data_consumed &&
+            (!filtered || (prefetched->srgb == srgb))) {
+          // The first user of the asset takes over the decoded texels and
+          // their reservation.
+          assetImageBuffer.data = std::move(prefetched->data);
+          prefetched->data_consumed = true;
+
+          const uint64_t nbytes = assetImageBuffer.data.size();
+          if (_prefetch_memory_budget) {
+            _prefetch_memory_bytes -= (std::min)(nbytes, _prefetch_memory_bytes);
+            asset_reservation.adopt(nbytes);
+          }
+        } else {
+          // Same asset with another colorSpace. Decode it again.
+          TextureImage reloaded_image;
+          std::string reload_warn;
+          std::string reload_err;
+          if (!tex_loader_fun(
+                  assetPath, assetInfo, env.asset_resolver, &reloaded_image,
+                  &assetImageBuffer.data,
+                  env.material_config.texture_image_loader_function_userdata,
+                  &reload_warn, &reload_err)) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", assetPath.GetAssetPath(), reload_err));
+          }
+
+          if (!ProcessDecodedTexels(env.material_config, srgb, &reloaded_image,
+                                    &assetImageBuffer.data, &reload_warn,
+                                    &reload_err)) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Texture image `{}`: {}", assetPath.GetAssetPath(), reload_err));
+          }
+          texImage.width = reloaded_image.width;
+          texImage.height = reloaded_image.height;
+          texImage.mipLevels = reloaded_image.mipLevels;
+
+          std::string budget_err;
+          if (!asset_reservation.reserve(assetImageBuffer.data.size(),
+                                         &budget_err)) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", assetPath.GetAssetPath(), budget_err));
+          }
+        }
+      }
+    }
+
+    if (tex_loaded && (shared_image_id >= 0)) {
+      tex.texture_image_id = shared_image_id;
+
+      DCOUT("Use shared texture image " << assetPath.GetAssetPath()
+                                        << " : image_id " << shared_image_id);
+
+    } else if (tex_loaded) {
       BufferData imageBuffer;
 
+      // Texels are downscaled and mip chain is built when decoded. Each texel
+      // is converted independently, so a mip chain is converted as an array
+      // of(1 x N) texels.
+      size_t conv_width = size_t(texImage.width);
+      size_t conv_height = size_t(texImage.height);
+      if (!texImage.mipLevels.empty()) {
+        conv_width = 1;
+        conv_height = 0;
+        for (const auto &level : texImage.mipLevels) {
+          conv_height += size_t(level.width) * size_t(level.height);
+        }
+      }
+      const uint64_t src_texel_bytes = assetImageBuffer.data.size();
+
       // Linearlization and widen texel bit depth if required.
       if (env.material_config.linearize_color_space) {
         // TODO: Support ACEScg and Lin_DisplayP3
         DCOUT("linearlize colorspace.");
-        size_t width = size_t(texImage.width);
-        size_t height = size_t(texImage.height);
+        size_t width = conv_width;
+        size_t height = conv_height;
         size_t channels = size_t(texImage.channels);
 
         if (channels > 4) {
@@ -4509,8 +5169,8 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
             imageBuffer = std::move(assetImageBuffer);
 
           } else {
-            size_t width = size_t(texImage.width);
-            size_t height = size_t(texImage.height);
+            size_t width = conv_width;
+            size_t height = conv_height;
             size_t channels = size_t(texImage.channels);
 
             // u8 to f32, but no sRGB -> linear conversion(this would break
@@ -4546,18 +5206,78 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
         }
       }
 
+      // Texel size of the mip chain may be widened(e.g. u8 -> fp32).
+      if (!texImage.mipLevels.empty() && src_texel_bytes &&
+          (imageBuffer.data.size() != src_texel_bytes)) {
+        for (auto &level : texImage.mipLevels) {
+          level.byte_offset =
+              level.byte_offset * imageBuffer.data.size() / src_texel_bytes;
+          level.byte_length =
+              level.byte_length * imageBuffer.data.size() / src_texel_bytes;
+        }
+      }
+
+      // Source texels are no longer used.
+      assetImageBuffer.data.clear();
+      assetImageBuffer.data.shrink_to_fit();
+      asset_reservation.release();
+
+      // Block compression.
+      const TextureCompressionFormat compression_format =
+          env.material_config.texture_compression_format;
+      if (compression_format != TextureCompressionFormat::None) {
+        if ((texImage.assetTexelComponentType == ComponentType::UInt8) ||
+            (texImage.assetTexelComponentType == ComponentType::Int8)) {
+          BufferData compressedBuffer;
+          std::string compress_err;
+          if (!CompressTextureImage(
+                  imageBuffer, compression_format,
+                  env.material_config.texture_compression_mipmaps, &texImage,
+                  &compressedBuffer, &compress_err,
+                  env.material_config.texture_compression_num_threads)) {
+            PUSH_ERROR_AND_RETURN(fmt::format("Failed to compress texture image `{}`: {}", assetPath.GetAssetPath(), compress_err));
+          }
+          imageBuffer = std::move(compressedBuffer);
+        } else {
+          PUSH_WARN(fmt::format("Texture image `{}` is not compressed since its texel format is {}(only 8bit texture is compressed).", assetPath.GetAssetPath(), to_string(texImage.assetTexelComponentType)));
+        }
+      }
+
+      if (!_buffer_reservation.budget()) {
+        _buffer_reservation = MemoryReservation(env.scene_config.memory_budget);
+      }
+      {
+        std::string budget_err;
+        if (!_buffer_reservation.reserve(MemoryCategory::TydraBuffers,
+                                         imageBuffer.data.size(),
+                                         &budget_err)) {
+          PUSH_ERROR_AND_RETURN(fmt::format("Failed to allocate texture image buffer: `{}` err = {}", assetPath.GetAssetPath(), budget_err));
+        }
+      }
+
       // Assign buffer id
       texImage.buffer_id = int64_t(buffers.size());
 
-      // TODO: Share image data as much as possible.
-      // e.g. Texture A and B uses same image file, but texturing parameter is
-      // different.
-      buffers.emplace_back(imageBuffer);
+      // TODO: Share texels of the same image file with different colorSpace
+      // (they are keyed separately in `_shared_texture_image_ids`).
+      buffers.emplace_back(std::move(imageBuffer));
 
       tex.texture_image_id = int64_t(images.size());
 
+      _shared_texture_image_ids[shared_image_key] = tex.texture_image_id;
+
       images.emplace_back(texImage);
 
+      if (env.scene_config.texture_image_loaded_callback) {
+        if (!env.scene_config.texture_image_loaded_callback(
+                uint64_t(tex.texture_image_id), images.back(),
+                buffers[size_t(texImage.buffer_id)],
+                env.scene_config.progress_callback_userdata)) {
+          PUSH_ERROR_AND_RETURN(
+              "Conversion cancelled by `texture_image_loaded_callback`.");
+        }
+      }
+
       std::stringstream ss;
       ss << "Loaded texture image " << assetPath.GetAssetPath()
          << " : buffer_id " + std::to_string(texImage.buffer_id) << "\n";
@@ -4620,9 +5340,19 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
       }
       const Path &path = paths[0];
 
+      ConnectionGraph *graph = GetConnectionGraph(env);
+
       const Prim *readerPrim{nullptr};
-      if (!env.stage.find_prim_at_path(Path(path.prim_part(), ""), readerPrim,
-                                       &err)) {
+      if (graph) {
+        readerPrim = graph->GetPrim(Path(path.prim_part(), ""));
+        if (!readerPrim) {
+          PUSH_ERROR_AND_RETURN(
+              "UsdUVTexture inputs:st connection targetPath not found in the "
+              "Stage: " +
+              path.prim_part());
+        }
+      } else if (!env.stage.find_prim_at_path(Path(path.prim_part(), ""),
+                                              readerPrim, &err)) {
         PUSH_ERROR_AND_RETURN(
             "UsdUVTexture inputs:st connection targetPath not found in the "
             "Stage: " +
@@ -4656,8 +5386,12 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
         // terminal Attribute value)
         std::string varname;
         TerminalAttributeValue attr;
-        if (!tydra::EvaluateAttribute(env.stage, *readerPrim, "inputs:varname",
-                                      &attr, &err)) {
+        bool varname_ret =
+            graph ? graph->EvaluateAttribute(Path(path.prim_part(), ""),
+                                             "inputs:varname", &attr, &err)
+                  : tydra::EvaluateAttribute(env.stage, *readerPrim,
+                                             "inputs:varname", &attr, &err);
+        if (!varname_ret) {
           PUSH_ERROR_AND_RETURN(
               fmt::format("Failed to evaluate UsdPrimvarReader_float2's "
                           "inputs:varname.\n{}",
@@ -4684,7 +5418,7 @@ bool RenderSceneConverter::ConvertUVTexture(const RenderSceneConverterEnv &env,
       } else if (const UsdTransform2d *ptransform =
                      pshader->value.as<UsdTransform2d>()) {
         auto result = ConvertTexTransform2d(env.stage, path, *ptransform, &tex,
-                                            env.timecode);
+                                            env.timecode, graph);
         if (!result) {
           PUSH_ERROR_AND_RETURN(result.error());
         }
@@ -4770,8 +5504,8 @@ bool RenderSceneConverter::ConvertPreviewSurfaceShaderParam(
     const UsdUVTexture *ptex{nullptr};
     const Shader *pshader{nullptr};
     Path texPath;
-    auto result =
-        GetConnectedUVTexture(env.stage, param, &texPath, &ptex, &pshader);
+    auto result = GetConnectedUVTexture(env.stage, param, &texPath, &ptex,
+                                        &pshader, GetConnectionGraph(env));
 
     if (!result) {
       PUSH_ERROR_AND_RETURN(result.error());
@@ -4852,8 +5586,29 @@ bool RenderSceneConverter::ConvertPreviewSurfaceShader(
       PUSH_ERROR_AND_RETURN(
           fmt::format("useSpecularWorkflow attribute is blocked."));
     } else if (shader.useSpecularWorkflow.is_connection()) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("TODO: useSpecularWorkflow with connection."));
+      ConnectionGraph *graph = GetConnectionGraph(env);
+      if (!graph) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("TODO: useSpecularWorkflow with connection."));
+      }
+
+      std::string err;
+      TerminalAttributeValue attr;
+      if (!graph->EvaluateAttribute(shader_abs_path,
+                                    "inputs:useSpecularWorkflow", &attr, &err,
+                                    env.timecode)) {
+        PUSH_ERROR_AND_RETURN(fmt::format(
+            "Failed to evaluate connected useSpecularWorkflow. {}", err));
+      }
+
+      const int *pval = attr.as<int>();
+      if (!pval) {
+        PUSH_ERROR_AND_RETURN(fmt::format(
+            "useSpecularWorkflow must be `int` type, but got {}.",
+            attr.type_name()));
+      }
+
+      rshader.useSpecularWorkflow = (*pval) ? true : false;
     } else {
       int val;
       if (!shader.useSpecularWorkflow.get_value().get(env.timecode, &val)) {
@@ -4943,6 +5698,7 @@ bool RenderSceneConverter::ConvertMaterial(const RenderSceneConverterEnv &env,
                                            const Path &mat_abs_path,
                                            const tinyusdz::Material &material,
                                            RenderMaterial *rmat_out) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::ConvertMaterial");
   if (!rmat_out) {
     PUSH_ERROR_AND_RETURN("rmat_out argument is nullptr.");
   }
@@ -5044,6 +5800,7 @@ namespace {
 struct MeshVisitorEnv {
   RenderSceneConverter *converter{nullptr};
   const RenderSceneConverterEnv *env{nullptr};
+  const MaterialBindingCache *material_bindings{nullptr};
 };
 
 bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
@@ -5167,10 +5924,9 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
         {
           tinyusdz::Path bound_material_path;
           const tinyusdz::Material *bound_material{nullptr};
-          bool ret = tinyusdz::tydra::GetBoundMaterial(
-              visitorEnv->env->stage,
-              /* GeomSubset prim path */ subset_abs_path,
-              /* purpose */ "", &bound_material_path, &bound_material, err);
+          bool ret = visitorEnv->material_bindings->GetBoundMaterial(
+              /* GeomSubset prim path */ subset_abs_path, /* purpose */ "",
+              &bound_material_path, &bound_material);
 
           if (ret && bound_material) {
             int64_t rmaterial_id = -1;  // not used.
@@ -5200,13 +5956,12 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
                        .default_backface_material_purpose_name);
           tinyusdz::Path bound_material_path;
           const tinyusdz::Material *bound_material{nullptr};
-          bool ret = tinyusdz::tydra::GetBoundMaterial(
-              visitorEnv->env->stage,
+          bool ret = visitorEnv->material_bindings->GetBoundMaterial(
               /* GeomSubset prim path */ subset_abs_path,
               /* purpose */
               visitorEnv->env->material_config
                   .default_backface_material_purpose_name,
-              &bound_material_path, &bound_material, err);
+              &bound_material_path, &bound_material);
 
           if (ret && bound_material) {
             int64_t rmaterial_id = -1;  // not used
@@ -5243,9 +5998,9 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
       {
         tinyusdz::Path bound_material_path;
         const tinyusdz::Material *bound_material{nullptr};
-        bool ret = tinyusdz::tydra::GetBoundMaterial(
-            visitorEnv->env->stage, /* GeomMesh prim path */ abs_path,
-            /* purpose */ "", &bound_material_path, &bound_material, err);
+        bool ret = visitorEnv->material_bindings->GetBoundMaterial(
+            /* GeomMesh prim path */ abs_path, /* purpose */ "",
+            &bound_material_path, &bound_material);
 
         if (ret && bound_material) {
           int64_t rmaterial_id = -1;  // not used
@@ -5271,12 +6026,12 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
           pmesh->has_materialBinding(value::token(backface_purpose))) {
         tinyusdz::Path bound_material_path;
         const tinyusdz::Material *bound_material{nullptr};
-        bool ret = tinyusdz::tydra::GetBoundMaterial(
-            visitorEnv->env->stage, /* GeomMesh prim path */ abs_path,
+        bool ret = visitorEnv->material_bindings->GetBoundMaterial(
+            /* GeomMesh prim path */ abs_path,
             /* purpose */
             visitorEnv->env->material_config
                 .default_backface_material_purpose_name,
-            &bound_material_path, &bound_material, err);
+            &bound_material_path, &bound_material);
 
         if (ret && bound_material) {
           int64_t rmaterial_id = -1;  // not used
@@ -5333,7 +6088,25 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
       }
       visitorEnv->converter->meshMap.add(abs_path.full_path_name(), mesh_id);
 
+      // NOTE: This is the only place RenderMesh is appended, and exactly one
+      // RenderMesh is appended per GeomMesh Prim. ProgressiveLoader relies on
+      // this: it reserves `meshes` for the # of GeomMesh Prims before the
+      // conversion and keeps pointers to the elements passed to
+      // `mesh_converted_callback`, so the append never reallocates there.
       visitorEnv->converter->meshes.emplace_back(std::move(rmesh));
+
+      const RenderSceneConverterConfig &scene_config =
+          visitorEnv->env->scene_config;
+      if (scene_config.mesh_converted_callback) {
+        if (!scene_config.mesh_converted_callback(
+                mesh_id, visitorEnv->converter->meshes.back(),
+                scene_config.progress_callback_userdata)) {
+          if (err) {
+            (*err) += "Conversion cancelled by `mesh_converted_callback`.\n";
+          }
+          return false;
+        }
+      }
     }
   }
 
@@ -5346,6 +6119,7 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
                                             const Path &abs_path,
                                             const SkelAnimation &skelAnim,
                                             Animation *anim_out) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::ConvertSkelAnimation");
   // The spec says
   // """
   // An animation source is only valid if its translation, rotation, and scale components are all authored, storing arrays size to the same size as the authored joints array.
@@ -5822,6 +6596,7 @@ bool RenderSceneConverter::BuildNodeHierarchyImpl(
 
 bool RenderSceneConverter::BuildNodeHierarchy(
     const RenderSceneConverterEnv &env, const XformNode &root) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::BuildNodeHierarchy");
   std::string defaultRootNode = env.stage.metas().defaultPrim.str();
 
   default_node = -1;
@@ -5843,12 +6618,181 @@ bool RenderSceneConverter::BuildNodeHierarchy(
   return true;
 }
 
+namespace {
+
+struct TextureAssetCollectorEnv {
+  const RenderSceneConverterEnv *env{nullptr};
+
+  // Unique texture assets in traversal order.
+  std::vector<std::string> resolved_paths;
+  std::vector<value::AssetPath> asset_paths;
+  std::vector<AssetInfo> asset_infos;
+  std::vector<const UsdUVTexture *> textures;  // First user of the asset.
+  std::set<std::string> visited;
+};
+
+bool TextureAssetCollector(const tinyusdz::Path &abs_path,
+                           const tinyusdz::Prim &prim, const int32_t level,
+                           void *userdata, std::string *err) {
+  (void)abs_path;
+  (void)level;
+  (void)err;
+
+  TextureAssetCollectorEnv *cenv =
+      reinterpret_cast<TextureAssetCollectorEnv *>(userdata);
+
+  const Shader *pshader = prim.as<Shader>();
+  if (!pshader) {
+    return true;
+  }
+
+  const UsdUVTexture *ptex = pshader->value.as<UsdUVTexture>();
+  if (!ptex || !ptex->file.authored()) {
+    return true;
+  }
+
+  // Invalid `asset:file` is reported in ConvertUVTexture.
+  value::AssetPath assetPath;
+  auto apath = ptex->file.get_value();
+  if (!apath || !apath.value().get(cenv->env->timecode, &assetPath)) {
+    return true;
+  }
+
+  std::string resolved_path =
+      cenv->env->asset_resolver.resolve(assetPath.GetAssetPath());
+  if (resolved_path.empty() || cenv->visited.count(resolved_path)) {
+    return true;
+  }
+
+  cenv->visited.insert(resolved_path);
+  cenv->resolved_paths.push_back(resolved_path);
+  cenv->asset_paths.push_back(assetPath);
+  cenv->asset_infos.push_back(pshader->metas().get_assetInfo());
+  cenv->textures.push_back(ptex);
+
+  return true;
+}
+
+}  // namespace
+
+bool RenderSceneConverter::PrefetchTextureImages(
+    const RenderSceneConverterEnv &env) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::PrefetchTextureImages");
+
+  ClearPrefetchedTextureImages();
+
+  TextureAssetCollectorEnv cenv;
+  cenv.env = &env;
+
+  std::string err;
+  if (!tydra::VisitPrims(env.stage, TextureAssetCollector, &cenv, &err)) {
+    PUSH_ERROR_AND_RETURN(err);
+  }
+
+  TextureImageLoaderFunction tex_loader_fun =
+      env.material_config.texture_image_loader_function;
+
+  if (!tex_loader_fun) {
+    tex_loader_fun = DefaultTextureImageLoaderFunction;
+  }
+
+  MemoryBudget *budget = env.scene_config.memory_budget.get();
+
+  const size_t n = cenv.resolved_paths.size();
+  std::vector<PrefetchedTextureImage> results(n);
+  std::vector<uint8_t> budget_exceeded(n, 0);
+
+  parallel::ParallelFor(
+      n,
+      [&](size_t i, int thread_id) {
+        (void)thread_id;
+        PrefetchedTextureImage &result = results[i];
+
+        result.loaded = tex_loader_fun(
+            cenv.asset_paths[i], cenv.asset_infos[i], env.asset_resolver,
+            &result.image, &result.data,
+            env.material_config.texture_image_loader_function_userdata,
+            &result.warn, &result.err);
+
+        if (result.loaded) {
+          result.srgb =
+              IsSRGBTexels(*cenv.textures[i], env.timecode, result.image);
+          if (!ProcessDecodedTexels(env.material_config, result.srgb,
+                                    &result.image, &result.data, &result.warn,
+                                    &result.err)) {
+            // Reported as texture load failure in ConvertUVTexture.
+            result.loaded = false;
+            result.data.clear();
+            result.data.shrink_to_fit();
+          }
+        }
+
+        if (result.loaded && budget) {
+          if (!budget->reserve(MemoryCategory::Assets, result.data.size(),
+                               &result.err)) {
+            budget_exceeded[i] = 1;
+            result.data.clear();
+            result.data.shrink_to_fit();
+          }
+        }
+      },
+      env.scene_config.texture_loading_num_threads);
+
+  // Stitch results in traversal order.
+  _prefetch_memory_budget = env.scene_config.memory_budget;
+  for (size_t i = 0; i < n; i++) {
+    if (!budget_exceeded[i]) {
+      if (results[i].loaded) {
+        _prefetch_memory_bytes += results[i].data.size();
+      }
+      _prefetched_texture_images.emplace(cenv.resolved_paths[i],
+                                         std::move(results[i]));
+    }
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (budget_exceeded[i]) {
+      ClearPrefetchedTextureImages();
+      PUSH_ERROR_AND_RETURN(fmt::format("Failed to load texture image: `{}` err = {}", cenv.asset_paths[i].GetAssetPath(), results[i].err));
+    }
+  }
+
+  return true;
+}
+
+void RenderSceneConverter::ClearPrefetchedTextureImages() {
+  if (_prefetch_memory_budget) {
+    _prefetch_memory_budget->release(MemoryCategory::Assets,
+                                     _prefetch_memory_bytes);
+  }
+
+  _prefetched_texture_images.clear();
+  _shared_texture_image_ids.clear();
+  _prefetch_memory_budget = nullptr;
+  _prefetch_memory_bytes = 0;
+}
+
 bool RenderSceneConverter::ConvertToRenderScene(
     const RenderSceneConverterEnv &env, RenderScene *scene) {
+  TINYUSDZ_TRACE_ZONE("RenderSceneConverter::ConvertToRenderScene");
   if (!scene) {
     PUSH_ERROR_AND_RETURN("nullptr for RenderScene argument.");
   }
 
+  // Bound Materials, the connection graph and decoded texture images refer
+  // the Stage or are transient. Do not keep them after the conversion(also
+  // when the conversion fails in the middle).
+  ScopeExit cleanup([this]() {
+    _material_binding_cache.clear();
+    _connection_graph.clear();
+    ClearPrefetchedTextureImages();
+    _buffer_reservation = MemoryReservation();
+  });
+
+  // Texture buffers are accounted to the budget until the RenderScene is
+  // destroyed.
+  _buffer_reservation = MemoryReservation(env.scene_config.memory_budget);
+
   // 1. Convert Xform
   // 2. Convert Material/Texture
   // 3. Convert Mesh/SkinWeights/BlendShapes
@@ -5874,12 +6818,48 @@ bool RenderSceneConverter::ConvertToRenderScene(
   //
   // Material conversion will be done in MeshVisitor.
   //
+  if (env.scene_config.load_texture_assets &&
+      env.scene_config.parallel_texture_loading) {
+    if (!PrefetchTextureImages(env)) {
+      return false;
+    }
+  }
+
+  // Attribute connections of shader networks are followed many times while
+  // converting Materials, so build the connection graph once.
+  if (!_connection_graph.Build(env.stage, &err)) {
+    PUSH_ERROR_AND_RETURN(err);
+  }
+
+  // Resolve bound Materials of all Prims at once, instead of walking up the
+  // Prim tree for each GeomMesh and GeomSubset.
+  {
+    std::vector<std::string> purposes;
+    if (!env.material_config.default_backface_material_purpose_name.empty()) {
+      purposes.push_back(
+          env.material_config.default_backface_material_purpose_name);
+    }
+    std::string binding_warn;
+    if (!_material_binding_cache.Build(env.stage, purposes, &binding_warn,
+                                       &err)) {
+      PUSH_ERROR_AND_RETURN(err);
+    }
+    if (binding_warn.size()) {
+      PUSH_WARN(binding_warn);
+    }
+  }
+
   MeshVisitorEnv menv;
   menv.env = &env;
   menv.converter = this;
+  menv.material_bindings = &_material_binding_cache;
 
   bool ret = tydra::VisitPrims(env.stage, MeshVisitor, &menv, &err);
 
+  // Decoded texture images are no longer required. Release them before
+  // building the node hierarchy.
+  ClearPrefetchedTextureImages();
+
   if (!ret) {
     PUSH_ERROR_AND_RETURN(err);
   }
@@ -5913,6 +6893,8 @@ bool RenderSceneConverter::ConvertToRenderScene(
   render_scene.textures = std::move(textures);
   render_scene.images = std::move(images);
   render_scene.buffers = std::move(buffers);
+  render_scene.memory_reservation =
+      std::make_shared<MemoryReservation>(std::move(_buffer_reservation));
   render_scene.materials = std::move(materials);
   render_scene.skeletons = std::move(skeletons);
   render_scene.animations = std::move(animations);
@@ -6062,8 +7044,12 @@ bool DefaultTextureImageLoaderFunction(
 
   DCOUT("Resolved asset path = " << resolvedPath);
 
+  // Read through const accessor so that a view Asset(e.g. image in USDZ) is
+  // decoded without copying.
+  const Asset &casset = asset;
+
   // TODO: user-defined image loader handler.
-  auto result = tinyusdz::image::LoadImageFromMemory(asset.data(), asset.size(),
+  auto result = tinyusdz::image::LoadImageFromMemory(casset.data(), casset.size(),
                                                      resolvedPath);
   if (!result) {
     if (err) {
@@ -6125,11 +7111,43 @@ bool DefaultTextureImageLoaderFunction(
   (*texImageOut) = texImage;
 
   // raw image data
-  (*imageData) = result.value().image.data;
+  (*imageData) = std::move(result.value().image.data);
 
   return true;
 }
 
+std::string to_string(TextureCompressionFormat cfmt) {
+  std::string s;
+  switch (cfmt) {
+    case TextureCompressionFormat::None: {
+      s = "none";
+      break;
+    }
+    case TextureCompressionFormat::BC1: {
+      s = "bc1";
+      break;
+    }
+    case TextureCompressionFormat::BC3: {
+      s = "bc3";
+      break;
+    }
+    case TextureCompressionFormat::BC4: {
+      s = "bc4";
+      break;
+    }
+    case TextureCompressionFormat::BC5: {
+      s = "bc5";
+      break;
+    }
+    case TextureCompressionFormat::BC7: {
+      s = "bc7";
+      break;
+    }
+  }
+
+  return s;
+}
+
 std::string to_string(ColorSpace cty) {
   std::string s;
   switch (cty) {
@@ -7093,6 +8111,14 @@ std::string DumpImage(const TextureImage &image, uint32_t indent) {
      << to_string(image.colorSpace) << "\n";
   ss << pprint::Indent(indent + 1) << "bufferID "
      << std::to_string(image.buffer_id) << "\n";
+  if (image.compressionFormat != TextureCompressionFormat::None) {
+    ss << pprint::Indent(indent + 1) << "compressionFormat "
+       << to_string(image.compressionFormat) << "\n";
+  }
+  if (image.mipLevels.size()) {
+    ss << pprint::Indent(indent + 1) << "mipLevels " << image.mipLevels.size()
+       << "\n";
+  }
 
   ss << "\n";
 
@@ -8,9 +8,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <unordered_map>
 
 #include "asset-resolution.hh"
+#include "memory-budget.hh"
 #include "nonstd/expected.hpp"
 #include "usdGeom.hh"
 #include "usdShade.hh"
@@ -18,7 +20,9 @@
 #include "value-types.hh"
 
 // tydra
+#include "connection-graph.hh"
 #include "scene-access.hh"
+#include "shader-network.hh"
 
 namespace tinyusdz {
 
@@ -32,6 +36,7 @@ struct AssetInfo;
 class Path;
 struct UsdPreviewSurface;
 struct UsdUVTexture;
+class Subdivider;
 
 template <typename T>
 struct UsdPrimvarReader;
@@ -580,6 +585,26 @@ std::string to_string(ColorSpace cs);
 // Infer colorspace from token value.
 bool InferColorSpace(const value::token &tok, ColorSpace *result);
 
+// GPU block compression format of texel data(4x4 texels per block).
+enum class TextureCompressionFormat {
+  None,  // Uncompressed
+  BC1,   // RGB(alpha is ignored). 8 bytes/block
+  BC3,   // RGBA. 16 bytes/block
+  BC4,   // R. 8 bytes/block
+  BC5,   // RG. 16 bytes/block
+  BC7,   // RGBA. 16 bytes/block
+};
+
+std::string to_string(TextureCompressionFormat fmt);
+
+// Mip level of texel data stored in BufferData.
+struct TextureMipLevel {
+  int32_t width{-1};
+  int32_t height{-1};
+  uint64_t byte_offset{0};  // byte offset in BufferData
+  uint64_t byte_length{0};
+};
+
 struct TextureImage {
   std::string asset_identifier;  // (resolved) filename or asset identifier.
 
@@ -597,6 +622,15 @@ struct TextureImage {
   int32_t channels{-1};  // e.g. 3 for RGB.
   int32_t miplevel{0};
 
+  // Block compression format of texel data in `buffer_id`.
+  // Texel data is 8bit and `colorSpace` is kept as-is(i.e. BC1 + sRGB
+  // colorSpace corresponds to BC1_RGBA_UNORM_SRGB in GPU API).
+  TextureCompressionFormat compressionFormat{TextureCompressionFormat::None};
+
+  // Mip chain stored in `buffer_id`(level 0 first).
+  // Empty = single level which spans the whole BufferData.
+  std::vector<TextureMipLevel> mipLevels;
+
   int64_t buffer_id{-1};  // index to buffer_id(texel data)
 
   uint64_t handle{0};  // Handle ID for Graphics API. 0 = invalid
@@ -1224,6 +1258,10 @@ class RenderScene {
   std::vector<BufferData>
       buffers;  // Various data storage(e.g. texel/image data).
 
+  // Memory reserved in `RenderSceneConverterConfig::memory_budget` for
+  // `buffers`. Copies of the RenderScene share the reservation, and it is
+  // released when the last RenderScene sharing it is destroyed.
+  std::shared_ptr<MemoryReservation> memory_reservation;
 };
 
 ///
@@ -1330,6 +1368,18 @@ struct MeshConverterConfig {
   // ConvertMesh. Only effective to floating-point vertex data.
   //
   float facevarying_to_vertex_eps = std::numeric_limits<float>::epsilon();
+
+  //
+  // Uniform subdivision level for Mesh whose `subdivisionScheme` is not
+  // `none`. 0 = no subdivision(use the control mesh as a polygon mesh).
+  // Requires TinyUSDZ built with TINYUSDZ_WITH_OPENSUBDIV.
+  //
+  // The refiner and stencil tables are cached per Mesh Prim path in
+  // RenderSceneConverter, so converting the same Mesh at other time codes only
+  // applies stencils to new points. Skinned Mesh and Mesh with BlendShapes are
+  // not subdivided(deform the control mesh and use `Subdivider` instead).
+  //
+  int subdivision_level{0};
 };
 
 struct MaterialConverterConfig {
@@ -1388,13 +1438,84 @@ struct MaterialConverterConfig {
   // Allow asset(e.g. texture file/shader file) which does not exit?
   bool allow_missing_asset{true};
 
+  // Downscale texture image on load so that both width and height are equal or
+  // less than this value(aspect ratio is kept). 0 = no limit.
+  // 8bit sRGB texture is filtered in linear space. 16bit and half texture is
+  // not downscaled.
+  uint32_t max_texture_size{0};
+
+  // Generate full mip chain(down to 1x1) for each texture image.
+  // Mip levels are stored in the texture's BufferData and described by
+  // `TextureImage::mipLevels`.
+  bool generate_texture_mipmaps{false};
+
+  // Compress texture images with the built-in CPU block compressor so that
+  // the app can upload texel data to GPU as-is.
+  // Texel data is quantized to 8bit before the compression. Texture whose
+  // asset is 16bit or floating point(e.g. HDR image) is not compressed.
+  TextureCompressionFormat texture_compression_format{
+      TextureCompressionFormat::None};
+
+  // Generate and compress mip chain(down to 1x1) when
+  // `texture_compression_format` is set.
+  bool texture_compression_mipmaps{true};
+
+  // # of threads for block compression. -1 = use all hardware threads.
+  int texture_compression_num_threads{-1};
+
 };
 
+///
+/// Callbacks to receive converted data progressively(e.g. upload meshes to
+/// GPU before the whole Stage has been converted).
+///
+/// Invoked from the thread calling `RenderSceneConverter::ConvertToRenderScene`.
+/// Arguments are valid only during the call(the data is moved to RenderScene
+/// at the end of the conversion), so copy them when required.
+/// Return false to cancel the conversion.
+///
+typedef bool (*RenderMeshConvertedCallback)(uint64_t mesh_id,
+                                            const RenderMesh &mesh,
+                                            void *userdata);
+
+typedef bool (*TextureImageLoadedCallback)(uint64_t image_id,
+                                           const TextureImage &image,
+                                           const BufferData &buffer,
+                                           void *userdata);
+
 struct RenderSceneConverterConfig {
   // Load texture image data on convert.
   // false: no actual texture file/asset access.
   // App/User must setup TextureImage manually after the conversion.
   bool load_texture_assets{true};
+
+  // Optional. Account loaded texture assets(`MemoryCategory::Assets`) and
+  // RenderScene `BufferData`(`MemoryCategory::TydraBuffers`) to this budget.
+  // The conversion fails when the budget is exceeded.
+  std::shared_ptr<MemoryBudget> memory_budget;
+
+  // Decode texture images in parallel before converting Materials.
+  // Texture assets referenced by UsdUVTexture Shaders in the Stage are
+  // deduplicated by resolved asset path and decoded concurrently.
+  // UVTextures which use the same asset and colorSpace share the same
+  // TextureImage/BufferData. The order of `images` and `buffers` in the
+  // RenderScene does not depend on the number of threads.
+  //
+  // NOTE: `MaterialConverterConfig::texture_image_loader_function` must be
+  // thread-safe when this flag is set to true.
+  bool parallel_texture_loading{false};
+
+  // # of threads for parallel texture loading. -1 = use all hardware threads.
+  int texture_loading_num_threads{-1};
+
+  // Optional. Called when each RenderMesh has been converted.
+  RenderMeshConvertedCallback mesh_converted_callback{nullptr};
+
+  // Optional. Called when each TextureImage has been loaded.
+  TextureImageLoadedCallback texture_image_loaded_callback{nullptr};
+
+  // Userdata passed to the callbacks above.
+  void *progress_callback_userdata{nullptr};
 };
 
 //
@@ -1762,6 +1883,27 @@ class RenderSceneConverter {
                         const Path &tex_abs_path, const AssetInfo &assetInfo,
                         const UsdUVTexture &texture, UVTexture *tex_out);
 
+  ///
+  /// Decode texture images of all UsdUVTexture Shaders in the Stage in
+  /// parallel. Decoded images are kept in the converter and used by
+  /// subsequent ConvertUVTexture calls until ClearPrefetchedTextureImages is
+  /// called.
+  ///
+  /// ConvertToRenderScene calls this function when
+  /// `RenderSceneConverterConfig::parallel_texture_loading` is true.
+  ///
+  /// Texture load failure is not an error here(it is reported in
+  /// ConvertUVTexture).
+  ///
+  /// @return false when the memory budget is exceeded.
+  ///
+  bool PrefetchTextureImages(const RenderSceneConverterEnv &env);
+
+  ///
+  /// Free texture images decoded by PrefetchTextureImages(or ConvertUVTexture).
+  ///
+  void ClearPrefetchedTextureImages();
+
   ///
   /// Convert SkelAnimation to Tydra Animation.
   ///
@@ -1833,6 +1975,48 @@ class RenderSceneConverter {
   std::string _info;
   std::string _err;
   std::string _warn;
+
+  struct PrefetchedTextureImage {
+    bool loaded{false};
+    TextureImage image;
+    std::vector<uint8_t> data;
+    bool data_consumed{false};  // `data` was moved to a RenderScene buffer.
+    bool srgb{false};  // `data` was resized/mipmapped as sRGB texels.
+    std::string warn;
+    std::string err;
+  };
+
+  // Decoded texture images. Filled by PrefetchTextureImages, or on demand by
+  // ConvertUVTexture so that an asset is decoded once per conversion.
+  // key = resolved asset path
+  std::map<std::string, PrefetchedTextureImage> _prefetched_texture_images;
+
+  // key = resolved asset path + colorSpace, value = index to `images`.
+  std::map<std::string, int64_t> _shared_texture_image_ids;
+
+  std::shared_ptr<MemoryBudget> _prefetch_memory_budget;
+  uint64_t _prefetch_memory_bytes{0};  // Assets reserved for not-yet-consumed `data`.
+
+  // TydraBuffers reserved for `buffers`. Handed over to the RenderScene.
+  MemoryReservation _buffer_reservation;
+
+  // key = Mesh Prim path
+  std::map<std::string, std::shared_ptr<tinyusdz::Subdivider>>
+      _subdivider_cache;
+
+  // Bound Materials of Prims. Valid while ConvertToRenderScene converts
+  // Prims(refers Material Prims in the Stage).
+  MaterialBindingCache _material_binding_cache;
+
+  // Attribute connections of the Stage. Valid while ConvertToRenderScene
+  // converts Prims.
+  ConnectionGraph _connection_graph;
+
+  // Returns nullptr when `_connection_graph` is not built for `env.stage`.
+  ConnectionGraph *GetConnectionGraph(const RenderSceneConverterEnv &env) {
+    return (_connection_graph.stage() == &env.stage) ? &_connection_graph
+                                                     : nullptr;
+  }
 };
 
 // For debug
@@ -2,12 +2,15 @@
 // Copyright 2022-Present Light Transport Entertainment, Inc.
 //
 
+#include <algorithm>
+
 // src
 #include "common-macros.inc"
 #include "pprinter.hh"
 #include "prim-pprint.hh"
 #include "prim-types.hh"
 #include "primvar.hh"
+#include "str-util.hh"
 #include "tiny-format.hh"
 #include "tydra/prim-apply.hh"
 #include "usdGeom.hh"
@@ -1207,6 +1210,7 @@ nonstd::expected<bool, std::string> GetPrimProperty(
   std::string err;
 
   TO_PROPERTY("inputs:file", tex.file)
+  TO_PROPERTY("inputs:st", tex.st)
 
   {
     const auto it = tex.props.find(prop_name);
@@ -1341,9 +1345,10 @@ nonstd::expected<bool, std::string> GetPrimProperty(
   DCOUT("prop_name = " << prop_name);
   std::string err;
 
-  TO_PROPERTY("rotation", tx.rotation)
-  TO_PROPERTY("scale", tx.scale)
-  TO_PROPERTY("translation", tx.translation)
+  TO_PROPERTY("inputs:in", tx.in)
+  TO_PROPERTY("inputs:rotation", tx.rotation)
+  TO_PROPERTY("inputs:scale", tx.scale)
+  TO_PROPERTY("inputs:translation", tx.translation)
 
   if (prop_name == "outputs:result") {
     // Terminal attribute
@@ -1382,20 +1387,20 @@ nonstd::expected<bool, std::string> GetPrimProperty(
   DCOUT("prop_name = " << prop_name);
   std::string err;
 
-  TO_PROPERTY("diffuseColor", surface.diffuseColor)
-  TO_PROPERTY("emissiveColor", surface.emissiveColor)
-  TO_PROPERTY("specularColor", surface.specularColor)
-  TO_PROPERTY("useSpecularWorkflow", surface.useSpecularWorkflow)
-  TO_PROPERTY("metallic", surface.metallic)
-  TO_PROPERTY("clearcoat", surface.clearcoat)
-  TO_PROPERTY("clearcoatRoughness", surface.clearcoatRoughness)
-  TO_PROPERTY("roughness", surface.roughness)
-  TO_PROPERTY("opacity", surface.opacity)
-  TO_PROPERTY("opacityThreshold", surface.opacityThreshold)
-  TO_PROPERTY("ior", surface.ior)
-  TO_PROPERTY("normal", surface.normal)
-  TO_PROPERTY("displacement", surface.displacement)
-  TO_PROPERTY("occlusion", surface.occlusion)
+  TO_PROPERTY("inputs:diffuseColor", surface.diffuseColor)
+  TO_PROPERTY("inputs:emissiveColor", surface.emissiveColor)
+  TO_PROPERTY("inputs:specularColor", surface.specularColor)
+  TO_PROPERTY("inputs:useSpecularWorkflow", surface.useSpecularWorkflow)
+  TO_PROPERTY("inputs:metallic", surface.metallic)
+  TO_PROPERTY("inputs:clearcoat", surface.clearcoat)
+  TO_PROPERTY("inputs:clearcoatRoughness", surface.clearcoatRoughness)
+  TO_PROPERTY("inputs:roughness", surface.roughness)
+  TO_PROPERTY("inputs:opacity", surface.opacity)
+  TO_PROPERTY("inputs:opacityThreshold", surface.opacityThreshold)
+  TO_PROPERTY("inputs:ior", surface.ior)
+  TO_PROPERTY("inputs:normal", surface.normal)
+  TO_PROPERTY("inputs:displacement", surface.displacement)
+  TO_PROPERTY("inputs:occlusion", surface.occlusion)
 
   if (prop_name == "outputs:surface") {
     if (surface.outputsSurface.authored()) {
@@ -2459,24 +2464,338 @@ bool GetCollection(const Prim &prim, const Collection **dst) {
   return ret;
 }
 
+namespace {
+
+// Split Prim part of the path into elements. `/` = empty.
+std::vector<std::string> SplitPrimPath(const std::string &prim_part) {
+  std::vector<std::string> elements;
+  size_t s = 0;
+  while (s < prim_part.size()) {
+    size_t e = prim_part.find('/', s);
+    if (e == std::string::npos) {
+      e = prim_part.size();
+    }
+    if (e > s) {
+      elements.push_back(prim_part.substr(s, e - s));
+    }
+    s = e + 1;
+  }
+  return elements;
+}
+
+constexpr auto kCollectionPropPrefix = "collection:";
+
+}  // namespace
+
+uint32_t CollectionMembershipQuery::get_or_add_node(const Path &path) {
+  if (_nodes.empty()) {
+    _nodes.emplace_back();  // root
+  }
+
+  std::vector<std::string> elements = SplitPrimPath(path.prim_part());
+  if (!path.prop_part().empty()) {
+    elements.push_back("." + path.prop_part());
+  }
+
+  uint32_t node = 0;
+  for (const auto &element : elements) {
+    uint32_t element_id;
+    auto eit = _elements.find(element);
+    if (eit == _elements.end()) {
+      element_id = uint32_t(_elements.size());
+      _elements.emplace(element, element_id);
+    } else {
+      element_id = eit->second;
+    }
+
+    const uint64_t key = (uint64_t(node) << 32) | uint64_t(element_id);
+    auto cit = _children.find(key);
+    if (cit == _children.end()) {
+      uint32_t child_node = uint32_t(_nodes.size());
+      _nodes.emplace_back();
+      _children.emplace(key, child_node);
+      node = child_node;
+    } else {
+      node = cit->second;
+    }
+  }
+
+  return node;
+}
+
+void CollectionMembershipQuery::set_rule(const Path &path, const Rule rule,
+                                         const bool exclude) {
+  if (!path.is_valid()) {
+    return;
+  }
+
+  uint32_t node = get_or_add_node(path);
+  Node &dst = _nodes[node];
+  if ((dst.rule == Rule::None) && !dst.excluded) {
+    _num_rules++;
+  }
+
+  // Rules are combined regardless of the order they are added: keep the
+  // strongest expansion. Exclusion is evaluated before the include rule.
+  dst.rule = (std::max)(dst.rule, rule);
+  dst.excluded |= exclude;
+}
+
+void CollectionMembershipQuery::add_include(const Path &path,
+                                            const ExpansionRule rule) {
+  if (rule == ExpansionRule::ExplicitOnly) {
+    set_rule(path, Rule::ExplicitOnly, /* exclude */ false);
+  } else if (rule == ExpansionRule::ExpandPrimsAndProperties) {
+    set_rule(path, Rule::ExpandPrimsAndProperties, /* exclude */ false);
+  } else {
+    set_rule(path, Rule::ExpandPrims, /* exclude */ false);
+  }
+}
+
+void CollectionMembershipQuery::add_exclude(const Path &path) {
+  set_rule(path, Rule::None, /* exclude */ true);
+}
+
+CollectionMembershipQuery::Cursor CollectionMembershipQuery::step(
+    const Cursor &parent, int64_t node) const {
+  Cursor c;
+  c.node = node;
+  c.included_by = parent.inherited_by;
+  c.inherited_by = parent.inherited_by;
+
+  if ((node >= 0) && _nodes[size_t(node)].excluded) {
+    // excludes wins.
+    c.included_by = -1;
+    c.inherited_by = -1;
+  } else if (node >= 0) {
+    switch (_nodes[size_t(node)].rule) {
+      case Rule::None:
+        break;
+      case Rule::ExplicitOnly:
+        c.included_by = node;
+        break;
+      case Rule::ExpandPrims:
+      case Rule::ExpandPrimsAndProperties:
+        c.included_by = node;
+        c.inherited_by = node;
+        break;
+    }
+  }
+
+  return c;
+}
+
+CollectionMembershipQuery::Cursor CollectionMembershipQuery::root() const {
+  return step(Cursor(), _nodes.empty() ? -1 : 0);
+}
+
+CollectionMembershipQuery::Cursor CollectionMembershipQuery::child(
+    const Cursor &parent, const std::string &element_name) const {
+  int64_t node = -1;
+  if (parent.node >= 0) {
+    auto eit = _elements.find(element_name);
+    if (eit != _elements.end()) {
+      const uint64_t key = (uint64_t(parent.node) << 32) | uint64_t(eit->second);
+      auto cit = _children.find(key);
+      if (cit != _children.end()) {
+        node = int64_t(cit->second);
+      }
+    }
+  }
+
+  return step(parent, node);
+}
+
+bool CollectionMembershipQuery::is_path_included(const Path &abs_path,
+                                                 ExpansionRule *rule) const {
+  if (!abs_path.is_valid() || !abs_path.is_absolute_path()) {
+    return false;
+  }
+
+  Cursor c = root();
+  for (const auto &element : SplitPrimPath(abs_path.prim_part())) {
+    if ((c.node < 0) && (c.inherited_by < 0)) {
+      // No rules under this path.
+      return false;
+    }
+    c = child(c, element);
+  }
+
+  if (!abs_path.prop_part().empty()) {
+    const int64_t prim_inherited_by = c.inherited_by;
+    c = child(c, "." + abs_path.prop_part());
+    if ((c.included_by >= 0) && (c.included_by == prim_inherited_by)) {
+      // Properties of descendant Prims are included by
+      // `expandPrimsAndProperties` only.
+      if (_nodes[size_t(c.included_by)].rule !=
+          Rule::ExpandPrimsAndProperties) {
+        return false;
+      }
+    }
+  }
+
+  if (c.included_by < 0) {
+    return false;
+  }
+
+  if (rule) {
+    switch (_nodes[size_t(c.included_by)].rule) {
+      case Rule::ExplicitOnly:
+        (*rule) = ExpansionRule::ExplicitOnly;
+        break;
+      case Rule::ExpandPrimsAndProperties:
+        (*rule) = ExpansionRule::ExpandPrimsAndProperties;
+        break;
+      default:
+        (*rule) = ExpansionRule::ExpandPrims;
+        break;
+    }
+  }
+
+  return true;
+}
+
+namespace {
+
+bool BuildCollectionMembershipQueryRec(const Stage &stage,
+                                       const CollectionInstance &coll,
+                                       std::set<std::string> &visited,
+                                       CollectionMembershipQuery &query) {
+  const CollectionInstance::ExpansionRule rule = coll.expansionRule.get_value();
+
+  bool includeRoot{false};
+  coll.includeRoot.get_value().get_scalar(&includeRoot);
+  if (includeRoot) {
+    query.add_include(Path("/", ""), rule);
+  }
+
+  if (coll.excludes) {
+    for (const auto &target : coll.excludes.value().targetPathVector) {
+      query.add_exclude(target);
+    }
+    if (coll.excludes.value().is_path()) {
+      query.add_exclude(coll.excludes.value().targetPath);
+    }
+  }
+
+  if (coll.includes) {
+    std::vector<Path> targets = coll.includes.value().targetPathVector;
+    if (coll.includes.value().is_path()) {
+      targets.push_back(coll.includes.value().targetPath);
+    }
+
+    for (const auto &target : targets) {
+      if (!startsWith(target.prop_part(), kCollectionPropPrefix)) {
+        query.add_include(target, rule);
+        continue;
+      }
+
+      // Include other collection.
+      const std::string coll_path = target.full_path_name();
+      if (visited.count(coll_path)) {
+        DCOUT("Circular referencing of collection: " << coll_path);
+        return false;
+      }
+      visited.insert(coll_path);
+
+      const Prim *prim{nullptr};
+      const Collection *collection{nullptr};
+      const CollectionInstance *instance{nullptr};
+      if (!stage.find_prim_at_path(Path(target.prim_part(), ""), prim) ||
+          !GetCollection(*prim, &collection) ||
+          !collection->get_instance(
+              removePrefix(target.prop_part(), kCollectionPropPrefix),
+              &instance)) {
+        DCOUT("Collection not found: " << coll_path);
+        return false;
+      }
+
+      if (!BuildCollectionMembershipQueryRec(stage, *instance, visited,
+                                             query)) {
+        return false;
+      }
+
+      visited.erase(coll_path);
+    }
+  }
+
+  return true;
+}
+
+struct IncludedPrimPathsTraversal {
+  const CollectionMembershipQuery *query{nullptr};
+  std::vector<CollectionMembershipQuery::Cursor> cursors;  // index = depth
+  std::vector<Path> *included_paths{nullptr};
+};
+
+bool IncludedPrimPathsVisitor(const Path &abs_path, const Prim &prim,
+                              const int32_t level, void *userdata,
+                              std::string *err) {
+  (void)err;
+
+  IncludedPrimPathsTraversal *traversal =
+      reinterpret_cast<IncludedPrimPathsTraversal *>(userdata);
+
+  if (level < 0) {
+    return true;
+  }
+
+  // [0] = root(`/`)
+  traversal->cursors.resize(size_t(level) + 2);
+  const CollectionMembershipQuery::Cursor &parent =
+      traversal->cursors[size_t(level)];
+  CollectionMembershipQuery::Cursor &c = traversal->cursors[size_t(level) + 1];
+  c = traversal->query->child(parent, prim.element_name());
+
+  if (c.included()) {
+    traversal->included_paths->push_back(abs_path);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+CollectionMembershipQuery BuildCollectionMembershipQuery(
+    const Stage &stage, const CollectionInstance &seedCollectionInstance) {
+  CollectionMembershipQuery query;
+  std::set<std::string> visited;
+  if (!BuildCollectionMembershipQueryRec(stage, seedCollectionInstance,
+                                         visited, query)) {
+    return CollectionMembershipQuery();
+  }
+
+  return query;
+}
+
 bool IsPathIncluded(const CollectionMembershipQuery &query, const Stage &stage,
                     const Path &abs_path,
-                    const CollectionInstance::ExpansionRule expansionRule) {
-  (void)query;
+                    CollectionInstance::ExpansionRule *expansionRule) {
   (void)stage;
-  (void)expansionRule;
 
-  DCOUT("TODO");
+  return query.is_path_included(abs_path, expansionRule);
+}
 
-  if (!abs_path.is_valid()) {
-    return false;
+bool ComputeIncludedPrimPaths(const CollectionMembershipQuery &query,
+                              const Stage &stage,
+                              std::vector<Path> *included_paths,
+                              std::string *err) {
+  if (!included_paths) {
+    PUSH_ERROR_AND_RETURN("`included_paths` is nullptr.");
   }
 
-  if (abs_path.is_root_path()) {
+  included_paths->clear();
+
+  if (query.empty()) {
     return true;
   }
 
-  return false;
+  IncludedPrimPathsTraversal traversal;
+  traversal.query = &query;
+  traversal.cursors.push_back(query.root());
+  traversal.included_paths = included_paths;
+
+  return VisitPrims(stage, IncludedPrimPathsVisitor, &traversal, err);
 }
 
 std::vector<std::pair<std::string, const tinyusdz::BlendShape *>>
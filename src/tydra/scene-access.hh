@@ -9,6 +9,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 
 #include "prim-type-macros.inc"
 #include "prim-types.hh"
@@ -402,10 +403,94 @@ bool ShaderToPrimSpec(const UsdPrimvarReader<T> &node, PrimSpec &ps,
 ///
 bool GetCollection(const Prim &prim, const Collection **collection);
 
+///
+/// Compiled membership of Collection(includes/excludes and expansionRule).
+///
+/// Paths are stored in a path-prefix trie over interned path elements, so a
+/// membership test is O(depth of the path).
+///
+/// Same rule as UsdCollectionMembershipQuery: the nearest included/excluded
+/// path(the path itself or its ancestor) decides the membership. `excludes`
+/// wins over `includes` for the same path. `explicitOnly` includes apply to
+/// the exact path only. `expandPrims` does not include properties of
+/// descendant Prims. When a path is included multiple times(e.g. by nested
+/// collections), the strongest expansion rule is used.
+///
 class CollectionMembershipQuery {
  public:
+  using ExpansionRule = CollectionInstance::ExpansionRule;
+
+  ///
+  /// Include `path`(and its descendants depending on `rule`).
+  /// `/` includes all Prims(`includeRoot`).
+  ///
+  void add_include(const Path &path, const ExpansionRule rule);
+
+  ///
+  /// Exclude `path` and its descendants.
+  ///
+  void add_exclude(const Path &path);
+
+  ///
+  /// @param[in] abs_path Absolute Prim or Property path.
+  /// @param[out] rule (Optional) ExpansionRule which includes `abs_path`.
+  /// @return true when `abs_path` is a member of the collection.
+  ///
+  bool is_path_included(const Path &abs_path,
+                        ExpansionRule *rule = nullptr) const;
+
+  bool empty() const { return _num_rules == 0; }
+
+  void clear() {
+    _nodes.clear();
+    _children.clear();
+    _elements.clear();
+    _num_rules = 0;
+  }
+
+  ///
+  /// Trie traversal. Used to evaluate the membership of Prims in top-down
+  /// order without looking up the whole path for each Prim.
+  ///
+  struct Cursor {
+    int64_t node{-1};          // Trie node. -1 = no rules under this path.
+    int64_t included_by{-1};   // Trie node whose rule includes this path.
+    int64_t inherited_by{-1};  // Trie node whose rule includes descendant
+                               // Prims.
+
+    bool included() const { return included_by >= 0; }
+  };
+
+  Cursor root() const;
+  Cursor child(const Cursor &parent, const std::string &element_name) const;
+
  private:
-  std::map<Path, CollectionInstance::ExpansionRule> _expansionRuleMap;
+  // Ordered from weakest to strongest expansion.
+  enum class Rule : uint8_t {
+    None,
+    ExplicitOnly,
+    ExpandPrims,
+    ExpandPrimsAndProperties,
+  };
+
+  struct Node {
+    Rule rule{Rule::None};  // include rule
+    bool excluded{false};
+  };
+
+  uint32_t get_or_add_node(const Path &path);
+  void set_rule(const Path &path, const Rule rule, const bool exclude);
+  Cursor step(const Cursor &parent, int64_t node) const;
+
+  std::vector<Node> _nodes;  // [0] = root(`/`)
+
+  // key = (parent node id << 32) | element id, value = child node id
+  std::unordered_map<uint64_t, uint32_t> _children;
+
+  // Interned path elements(Prim name, or `.` + Property name)
+  std::unordered_map<std::string, uint32_t> _elements;
+
+  size_t _num_rules{0};
 };
 
 ///
@@ -494,7 +579,8 @@ std::vector<GeomPrimvar> GetGeomPrimvars(const Stage &stage, const GPrim &prim);
 /// Build Collection Membership
 ///
 /// It traverse collection paths starting from `seedCollectionInstance` in the
-/// Stage. Note: No circular referencing path allowed.
+/// Stage. Collections in `includes` are merged into the query.
+/// Note: No circular referencing path allowed.
 ///
 /// @returns CollectionMembershipQuery object. When encountered an error,
 /// CollectionMembershipQuery contains empty info(i.e, all query will fail)
@@ -502,10 +588,34 @@ std::vector<GeomPrimvar> GetGeomPrimvars(const Stage &stage, const GPrim &prim);
 CollectionMembershipQuery BuildCollectionMembershipQuery(
     const Stage &stage, const CollectionInstance &seedCollectionInstance);
 
+///
+/// Test if `abs_path` is a member of the collection.
+///
+/// @param[in] query Compiled collection membership.
+/// @param[in] stage Stage(unused for now. for API compatibility)
+/// @param[in] abs_path Absolute Prim or Property path
+/// @param[out] expansionRule (Optional) ExpansionRule which includes
+/// `abs_path`.
+///
 bool IsPathIncluded(const CollectionMembershipQuery &query, const Stage &stage,
                     const Path &abs_path,
-                    const CollectionInstance::ExpansionRule expansionRule =
-                        CollectionInstance::ExpansionRule::ExpandPrims);
+                    CollectionInstance::ExpansionRule *expansionRule = nullptr);
+
+///
+/// Bulk version of `IsPathIncluded`. Evaluate membership of all Prims in the
+/// Stage in a single traversal.
+///
+/// @param[in] query Compiled collection membership.
+/// @param[in] stage Stage
+/// @param[out] included_paths Absolute paths of member Prims(in traversal
+/// order).
+/// @param[out] err Error message
+/// @return true upon success.
+///
+bool ComputeIncludedPrimPaths(const CollectionMembershipQuery &query,
+                              const Stage &stage,
+                              std::vector<Path> *included_paths,
+                              std::string *err = nullptr);
 
 // TODO: Layer version
 // bool IsPathIncluded(const Layer &layer, const Path &abs_path, const
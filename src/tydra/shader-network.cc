@@ -1,4 +1,7 @@
 #include "shader-network.hh"
+
+#include <algorithm>
+
 #include "prim-apply.hh"
 
 #include "common-macros.inc"
@@ -9,6 +12,7 @@
 #include "prim-pprint.hh"
 #include "value-pprint.hh"
 #include "stage.hh"
+#include "str-util.hh"
 #include "common-macros.inc"
 #include "tydra/scene-access.hh"
 
@@ -452,5 +456,320 @@ bool GetBoundMaterial(
   return false;
 }
 
+namespace {
+
+std::vector<Path> GetTargetPaths(const Relationship &rel) {
+  if (rel.is_path()) {
+    return {rel.targetPath};
+  } else if (rel.is_pathvector()) {
+    return rel.targetPathVector;
+  }
+  return {};
+}
+
+//
+// Prims included in the collection of `material:binding:collection`.
+//
+struct BindingCollection {
+  bool valid{false};
+  CollectionMembershipQuery query;
+
+  bool contains(const Path &abs_path) const {
+    return valid && query.is_path_included(abs_path);
+  }
+};
+
+struct CollectionMaterialBinding {
+  const BindingCollection *collection{nullptr};
+  int32_t material_id{-1};
+  bool stronger{false};
+};
+
+struct PurposeMaterialBinding {
+  int32_t direct_material_id{-1};
+  bool direct_stronger{false};
+  std::vector<CollectionMaterialBinding> collections;
+
+  bool empty() const {
+    return (direct_material_id < 0) && collections.empty();
+  }
+};
+
+// Material bindings authored in a Prim.
+struct MaterialBindingLevel {
+  int32_t depth{0};
+  std::vector<PurposeMaterialBinding> purposes;  // same order with
+                                                 // `MaterialBindingTraversal::purposes`
+};
+
+struct MaterialBindingTraversal {
+  const Stage *stage{nullptr};
+  std::vector<std::string> purposes;  // [0] = all-purpose
+
+  // Ancestors(and the current Prim) which have material bindings. Ordered from
+  // the root to the current Prim.
+  std::vector<MaterialBindingLevel> levels;
+
+  // key = collection path(e.g. `/root.collection:metal`)
+  std::map<std::string, BindingCollection> collections;
+
+  std::vector<std::pair<std::string, const Material *>> materials;
+  std::map<std::string, int32_t> material_ids;  // key = Material Prim path
+
+  // Resolved bindings for each purpose. key = Prim path
+  std::vector<std::unordered_map<std::string, uint32_t>> bindings;
+
+  std::string warn;
+
+  int32_t GetMaterialId(const Path &path) {
+    const std::string path_str = path.full_path_name();
+    auto it = material_ids.find(path_str);
+    if (it != material_ids.end()) {
+      return it->second;
+    }
+
+    int32_t id = -1;
+    const Prim *p{nullptr};
+    if (stage->find_prim_at_path(path, p) && p->is<Material>()) {
+      id = int32_t(materials.size());
+      materials.push_back(std::make_pair(path_str, p->as<Material>()));
+    }
+    material_ids[path_str] = id;
+    return id;
+  }
+
+  const BindingCollection *GetCollection(const Path &path) {
+    const std::string path_str = path.full_path_name();
+    auto it = collections.find(path_str);
+    if (it != collections.end()) {
+      return &it->second;
+    }
+
+    BindingCollection &dst = collections[path_str];
+
+    const std::string kCollectionPrefix = "collection:";
+    const Prim *p{nullptr};
+    const Collection *coll{nullptr};
+    const CollectionInstance *instance{nullptr};
+    if (!startsWith(path.prop_part(), kCollectionPrefix) ||
+        !stage->find_prim_at_path(Path(path.prim_part(), ""), p) ||
+        !tydra::GetCollection(*p, &coll) ||
+        !coll->get_instance(removePrefix(path.prop_part(), kCollectionPrefix),
+                            &instance)) {
+      warn += fmt::format("Collection `{}` not found.\n", path_str);
+      return &dst;
+    }
+
+    dst.query = BuildCollectionMembershipQuery(*stage, *instance);
+    dst.valid = !dst.query.empty();
+    if (!dst.valid) {
+      warn += fmt::format("Collection `{}` is empty or invalid.\n", path_str);
+    }
+
+    return &dst;
+  }
+
+  bool IsStronger(const Relationship &rel) const {
+    const value::token strength =
+        rel.metas().bindMaterialAs.value_or(kWeaderThanDescendants);
+    return strength.str() == kStrongerThanDescendants;
+  }
+
+  PurposeMaterialBinding GetBindings(const Path &abs_path,
+                                     const MaterialBinding &mb,
+                                     const std::string &purpose) {
+    PurposeMaterialBinding dst;
+
+    Relationship rel;
+    if (mb.get_materialBinding(value::token(purpose), &rel)) {
+      Path target;
+      if (GetSinglePath(rel, &target)) {
+        dst.direct_material_id = GetMaterialId(target);
+        dst.direct_stronger = IsStronger(rel);
+      } else {
+        warn += fmt::format("material:binding of `{}` has no target path.\n",
+                            abs_path.full_path_name());
+      }
+    }
+
+    // NOTE: Collection bindings are evaluated in the order of collection
+    // name(not the authored order).
+    for (const auto &item : mb.materialBindingCollectionMap()) {
+      const Relationship *coll_rel{nullptr};
+      if (!item.second.at(purpose, &coll_rel)) {
+        continue;
+      }
+
+      // targets = [collection path, material path]
+      std::vector<Path> targets = GetTargetPaths(*coll_rel);
+      if (targets.size() != 2) {
+        warn += fmt::format(
+            "material:binding:collection `{}` of `{}` must have 2 targets"
+            "(collection and material).\n",
+            item.first, abs_path.full_path_name());
+        continue;
+      }
+
+      CollectionMaterialBinding binding;
+      binding.collection = GetCollection(targets[0]);
+      binding.material_id = GetMaterialId(targets[1]);
+      binding.stronger = IsStronger(*coll_rel);
+      if (binding.collection->valid && (binding.material_id >= 0)) {
+        dst.collections.push_back(binding);
+      }
+    }
+
+    return dst;
+  }
+
+  // Same rule with `GetBoundMaterial`: walk up from the current Prim to the
+  // root. As in UsdShade, collection bindings of a Prim are evaluated before
+  // its direct binding.
+  int32_t Resolve(size_t purpose_id, const Path &abs_path) const {
+    int32_t bound = -1;
+    for (auto it = levels.rbegin(); it != levels.rend(); it++) {
+      const PurposeMaterialBinding &b = it->purposes[purpose_id];
+
+      for (const auto &coll : b.collections) {
+        if (coll.collection->contains(abs_path)) {
+          if ((bound < 0) || coll.stronger) {
+            bound = coll.material_id;
+          }
+          break;
+        }
+      }
+
+      if ((b.direct_material_id >= 0) && ((bound < 0) || b.direct_stronger)) {
+        bound = b.direct_material_id;
+      }
+    }
+    return bound;
+  }
+};
+
+bool MaterialBindingVisitor(const Path &abs_path, const Prim &prim,
+                            const int32_t level, void *userdata,
+                            std::string *err) {
+  (void)err;
+
+  MaterialBindingTraversal *traversal =
+      reinterpret_cast<MaterialBindingTraversal *>(userdata);
+
+  // Leave the subtree of Prims in the stack.
+  while (!traversal->levels.empty() &&
+         (traversal->levels.back().depth >= level)) {
+    traversal->levels.pop_back();
+  }
+
+  auto apply_fun = [&](const Stage &stage, const MaterialBinding *mb) -> bool {
+    (void)stage;
+
+    MaterialBindingLevel binding_level;
+    binding_level.depth = level;
+
+    bool has_binding{false};
+    for (const auto &purpose : traversal->purposes) {
+      binding_level.purposes.emplace_back(
+          traversal->GetBindings(abs_path, *mb, purpose));
+      has_binding |= !binding_level.purposes.back().empty();
+    }
+
+    if (has_binding) {
+      traversal->levels.emplace_back(std::move(binding_level));
+    }
+    return true;
+  };
+
+  ApplyToMaterialBinding(*traversal->stage, prim, apply_fun);
+
+  if (traversal->levels.empty()) {
+    return true;
+  }
+
+  const std::string prim_path = abs_path.full_path_name();
+
+  int32_t all_purpose_id = -1;
+  for (size_t i = 0; i < traversal->purposes.size(); i++) {
+    int32_t id = traversal->Resolve(i, abs_path);
+    if (i == 0) {
+      all_purpose_id = id;
+    } else if (id < 0) {
+      id = all_purpose_id;
+    }
+
+    if (id >= 0) {
+      traversal->bindings[i][prim_path] = uint32_t(id);
+    }
+  }
+
+  return true;
+}
+
+} // namespace
+
+bool MaterialBindingCache::Build(const Stage &stage,
+                                 const std::vector<std::string> &purposes,
+                                 std::string *warn, std::string *err) {
+  clear();
+
+  MaterialBindingTraversal traversal;
+  traversal.stage = &stage;
+  traversal.purposes.push_back("");  // all-purpose
+  for (const auto &purpose : purposes) {
+    if (std::find(traversal.purposes.begin(), traversal.purposes.end(),
+                  purpose) == traversal.purposes.end()) {
+      traversal.purposes.push_back(purpose);
+    }
+  }
+  traversal.bindings.resize(traversal.purposes.size());
+
+  std::string visit_err;
+  if (!VisitPrims(stage, MaterialBindingVisitor, &traversal, &visit_err)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Failed to resolve material bindings: {}", visit_err));
+  }
+
+  if (warn && traversal.warn.size()) {
+    (*warn) += traversal.warn;
+  }
+
+  _materials.resize(traversal.materials.size());
+  for (size_t i = 0; i < traversal.materials.size(); i++) {
+    _materials[i].path = std::move(traversal.materials[i].first);
+    _materials[i].material = traversal.materials[i].second;
+  }
+
+  for (size_t i = 0; i < traversal.purposes.size(); i++) {
+    _bindings[traversal.purposes[i]] = std::move(traversal.bindings[i]);
+  }
+
+  return true;
+}
+
+bool MaterialBindingCache::GetBoundMaterial(const Path &abs_path,
+                                            const std::string &purpose,
+                                            Path *materialPath,
+                                            const Material **material) const {
+  if (!materialPath || !material) {
+    return false;
+  }
+
+  auto pit = _bindings.find(purpose);
+  if (pit == _bindings.end()) {
+    return false;
+  }
+
+  auto it = pit->second.find(abs_path.full_path_name());
+  if (it == pit->second.end()) {
+    return false;
+  }
+
+  const BoundMaterial &bound = _materials[it->second];
+  (*materialPath) = Path(bound.path, "");
+  (*material) = bound.material;
+
+  return true;
+}
+
 } // namespace tydra
 } // namespace tinyusdz
@@ -5,7 +5,10 @@
 
 #pragma once
 
+#include <map>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "nonstd/expected.hpp"
 #include "value-types.hh"
@@ -215,5 +218,92 @@ bool GetDirectCollectionMaterialBinding(
   const Material **material,
   std::string *err);
 
+///
+/// Resolved material bindings of all Prims in the Stage.
+///
+/// `Build` resolves the bound Material of every Prim in a single top-down
+/// traversal of the Stage, so looking up the bound Material of a Prim does
+/// not need to walk up the Prim tree(as `GetBoundMaterial` does) for each
+/// query.
+///
+/// The resolve rule is same as `GetBoundMaterial`, plus
+/// `material:binding:collection` bindings:
+///
+/// - Binding of the nearest Prim(including the Prim itself) is used, unless
+///   the binding of an ancestor Prim is `strongerThanDescendants`
+///   (`bindMaterialAs` metadata). The outermost `strongerThanDescendants`
+///   binding wins.
+/// - For each Prim, collection bindings(`material:binding:collection[:PURPOSE]:NAME`)
+///   are evaluated first(the first one whose collection contains the Prim is
+///   used), then direct binding(`material:binding[:PURPOSE]`). So a collection
+///   binding wins over the direct binding of the same Prim, unless the direct
+///   binding is `strongerThanDescendants`.
+/// - If no binding found for the purpose, all-purpose binding is used.
+///
+/// GeomSubset bindings are resolved as well since GeomSubset is a child Prim
+/// of GeomMesh.
+///
+/// Cached `Material` pointers point to Material Prims in the Stage, so the
+/// cache is valid while the Stage is alive and not modified.
+///
+class MaterialBindingCache {
+ public:
+  ///
+  /// Resolve material bindings of all Prims in `stage`.
+  ///
+  /// @param[in] stage Stage
+  /// @param[in] purposes Material purposes to resolve. All-purpose("") is
+  /// always resolved.
+  /// @param[out] warn Warning message(e.g. invalid binding relationship which
+  /// is ignored)
+  /// @param[out] err Error message
+  /// @return true upon success.
+  ///
+  bool Build(const Stage &stage, const std::vector<std::string> &purposes,
+             std::string *warn, std::string *err);
+
+  ///
+  /// Get the bound Material of the Prim.
+  ///
+  /// @param[in] abs_path Absolute Prim path.
+  /// @param[in] purpose Material purpose(Empty string is treated as
+  /// "all-purpose"). Must be one of purposes given to `Build`.
+  /// @param[out] materialPath Bound Material Path.
+  /// @param[out] material Bound Material.
+  /// @return true when bound Material is found.
+  ///
+  bool GetBoundMaterial(const Path &abs_path, const std::string &purpose,
+                        Path *materialPath, const Material **material) const;
+
+  bool has_purpose(const std::string &purpose) const {
+    return _bindings.count(purpose);
+  }
+
+  // # of Prims which have bound Material for the purpose.
+  size_t size(const std::string &purpose = std::string()) const {
+    auto it = _bindings.find(purpose);
+    if (it == _bindings.end()) {
+      return 0;
+    }
+    return it->second.size();
+  }
+
+  void clear() {
+    _materials.clear();
+    _bindings.clear();
+  }
+
+ private:
+  struct BoundMaterial {
+    std::string path;  // Material Prim path
+    const Material *material{nullptr};
+  };
+
+  std::vector<BoundMaterial> _materials;
+
+  // key = purpose, value = (Prim path, index to `_materials`)
+  std::map<std::string, std::unordered_map<std::string, uint32_t>> _bindings;
+};
+
 }  // namespace tydra
 }  // namespace tinyusdz
@@ -0,0 +1,791 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// CPU skinning of RenderMesh
+//
+#include "skinning.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TINYUSDZ_SKINNING_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "animation-clip.hh"
+#include "blendshape.hh"
+#include "common-macros.inc"
+#include "parallel-for.hh"
+#include "tiny-format.hh"
+#include "xform.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+#define PushError(msg) \
+  {                    \
+    if (err) {         \
+      (*err) += msg;   \
+    }                  \
+  }
+
+#define PushWarn(msg) \
+  {                   \
+    if (warn) {       \
+      (*warn) += msg; \
+    }                 \
+  }
+
+// Decompose the upper-left 3x3 of `m`(= S * R, no shear) into scale and
+// rotation rows. A negative determinant is assigned to the x scale.
+void DecomposeScaleRotation(const value::matrix4d &m, double rotation[3][3],
+                            double scale[3]) {
+  for (size_t i = 0; i < 3; i++) {
+    double len = std::sqrt(m.m[i][0] * m.m[i][0] + m.m[i][1] * m.m[i][1] +
+                           m.m[i][2] * m.m[i][2]);
+    scale[i] = len;
+    for (size_t j = 0; j < 3; j++) {
+      if (len > std::numeric_limits<double>::epsilon()) {
+        rotation[i][j] = m.m[i][j] / len;
+      } else {
+        // Degenerated axis.
+        rotation[i][j] = (i == j) ? 1.0 : 0.0;
+      }
+    }
+  }
+
+  double det =
+      rotation[0][0] * (rotation[1][1] * rotation[2][2] -
+                        rotation[1][2] * rotation[2][1]) -
+      rotation[0][1] * (rotation[1][0] * rotation[2][2] -
+                        rotation[1][2] * rotation[2][0]) +
+      rotation[0][2] * (rotation[1][0] * rotation[2][1] -
+                        rotation[1][1] * rotation[2][0]);
+  if (det < 0.0) {
+    scale[0] = -scale[0];
+    for (size_t j = 0; j < 3; j++) {
+      rotation[0][j] = -rotation[0][j];
+    }
+  }
+}
+
+// Compute joint local matrix(S * R * T in USD's row-vector convention) from
+// AnimationChannels of the joint. Components not animated are taken from
+// the decomposed `rest` transform.
+value::matrix4d ComputeAnimatedLocalTransform(
+    const std::map<AnimationChannel::ChannelType, AnimationChannel> &channels,
+    const value::matrix4d &rest, double t) {
+  double rotation[3][3];
+  double scale[3];
+  DecomposeScaleRotation(rest, rotation, scale);
+
+  double translation[3] = {rest.m[3][0], rest.m[3][1], rest.m[3][2]};
+
+  for (const auto &it : channels) {
+    const AnimationChannel &ch = it.second;
+    switch (it.first) {
+      case AnimationChannel::ChannelType::Translation: {
+        vec3 v;
+        if (EvaluateAnimationSampler(ch.translations, t, &v)) {
+          for (size_t i = 0; i < 3; i++) {
+            translation[i] = double(v[i]);
+          }
+        }
+        break;
+      }
+      case AnimationChannel::ChannelType::Rotation: {
+        quat r;
+        if (EvaluateAnimationSampler(ch.rotations, t, &r)) {
+          value::quatf q;
+          q.imag = {r[0], r[1], r[2]};
+          q.real = r[3];
+          value::matrix4d rm = to_matrix(q);
+          for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 3; j++) {
+              rotation[i][j] = rm.m[i][j];
+            }
+          }
+        }
+        break;
+      }
+      case AnimationChannel::ChannelType::Scale: {
+        vec3 v;
+        if (EvaluateAnimationSampler(ch.scales, t, &v)) {
+          for (size_t i = 0; i < 3; i++) {
+            scale[i] = double(v[i]);
+          }
+        }
+        break;
+      }
+      case AnimationChannel::ChannelType::Transform:
+      case AnimationChannel::ChannelType::Weight:
+        break;
+    }
+  }
+
+  value::matrix4d m = value::matrix4d::identity();
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      m.m[i][j] = scale[i] * rotation[i][j];
+    }
+    m.m[3][i] = translation[i];
+  }
+
+  return m;
+}
+
+void ComputeJointTransformsRec(
+    const SkelNode &node, const value::matrix4d &parent_transform,
+    const Animation *anim, double t,
+    std::vector<value::matrix4d> &joint_transforms, bool *ok) {
+  value::matrix4d local = node.rest_transform;
+  if (anim) {
+    auto it = anim->channels_map.find(node.joint_path);
+    if (it != anim->channels_map.end()) {
+      local = ComputeAnimatedLocalTransform(it->second, node.rest_transform, t);
+    }
+  }
+
+  // row-vector: child local first.
+  value::matrix4d m = local * parent_transform;
+
+  if ((node.joint_id < 0) ||
+      (size_t(node.joint_id) >= joint_transforms.size())) {
+    (*ok) = false;
+    return;
+  }
+  joint_transforms[size_t(node.joint_id)] = m;
+
+  for (const auto &child : node.children) {
+    ComputeJointTransformsRec(child, m, anim, t, joint_transforms, ok);
+  }
+}
+
+size_t CountJoints(const SkelNode &node) {
+  size_t n = 1;
+  for (const auto &child : node.children) {
+    n += CountJoints(child);
+  }
+  return n;
+}
+
+//
+// Kernels
+//
+
+// Joint matrix in 4x4 floats(rows padded to 4 floats for SIMD).
+// Row 3 is translation. v' = v[0] * row0 + v[1] * row1 + v[2] * row2 (+ row3)
+constexpr size_t kMatrixStride = 16;
+
+// Dual quaternion in 8 floats(real xyzw, dual xyzw)
+constexpr size_t kDualQuatStride = 8;
+
+void ToPaletteMatrix(const value::matrix4d &m, float *dst) {
+  for (size_t i = 0; i < 4; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      dst[i * 4 + j] = float(m.m[i][j]);
+    }
+    dst[i * 4 + 3] = 0.0f;
+  }
+}
+
+// Inverse transpose of upper-left 3x3(for normals).
+value::matrix4d NormalMatrix(const value::matrix4d &m) {
+  value::matrix3d m3;
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      m3.m[i][j] = m.m[i][j];
+    }
+  }
+
+  value::matrix3d inv_m3;
+  if (!inverse(m3, inv_m3)) {
+    inv_m3 = m3;  // singular. fallback
+  } else {
+    inv_m3 = transpose(inv_m3);
+  }
+
+  value::matrix4d n = value::matrix4d::identity();
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      n.m[i][j] = inv_m3.m[i][j];
+    }
+  }
+  return n;
+}
+
+// Rigid part of `m` as a dual quaternion.
+void ToDualQuat(const value::matrix4d &m, float *dst) {
+  // Remove scale from the rotation part.
+  value::matrix4d r = value::matrix4d::identity();
+  for (size_t i = 0; i < 3; i++) {
+    double len = std::sqrt(m.m[i][0] * m.m[i][0] + m.m[i][1] * m.m[i][1] +
+                           m.m[i][2] * m.m[i][2]);
+    for (size_t j = 0; j < 3; j++) {
+      r.m[i][j] = (len > 0.0) ? (m.m[i][j] / len) : ((i == j) ? 1.0 : 0.0);
+    }
+  }
+
+  // Quaternion of row-vector rotation matrix `r`(= transpose of column-vector
+  // rotation matrix)
+  double x, y, z, w;
+  double trace = r.m[0][0] + r.m[1][1] + r.m[2][2];
+  if (trace > 0.0) {
+    double k = std::sqrt(trace + 1.0) * 2.0;
+    w = 0.25 * k;
+    x = (r.m[1][2] - r.m[2][1]) / k;
+    y = (r.m[2][0] - r.m[0][2]) / k;
+    z = (r.m[0][1] - r.m[1][0]) / k;
+  } else if ((r.m[0][0] > r.m[1][1]) && (r.m[0][0] > r.m[2][2])) {
+    double k = std::sqrt(1.0 + r.m[0][0] - r.m[1][1] - r.m[2][2]) * 2.0;
+    w = (r.m[1][2] - r.m[2][1]) / k;
+    x = 0.25 * k;
+    y = (r.m[1][0] + r.m[0][1]) / k;
+    z = (r.m[2][0] + r.m[0][2]) / k;
+  } else if (r.m[1][1] > r.m[2][2]) {
+    double k = std::sqrt(1.0 + r.m[1][1] - r.m[0][0] - r.m[2][2]) * 2.0;
+    w = (r.m[2][0] - r.m[0][2]) / k;
+    x = (r.m[1][0] + r.m[0][1]) / k;
+    y = 0.25 * k;
+    z = (r.m[2][1] + r.m[1][2]) / k;
+  } else {
+    double k = std::sqrt(1.0 + r.m[2][2] - r.m[0][0] - r.m[1][1]) * 2.0;
+    w = (r.m[0][1] - r.m[1][0]) / k;
+    x = (r.m[2][0] + r.m[0][2]) / k;
+    y = (r.m[2][1] + r.m[1][2]) / k;
+    z = 0.25 * k;
+  }
+
+  double len = std::sqrt(x * x + y * y + z * z + w * w);
+  x /= len;
+  y /= len;
+  z /= len;
+  w /= len;
+
+  double tx = m.m[3][0];
+  double ty = m.m[3][1];
+  double tz = m.m[3][2];
+
+  // dual = 0.5 * (t, 0) * real
+  dst[0] = float(x);
+  dst[1] = float(y);
+  dst[2] = float(z);
+  dst[3] = float(w);
+  dst[4] = float(0.5 * (tx * w + ty * z - tz * y));
+  dst[5] = float(0.5 * (-tx * z + ty * w + tz * x));
+  dst[6] = float(0.5 * (tx * y - ty * x + tz * w));
+  dst[7] = float(-0.5 * (tx * x + ty * y + tz * z));
+}
+
+// Per-vertex influences(sanitized joint indices and weights).
+struct Influences {
+  size_t element_size{0};
+  std::vector<uint32_t> joints;
+  std::vector<float> weights;
+};
+
+// Item(point, normal, etc) to skin.
+struct SkinTarget {
+  const vec3 *src{nullptr};
+  vec3 *dst{nullptr};
+  size_t count{0};
+  const uint32_t *point_indices{nullptr};  // nullptr = item i is point i.
+  bool is_point{false};                    // apply translation
+  bool normalize{false};                   // normalize the result
+  const float *palette{nullptr};           // kMatrixStride x num_joints(LBS)
+  const float *pre_matrix{nullptr};        // 4x4(DQS only). nullptr = identity
+};
+
+inline void Normalize3(float *v) {
+  float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  if (len > 0.0f) {
+    v[0] /= len;
+    v[1] /= len;
+    v[2] /= len;
+  }
+}
+
+void SkinLBSRange(const SkinTarget &target, const Influences &inf,
+                  size_t begin, size_t end) {
+  const size_t es = inf.element_size;
+
+  for (size_t i = begin; i < end; i++) {
+    const size_t p = target.point_indices ? target.point_indices[i] : i;
+    const uint32_t *joints = inf.joints.data() + p * es;
+    const float *weights = inf.weights.data() + p * es;
+    const vec3 &v = target.src[i];
+    float out[4];
+
+#if defined(TINYUSDZ_SKINNING_USE_SSE2)
+    __m128 r0 = _mm_setzero_ps();
+    __m128 r1 = _mm_setzero_ps();
+    __m128 r2 = _mm_setzero_ps();
+    __m128 r3 = _mm_setzero_ps();
+    for (size_t k = 0; k < es; k++) {
+      const float *m = target.palette + joints[k] * kMatrixStride;
+      __m128 w = _mm_set1_ps(weights[k]);
+      r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_loadu_ps(m)));
+      r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_loadu_ps(m + 4)));
+      r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_loadu_ps(m + 8)));
+      r3 = _mm_add_ps(r3, _mm_mul_ps(w, _mm_loadu_ps(m + 12)));
+    }
+
+    __m128 o = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), r0),
+                   _mm_mul_ps(_mm_set1_ps(v[1]), r1)),
+        _mm_mul_ps(_mm_set1_ps(v[2]), r2));
+    if (target.is_point) {
+      o = _mm_add_ps(o, r3);
+    }
+    _mm_storeu_ps(out, o);
+#else
+    float r[16] = {};
+    for (size_t k = 0; k < es; k++) {
+      const float *m = target.palette + joints[k] * kMatrixStride;
+      const float w = weights[k];
+      for (size_t e = 0; e < 16; e++) {
+        r[e] += w * m[e];
+      }
+    }
+
+    for (size_t c = 0; c < 3; c++) {
+      out[c] = (v[0] * r[c] + v[1] * r[4 + c]) + v[2] * r[8 + c];
+      if (target.is_point) {
+        out[c] += r[12 + c];
+      }
+    }
+#endif
+
+    if (target.normalize) {
+      Normalize3(out);
+    }
+
+    target.dst[i] = {out[0], out[1], out[2]};
+  }
+}
+
+void SkinDQSRange(const SkinTarget &target, const float *dual_quats,
+                  const Influences &inf, size_t begin, size_t end) {
+  const size_t es = inf.element_size;
+
+  for (size_t i = begin; i < end; i++) {
+    const size_t p = target.point_indices ? target.point_indices[i] : i;
+    const uint32_t *joints = inf.joints.data() + p * es;
+    const float *weights = inf.weights.data() + p * es;
+
+    float v[3] = {target.src[i][0], target.src[i][1], target.src[i][2]};
+    if (target.pre_matrix) {
+      const float *m = target.pre_matrix;
+      float pv[3];
+      for (size_t c = 0; c < 3; c++) {
+        pv[c] = (v[0] * m[c] + v[1] * m[4 + c]) + v[2] * m[8 + c];
+        if (target.is_point) {
+          pv[c] += m[12 + c];
+        }
+      }
+      v[0] = pv[0];
+      v[1] = pv[1];
+      v[2] = pv[2];
+    }
+
+    // Blend dual quaternions. Flip the sign of quaternions in the opposite
+    // hemisphere of the first influence(shortest path).
+    const float *q0 = dual_quats + joints[0] * kDualQuatStride;
+    float b[8];
+#if defined(TINYUSDZ_SKINNING_USE_SSE2)
+    __m128 br = _mm_setzero_ps();
+    __m128 bd = _mm_setzero_ps();
+    for (size_t k = 0; k < es; k++) {
+      const float *q = dual_quats + joints[k] * kDualQuatStride;
+      float d = q0[0] * q[0] + q0[1] * q[1] + q0[2] * q[2] + q0[3] * q[3];
+      __m128 w = _mm_set1_ps((d < 0.0f) ? -weights[k] : weights[k]);
+      br = _mm_add_ps(br, _mm_mul_ps(w, _mm_loadu_ps(q)));
+      bd = _mm_add_ps(bd, _mm_mul_ps(w, _mm_loadu_ps(q + 4)));
+    }
+    _mm_storeu_ps(b, br);
+    _mm_storeu_ps(b + 4, bd);
+#else
+    for (size_t e = 0; e < 8; e++) {
+      b[e] = 0.0f;
+    }
+    for (size_t k = 0; k < es; k++) {
+      const float *q = dual_quats + joints[k] * kDualQuatStride;
+      float d = q0[0] * q[0] + q0[1] * q[1] + q0[2] * q[2] + q0[3] * q[3];
+      float w = (d < 0.0f) ? -weights[k] : weights[k];
+      for (size_t e = 0; e < 8; e++) {
+        b[e] += w * q[e];
+      }
+    }
+#endif
+
+    float len = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+    if (len > 0.0f) {
+      for (size_t e = 0; e < 8; e++) {
+        b[e] /= len;
+      }
+    } else {
+      b[0] = b[1] = b[2] = 0.0f;
+      b[3] = 1.0f;
+      b[4] = b[5] = b[6] = b[7] = 0.0f;
+    }
+
+    const float rx = b[0], ry = b[1], rz = b[2], rw = b[3];
+    const float dx = b[4], dy = b[5], dz = b[6], dw = b[7];
+
+    // v' = v + 2 * cross(r.xyz, cross(r.xyz, v) + rw * v)
+    float cx = ry * v[2] - rz * v[1] + rw * v[0];
+    float cy = rz * v[0] - rx * v[2] + rw * v[1];
+    float cz = rx * v[1] - ry * v[0] + rw * v[2];
+    float out[3] = {v[0] + 2.0f * (ry * cz - rz * cy),
+                    v[1] + 2.0f * (rz * cx - rx * cz),
+                    v[2] + 2.0f * (rx * cy - ry * cx)};
+
+    if (target.is_point) {
+      // t = 2 * (rw * d.xyz - dw * r.xyz + cross(r.xyz, d.xyz))
+      out[0] += 2.0f * (rw * dx - dw * rx + (ry * dz - rz * dy));
+      out[1] += 2.0f * (rw * dy - dw * ry + (rz * dx - rx * dz));
+      out[2] += 2.0f * (rw * dz - dw * rz + (rx * dy - ry * dx));
+    }
+
+    if (target.normalize) {
+      Normalize3(out);
+    }
+
+    target.dst[i] = {out[0], out[1], out[2]};
+  }
+}
+
+}  // namespace
+
+std::string to_string(SkinningMethod method) {
+  switch (method) {
+    case SkinningMethod::LinearBlend:
+      return "classicLinear";
+    case SkinningMethod::DualQuaternion:
+      return "dualQuaternion";
+  }
+  return "[[InvalidSkinningMethod]]";
+}
+
+bool ComputeSkinningPalette(const SkelHierarchy &skel, const Animation *anim,
+                            double t, SkinningPalette *palette,
+                            std::string *err) {
+  if (!palette) {
+    PUSH_ERROR_AND_RETURN("`palette` is nullptr.");
+  }
+
+  size_t num_joints = CountJoints(skel.root_node);
+
+  palette->time = t;
+  palette->joint_transforms.assign(num_joints, value::matrix4d::identity());
+
+  bool ok = true;
+  ComputeJointTransformsRec(skel.root_node, value::matrix4d::identity(), anim,
+                            t, palette->joint_transforms, &ok);
+  if (!ok) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Invalid joint id in Skeleton: {}", skel.abs_path));
+  }
+
+  palette->skinning_transforms.resize(num_joints);
+
+  // bind transforms by joint id
+  std::vector<const SkelNode *> stack{&skel.root_node};
+  while (!stack.empty()) {
+    const SkelNode *node = stack.back();
+    stack.pop_back();
+
+    size_t j = size_t(node->joint_id);
+    palette->skinning_transforms[j] =
+        inverse(node->bind_transform) * palette->joint_transforms[j];
+
+    for (const auto &child : node->children) {
+      stack.push_back(&child);
+    }
+  }
+
+  return true;
+}
+
+const SkinningPalette *SkinningEngine::GetPalette(const RenderScene &scene,
+                                                  int skel_id, double t) {
+  std::string *err = &_err;
+
+  if ((skel_id < 0) || (size_t(skel_id) >= scene.skeletons.size())) {
+    PUSH_ERROR(fmt::format("Invalid skel_id {}", skel_id));
+    return nullptr;
+  }
+
+  const bool is_default = value::TimeCode(t).is_default();
+  PaletteKey key(skel_id, is_default, is_default ? 0.0 : t);
+
+  auto it = _palette_cache.find(key);
+  if (it != _palette_cache.end()) {
+    return &it->second;
+  }
+
+  const SkelHierarchy &skel = scene.skeletons[size_t(skel_id)];
+  const Animation *anim{nullptr};
+  if ((skel.anim_id >= 0) && (size_t(skel.anim_id) < scene.animations.size())) {
+    anim = &scene.animations[size_t(skel.anim_id)];
+  }
+
+  SkinningPalette palette;
+  if (!ComputeSkinningPalette(skel, anim, t, &palette, err)) {
+    return nullptr;
+  }
+
+  // Evict the oldest palette.
+  while ((_palette_cache.size() >= std::max(size_t(1), _config.max_cached_palettes)) &&
+         !_palette_cache_order.empty()) {
+    _palette_cache.erase(_palette_cache_order.front());
+    _palette_cache_order.pop_front();
+  }
+
+  _palette_cache_order.push_back(key);
+  return &(_palette_cache[key] = std::move(palette));
+}
+
+void SkinningEngine::ClearCache() {
+  _palette_cache.clear();
+  _palette_cache_order.clear();
+}
+
+bool SkinningEngine::SkinMesh(const RenderScene &scene, size_t mesh_id,
+                              double t, SkinnedMesh *out) {
+  std::string *err = &_err;
+  std::string *warn = &_warn;
+
+  if (!out) {
+    PUSH_ERROR_AND_RETURN("`out` is nullptr.");
+  }
+
+  if (mesh_id >= scene.meshes.size()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("mesh_id {} is out-of-range. meshes.size {}", mesh_id, scene.meshes.size()));
+  }
+
+  const RenderMesh &mesh = scene.meshes[mesh_id];
+  const JointAndWeight &jw = mesh.joint_and_weights;
+
+  if (mesh.skel_id < 0) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Mesh is not bound to Skeleton: {}", mesh.abs_path));
+  }
+
+  const size_t num_points = mesh.points.size();
+  const size_t es = size_t(std::max(1, jw.elementSize));
+  if ((jw.jointIndices.size() != num_points * es) ||
+      (jw.jointWeights.size() != num_points * es)) {
+    PUSH_ERROR_AND_RETURN(fmt::format("jointIndices.size {} and jointWeights.size {} must be points.size {} * elementSize {}: {}", jw.jointIndices.size(), jw.jointWeights.size(), num_points, es, mesh.abs_path));
+  }
+
+  const SkinningPalette *palette = GetPalette(scene, mesh.skel_id, t);
+  if (!palette) {
+    return false;
+  }
+
+  const size_t num_joints = palette->skinning_transforms.size();
+  if (num_joints == 0) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Skeleton has no joints: {}", mesh.abs_path));
+  }
+
+  // Sanitize influences. Invalid joint index gets zero weight.
+  Influences inf;
+  inf.element_size = es;
+  inf.joints.resize(num_points * es);
+  inf.weights.resize(num_points * es);
+  bool has_invalid_joint{false};
+  for (size_t p = 0; p < num_points; p++) {
+    float sum = 0.0f;
+    for (size_t k = 0; k < es; k++) {
+      int j = jw.jointIndices[p * es + k];
+      float w = jw.jointWeights[p * es + k];
+      if ((j < 0) || (size_t(j) >= num_joints)) {
+        has_invalid_joint = true;
+        j = 0;
+        w = 0.0f;
+      }
+      inf.joints[p * es + k] = uint32_t(j);
+      inf.weights[p * es + k] = w;
+      sum += w;
+    }
+    if (_config.normalize_weights && (sum > 0.0f)) {
+      for (size_t k = 0; k < es; k++) {
+        inf.weights[p * es + k] /= sum;
+      }
+    }
+  }
+  if (has_invalid_joint) {
+    PUSH_WARN(fmt::format("jointIndices contains invalid joint index: {}", mesh.abs_path));
+  }
+
+  // geomBindTransform is applied before skinning.
+  const value::matrix4d &geomBind = jw.geomBindTransform;
+  const bool has_geom_bind = !is_identity(geomBind);
+
+  const bool lbs = _config.method == SkinningMethod::LinearBlend;
+
+  // LBS: geomBindTransform is folded into the palette.
+  // DQS: applied to each vertex before skinning(since geomBindTransform may
+  // contain scale).
+  std::vector<float> point_palette;
+  std::vector<float> normal_palette;
+  std::vector<float> dual_quats;
+  float pre_point[16];
+  float pre_normal[16];
+  if (lbs) {
+    point_palette.resize(num_joints * kMatrixStride);
+    normal_palette.resize(num_joints * kMatrixStride);
+    for (size_t j = 0; j < num_joints; j++) {
+      value::matrix4d m = has_geom_bind
+                              ? geomBind * palette->skinning_transforms[j]
+                              : palette->skinning_transforms[j];
+      ToPaletteMatrix(m, &point_palette[j * kMatrixStride]);
+      ToPaletteMatrix(NormalMatrix(m), &normal_palette[j * kMatrixStride]);
+    }
+  } else {
+    dual_quats.resize(num_joints * kDualQuatStride);
+    for (size_t j = 0; j < num_joints; j++) {
+      ToDualQuat(palette->skinning_transforms[j], &dual_quats[j * kDualQuatStride]);
+    }
+    ToPaletteMatrix(geomBind, pre_point);
+    ToPaletteMatrix(NormalMatrix(geomBind), pre_normal);
+  }
+
+  // BlendShapes are applied before skinning.
+  std::vector<vec3> blended_points;
+  std::vector<vec3> blended_normals;
+  if (_config.apply_blendshapes && !mesh.targets.empty()) {
+    const SkelHierarchy &skel = scene.skeletons[size_t(mesh.skel_id)];
+    const Animation *anim{nullptr};
+    if ((skel.anim_id >= 0) && (size_t(skel.anim_id) < scene.animations.size())) {
+      anim = &scene.animations[size_t(skel.anim_id)];
+    }
+
+    std::vector<float> bs_weights;
+    GetBlendShapeWeights(mesh, anim, t, &bs_weights);
+
+    BlendShapeConfig bs_config;
+    bs_config.apply_normals = _config.skin_normals;
+    bs_config.num_threads = _config.num_threads;
+    if (!ApplyBlendShapes(mesh, bs_weights, &blended_points, &blended_normals, err, bs_config)) {
+      return false;
+    }
+  }
+
+  std::vector<SkinTarget> targets;
+
+  out->points.resize(num_points);
+  {
+    SkinTarget target;
+    target.src = blended_points.empty() ? mesh.points.data() : blended_points.data();
+    target.dst = out->points.data();
+    target.count = num_points;
+    target.is_point = true;
+    target.palette = point_palette.data();
+    target.pre_matrix = has_geom_bind ? pre_point : nullptr;
+    targets.push_back(target);
+  }
+
+  // Vertex attributes(vec3)
+  const std::vector<uint32_t> &fvIndices = mesh.faceVertexIndices();
+  auto add_attribute_target = [&](const VertexAttribute &attr,
+                                  const char *name, bool is_normal,
+                                  const std::vector<vec3> &override_src,
+                                  std::vector<vec3> &dst) -> bool {
+    dst.clear();
+    if (attr.empty()) {
+      return true;
+    }
+
+    if ((attr.format != VertexAttributeFormat::Vec3) ||
+        (attr.elementSize != 1) ||
+        ((attr.stride != 0) && (attr.stride != sizeof(vec3)))) {
+      PUSH_WARN(fmt::format("{} must be float3. Skip skinning it: {}", name, mesh.abs_path));
+      return true;
+    }
+
+    const size_t count = attr.vertex_count();
+
+    SkinTarget target;
+    target.count = count;
+    target.src = (override_src.size() == count)
+                     ? override_src.data()
+                     : reinterpret_cast<const vec3 *>(attr.data.data());
+    target.normalize = true;
+    target.palette = is_normal ? normal_palette.data() : point_palette.data();
+    if (has_geom_bind) {
+      target.pre_matrix = is_normal ? pre_normal : pre_point;
+    }
+
+    if ((attr.variability == VertexVariability::Vertex) ||
+        (attr.variability == VertexVariability::Varying)) {
+      if (count != num_points) {
+        PUSH_WARN(fmt::format("{} size mismatch. Skip skinning it: {}", name, mesh.abs_path));
+        return true;
+      }
+    } else if (attr.variability == VertexVariability::FaceVarying) {
+      if (count != fvIndices.size()) {
+        PUSH_WARN(fmt::format("{} size mismatch. Skip skinning it: {}", name, mesh.abs_path));
+        return true;
+      }
+      for (uint32_t idx : fvIndices) {
+        if (idx >= num_points) {
+          PUSH_ERROR_AND_RETURN(fmt::format("faceVertexIndices contains out-of-range index {}: {}", idx, mesh.abs_path));
+        }
+      }
+      target.point_indices = fvIndices.data();
+    } else {
+      PUSH_WARN(fmt::format("Skinning {} with `{}` variability is not supported: {}", name, to_string(attr.variability), mesh.abs_path));
+      return true;
+    }
+
+    dst.resize(count);
+    target.dst = dst.data();
+    targets.push_back(target);
+    return true;
+  };
+
+  if (_config.skin_normals) {
+    if (!add_attribute_target(mesh.normals, "normals", true, blended_normals, out->normals)) {
+      return false;
+    }
+  } else {
+    out->normals.clear();
+  }
+
+  if (_config.skin_tangents) {
+    if (!add_attribute_target(mesh.tangents, "tangents", false, {}, out->tangents)) {
+      return false;
+    }
+    if (!add_attribute_target(mesh.binormals, "binormals", false, {}, out->binormals)) {
+      return false;
+    }
+  } else {
+    out->tangents.clear();
+    out->binormals.clear();
+  }
+
+  for (const auto &target : targets) {
+    parallel::ParallelForChunked(
+        target.count,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          if (lbs) {
+            SkinLBSRange(target, inf, begin, end);
+          } else {
+            SkinDQSRange(target, dual_quats.data(), inf, begin, end);
+          }
+        },
+        _config.num_threads, _config.grain_size);
+  }
+
+  return true;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
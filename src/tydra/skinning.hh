@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// CPU skinning of RenderMesh(UsdSkel LBS and dual-quaternion skinning)
+//
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "render-data.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+enum class SkinningMethod {
+  LinearBlend,     // Linear blend skinning(UsdSkel's classicLinear)
+  DualQuaternion,  // Dual quaternion skinning(UsdSkel's dualQuaternion).
+                   // Scale/shear in joint transforms are ignored.
+};
+
+std::string to_string(SkinningMethod method);
+
+struct SkinningConfig {
+  SkinningMethod method{SkinningMethod::LinearBlend};
+
+  // Skin `RenderMesh::normals`, `tangents` and `binormals` as well.
+  bool skin_normals{true};
+  bool skin_tangents{true};
+
+  // Apply BlendShapes(`RenderMesh::targets`) before skinning. Weights are
+  // taken from the Animation of the Skeleton(`SkelHierarchy::anim_id`).
+  bool apply_blendshapes{true};
+
+  // Normalize joint weights per vertex(UsdSkel does not require normalized
+  // weights, but skinning assumes it).
+  bool normalize_weights{true};
+
+  // # of threads. -1 = use all hardware threads.
+  int num_threads{-1};
+
+  // Minimum # of vertices processed per thread task.
+  size_t grain_size{4096};
+
+  // Max # of joint palettes(per Skeleton and time) cached in SkinningEngine.
+  size_t max_cached_palettes{64};
+};
+
+///
+/// Joint transforms of a Skeleton at specific time.
+/// Arrays are indexed by joint id(index in UsdSkel `joints`).
+///
+struct SkinningPalette {
+  double time{0.0};
+
+  // Joint transform in skeleton space.
+  std::vector<value::matrix4d> joint_transforms;
+
+  // inverse(bindTransform) * joint_transform
+  std::vector<value::matrix4d> skinning_transforms;
+};
+
+///
+/// Compute joint palette of the Skeleton at time `t`.
+///
+/// Joint local transform is restTransform, or TRS of `anim`(SkelAnimation)
+/// when the joint is animated by `anim`. Rotation is interpolated with slerp.
+///
+/// @param[in] skel Skeleton
+/// @param[in] anim Animation bound to the Skeleton. Can be nullptr.
+/// @param[in] t Time code. `value::TimeCode::Default()` = use static value of
+/// Animation channels(the first sample when no static value is authored).
+/// @param[out] palette Joint palette.
+/// @param[out] err Error message.
+///
+bool ComputeSkinningPalette(const SkelHierarchy &skel, const Animation *anim,
+                            double t, SkinningPalette *palette,
+                            std::string *err);
+
+///
+/// Skinned(posed) vertex data in skeleton space.
+///
+/// Arrays have the same order and variability as the corresponding
+/// RenderMesh attribute(e.g. `normals` is facevarying when
+/// `RenderMesh::normals` is facevarying). Empty when not skinned.
+///
+struct SkinnedMesh {
+  std::vector<vec3> points;
+  std::vector<vec3> normals;
+  std::vector<vec3> tangents;
+  std::vector<vec3> binormals;
+};
+
+///
+/// Deform RenderMesh with `RenderMesh::joint_and_weights` on the CPU.
+///
+/// Joint palettes are cached per (skel_id, time), so skinning multiple meshes
+/// bound to the same Skeleton at the same time computes the palette only
+/// once. Vertices are processed in parallel. The inner loop blends joint
+/// matrices row-wise with SSE2 when available.
+///
+/// NOTE: SkinningEngine itself is not thread-safe.
+/// NOTE: Call `ClearCache` when the RenderScene(skeletons or animations) is
+/// modified.
+///
+class SkinningEngine {
+ public:
+  SkinningEngine() = default;
+  SkinningEngine(const SkinningConfig &config) : _config(config) {}
+
+  void SetConfig(const SkinningConfig &config) { _config = config; }
+  const SkinningConfig &GetConfig() const { return _config; }
+
+  ///
+  /// Skin `scene.meshes[mesh_id]` at time `t`.
+  ///
+  /// @param[in] scene RenderScene
+  /// @param[in] mesh_id Mesh id
+  /// @param[in] t Time code
+  /// @param[out] out Skinned vertex data
+  ///
+  /// @return false when the mesh is not skinned or skinning failed.
+  ///
+  bool SkinMesh(const RenderScene &scene, size_t mesh_id, double t,
+                SkinnedMesh *out);
+
+  ///
+  /// Get(or compute) joint palette of `scene.skeletons[skel_id]` at time `t`.
+  /// Animation of the Skeleton(`SkelHierarchy::anim_id`) is applied.
+  ///
+  /// @return nullptr when failed. The pointer is valid until the next call of
+  /// `GetPalette`, `SkinMesh` or `ClearCache`.
+  ///
+  const SkinningPalette *GetPalette(const RenderScene &scene, int skel_id,
+                                    double t);
+
+  void ClearCache();
+
+  size_t NumCachedPalettes() const { return _palette_cache.size(); }
+
+  const std::string &GetError() const { return _err; }
+  const std::string &GetWarning() const { return _warn; }
+
+ private:
+  SkinningConfig _config;
+
+  // key = (skel_id, is default time, time)
+  using PaletteKey = std::tuple<int, bool, double>;
+  std::map<PaletteKey, SkinningPalette> _palette_cache;
+  std::deque<PaletteKey> _palette_cache_order;  // insertion order(FIFO)
+
+  std::string _err;
+  std::string _warn;
+};
+
+}  // namespace tydra
+}  // namespace tinyusdz
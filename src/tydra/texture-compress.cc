@@ -0,0 +1,761 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "texture-compress.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "parallel-for.hh"
+#include "texture-util.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+namespace {
+
+// Target # of blocks processed per parallel task.
+constexpr size_t kParallelGrainBlocks = 4096;
+
+// Interpolation weights of 4bit index(BC7)
+constexpr int kBC7Weights4[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                  34, 38, 43, 47, 51, 55, 60, 64};
+
+inline int Clamp255(int v) { return (std::min)(255, (std::max)(0, v)); }
+
+inline float Clamp255f(float v) { return (std::min)(255.0f, (std::max)(0.0f, v)); }
+
+// Fetch 4x4 texels as RGBA. Texels outside of the image are clamped to edge.
+void FetchBlockRGBA(const uint8_t *src, size_t width, size_t height,
+                    size_t channels, size_t bx, size_t by, uint8_t rgba[64]) {
+  for (size_t y = 0; y < 4; y++) {
+    size_t sy = (std::min)(by * 4 + y, height - 1);
+    for (size_t x = 0; x < 4; x++) {
+      size_t sx = (std::min)(bx * 4 + x, width - 1);
+      const uint8_t *p = src + (sy * width + sx) * channels;
+      uint8_t *d = rgba + (y * 4 + x) * 4;
+      if (channels == 1) {
+        d[0] = p[0];
+        d[1] = p[0];
+        d[2] = p[0];
+        d[3] = 255;
+      } else if (channels == 2) {
+        d[0] = p[0];
+        d[1] = p[1];
+        d[2] = 0;
+        d[3] = 255;
+      } else if (channels == 3) {
+        d[0] = p[0];
+        d[1] = p[1];
+        d[2] = p[2];
+        d[3] = 255;
+      } else {
+        d[0] = p[0];
+        d[1] = p[1];
+        d[2] = p[2];
+        d[3] = p[3];
+      }
+    }
+  }
+}
+
+bool IsSolidBlock(const uint8_t rgba[64], int num_channels) {
+  for (int i = 1; i < 16; i++) {
+    for (int c = 0; c < num_channels; c++) {
+      if (rgba[i * 4 + c] != rgba[c]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//
+// Fit endpoints along the principal axis of the texels(first N channels).
+// e0 = max projection, e1 = min projection.
+//
+template <int N>
+void FitPrincipalAxisEndpoints(const uint8_t rgba[64], float e0[4],
+                               float e1[4]) {
+  float mean[N] = {};
+  float mn[N];
+  float mx[N];
+  for (int c = 0; c < N; c++) {
+    mn[c] = 255.0f;
+    mx[c] = 0.0f;
+  }
+
+  for (int i = 0; i < 16; i++) {
+    for (int c = 0; c < N; c++) {
+      float v = float(rgba[i * 4 + c]);
+      mean[c] += v;
+      mn[c] = (std::min)(mn[c], v);
+      mx[c] = (std::max)(mx[c], v);
+    }
+  }
+  for (int c = 0; c < N; c++) {
+    mean[c] /= 16.0f;
+  }
+
+  float cov[N][N] = {};
+  for (int i = 0; i < 16; i++) {
+    float d[N];
+    for (int c = 0; c < N; c++) {
+      d[c] = float(rgba[i * 4 + c]) - mean[c];
+    }
+    for (int a = 0; a < N; a++) {
+      for (int b = 0; b < N; b++) {
+        cov[a][b] += d[a] * d[b];
+      }
+    }
+  }
+
+  // Power iteration starting from the bounding box diagonal.
+  float axis[N];
+  for (int c = 0; c < N; c++) {
+    axis[c] = mx[c] - mn[c];
+  }
+
+  for (int iter = 0; iter < 4; iter++) {
+    float v[N] = {};
+    for (int a = 0; a < N; a++) {
+      for (int b = 0; b < N; b++) {
+        v[a] += cov[a][b] * axis[b];
+      }
+    }
+    float m = 0.0f;
+    for (int c = 0; c < N; c++) {
+      m = (std::max)(m, std::fabs(v[c]));
+    }
+    if (m <= 0.0f) {
+      break;
+    }
+    for (int c = 0; c < N; c++) {
+      axis[c] = v[c] / m;
+    }
+  }
+
+  float len2 = 0.0f;
+  for (int c = 0; c < N; c++) {
+    len2 += axis[c] * axis[c];
+  }
+
+  if (len2 <= 0.0f) {
+    for (int c = 0; c < N; c++) {
+      e0[c] = mean[c];
+      e1[c] = mean[c];
+    }
+    return;
+  }
+
+  float inv_len = 1.0f / std::sqrt(len2);
+  for (int c = 0; c < N; c++) {
+    axis[c] *= inv_len;
+  }
+
+  float tmin = 0.0f;
+  float tmax = 0.0f;
+  for (int i = 0; i < 16; i++) {
+    float t = 0.0f;
+    for (int c = 0; c < N; c++) {
+      t += (float(rgba[i * 4 + c]) - mean[c]) * axis[c];
+    }
+    tmin = (std::min)(tmin, t);
+    tmax = (std::max)(tmax, t);
+  }
+
+  for (int c = 0; c < N; c++) {
+    e0[c] = Clamp255f(mean[c] + axis[c] * tmax);
+    e1[c] = Clamp255f(mean[c] + axis[c] * tmin);
+  }
+}
+
+//
+// Least squares fit of endpoints for given interpolation weights
+// (texel = (1 - w) * e0 + w * e1).
+//
+// @return false when the system is degenerated(endpoints are not updated).
+//
+template <int N>
+bool RefineEndpoints(const uint8_t rgba[64], const float w[16], float e0[4],
+                     float e1[4]) {
+  float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+  float ra[N] = {};
+  float rb[N] = {};
+
+  for (int i = 0; i < 16; i++) {
+    float a = 1.0f - w[i];
+    float b = w[i];
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (int c = 0; c < N; c++) {
+      float x = float(rgba[i * 4 + c]);
+      ra[c] += a * x;
+      rb[c] += b * x;
+    }
+  }
+
+  float det = aa * bb - ab * ab;
+  if (std::fabs(det) < 1.0e-6f) {
+    return false;
+  }
+
+  float inv_det = 1.0f / det;
+  for (int c = 0; c < N; c++) {
+    e0[c] = Clamp255f((bb * ra[c] - ab * rb[c]) * inv_det);
+    e1[c] = Clamp255f((aa * rb[c] - ab * ra[c]) * inv_det);
+  }
+  return true;
+}
+
+//
+// BC1
+//
+
+inline uint16_t ToRGB565(const float c[4]) {
+  int r = int(c[0] * (31.0f / 255.0f) + 0.5f);
+  int g = int(c[1] * (63.0f / 255.0f) + 0.5f);
+  int b = int(c[2] * (31.0f / 255.0f) + 0.5f);
+  r = (std::min)(31, (std::max)(0, r));
+  g = (std::min)(63, (std::max)(0, g));
+  b = (std::min)(31, (std::max)(0, b));
+  return uint16_t((r << 11) | (g << 5) | b);
+}
+
+inline void FromRGB565(uint16_t v, int rgb[3]) {
+  int r = (v >> 11) & 31;
+  int g = (v >> 5) & 63;
+  int b = v & 31;
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Select 4-color mode indices for (c0, c1). Returns squared error.
+uint32_t SelectBC1Indices(const uint8_t rgba[64], uint16_t c0, uint16_t c1,
+                          uint8_t indices[16]) {
+  int palette[4][3];
+  FromRGB565(c0, palette[0]);
+  FromRGB565(c1, palette[1]);
+  for (int c = 0; c < 3; c++) {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  uint32_t total = 0;
+  for (int i = 0; i < 16; i++) {
+    uint32_t best = ~0u;
+    uint8_t best_idx = 0;
+    for (uint8_t k = 0; k < 4; k++) {
+      int dr = int(rgba[i * 4 + 0]) - palette[k][0];
+      int dg = int(rgba[i * 4 + 1]) - palette[k][1];
+      int db = int(rgba[i * 4 + 2]) - palette[k][2];
+      uint32_t d = uint32_t(dr * dr + dg * dg + db * db);
+      if (d < best) {
+        best = d;
+        best_idx = k;
+      }
+    }
+    indices[i] = best_idx;
+    total += best;
+  }
+  return total;
+}
+
+// Encode color block of BC1/BC3(always 4-color mode).
+void EncodeBC1Block(const uint8_t rgba[64], uint8_t out[8]) {
+  uint16_t best_c0 = 0;
+  uint16_t best_c1 = 0;
+  uint8_t best_indices[16] = {};
+
+  if (IsSolidBlock(rgba, 3)) {
+    float c[4] = {float(rgba[0]), float(rgba[1]), float(rgba[2]), 0.0f};
+    best_c0 = ToRGB565(c);
+    best_c1 = best_c0;
+  } else {
+    float e0[4];
+    float e1[4];
+    FitPrincipalAxisEndpoints<3>(rgba, e0, e1);
+
+    // Interpolation weight of each palette entry(toward e1).
+    const float kWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+    uint32_t best_err = ~0u;
+    for (int iter = 0; iter < 2; iter++) {
+      uint16_t c0 = ToRGB565(e0);
+      uint16_t c1 = ToRGB565(e1);
+      uint8_t indices[16];
+      uint32_t err = SelectBC1Indices(rgba, c0, c1, indices);
+      if (err < best_err) {
+        best_err = err;
+        best_c0 = c0;
+        best_c1 = c1;
+        memcpy(best_indices, indices, 16);
+      }
+
+      if (err == 0) {
+        break;
+      }
+
+      float w[16];
+      for (int i = 0; i < 16; i++) {
+        w[i] = kWeights[indices[i]];
+      }
+      if (!RefineEndpoints<3>(rgba, w, e0, e1)) {
+        break;
+      }
+    }
+  }
+
+  // Ensure c0 > c1 to select 4-color mode.
+  if (best_c0 < best_c1) {
+    std::swap(best_c0, best_c1);
+    for (int i = 0; i < 16; i++) {
+      best_indices[i] ^= 1;
+    }
+  } else if (best_c0 == best_c1) {
+    memset(best_indices, 0, 16);
+  }
+
+  uint32_t bits = 0;
+  for (int i = 0; i < 16; i++) {
+    bits |= uint32_t(best_indices[i]) << (2 * i);
+  }
+
+  out[0] = uint8_t(best_c0 & 0xff);
+  out[1] = uint8_t(best_c0 >> 8);
+  out[2] = uint8_t(best_c1 & 0xff);
+  out[3] = uint8_t(best_c1 >> 8);
+  out[4] = uint8_t(bits & 0xff);
+  out[5] = uint8_t((bits >> 8) & 0xff);
+  out[6] = uint8_t((bits >> 16) & 0xff);
+  out[7] = uint8_t((bits >> 24) & 0xff);
+}
+
+//
+// BC4(also used for BC3 alpha and BC5)
+//
+// `channel` is the RGBA channel to encode.
+void EncodeBC4Block(const uint8_t rgba[64], int channel, uint8_t out[8]) {
+  int mn = 255;
+  int mx = 0;
+  for (int i = 0; i < 16; i++) {
+    int v = rgba[i * 4 + channel];
+    mn = (std::min)(mn, v);
+    mx = (std::max)(mx, v);
+  }
+
+  out[0] = uint8_t(mx);
+  out[1] = uint8_t(mn);
+
+  uint64_t bits = 0;
+  if (mx > mn) {
+    // 8 values mode(a0 > a1)
+    int palette[8];
+    palette[0] = mx;
+    palette[1] = mn;
+    for (int k = 2; k < 8; k++) {
+      palette[k] = ((8 - k) * mx + (k - 1) * mn) / 7;
+    }
+
+    for (int i = 0; i < 16; i++) {
+      int v = rgba[i * 4 + channel];
+      int best = 256 * 256;
+      uint64_t best_idx = 0;
+      for (int k = 0; k < 8; k++) {
+        int d = (v - palette[k]) * (v - palette[k]);
+        if (d < best) {
+          best = d;
+          best_idx = uint64_t(k);
+        }
+      }
+      bits |= best_idx << (3 * i);
+    }
+  }
+
+  for (int i = 0; i < 6; i++) {
+    out[2 + i] = uint8_t((bits >> (8 * i)) & 0xff);
+  }
+}
+
+//
+// BC7(mode 6 only)
+//
+
+// Quantize endpoint to 7bit RGBA + p-bit.
+void QuantizeBC7Mode6Endpoint(const float e[4], uint8_t q[4], int *pbit) {
+  uint32_t best_err = ~0u;
+  for (int p = 0; p < 2; p++) {
+    uint8_t tq[4];
+    uint32_t err = 0;
+    for (int c = 0; c < 4; c++) {
+      int v = int((e[c] - float(p)) * 0.5f + 0.5f);
+      v = (std::min)(127, (std::max)(0, v));
+      tq[c] = uint8_t(v);
+      int d = ((v << 1) | p) - int(e[c] + 0.5f);
+      err += uint32_t(d * d);
+    }
+    if (err < best_err) {
+      best_err = err;
+      memcpy(q, tq, 4);
+      (*pbit) = p;
+    }
+  }
+}
+
+uint32_t SelectBC7Mode6Indices(const uint8_t rgba[64], const uint8_t q0[4],
+                               int p0, const uint8_t q1[4], int p1,
+                               uint8_t indices[16]) {
+  int palette[16][4];
+  for (int c = 0; c < 4; c++) {
+    int a = (q0[c] << 1) | p0;
+    int b = (q1[c] << 1) | p1;
+    for (int k = 0; k < 16; k++) {
+      palette[k][c] =
+          ((64 - kBC7Weights4[k]) * a + kBC7Weights4[k] * b + 32) >> 6;
+    }
+  }
+
+  uint32_t total = 0;
+  for (int i = 0; i < 16; i++) {
+    uint32_t best = ~0u;
+    uint8_t best_idx = 0;
+    for (uint8_t k = 0; k < 16; k++) {
+      uint32_t d = 0;
+      for (int c = 0; c < 4; c++) {
+        int diff = int(rgba[i * 4 + c]) - palette[k][c];
+        d += uint32_t(diff * diff);
+      }
+      if (d < best) {
+        best = d;
+        best_idx = k;
+      }
+    }
+    indices[i] = best_idx;
+    total += best;
+  }
+  return total;
+}
+
+class BitWriter128 {
+ public:
+  void put(uint32_t value, uint32_t nbits) {
+    for (uint32_t i = 0; i < nbits; i++) {
+      if ((value >> i) & 1u) {
+        _bytes[_pos >> 3] |= uint8_t(1u << (_pos & 7));
+      }
+      _pos++;
+    }
+  }
+
+  const uint8_t *bytes() const { return _bytes; }
+
+ private:
+  uint8_t _bytes[16] = {};
+  uint32_t _pos{0};
+};
+
+void EncodeBC7Block(const uint8_t rgba[64], uint8_t out[16]) {
+  float e0[4];
+  float e1[4];
+
+  if (IsSolidBlock(rgba, 4)) {
+    for (int c = 0; c < 4; c++) {
+      e0[c] = float(rgba[c]);
+      e1[c] = float(rgba[c]);
+    }
+  } else {
+    FitPrincipalAxisEndpoints<4>(rgba, e0, e1);
+  }
+
+  uint8_t best_q0[4] = {};
+  uint8_t best_q1[4] = {};
+  int best_p0 = 0;
+  int best_p1 = 0;
+  uint8_t best_indices[16] = {};
+  uint32_t best_err = ~0u;
+
+  for (int iter = 0; iter < 2; iter++) {
+    uint8_t q0[4];
+    uint8_t q1[4];
+    int p0;
+    int p1;
+    QuantizeBC7Mode6Endpoint(e0, q0, &p0);
+    QuantizeBC7Mode6Endpoint(e1, q1, &p1);
+
+    uint8_t indices[16];
+    uint32_t err = SelectBC7Mode6Indices(rgba, q0, p0, q1, p1, indices);
+    if (err < best_err) {
+      best_err = err;
+      memcpy(best_q0, q0, 4);
+      memcpy(best_q1, q1, 4);
+      best_p0 = p0;
+      best_p1 = p1;
+      memcpy(best_indices, indices, 16);
+    }
+
+    if (err == 0) {
+      break;
+    }
+
+    float w[16];
+    for (int i = 0; i < 16; i++) {
+      w[i] = float(kBC7Weights4[indices[i]]) / 64.0f;
+    }
+    if (!RefineEndpoints<4>(rgba, w, e0, e1)) {
+      break;
+    }
+  }
+
+  // MSB of the anchor index(texel 0) is implicitly zero.
+  if (best_indices[0] & 8) {
+    uint8_t tmp[4];
+    memcpy(tmp, best_q0, 4);
+    memcpy(best_q0, best_q1, 4);
+    memcpy(best_q1, tmp, 4);
+    std::swap(best_p0, best_p1);
+    for (int i = 0; i < 16; i++) {
+      best_indices[i] = uint8_t(15 - best_indices[i]);
+    }
+  }
+
+  BitWriter128 bw;
+  bw.put(1u << 6, 7);  // mode 6
+  for (int c = 0; c < 4; c++) {
+    bw.put(best_q0[c], 7);
+    bw.put(best_q1[c], 7);
+  }
+  bw.put(uint32_t(best_p0), 1);
+  bw.put(uint32_t(best_p1), 1);
+  bw.put(best_indices[0], 3);
+  for (int i = 1; i < 16; i++) {
+    bw.put(best_indices[i], 4);
+  }
+
+  memcpy(out, bw.bytes(), 16);
+}
+
+void EncodeBlock(TextureCompressionFormat fmt, const uint8_t rgba[64],
+                 uint8_t *out) {
+  switch (fmt) {
+    case TextureCompressionFormat::BC1:
+      EncodeBC1Block(rgba, out);
+      break;
+    case TextureCompressionFormat::BC3:
+      EncodeBC4Block(rgba, 3, out);
+      EncodeBC1Block(rgba, out + 8);
+      break;
+    case TextureCompressionFormat::BC4:
+      EncodeBC4Block(rgba, 0, out);
+      break;
+    case TextureCompressionFormat::BC5:
+      EncodeBC4Block(rgba, 0, out);
+      EncodeBC4Block(rgba, 1, out + 8);
+      break;
+    case TextureCompressionFormat::BC7:
+      EncodeBC7Block(rgba, out);
+      break;
+    case TextureCompressionFormat::None:
+      break;
+  }
+}
+
+}  // namespace
+
+size_t GetCompressedBlockBytes(TextureCompressionFormat fmt) {
+  switch (fmt) {
+    case TextureCompressionFormat::BC1:
+    case TextureCompressionFormat::BC4:
+      return 8;
+    case TextureCompressionFormat::BC3:
+    case TextureCompressionFormat::BC5:
+    case TextureCompressionFormat::BC7:
+      return 16;
+    case TextureCompressionFormat::None:
+      break;
+  }
+  return 0;
+}
+
+size_t GetCompressedImageBytes(TextureCompressionFormat fmt, size_t width,
+                               size_t height) {
+  return ((width + 3) / 4) * ((height + 3) / 4) * GetCompressedBlockBytes(fmt);
+}
+
+bool CompressImage(const uint8_t *src, size_t width, size_t height,
+                   size_t channels, TextureCompressionFormat fmt,
+                   std::vector<uint8_t> *dst, std::string *err,
+                   int num_threads) {
+  if (!src || !dst) {
+    if (err) {
+      (*err) += "`src` or `dst` is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((width == 0) || (height == 0) || (channels == 0) || (channels > 4)) {
+    if (err) {
+      (*err) += "Invalid image size or # of channels for texture compression.\n";
+    }
+    return false;
+  }
+
+  const size_t block_bytes = GetCompressedBlockBytes(fmt);
+  if (block_bytes == 0) {
+    if (err) {
+      (*err) += "Invalid texture compression format.\n";
+    }
+    return false;
+  }
+
+  const size_t num_block_x = (width + 3) / 4;
+  const size_t num_block_y = (height + 3) / 4;
+
+  dst->resize(num_block_x * num_block_y * block_bytes);
+  uint8_t *dst_ptr = dst->data();
+
+  size_t grain = (std::max)(size_t(1), kParallelGrainBlocks / num_block_x);
+
+  parallel::ParallelForChunked(
+      num_block_y,
+      [=](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        uint8_t rgba[64];
+        for (size_t by = begin; by < end; by++) {
+          for (size_t bx = 0; bx < num_block_x; bx++) {
+            FetchBlockRGBA(src, width, height, channels, bx, by, rgba);
+            EncodeBlock(fmt, rgba,
+                        dst_ptr + (by * num_block_x + bx) * block_bytes);
+          }
+        }
+      },
+      num_threads, grain);
+
+  return true;
+}
+
+bool CompressTextureImage(const BufferData &src, TextureCompressionFormat fmt,
+                          bool mipmaps, TextureImage *image, BufferData *dst,
+                          std::string *err, int num_threads) {
+  if (!image || !dst) {
+    if (err) {
+      (*err) += "`image` or `dst` is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((image->width <= 0) || (image->height <= 0) || (image->channels <= 0) ||
+      (image->channels > 4)) {
+    if (err) {
+      (*err) += "Invalid TextureImage size or # of channels for texture compression.\n";
+    }
+    return false;
+  }
+
+  size_t texel_bytes;
+  if (src.componentType == ComponentType::UInt8) {
+    texel_bytes = 1;
+  } else if (src.componentType == ComponentType::Float) {
+    texel_bytes = sizeof(float);
+  } else {
+    if (err) {
+      (*err) += "Unsupported texel component type for texture compression: " +
+                to_string(src.componentType) + "\n";
+    }
+    return false;
+  }
+
+  size_t channels = size_t(image->channels);
+
+  // Uncompressed mip chain.
+  BufferData chain;
+  const BufferData *levels_src = &src;
+  if (image->mipLevels.empty() && mipmaps) {
+    bool srgb = (image->colorSpace == ColorSpace::sRGB) &&
+                (src.componentType == ComponentType::UInt8);
+    if (!BuildTextureMipChain(src, srgb, image, &chain, err)) {
+      return false;
+    }
+    levels_src = &chain;
+  }
+
+  std::vector<TextureMipLevel> src_levels = image->mipLevels;
+  if (src_levels.empty()) {
+    TextureMipLevel level;
+    level.width = image->width;
+    level.height = image->height;
+    level.byte_offset = 0;
+    level.byte_length = size_t(image->width) * size_t(image->height) *
+                        channels * texel_bytes;
+    src_levels.push_back(level);
+  }
+
+  std::vector<TextureMipLevel> levels;
+  uint64_t total_bytes = 0;
+  for (const auto &src_level : src_levels) {
+    if ((src_level.width <= 0) || (src_level.height <= 0) ||
+        (src_level.byte_length < size_t(src_level.width) *
+                                     size_t(src_level.height) * channels *
+                                     texel_bytes) ||
+        (src_level.byte_offset + src_level.byte_length >
+         levels_src->data.size())) {
+      if (err) {
+        (*err) += "Insufficient texel data for texture compression.\n";
+      }
+      return false;
+    }
+
+    TextureMipLevel level;
+    level.width = src_level.width;
+    level.height = src_level.height;
+    level.byte_offset = total_bytes;
+    level.byte_length =
+        GetCompressedImageBytes(fmt, size_t(level.width), size_t(level.height));
+    total_bytes += level.byte_length;
+    levels.push_back(level);
+  }
+
+  dst->data.resize(size_t(total_bytes));
+
+  std::vector<uint8_t> quantized;
+  std::vector<uint8_t> blocks;
+
+  for (size_t i = 0; i < levels.size(); i++) {
+    size_t w = size_t(levels[i].width);
+    size_t h = size_t(levels[i].height);
+    size_t num_texels = w * h * channels;
+
+    const uint8_t *level_src =
+        levels_src->data.data() + src_levels[i].byte_offset;
+
+    if (src.componentType == ComponentType::Float) {
+      quantized.resize(num_texels);
+      for (size_t k = 0; k < num_texels; k++) {
+        float f;
+        memcpy(&f, level_src + k * sizeof(float), sizeof(float));
+        quantized[k] = uint8_t(Clamp255(int(f * 255.0f + 0.5f)));
+      }
+      level_src = quantized.data();
+    }
+
+    if (!CompressImage(level_src, w, h, channels, fmt, &blocks, err,
+                       num_threads)) {
+      return false;
+    }
+
+    memcpy(dst->data.data() + levels[i].byte_offset, blocks.data(),
+           blocks.size());
+  }
+
+  dst->componentType = ComponentType::UInt8;
+
+  image->texelComponentType = ComponentType::UInt8;
+  image->compressionFormat = fmt;
+  image->mipLevels = std::move(levels);
+
+  return true;
+}
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// CPU block compressor(BC1/BC3/BC4/BC5/BC7) for Tydra texture images.
+//
+// Encoders are tuned for conversion speed rather than the best quality
+// (principal axis endpoint fit + least squares refinement). BC7 uses mode 6
+// only(single subset, RGBA).
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "render-data.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+///
+/// @return Bytes of a 4x4 block. 0 for `TextureCompressionFormat::None`.
+///
+size_t GetCompressedBlockBytes(TextureCompressionFormat fmt);
+
+///
+/// @return Bytes of compressed image(partial blocks at the right/bottom edge
+/// are counted as full blocks).
+///
+size_t GetCompressedImageBytes(TextureCompressionFormat fmt, size_t width,
+                               size_t height);
+
+///
+/// Compress 8bit image.
+///
+/// Channels are mapped to RGBA as: 1ch = (r, r, r, 255), 2ch = (r, g, 0, 255),
+/// 3ch = (r, g, b, 255), 4ch = (r, g, b, a).
+///
+/// @param[in] src Texel data(`width` x `height` x `channels`).
+/// @param[in] fmt Compression format.
+/// @param[out] dst Compressed blocks(row-major).
+/// @param[in] num_threads # of threads. -1 = use all hardware threads.
+///
+bool CompressImage(const uint8_t *src, size_t width, size_t height,
+                   size_t channels, TextureCompressionFormat fmt,
+                   std::vector<uint8_t> *dst, std::string *err,
+                   int num_threads = -1);
+
+///
+/// Compress texel data of TextureImage(and generate mip chain optionally).
+///
+/// `src` must be UInt8 or Float(quantized to 8bit) texel data. When
+/// `image->mipLevels` is not empty, `src` is treated as uncompressed mip chain
+/// and each level is compressed.
+///
+/// @param[in] src Uncompressed texel data of `image`.
+/// @param[in] fmt Compression format.
+/// @param[in] mipmaps Generate(`BuildTextureMipChain`) and compress mip chain
+/// down to 1x1 when `image` does not have mip levels.
+/// @param[inout] image TextureImage. `compressionFormat` and `mipLevels` are
+/// updated, and `texelComponentType` is set to UInt8.
+/// @param[out] dst Compressed mip chain(level 0 first).
+/// @param[in] num_threads # of threads. -1 = use all hardware threads.
+///
+bool CompressTextureImage(const BufferData &src, TextureCompressionFormat fmt,
+                          bool mipmaps, TextureImage *image, BufferData *dst,
+                          std::string *err, int num_threads = -1);
+
+}  // namespace tydra
+}  // namespace tinyusdz
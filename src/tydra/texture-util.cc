@@ -1,5 +1,9 @@
 #include "texture-util.hh"
 
+#include <cstring>
+
+#include "image-util.hh"
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Weverything"
@@ -166,5 +170,149 @@ bool BuildOcclusionRoughnessMetallicTexture(
 	return true;
 }
 
+void ComputeDownscaledTextureSize(size_t width, size_t height, size_t max_size,
+                                  size_t *dst_width, size_t *dst_height) {
+  size_t w = width;
+  size_t h = height;
+
+  if ((max_size > 0) && ((w > max_size) || (h > max_size))) {
+    if (w >= h) {
+      h = (std::max)(size_t(1), (h * max_size + w / 2) / w);
+      w = max_size;
+    } else {
+      w = (std::max)(size_t(1), (w * max_size + h / 2) / h);
+      h = max_size;
+    }
+  }
+
+  (*dst_width) = w;
+  (*dst_height) = h;
+}
+
+bool ResizeTexels(const std::vector<uint8_t> &src,
+                  ComponentType texelComponentType, size_t width,
+                  size_t height, size_t channels, size_t dst_width,
+                  size_t dst_height, bool srgb, std::vector<uint8_t> *dst,
+                  std::string *err) {
+  if (!dst) {
+    if (err) {
+      (*err) += "`dst` is nullptr.\n";
+    }
+    return false;
+  }
+
+  if (texelComponentType == ComponentType::UInt8) {
+    if (srgb) {
+      return resize_image_u8_srgb(src, width, 0, height, dst_width, 0,
+                                  dst_height, channels, dst, err);
+    }
+    return resize_image_u8(src, width, 0, height, dst_width, 0, dst_height,
+                           channels, dst, err);
+  } else if (texelComponentType == ComponentType::Float) {
+    std::vector<float> src_f32(src.size() / sizeof(float));
+    memcpy(src_f32.data(), src.data(), src_f32.size() * sizeof(float));
+
+    std::vector<float> dst_f32;
+    if (!resize_image_f32(src_f32, width, 0, height, dst_width, 0, dst_height,
+                          channels, &dst_f32, err)) {
+      return false;
+    }
+
+    dst->resize(dst_f32.size() * sizeof(float));
+    memcpy(dst->data(), dst_f32.data(), dst->size());
+    return true;
+  }
+
+  if (err) {
+    (*err) += "Unsupported texel component type for resize: " +
+              to_string(texelComponentType) + "\n";
+  }
+  return false;
+}
+
+bool BuildTextureMipChain(const BufferData &src, bool srgb,
+                          TextureImage *image, BufferData *dst,
+                          std::string *err) {
+  if (!image || !dst) {
+    if (err) {
+      (*err) += "`image` or `dst` is nullptr.\n";
+    }
+    return false;
+  }
+
+  if ((image->width <= 0) || (image->height <= 0) || (image->channels <= 0)) {
+    if (err) {
+      (*err) += "Invalid TextureImage size or # of channels.\n";
+    }
+    return false;
+  }
+
+  size_t texel_bytes;
+  if (src.componentType == ComponentType::UInt8) {
+    texel_bytes = 1;
+  } else if (src.componentType == ComponentType::Float) {
+    texel_bytes = sizeof(float);
+  } else {
+    if (err) {
+      (*err) += "Unsupported texel component type for mipmap: " +
+                to_string(src.componentType) + "\n";
+    }
+    return false;
+  }
+
+  size_t channels = size_t(image->channels);
+  size_t w = size_t(image->width);
+  size_t h = size_t(image->height);
+  size_t level0_bytes = w * h * channels * texel_bytes;
+  if (src.data.size() < level0_bytes) {
+    if (err) {
+      (*err) += "Insufficient texel data for mipmap.\n";
+    }
+    return false;
+  }
+
+  std::vector<TextureMipLevel> levels;
+  uint64_t total_bytes = 0;
+  while (true) {
+    TextureMipLevel level;
+    level.width = int32_t(w);
+    level.height = int32_t(h);
+    level.byte_offset = total_bytes;
+    level.byte_length = w * h * channels * texel_bytes;
+    total_bytes += level.byte_length;
+    levels.push_back(level);
+
+    if ((w == 1) && (h == 1)) {
+      break;
+    }
+    w = (std::max)(size_t(1), w / 2);
+    h = (std::max)(size_t(1), h / 2);
+  }
+
+  dst->componentType = src.componentType;
+  dst->data.resize(size_t(total_bytes));
+  memcpy(dst->data.data(), src.data.data(), level0_bytes);
+
+  std::vector<uint8_t> prev(src.data.begin(),
+                            src.data.begin() + std::ptrdiff_t(level0_bytes));
+  std::vector<uint8_t> next;
+  for (size_t i = 1; i < levels.size(); i++) {
+    if (!ResizeTexels(prev, src.componentType, size_t(levels[i - 1].width),
+                      size_t(levels[i - 1].height), channels,
+                      size_t(levels[i].width), size_t(levels[i].height), srgb,
+                      &next, err)) {
+      return false;
+    }
+
+    memcpy(dst->data.data() + levels[i].byte_offset, next.data(),
+           size_t(levels[i].byte_length));
+    prev.swap(next);
+  }
+
+  image->mipLevels = std::move(levels);
+
+  return true;
+}
+
 } // namespace tydra
 } // namespace tinyusdz
@@ -8,6 +8,9 @@
 #include <vector>
 #include <cstdint>
 #include <cstdlib>
+#include <string>
+
+#include "render-data.hh"
 
 namespace tinyusdz {
 namespace tydra {
@@ -39,6 +42,42 @@ bool BuildOcclusionRoughnessMetallicTexture(
   size_t &dstWidth,	
   size_t &dstHeight);
 
+///
+/// Compute texture size downscaled so that both width and height are equal
+/// or less than `max_size`(aspect ratio is kept. Each side is at least 1).
+/// Size is not changed when `max_size` is 0.
+///
+void ComputeDownscaledTextureSize(size_t width, size_t height, size_t max_size,
+                                  size_t *dst_width, size_t *dst_height);
+
+///
+/// Resize 8bit or fp32 texel data.
+///
+/// @param[in] src Texel data(byte array).
+/// @param[in] texelComponentType Texel type of `src`. UInt8 or Float.
+/// @param[in] srgb Texel is in sRGB color space(filtered in linear space. 8bit
+/// texel only).
+/// @param[out] dst Resized texel data.
+///
+bool ResizeTexels(const std::vector<uint8_t> &src,
+                  ComponentType texelComponentType, size_t width,
+                  size_t height, size_t channels, size_t dst_width,
+                  size_t dst_height, bool srgb, std::vector<uint8_t> *dst,
+                  std::string *err);
+
+///
+/// Build full mip chain(down to 1x1) of uncompressed texel data.
+/// Each level is resized from the previous level.
+///
+/// @param[in] src Texel data of level 0(UInt8 or Float).
+/// @param[in] srgb Texel is in sRGB color space.
+/// @param[inout] image TextureImage of `src`. `mipLevels` is updated.
+/// @param[out] dst Mip chain(level 0 first).
+///
+bool BuildTextureMipChain(const BufferData &src, bool srgb,
+                          TextureImage *image, BufferData *dst,
+                          std::string *err);
+
 
 } // namespace tydra
 } // namespace tinyusdz
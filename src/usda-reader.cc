@@ -61,6 +61,7 @@
 
 #include "io-util.hh"
 #include "math-util.inc"
+#include "performance.hh"
 #include "pprinter.hh"
 #include "prim-types.hh"
 #include "prim-reconstruct.hh"
@@ -320,6 +321,9 @@ class USDAReader::Impl {
 
   void set_reader_config(const USDAReaderConfig &config) {
     _config = config;
+    if (_prim_reservation.budget() != _config.memory_budget) {
+      _prim_reservation = MemoryReservation(_config.memory_budget);
+    }
   }
 
   const USDAReaderConfig get_reader_config() const {
@@ -399,6 +403,13 @@ class USDAReader::Impl {
                 "Unexpected primIdx value. primIdx must be positive.");
           }
 
+          {
+            std::string budget_err;
+            if (!ReservePrimMemory(&_prim_reservation, properties, &budget_err)) {
+              return nonstd::make_unexpected(budget_err);
+            }
+          }
+
           T prim;
 
           if (!ReconstructPrimMeta(in_meta, &prim.meta)) {
@@ -547,6 +558,13 @@ class USDAReader::Impl {
             return nonstd::make_unexpected("Prim's name should not be empty ");
           }
 
+          {
+            std::string budget_err;
+            if (!ReservePrimMemory(&_prim_reservation, properties, &budget_err)) {
+              return nonstd::make_unexpected(budget_err);
+            }
+          }
+
           PrimSpec primspec;
           primspec.name() = prim_name.prim_part();
           primspec.specifier() = spec;
@@ -1284,6 +1302,10 @@ class USDAReader::Impl {
   // Used for Ascii parser option
   USDAReaderConfig _config;
 
+  // Memory reserved for reconstructed Prims. Moved to the Stage in
+  // `ReconstructStage`, otherwise released when the reader is destroyed.
+  MemoryReservation _prim_reservation;
+
   ascii::AsciiParser _parser;
 
 };  // namespace usda
@@ -1379,6 +1401,7 @@ bool ToPrimSpecRec(const size_t primSpecIdx,
 }  // namespace
 
 bool USDAReader::Impl::GetAsLayer(Layer *layer) {
+  TINYUSDZ_TRACE_ZONE("USDAReader::GetAsLayer");
 
   if (!layer) {
     PUSH_ERROR_AND_RETURN("layer arg is nullptr.");
@@ -1530,6 +1553,7 @@ bool ConstructPrimTreeRec(const size_t primIdx,
 
 
 bool USDAReader::Impl::ReconstructStage() {
+  TINYUSDZ_TRACE_ZONE("USDAReader::ReconstructStage");
   _stage.root_prims().clear();
 
   for (const auto &idx : _toplevel_prims) {
@@ -1548,6 +1572,9 @@ bool USDAReader::Impl::ReconstructStage() {
   // Compute Abs Path from built Prim tree and Assign prim id.
   _stage.compute_absolute_prim_path_and_assign_prim_id();
 
+  _stage.set_memory_reservation(
+      std::make_shared<MemoryReservation>(std::move(_prim_reservation)));
+
   return true;
 }
 
@@ -1631,6 +1658,7 @@ bool USDAReader::Impl::ReconstructPrim(
 ///
 
 bool USDAReader::Impl::Read(const uint32_t state_flags, bool as_primspec) {
+  TINYUSDZ_TRACE_ZONE("USDAReader::Read");
 
   ///
   /// Convert parser option.
@@ -1639,6 +1667,7 @@ bool USDAReader::Impl::Read(const uint32_t state_flags, bool as_primspec) {
   ascii_parser_option.allow_unknown_prim = _config.allow_unknown_prims;
   ascii_parser_option.allow_unknown_apiSchema = _config.allow_unknown_apiSchema;
   ascii_parser_option.strict_allowedToken_check = _config.strict_allowedToken_check;
+  ascii_parser_option.population_mask = _config.population_mask;
 
   ///
   /// Setup callbacks.
@@ -18,6 +18,14 @@ struct USDAReaderConfig {
   bool allow_unknown_shader{true};
   bool allow_unknown_apiSchema{true};
   bool strict_allowedToken_check{false};
+
+  // Optional. Account reconstructed Prims to this budget and fail when the
+  // budget is exceeded.
+  std::shared_ptr<MemoryBudget> memory_budget;
+
+  // Optional. Population mask(list of absolute Prim paths). Prim blocks
+  // outside of the mask are skipped without parsing. Empty = load all Prims.
+  std::vector<Path> population_mask;
 };
 
 ///
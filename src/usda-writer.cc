@@ -9,32 +9,299 @@
 
 #if !defined(TINYUSDZ_DISABLE_MODULE_USDA_WRITER)
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
 #include "pprinter.hh"
+#include "prim-pprint.hh"
 #include "value-pprint.hh"
 #include "tinyusdz.hh"
 #include "io-util.hh"
+#include "parallel-for.hh"
 
 namespace tinyusdz {
 namespace usda {
 
 namespace {
 
+// Upper bound of # of Prims serialized ahead in one batch.
+constexpr size_t kMaxPrimsInFlight = 16384;
 
-}  // namespace
+///
+/// Accumulates USDA text and hands it to the callback in `buffer_size` chunks.
+///
+class BufferedSink {
+ public:
+  BufferedSink(USDAWriteCallback callback, void *userdata, size_t buffer_size)
+      : _callback(callback), _userdata(userdata) {
+    _buffer_size = (std::max)(size_t(1), buffer_size);
+    _buf.reserve((std::min)(_buffer_size, size_t(1024 * 1024)));
+  }
 
-bool SaveAsUSDA(const std::string &filename, const Stage &stage,
-                std::string *warn, std::string *err) {
+  bool write(const std::string &s) {
+    if (s.size() >= _buffer_size) {
+      // Large chunk. Write it directly without copying to the buffer.
+      if (!flush()) {
+        return false;
+      }
+      return emit(s.data(), s.size());
+    }
+
+    if ((_buf.size() + s.size()) > _buffer_size) {
+      if (!flush()) {
+        return false;
+      }
+    }
+
+    _buf.append(s);
+    return true;
+  }
+
+  bool flush() {
+    if (_buf.empty()) {
+      return true;
+    }
+
+    bool ret = emit(_buf.data(), _buf.size());
+    _buf.clear();
+    return ret;
+  }
+
+  const std::string &error() const { return _err; }
+
+ private:
+  bool emit(const char *data, size_t nbytes) {
+    if (!_callback(data, nbytes, _userdata, &_err)) {
+      if (_err.empty()) {
+        _err = "USDA write callback returned false.\n";
+      }
+      return false;
+    }
+    return true;
+  }
+
+  USDAWriteCallback _callback{nullptr};
+  void *_userdata{nullptr};
+  size_t _buffer_size{1};
+  std::string _buf;
+  std::string _err;
+};
+
+///
+/// Flattened Prim tree in output order.
+/// Only `Head` segment requires (expensive) serialization of Prim contents.
+///
+struct Segment {
+  enum class Kind { Head, Tail, Separator };
+
+  Kind kind{Kind::Separator};
+  const Prim *prim{nullptr};
+  uint32_t indent{0};
+};
+
+void BuildSegmentsRec(const Prim &prim, const uint32_t indent,
+                      std::vector<Segment> *segments) {
+  segments->push_back({Segment::Kind::Head, &prim, indent});
+
+  std::vector<const Prim *> children;
+  prim::get_ordered_children(prim, &children);
+
+  for (size_t i = 0; i < children.size(); i++) {
+    if (i > 0) {
+      segments->push_back({Segment::Kind::Separator, nullptr, 0});
+    }
+    if (children[i]) {
+      BuildSegmentsRec(*children[i], indent + 1, segments);
+    }
+  }
+
+  segments->push_back({Segment::Kind::Tail, &prim, indent});
+}
 
+// Same ordering rule with Stage::ExportToString()
+void BuildSegments(const Stage &stage, std::vector<Segment> *segments) {
+  const StageMetas &metas = stage.metas();
+  const std::vector<Prim> &root_prims = stage.root_prims();
+
+  if (metas.primChildren.size() == root_prims.size()) {
+    std::map<std::string, const Prim *> primNameTable;
+    for (size_t i = 0; i < root_prims.size(); i++) {
+      primNameTable.emplace(root_prims[i].element_name(), &root_prims[i]);
+    }
+
+    for (size_t i = 0; i < metas.primChildren.size(); i++) {
+      const auto it = primNameTable.find(metas.primChildren[i].str());
+      if (it != primNameTable.end()) {
+        BuildSegmentsRec(*(it->second), 0, segments);
+        if (i != (metas.primChildren.size() - 1)) {
+          segments->push_back({Segment::Kind::Separator, nullptr, 0});
+        }
+      } else {
+        // TODO: Report warning?
+      }
+    }
+  } else {
+    for (size_t i = 0; i < root_prims.size(); i++) {
+      BuildSegmentsRec(root_prims[i], 0, segments);
+      if (i != (root_prims.size() - 1)) {
+        segments->push_back({Segment::Kind::Separator, nullptr, 0});
+      }
+    }
+  }
+}
+
+bool WriteToStreamCallback(const char *data, size_t nbytes, void *userdata,
+                           std::string *err) {
+  std::ostream *ofs = reinterpret_cast<std::ostream *>(userdata);
+  ofs->write(data, static_cast<std::streamsize>(nbytes));
+  if (!(*ofs)) {
+    if (err) {
+      (*err) += "File write error.\n";
+    }
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool SaveAsUSDAToCallback(const Stage &stage, USDAWriteCallback callback,
+                          void *userdata, std::string *warn, std::string *err,
+                          const USDAWriterConfig &config) {
   (void)warn;
 
-  // TODO: Handle warn and err on export.
-  std::string s = stage.ExportToString();
+  if (!callback) {
+    if (err) {
+      (*err) += "`callback` is nullptr.\n";
+    }
+    return false;
+  }
+
+  BufferedSink sink(callback, userdata, config.buffer_size);
+
+#define WRITE_OR_RETURN(__s) do { \
+    if (!sink.write(__s)) { \
+      if (err) { \
+        (*err) += sink.error(); \
+      } \
+      return false; \
+    } \
+  } while (0)
+
+  {
+    std::stringstream ss;
+    ss << "#usda 1.0\n";
+
+    std::string meta_str = print_layer_metas(stage.metas(), /* indent */ 1);
+    if (meta_str.size()) {
+      ss << "(\n";
+      ss << meta_str;
+      ss << ")\n";
+    }
+
+    ss << "\n";
+
+    WRITE_OR_RETURN(ss.str());
+  }
 
-  if (!io::WriteWholeFile(filename, reinterpret_cast<const unsigned char *>(s.data()), s.size(), err)) {
+  std::vector<Segment> segments;
+  BuildSegments(stage, &segments);
+
+  const int num_threads = parallel::GetNumThreads(config.num_threads);
+
+  // # of Prims serialized ahead. Adjusted after each batch so that the
+  // serialized text of a batch roughly fits into `buffer_size`.
+  size_t batch_size = size_t(num_threads) * 4;
+
+  std::vector<size_t> heads;
+  std::vector<std::string> texts;
+
+  size_t s_begin = 0;
+  while (s_begin < segments.size()) {
+    heads.clear();
+
+    size_t s_end = s_begin;
+    while ((s_end < segments.size()) && (heads.size() < batch_size)) {
+      if (segments[s_end].kind == Segment::Kind::Head) {
+        heads.push_back(s_end);
+      }
+      s_end++;
+    }
+
+    texts.clear();
+    texts.resize(heads.size());
+
+    parallel::ParallelFor(
+        heads.size(),
+        [&](size_t k, int thread_id) {
+          (void)thread_id;
+          const Segment &seg = segments[heads[k]];
+          texts[k] = prim::print_prim_head(*seg.prim, seg.indent);
+        },
+        num_threads);
+
+    size_t batch_bytes = 0;
+    size_t h = 0;
+    for (size_t s = s_begin; s < s_end; s++) {
+      const Segment &seg = segments[s];
+      if (seg.kind == Segment::Kind::Head) {
+        batch_bytes += texts[h].size();
+        WRITE_OR_RETURN(texts[h]);
+        // Release memory as soon as possible.
+        std::string().swap(texts[h]);
+        h++;
+      } else if (seg.kind == Segment::Kind::Tail) {
+        WRITE_OR_RETURN(prim::print_prim_tail(*seg.prim, seg.indent));
+      } else {
+        WRITE_OR_RETURN("\n");
+      }
+    }
+
+    if (heads.size()) {
+      size_t avg_bytes = (std::max)(size_t(1), batch_bytes / heads.size());
+      batch_size = (std::max)(size_t(1), config.buffer_size / avg_bytes);
+      batch_size = (std::max)(size_t(num_threads), batch_size);
+      batch_size = (std::min)(kMaxPrimsInFlight, batch_size);
+    }
+
+    s_begin = s_end;
+  }
+
+#undef WRITE_OR_RETURN
+
+  if (!sink.flush()) {
+    if (err) {
+      (*err) += sink.error();
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool SaveAsUSDA(const std::string &filename, const Stage &stage,
+                std::string *warn, std::string *err,
+                const USDAWriterConfig &config) {
+
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(_LIBCPP_VERSION))
+  std::ofstream ofs(io::UTF8ToWchar(filename).c_str(), std::ofstream::binary);
+#else
+  std::ofstream ofs(filename.c_str(), std::ofstream::binary);
+#endif
+  if (!ofs) {
+    if (err) {
+      (*err) += "File open error for writing : " + filename + "\n";
+    }
+    return false;
+  }
+
+  std::ostream *os = &ofs;
+  if (!SaveAsUSDAToCallback(stage, WriteToStreamCallback, reinterpret_cast<void *>(os), warn, err, config)) {
+    if (err) {
+      (*err) += "Failed to write USDA : " + filename + "\n";
+    }
     return false;
   }
 
@@ -45,14 +312,24 @@ bool SaveAsUSDA(const std::string &filename, const Stage &stage,
 
 #if defined(_WIN32)
 bool SaveAsUSDA(const std::wstring &filename, const Stage &stage,
-                std::string *warn, std::string *err) {
+                std::string *warn, std::string *err,
+                const USDAWriterConfig &config) {
 
-  (void)warn;
-
-  // TODO: Handle warn and err on export.
-  std::string s = stage.ExportToString();
+#if defined(_MSC_VER) || defined(_LIBCPP_VERSION)
+  // MSVC extension allow wstrng as an argument.
+  std::ofstream ofs(filename.c_str(), std::ofstream::binary);
+#else
+  std::ofstream ofs(io::WcharToUTF8(filename).c_str(), std::ofstream::binary);
+#endif
+  if (!ofs) {
+    if (err) {
+      (*err) += "File open error for writing : " + io::WcharToUTF8(filename) + "\n";
+    }
+    return false;
+  }
 
-  if (!io::WriteWholeFile(filename, reinterpret_cast<const unsigned char *>(s.data()), s.size(), err)) {
+  std::ostream *os = &ofs;
+  if (!SaveAsUSDAToCallback(stage, WriteToStreamCallback, reinterpret_cast<void *>(os), warn, err, config)) {
     return false;
   }
 
@@ -71,10 +348,24 @@ bool SaveAsUSDA(const std::wstring &filename, const Stage &stage,
 namespace tinyusdz {
 namespace usda {
 
-bool SaveAsUSDA(const std::string &filename, const Stage &stage, std::string *warn, std::string *err) {
+bool SaveAsUSDA(const std::string &filename, const Stage &stage, std::string *warn, std::string *err, const USDAWriterConfig &config) {
   (void)filename;
   (void)stage;
   (void)warn;
+  (void)config;
+
+  if (err) {
+    (*err) = "USDA Writer feature is disabled in this build.\n";
+  }
+  return false;
+}
+
+bool SaveAsUSDAToCallback(const Stage &stage, USDAWriteCallback callback, void *userdata, std::string *warn, std::string *err, const USDAWriterConfig &config) {
+  (void)stage;
+  (void)callback;
+  (void)userdata;
+  (void)warn;
+  (void)config;
 
   if (err) {
     (*err) = "USDA Writer feature is disabled in this build.\n";
@@ -1,10 +1,44 @@
 #pragma once
 
+#include <cstddef>
+
 #include "tinyusdz.hh"
 
 namespace tinyusdz {
 namespace usda {
 
+///
+/// Config for the (streaming) USDA writer.
+///
+struct USDAWriterConfig {
+  ///
+  /// Size of the output buffer in bytes. Serialized text is accumulated up to
+  /// this size before it is handed to the sink(file or callback). Also used to
+  /// bound the number of Prims serialized ahead(in parallel).
+  ///
+  size_t buffer_size = 16 * 1024 * 1024;
+
+  ///
+  /// # of threads to serialize Prims. -1 = use all hardware threads.
+  ///
+  int num_threads = -1;
+};
+
+///
+/// Callback to receive serialized USDA text.
+/// Invoked sequentially(in output order) from the thread calling
+/// `SaveAsUSDAToCallback`.
+///
+/// @param[in] data Pointer to the chunk of USDA text.
+/// @param[in] nbytes Chunk size in bytes.
+/// @param[in] userdata Userdata passed to `SaveAsUSDAToCallback`.
+/// @param[out] err Error message.
+///
+/// @return false to abort writing.
+///
+typedef bool (*USDAWriteCallback)(const char *data, size_t nbytes,
+                                  void *userdata, std::string *err);
+
 ///
 /// Save scene as USDA(ASCII)
 ///
@@ -12,15 +46,34 @@ namespace usda {
 /// @param[in] stage Stage(scene graph).
 /// @param[out] warn Warning message
 /// @param[out] err Error message
+/// @param[in] config Writer config.
 ///
 /// @return true upon success.
 ///
-bool SaveAsUSDA(const std::string &filename, const Stage &stage, std::string *warn, std::string *err);
+/// USDA text is streamed to the file through a buffer of
+/// `config.buffer_size` bytes, so the whole USDA text is never built in memory.
+///
+bool SaveAsUSDA(const std::string &filename, const Stage &stage, std::string *warn, std::string *err, const USDAWriterConfig &config = USDAWriterConfig());
 
 #if defined(_WIN32)
 // WideChar(UNICODE) filename version.
-bool SaveAsUSDA(const std::wstring &filename, const Stage &stage, std::string *warn, std::string *err);
+bool SaveAsUSDA(const std::wstring &filename, const Stage &stage, std::string *warn, std::string *err, const USDAWriterConfig &config = USDAWriterConfig());
 #endif
 
+///
+/// Save scene as USDA(ASCII) through user-supplied callback.
+/// Output is identical to `Stage::ExportToString()`.
+///
+/// @param[in] stage Stage(scene graph).
+/// @param[in] callback Callback function to receive USDA text chunks.
+/// @param[in] userdata Userdata passed to the callback.
+/// @param[out] warn Warning message
+/// @param[out] err Error message
+/// @param[in] config Writer config.
+///
+/// @return true upon success.
+///
+bool SaveAsUSDAToCallback(const Stage &stage, USDAWriteCallback callback, void *userdata, std::string *warn, std::string *err, const USDAWriterConfig &config = USDAWriterConfig());
+
 } // namespace usda
 } // namespace tinyusdz
@@ -40,6 +40,7 @@
 #include "integerCoding.h"
 #include "lz4-compression.hh"
 #include "path-util.hh"
+#include "performance.hh"
 #include "pprinter.hh"
 #include "prim-reconstruct.hh"
 #include "str-util.hh"
@@ -232,6 +233,9 @@ class USDCReader::Impl {
 
   void set_reader_config(const USDCReaderConfig &config) {
     _config = config;
+    if (_prim_reservation.budget() != _config.memory_budget) {
+      _prim_reservation = MemoryReservation(_config.memory_budget);
+    }
 
 #if defined(__wasi__)
     _config.numThreads = 1;
@@ -362,6 +366,21 @@ class USDCReader::Impl {
   std::vector<std::pair<ListEditQual, std::vector<T>>> DecodeListOp(
       const ListOp<T> &);
 
+  // Test if the node is within `population_mask`.
+  bool IsNodeInPopulationMask(size_t node_id) const {
+    if (_config.population_mask.empty()) {
+      return true;
+    }
+
+    if (node_id >= _nodes.size()) {
+      // Let the caller report an error.
+      return true;
+    }
+
+    return pathutil::IsPathInPopulationMask(_nodes[node_id].GetPath(),
+                                            _config.population_mask);
+  }
+
   ///
   /// Builds std::map<std::string, Property> from the list of Path(Spec)
   /// indices.
@@ -398,6 +417,10 @@ class USDCReader::Impl {
 
   USDCReaderConfig _config;
 
+  // Memory reserved for reconstructed Prims. Moved to the Stage in
+  // `ReconstructStage`, otherwise released when the reader is destroyed.
+  MemoryReservation _prim_reservation;
+
   // Tracks the memory used(In advisorily manner since counting memory usage is
   // done by manually, so not all memory consumption could be tracked)
   size_t memory_used{0};  // in bytes.
@@ -809,6 +832,16 @@ USDCReader::Impl::DecodeListOp(const ListOp<T> &arg) {
 bool USDCReader::Impl::BuildPropertyMap(const std::vector<size_t> &pathIndices,
                                         const PathIndexToSpecIndexMap &psmap,
                                         prim::PropertyMap *props) {
+  // Reserve Prim memory before its Properties are stored, so that the budget
+  // stops the load before the Prim is reconstructed.
+  {
+    std::string budget_err;
+    if (!_prim_reservation.reserve(MemoryCategory::Prims, sizeof(Prim),
+                                   &budget_err)) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, budget_err);
+    }
+  }
+
   for (size_t i = 0; i < pathIndices.size(); i++) {
     int child_index = int(pathIndices[i]);
     if ((child_index < 0) || (child_index >= int(_nodes.size()))) {
@@ -883,7 +916,15 @@ bool USDCReader::Impl::BuildPropertyMap(const std::vector<size_t> &pathIndices,
                 prop_name));
       }
 
-      (*props)[prop_name] = prop;
+      {
+        std::string budget_err;
+        if (!ReservePropertyMemory(&_prim_reservation, prop_name, prop,
+                                   &budget_err)) {
+          PUSH_ERROR_AND_RETURN_TAG(kTag, budget_err);
+        }
+      }
+
+      (*props)[prop_name] = std::move(prop);
       DCOUT("Add property : " << prop_name);
     }
   }
@@ -2293,6 +2334,7 @@ bool USDCReader::Impl::ReconstructPrimNode(int parent, int current, int level,
                                            const PathIndexToSpecIndexMap &psmap,
                                            Stage *stage,
                                            nonstd::optional<Prim> *primOut) {
+  TINYUSDZ_TRACE_ZONE("USDCReader::ReconstructPrimNode");
   (void)level;
   const crate::CrateReader::Node &node = _nodes[size_t(current)];
 
@@ -2756,6 +2798,7 @@ bool USDCReader::Impl::ReconstructPrimSpecNode(int parent, int current, int leve
                                            const PathIndexToSpecIndexMap &psmap,
                                            Layer *layer,
                                            nonstd::optional<PrimSpec> *primOut) {
+  TINYUSDZ_TRACE_ZONE("USDCReader::ReconstructPrimSpecNode");
   (void)level;
   const crate::CrateReader::Node &node = _nodes[size_t(current)];
 
@@ -3296,6 +3339,10 @@ bool USDCReader::Impl::ReconstructPrimRecursively(
     for (size_t i = 0; i < node.GetChildren().size(); i++) {
       DCOUT("Reconstuct Prim children: " << i << " / "
                                          << node.GetChildren().size());
+      if (!IsNodeInPopulationMask(node.GetChildren()[i])) {
+        DCOUT("Skip node outside of population mask: " << node.GetChildren()[i]);
+        continue;
+      }
       if (!ReconstructPrimRecursively(current, int(node.GetChildren()[i]),
                                       currPrimPtr, level + 1, psmap, stage)) {
         return false;
@@ -3446,6 +3493,7 @@ bool USDCReader::Impl::ReconstructPrimRecursively(
 }
 
 bool USDCReader::Impl::ReconstructStage(Stage *stage) {
+  TINYUSDZ_TRACE_ZONE("USDCReader::ReconstructStage");
 
   // format test
   DCOUT(fmt::format("# of Paths = {}", crate_reader->NumPaths()));
@@ -3498,6 +3546,9 @@ bool USDCReader::Impl::ReconstructStage(Stage *stage) {
 
   stage->compute_absolute_prim_path_and_assign_prim_id();
 
+  stage->set_memory_reservation(
+      std::make_shared<MemoryReservation>(std::move(_prim_reservation)));
+
   return true;
 }
 
@@ -3543,6 +3594,10 @@ bool USDCReader::Impl::ReconstructPrimSpecRecursively(
     for (size_t i = 0; i < node.GetChildren().size(); i++) {
       DCOUT("Reconstuct Prim children: " << i << " / "
                                          << node.GetChildren().size());
+      if (!IsNodeInPopulationMask(node.GetChildren()[i])) {
+        DCOUT("Skip node outside of population mask: " << node.GetChildren()[i]);
+        continue;
+      }
       if (!ReconstructPrimSpecRecursively(current, int(node.GetChildren()[i]),
                                       currPrimSpecPtr, level + 1, psmap, layer)) {
         return false;
@@ -3693,6 +3748,7 @@ bool USDCReader::Impl::ReconstructPrimSpecRecursively(
 }
 
 bool USDCReader::Impl::ToLayer(Layer *layer) {
+  TINYUSDZ_TRACE_ZONE("USDCReader::ToLayer");
 
   if (!layer) {
     PUSH_ERROR_AND_RETURN("`layer` argument is nullptr.");
@@ -3753,6 +3809,7 @@ bool USDCReader::Impl::ToLayer(Layer *layer) {
 }
 
 bool USDCReader::Impl::ReadUSDC() {
+  TINYUSDZ_TRACE_ZONE("USDCReader::ReadUSDC");
   if (crate_reader) {
     delete crate_reader;
   }
@@ -3774,6 +3831,9 @@ bool USDCReader::Impl::ReadUSDC() {
     config.maxMemoryBudget = _config.kMaxAllowedMemoryInMB * 1024ull * 1024ull;
   }
 
+  config.memoryBudget = _config.memory_budget.get();
+  config.populationMask = _config.population_mask;
+
   crate_reader = new crate::CrateReader(_sr, config);
 
   _warn.clear();
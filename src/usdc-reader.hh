@@ -27,6 +27,14 @@ struct USDCReaderConfig {
   bool allow_unknown_apiSchemas = true;
 
   bool strict_allowedToken_check = false;
+
+  // Optional. Account Crate tables and reconstructed Prims to this budget and
+  // fail when the budget is exceeded.
+  std::shared_ptr<MemoryBudget> memory_budget;
+
+  // Optional. Population mask(list of absolute Prim paths). Prims outside of
+  // the mask are not reconstructed. Empty = load all Prims.
+  std::vector<Path> population_mask;
 };
 
 class USDCReader {
@@ -0,0 +1,821 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// USDZ(uncompressed, 64 bytes aligned ZIP) writer
+//
+// https://openusd.org/release/spec_usdz.html
+//
+
+#include "usdz-writer.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <set>
+
+#include "io-util.hh"
+#include "parallel-for.hh"
+
+namespace tinyusdz {
+namespace usdz {
+
+namespace {
+
+// Chunks smaller than this are not worth to compute CRC32 in parallel.
+constexpr size_t kCRC32ParallelChunkBytes = 256 * 1024;
+
+// USDZ requires file data to be aligned at 64 bytes boundary.
+constexpr uint64_t kDataAlignment = 64;
+
+constexpr size_t kLocalHeaderBytes = 30;
+constexpr size_t kCentralHeaderBytes = 46;
+constexpr size_t kEndOfCentralDirBytes = 22;
+
+// Header ID of the extra field used for padding. Same as pxr's usdzip.
+constexpr uint16_t kPaddingExtraFieldID = 0x1986;
+
+// ZIP64 is not supported.
+constexpr uint64_t kMaxZip32Bytes = 0xffffffffull;
+
+// 1980-01-01 00:00:00 in MS-DOS format. Use fixed timestamp so that the output
+// is deterministic.
+constexpr uint16_t kDosTime = 0;
+constexpr uint16_t kDosDate = (1 << 5) | 1;
+
+struct CRC32Table {
+  uint32_t t[8][256];
+
+  CRC32Table() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+      }
+      t[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int k = 1; k < 8; k++) {
+        t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+      }
+    }
+  }
+};
+
+const CRC32Table &GetCRC32Table() {
+  static CRC32Table table;
+  return table;
+}
+
+uint32_t GF2MatrixTimes(const uint32_t *mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec) {
+    if (vec & 1) {
+      sum ^= (*mat);
+    }
+    vec >>= 1;
+    mat++;
+  }
+  return sum;
+}
+
+void GF2MatrixSquare(uint32_t *square, const uint32_t *mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = GF2MatrixTimes(mat, mat[n]);
+  }
+}
+
+void PutU16(uint8_t *dst, uint16_t v) {
+  dst[0] = uint8_t(v & 0xff);
+  dst[1] = uint8_t((v >> 8) & 0xff);
+}
+
+void PutU32(uint8_t *dst, uint32_t v) {
+  dst[0] = uint8_t(v & 0xff);
+  dst[1] = uint8_t((v >> 8) & 0xff);
+  dst[2] = uint8_t((v >> 16) & 0xff);
+  dst[3] = uint8_t((v >> 24) & 0xff);
+}
+
+///
+/// Output of the writer.
+///
+class Sink {
+ public:
+  virtual ~Sink() {}
+
+  virtual bool write(const uint8_t *data, size_t nbytes, std::string *err) = 0;
+
+  ///
+  /// true when already written bytes can be overwritten with `patch`.
+  ///
+  virtual bool seekable() const { return false; }
+
+  ///
+  /// Overwrite `nbytes` at `offset`, then continue writing at `end`.
+  ///
+  virtual bool patch(uint64_t offset, const uint8_t *data, size_t nbytes,
+                     uint64_t end, std::string *err) {
+    (void)offset;
+    (void)data;
+    (void)nbytes;
+    (void)end;
+    if (err) {
+      (*err) += "Sink is not seekable.\n";
+    }
+    return false;
+  }
+};
+
+class CallbackSink : public Sink {
+ public:
+  CallbackSink(USDZWriteCallback callback, void *userdata)
+      : _callback(callback), _userdata(userdata) {}
+
+  bool write(const uint8_t *data, size_t nbytes, std::string *err) override {
+    if (nbytes == 0) {
+      return true;
+    }
+    return _callback(data, nbytes, _userdata, err);
+  }
+
+ private:
+  USDZWriteCallback _callback{nullptr};
+  void *_userdata{nullptr};
+};
+
+class StreamSink : public Sink {
+ public:
+  explicit StreamSink(std::ostream *os) : _os(os) {}
+
+  bool write(const uint8_t *data, size_t nbytes, std::string *err) override {
+    _os->write(reinterpret_cast<const char *>(data),
+               static_cast<std::streamsize>(nbytes));
+    if (!(*_os)) {
+      if (err) {
+        (*err) += "File write error.\n";
+      }
+      return false;
+    }
+    return true;
+  }
+
+  bool seekable() const override { return true; }
+
+  bool patch(uint64_t offset, const uint8_t *data, size_t nbytes, uint64_t end,
+             std::string *err) override {
+    _os->seekp(static_cast<std::streamoff>(offset));
+    _os->write(reinterpret_cast<const char *>(data),
+               static_cast<std::streamsize>(nbytes));
+    _os->seekp(static_cast<std::streamoff>(end));
+    if (!(*_os)) {
+      if (err) {
+        (*err) += "File seek/write error.\n";
+      }
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  std::ostream *_os{nullptr};
+};
+
+bool OpenInputFile(const std::string &filename, std::ifstream *ifs) {
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(_LIBCPP_VERSION))
+  ifs->open(io::UTF8ToWchar(filename).c_str(), std::ifstream::binary);
+#else
+  ifs->open(filename.c_str(), std::ifstream::binary);
+#endif
+  return bool(*ifs);
+}
+
+bool AppendToString(const char *data, size_t nbytes, void *userdata,
+                    std::string *err) {
+  (void)err;
+  std::string *dst = reinterpret_cast<std::string *>(userdata);
+  dst->append(data, nbytes);
+  return true;
+}
+
+///
+/// Writes ZIP local file headers and file data in order, then the central
+/// directory at `finish`. Only per-file records are kept in memory.
+///
+class USDZStreamWriter {
+ public:
+  USDZStreamWriter(Sink *sink, const USDZWriterConfig &config)
+      : _sink(sink), _config(config) {
+    _num_threads = parallel::GetNumThreads(config.num_threads);
+  }
+
+  bool add(const USDZEntry &entry, std::string *err) {
+    std::string name = entry.name;
+    if (name.empty()) {
+      name = io::GetBaseFilename(entry.filename);
+    }
+
+    if (entry.filename.size()) {
+      return add_file(name, entry.filename, err);
+    }
+
+    if (!entry.data && entry.size) {
+      if (err) {
+        (*err) += "`data` is nullptr for USDZ entry `" + name + "`.\n";
+      }
+      return false;
+    }
+    return add_memory(name, entry.data, entry.size, err);
+  }
+
+  bool add_memory(const std::string &name, const uint8_t *data, size_t nbytes,
+                  std::string *err) {
+    uint32_t crc = ComputeCRC32(data, nbytes, _num_threads);
+    if (!begin_entry(name, crc, nbytes, err)) {
+      return false;
+    }
+    return emit(data, nbytes, err);
+  }
+
+  bool add_file(const std::string &name, const std::string &filename,
+                std::string *err) {
+    std::ifstream ifs;
+    if (!OpenInputFile(filename, &ifs)) {
+      if (err) {
+        (*err) += "File open error : " + filename + "\n";
+      }
+      return false;
+    }
+
+    std::vector<uint8_t> buf((std::max)(_config.buffer_size, size_t(4096)));
+
+    if (_sink->seekable()) {
+      // Single pass. CRC32 and size are patched at `end_entry`.
+      if (!begin_entry(name, 0, 0, err)) {
+        return false;
+      }
+      for (;;) {
+        ifs.read(reinterpret_cast<char *>(buf.data()),
+                 static_cast<std::streamsize>(buf.size()));
+        size_t n = size_t(ifs.gcount());
+        if (n == 0) {
+          break;
+        }
+        if (!write_entry_data(buf.data(), n, err)) {
+          return false;
+        }
+      }
+      if (ifs.bad()) {
+        if (err) {
+          (*err) += "File read error : " + filename + "\n";
+        }
+        return false;
+      }
+      return end_entry(err);
+    }
+
+    // Pass 1: CRC32 and size.
+    uint32_t crc = 0;
+    uint64_t nbytes = 0;
+    for (;;) {
+      ifs.read(reinterpret_cast<char *>(buf.data()),
+               static_cast<std::streamsize>(buf.size()));
+      size_t n = size_t(ifs.gcount());
+      if (n == 0) {
+        break;
+      }
+      crc = CombineCRC32(crc, ComputeCRC32(buf.data(), n, _num_threads), n);
+      nbytes += n;
+    }
+    if (ifs.bad()) {
+      if (err) {
+        (*err) += "File read error : " + filename + "\n";
+      }
+      return false;
+    }
+
+    if (!begin_entry(name, crc, nbytes, err)) {
+      return false;
+    }
+
+    // Pass 2: copy.
+    ifs.clear();
+    ifs.seekg(0, std::ios::beg);
+    uint64_t copied = 0;
+    for (;;) {
+      ifs.read(reinterpret_cast<char *>(buf.data()),
+               static_cast<std::streamsize>(buf.size()));
+      size_t n = size_t(ifs.gcount());
+      if (n == 0) {
+        break;
+      }
+      if (!emit(buf.data(), n, err)) {
+        return false;
+      }
+      copied += n;
+    }
+
+    if (ifs.bad() || (copied != nbytes)) {
+      if (err) {
+        (*err) += "File read error or file was modified while writing USDZ : " +
+                  filename + "\n";
+      }
+      return false;
+    }
+
+    return true;
+  }
+
+  bool add_usda(const std::string &name, const Stage &stage, std::string *warn,
+                std::string *err) {
+    if (_sink->seekable()) {
+      if (!begin_entry(name, 0, 0, err)) {
+        return false;
+      }
+      if (!usda::SaveAsUSDAToCallback(stage, WriteEntryDataCallback,
+                                      reinterpret_cast<void *>(this), warn,
+                                      err, _config.usda_config)) {
+        return false;
+      }
+      return end_entry(err);
+    }
+
+    std::string s;
+    if (!usda::SaveAsUSDAToCallback(stage, AppendToString,
+                                    reinterpret_cast<void *>(&s), warn, err,
+                                    _config.usda_config)) {
+      return false;
+    }
+    return add_memory(name, reinterpret_cast<const uint8_t *>(s.data()),
+                      s.size(), err);
+  }
+
+  bool finish(std::string *err) {
+    const uint64_t cd_offset = _offset;
+
+    std::vector<uint8_t> header;
+    for (const Record &rec : _records) {
+      header.assign(kCentralHeaderBytes + rec.name.size(), 0);
+      uint8_t *p = header.data();
+      PutU32(p + 0, 0x02014b50);
+      PutU16(p + 4, 20);  // version made by(MS-DOS, 2.0)
+      PutU16(p + 6, 10);  // version needed to extract(1.0, stored)
+      PutU16(p + 8, 0);   // flags
+      PutU16(p + 10, 0);  // compression method(stored)
+      PutU16(p + 12, kDosTime);
+      PutU16(p + 14, kDosDate);
+      PutU32(p + 16, rec.crc);
+      PutU32(p + 20, uint32_t(rec.size));
+      PutU32(p + 24, uint32_t(rec.size));
+      PutU16(p + 28, uint16_t(rec.name.size()));
+      // extra field, comment, disk number, internal/external attributes = 0
+      PutU32(p + 42, uint32_t(rec.header_offset));
+      memcpy(p + kCentralHeaderBytes, rec.name.data(), rec.name.size());
+
+      if (!emit(header.data(), header.size(), err)) {
+        return false;
+      }
+    }
+
+    const uint64_t cd_size = _offset - cd_offset;
+    if ((_offset + kEndOfCentralDirBytes) > kMaxZip32Bytes) {
+      if (err) {
+        (*err) += "USDZ exceeds 4GB. ZIP64 is not supported.\n";
+      }
+      return false;
+    }
+
+    uint8_t eocd[kEndOfCentralDirBytes] = {};
+    PutU32(eocd + 0, 0x06054b50);
+    PutU16(eocd + 8, uint16_t(_records.size()));
+    PutU16(eocd + 10, uint16_t(_records.size()));
+    PutU32(eocd + 12, uint32_t(cd_size));
+    PutU32(eocd + 16, uint32_t(cd_offset));
+
+    return emit(eocd, kEndOfCentralDirBytes, err);
+  }
+
+ private:
+  struct Record {
+    std::string name;
+    uint32_t crc{0};
+    uint64_t size{0};
+    uint64_t header_offset{0};
+  };
+
+  static bool WriteEntryDataCallback(const char *data, size_t nbytes,
+                                     void *userdata, std::string *err) {
+    USDZStreamWriter *self = reinterpret_cast<USDZStreamWriter *>(userdata);
+    return self->write_entry_data(reinterpret_cast<const uint8_t *>(data),
+                                  nbytes, err);
+  }
+
+  bool emit(const uint8_t *data, size_t nbytes, std::string *err) {
+    if (!_sink->write(data, nbytes, err)) {
+      return false;
+    }
+    _offset += nbytes;
+    return true;
+  }
+
+  ///
+  /// Write local file header. `crc` and `nbytes` are ignored for streamed
+  /// entry(finalized at `end_entry`).
+  ///
+  bool begin_entry(const std::string &name, uint32_t crc, uint64_t nbytes,
+                   std::string *err) {
+    if (name.empty()) {
+      if (err) {
+        (*err) += "Empty file name in USDZ.\n";
+      }
+      return false;
+    }
+
+    if (name.size() > 0xffff) {
+      if (err) {
+        (*err) += "File name too long : " + name + "\n";
+      }
+      return false;
+    }
+
+    if (_names.count(name)) {
+      if (err) {
+        (*err) += "Duplicated file name in USDZ : " + name + "\n";
+      }
+      return false;
+    }
+
+    if (_records.size() >= 0xffff) {
+      if (err) {
+        (*err) += "Too many files in USDZ. ZIP64 is not supported.\n";
+      }
+      return false;
+    }
+
+    if ((nbytes > kMaxZip32Bytes) || (_offset > kMaxZip32Bytes)) {
+      if (err) {
+        (*err) += "USDZ exceeds 4GB. ZIP64 is not supported.\n";
+      }
+      return false;
+    }
+
+    // Pad with an extra field so that file data starts at 64 bytes boundary.
+    // Extra field requires 4 bytes at least(header ID + size).
+    uint64_t data_offset = _offset + kLocalHeaderBytes + name.size();
+    size_t padding =
+        size_t((kDataAlignment - (data_offset % kDataAlignment)) % kDataAlignment);
+    if ((padding > 0) && (padding < 4)) {
+      padding += size_t(kDataAlignment);
+    }
+
+    std::vector<uint8_t> header(kLocalHeaderBytes + name.size() + padding, 0);
+    uint8_t *p = header.data();
+    PutU32(p + 0, 0x04034b50);
+    PutU16(p + 4, 10);  // version needed to extract(1.0, stored)
+    PutU16(p + 6, 0);   // flags
+    PutU16(p + 8, 0);   // compression method(stored)
+    PutU16(p + 10, kDosTime);
+    PutU16(p + 12, kDosDate);
+    PutU32(p + 14, crc);
+    PutU32(p + 18, uint32_t(nbytes));
+    PutU32(p + 22, uint32_t(nbytes));
+    PutU16(p + 26, uint16_t(name.size()));
+    PutU16(p + 28, uint16_t(padding));
+    memcpy(p + kLocalHeaderBytes, name.data(), name.size());
+    if (padding) {
+      uint8_t *extra = p + kLocalHeaderBytes + name.size();
+      PutU16(extra + 0, kPaddingExtraFieldID);
+      PutU16(extra + 2, uint16_t(padding - 4));
+    }
+
+    Record rec;
+    rec.name = name;
+    rec.crc = crc;
+    rec.size = nbytes;
+    rec.header_offset = _offset;
+
+    if (!emit(header.data(), header.size(), err)) {
+      return false;
+    }
+
+    _names.insert(name);
+    _records.push_back(rec);
+    _entry_crc = 0;
+    _entry_size = 0;
+
+    return true;
+  }
+
+  bool write_entry_data(const uint8_t *data, size_t nbytes, std::string *err) {
+    _entry_crc = CombineCRC32(_entry_crc, ComputeCRC32(data, nbytes, _num_threads),
+                              nbytes);
+    _entry_size += nbytes;
+    if (_entry_size > kMaxZip32Bytes) {
+      if (err) {
+        (*err) += "File in USDZ exceeds 4GB. ZIP64 is not supported.\n";
+      }
+      return false;
+    }
+    return emit(data, nbytes, err);
+  }
+
+  ///
+  /// Finalize streamed entry: patch CRC32 and sizes in the local file header.
+  ///
+  bool end_entry(std::string *err) {
+    Record &rec = _records.back();
+    rec.crc = _entry_crc;
+    rec.size = _entry_size;
+
+    uint8_t buf[12];
+    PutU32(buf + 0, rec.crc);
+    PutU32(buf + 4, uint32_t(rec.size));
+    PutU32(buf + 8, uint32_t(rec.size));
+
+    return _sink->patch(rec.header_offset + 14, buf, sizeof(buf), _offset,
+                        err);
+  }
+
+  Sink *_sink{nullptr};
+  const USDZWriterConfig &_config;
+  int _num_threads{1};
+
+  uint64_t _offset{0};
+  std::vector<Record> _records;
+  std::set<std::string> _names;
+
+  // CRC32 and size of the streamed entry.
+  uint32_t _entry_crc{0};
+  uint64_t _entry_size{0};
+};
+
+bool IsUSDFilename(const std::string &name) {
+  std::string ext = io::GetFileExtension(name);
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+                 [](unsigned char c) { return char(std::tolower(c)); });
+  return (ext == "usda") || (ext == "usdc") || (ext == "usd");
+}
+
+std::string RootLayerName(const std::string &usdz_filename,
+                          const USDZWriterConfig &config) {
+  if (config.root_layer_name.size()) {
+    return config.root_layer_name;
+  }
+
+  std::string basename = io::GetBaseFilename(usdz_filename);
+  if (basename.empty()) {
+    return "root.usda";
+  }
+  size_t idx = basename.find_last_of('.');
+  if ((idx != std::string::npos) && (idx > 0)) {
+    basename = basename.substr(0, idx);
+  }
+  return basename + ".usda";
+}
+
+bool WriteStageAndAssets(Sink *sink, const std::string &root_layer_name,
+                         const Stage &stage,
+                         const std::vector<USDZEntry> &assets,
+                         std::string *warn, std::string *err,
+                         const USDZWriterConfig &config) {
+  USDZStreamWriter writer(sink, config);
+
+  if (!writer.add_usda(root_layer_name, stage, warn, err)) {
+    return false;
+  }
+
+  for (const auto &asset : assets) {
+    if (!writer.add(asset, err)) {
+      return false;
+    }
+  }
+
+  return writer.finish(err);
+}
+
+bool WriteEntries(Sink *sink, const std::vector<USDZEntry> &entries,
+                  std::string *err, const USDZWriterConfig &config) {
+  if (entries.empty()) {
+    if (err) {
+      (*err) += "No entries to write USDZ.\n";
+    }
+    return false;
+  }
+
+  const USDZEntry &root = entries[0];
+  if (!IsUSDFilename(root.name.size() ? root.name : root.filename)) {
+    if (err) {
+      (*err) += "The first entry of USDZ must be USD(.usda, .usdc or .usd) "
+                "file.\n";
+    }
+    return false;
+  }
+
+  USDZStreamWriter writer(sink, config);
+
+  for (const auto &entry : entries) {
+    if (!writer.add(entry, err)) {
+      return false;
+    }
+  }
+
+  return writer.finish(err);
+}
+
+bool OpenOutputFile(const std::string &filename, std::ofstream *ofs,
+                    std::string *err) {
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(_LIBCPP_VERSION))
+  ofs->open(io::UTF8ToWchar(filename).c_str(), std::ofstream::binary);
+#else
+  ofs->open(filename.c_str(), std::ofstream::binary);
+#endif
+  if (!(*ofs)) {
+    if (err) {
+      (*err) += "File open error for writing : " + filename + "\n";
+    }
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint32_t UpdateCRC32(uint32_t crc, const uint8_t *data, size_t nbytes) {
+  const CRC32Table &table = GetCRC32Table();
+  const uint32_t(*t)[256] = table.t;
+
+  uint32_t c = ~crc;
+
+  // Slicing-by-8
+  while (nbytes >= 8) {
+    uint32_t lo = c ^ (uint32_t(data[0]) | (uint32_t(data[1]) << 8) |
+                       (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24));
+    uint32_t hi = uint32_t(data[4]) | (uint32_t(data[5]) << 8) |
+                  (uint32_t(data[6]) << 16) | (uint32_t(data[7]) << 24);
+    c = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^
+        t[4][lo >> 24] ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^
+        t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+    data += 8;
+    nbytes -= 8;
+  }
+
+  while (nbytes) {
+    c = t[0][(c ^ (*data)) & 0xff] ^ (c >> 8);
+    data++;
+    nbytes--;
+  }
+
+  return ~c;
+}
+
+uint32_t CombineCRC32(uint32_t crc1, uint32_t crc2, uint64_t len2) {
+  // Based on zlib's crc32_combine.
+  if (len2 == 0) {
+    return crc1;
+  }
+
+  uint32_t even[32];  // even-power-of-two zeros operator
+  uint32_t odd[32];   // odd-power-of-two zeros operator
+
+  // operator for one zero bit in odd
+  odd[0] = 0xedb88320u;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+
+  GF2MatrixSquare(even, odd);  // two zero bits
+  GF2MatrixSquare(odd, even);  // four zero bits
+
+  // apply len2 zeros to crc1(first square will put the operator for one zero
+  // byte, eight zero bits, in even)
+  do {
+    GF2MatrixSquare(even, odd);
+    if (len2 & 1) {
+      crc1 = GF2MatrixTimes(even, crc1);
+    }
+    len2 >>= 1;
+
+    if (len2 == 0) {
+      break;
+    }
+
+    GF2MatrixSquare(odd, even);
+    if (len2 & 1) {
+      crc1 = GF2MatrixTimes(odd, crc1);
+    }
+    len2 >>= 1;
+  } while (len2 != 0);
+
+  return crc1 ^ crc2;
+}
+
+uint32_t ComputeCRC32(const uint8_t *data, size_t nbytes, int num_threads) {
+  const int nthreads = parallel::GetNumThreads(num_threads);
+
+  if ((nthreads <= 1) || (nbytes < 2 * kCRC32ParallelChunkBytes)) {
+    return UpdateCRC32(0, data, nbytes);
+  }
+
+  const size_t chunk_bytes = (std::max)(
+      kCRC32ParallelChunkBytes, (nbytes + size_t(nthreads) - 1) / size_t(nthreads));
+  const size_t num_chunks = (nbytes + chunk_bytes - 1) / chunk_bytes;
+
+  std::vector<uint32_t> crcs(num_chunks);
+  parallel::ParallelFor(
+      num_chunks,
+      [&](size_t i, int thread_id) {
+        (void)thread_id;
+        size_t begin = i * chunk_bytes;
+        size_t n = (std::min)(chunk_bytes, nbytes - begin);
+        crcs[i] = UpdateCRC32(0, data + begin, n);
+      },
+      nthreads);
+
+  uint32_t crc = crcs[0];
+  for (size_t i = 1; i < num_chunks; i++) {
+    size_t n = (std::min)(chunk_bytes, nbytes - i * chunk_bytes);
+    crc = CombineCRC32(crc, crcs[i], n);
+  }
+
+  return crc;
+}
+
+bool SaveAsUSDZ(const std::string &filename, const Stage &stage,
+                const std::vector<USDZEntry> &assets, std::string *warn,
+                std::string *err, const USDZWriterConfig &config) {
+  std::ofstream ofs;
+  if (!OpenOutputFile(filename, &ofs, err)) {
+    return false;
+  }
+
+  StreamSink sink(&ofs);
+  if (!WriteStageAndAssets(&sink, RootLayerName(filename, config), stage,
+                           assets, warn, err, config)) {
+    if (err) {
+      (*err) += "Failed to write USDZ : " + filename + "\n";
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool SaveAsUSDZToCallback(const Stage &stage,
+                          const std::vector<USDZEntry> &assets,
+                          USDZWriteCallback callback, void *userdata,
+                          std::string *warn, std::string *err,
+                          const USDZWriterConfig &config) {
+  if (!callback) {
+    if (err) {
+      (*err) += "`callback` is nullptr.\n";
+    }
+    return false;
+  }
+
+  CallbackSink sink(callback, userdata);
+  return WriteStageAndAssets(&sink, RootLayerName("", config), stage, assets,
+                             warn, err, config);
+}
+
+bool PackUSDZ(const std::string &filename,
+              const std::vector<USDZEntry> &entries, std::string *warn,
+              std::string *err, const USDZWriterConfig &config) {
+  (void)warn;
+
+  std::ofstream ofs;
+  if (!OpenOutputFile(filename, &ofs, err)) {
+    return false;
+  }
+
+  StreamSink sink(&ofs);
+  if (!WriteEntries(&sink, entries, err, config)) {
+    if (err) {
+      (*err) += "Failed to write USDZ : " + filename + "\n";
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool PackUSDZToCallback(const std::vector<USDZEntry> &entries,
+                        USDZWriteCallback callback, void *userdata,
+                        std::string *warn, std::string *err,
+                        const USDZWriterConfig &config) {
+  (void)warn;
+
+  if (!callback) {
+    if (err) {
+      (*err) += "`callback` is nullptr.\n";
+    }
+    return false;
+  }
+
+  CallbackSink sink(callback, userdata);
+  return WriteEntries(&sink, entries, err, config);
+}
+
+}  // namespace usdz
+}  // namespace tinyusdz
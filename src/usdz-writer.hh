@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// USDZ(uncompressed, 64 bytes aligned ZIP) writer
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tinyusdz.hh"
+#include "usda-writer.hh"
+
+namespace tinyusdz {
+namespace usdz {
+
+///
+/// Config for the (streaming) USDZ writer.
+///
+struct USDZWriterConfig {
+  ///
+  /// Size of the chunk in bytes used to stream asset files into the archive.
+  ///
+  size_t buffer_size = 4 * 1024 * 1024;
+
+  ///
+  /// # of threads to compute CRC32. -1 = use all hardware threads.
+  ///
+  int num_threads = -1;
+
+  ///
+  /// Name of the root layer in the archive. Empty = "<stem of USDZ
+  /// filename>.usda"("root.usda" for callback API). Only used when the root
+  /// layer is serialized from Stage.
+  ///
+  std::string root_layer_name;
+
+  ///
+  /// Config to serialize the root layer from Stage.
+  ///
+  usda::USDAWriterConfig usda_config;
+};
+
+///
+/// File(asset) to be stored in USDZ.
+///
+/// Content is read from `filename`(streamed in `buffer_size` chunks) when
+/// `filename` is not empty, otherwise `data` and `size` are used(`data` must be
+/// valid until the writer returns).
+///
+struct USDZEntry {
+  std::string name;  // Path in the archive(e.g. "textures/albedo.png")
+  std::string filename;
+  const uint8_t *data{nullptr};
+  size_t size{0};
+};
+
+///
+/// Callback to receive USDZ(ZIP) bytes.
+/// Invoked sequentially(in output order) from the thread calling the writer.
+///
+/// @param[in] data Pointer to the chunk of USDZ data.
+/// @param[in] nbytes Chunk size in bytes.
+/// @param[in] userdata Userdata passed to the writer.
+/// @param[out] err Error message.
+///
+/// @return false to abort writing.
+///
+typedef bool (*USDZWriteCallback)(const uint8_t *data, size_t nbytes,
+                                  void *userdata, std::string *err);
+
+///
+/// Save Stage as USDZ. The root layer is serialized as USDA and stored as the
+/// first file in the archive, followed by `assets`.
+///
+/// @param[in] filename USDZ filename(UTF-8).
+/// @param[in] stage Stage(scene graph).
+/// @param[in] assets Assets(e.g. textures) referenced from the Stage.
+/// @param[out] warn Warning message
+/// @param[out] err Error message
+/// @param[in] config Writer config.
+///
+/// @return true upon success.
+///
+/// Root layer text and asset files are streamed into the file, and the local
+/// file header is patched after each file has been written, so neither the
+/// root layer nor the whole archive is built in memory.
+///
+bool SaveAsUSDZ(const std::string &filename, const Stage &stage,
+                const std::vector<USDZEntry> &assets, std::string *warn,
+                std::string *err,
+                const USDZWriterConfig &config = USDZWriterConfig());
+
+///
+/// Save Stage as USDZ through user-supplied callback.
+///
+/// Since the callback cannot seek, CRC32 and size must be known before the
+/// local file header is emitted: the root layer(USDA text) is serialized into
+/// memory, and asset files are read twice(CRC32 pass and copy pass).
+///
+bool SaveAsUSDZToCallback(const Stage &stage,
+                          const std::vector<USDZEntry> &assets,
+                          USDZWriteCallback callback, void *userdata,
+                          std::string *warn, std::string *err,
+                          const USDZWriterConfig &config = USDZWriterConfig());
+
+///
+/// Package existing files as USDZ. The first entry is the root layer and must
+/// be a USD file(.usda, .usdc or .usd).
+///
+bool PackUSDZ(const std::string &filename,
+              const std::vector<USDZEntry> &entries, std::string *warn,
+              std::string *err,
+              const USDZWriterConfig &config = USDZWriterConfig());
+
+bool PackUSDZToCallback(const std::vector<USDZEntry> &entries,
+                        USDZWriteCallback callback, void *userdata,
+                        std::string *warn, std::string *err,
+                        const USDZWriterConfig &config = USDZWriterConfig());
+
+///
+/// Update CRC32(ZIP, polynomial 0xEDB88320) with `nbytes` of `data`.
+/// Start with `crc` = 0.
+///
+uint32_t UpdateCRC32(uint32_t crc, const uint8_t *data, size_t nbytes);
+
+///
+/// Combine CRC32 of two consecutive blocks.
+///
+/// @param[in] crc1 CRC32 of the first block.
+/// @param[in] crc2 CRC32 of the second block.
+/// @param[in] len2 Length of the second block in bytes.
+///
+/// @return CRC32 of the concatenated block.
+///
+uint32_t CombineCRC32(uint32_t crc1, uint32_t crc2, uint64_t len2);
+
+///
+/// Compute CRC32 of `data`. Large data is split into chunks and chunk CRCs are
+/// computed in parallel, then combined with `CombineCRC32`.
+///
+/// @param[in] num_threads # of threads. -1 = use all hardware threads.
+///
+uint32_t ComputeCRC32(const uint8_t *data, size_t nbytes,
+                      int num_threads = -1);
+
+}  // namespace usdz
+}  // namespace tinyusdz
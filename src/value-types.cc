@@ -799,13 +799,7 @@ matrix4d &matrix4d::operator=(const matrix4f &src) {
 }
 
 
-size_t Value::array_size() const {
-  if (!is_array()) {
-    return 0;
-  }
-
-  // primvar types only.
-
+// primvar types only.
 #define APPLY_FUNC_TO_TYPES(__FUNC) \
   __FUNC(bool)                 \
   __FUNC(value::token)                 \
@@ -861,6 +855,12 @@ size_t Value::array_size() const {
   __FUNC(matrix4d) \
   __FUNC(frame4d)
 
+size_t Value::array_size() const {
+  if (!is_array()) {
+    return 0;
+  }
+
+
 #define ARRAY_SIZE_GET(__ty) case value::TypeTraits<__ty>::type_id() | value::TYPE_ID_1D_ARRAY_BIT: { \
     if (auto pv = v_.cast<std::vector<__ty>>()) { \
       return pv->size(); \
@@ -876,10 +876,34 @@ size_t Value::array_size() const {
   }
 
 #undef ARRAY_SIZE_GET
-#undef APPLY_FUNC_TO_TYPES
 
 }
 
+size_t Value::estimate_memory_usage() const {
+  if (!is_array()) {
+    // TODO: Account heap memory of non-primvar types(e.g. `std::string`, `Reference`)
+    return sizeof(Value);
+  }
+
+#define ARRAY_MEMORY_USAGE_GET(__ty) case value::TypeTraits<__ty>::type_id() | value::TYPE_ID_1D_ARRAY_BIT: { \
+    if (auto pv = v_.cast<std::vector<__ty>>()) { \
+      return sizeof(Value) + sizeof(std::vector<__ty>) + pv->capacity() * sizeof(__ty); \
+    } \
+    return sizeof(Value); \
+  }
+
+  switch (v_.type_id()) {
+    APPLY_FUNC_TO_TYPES(ARRAY_MEMORY_USAGE_GET)
+    default:
+      return sizeof(Value);
+  }
+
+#undef ARRAY_MEMORY_USAGE_GET
+
+}
+
+#undef APPLY_FUNC_TO_TYPES
+
 bool RoleTypeCast(const uint32_t roleTyId, value::Value &inout) {
   const uint32_t srcUnderlyingTyId = inout.underlying_type_id();
 
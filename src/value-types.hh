@@ -2129,6 +2129,10 @@ class Value {
   // ...)
   size_t array_size() const;
 
+  // Approximated memory usage in [bytes](including heap memory of primvar
+  // array types).
+  size_t estimate_memory_usage() const;
+
   bool is_empty() const { return v_.type_id() == value::TYPE_ID_NULL; }
 
  private:
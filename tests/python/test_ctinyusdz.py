@@ -0,0 +1,124 @@
+#
+# Smoke test for the native module `ctinyusdz`(RenderScene, PrimVar array views).
+# Skipped when `ctinyusdz` is not built.
+#
+import os
+import threading
+
+import pytest
+
+np = pytest.importorskip("numpy")
+ctinyusdz = pytest.importorskip("ctinyusdz")
+
+_MODELS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "models")
+
+
+def _model(name):
+    return os.path.join(_MODELS_DIR, name)
+
+
+def test_load_usd():
+    filename = _model("cube-previewsurface.usda")
+    assert ctinyusdz.is_usd(filename)
+    assert ctinyusdz.format(filename) == "usda"
+
+    stage = ctinyusdz.load_usd(filename)
+    assert stage is not None
+
+    with pytest.raises(FileNotFoundError):
+        ctinyusdz.load_usd(_model("not-exist.usda"))
+
+
+def test_render_scene_mesh_views():
+    filename = _model("cube-previewsurface.usda")
+    stage = ctinyusdz.load_usd(filename)
+
+    scene = ctinyusdz.tydra.to_render_scene(stage, usd_filename=filename)
+    assert len(scene.meshes) > 0
+
+    mesh = scene.meshes[0]
+    points = mesh.points
+    assert points.dtype == np.float32
+    assert points.ndim == 2 and points.shape[1] == 3
+    assert points.shape[0] > 0
+
+    # Zero-copy: the view does not own its memory and refers to the mesh.
+    assert not points.flags.owndata
+    assert points.base is not None
+
+    counts = mesh.face_vertex_counts
+    indices = mesh.face_vertex_indices
+    assert int(counts.sum()) == indices.shape[0]
+    assert int(indices.max()) < points.shape[0]
+
+    # The view keeps RenderScene alive.
+    expected = points.copy()
+    del mesh, scene
+    assert np.array_equal(points, expected)
+
+
+def test_render_scene_texture_buffers():
+    filename = _model("texture-cat-plane.usda")
+    stage = ctinyusdz.load_usd(filename)
+
+    config = ctinyusdz.tydra.RenderSceneConverterConfig()
+    config.load_texture_assets = True
+    scene = ctinyusdz.tydra.to_render_scene(stage, config, filename)
+
+    assert len(scene.images) == 1
+    image = scene.images[0]
+    assert image.width > 0 and image.height > 0
+
+    buf = scene.buffers[image.buffer_id]
+    data = buf.data
+    assert not data.flags.owndata
+    assert data.size * data.itemsize >= image.width * image.height * image.channels
+
+
+def test_load_usd_in_threads():
+    # GIL is released while loading and converting.
+    filename = _model("cube-previewsurface.usda")
+    results = []
+
+    def work():
+        stage = ctinyusdz.load_usd(filename)
+        scene = ctinyusdz.tydra.to_render_scene(stage)
+        results.append(len(scene.meshes))
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    assert len(results) == 4
+    assert all(n == results[0] and n > 0 for n in results)
+
+
+def test_primvar_get_array_empty():
+    p = ctinyusdz.PrimVar()
+    assert p.get_array() is None
+
+
+def test_primvar_get_array_points():
+    stage = ctinyusdz.load_usd(_model("cube-previewsurface.usda"))
+    prim = stage.GetPrimAtPath("/Cube/Cube")
+    assert prim is not None
+
+    pv = prim.get_attribute("points")
+    assert pv is not None
+    points = pv.get_array()
+    assert points is not None
+
+    # Zero-copy: `base` keeps the PrimVar alive.
+    assert not points.flags.owndata
+    assert points.base is not None
+
+    del pv, prim, stage
+
+    assert points.dtype == np.float32
+    assert points.shape == (8, 3)
+    expected = np.array([(1, 1, 1), (1, 1, -1), (1, -1, 1), (1, -1, -1),
+                         (-1, 1, 1), (-1, 1, -1), (-1, -1, 1), (-1, -1, -1)],
+                        dtype=np.float32)
+    assert np.array_equal(points, expected)
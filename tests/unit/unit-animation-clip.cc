@@ -0,0 +1,185 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cmath>
+#include <vector>
+
+#include "unit-animation-clip.h"
+#include "tydra/animation-clip.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+bool Near(const vec3 &a, const vec3 &b, float eps = 1e-4f) {
+  return (std::fabs(a[0] - b[0]) < eps) && (std::fabs(a[1] - b[1]) < eps) &&
+         (std::fabs(a[2] - b[2]) < eps);
+}
+
+bool Near(const quat &a, const quat &b, float eps = 1e-4f) {
+  float d = std::fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+  return d > (1.0f - eps);
+}
+
+// joint "a": linear translation, rotation(90 degree around Z) and static scale.
+// joint "b": held(step) translation.
+RenderScene MakeScene() {
+  RenderScene scene;
+  scene.meta.framesPerSecond = 24.0;
+  scene.meta.timeCodesPerSecond = 24.0;
+
+  Animation anim;
+  anim.abs_path = "/anim";
+
+  AnimationChannel t(AnimationChannel::ChannelType::Translation);
+  t.translations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f}});
+  t.translations.samples.push_back({10.0f, {10.0f, 0.0f, 0.0f}});
+  anim.channels_map["a"][AnimationChannel::ChannelType::Translation] = t;
+
+  const float s = std::sqrt(0.5f);
+  AnimationChannel r(AnimationChannel::ChannelType::Rotation);
+  r.rotations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f, 1.0f}});
+  r.rotations.samples.push_back({10.0f, {0.0f, 0.0f, s, s}});
+  anim.channels_map["a"][AnimationChannel::ChannelType::Rotation] = r;
+
+  AnimationChannel sc(AnimationChannel::ChannelType::Scale);
+  sc.scales.static_value = vec3{1.0f, 2.0f, 1.0f};
+  anim.channels_map["a"][AnimationChannel::ChannelType::Scale] = sc;
+
+  AnimationChannel tb(AnimationChannel::ChannelType::Translation);
+  tb.translations.interpolation = AnimationSampler<vec3>::Interpolation::Step;
+  tb.translations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f}});
+  tb.translations.samples.push_back({5.0f, {0.0f, 1.0f, 0.0f}});
+  anim.channels_map["b"][AnimationChannel::ChannelType::Translation] = tb;
+
+  scene.animations.push_back(anim);
+  return scene;
+}
+
+void animation_sampler_test() {
+  RenderScene scene = MakeScene();
+  const auto &a = scene.animations[0].channels_map.at("a");
+  const auto &b = scene.animations[0].channels_map.at("b");
+
+  vec3 v;
+  TEST_CHECK(EvaluateAnimationSampler(a.at(AnimationChannel::ChannelType::Translation).translations, 2.5, &v));
+  TEST_CHECK(Near(v, {2.5f, 0.0f, 0.0f}));
+  TEST_CHECK(EvaluateAnimationSampler(a.at(AnimationChannel::ChannelType::Translation).translations, 20.0, &v));
+  TEST_CHECK(Near(v, {10.0f, 0.0f, 0.0f}));
+
+  TEST_CHECK(EvaluateAnimationSampler(b.at(AnimationChannel::ChannelType::Translation).translations, 4.9, &v));
+  TEST_CHECK(Near(v, {0.0f, 0.0f, 0.0f}));
+
+  quat q;
+  TEST_CHECK(EvaluateAnimationSampler(a.at(AnimationChannel::ChannelType::Rotation).rotations, 5.0, &q));
+  const float h = float(std::sin(3.141592653589793 / 8.0));
+  TEST_CHECK(Near(q, {0.0f, 0.0f, h, std::sqrt(1.0f - h * h)}));
+
+  AnimationSampler<float> empty;
+  float f;
+  TEST_CHECK(!EvaluateAnimationSampler(empty, 0.0, &f));
+}
+
+void animation_clip_bake_test() {
+  RenderScene scene = MakeScene();
+
+  std::string err;
+  AnimationClip dense;
+  AnimationClipBakeConfig config;
+  config.reduce_keyframes = false;
+  TEST_CHECK(BakeAnimationClip(scene, 0, &dense, &err, config));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(dense.num_frames == 11);
+  TEST_CHECK(dense.targets.size() == 2);
+  TEST_CHECK(dense.translation_tracks[0].count == 11);
+  TEST_CHECK(dense.scale_tracks[1].count == 0);
+
+  AnimationClip clip;
+  TEST_CHECK(BakeAnimationClip(scene, 0, &clip, &err));
+  TEST_CHECK(clip.num_frames == 11);
+  // Linear tracks are reduced to the end keys.
+  TEST_CHECK(clip.translation_tracks[0].count == 2);
+  TEST_CHECK(clip.rotation_tracks[0].count == 2);
+  TEST_CHECK(clip.scale_tracks[0].count == 1);
+  TEST_CHECK(clip.memory_usage() < dense.memory_usage());
+
+  // Reduced clip reproduces the dense clip at frames.
+  AnimationClipPose pose;
+  AnimationClipPose dense_pose;
+  for (uint32_t fr = 0; fr < dense.num_frames; fr++) {
+    SampleAnimationClip(clip, double(fr), &pose);
+    SampleAnimationClip(dense, double(fr), &dense_pose);
+    TEST_CHECK(Near(pose.translations[0], dense_pose.translations[0]));
+    TEST_CHECK(Near(pose.rotations[0], dense_pose.rotations[0]));
+    TEST_CHECK(Near(pose.translations[1], dense_pose.translations[1]));
+  }
+
+  SampleAnimationClip(clip, 2.5, &pose);
+  TEST_CHECK(pose.channels[0] == (AnimationClipPose::kTranslation | AnimationClipPose::kRotation | AnimationClipPose::kScale));
+  TEST_CHECK(pose.channels[1] == AnimationClipPose::kTranslation);
+  TEST_CHECK(Near(pose.translations[0], {2.5f, 0.0f, 0.0f}));
+  TEST_CHECK(Near(pose.scales[0], {1.0f, 2.0f, 1.0f}));
+  TEST_CHECK(Near(pose.scales[1], {1.0f, 1.0f, 1.0f}));
+
+  // Frame rate
+  config = AnimationClipBakeConfig();
+  config.frames_per_second = 48.0;
+  TEST_CHECK(BakeAnimationClip(scene, 0, &clip, &err, config));
+  TEST_CHECK(clip.num_frames == 21);
+  TEST_CHECK(std::fabs(clip.time_codes_per_frame - 0.5) < 1e-9);
+
+  // Quantization
+  config = AnimationClipBakeConfig();
+  config.quantize = true;
+  TEST_CHECK(BakeAnimationClip(scene, 0, &clip, &err, config));
+  TEST_CHECK(clip.quantized);
+  TEST_CHECK(clip.translations.empty());
+  TEST_CHECK(clip.quantized_rotations.size() == 4 * clip.rotation_frames.size());
+  SampleAnimationClip(clip, 7.0, &pose);
+  SampleAnimationClip(dense, 7.0, &dense_pose);
+  TEST_CHECK(Near(pose.translations[0], dense_pose.translations[0], 1e-3f));
+  TEST_CHECK(Near(pose.rotations[0], dense_pose.rotations[0], 1e-3f));
+  TEST_CHECK(Near(pose.scales[0], dense_pose.scales[0], 1e-3f));
+
+  TEST_CHECK(!BakeAnimationClip(scene, 1, &clip, &err));
+}
+
+void animation_clip_node_test() {
+  RenderScene scene;
+
+  Node root;
+  root.abs_path = "/root";
+  Node child;
+  child.abs_path = "/root/child";
+  AnimationChannel t(AnimationChannel::ChannelType::Translation);
+  t.translations.samples.push_back({1.0f, {0.0f, 0.0f, 0.0f}});
+  t.translations.samples.push_back({3.0f, {0.0f, 0.0f, 4.0f}});
+  child.node_animations.push_back(t);
+  root.children.push_back(child);
+  scene.nodes.push_back(root);
+
+  std::string err;
+  AnimationClip clip;
+  TEST_CHECK(BakeNodeAnimationClip(scene, &clip, &err));
+  TEST_CHECK(clip.targets.size() == 1);
+  TEST_CHECK(clip.targets[0] == "/root/child");
+  TEST_CHECK(clip.num_frames == 3);
+  TEST_CHECK(std::fabs(clip.start_time - 1.0) < 1e-9);
+
+  AnimationClipPose pose;
+  SampleAnimationClip(clip, 2.5, &pose);
+  TEST_CHECK(Near(pose.translations[0], {0.0f, 0.0f, 3.0f}));
+}
+
+}  // namespace
+
+void animation_clip_test(void) {
+  animation_sampler_test();
+  animation_clip_bake_test();
+  animation_clip_node_test();
+}
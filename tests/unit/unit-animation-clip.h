@@ -0,0 +1,3 @@
+#pragma once
+
+void animation_clip_test(void);
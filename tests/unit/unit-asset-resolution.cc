@@ -0,0 +1,91 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+
+#include "unit-asset-resolution.h"
+#include "asset-resolution.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+const uint8_t kPayload[] = {'t', 'i', 'n', 'y', 'u', 's', 'd', 'z'};
+
+int ViewPayload(const char *resolved_asset_name, const uint8_t **addr,
+                uint64_t *nbytes, std::string *err, void *userdata) {
+  (void)resolved_asset_name;
+  (void)err;
+  (void)userdata;
+  (*addr) = kPayload;
+  (*nbytes) = sizeof(kPayload);
+  return 0;
+}
+
+}  // namespace
+
+void asset_resolution_test(void) {
+  // Asset view
+  {
+    Asset asset;
+    asset.set_view(kPayload, sizeof(kPayload));
+    TEST_CHECK(asset.is_view());
+    TEST_CHECK(asset.size() == sizeof(kPayload));
+
+    const Asset &casset = asset;
+    TEST_CHECK(casset.data() == kPayload);
+
+    // Copy of view Asset still refers to the same memory.
+    Asset copied = asset;
+    TEST_CHECK(copied.is_view());
+    TEST_CHECK(static_cast<const Asset &>(copied).data() == kPayload);
+
+    // Read access does not copy the viewed data.
+    TEST_CHECK(casset.data() == kPayload);
+    TEST_CHECK(asset.is_view());
+
+    // Writable access requires explicit copy.
+    TEST_CHECK(asset.mutable_data() == nullptr);
+    asset.materialize();
+    uint8_t *p = asset.mutable_data();
+    TEST_CHECK(!asset.is_view());
+    TEST_CHECK(p != kPayload);
+    TEST_CHECK(asset.size() == sizeof(kPayload));
+    TEST_CHECK(memcmp(p, kPayload, sizeof(kPayload)) == 0);
+
+    // Non-const `data()` copies the viewed data.
+    uint8_t *q = copied.data();
+    TEST_CHECK(!copied.is_view());
+    TEST_CHECK(q != kPayload);
+    TEST_CHECK(memcmp(q, kPayload, sizeof(kPayload)) == 0);
+
+    asset.set_data({1, 2, 3});
+    TEST_CHECK(!asset.is_view());
+    TEST_CHECK(asset.size() == 3);
+
+    // Non-const `data()` writes to the owned buffer.
+    asset.data()[0] = 4;
+    TEST_CHECK(asset.mutable_data() == asset.data());
+    TEST_CHECK(casset.data()[0] == 4);
+  }
+
+  // Resolver uses `view_fun` when provided.
+  {
+    AssetResolutionResolver resolver;
+
+    AssetResolutionHandler handler;
+    handler.view_fun = ViewPayload;
+    resolver.register_asset_resolution_handler("bin", handler);
+
+    Asset asset;
+    std::string warn, err;
+    TEST_CHECK(resolver.open_asset("dummy.bin", "dummy.bin", &asset, &warn, &err));
+    TEST_CHECK(asset.is_view());
+    TEST_CHECK(asset.size() == sizeof(kPayload));
+    TEST_CHECK(static_cast<const Asset &>(asset).data() == kPayload);
+  }
+}
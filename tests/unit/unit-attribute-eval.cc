@@ -0,0 +1,222 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "unit-attribute-eval.h"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+#include "tydra/attribute-eval.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+const char *kAnimatedMaterialUSDA = R"(#usda 1.0
+def Material "mat" {
+  float inputs:rough.timeSamples = {
+    0: 0.5,
+    10: 1.5,
+  }
+  float inputs:rough2.connect = </mat.inputs:rough>
+  int inputs:count = 3
+}
+)";
+
+// Compare with per-time-code evaluation.
+template <typename T, typename A>
+bool SameAsSingleEval(const Stage &stage, const A &attr,
+                      const std::vector<double> &times,
+                      const std::vector<T> &values,
+                      value::TimeSampleInterpolationType tinterp) {
+  for (size_t i = 0; i < times.size(); i++) {
+    T v;
+    std::string err;
+    if (!EvaluateTypedAnimatableAttribute(stage, attr, "attr", &v, &err,
+                                          times[i], tinterp)) {
+      return false;
+    }
+    if (!(v == values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void attribute_eval_test(void) {
+  Stage stage;
+
+  const std::vector<double> times = {value::TimeCode::Default(),
+                                     -5.0,
+                                     0.0,
+                                     2.5,
+                                     10.0,
+                                     15.0,
+                                     20.0,
+                                     30.0};
+  const std::vector<double> unsorted_times = {15.0, 2.5, 30.0, 0.0, 20.0,
+                                              -1.0};
+
+  TypedAttribute<Animatable<float>> animated;
+  {
+    // Added in unsorted order.
+    Animatable<float> anim;
+    anim.add_sample(20.0, 50.0f);
+    anim.add_sample(0.0, 0.0f);
+    anim.add_sample(10.0, 100.0f);
+    animated.set_value(anim);
+  }
+
+  // Single attribute
+  {
+    std::string err;
+    std::vector<float> values(times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(stage, animated, "animated",
+                                                times, values.data(),
+                                                &err) == true);
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(values[1] == 0.0f);
+    TEST_CHECK(values[3] == 25.0f);
+    TEST_CHECK(values[5] == 75.0f);
+    TEST_CHECK(values[7] == 50.0f);
+    TEST_CHECK(SameAsSingleEval(stage, animated, times, values,
+                                value::TimeSampleInterpolationType::Linear));
+
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(
+                   stage, animated, "animated", times, values.data(), &err,
+                   value::TimeSampleInterpolationType::Held) == true);
+    TEST_CHECK(values[3] == 0.0f);
+    TEST_CHECK(values[5] == 100.0f);
+    TEST_CHECK(values[7] == 50.0f);
+    TEST_CHECK(SameAsSingleEval(stage, animated, times, values,
+                                value::TimeSampleInterpolationType::Held));
+
+    // Time goes backward.
+    values.resize(unsorted_times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(stage, animated, "animated",
+                                                unsorted_times, values.data(),
+                                                &err) == true);
+    TEST_CHECK(SameAsSingleEval(stage, animated, unsorted_times, values,
+                                value::TimeSampleInterpolationType::Linear));
+  }
+
+  // Non-interpolatable type is always Held.
+  {
+    TypedAttribute<Animatable<int>> ints;
+    Animatable<int> anim;
+    anim.add_sample(0.0, 1);
+    anim.add_sample(10.0, 2);
+    ints.set_value(anim);
+
+    std::string err;
+    std::vector<int> values(times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(stage, ints, "ints", times,
+                                                values.data(), &err) == true);
+    TEST_CHECK(values[3] == 1);
+    TEST_CHECK(values[4] == 2);
+    TEST_CHECK(SameAsSingleEval(stage, ints, times, values,
+                                value::TimeSampleInterpolationType::Linear));
+  }
+
+  // Fallback
+  {
+    TypedAttributeWithFallback<Animatable<float>> fallback{0.5f};
+    std::string err;
+    std::vector<float> values(times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(stage, fallback, "fallback",
+                                                times, values.data(),
+                                                &err) == true);
+    TEST_CHECK(values[0] == 0.5f);
+    TEST_CHECK(values[7] == 0.5f);
+    TEST_CHECK(SameAsSingleEval(stage, fallback, times, values,
+                                value::TimeSampleInterpolationType::Linear));
+  }
+
+  // Connection to timeSampled attribute.
+  {
+    Stage mat_stage;
+    std::string warn, err;
+    bool ret = LoadUSDAFromMemory(
+        reinterpret_cast<const uint8_t *>(kAnimatedMaterialUSDA),
+        strlen(kAnimatedMaterialUSDA), "", &mat_stage, &warn, &err);
+    TEST_CHECK(ret == true);
+    TEST_MSG("%s", err.c_str());
+
+    TypedAttribute<Animatable<float>> connected;
+    connected.set_connection(Path("/mat", "inputs:rough2"));
+
+    std::vector<float> values(times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(mat_stage, connected,
+                                                "connected", times,
+                                                values.data(), &err) == true);
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(values[2] == 0.5f);
+    TEST_CHECK(values[3] == 0.75f);
+    TEST_CHECK(values[7] == 1.5f);
+    TEST_CHECK(SameAsSingleEval(mat_stage, connected, times, values,
+                                value::TimeSampleInterpolationType::Linear));
+
+    // Type mismatch
+    TypedAttribute<Animatable<int>> mismatch;
+    mismatch.set_connection(Path("/mat", "inputs:rough"));
+    std::vector<int> ivalues(times.size());
+    err.clear();
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(mat_stage, mismatch,
+                                                "mismatch", times,
+                                                ivalues.data(), &err) == false);
+    TEST_CHECK(err.find("Type mismatch") != std::string::npos);
+  }
+
+  // Multiple attributes
+  {
+    TypedAttribute<Animatable<float>> scalar;
+    scalar.set_value(Animatable<float>(2.0f));
+
+    TypedAttribute<Animatable<float>> blocked;
+    blocked.set_blocked(true);
+
+    std::vector<const TypedAttribute<Animatable<float>> *> attrs = {
+        &animated, &scalar, &animated};
+
+    std::string err;
+    std::vector<float> values(attrs.size() * times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttributes(
+                   stage, attrs, {}, times, values.data(), &err,
+                   value::TimeSampleInterpolationType::Linear,
+                   /* num_threads */ 2) == true);
+    TEST_MSG("%s", err.c_str());
+
+    std::vector<float> expected(times.size());
+    TEST_CHECK(EvaluateTypedAnimatableAttribute(
+                   stage, animated, "animated", times, expected.data(), &err));
+    for (size_t i = 0; i < times.size(); i++) {
+      TEST_CHECK(values[i] == expected[i]);
+      TEST_CHECK(values[times.size() + i] == 2.0f);
+      TEST_CHECK(values[2 * times.size() + i] == expected[i]);
+    }
+
+    // Failed attribute is reported, others are still evaluated.
+    attrs[0] = &blocked;
+    std::fill(values.begin(), values.end(), -1.0f);
+    TEST_CHECK(EvaluateTypedAnimatableAttributes(
+                   stage, attrs, {"blocked", "scalar", "animated"}, times,
+                   values.data(), &err) == false);
+    TEST_CHECK(err.find("blocked") != std::string::npos);
+    TEST_CHECK(values[times.size()] == 2.0f);
+    TEST_CHECK(values[2 * times.size() + 3] == expected[3]);
+
+    // Names size mismatch
+    TEST_CHECK(EvaluateTypedAnimatableAttributes(stage, attrs, {"a"}, times,
+                                                 values.data(),
+                                                 &err) == false);
+  }
+}
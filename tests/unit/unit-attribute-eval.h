@@ -0,0 +1,3 @@
+#pragma once
+
+void attribute_eval_test(void);
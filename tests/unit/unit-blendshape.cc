@@ -0,0 +1,190 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cmath>
+#include <vector>
+
+#include "unit-blendshape.h"
+#include "tydra/blendshape.hh"
+#include "tydra/skinning.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+bool Near(const vec3 &a, float x, float y, float z, float eps = 1e-5f) {
+  return (std::fabs(a[0] - x) < eps) && (std::fabs(a[1] - y) < eps) &&
+         (std::fabs(a[2] - z) < eps);
+}
+
+// targets: "a"(sparse), "b"(dense, with in-between at weight 0.5)
+RenderMesh MakeMesh() {
+  RenderMesh mesh;
+  mesh.abs_path = "/mesh";
+  mesh.points = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+  mesh.usdFaceVertexIndices = {0, 1, 2};
+  mesh.usdFaceVertexCounts = {3};
+
+  ShapeTarget a;
+  a.pointIndices = {1};
+  a.pointOffsets = {{1.0f, 0.0f, 0.0f}};
+  a.normalOffsets = {{1.0f, 0.0f, -1.0f}};
+  mesh.targets["a"] = a;
+
+  ShapeTarget b;
+  b.pointOffsets = {{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}};
+  InbetweenShapeTarget ib;
+  ib.weight = 0.5f;
+  ib.pointOffsets = {{0.0f, 0.0f, 2.0f}, {0.0f, 0.0f, 2.0f}, {0.0f, 0.0f, 2.0f}};
+  b.inbetweens[ib.weight] = ib;
+  mesh.targets["b"] = b;
+
+  std::vector<vec3> normals(3, {0.0f, 0.0f, 1.0f});
+  mesh.normals.format = VertexAttributeFormat::Vec3;
+  mesh.normals.variability = VertexVariability::Vertex;
+  mesh.normals.set_buffer(reinterpret_cast<const uint8_t *>(normals.data()), normals.size() * sizeof(vec3));
+
+  return mesh;
+}
+
+void blendshape_inbetween_test() {
+  RenderMesh mesh = MakeMesh();
+  const ShapeTarget &b = mesh.targets["b"];
+
+  std::vector<vec3> offsets;
+  EvaluateShapeTarget(b, 0.25f, &offsets);
+  TEST_CHECK(offsets.size() == 3);
+  TEST_CHECK(Near(offsets[0], 0.0f, 0.0f, 1.0f));
+
+  EvaluateShapeTarget(b, 0.75f, &offsets);
+  TEST_CHECK(Near(offsets[0], 0.0f, 0.0f, 1.5f));
+
+  EvaluateShapeTarget(b, 1.0f, &offsets);
+  TEST_CHECK(Near(offsets[0], 0.0f, 0.0f, 1.0f));
+
+  // Extrapolated with the segment [0.5, 1.0]
+  EvaluateShapeTarget(b, 1.5f, &offsets);
+  TEST_CHECK(Near(offsets[0], 0.0f, 0.0f, 0.0f));
+}
+
+void blendshape_apply_test() {
+  RenderMesh mesh = MakeMesh();
+
+  std::vector<vec3> points;
+  std::vector<vec3> normals;
+  std::string err;
+
+  TEST_CHECK(ApplyBlendShapes(mesh, {1.0f, 0.0f}, &points, &normals, &err));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(points.size() == 3);
+  TEST_CHECK(Near(points[0], 0.0f, 0.0f, 0.0f));
+  TEST_CHECK(Near(points[1], 2.0f, 0.0f, 0.0f));
+  TEST_CHECK(normals.size() == 3);
+  TEST_CHECK(Near(normals[0], 0.0f, 0.0f, 1.0f));
+  TEST_CHECK(Near(normals[1], 1.0f, 0.0f, 0.0f));
+
+  TEST_CHECK(ApplyBlendShapes(mesh, {0.5f, 0.25f}, &points, &normals, &err));
+  TEST_CHECK(Near(points[1], 1.5f, 0.0f, 1.0f));
+  TEST_CHECK(Near(points[2], 0.0f, 1.0f, 1.0f));
+
+  // No active target with normalOffsets.
+  TEST_CHECK(ApplyBlendShapes(mesh, {0.0f, 1.0f}, &points, &normals, &err));
+  TEST_CHECK(normals.empty());
+
+  // weights.size mismatch
+  TEST_CHECK(!ApplyBlendShapes(mesh, {1.0f}, &points, &normals, &err));
+
+  // out-of-range pointIndices
+  mesh.targets["a"].pointIndices[0] = 3;
+  TEST_CHECK(!ApplyBlendShapes(mesh, {1.0f, 0.0f}, &points, &normals, &err));
+}
+
+void blendshape_parallel_test() {
+  RenderMesh mesh;
+  const size_t num_points = 1000;
+  for (size_t i = 0; i < num_points; i++) {
+    mesh.points.push_back({float(i), 0.0f, 0.0f});
+  }
+
+  std::vector<float> weights;
+  for (size_t t = 0; t < 32; t++) {
+    ShapeTarget target;
+    for (size_t i = t; i < num_points; i += 3) {
+      target.pointIndices.push_back(uint32_t(i));
+      target.pointOffsets.push_back({0.0f, float(t), 1.0f});
+    }
+    mesh.targets["t" + std::to_string(t)] = target;
+    weights.push_back((t % 4) ? 0.5f : 0.0f);
+  }
+
+  std::string err;
+  std::vector<vec3> serial;
+  BlendShapeConfig config;
+  config.num_threads = 1;
+  TEST_CHECK(ApplyBlendShapes(mesh, weights, &serial, nullptr, &err, config));
+
+  std::vector<vec3> parallel;
+  config.num_threads = 4;
+  config.parallel_threshold = 0;
+  TEST_CHECK(ApplyBlendShapes(mesh, weights, &parallel, nullptr, &err, config));
+
+  TEST_CHECK(serial.size() == num_points);
+  TEST_CHECK(parallel.size() == num_points);
+  bool same = true;
+  for (size_t i = 0; i < num_points; i++) {
+    same &= Near(serial[i], parallel[i][0], parallel[i][1], parallel[i][2]);
+  }
+  TEST_CHECK(same);
+}
+
+void blendshape_skinning_test() {
+  RenderScene scene;
+
+  SkelHierarchy skel;
+  skel.root_node.joint_path = "root";
+  skel.root_node.joint_id = 0;
+  skel.root_node.rest_transform.m[3][0] = 10.0;
+  skel.anim_id = 0;
+  scene.skeletons.push_back(skel);
+
+  Animation anim;
+  AnimationSampler<float> w;
+  w.samples.push_back({0.0f, 0.0f});
+  w.samples.push_back({10.0f, 1.0f});
+  anim.blendshape_weights_map["a"] = w;
+  scene.animations.push_back(anim);
+
+  std::vector<float> weights;
+  RenderMesh mesh = MakeMesh();
+  GetBlendShapeWeights(mesh, &scene.animations[0], 5.0, &weights);
+  TEST_CHECK(weights.size() == 2);
+  TEST_CHECK(std::fabs(weights[0] - 0.5f) < 1e-6f);
+  TEST_CHECK(weights[1] == 0.0f);
+
+  mesh.skel_id = 0;
+  mesh.joint_and_weights.jointIndices = {0, 0, 0};
+  mesh.joint_and_weights.jointWeights = {1.0f, 1.0f, 1.0f};
+  scene.meshes.push_back(mesh);
+
+  // BlendShape, then translate by the joint.
+  SkinningEngine engine;
+  SkinnedMesh out;
+  TEST_CHECK(engine.SkinMesh(scene, 0, 10.0, &out));
+  TEST_MSG("%s", engine.GetError().c_str());
+  TEST_CHECK(Near(out.points[1], 12.0f, 0.0f, 0.0f));
+  TEST_CHECK(Near(out.normals[1], 1.0f, 0.0f, 0.0f));
+}
+
+}  // namespace
+
+void blendshape_test(void) {
+  blendshape_inbetween_test();
+  blendshape_apply_test();
+  blendshape_parallel_test();
+  blendshape_skinning_test();
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void blendshape_test(void);
@@ -0,0 +1,195 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "unit-c-api.h"
+#include "c-tinyusd.h"
+
+namespace {
+
+const char *kUSDA = R"(#usda 1.0
+
+def Xform "root"
+{
+    def Mesh "mesh"
+    {
+        int[] faceVertexCounts = [4]
+        int[] faceVertexIndices = [0, 1, 2, 3]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)]
+        float[] primvars:weight = [0.5, 1.5]
+    }
+
+    def Sphere "sphere"
+    {
+        double radius = 2
+        float[] primvars:foo = [1, 2, 3]
+    }
+
+    def Cube "cube"
+    {
+        custom int[] myattr.timeSamples = {
+            0: [1, 2],
+            1: [3, 4, 5],
+        }
+    }
+
+    def Camera "camera"
+    {
+        float[] primvars:bar = [4]
+    }
+
+    def SphereLight "light"
+    {
+        float[] primvars:baz = [5, 6]
+    }
+}
+)";
+
+const CTinyUSDPrim *GetPrim(const CTinyUSDStage *stage, const char *path) {
+  const CTinyUSDPrim *prim = nullptr;
+  if (!c_tinyusd_stage_get_prim_at_path(stage, path, &prim)) {
+    return nullptr;
+  }
+  return prim;
+}
+
+bool CheckFloats(const c_tinyusd_array_view_t &view, const float *expected,
+                 uint64_t n) {
+  if ((view.count != n) || (view.stride != sizeof(float)) ||
+      (view.value_type != C_TINYUSD_VALUE_FLOAT)) {
+    return false;
+  }
+  return std::memcmp(view.data, expected, sizeof(float) * n) == 0;
+}
+
+}  // namespace
+
+void c_api_test(void) {
+  const std::string filename = "unit-c-api-test.usda";
+  {
+    std::ofstream ofs(filename);
+    ofs << kUSDA;
+  }
+
+  CTinyUSDStage *stage = c_tinyusd_stage_new();
+  c_tinyusd_string_t *warn = c_tinyusd_string_new_empty();
+  c_tinyusd_string_t *err = c_tinyusd_string_new_empty();
+
+  int ret = c_tinyusd_load_usd_from_file(filename.c_str(), stage, warn, err);
+  TEST_CHECK(ret == 1);
+  TEST_MSG("%s", c_tinyusd_string_str(err));
+  if (!ret) {
+    c_tinyusd_string_free(warn);
+    c_tinyusd_string_free(err);
+    c_tinyusd_stage_free(stage);
+    std::remove(filename.c_str());
+    return;
+  }
+
+  c_tinyusd_array_view_t view;
+
+  // GeomMesh builtin attribute.
+  {
+    const CTinyUSDPrim *mesh = GetPrim(stage, "/root/mesh");
+    TEST_CHECK(mesh != nullptr);
+
+    TEST_CHECK(c_tinyusd_prim_get_attribute_array_view(mesh, "points", &view));
+    TEST_CHECK(view.count == 4);
+    TEST_CHECK(view.stride == sizeof(float) * 3);
+    TEST_CHECK(view.value_type == C_TINYUSD_VALUE_POINT3F);
+    const float *p = reinterpret_cast<const float *>(view.data);
+    TEST_CHECK(p[3] == 1.0f);
+    TEST_CHECK(p[7] == 1.0f);
+
+    TEST_CHECK(c_tinyusd_prim_get_attribute_array_view(
+        mesh, "faceVertexIndices", &view));
+    TEST_CHECK(view.count == 4);
+    TEST_CHECK(view.value_type == C_TINYUSD_VALUE_INT);
+
+    const float weight[] = {0.5f, 1.5f};
+    TEST_CHECK(c_tinyusd_prim_get_attribute_array_view(
+        mesh, "primvars:weight", &view));
+    TEST_CHECK(CheckFloats(view, weight, 2));
+
+    TEST_CHECK(!c_tinyusd_prim_get_attribute_array_view(mesh, "no_such_attr",
+                                                         &view));
+  }
+
+  // Generic properties of non-Mesh Prims.
+  {
+    const float foo[] = {1.0f, 2.0f, 3.0f};
+    const CTinyUSDPrim *sphere = GetPrim(stage, "/root/sphere");
+    TEST_CHECK(sphere != nullptr);
+    TEST_CHECK(
+        c_tinyusd_prim_get_attribute_array_view(sphere, "primvars:foo", &view));
+    TEST_CHECK(CheckFloats(view, foo, 3));
+
+    const float bar[] = {4.0f};
+    const CTinyUSDPrim *camera = GetPrim(stage, "/root/camera");
+    TEST_CHECK(camera != nullptr);
+    TEST_CHECK(
+        c_tinyusd_prim_get_attribute_array_view(camera, "primvars:bar", &view));
+    TEST_CHECK(CheckFloats(view, bar, 1));
+
+    const float baz[] = {5.0f, 6.0f};
+    const CTinyUSDPrim *light = GetPrim(stage, "/root/light");
+    TEST_CHECK(light != nullptr);
+    TEST_CHECK(
+        c_tinyusd_prim_get_attribute_array_view(light, "primvars:baz", &view));
+    TEST_CHECK(CheckFloats(view, baz, 2));
+  }
+
+  // TimeSamples
+  {
+    const CTinyUSDPrim *cube = GetPrim(stage, "/root/cube");
+    TEST_CHECK(cube != nullptr);
+    TEST_CHECK(c_tinyusd_prim_get_attribute_num_timesamples(cube, "myattr") ==
+               2);
+
+    // No default value.
+    TEST_CHECK(!c_tinyusd_prim_get_attribute_array_view(cube, "myattr", &view));
+
+    double t = -1.0;
+    TEST_CHECK(c_tinyusd_prim_get_attribute_timesample_view(cube, "myattr", 1,
+                                                            &t, &view));
+    TEST_CHECK(t == 1.0);
+    TEST_CHECK(view.count == 3);
+    TEST_CHECK(view.value_type == C_TINYUSD_VALUE_INT);
+    TEST_CHECK(reinterpret_cast<const int *>(view.data)[2] == 5);
+
+    TEST_CHECK(!c_tinyusd_prim_get_attribute_timesample_view(cube, "myattr", 2,
+                                                             &t, &view));
+  }
+
+  // RenderScene
+  {
+    CTinyUSDRenderScene *scene = c_tinyusd_render_scene_new();
+    TEST_CHECK(c_tinyusd_render_scene_convert(stage, filename.c_str(), scene,
+                                              warn, err));
+    TEST_MSG("%s", c_tinyusd_string_str(err));
+    TEST_CHECK(c_tinyusd_render_scene_num_meshes(scene) == 1);
+
+    TEST_CHECK(c_tinyusd_render_mesh_get_array_view(
+        scene, 0, C_TINYUSD_RENDER_MESH_POINTS, &view));
+    TEST_CHECK(view.count == 4);
+    TEST_CHECK(view.stride == sizeof(float) * 3);
+
+    TEST_CHECK(!c_tinyusd_render_mesh_get_array_view(
+        scene, 1, C_TINYUSD_RENDER_MESH_POINTS, &view));
+
+    TEST_CHECK(c_tinyusd_render_scene_free(scene));
+  }
+
+  c_tinyusd_string_free(warn);
+  c_tinyusd_string_free(err);
+  c_tinyusd_stage_free(stage);
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void c_api_test(void);
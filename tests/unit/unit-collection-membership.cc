@@ -0,0 +1,224 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <string>
+
+#include "unit-collection-membership.h"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+#include "tydra/scene-access.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+const char *kCollectionUSDA = R"(#usda 1.0
+def Xform "root" {
+  rel collection:geom:includes = [</root/a>, </root/b/c>, </root.collection:lights>]
+  rel collection:geom:excludes = [</root/a/x>]
+
+  rel collection:lights:includes = [</root/lights>]
+
+  uniform token collection:explicit:expansionRule = "explicitOnly"
+  rel collection:explicit:includes = [</root/a>, </root/b>]
+
+  uniform token collection:props:expansionRule = "expandPrimsAndProperties"
+  rel collection:props:includes = [</root/a>]
+
+  rel collection:cycle:includes = [</root.collection:cycle>]
+
+  rel collection:outer:includes = [</root/b>, </root.collection:inner>]
+
+  uniform token collection:inner:expansionRule = "explicitOnly"
+  rel collection:inner:includes = [</root/b>, </root/a>]
+  rel collection:inner:excludes = [</root/b/e>]
+
+  def Xform "a" {
+    def Xform "x" {
+      def Xform "y" {
+      }
+    }
+    def Xform "z" {
+    }
+  }
+
+  def Xform "b" {
+    def Xform "c" {
+      def Xform "d" {
+      }
+    }
+    def Xform "e" {
+    }
+  }
+
+  def Scope "lights" {
+    def Xform "key" {
+    }
+  }
+}
+)";
+
+CollectionMembershipQuery BuildQuery(const Stage &stage,
+                                     const std::string &name) {
+  const Prim *prim{nullptr};
+  const Collection *coll{nullptr};
+  const CollectionInstance *instance{nullptr};
+  if (!stage.find_prim_at_path(Path("/root", ""), prim) ||
+      !GetCollection(*prim, &coll) || !coll->get_instance(name, &instance)) {
+    return CollectionMembershipQuery();
+  }
+  return BuildCollectionMembershipQuery(stage, *instance);
+}
+
+bool Included(const CollectionMembershipQuery &query, const Stage &stage,
+              const std::string &prim_part,
+              const std::string &prop_part = std::string()) {
+  return IsPathIncluded(query, stage, Path(prim_part, prop_part));
+}
+
+}  // namespace
+
+void collection_membership_test(void) {
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(
+      reinterpret_cast<const uint8_t *>(kCollectionUSDA),
+      strlen(kCollectionUSDA), "", &stage, &warn, &err);
+  TEST_CHECK(ret == true);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+
+  // expandPrims, excludes and nested collection.
+  {
+    CollectionMembershipQuery query = BuildQuery(stage, "geom");
+    TEST_CHECK(!query.empty());
+
+    TEST_CHECK(!Included(query, stage, "/"));
+    TEST_CHECK(!Included(query, stage, "/root"));
+    TEST_CHECK(Included(query, stage, "/root/a"));
+    TEST_CHECK(!Included(query, stage, "/root/a/x"));
+    TEST_CHECK(!Included(query, stage, "/root/a/x/y"));
+    TEST_CHECK(Included(query, stage, "/root/a/z"));
+    TEST_CHECK(!Included(query, stage, "/root/b"));
+    TEST_CHECK(Included(query, stage, "/root/b/c"));
+    TEST_CHECK(Included(query, stage, "/root/b/c/d"));
+    TEST_CHECK(!Included(query, stage, "/root/b/e"));
+    TEST_CHECK(Included(query, stage, "/root/lights/key"));
+    TEST_CHECK(!Included(query, stage, "/nonexistent/a"));
+
+    // expandPrims does not include properties.
+    TEST_CHECK(!Included(query, stage, "/root/a/z", "visibility"));
+
+    CollectionInstance::ExpansionRule rule =
+        CollectionInstance::ExpansionRule::ExplicitOnly;
+    TEST_CHECK(IsPathIncluded(query, stage, Path("/root/b/c/d", ""), &rule));
+    TEST_CHECK(rule == CollectionInstance::ExpansionRule::ExpandPrims);
+
+    // Bulk evaluation
+    std::vector<Path> paths;
+    TEST_CHECK(ComputeIncludedPrimPaths(query, stage, &paths, &err) == true);
+    std::vector<std::string> path_strs;
+    for (const auto &p : paths) {
+      path_strs.push_back(p.full_path_name());
+    }
+    const std::vector<std::string> expected = {
+        "/root/a", "/root/a/z", "/root/b/c", "/root/b/c/d", "/root/lights",
+        "/root/lights/key"};
+    TEST_CHECK(path_strs == expected);
+    TEST_MSG("# of included paths = %d", int(path_strs.size()));
+  }
+
+  // explicitOnly
+  {
+    CollectionMembershipQuery query = BuildQuery(stage, "explicit");
+    TEST_CHECK(Included(query, stage, "/root/a"));
+    TEST_CHECK(Included(query, stage, "/root/b"));
+    TEST_CHECK(!Included(query, stage, "/root/a/z"));
+    TEST_CHECK(!Included(query, stage, "/root/b/c"));
+
+    std::vector<Path> paths;
+    TEST_CHECK(ComputeIncludedPrimPaths(query, stage, &paths, &err) == true);
+    TEST_CHECK(paths.size() == 2);
+  }
+
+  // expandPrimsAndProperties
+  {
+    CollectionMembershipQuery query = BuildQuery(stage, "props");
+    TEST_CHECK(Included(query, stage, "/root/a/x/y"));
+    TEST_CHECK(Included(query, stage, "/root/a/x/y", "visibility"));
+    TEST_CHECK(!Included(query, stage, "/root/b", "visibility"));
+  }
+
+  // Nested collection includes the same path with a weaker expansion rule.
+  {
+    CollectionMembershipQuery query = BuildQuery(stage, "outer");
+    TEST_CHECK(Included(query, stage, "/root/b"));
+    TEST_CHECK(Included(query, stage, "/root/b/c/d"));
+    TEST_CHECK(!Included(query, stage, "/root/b/e"));
+    TEST_CHECK(Included(query, stage, "/root/a"));
+    TEST_CHECK(!Included(query, stage, "/root/a/z"));
+
+    CollectionInstance::ExpansionRule rule =
+        CollectionInstance::ExpansionRule::ExplicitOnly;
+    TEST_CHECK(IsPathIncluded(query, stage, Path("/root/b", ""), &rule));
+    TEST_CHECK(rule == CollectionInstance::ExpansionRule::ExpandPrims);
+  }
+
+  // Circular reference gives empty query.
+  {
+    CollectionMembershipQuery query = BuildQuery(stage, "cycle");
+    TEST_CHECK(query.empty());
+    TEST_CHECK(!Included(query, stage, "/root"));
+  }
+
+  // Manually built query. includeRoot + excludes.
+  {
+    CollectionMembershipQuery query;
+    query.add_include(Path("/", ""),
+                      CollectionInstance::ExpansionRule::ExpandPrims);
+    query.add_exclude(Path("/root/b", ""));
+    query.add_include(Path("/root/b/c", ""),
+                      CollectionInstance::ExpansionRule::ExpandPrims);
+    TEST_CHECK(Included(query, stage, "/root"));
+    TEST_CHECK(Included(query, stage, "/root/a/x"));
+    TEST_CHECK(!Included(query, stage, "/root/b"));
+    TEST_CHECK(!Included(query, stage, "/root/b/e"));
+    TEST_CHECK(Included(query, stage, "/root/b/c/d"));
+
+    std::vector<Path> paths;
+    TEST_CHECK(ComputeIncludedPrimPaths(query, stage, &paths, &err) == true);
+    TEST_CHECK(paths.size() == 9);
+    TEST_MSG("# of included paths = %d", int(paths.size()));
+  }
+
+  // Rules of the same path do not depend on the order.
+  {
+    CollectionMembershipQuery query;
+    query.add_include(Path("/root/a", ""),
+                      CollectionInstance::ExpansionRule::ExpandPrimsAndProperties);
+    query.add_include(Path("/root/a", ""),
+                      CollectionInstance::ExpansionRule::ExplicitOnly);
+    query.add_include(Path("/root/b", ""),
+                      CollectionInstance::ExpansionRule::ExpandPrims);
+    query.add_exclude(Path("/root/b", ""));
+    query.add_include(Path("/root/b", ""),
+                      CollectionInstance::ExpansionRule::ExpandPrims);
+
+    CollectionInstance::ExpansionRule rule =
+        CollectionInstance::ExpansionRule::ExplicitOnly;
+    TEST_CHECK(IsPathIncluded(query, stage, Path("/root/a", ""), &rule));
+    TEST_CHECK(rule ==
+               CollectionInstance::ExpansionRule::ExpandPrimsAndProperties);
+    TEST_CHECK(Included(query, stage, "/root/a/x", "visibility"));
+    TEST_CHECK(!Included(query, stage, "/root/b"));
+    TEST_CHECK(!Included(query, stage, "/root/b/c"));
+  }
+}
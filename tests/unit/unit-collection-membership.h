@@ -0,0 +1,3 @@
+#pragma once
+
+void collection_membership_test(void);
@@ -0,0 +1,153 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <string>
+
+#include "unit-connection-graph.h"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+#include "tydra/connection-graph.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+const char *kShaderNetworkUSDA = R"(#usda 1.0
+def Material "mat" {
+  token outputs:surface.connect = </mat/pbr.outputs:surface>
+  color3f inputs:baseColor = (1, 0, 0)
+  color3f inputs:texColor.connect = </mat/tex.outputs:rgb>
+  int inputs:specular = 1
+  float inputs:a.connect = </mat.inputs:b>
+  float inputs:b.connect = </mat.inputs:a>
+  float inputs:missing.connect = </nonexistent.outputs:r>
+
+  def Shader "pbr" {
+    uniform token info:id = "UsdPreviewSurface"
+    color3f inputs:diffuseColor.connect = </mat.inputs:baseColor>
+    color3f inputs:emissiveColor.connect = </mat.inputs:texColor>
+    int inputs:useSpecularWorkflow.connect = </mat.inputs:specular>
+    float inputs:roughness = 0.25
+    token outputs:surface
+  }
+
+  def Shader "tex" {
+    uniform token info:id = "UsdUVTexture"
+    asset inputs:file = @tex.png@
+    float2 inputs:st.connect = </mat/reader.outputs:result>
+    float3 outputs:rgb
+  }
+
+  def Shader "reader" {
+    uniform token info:id = "UsdPrimvarReader_float2"
+    string inputs:varname = "st"
+    float2 outputs:result
+  }
+}
+)";
+
+std::string TerminalPath(ConnectionGraph &graph,
+                         const std::string &prim_part,
+                         const std::string &prop_part) {
+  Path terminal;
+  std::string err;
+  if (!graph.GetTerminalAttributePath(Path(prim_part, prop_part), &terminal,
+                                      &err)) {
+    return "error";
+  }
+  return terminal.full_path_name();
+}
+
+}  // namespace
+
+void connection_graph_test(void) {
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(
+      reinterpret_cast<const uint8_t *>(kShaderNetworkUSDA),
+      strlen(kShaderNetworkUSDA), "", &stage, &warn, &err);
+  TEST_CHECK(ret == true);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+
+  ConnectionGraph graph;
+  TEST_CHECK(graph.stage() == nullptr);
+  TEST_CHECK(graph.Build(stage, &err) == true);
+  TEST_CHECK(graph.stage() == &stage);
+
+  TEST_CHECK(graph.GetPrim(Path("/mat/pbr", "")) != nullptr);
+  TEST_CHECK(graph.GetPrim(Path("/mat/none", "")) == nullptr);
+
+  // Terminal attribute
+  TEST_CHECK(TerminalPath(graph, "/mat/pbr", "inputs:diffuseColor") ==
+             "/mat.inputs:baseColor");
+  TEST_CHECK(TerminalPath(graph, "/mat/pbr", "inputs:emissiveColor") ==
+             "/mat/tex.outputs:rgb");
+  TEST_CHECK(TerminalPath(graph, "/mat/pbr", "inputs:roughness") ==
+             "/mat/pbr.inputs:roughness");
+  TEST_CHECK(TerminalPath(graph, "/mat/tex", "inputs:st") ==
+             "/mat/reader.outputs:result");
+
+  // Memoized for every attribute in the chain.
+  size_t num_resolved = graph.num_resolved();
+  TEST_CHECK(num_resolved >= 7);
+  TEST_CHECK(TerminalPath(graph, "/mat", "inputs:texColor") ==
+             "/mat/tex.outputs:rgb");
+  TEST_CHECK(graph.num_resolved() == num_resolved);
+
+  // Invalid connections
+  TEST_CHECK(TerminalPath(graph, "/mat", "inputs:a") == "error");
+  TEST_CHECK(TerminalPath(graph, "/mat", "inputs:b") == "error");
+  TEST_CHECK(TerminalPath(graph, "/mat", "inputs:missing") == "error");
+
+  // Evaluation
+  {
+    TerminalAttributeValue value;
+    TEST_CHECK(graph.EvaluateAttribute(Path("/mat/pbr", ""),
+                                       "inputs:diffuseColor", &value,
+                                       &err) == true);
+    TEST_MSG("%s", err.c_str());
+    const value::color3f *pcol = value.as<value::color3f>();
+    TEST_CHECK(pcol != nullptr);
+    if (pcol) {
+      TEST_CHECK((*pcol)[0] == 1.0f);
+      TEST_CHECK((*pcol)[1] == 0.0f);
+    }
+    TEST_CHECK(graph.num_cached_values() == 1);
+
+    // Cached
+    TEST_CHECK(graph.EvaluateAttribute(Path("/mat", ""), "inputs:baseColor",
+                                       &value, &err) == true);
+    TEST_CHECK(graph.num_cached_values() == 1);
+
+    TEST_CHECK(graph.EvaluateAttribute(Path("/mat/pbr", ""),
+                                       "inputs:useSpecularWorkflow", &value,
+                                       &err) == true);
+    TEST_CHECK(value.as<int>() != nullptr);
+    if (value.as<int>()) {
+      TEST_CHECK(*value.as<int>() == 1);
+    }
+
+    TEST_CHECK(graph.EvaluateAttribute(Path("/mat/reader", ""),
+                                       "inputs:varname", &value,
+                                       &err) == true);
+    TEST_CHECK(value.as<std::string>() != nullptr);
+
+    err.clear();
+    TEST_CHECK(graph.EvaluateAttribute(Path("/mat", ""), "inputs:a", &value,
+                                       &err) == false);
+    TEST_CHECK(err.find("Circular") != std::string::npos);
+  }
+
+  graph.clear();
+  TEST_CHECK(graph.stage() == nullptr);
+  TEST_CHECK(graph.GetPrim(Path("/mat/pbr", "")) == nullptr);
+}
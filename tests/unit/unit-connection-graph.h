@@ -0,0 +1,3 @@
+#pragma once
+
+void connection_graph_test(void);
@@ -0,0 +1,203 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "unit-gltf-export.h"
+#include "tydra/gltf-export.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+uint32_t ReadU32(const std::vector<uint8_t> &data, size_t offset) {
+  uint32_t v{0};
+  memcpy(&v, data.data() + offset, sizeof(uint32_t));
+  return v;
+}
+
+// Quad(not triangulated) with facevarying texcoords + textured material.
+RenderScene MakeQuadScene() {
+  RenderScene scene;
+
+  RenderMesh mesh;
+  mesh.prim_name = "quad";
+  mesh.abs_path = "/root/quad";
+  mesh.points = {{0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {2.0f, 2.0f, 0.0f}, {0.0f, 2.0f, 0.0f}};
+  mesh.usdFaceVertexIndices = {0, 1, 2, 3};
+  mesh.usdFaceVertexCounts = {4};
+  mesh.material_id = 0;
+
+  std::vector<vec2> uvs = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+  VertexAttribute texcoords;
+  texcoords.format = VertexAttributeFormat::Vec2;
+  texcoords.variability = VertexVariability::FaceVarying;
+  texcoords.set_buffer(reinterpret_cast<const uint8_t *>(uvs.data()), uvs.size() * sizeof(vec2));
+  mesh.texcoords[0] = texcoords;
+
+  std::vector<vec3> normals(4, {0.0f, 0.0f, 1.0f});
+  mesh.normals.format = VertexAttributeFormat::Vec3;
+  mesh.normals.variability = VertexVariability::Vertex;
+  mesh.normals.set_buffer(reinterpret_cast<const uint8_t *>(normals.data()), normals.size() * sizeof(vec3));
+
+  scene.meshes.push_back(mesh);
+
+  BufferData buffer;
+  buffer.data.assign(2 * 2 * 4, 255);
+  scene.buffers.push_back(buffer);
+
+  TextureImage image;
+  image.width = 2;
+  image.height = 2;
+  image.channels = 4;
+  image.buffer_id = 0;
+  scene.images.push_back(image);
+
+  UVTexture tex;
+  tex.texture_image_id = 0;
+  tex.wrapS = UVTexture::WrapMode::REPEAT;
+  scene.textures.push_back(tex);
+
+  RenderMaterial material;
+  material.name = "mat";
+  material.surfaceShader.diffuseColor.texture_id = 0;
+  scene.materials.push_back(material);
+
+  Node node;
+  node.prim_name = "quad";
+  node.nodeType = NodeType::Mesh;
+  node.id = 0;
+  node.local_matrix = value::matrix4d::identity();
+  scene.nodes.push_back(node);
+
+  return scene;
+}
+
+bool CheckGLB(const std::vector<uint8_t> &glb, std::string *json_str) {
+  if (glb.size() < 20) {
+    return false;
+  }
+
+  TEST_CHECK(ReadU32(glb, 0) == 0x46546C67);  // "glTF"
+  TEST_CHECK(ReadU32(glb, 4) == 2);
+  TEST_CHECK(ReadU32(glb, 8) == glb.size());
+
+  uint32_t json_len = ReadU32(glb, 12);
+  TEST_CHECK(ReadU32(glb, 16) == 0x4E4F534A);  // "JSON"
+  TEST_CHECK((json_len % 4) == 0);
+  if ((20 + size_t(json_len)) > glb.size()) {
+    return false;
+  }
+  (*json_str) = std::string(reinterpret_cast<const char *>(glb.data() + 20), json_len);
+
+  size_t bin_offset = 20 + json_len;
+  if (bin_offset == glb.size()) {
+    return true;  // no BIN chunk
+  }
+
+  uint32_t bin_len = ReadU32(glb, bin_offset);
+  TEST_CHECK(ReadU32(glb, bin_offset + 4) == 0x004E4942);  // "BIN\0"
+  TEST_CHECK((bin_len % 4) == 0);
+  TEST_CHECK((bin_offset + 8 + bin_len) == glb.size());
+
+  return true;
+}
+
+}  // namespace
+
+void gltf_export_test(void) {
+  const RenderScene scene = MakeQuadScene();
+
+  {
+    std::vector<uint8_t> glb;
+    std::string warn, err;
+    TEST_CHECK(export_to_glb(scene, glb, &warn, &err));
+    TEST_MSG("%s", err.c_str());
+
+    std::string json_str;
+    TEST_CHECK(CheckGLB(glb, &json_str));
+    TEST_CHECK(json_str.find("\"POSITION\"") != std::string::npos);
+    TEST_CHECK(json_str.find("\"NORMAL\"") != std::string::npos);
+    TEST_CHECK(json_str.find("\"TEXCOORD_0\"") != std::string::npos);
+    TEST_CHECK(json_str.find("\"baseColorTexture\"") != std::string::npos);
+    TEST_CHECK(json_str.find("\"image/png\"") != std::string::npos);
+    TEST_CHECK(json_str.find("KHR_mesh_quantization") == std::string::npos);
+    // Quad is expanded to 4 face-vertices(facevarying texcoords) and
+    // triangulated into 2 triangles.
+    TEST_CHECK(json_str.find("\"count\":6") != std::string::npos);
+  }
+
+  // Quantized
+  {
+    GLBExportConfig config;
+    config.quantize_positions = true;
+    config.quantize_normals = true;
+    config.quantize_texcoords = true;
+    config.export_images = false;
+
+    std::vector<uint8_t> glb;
+    std::string warn, err;
+    TEST_CHECK(export_to_glb(scene, glb, &warn, &err, config));
+    TEST_MSG("%s", err.c_str());
+
+    std::string json_str;
+    TEST_CHECK(CheckGLB(glb, &json_str));
+    TEST_CHECK(json_str.find("\"extensionsRequired\":[\"KHR_mesh_quantization\"]") != std::string::npos);
+    TEST_CHECK(json_str.find("\"quad_dequantize\"") != std::string::npos);
+    TEST_CHECK(json_str.find("\"images\"") == std::string::npos);
+  }
+
+  // Two UV sets. Textures refer TEXCOORD_n of their `varname_uv`.
+  {
+    RenderScene uv2 = scene;
+    RenderMesh &mesh = uv2.meshes[0];
+
+    std::vector<vec2> uvs = {{0.0f, 0.0f}, {0.5f, 0.0f}, {0.5f, 0.5f}, {0.0f, 0.5f}};
+    VertexAttribute texcoords;
+    texcoords.format = VertexAttributeFormat::Vec2;
+    texcoords.variability = VertexVariability::FaceVarying;
+    texcoords.set_buffer(reinterpret_cast<const uint8_t *>(uvs.data()), uvs.size() * sizeof(vec2));
+    mesh.texcoords[1] = texcoords;
+    mesh.texcoordSlotIdMap.add("st", 0);
+    mesh.texcoordSlotIdMap.add("st1", 1);
+
+    uv2.textures[0].varname_uv = "st1";
+
+    UVTexture tex;
+    tex.texture_image_id = 0;
+    tex.varname_uv = "st";
+    uv2.textures.push_back(tex);
+    uv2.materials[0].surfaceShader.emissiveColor.texture_id = 1;
+
+    std::vector<uint8_t> glb;
+    std::string warn, err;
+    TEST_CHECK(export_to_glb(uv2, glb, &warn, &err));
+    TEST_MSG("%s", err.c_str());
+
+    std::string json_str;
+    TEST_CHECK(CheckGLB(glb, &json_str));
+    TEST_CHECK(json_str.find("\"TEXCOORD_1\"") != std::string::npos);
+    TEST_CHECK(json_str.find("\"baseColorTexture\":{\"index\":0,\"texCoord\":1}") != std::string::npos);
+    TEST_CHECK(json_str.find("\"emissiveTexture\":{\"index\":1,\"texCoord\":0}") != std::string::npos);
+    TEST_MSG("%s", json_str.c_str());
+  }
+
+  // Empty scene
+  {
+    RenderScene empty;
+    std::vector<uint8_t> glb;
+    std::string warn, err;
+    TEST_CHECK(export_to_glb(empty, glb, &warn, &err));
+
+    std::string json_str;
+    TEST_CHECK(CheckGLB(glb, &json_str));
+    TEST_CHECK(json_str.find("\"buffers\"") == std::string::npos);
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void gltf_export_test(void);
@@ -0,0 +1,275 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "unit-image-util.h"
+#include "image-util.hh"
+#include "value-types.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+// Scalar references(per-texel evaluation) for LUT kernels.
+
+float RefSrgbToLinear(float x) {
+  if (x <= 0.0f)
+    return 0.0f;
+  else if (x >= 1.0f)
+    return 1.0f;
+  else if (x < 0.04045f)
+    return x / 12.92f;
+  else
+    return std::pow((x + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t RefF32ToU8(float x) {
+  return static_cast<uint8_t>((std::max)(0, (std::min)(int(x * 255.0f), 255)));
+}
+
+float RefRec709ToLinear(uint8_t v) {
+  float V = v / 255.0f;
+  if (V < 0.081f) {
+    return V / 4.5f;
+  }
+  return std::pow((V + 0.099f) / 1.099f, (1.0f / 0.45f));
+}
+
+bool SameBits(float a, float b) {
+  return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Widths which are not a multiple of SIMD width(4 pixels).
+const size_t kTailWidths[] = {1, 2, 3, 5, 7, 13};
+const size_t kTailHeights[] = {1, 3};
+
+}  // namespace
+
+void image_util_test(void) {
+  // All 256 u8 inputs. RGB uses LUT, alpha(channel_stride > channels) uses
+  // linear conversion.
+  std::vector<uint8_t> u8_all(256 * 4);
+  for (size_t i = 0; i < 256; i++) {
+    for (size_t c = 0; c < 4; c++) {
+      u8_all[4 * i + c] = uint8_t(i);
+    }
+  }
+
+  // sRGB u8 -> linear f32
+  {
+    std::vector<float> out;
+    std::string err;
+    TEST_CHECK(srgb_8bit_to_linear_f32(u8_all, 256, 1, 3, 4, &out, &err));
+    TEST_CHECK(out.size() == 256 * 4);
+    for (size_t i = 0; i < 256; i++) {
+      float ref = RefSrgbToLinear(float(i) / 255.0f);
+      for (size_t c = 0; c < 3; c++) {
+        TEST_CHECK(SameBits(out[4 * i + c], ref));
+        TEST_MSG("u8 %d: %.9g vs %.9g", int(i), double(out[4 * i + c]),
+                 double(ref));
+      }
+      TEST_CHECK(SameBits(out[4 * i + 3], float(i) / 255.0f));
+    }
+  }
+
+  // sRGB u8 -> linear u8
+  {
+    std::vector<uint8_t> out;
+    std::string err;
+    TEST_CHECK(srgb_8bit_to_linear_8bit(u8_all, 256, 1, 3, 4, &out, &err));
+    TEST_CHECK(out.size() == 256 * 4);
+    for (size_t i = 0; i < 256; i++) {
+      uint8_t ref = RefF32ToU8(RefSrgbToLinear(float(i) / 255.0f));
+      for (size_t c = 0; c < 3; c++) {
+        TEST_CHECK(out[4 * i + c] == ref);
+      }
+      TEST_CHECK(out[4 * i + 3] == uint8_t(i));
+    }
+  }
+
+  // u8 -> f32
+  {
+    std::vector<float> out;
+    std::string err;
+    TEST_CHECK(u8_to_f32_image(u8_all, 256, 1, 4, &out, &err));
+    TEST_CHECK(out.size() == 256 * 4);
+    for (size_t i = 0; i < out.size(); i++) {
+      TEST_CHECK(SameBits(out[i], float(u8_all[i]) / 255.0f));
+    }
+  }
+
+  // Rec.709 u8 -> linear f32, with padded rows.
+  {
+    const size_t width = 64;
+    const size_t height = 4;
+    const size_t row_bytes = width * 4 + 3;
+    std::vector<uint8_t> src(row_bytes * height, 0xcd);
+    for (size_t y = 0; y < height; y++) {
+      std::memcpy(src.data() + row_bytes * y, u8_all.data() + width * 4 * y,
+                  width * 4);
+    }
+
+    std::vector<float> out;
+    std::string err;
+    TEST_CHECK(rec709_8bit_to_linear_f32(src, width, row_bytes, height, 3, 4,
+                                         &out, &err));
+    TEST_CHECK(out.size() == 256 * 4);
+    for (size_t i = 0; i < 256; i++) {
+      float ref = RefRec709ToLinear(uint8_t(i));
+      for (size_t c = 0; c < 3; c++) {
+        TEST_CHECK(SameBits(out[4 * i + c], ref));
+      }
+      TEST_CHECK(SameBits(out[4 * i + 3], float(i) / 255.0f));
+    }
+  }
+
+  // linear f32 -> sRGB u8
+  {
+    // Round trip of all 256 levels.
+    std::vector<float> linear;
+    std::string err;
+    TEST_CHECK(srgb_8bit_to_linear_f32(u8_all, 256, 1, 4, 4, &linear, &err));
+
+    std::vector<uint8_t> out;
+    TEST_CHECK(linear_f32_to_srgb_8bit(linear, 256, 1, 4, 4, &out, &err));
+    TEST_CHECK(out == u8_all);
+
+    // Dense sweep: the result is one of the two nearest levels and is
+    // monotonic.
+    const size_t n = 100003;  // odd length
+    std::vector<float> sweep(n);
+    for (size_t i = 0; i < n; i++) {
+      sweep[i] = -0.01f + 1.02f * float(i) / float(n - 1);
+    }
+    TEST_CHECK(linear_f32_to_srgb_8bit(sweep, n, 1, 1, 1, &out, &err));
+    TEST_CHECK(out.size() == n);
+
+    std::vector<float> levels(256);
+    for (size_t i = 0; i < 256; i++) {
+      levels[i] = RefSrgbToLinear(float(i) / 255.0f);
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+      float x = sweep[i];
+      uint8_t v = out[i];
+      if (x <= 0.0f) {
+        ok &= (v == 0);
+      } else if (x >= 1.0f) {
+        ok &= (v == 255);
+      } else {
+        size_t hi = size_t(std::upper_bound(levels.begin(), levels.end(), x) -
+                           levels.begin());
+        size_t lo = (hi > 0) ? hi - 1 : 0;
+        hi = (std::min)(hi, size_t(255));
+        ok &= ((v == lo) || (v == hi));
+      }
+      if (i > 0) {
+        ok &= (out[i - 1] <= v);
+      }
+    }
+    TEST_CHECK(ok);
+  }
+
+  // fp16 -> linear f32: 65536-entry LUT path(large image) vs per-texel
+  // path(small image) over all fp16 bit patterns.
+  {
+    // 512 x 512 texels(= 4 * 65536) selects the LUT path.
+    const size_t lut_width = 512;
+    const size_t lut_height = 512;
+    std::vector<value::half> large(lut_width * lut_height);
+    for (size_t i = 0; i < large.size(); i++) {
+      large[i].value = uint16_t(i & 0xffff);
+    }
+
+    std::vector<float> lut_out;
+    std::string err;
+    TEST_CHECK(displayp3_f16_to_linear_f32(large, lut_width, lut_height, 1, 1,
+                                           &lut_out, 1.0f, 0.0f, 1.0f, 0.0f,
+                                           &err));
+
+    // Per-texel path, 257 texels per row to leave a tail.
+    const size_t width = 257;
+    const size_t height = (65536 + width - 1) / width;
+    std::vector<value::half> small(width * height);
+    for (size_t i = 0; i < small.size(); i++) {
+      small[i].value = uint16_t(i & 0xffff);
+    }
+
+    std::vector<float> ref_out;
+    TEST_CHECK(displayp3_f16_to_linear_f32(small, width, height, 1, 1,
+                                           &ref_out, 1.0f, 0.0f, 1.0f, 0.0f,
+                                           &err));
+
+    bool ok = true;
+    for (size_t i = 0; i < large.size(); i++) {
+      float a = lut_out[i];
+      float b = ref_out[i & 0xffff];
+      if (std::isnan(a) || std::isnan(b)) {
+        ok &= (std::isnan(a) && std::isnan(b));
+      } else {
+        ok &= SameBits(a, b);
+      }
+    }
+    TEST_CHECK(ok);
+  }
+
+  // 3x3 color matrix: SSE2 path(RGBA) vs scalar path(RGB) on tail lengths.
+  for (size_t width : kTailWidths) {
+    for (size_t height : kTailHeights) {
+      size_t num_pixels = width * height;
+      std::vector<float> rgba(num_pixels * 4);
+      std::vector<float> rgb(num_pixels * 3);
+      for (size_t i = 0; i < num_pixels; i++) {
+        for (size_t c = 0; c < 3; c++) {
+          // Include negative values to exercise clamping.
+          float v = float((i * 7 + c * 13) % 29) / 14.0f - 0.5f;
+          rgba[4 * i + c] = v;
+          rgb[3 * i + c] = v;
+        }
+        rgba[4 * i + 3] = float(i) * 0.25f;
+      }
+
+      std::string err;
+      std::vector<float> out4, out3;
+      TEST_CHECK(linear_sRGB_to_ACEScg(rgba, width, height, 4, &out4, &err));
+      TEST_CHECK(linear_sRGB_to_ACEScg(rgb, width, height, 3, &out3, &err));
+      TEST_CHECK(out4.size() == num_pixels * 4);
+      TEST_CHECK(out3.size() == num_pixels * 3);
+
+      bool ok = true;
+      for (size_t i = 0; i < num_pixels; i++) {
+        for (size_t c = 0; c < 3; c++) {
+          ok &= SameBits(out4[4 * i + c], out3[3 * i + c]);
+          ok &= (out3[3 * i + c] >= 0.0f);
+        }
+        ok &= SameBits(out4[4 * i + 3], rgba[4 * i + 3]);
+      }
+      TEST_CHECK(ok);
+      TEST_MSG("linear_sRGB_to_ACEScg %d x %d", int(width), int(height));
+
+      TEST_CHECK(linear_displayp3_to_linear_sRGB(rgba, width, height, 4, &out4,
+                                                 &err));
+      TEST_CHECK(
+          linear_displayp3_to_linear_sRGB(rgb, width, height, 3, &out3, &err));
+      ok = true;
+      for (size_t i = 0; i < num_pixels; i++) {
+        for (size_t c = 0; c < 3; c++) {
+          ok &= SameBits(out4[4 * i + c], out3[3 * i + c]);
+        }
+        ok &= SameBits(out4[4 * i + 3], rgba[4 * i + 3]);
+      }
+      TEST_CHECK(ok);
+      TEST_MSG("linear_displayp3_to_linear_sRGB %d x %d", int(width),
+               int(height));
+    }
+  }
+}
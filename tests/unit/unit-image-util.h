@@ -0,0 +1,3 @@
+#pragma once
+
+void image_util_test(void);
@@ -15,12 +15,43 @@
 #include "unit-ioutil.h"
 #include "unit-strutil.h"
 #include "unit-timesamples.h"
+#include "unit-trace.h"
 #include "unit-pprint.h"
+#include "unit-usda-writer.h"
+#include "unit-usdz-writer.h"
+#include "unit-memory-budget.h"
+#include "unit-asset-resolution.h"
+#include "unit-image-util.h"
+#include "unit-population-mask.h"
+
+#if defined(TINYUSDZ_WITH_TYDRA)
+#include "unit-texture-compress.h"
+#include "unit-texture-util.h"
+#include "unit-progressive-loader.h"
+#include "unit-gltf-export.h"
+#include "unit-skinning.h"
+#include "unit-blendshape.h"
+#include "unit-animation-clip.h"
+#include "unit-nurbs-tess.h"
+#include "unit-tydra-triangulate.h"
+#include "unit-material-binding.h"
+#include "unit-collection-membership.h"
+#include "unit-connection-graph.h"
+#include "unit-attribute-eval.h"
+#endif
 
 #if defined(TINYUSDZ_WITH_PXR_COMPAT_API)
 #include "unit-pxr-compat-api.h"
 #endif
 
+#if defined(TINYUSDZ_WITH_C_API)
+#include "unit-c-api.h"
+#endif
+
+#if defined(TINYUSDZ_WITH_OPENSUBDIV)
+#include "unit-subdiv.h"
+#endif
+
 
 
 TEST_LIST = {
@@ -38,8 +69,36 @@ TEST_LIST = {
   { "ioutil_test", ioutil_test },
   { "strutil_test", strutil_test },
   { "timesamples_test", timesamples_test },
+  { "trace_test", trace_test },
+  { "usda_writer_test", usda_writer_test },
+  { "usdz_writer_test", usdz_writer_test },
+  { "memory_budget_test", memory_budget_test },
+  { "asset_resolution_test", asset_resolution_test },
+  { "image_util_test", image_util_test },
+  { "population_mask_test", population_mask_test },
+#if defined(TINYUSDZ_WITH_TYDRA)
+  { "texture_compress_test", texture_compress_test },
+  { "texture_util_test", texture_util_test },
+  { "progressive_loader_test", progressive_loader_test },
+  { "gltf_export_test", gltf_export_test },
+  { "skinning_test", skinning_test },
+  { "blendshape_test", blendshape_test },
+  { "animation_clip_test", animation_clip_test },
+  { "nurbs_tess_test", nurbs_tess_test },
+  { "tydra_triangulate_test", tydra_triangulate_test },
+  { "material_binding_test", material_binding_test },
+  { "collection_membership_test", collection_membership_test },
+  { "connection_graph_test", connection_graph_test },
+  { "attribute_eval_test", attribute_eval_test },
+#endif
 #if defined(TINYUSDZ_WITH_PXR_COMPAT_API)
   { "pxr_compat_api_test", pxr_compat_api_test },
+#endif
+#if defined(TINYUSDZ_WITH_C_API)
+  { "c_api_test", c_api_test },
+#endif
+#if defined(TINYUSDZ_WITH_OPENSUBDIV)
+  { "subdiv_test", subdiv_test },
 #endif
   { nullptr, nullptr }
 };
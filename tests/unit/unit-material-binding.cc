@@ -0,0 +1,194 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <string>
+
+#include "unit-material-binding.h"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+#include "tydra/shader-network.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+const char *kMaterialBindingUSDA = R"(#usda 1.0
+def Xform "root" {
+  rel material:binding = </root/mtls/red>
+
+  def Scope "mtls" {
+    def Material "red" {}
+    def Material "green" {}
+    def Material "blue" {}
+    def Material "metal" {}
+  }
+
+  def Xform "a" {
+    rel material:binding = </root/mtls/green>
+    rel material:binding:back = </root/mtls/blue>
+
+    def Mesh "mesh" {
+      int[] faceVertexCounts = [3, 3]
+      int[] faceVertexIndices = [0, 1, 2, 0, 2, 3]
+      point3f[] points = [(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)]
+
+      def GeomSubset "sub0" {
+        uniform token elementType = "face"
+        uniform token familyName = "materialBind"
+        int[] indices = [0]
+        rel material:binding = </root/mtls/blue>
+      }
+
+      def GeomSubset "sub1" {
+        uniform token elementType = "face"
+        uniform token familyName = "materialBind"
+        int[] indices = [1]
+      }
+    }
+  }
+
+  def Xform "b" {
+    rel material:binding = </root/mtls/blue> (
+      bindMaterialAs = "strongerThanDescendants"
+    )
+
+    def Xform "c" {
+      rel material:binding = </root/mtls/green>
+    }
+  }
+
+  def Xform "d" {
+    rel collection:metal:includes = [</root/d>]
+    rel collection:metal:excludes = [</root/d/f>]
+    rel material:binding:collection:metal = [</root/d.collection:metal>, </root/mtls/metal>]
+
+    def Xform "e" {
+    }
+
+    def Xform "f" {
+    }
+  }
+
+  def Xform "g" {
+    rel material:binding = </root/mtls/green>
+    rel collection:metal:includes = [</root/g>]
+    rel collection:metal:excludes = [</root/g/i>]
+    rel material:binding:collection:metal = [</root/g.collection:metal>, </root/mtls/metal>]
+
+    def Xform "h" {
+    }
+
+    def Xform "i" {
+    }
+  }
+
+  def Xform "k" {
+    rel material:binding = </root/mtls/blue> (
+      bindMaterialAs = "strongerThanDescendants"
+    )
+    rel collection:metal:includes = [</root/k>]
+    rel material:binding:collection:metal = [</root/k.collection:metal>, </root/mtls/metal>]
+  }
+}
+)";
+
+std::string BoundMaterial(const MaterialBindingCache &cache,
+                          const std::string &prim_path,
+                          const std::string &purpose = std::string()) {
+  Path material_path;
+  const Material *material{nullptr};
+  if (!cache.GetBoundMaterial(Path(prim_path, ""), purpose, &material_path,
+                              &material)) {
+    return std::string();
+  }
+  if (!material) {
+    return "(null)";
+  }
+  return material_path.full_path_name();
+}
+
+}  // namespace
+
+void material_binding_test(void) {
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(
+      reinterpret_cast<const uint8_t *>(kMaterialBindingUSDA),
+      strlen(kMaterialBindingUSDA), "", &stage, &warn, &err);
+  TEST_CHECK(ret == true);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+
+  MaterialBindingCache cache;
+  ret = cache.Build(stage, {"back"}, &warn, &err);
+  TEST_CHECK(ret == true);
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(cache.has_purpose(""));
+  TEST_CHECK(cache.has_purpose("back"));
+  TEST_CHECK(!cache.has_purpose("full"));
+
+  // Root-level Prim and inheritance.
+  TEST_CHECK(BoundMaterial(cache, "/root") == "/root/mtls/red");
+  TEST_CHECK(BoundMaterial(cache, "/root/mtls") == "/root/mtls/red");
+
+  // Nearest binding wins.
+  TEST_CHECK(BoundMaterial(cache, "/root/a") == "/root/mtls/green");
+  TEST_CHECK(BoundMaterial(cache, "/root/a/mesh") == "/root/mtls/green");
+
+  // GeomSubset
+  TEST_CHECK(BoundMaterial(cache, "/root/a/mesh/sub0") == "/root/mtls/blue");
+  TEST_CHECK(BoundMaterial(cache, "/root/a/mesh/sub1") == "/root/mtls/green");
+
+  // Purpose. Fallback to all-purpose binding.
+  TEST_CHECK(BoundMaterial(cache, "/root/a/mesh", "back") == "/root/mtls/blue");
+  TEST_CHECK(BoundMaterial(cache, "/root/a/mesh/sub0", "back") ==
+             "/root/mtls/blue");
+  TEST_CHECK(BoundMaterial(cache, "/root/b", "back") == "/root/mtls/blue");
+  TEST_CHECK(BoundMaterial(cache, "/root", "back") == "/root/mtls/red");
+  TEST_CHECK(BoundMaterial(cache, "/root/a", "full").empty());
+
+  // strongerThanDescendants
+  TEST_CHECK(BoundMaterial(cache, "/root/b") == "/root/mtls/blue");
+  TEST_CHECK(BoundMaterial(cache, "/root/b/c") == "/root/mtls/blue");
+
+  // Collection binding
+  TEST_CHECK(BoundMaterial(cache, "/root/d") == "/root/mtls/metal");
+  TEST_CHECK(BoundMaterial(cache, "/root/d/e") == "/root/mtls/metal");
+  TEST_CHECK(BoundMaterial(cache, "/root/d/f") == "/root/mtls/red");
+
+  // Collection binding is evaluated before the direct binding of the same
+  // Prim.
+  TEST_CHECK(BoundMaterial(cache, "/root/g") == "/root/mtls/metal");
+  TEST_CHECK(BoundMaterial(cache, "/root/g/h") == "/root/mtls/metal");
+  TEST_CHECK(BoundMaterial(cache, "/root/g/i") == "/root/mtls/green");
+
+  // ...unless the direct binding is strongerThanDescendants.
+  TEST_CHECK(BoundMaterial(cache, "/root/k") == "/root/mtls/blue");
+
+  // Same result with GetBoundMaterial(except for the collection binding,
+  // which is not supported in GetBoundMaterial)
+  {
+    Path material_path;
+    const Material *material{nullptr};
+    TEST_CHECK(GetBoundMaterial(stage, Path("/root/b/c", ""), "",
+                                &material_path, &material, &err) == true);
+    TEST_CHECK(material_path.full_path_name() == "/root/mtls/blue");
+    TEST_CHECK(GetBoundMaterial(stage, Path("/root/a/mesh/sub1", ""), "",
+                                &material_path, &material, &err) == true);
+    TEST_CHECK(material_path.full_path_name() == "/root/mtls/green");
+  }
+
+  TEST_CHECK(BoundMaterial(cache, "/nonexistent").empty());
+
+  cache.clear();
+  TEST_CHECK(BoundMaterial(cache, "/root").empty());
+  TEST_CHECK(cache.size() == 0);
+}
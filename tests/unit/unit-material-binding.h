@@ -0,0 +1,3 @@
+#pragma once
+
+void material_binding_test(void);
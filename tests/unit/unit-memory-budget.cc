@@ -0,0 +1,266 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include "unit-memory-budget.h"
+#include "crate-reader.hh"
+#include "io-util.hh"
+#include "memory-budget.hh"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+
+using namespace tinyusdz;
+
+static const char kUSDA[] = R"(#usda 1.0
+
+def Xform "root"
+{
+    double3 xformOp:translate.timeSamples = {
+        0: (0, 0, 0),
+        1: (1, 0, 0),
+        2: (2, 0, 0),
+    }
+    uniform token[] xformOpOrder = ["xformOp:translate"]
+
+    def Mesh "mesh"
+    {
+        int[] faceVertexCounts = [3, 3]
+        int[] faceVertexIndices = [0, 1, 2, 0, 2, 3]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)]
+    }
+}
+)";
+
+void memory_budget_test(void) {
+
+  {
+    MemoryBudget budget(100);
+
+    TEST_CHECK(budget.reserve(MemoryCategory::Prims, 60) == true);
+    TEST_CHECK(budget.reserve(MemoryCategory::Assets, 30) == true);
+
+    // exceeds the limit. Nothing is accounted.
+    std::string err;
+    TEST_CHECK(budget.reserve(MemoryCategory::Assets, 11, &err) == false);
+    TEST_CHECK(err.size() > 0);
+    TEST_CHECK(budget.usage(MemoryCategory::Assets) == 30);
+    TEST_CHECK(budget.total_usage() == 90);
+
+    budget.release(MemoryCategory::Assets, 30);
+    TEST_CHECK(budget.usage(MemoryCategory::Assets) == 0);
+    TEST_CHECK(budget.peak_usage(MemoryCategory::Assets) == 30);
+    TEST_CHECK(budget.total_usage() == 60);
+    TEST_CHECK(budget.peak_total_usage() == 90);
+
+    // clamped to zero.
+    budget.release(MemoryCategory::Prims, 1000);
+    TEST_CHECK(budget.usage(MemoryCategory::Prims) == 0);
+    TEST_CHECK(budget.total_usage() == 0);
+
+    budget.reset();
+    TEST_CHECK(budget.peak_total_usage() == 0);
+    TEST_CHECK(budget.limit() == 100);
+  }
+
+  {
+    MemoryBudget budget(8);
+    ScopedMemoryReservation reservation(&budget, MemoryCategory::Assets);
+    TEST_CHECK(reservation.reserve(4) == true);
+    TEST_CHECK(reservation.reserve(4) == true);
+    TEST_CHECK(reservation.reserve(1) == false);
+    TEST_CHECK(budget.usage(MemoryCategory::Assets) == 8);
+    reservation.release();
+    TEST_CHECK(budget.usage(MemoryCategory::Assets) == 0);
+  }
+
+  {
+    auto budget = std::make_shared<MemoryBudget>(100);
+    {
+      MemoryReservation reservation(budget);
+      TEST_CHECK(reservation.reserve(MemoryCategory::Prims, 40) == true);
+      TEST_CHECK(reservation.reserve(MemoryCategory::TimeSamples, 20) == true);
+      TEST_CHECK(reservation.reserve(MemoryCategory::Assets, 41) == false);
+      TEST_CHECK(reservation.total_reserved() == 60);
+
+      reservation.release(MemoryCategory::Prims, 10);
+      TEST_CHECK(budget->usage(MemoryCategory::Prims) == 30);
+
+      // Moved reservation is released only once.
+      MemoryReservation moved(std::move(reservation));
+      TEST_CHECK(reservation.total_reserved() == 0);
+      TEST_CHECK(moved.total_reserved() == 50);
+      TEST_CHECK(budget->total_usage() == 50);
+    }
+    TEST_CHECK(budget->total_usage() == 0);
+  }
+
+  // Partial reservation is rolled back.
+  {
+    primvar::PrimVar var;
+    value::TimeSamples ts;
+    ts.add_sample(0.0, value::Value(1.0f));
+    ts.add_sample(1.0, value::Value(2.0f));
+    var.set_timesamples(ts);
+    Attribute attr;
+    attr.set_var(std::move(var));
+
+    std::map<std::string, Property> props;
+    props["a"] = Property(attr, /* custom */ false);
+
+    uint64_t ts_bytes = 0;
+    uint64_t prop_bytes = EstimatePropertiesMemoryUsage(props, &ts_bytes);
+    TEST_CHECK(ts_bytes > 0);
+
+    // Prims fits, but TimeSamples does not.
+    auto budget =
+        std::make_shared<MemoryBudget>(sizeof(Prim) + prop_bytes + ts_bytes - 1);
+    MemoryReservation reservation(budget);
+    std::string err;
+    TEST_CHECK(ReservePrimMemory(&reservation, props, &err) == false);
+    TEST_CHECK(budget->total_usage() == 0);
+    TEST_CHECK(reservation.total_reserved() == 0);
+  }
+
+  // CrateReader failing on `maxMemoryBudget` only releases the bytes it has
+  // reserved in the shared budget.
+  {
+    std::vector<uint8_t> data;
+    std::string err;
+    TEST_CHECK(io::ReadWholeFile(
+        &data, &err, std::string(TINYUSDZ_TEST_DATA_DIR) + "/models/cube.usdc"));
+    TEST_MSG("%s", err.c_str());
+
+    auto budget = std::make_shared<MemoryBudget>();
+    // CrateTables reserved by other loader sharing the budget.
+    TEST_CHECK(budget->reserve(MemoryCategory::CrateTables, 4096) == true);
+
+    {
+      StreamReader sr(data.data(), data.size(), /* swap endian */ false);
+      crate::CrateReaderConfig config;
+      config.numThreads = 1;
+      config.maxMemoryBudget = 64;
+      config.memoryBudget = budget.get();
+      crate::CrateReader reader(&sr, config);
+
+      bool ret = reader.ReadBootStrap() && reader.ReadTOC() &&
+                 reader.ReadTokens() && reader.ReadStrings() &&
+                 reader.ReadFields();
+      TEST_CHECK(ret == false);
+      TEST_CHECK(reader.GetError().find("max memory budget") !=
+                 std::string::npos);
+    }
+
+    TEST_CHECK(budget->usage(MemoryCategory::CrateTables) == 4096);
+  }
+
+  // Budget is shared through USDLoadOptions.
+  {
+    auto budget = std::make_shared<MemoryBudget>();
+
+    USDLoadOptions options;
+    options.memory_budget = budget;
+
+    Stage stage;
+    std::string warn, err;
+    bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(kUSDA),
+                                  sizeof(kUSDA) - 1, "", &stage, &warn, &err,
+                                  options);
+    TEST_CHECK(ret == true);
+    TEST_MSG("%s", err.c_str());
+
+    TEST_CHECK(budget->usage(MemoryCategory::Prims) > 0);
+    TEST_CHECK(budget->usage(MemoryCategory::TimeSamples) > 0);
+    TEST_CHECK(to_string(*budget).size() > 0);
+  }
+
+  // Reservations are released when the Stage is destroyed or the load fails,
+  // so a shared budget can be used for multiple loads.
+  {
+    uint64_t usage_per_load = 0;
+    {
+      auto budget = std::make_shared<MemoryBudget>();
+      USDLoadOptions options;
+      options.memory_budget = budget;
+
+      Stage stage;
+      std::string warn, err;
+      TEST_CHECK(LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(kUSDA),
+                                    sizeof(kUSDA) - 1, "", &stage, &warn, &err,
+                                    options) == true);
+      usage_per_load = budget->usage(MemoryCategory::Prims) +
+                       budget->usage(MemoryCategory::TimeSamples);
+      TEST_CHECK(usage_per_load > 0);
+    }
+
+    // Room for one loaded Stage only.
+    auto budget =
+        std::make_shared<MemoryBudget>(usage_per_load + usage_per_load / 2);
+    USDLoadOptions options;
+    options.memory_budget = budget;
+
+    for (int i = 0; i < 2; i++) {
+      Stage stage;
+      std::string warn, err;
+      TEST_CHECK(LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(kUSDA),
+                                    sizeof(kUSDA) - 1, "", &stage, &warn, &err,
+                                    options) == true);
+      TEST_MSG("load %d: %s", i, err.c_str());
+      TEST_CHECK(budget->total_usage() == usage_per_load);
+
+      // Copy of the Stage shares the reservation.
+      Stage copied = stage;
+      TEST_CHECK(budget->total_usage() == usage_per_load);
+
+      // Second Stage does not fit while the first one is alive. Partially
+      // reserved memory of the failed load is released.
+      Stage stage2;
+      TEST_CHECK(LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(kUSDA),
+                                    sizeof(kUSDA) - 1, "", &stage2, &warn, &err,
+                                    options) == false);
+      TEST_CHECK(budget->total_usage() == usage_per_load);
+    }
+    TEST_CHECK(budget->total_usage() == 0);
+  }
+
+  // Stage keeps the budget alive after the caller drops its reference.
+  {
+    auto budget = std::make_shared<MemoryBudget>();
+    std::weak_ptr<MemoryBudget> weak_budget = budget;
+
+    USDLoadOptions options;
+    options.memory_budget = budget;
+
+    Stage stage;
+    std::string warn, err;
+    TEST_CHECK(LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(kUSDA),
+                                  sizeof(kUSDA) - 1, "", &stage, &warn, &err,
+                                  options) == true);
+    options.memory_budget.reset();
+    budget.reset();
+    TEST_CHECK(weak_budget.expired() == false);
+
+    stage = Stage();
+    TEST_CHECK(weak_budget.expired() == true);
+  }
+
+  // Fail fast when the budget is exceeded.
+  {
+    auto budget = std::make_shared<MemoryBudget>(64);
+
+    USDLoadOptions options;
+    options.memory_budget = budget;
+
+    Stage stage;
+    std::string warn, err;
+    bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(kUSDA),
+                                  sizeof(kUSDA) - 1, "", &stage, &warn, &err,
+                                  options);
+    TEST_CHECK(ret == false);
+    TEST_CHECK(err.find("Memory budget exceeded") != std::string::npos);
+    TEST_MSG("%s", err.c_str());
+  }
+
+}
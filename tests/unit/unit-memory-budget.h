@@ -0,0 +1,3 @@
+#pragma once
+
+void memory_budget_test(void);
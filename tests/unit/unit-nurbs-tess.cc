@@ -0,0 +1,170 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cmath>
+#include <vector>
+
+#include "unit-nurbs-tess.h"
+#include "tydra/nurbs-tess.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+// Bilinear unit square on XY plane.
+Nurbs MakePlane() {
+  Nurbs nurbs;
+  nurbs.u_vertex_count = 2;
+  nurbs.v_vertex_count = 2;
+  nurbs.u_order = 2;
+  nurbs.v_order = 2;
+  nurbs.u_knots = {0.0, 0.0, 1.0, 1.0};
+  nurbs.v_knots = {0.0, 0.0, 1.0, 1.0};
+  nurbs.points = {{0.0f, 0.0f, 0.0f},
+                  {1.0f, 0.0f, 0.0f},
+                  {0.0f, 1.0f, 0.0f},
+                  {1.0f, 1.0f, 0.0f}};
+  return nurbs;
+}
+
+// Quarter cylinder(radius 1, height 1). Exact circle with rational quadratic
+// in u.
+Nurbs MakeQuarterCylinder() {
+  Nurbs nurbs;
+  nurbs.u_vertex_count = 3;
+  nurbs.v_vertex_count = 2;
+  nurbs.u_order = 3;
+  nurbs.v_order = 2;
+  nurbs.u_knots = {0.0, 0.0, 0.0, 1.0, 1.0, 1.0};
+  nurbs.v_knots = {0.0, 0.0, 1.0, 1.0};
+  nurbs.points = {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+                  {1.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 1.0f}};
+  const double w = std::sqrt(0.5);
+  nurbs.point_weights = {1.0, w, 1.0, 1.0, w, 1.0};
+  return nurbs;
+}
+
+// Closed linear trim curve(polygon)
+void AddTrimLoop(NurbsTrimCurves &trim,
+                 const std::vector<value::double2> &corners) {
+  int n = int(corners.size()) + 1;
+  trim.counts.push_back(1);
+  trim.orders.push_back(2);
+  trim.vertex_counts.push_back(n);
+  trim.knots.push_back(0.0);
+  for (int i = 0; i < n; i++) {
+    trim.knots.push_back(double(i));
+  }
+  trim.knots.push_back(double(n - 1));
+  for (int i = 0; i < n; i++) {
+    const value::double2 &c = corners[size_t(i) % corners.size()];
+    trim.points.push_back({c[0], c[1], 1.0});
+  }
+}
+
+}  // namespace
+
+void nurbs_tess_test(void) {
+  // Uniform
+  {
+    NurbsTesselator tess;
+    RenderMesh mesh;
+    TEST_CHECK(tess.tesselate(MakePlane(), 4, 4, mesh) == true);
+    TEST_CHECK(mesh.points.size() == 25);
+    TEST_CHECK(mesh.usdFaceVertexCounts.size() == 32);
+    TEST_CHECK(mesh.usdFaceVertexIndices.size() == 96);
+    TEST_CHECK(mesh.normals.vertex_count() == 25);
+    TEST_CHECK(mesh.texcoords.count(0) == 1);
+
+    const vec3 *normals =
+        reinterpret_cast<const vec3 *>(mesh.normals.buffer());
+    const vec2 *uvs =
+        reinterpret_cast<const vec2 *>(mesh.texcoords[0].buffer());
+    for (size_t i = 0; i < mesh.points.size(); i++) {
+      TEST_CHECK(std::fabs(normals[i][2] - 1.0f) < 1e-5f);
+      TEST_CHECK(std::fabs(uvs[i][0] - mesh.points[i][0]) < 1e-5f);
+      TEST_CHECK(std::fabs(uvs[i][1] - mesh.points[i][1]) < 1e-5f);
+    }
+  }
+
+  // Adaptive: curved direction is refined, straight direction is not.
+  {
+    NurbsTesselator tess;
+    NurbsTesselatorConfig config;
+    RenderMesh mesh;
+    TEST_CHECK(tess.tesselate(MakeQuarterCylinder(), config, mesh) == true);
+    TEST_CHECK((mesh.points.size() % 2) == 0);
+    TEST_CHECK(mesh.points.size() > 16);
+    TEST_MSG("# of points = %d", int(mesh.points.size()));
+
+    const vec3 *normals =
+        reinterpret_cast<const vec3 *>(mesh.normals.buffer());
+    for (size_t i = 0; i < mesh.points.size(); i++) {
+      const vec3 &p = mesh.points[i];
+      float r = std::sqrt(p[0] * p[0] + p[1] * p[1]);
+      TEST_CHECK(std::fabs(r - 1.0f) < 1e-5f);
+      TEST_CHECK((std::fabs(p[2]) < 1e-6f) || (std::fabs(p[2] - 1.0f) < 1e-6f));
+
+      // Outward normal
+      TEST_CHECK(std::fabs(normals[i][0] - p[0]) < 1e-4f);
+      TEST_CHECK(std::fabs(normals[i][1] - p[1]) < 1e-4f);
+      TEST_CHECK(std::fabs(normals[i][2]) < 1e-4f);
+    }
+
+    // Tighter tolerance produces more points.
+    RenderMesh fine;
+    config.chord_tolerance = 1e-5f;
+    TEST_CHECK(tess.tesselate(MakeQuarterCylinder(), config, fine) == true);
+    TEST_CHECK(fine.points.size() > mesh.points.size());
+  }
+
+  // Trimming: outer loop and a hole.
+  {
+    Nurbs plane = MakePlane();
+    AddTrimLoop(plane.trim_curves, {{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}});
+    AddTrimLoop(plane.trim_curves,
+                {{0.25, 0.25}, {0.75, 0.25}, {0.75, 0.75}, {0.25, 0.75}});
+
+    NurbsTesselator tess;
+    RenderMesh mesh;
+    TEST_CHECK(tess.tesselate(plane, 8, 8, mesh) == true);
+    TEST_CHECK(mesh.usdFaceVertexCounts.size() == (64 - 16) * 2);
+    TEST_MSG("# of triangles = %d", int(mesh.usdFaceVertexCounts.size()));
+
+    for (size_t f = 0; f < mesh.usdFaceVertexCounts.size(); f++) {
+      float cx = 0.0f, cy = 0.0f;
+      for (size_t k = 0; k < 3; k++) {
+        const vec3 &p = mesh.points[mesh.usdFaceVertexIndices[3 * f + k]];
+        cx += p[0] / 3.0f;
+        cy += p[1] / 3.0f;
+      }
+      bool in_hole = (cx > 0.25f) && (cx < 0.75f) && (cy > 0.25f) && (cy < 0.75f);
+      TEST_CHECK(!in_hole);
+    }
+  }
+
+  // Multiple patches
+  {
+    std::vector<Nurbs> patches;
+    patches.push_back(MakePlane());
+    patches.push_back(MakeQuarterCylinder());
+
+    NurbsTesselator tess;
+    NurbsTesselatorConfig config;
+    std::vector<RenderMesh> meshes;
+    TEST_CHECK(tess.tesselate(patches, config, meshes) == true);
+    TEST_CHECK(meshes.size() == 2);
+    TEST_CHECK(meshes[0].usdFaceVertexCounts.size() == 2);
+    TEST_CHECK(meshes[1].points.size() > 16);
+
+    // Invalid patch
+    patches[1].points.pop_back();
+    TEST_CHECK(tess.tesselate(patches, config, meshes) == false);
+    TEST_CHECK(tess.GetError().size() > 0);
+  }
+}
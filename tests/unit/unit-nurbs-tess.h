@@ -0,0 +1,3 @@
+#pragma once
+
+void nurbs_tess_test(void);
@@ -148,4 +148,27 @@ void pathutil_test(void) {
     TEST_CHECK(ret == false);
   }
 
+  {
+    // population mask
+    std::vector<Path> mask{Path("/root/geom", "")};
+
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root/geom", ""), mask));
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root/geom/mesh", ""), mask));
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root/geom", "points"), mask));
+    // ancestors are included
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root", ""), mask));
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/", ""), mask));
+    TEST_CHECK(!pathutil::IsPathInPopulationMask(Path("/root/geometry", ""), mask));
+    TEST_CHECK(!pathutil::IsPathInPopulationMask(Path("/root/lights", ""), mask));
+    TEST_CHECK(!pathutil::IsPathInPopulationMask(Path("/other", ""), mask));
+
+    // variant selections are ignored
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root{v=a}", ""), mask));
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root{v=a}geom", ""), mask));
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/root/geom{v=a}mesh", ""), mask));
+    TEST_CHECK(!pathutil::IsPathInPopulationMask(Path("/root{v=a}lights", ""), mask));
+
+    // empty mask = everything
+    TEST_CHECK(pathutil::IsPathInPopulationMask(Path("/other", ""), {}));
+  }
 }
@@ -0,0 +1,215 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <set>
+#include <string>
+
+#include "unit-population-mask.h"
+#include "prim-types.hh"
+#include "stage.hh"
+#include "tinyusdz.hh"
+
+using namespace tinyusdz;
+
+static const char *kMaskTestUSDA = R"(#usda 1.0
+(
+    doc = """{ braces in layer meta }"""
+)
+
+def Xform "A"
+{
+    def Xform "B" (
+        doc = "not a { block"
+    )
+    {
+        def Scope "C"
+        {
+        }
+    }
+
+    def Scope "D" (
+        doc = '}}} "'
+    )
+    {
+        # comment with braces } {
+        asset tex = @./dummy}.png@
+        string s = """
+        } multi-line {
+        """
+    }
+}
+
+def Xform "E"
+{
+    def Scope "F" {
+    }
+    # }
+}
+
+over "G"
+{
+}
+)";
+
+// Load a file in the source tree(e.g. `tests/usdc/variantSet-000.usdc`).
+static bool LoadMaskedFile(const std::string &filename,
+                           const std::vector<Path> &mask, Stage *stage) {
+  USDLoadOptions options;
+  options.population_mask = mask;
+
+  std::string warn, err;
+  bool ret = LoadUSDFromFile(std::string(TINYUSDZ_TEST_DATA_DIR) + "/" + filename,
+                             stage, &warn, &err, options);
+  if (!ret) {
+    std::cerr << err << "\n";
+  }
+  return ret;
+}
+
+// Names of Prims defined in the variants of the Prim at `path`.
+static std::set<std::string> VariantPrimNames(const Stage &stage,
+                                              const std::string &path) {
+  std::set<std::string> names;
+  auto prim = stage.GetPrimAtPath(Path(path, ""));
+  if (!prim) {
+    return names;
+  }
+  for (const auto &vs : prim.value()->variantSets()) {
+    for (const auto &variant : vs.second.variantSet) {
+      for (const auto &child : variant.second.primChildren()) {
+        names.insert(child.element_name());
+      }
+    }
+  }
+  return names;
+}
+
+static bool LoadMasked(const std::vector<Path> &mask, Stage *stage) {
+  USDLoadOptions options;
+  options.population_mask = mask;
+
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(
+      reinterpret_cast<const uint8_t *>(kMaskTestUSDA), strlen(kMaskTestUSDA),
+      "", stage, &warn, &err, options);
+  if (!ret) {
+    std::cerr << err << "\n";
+  }
+  return ret;
+}
+
+void population_mask_test(void) {
+
+  {
+    // No mask = load all
+    Stage stage;
+    TEST_CHECK(LoadMasked({}, &stage));
+    TEST_CHECK(stage.GetPrimAtPath(Path("/A/B/C", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/A/D", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/E/F", "")).has_value());
+  }
+
+  {
+    Stage stage;
+    TEST_CHECK(LoadMasked({Path("/A/B", "")}, &stage));
+
+    // ancestor and descendants of the mask
+    TEST_CHECK(stage.GetPrimAtPath(Path("/A", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/A/B", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/A/B/C", "")).has_value());
+
+    // siblings are skipped
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/A/D", "")).has_value());
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/E", "")).has_value());
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/G", "")).has_value());
+    TEST_CHECK(stage.root_prims().size() == 1);
+  }
+
+  {
+    Stage stage;
+    TEST_CHECK(LoadMasked({Path("/E/F", ""), Path("/A/D", "")}, &stage));
+
+    TEST_CHECK(stage.GetPrimAtPath(Path("/A/D", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/E/F", "")).has_value());
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/A/B", "")).has_value());
+    TEST_CHECK(stage.root_prims().size() == 2);
+  }
+
+  // USDC
+  {
+    Stage stage;
+    TEST_CHECK(LoadMaskedFile("models/cube.usdc", {}, &stage));
+    TEST_CHECK(stage.GetPrimAtPath(Path("/Camera/Camera", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/_materials/Material", "")).has_value());
+    TEST_CHECK(stage.root_prims().size() == 4);
+  }
+
+  {
+    Stage stage;
+    TEST_CHECK(LoadMaskedFile("models/cube.usdc", {Path("/Cube", "")}, &stage));
+
+    // mask and descendants
+    TEST_CHECK(stage.GetPrimAtPath(Path("/Cube", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/Cube/Cube", "")).has_value());
+
+    // siblings are skipped
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/Camera", "")).has_value());
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/Light", "")).has_value());
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/_materials", "")).has_value());
+    TEST_CHECK(stage.root_prims().size() == 1);
+  }
+
+  {
+    Stage stage;
+    TEST_CHECK(LoadMaskedFile("models/cube.usdc",
+                              {Path("/_materials/Material/previewShader", ""),
+                               Path("/Light/Light", "")},
+                              &stage));
+
+    // ancestors of the mask
+    TEST_CHECK(stage.GetPrimAtPath(Path("/_materials", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/_materials/Material", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/_materials/Material/previewShader", "")).has_value());
+    TEST_CHECK(stage.GetPrimAtPath(Path("/Light/Light", "")).has_value());
+    TEST_CHECK(!stage.GetPrimAtPath(Path("/Cube", "")).has_value());
+    TEST_CHECK(stage.root_prims().size() == 2);
+  }
+
+  // Prims in variants are masked by their namespace path. Same expectations
+  // for USDA and USDC.
+  for (const char *filename :
+       {"tests/usda/variantSet-000.usda", "tests/usdc/variantSet-000.usdc"}) {
+    TEST_CASE(filename);
+    {
+      Stage stage;
+      TEST_CHECK(LoadMaskedFile(filename, {}, &stage));
+      TEST_CHECK(VariantPrimNames(stage, "/Implicits").size() == 5);
+    }
+
+    {
+      Stage stage;
+      TEST_CHECK(LoadMaskedFile(filename, {Path("/Implicits", "")}, &stage));
+      TEST_CHECK(VariantPrimNames(stage, "/Implicits").size() == 5);
+    }
+
+    {
+      Stage stage;
+      TEST_CHECK(
+          LoadMaskedFile(filename, {Path("/Implicits/Ball", "")}, &stage));
+      TEST_CHECK(stage.GetPrimAtPath(Path("/Implicits", "")).has_value());
+      std::set<std::string> names = VariantPrimNames(stage, "/Implicits");
+      TEST_CHECK(names.size() == 1);
+      TEST_CHECK(names.count("Ball") == 1);
+    }
+
+    {
+      Stage stage;
+      TEST_CHECK(LoadMaskedFile(filename, {Path("/Other", "")}, &stage));
+      TEST_CHECK(!stage.GetPrimAtPath(Path("/Implicits", "")).has_value());
+    }
+  }
+}
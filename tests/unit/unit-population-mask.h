@@ -0,0 +1,3 @@
+#pragma once
+
+void population_mask_test(void);
@@ -0,0 +1,238 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <string>
+#include <vector>
+
+#include "unit-progressive-loader.h"
+#include "tydra/progressive-loader.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+const char *kTwoMeshesUSDA = R"(#usda 1.0
+
+def Xform "root"
+{
+    def Mesh "tri"
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+    }
+
+    def Mesh "quad"
+    {
+        int[] faceVertexCounts = [4]
+        int[] faceVertexIndices = [0, 1, 2, 3]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)]
+    }
+}
+)";
+
+// The texture of "textured" is loaded between the mesh events of "first" and
+// "textured".
+const char *kTexturedMeshesUSDA = R"(#usda 1.0
+
+def Xform "root"
+{
+    def Mesh "first"
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+    }
+
+    def Mesh "textured" (
+        prepend apiSchemas = ["MaterialBindingAPI"]
+    )
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+        rel material:binding = </root/mat>
+    }
+
+    def Mesh "last"
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+    }
+
+    def Material "mat"
+    {
+        token outputs:surface.connect = </root/mat/pbr.outputs:surface>
+
+        def Shader "pbr"
+        {
+            uniform token info:id = "UsdPreviewSurface"
+            color3f inputs:diffuseColor.connect = </root/mat/tex.outputs:rgb>
+            token outputs:surface
+        }
+
+        def Shader "tex"
+        {
+            uniform token info:id = "UsdUVTexture"
+            asset inputs:file = @dummy.png@
+            token inputs:sourceColorSpace = "raw"
+            float3 outputs:rgb
+        }
+    }
+}
+)";
+
+// Returns 1x1 RGBA image and cancels the loader passed as `userdata`.
+bool CancellingTextureLoader(const value::AssetPath &assetPath,
+                             const AssetInfo &assetInfo,
+                             const AssetResolutionResolver &assetResolver,
+                             TextureImage *imageOut,
+                             std::vector<uint8_t> *imageData, void *userdata,
+                             std::string *warn, std::string *err) {
+  (void)assetPath;
+  (void)assetInfo;
+  (void)assetResolver;
+  (void)warn;
+  (void)err;
+
+  imageOut->width = 1;
+  imageOut->height = 1;
+  imageOut->channels = 4;
+  imageOut->assetTexelComponentType = ComponentType::UInt8;
+  (*imageData) = {1, 2, 3, 4};
+
+  reinterpret_cast<ProgressiveLoader *>(userdata)->Cancel();
+
+  return true;
+}
+
+std::vector<uint8_t> ToBytes(const std::string &s) {
+  return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+}  // namespace
+
+void progressive_loader_test(void) {
+  // Synchronous and worker thread paths emit the same events.
+  for (int use_thread = 0; use_thread < 2; use_thread++) {
+    ProgressiveLoaderConfig config;
+    config.use_worker_thread = bool(use_thread);
+
+    ProgressiveLoader loader;
+    std::string err;
+    TEST_CHECK(loader.Start(ToBytes(kTwoMeshesUSDA), "test.usda", config, &err));
+    TEST_CHECK(loader.Wait());
+    TEST_MSG("%s", loader.GetError().c_str());
+    TEST_CHECK(loader.IsFinished());
+
+    // Second Start fails.
+    TEST_CHECK(!loader.Start(ToBytes(kTwoMeshesUSDA), "test.usda", config, &err));
+
+    ProgressiveLoaderProgress progress = loader.GetProgress();
+    TEST_CHECK(progress.state == ProgressiveLoaderState::Done);
+    TEST_CHECK(progress.input_bytes == std::string(kTwoMeshesUSDA).size());
+    TEST_CHECK(progress.num_meshes_total == 2);
+    TEST_CHECK(progress.num_meshes_converted == 2);
+    TEST_CHECK(progress.num_images_loaded == 0);
+
+    std::vector<ProgressiveLoaderEvent> events;
+    ProgressiveLoaderEvent ev;
+    while (loader.PollEvent(&ev)) {
+      events.push_back(ev);
+    }
+    TEST_CHECK(events.size() == 2);
+
+    const RenderScene &scene = loader.GetRenderScene();
+    TEST_CHECK(scene.meshes.size() == 2);
+    for (size_t i = 0; i < events.size(); i++) {
+      TEST_CHECK(events[i].type == ProgressiveLoaderEvent::Type::Mesh);
+      TEST_CHECK(events[i].id == i);
+      if (events[i].id < scene.meshes.size()) {
+        const RenderMesh &m = scene.meshes[size_t(events[i].id)];
+        // Not a copy.
+        TEST_CHECK(events[i].mesh == &m);
+      }
+    }
+  }
+
+  // Cancel before the conversion.
+  {
+    ProgressiveLoaderConfig config;
+    config.use_worker_thread = false;
+
+    ProgressiveLoader loader;
+    loader.Cancel();
+    std::string err;
+    TEST_CHECK(loader.Start(ToBytes(kTwoMeshesUSDA), "test.usda", config, &err));
+    TEST_CHECK(!loader.Wait());
+    TEST_CHECK(loader.GetProgress().state == ProgressiveLoaderState::Cancelled);
+    ProgressiveLoaderEvent ev;
+    TEST_CHECK(!loader.PollEvent(&ev));
+  }
+
+  // Cancel in the middle of the conversion. Events emitted before the
+  // cancellation are still valid.
+  for (int use_thread = 0; use_thread < 2; use_thread++) {
+    ProgressiveLoader loader;
+
+    ProgressiveLoaderConfig config;
+    config.use_worker_thread = bool(use_thread);
+    config.material_config.texture_image_loader_function =
+        CancellingTextureLoader;
+    config.material_config.texture_image_loader_function_userdata = &loader;
+
+    std::string err;
+    TEST_CHECK(
+        loader.Start(ToBytes(kTexturedMeshesUSDA), "test.usda", config, &err));
+    TEST_CHECK(!loader.Wait());
+
+    ProgressiveLoaderProgress progress = loader.GetProgress();
+    TEST_CHECK(progress.state == ProgressiveLoaderState::Cancelled);
+    TEST_MSG("state = %s", to_string(progress.state).c_str());
+    TEST_CHECK(progress.num_meshes_total == 3);
+    TEST_CHECK(progress.num_meshes_converted == 1);
+    TEST_CHECK(progress.num_images_loaded == 1);
+
+    std::vector<ProgressiveLoaderEvent> events;
+    ProgressiveLoaderEvent ev;
+    while (loader.PollEvent(&ev)) {
+      events.push_back(ev);
+    }
+    TEST_CHECK(events.size() == 2);
+    if (events.size() == 2) {
+      TEST_CHECK(events[0].type == ProgressiveLoaderEvent::Type::Mesh);
+      TEST_CHECK(events[0].mesh != nullptr);
+      if (events[0].mesh) {
+        TEST_CHECK(events[0].mesh->abs_path == "/root/first");
+        TEST_CHECK(events[0].mesh->points.size() == 3);
+      }
+
+      TEST_CHECK(events[1].type == ProgressiveLoaderEvent::Type::TextureImage);
+      TEST_CHECK(events[1].image.width == 1);
+      TEST_CHECK(events[1].texels != nullptr);
+      TEST_CHECK(events[1].texels_size > 0);
+    }
+
+    // The conversion did not finish.
+    TEST_CHECK(loader.GetRenderScene().meshes.empty());
+  }
+
+  // Parse error.
+  {
+    ProgressiveLoaderConfig config;
+
+    ProgressiveLoader loader;
+    std::string err;
+    TEST_CHECK(loader.Start(ToBytes("This is not a USD file."),
+                            "broken.usd", config, &err));
+    TEST_CHECK(!loader.Wait());
+    TEST_CHECK(loader.GetProgress().state == ProgressiveLoaderState::Failed);
+    TEST_CHECK(!loader.GetError().empty());
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void progressive_loader_test(void);
@@ -0,0 +1,251 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cmath>
+#include <vector>
+
+#include "unit-skinning.h"
+#include "tydra/skinning.hh"
+#include "xform.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+value::matrix4d Translate(double x, double y, double z) {
+  value::matrix4d m = value::matrix4d::identity();
+  m.m[3][0] = x;
+  m.m[3][1] = y;
+  m.m[3][2] = z;
+  return m;
+}
+
+bool Near(const vec3 &a, float x, float y, float z, float eps = 1e-4f) {
+  return (std::fabs(a[0] - x) < eps) && (std::fabs(a[1] - y) < eps) &&
+         (std::fabs(a[2] - z) < eps);
+}
+
+// Joint `a`(id 0) at origin, joint `a/b`(id 1) at (0, 1, 0).
+// `a` rotates 90 degree around Z axis from time 0 to 10.
+RenderScene MakeSkelScene() {
+  RenderScene scene;
+
+  SkelHierarchy skel;
+  skel.abs_path = "/skel";
+  skel.root_node.joint_path = "a";
+  skel.root_node.joint_id = 0;
+
+  SkelNode b;
+  b.joint_path = "a/b";
+  b.joint_id = 1;
+  b.bind_transform = Translate(0.0, 1.0, 0.0);
+  b.rest_transform = Translate(0.0, 1.0, 0.0);
+  skel.root_node.children.push_back(b);
+  skel.anim_id = 0;
+  scene.skeletons.push_back(skel);
+
+  Animation anim;
+  AnimationChannel ch(AnimationChannel::ChannelType::Rotation);
+  const float s = std::sqrt(0.5f);
+  ch.rotations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f, 1.0f}});
+  ch.rotations.samples.push_back({10.0f, {0.0f, 0.0f, s, s}});
+  anim.channels_map["a"][AnimationChannel::ChannelType::Rotation] = ch;
+  scene.animations.push_back(anim);
+
+  RenderMesh mesh;
+  mesh.abs_path = "/mesh";
+  mesh.points = {{1.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+  mesh.usdFaceVertexIndices = {0, 1, 2};
+  mesh.usdFaceVertexCounts = {3};
+  mesh.skel_id = 0;
+  mesh.joint_and_weights.elementSize = 2;
+  mesh.joint_and_weights.jointIndices = {0, 1, 1, 0, 0, 1};
+  // weights are not normalized for the first point.
+  mesh.joint_and_weights.jointWeights = {2.0f, 0.0f, 1.0f, 0.0f, 0.5f, 0.5f};
+
+  std::vector<vec3> normals = {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+  mesh.normals.format = VertexAttributeFormat::Vec3;
+  mesh.normals.variability = VertexVariability::Vertex;
+  mesh.normals.set_buffer(reinterpret_cast<const uint8_t *>(normals.data()), normals.size() * sizeof(vec3));
+
+  scene.meshes.push_back(mesh);
+
+  return scene;
+}
+
+void skinning_palette_test() {
+  RenderScene scene = MakeSkelScene();
+
+  SkinningPalette palette;
+  std::string err;
+  TEST_CHECK(ComputeSkinningPalette(scene.skeletons[0], &scene.animations[0], 10.0, &palette, &err));
+  TEST_MSG("%s", err.c_str());
+  TEST_CHECK(palette.joint_transforms.size() == 2);
+  TEST_CHECK(palette.skinning_transforms.size() == 2);
+
+  // `a/b` in skeleton space: (0, 1, 0) rotated by 90 degree => (-1, 0, 0)
+  TEST_CHECK(std::fabs(palette.joint_transforms[1].m[3][0] - (-1.0)) < 1e-5);
+  TEST_CHECK(std::fabs(palette.joint_transforms[1].m[3][1]) < 1e-5);
+
+  // No animation = rest pose = bind pose.
+  TEST_CHECK(ComputeSkinningPalette(scene.skeletons[0], nullptr, 10.0, &palette, &err));
+  TEST_CHECK(is_identity(palette.skinning_transforms[0]));
+  TEST_CHECK(is_identity(palette.skinning_transforms[1]));
+}
+
+void skinning_mesh_test(SkinningMethod method) {
+  RenderScene scene = MakeSkelScene();
+
+  SkinningConfig config;
+  config.method = method;
+  config.grain_size = 1;
+  SkinningEngine engine(config);
+
+  SkinnedMesh out;
+  TEST_CHECK(engine.SkinMesh(scene, 0, 10.0, &out));
+  TEST_MSG("%s", engine.GetError().c_str());
+  TEST_CHECK(out.points.size() == 3);
+  TEST_CHECK(out.normals.size() == 3);
+
+  TEST_CHECK(Near(out.points[0], 0.0f, 1.0f, 0.0f));
+  TEST_CHECK(Near(out.points[1], -2.0f, 0.0f, 0.0f));
+  // Both joints move (0, 1, 0) to (-1, 0, 0)
+  TEST_CHECK(Near(out.points[2], -1.0f, 0.0f, 0.0f));
+
+  TEST_CHECK(Near(out.normals[0], 0.0f, 1.0f, 0.0f));
+  TEST_CHECK(Near(out.normals[2], 0.0f, 0.0f, 1.0f));
+
+  // Halfway(slerp): 45 degree
+  TEST_CHECK(engine.SkinMesh(scene, 0, 5.0, &out));
+  const float s = std::sqrt(0.5f);
+  TEST_CHECK(Near(out.points[0], s, s, 0.0f));
+
+  // Before the first sample: clamped.
+  TEST_CHECK(engine.SkinMesh(scene, 0, -1.0, &out));
+  TEST_CHECK(Near(out.points[0], 1.0f, 0.0f, 0.0f));
+
+  // geomBindTransform is applied before skinning.
+  scene.meshes[0].joint_and_weights.geomBindTransform = Translate(0.0, 0.0, 3.0);
+  TEST_CHECK(engine.SkinMesh(scene, 0, 10.0, &out));
+  TEST_CHECK(Near(out.points[0], 0.0f, 1.0f, 3.0f));
+}
+
+void skinning_cache_test() {
+  RenderScene scene = MakeSkelScene();
+
+  SkinningConfig config;
+  config.max_cached_palettes = 2;
+  SkinningEngine engine(config);
+
+  SkinnedMesh out;
+  TEST_CHECK(engine.SkinMesh(scene, 0, 1.0, &out));
+  TEST_CHECK(engine.SkinMesh(scene, 0, 1.0, &out));
+  TEST_CHECK(engine.NumCachedPalettes() == 1);
+
+  TEST_CHECK(engine.SkinMesh(scene, 0, 2.0, &out));
+  TEST_CHECK(engine.SkinMesh(scene, 0, 3.0, &out));
+  TEST_CHECK(engine.NumCachedPalettes() == 2);
+
+  engine.ClearCache();
+  TEST_CHECK(engine.NumCachedPalettes() == 0);
+
+  // Invalid mesh
+  TEST_CHECK(!engine.SkinMesh(scene, 1, 1.0, &out));
+  scene.meshes[0].joint_and_weights.jointWeights.pop_back();
+  TEST_CHECK(!engine.SkinMesh(scene, 0, 1.0, &out));
+}
+
+// Only some of T/R/S channels are animated. The others are taken from the
+// rest transform.
+void skinning_partial_animation_test() {
+  const float s = std::sqrt(0.5f);
+  value::quatf q;
+  q.imag = {0.0f, 0.0f, s};
+  q.real = s;
+  const value::matrix4d rot = to_matrix(q);  // 90 degree around Z
+
+  // rest = scale(2) * rot * translate(1, 2, 3)
+  value::matrix4d rest = rot;
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      rest.m[i][j] *= 2.0;
+    }
+  }
+  rest.m[3][0] = 1.0;
+  rest.m[3][1] = 2.0;
+  rest.m[3][2] = 3.0;
+
+  SkelHierarchy skel;
+  skel.root_node.joint_path = "a";
+  skel.root_node.joint_id = 0;
+  skel.root_node.rest_transform = rest;
+
+  auto near3x3 = [](const value::matrix4d &m, const value::matrix4d &ref,
+                    double scale) {
+    bool ok = true;
+    for (size_t i = 0; i < 3; i++) {
+      for (size_t j = 0; j < 3; j++) {
+        ok &= std::fabs(m.m[i][j] - scale * ref.m[i][j]) < 1e-5;
+      }
+    }
+    return ok;
+  };
+
+  SkinningPalette palette;
+  std::string err;
+
+  // Translation only: rest rotation and scale are kept.
+  {
+    Animation anim;
+    AnimationChannel ch(AnimationChannel::ChannelType::Translation);
+    ch.translations.samples.push_back({0.0f, {5.0f, 0.0f, 0.0f}});
+    anim.channels_map["a"][AnimationChannel::ChannelType::Translation] = ch;
+
+    TEST_CHECK(ComputeSkinningPalette(skel, &anim, 0.0, &palette, &err));
+    const value::matrix4d &m = palette.joint_transforms[0];
+    TEST_CHECK(near3x3(m, rot, 2.0));
+    TEST_CHECK(std::fabs(m.m[3][0] - 5.0) < 1e-5);
+    TEST_CHECK(std::fabs(m.m[3][1]) < 1e-5);
+  }
+
+  // Rotation only: rest scale and translation are kept.
+  {
+    Animation anim;
+    AnimationChannel ch(AnimationChannel::ChannelType::Rotation);
+    ch.rotations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f, 1.0f}});
+    anim.channels_map["a"][AnimationChannel::ChannelType::Rotation] = ch;
+
+    TEST_CHECK(ComputeSkinningPalette(skel, &anim, 0.0, &palette, &err));
+    const value::matrix4d &m = palette.joint_transforms[0];
+    TEST_CHECK(near3x3(m, value::matrix4d::identity(), 2.0));
+    TEST_CHECK(std::fabs(m.m[3][1] - 2.0) < 1e-5);
+  }
+
+  // Scale only: rest rotation and translation are kept.
+  {
+    Animation anim;
+    AnimationChannel ch(AnimationChannel::ChannelType::Scale);
+    ch.scales.samples.push_back({0.0f, {3.0f, 3.0f, 3.0f}});
+    anim.channels_map["a"][AnimationChannel::ChannelType::Scale] = ch;
+
+    TEST_CHECK(ComputeSkinningPalette(skel, &anim, 0.0, &palette, &err));
+    const value::matrix4d &m = palette.joint_transforms[0];
+    TEST_CHECK(near3x3(m, rot, 3.0));
+    TEST_CHECK(std::fabs(m.m[3][2] - 3.0) < 1e-5);
+  }
+}
+
+}  // namespace
+
+void skinning_test(void) {
+  skinning_palette_test();
+  skinning_partial_animation_test();
+  skinning_mesh_test(SkinningMethod::LinearBlend);
+  skinning_mesh_test(SkinningMethod::DualQuaternion);
+  skinning_cache_test();
+}
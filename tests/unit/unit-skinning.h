@@ -0,0 +1,3 @@
+#pragma once
+
+void skinning_test(void);
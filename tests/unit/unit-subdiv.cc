@@ -0,0 +1,308 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "unit-subdiv.h"
+#include "subdiv.hh"
+
+#if defined(TINYUSDZ_WITH_TYDRA)
+#include "tinyusdz.hh"
+#include "tydra/render-data.hh"
+#endif
+
+using namespace tinyusdz;
+
+namespace {
+
+// Unit cube centered at origin. 8 vertices, 6 quads.
+const std::vector<float> kCubePoints = {
+    -0.5f, -0.5f, 0.5f,  0.5f, -0.5f, 0.5f,  -0.5f, 0.5f, 0.5f,
+    0.5f,  0.5f,  0.5f,  -0.5f, 0.5f, -0.5f, 0.5f,  0.5f, -0.5f,
+    -0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f};
+const std::vector<uint32_t> kCubeCounts = {4, 4, 4, 4, 4, 4};
+const std::vector<uint32_t> kCubeIndices = {0, 1, 3, 2, 2, 3, 5, 4,
+                                            4, 5, 7, 6, 6, 7, 1, 0,
+                                            1, 7, 5, 3, 6, 0, 2, 4};
+
+#if defined(TINYUSDZ_WITH_TYDRA)
+const char *kCubeUSDA = R"(#usda 1.0
+def Mesh "cube" {
+  int[] faceVertexCounts = [4, 4, 4, 4, 4, 4]
+  int[] faceVertexIndices = [0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4]
+  point3f[] points = [(-0.5, -0.5, 0.5), (0.5, -0.5, 0.5), (-0.5, 0.5, 0.5), (0.5, 0.5, 0.5), (-0.5, 0.5, -0.5), (0.5, 0.5, -0.5), (-0.5, -0.5, -0.5), (0.5, -0.5, -0.5)]
+  color3f[] primvars:displayColor = [(0, 0, 0), (1, 0, 0), (2, 0, 0), (3, 0, 0), (4, 0, 0), (5, 0, 0)] (
+    interpolation = "uniform"
+  )
+  texCoord2f[] primvars:st = [(0, 0), (1, 0), (1, 1), (0, 1), (0, 0), (1, 0), (1, 1), (0, 1), (0, 0), (1, 0), (1, 1), (0, 1), (0, 0), (1, 0), (1, 1), (0, 1), (0, 0), (1, 0), (1, 1), (0, 1), (0, 0), (1, 0), (1, 1), (0, 1)] (
+    interpolation = "faceVarying"
+  )
+}
+)";
+#endif
+
+}  // namespace
+
+void subdiv_test(void) {
+  // Catmull-Clark cube.
+  {
+    Subdivider subdivider;
+    SubdividerOptions options;
+    options.level = 1;
+
+    std::string err;
+    TEST_CHECK(subdivider.Setup(options, 8, kCubeCounts, kCubeIndices, &err));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(subdivider.valid());
+    TEST_CHECK(subdivider.IsSameTopology(options, 8, kCubeCounts, kCubeIndices));
+
+    // 8 vertices + 12 edge points + 6 face points.
+    TEST_CHECK(subdivider.num_control_vertices() == 8);
+    TEST_CHECK(subdivider.num_refined_vertices() == 26);
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 24);
+    TEST_CHECK(subdivider.refined_face_vertex_indices().size() == 24 * 4);
+
+    // Each control face is split into 4 faces.
+    std::vector<int> num_children(6, 0);
+    for (uint32_t parent : subdivider.refined_face_parents()) {
+      if (parent < 6) {
+        num_children[parent]++;
+      }
+    }
+    for (int n : num_children) {
+      TEST_CHECK(n == 4);
+    }
+
+    std::vector<float> refined;
+    TEST_CHECK(subdivider.RefineVertex(kCubePoints.data(), 3, &refined));
+    TEST_CHECK(refined.size() == 26 * 3);
+
+    // Symmetric cube: the centroid stays at the origin and points shrink
+    // toward it.
+    double c[3] = {0.0, 0.0, 0.0};
+    bool inside = true;
+    for (size_t i = 0; i < 26; i++) {
+      for (size_t k = 0; k < 3; k++) {
+        c[k] += double(refined[3 * i + k]);
+        inside &= (std::fabs(refined[3 * i + k]) <= 0.5f);
+      }
+    }
+    TEST_CHECK(inside);
+    for (size_t k = 0; k < 3; k++) {
+      TEST_CHECK(std::fabs(c[k]) < 1e-5);
+    }
+
+    // Face-varying: a value constant in each control face is inherited by
+    // its refined faces.
+    std::vector<float> fv(kCubeIndices.size());
+    for (size_t f = 0; f < 6; f++) {
+      for (size_t v = 0; v < 4; v++) {
+        fv[4 * f + v] = float(f);
+      }
+    }
+    std::vector<float> refined_fv;
+    TEST_CHECK(subdivider.RefineFaceVarying(fv.data(), 1, &refined_fv));
+    TEST_CHECK(refined_fv.size() == 24 * 4);
+    if (refined_fv.size() == 24 * 4) {
+      bool ok = true;
+      const std::vector<uint32_t> &parents = subdivider.refined_face_parents();
+      for (size_t f = 0; f < 24; f++) {
+        for (size_t v = 0; v < 4; v++) {
+          ok &= (std::fabs(refined_fv[4 * f + v] - float(parents[f])) < 1e-6f);
+        }
+      }
+      TEST_CHECK(ok);
+    }
+
+    // Level 2
+    options.level = 2;
+    TEST_CHECK(
+        !subdivider.IsSameTopology(options, 8, kCubeCounts, kCubeIndices));
+    TEST_CHECK(subdivider.Setup(options, 8, kCubeCounts, kCubeIndices, &err));
+    TEST_CHECK(subdivider.num_refined_vertices() == 98);
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 96);
+  }
+
+  // Bilinear quad: the face point is the center of the quad.
+  {
+    const std::vector<float> points = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                                       1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    Subdivider subdivider;
+    SubdividerOptions options;
+    options.scheme = SubdivisionScheme::Bilinear;
+
+    std::string err;
+    TEST_CHECK(subdivider.Setup(options, 4, {4}, {0, 1, 2, 3}, &err));
+    TEST_CHECK(subdivider.num_refined_vertices() == 9);
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 4);
+
+    std::vector<float> refined;
+    TEST_CHECK(subdivider.RefineVertex(points.data(), 3, &refined));
+    bool found_center = false;
+    for (size_t i = 0; i + 2 < refined.size(); i += 3) {
+      if ((std::fabs(refined[i] - 0.5f) < 1e-6f) &&
+          (std::fabs(refined[i + 1] - 0.5f) < 1e-6f)) {
+        found_center = true;
+      }
+    }
+    TEST_CHECK(found_center);
+  }
+
+  // Loop: one triangle is split into 4 triangles.
+  {
+    Subdivider subdivider;
+    SubdividerOptions options;
+    options.scheme = SubdivisionScheme::Loop;
+
+    std::string err;
+    TEST_CHECK(subdivider.Setup(options, 3, {3}, {0, 1, 2}, &err));
+    TEST_CHECK(subdivider.num_refined_vertices() == 6);
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 4);
+    TEST_CHECK(subdivider.refined_face_vertex_counts()[0] == 3);
+  }
+
+  // Boundary interpolation of 3x3 quad grid.
+  {
+    std::vector<float> points;
+    for (int y = 0; y < 4; y++) {
+      for (int x = 0; x < 4; x++) {
+        points.push_back(float(x));
+        points.push_back(float(y));
+        points.push_back(0.0f);
+      }
+    }
+    std::vector<uint32_t> counts(9, 4);
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < 3; y++) {
+      for (uint32_t x = 0; x < 3; x++) {
+        uint32_t v = y * 4 + x;
+        indices.insert(indices.end(), {v, v + 1, v + 5, v + 4});
+      }
+    }
+
+    auto has_origin = [](const std::vector<float> &refined) {
+      for (size_t i = 0; i + 2 < refined.size(); i += 3) {
+        if ((std::fabs(refined[i]) < 1e-6f) &&
+            (std::fabs(refined[i + 1]) < 1e-6f)) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    Subdivider subdivider;
+    SubdividerOptions options;
+    std::string err;
+    std::vector<float> refined;
+
+    // edgeAndCorner: corners are kept.
+    TEST_CHECK(subdivider.Setup(options, 16, counts, indices, &err));
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 36);
+    TEST_CHECK(subdivider.RefineVertex(points.data(), 3, &refined));
+    TEST_CHECK(has_origin(refined));
+
+    // edgeOnly: corners are smoothed.
+    options.boundary_interpolation = BoundaryInterpolation::EdgeOnly;
+    TEST_CHECK(!subdivider.IsSameTopology(options, 16, counts, indices));
+    TEST_CHECK(subdivider.Setup(options, 16, counts, indices, &err));
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 36);
+    TEST_CHECK(subdivider.RefineVertex(points.data(), 3, &refined));
+    TEST_CHECK(!has_origin(refined));
+
+    // none: boundary faces are holes. Only the center face is refined.
+    options.boundary_interpolation = BoundaryInterpolation::None;
+    TEST_CHECK(!subdivider.IsSameTopology(options, 16, counts, indices));
+    TEST_CHECK(subdivider.Setup(options, 16, counts, indices, &err));
+    TEST_CHECK(subdivider.refined_face_vertex_counts().size() == 4);
+    TEST_CHECK(subdivider.refined_face_parents().size() == 4);
+    for (uint32_t parent : subdivider.refined_face_parents()) {
+      TEST_CHECK(parent == 4);
+    }
+  }
+
+  // Invalid topology
+  {
+    Subdivider subdivider;
+    SubdividerOptions options;
+    std::string err;
+    TEST_CHECK(!subdivider.Setup(options, 3, {4}, {0, 1, 2, 3}, &err));
+    TEST_CHECK(!subdivider.valid());
+  }
+
+#if defined(TINYUSDZ_WITH_TYDRA)
+  // RenderMesh conversion with `subdivision_level`.
+  {
+    Stage stage;
+    std::string warn, err;
+    bool ret = LoadUSDAFromMemory(
+        reinterpret_cast<const uint8_t *>(kCubeUSDA), strlen(kCubeUSDA), "",
+        &stage, &warn, &err);
+    TEST_CHECK(ret == true);
+    TEST_MSG("%s", err.c_str());
+    if (!ret) {
+      return;
+    }
+
+    tydra::RenderSceneConverterEnv env(stage);
+    env.mesh_config.subdivision_level = 1;
+    env.mesh_config.triangulate = false;
+    env.mesh_config.build_vertex_indices = false;
+    env.mesh_config.compute_normals = false;
+    env.mesh_config.compute_tangents_and_binormals = false;
+
+    tydra::RenderSceneConverter converter;
+    tydra::RenderScene scene;
+    ret = converter.ConvertToRenderScene(env, &scene);
+    TEST_CHECK(ret == true);
+    TEST_MSG("%s", converter.GetError().c_str());
+    if (!ret || scene.meshes.size() != 1) {
+      return;
+    }
+
+    const tydra::RenderMesh &mesh = scene.meshes[0];
+    TEST_CHECK(mesh.points.size() == 26);
+    TEST_CHECK(mesh.usdFaceVertexCounts.size() == 24);
+    TEST_CHECK(mesh.usdFaceVertexIndices.size() == 24 * 4);
+
+    // facevarying texcoords: one value per refined face-vertex.
+    TEST_CHECK(mesh.texcoords.count(0) == 1);
+    if (mesh.texcoords.count(0)) {
+      const tydra::VertexAttribute &st = mesh.texcoords.at(0);
+      TEST_CHECK(st.is_facevarying());
+      TEST_CHECK(st.vertex_count() == 24 * 4);
+    }
+
+    // uniform displayColor is converted to facevarying before the
+    // subdivision. Refined faces take the value of the parent face.
+    TEST_CHECK(mesh.vertex_colors.is_facevarying());
+    TEST_CHECK(mesh.vertex_colors.vertex_count() == 24 * 4);
+    if (mesh.vertex_colors.vertex_count() == 24 * 4) {
+      const float *colors =
+          reinterpret_cast<const float *>(mesh.vertex_colors.get_data().data());
+      std::vector<int> num_children(6, 0);
+      bool ok = true;
+      for (size_t f = 0; f < 24; f++) {
+        float parent = colors[3 * (4 * f)];
+        for (size_t v = 1; v < 4; v++) {
+          ok &= (std::fabs(colors[3 * (4 * f + v)] - parent) < 1e-6f);
+        }
+        int p = int(std::lround(parent));
+        if ((p >= 0) && (p < 6)) {
+          num_children[size_t(p)]++;
+        }
+      }
+      TEST_CHECK(ok);
+      for (int n : num_children) {
+        TEST_CHECK(n == 4);
+      }
+    }
+  }
+#endif
+}
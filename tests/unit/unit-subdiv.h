@@ -0,0 +1,3 @@
+#pragma once
+
+void subdiv_test(void);
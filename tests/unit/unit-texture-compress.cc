@@ -0,0 +1,225 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "unit-texture-compress.h"
+#include "tydra/texture-compress.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+void DecodeRGB565(uint16_t v, int rgb[3]) {
+  int r = (v >> 11) & 31;
+  int g = (v >> 5) & 63;
+  int b = v & 31;
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Decode BC1 block(4-color mode only) to RGB.
+void DecodeBC1(const uint8_t *blk, int rgb[16][3]) {
+  uint16_t c0 = uint16_t(blk[0] | (blk[1] << 8));
+  uint16_t c1 = uint16_t(blk[2] | (blk[3] << 8));
+  int palette[4][3];
+  DecodeRGB565(c0, palette[0]);
+  DecodeRGB565(c1, palette[1]);
+  for (int c = 0; c < 3; c++) {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+  uint32_t bits = uint32_t(blk[4]) | (uint32_t(blk[5]) << 8) |
+                  (uint32_t(blk[6]) << 16) | (uint32_t(blk[7]) << 24);
+  for (int i = 0; i < 16; i++) {
+    int idx = (bits >> (2 * i)) & 3;
+    for (int c = 0; c < 3; c++) {
+      rgb[i][c] = palette[idx][c];
+    }
+  }
+}
+
+void DecodeBC4(const uint8_t *blk, int v[16]) {
+  int a0 = blk[0];
+  int a1 = blk[1];
+  int palette[8];
+  palette[0] = a0;
+  palette[1] = a1;
+  for (int k = 2; k < 8; k++) {
+    palette[k] = (a0 > a1) ? ((8 - k) * a0 + (k - 1) * a1) / 7 : 0;
+  }
+  uint64_t bits = 0;
+  for (int i = 0; i < 6; i++) {
+    bits |= uint64_t(blk[2 + i]) << (8 * i);
+  }
+  for (int i = 0; i < 16; i++) {
+    v[i] = palette[(bits >> (3 * i)) & 7];
+  }
+}
+
+uint32_t GetBits(const uint8_t *blk, uint32_t *pos, uint32_t n) {
+  uint32_t v = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t p = (*pos) + i;
+    v |= uint32_t((blk[p >> 3] >> (p & 7)) & 1) << i;
+  }
+  (*pos) += n;
+  return v;
+}
+
+// Decode BC7 mode 6 block. Returns false when the block is not mode 6.
+bool DecodeBC7Mode6(const uint8_t *blk, int rgba[16][4]) {
+  const int kWeights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                            34, 38, 43, 47, 51, 55, 60, 64};
+  uint32_t pos = 0;
+  if (GetBits(blk, &pos, 7) != (1u << 6)) {
+    return false;
+  }
+  int e[2][4];
+  for (int c = 0; c < 4; c++) {
+    e[0][c] = int(GetBits(blk, &pos, 7)) << 1;
+    e[1][c] = int(GetBits(blk, &pos, 7)) << 1;
+  }
+  int p0 = int(GetBits(blk, &pos, 1));
+  int p1 = int(GetBits(blk, &pos, 1));
+  for (int c = 0; c < 4; c++) {
+    e[0][c] |= p0;
+    e[1][c] |= p1;
+  }
+  for (int i = 0; i < 16; i++) {
+    int w = kWeights[GetBits(blk, &pos, (i == 0) ? 3 : 4)];
+    for (int c = 0; c < 4; c++) {
+      rgba[i][c] = ((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void texture_compress_test(void) {
+  TEST_CHECK(GetCompressedBlockBytes(TextureCompressionFormat::BC1) == 8);
+  TEST_CHECK(GetCompressedBlockBytes(TextureCompressionFormat::BC7) == 16);
+  TEST_CHECK(GetCompressedImageBytes(TextureCompressionFormat::BC1, 5, 3) == 16);
+
+  // 8x8 RGBA gradient(colors in each block lie on a line)
+  const size_t w = 8;
+  const size_t h = 8;
+  std::vector<uint8_t> img(w * h * 4);
+  for (size_t y = 0; y < h; y++) {
+    for (size_t x = 0; x < w; x++) {
+      uint8_t *p = &img[(y * w + x) * 4];
+      p[0] = uint8_t(x * 32);
+      p[1] = uint8_t(x * 16 + y / 4 * 64);
+      p[2] = 128;
+      p[3] = uint8_t(255 - x * 16);
+    }
+  }
+
+  // BC1
+  {
+    std::vector<uint8_t> dst;
+    std::string err;
+    TEST_CHECK(CompressImage(img.data(), w, h, 4, TextureCompressionFormat::BC1, &dst, &err, 2));
+    TEST_CHECK(dst.size() == 4 * 8);
+
+    int max_err = 0;
+    for (size_t by = 0; by < 2; by++) {
+      for (size_t bx = 0; bx < 2; bx++) {
+        int rgb[16][3];
+        DecodeBC1(&dst[(by * 2 + bx) * 8], rgb);
+        for (size_t i = 0; i < 16; i++) {
+          const uint8_t *p = &img[((by * 4 + i / 4) * w + bx * 4 + i % 4) * 4];
+          for (int c = 0; c < 3; c++) {
+            max_err = (std::max)(max_err, std::abs(rgb[i][c] - int(p[c])));
+          }
+        }
+      }
+    }
+    TEST_CHECK(max_err <= 16);
+    TEST_MSG("BC1 max error %d", max_err);
+  }
+
+  // BC5
+  {
+    std::vector<uint8_t> dst;
+    std::string err;
+    TEST_CHECK(CompressImage(img.data(), w, h, 4, TextureCompressionFormat::BC5, &dst, &err));
+    TEST_CHECK(dst.size() == 4 * 16);
+
+    int r[16];
+    int g[16];
+    DecodeBC4(&dst[0], r);
+    DecodeBC4(&dst[8], g);
+    int max_err = 0;
+    for (size_t i = 0; i < 16; i++) {
+      const uint8_t *p = &img[((i / 4) * w + i % 4) * 4];
+      max_err = (std::max)(max_err, std::abs(r[i] - int(p[0])));
+      max_err = (std::max)(max_err, std::abs(g[i] - int(p[1])));
+    }
+    TEST_CHECK(max_err <= 8);
+    TEST_MSG("BC5 max error %d", max_err);
+  }
+
+  // BC7
+  {
+    std::vector<uint8_t> dst;
+    std::string err;
+    TEST_CHECK(CompressImage(img.data(), w, h, 4, TextureCompressionFormat::BC7, &dst, &err));
+    TEST_CHECK(dst.size() == 4 * 16);
+
+    int max_err = 0;
+    for (size_t by = 0; by < 2; by++) {
+      for (size_t bx = 0; bx < 2; bx++) {
+        int rgba[16][4];
+        TEST_CHECK(DecodeBC7Mode6(&dst[(by * 2 + bx) * 16], rgba));
+        for (size_t i = 0; i < 16; i++) {
+          const uint8_t *p = &img[((by * 4 + i / 4) * w + bx * 4 + i % 4) * 4];
+          for (int c = 0; c < 4; c++) {
+            max_err = (std::max)(max_err, std::abs(rgba[i][c] - int(p[c])));
+          }
+        }
+      }
+    }
+    TEST_CHECK(max_err <= 8);
+    TEST_MSG("BC7 max error %d", max_err);
+  }
+
+  // Mip chain of non power-of-two RGB image.
+  {
+    TextureImage image;
+    image.width = 6;
+    image.height = 3;
+    image.channels = 3;
+
+    BufferData src;
+    src.componentType = ComponentType::UInt8;
+    src.data.assign(6 * 3 * 3, 200);
+
+    BufferData dst;
+    std::string err;
+    TEST_CHECK(CompressTextureImage(src, TextureCompressionFormat::BC1, /* mipmaps */true, &image, &dst, &err));
+    TEST_CHECK(image.compressionFormat == TextureCompressionFormat::BC1);
+
+    // 6x3, 3x1, 1x1
+    TEST_CHECK(image.mipLevels.size() == 3);
+    if (image.mipLevels.size() == 3) {
+      TEST_CHECK(image.mipLevels[1].width == 3);
+      TEST_CHECK(image.mipLevels[1].height == 1);
+      TEST_CHECK(image.mipLevels[2].byte_offset == 24);
+    }
+    TEST_CHECK(dst.data.size() == 32);
+
+    // Solid color
+    int rgb[16][3];
+    DecodeBC1(&dst.data[0], rgb);
+    TEST_CHECK(std::abs(rgb[0][0] - 200) <= 4);
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void texture_compress_test(void);
@@ -0,0 +1,90 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "unit-texture-util.h"
+#include "image-util.hh"
+#include "tydra/texture-util.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+void texture_util_test(void) {
+  // Downscaled size
+  {
+    size_t w, h;
+    ComputeDownscaledTextureSize(4096, 1024, 512, &w, &h);
+    TEST_CHECK(w == 512);
+    TEST_CHECK(h == 128);
+
+    ComputeDownscaledTextureSize(3, 3000, 1000, &w, &h);
+    TEST_CHECK(w == 1);
+    TEST_CHECK(h == 1000);
+
+    ComputeDownscaledTextureSize(300, 200, 0, &w, &h);
+    TEST_CHECK(w == 300);
+    TEST_CHECK(h == 200);
+
+    ComputeDownscaledTextureSize(300, 200, 512, &w, &h);
+    TEST_CHECK(w == 300);
+    TEST_CHECK(h == 200);
+  }
+
+  // Resize keeps constant color.
+  {
+    std::vector<uint8_t> src(64 * 32 * 3, 77);
+    std::vector<uint8_t> dst;
+    TEST_CHECK(resize_image_u8_srgb(src, 64, 0, 32, 16, 0, 8, 3, &dst));
+    TEST_CHECK(dst.size() == 16 * 8 * 3);
+    TEST_CHECK(dst[0] == 77);
+    TEST_CHECK(dst[dst.size() - 1] == 77);
+
+    std::vector<float> srcf(64 * 32 * 4, 0.25f);
+    std::vector<float> dstf;
+    TEST_CHECK(resize_image_f32(srcf, 64, 0, 32, 16, 0, 8, 4, &dstf));
+    TEST_CHECK(dstf.size() == 16 * 8 * 4);
+    TEST_CHECK(std::fabs(dstf[5] - 0.25f) < 1.0e-5f);
+
+    // Insufficient input
+    std::string err;
+    TEST_CHECK(!resize_image_u8(src, 128, 0, 32, 16, 0, 8, 3, &dst, &err));
+  }
+
+  // Mip chain of fp32 image.
+  {
+    TextureImage image;
+    image.width = 8;
+    image.height = 2;
+    image.channels = 1;
+
+    std::vector<float> texels(16, 0.5f);
+    BufferData src;
+    src.componentType = ComponentType::Float;
+    src.data.resize(texels.size() * sizeof(float));
+    memcpy(src.data.data(), texels.data(), src.data.size());
+
+    BufferData dst;
+    std::string err;
+    TEST_CHECK(BuildTextureMipChain(src, /* srgb */false, &image, &dst, &err));
+
+    // 8x2, 4x1, 2x1, 1x1
+    TEST_CHECK(image.mipLevels.size() == 4);
+    TEST_CHECK(dst.componentType == ComponentType::Float);
+    TEST_CHECK(dst.data.size() == (16 + 4 + 2 + 1) * sizeof(float));
+    if (image.mipLevels.size() == 4) {
+      TEST_CHECK(image.mipLevels[3].width == 1);
+      TEST_CHECK(image.mipLevels[3].byte_offset == 22 * sizeof(float));
+
+      float f;
+      memcpy(&f, dst.data.data() + image.mipLevels[3].byte_offset, sizeof(float));
+      TEST_CHECK(std::fabs(f - 0.5f) < 1.0e-5f);
+    }
+  }
+}
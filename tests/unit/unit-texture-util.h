@@ -0,0 +1,3 @@
+#pragma once
+
+void texture_util_test(void);
@@ -0,0 +1,95 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "unit-trace.h"
+#include "performance.hh"
+
+using namespace tinyusdz;
+
+void trace_test(void) {
+  if (!performance::IsTraceEnabled()) {
+    // Capture API is no-op.
+    TEST_CHECK(performance::StartTraceCapture() == false);
+    TEST_CHECK(performance::IsTraceCapturing() == false);
+    {
+      performance::ScopedTraceZone zone("disabled");
+    }
+    TEST_CHECK(performance::GetNumTraceEvents() == 0);
+
+    std::string err;
+    TEST_CHECK(performance::WriteChromeTrace("trace.json", &err) == false);
+    TEST_CHECK(!err.empty());
+    return;
+  }
+
+  // Zones outside of capture are not recorded.
+  performance::ClearTraceCapture();
+  {
+    performance::ScopedTraceZone zone("not_captured");
+  }
+  TEST_CHECK(performance::GetNumTraceEvents() == 0);
+
+  // Start capture from multiple threads for the first time.
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([]() { performance::StartTraceCapture(); });
+    }
+    for (auto &th : threads) {
+      th.join();
+    }
+  }
+  TEST_CHECK(performance::IsTraceCapturing() == true);
+
+  {
+    performance::ScopedTraceZone zone("main");
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; i++) {
+      threads.emplace_back([]() {
+        for (int k = 0; k < 10; k++) {
+          performance::ScopedTraceZone worker_zone("worker");
+        }
+      });
+    }
+    for (auto &th : threads) {
+      th.join();
+    }
+  }
+
+  TEST_CHECK(performance::StopTraceCapture() == true);
+  TEST_CHECK(performance::IsTraceCapturing() == false);
+  TEST_CHECK(performance::GetNumTraceEvents() == 31);
+  TEST_MSG("# of events = %d", int(performance::GetNumTraceEvents()));
+  TEST_CHECK(performance::GetNumDroppedTraceEvents() == 0);
+
+  std::string json = performance::ExportChromeTrace();
+  TEST_CHECK(json.find("\"traceEvents\"") != std::string::npos);
+  TEST_CHECK(json.find("\"name\":\"main\"") != std::string::npos);
+  TEST_CHECK(json.find("\"name\":\"worker\"") != std::string::npos);
+  TEST_CHECK(json.find("\"thread_name\"") != std::string::npos);
+
+  // Buffer capacity
+  size_t capacity = performance::GetTraceBufferCapacity();
+  performance::SetTraceBufferCapacity(5);
+  performance::StartTraceCapture();
+  for (int k = 0; k < 8; k++) {
+    performance::ScopedTraceZone zone("capped");
+  }
+  performance::StopTraceCapture();
+  TEST_CHECK(performance::GetNumTraceEvents() == 5);
+  TEST_CHECK(performance::GetNumDroppedTraceEvents() == 3);
+  performance::SetTraceBufferCapacity(capacity);
+
+  performance::ClearTraceCapture();
+  TEST_CHECK(performance::GetNumTraceEvents() == 0);
+  TEST_CHECK(performance::GetNumDroppedTraceEvents() == 0);
+}
@@ -0,0 +1,99 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <string>
+
+#include "unit-tydra-triangulate.h"
+#include "tinyusdz.hh"
+#include "tydra/render-data.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+namespace {
+
+// Triangle, convex quad, concave quad(reflex at corner 1), convex pentagon and
+// concave hexagon(L shape) on XY plane. All faces are counter-clockwise.
+const char *kPolygonsUSDA = R"(#usda 1.0
+def Mesh "polygons" {
+  int[] faceVertexCounts = [3, 4, 4, 5, 6]
+  int[] faceVertexIndices = [0, 1, 2,  3, 4, 5, 6,  7, 8, 9, 10,  11, 12, 13, 14, 15,  16, 17, 18, 19, 20, 21]
+  point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0),
+    (0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0),
+    (0, 0, 0), (0.5, 0.25, 0), (1, 0, 0), (0.5, 1, 0),
+    (0, 0, 0), (1, 0, 0), (1.5, 1, 0), (0.5, 1.5, 0), (-0.5, 1, 0),
+    (0, 0, 0), (2, 0, 0), (2, 1, 0), (1, 1, 0), (1, 2, 0), (0, 2, 0)]
+}
+)";
+
+}  // namespace
+
+void tydra_triangulate_test(void) {
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(
+      reinterpret_cast<const uint8_t *>(kPolygonsUSDA), strlen(kPolygonsUSDA),
+      "", &stage, &warn, &err);
+  TEST_CHECK(ret == true);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+
+  RenderSceneConverterEnv env(stage);
+  env.mesh_config.build_vertex_indices = false;
+  env.mesh_config.compute_normals = false;
+  env.mesh_config.compute_tangents_and_binormals = false;
+
+  RenderSceneConverter converter;
+  RenderScene scene;
+  ret = converter.ConvertToRenderScene(env, &scene);
+  TEST_CHECK(ret == true);
+  TEST_MSG("%s", converter.GetError().c_str());
+  if (!ret) {
+    return;
+  }
+
+  TEST_CHECK(scene.meshes.size() == 1);
+  if (scene.meshes.size() != 1) {
+    return;
+  }
+  const RenderMesh &mesh = scene.meshes[0];
+
+  // n - 2 triangles per face.
+  TEST_CHECK(mesh.triangulatedFaceCounts.size() == 5);
+  TEST_CHECK(mesh.triangulatedFaceVertexCounts.size() == (1 + 2 + 2 + 3 + 4));
+  TEST_CHECK(mesh.triangulatedFaceVertexIndices.size() ==
+             3 * mesh.triangulatedFaceVertexCounts.size());
+  TEST_CHECK(mesh.triangulatedToOrigFaceVertexIndexMap.size() ==
+             mesh.triangulatedFaceVertexIndices.size());
+
+  const uint32_t expected_counts[5] = {1, 2, 2, 3, 4};
+  const float expected_areas[5] = {0.5f, 1.0f, 0.375f, 2.0f, 3.0f};
+
+  size_t tri = 0;
+  for (size_t f = 0; f < 5; f++) {
+    TEST_CHECK(mesh.triangulatedFaceCounts[f] == expected_counts[f]);
+
+    // Triangles keep the winding and cover the polygon: signed areas are all
+    // positive and sum up to the polygon area.
+    float area = 0.0f;
+    for (uint32_t k = 0; k < mesh.triangulatedFaceCounts[f]; k++, tri++) {
+      const vec3 &p0 = mesh.points[mesh.triangulatedFaceVertexIndices[3 * tri + 0]];
+      const vec3 &p1 = mesh.points[mesh.triangulatedFaceVertexIndices[3 * tri + 1]];
+      const vec3 &p2 = mesh.points[mesh.triangulatedFaceVertexIndices[3 * tri + 2]];
+      float a = 0.5f * ((p1[0] - p0[0]) * (p2[1] - p0[1]) -
+                        (p2[0] - p0[0]) * (p1[1] - p0[1]));
+      TEST_CHECK(a > 0.0f);
+      area += a;
+    }
+    TEST_CHECK(std::fabs(area - expected_areas[f]) < 1e-5f);
+    TEST_MSG("face %d: area %f, expected %f", int(f), double(area),
+             double(expected_areas[f]));
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void tydra_triangulate_test(void);
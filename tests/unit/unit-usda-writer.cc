@@ -0,0 +1,82 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include "unit-usda-writer.h"
+#include "prim-types.hh"
+#include "usdGeom.hh"
+#include "stage.hh"
+#include "usda-writer.hh"
+
+using namespace tinyusdz;
+
+static bool AppendToString(const char *data, size_t nbytes, void *userdata, std::string *err) {
+  (void)err;
+  std::string *dst = reinterpret_cast<std::string *>(userdata);
+  dst->append(data, nbytes);
+  return true;
+}
+
+static bool AbortWrite(const char *data, size_t nbytes, void *userdata, std::string *err) {
+  (void)data;
+  (void)nbytes;
+  (void)userdata;
+  (*err) = "abort";
+  return false;
+}
+
+void usda_writer_test(void) {
+
+  Stage stage;
+  stage.metas().upAxis = Axis::Y;
+
+  for (size_t r = 0; r < 3; r++) {
+    Xform xform;
+    xform.name = "root" + std::to_string(r);
+
+    Prim xformPrim(xform);
+
+    for (size_t c = 0; c < 5; c++) {
+      GeomMesh mesh;
+      mesh.name = "mesh" + std::to_string(c);
+      std::vector<value::point3f> pts;
+      pts.push_back({0.0f, 0.0f, float(c)});
+      pts.push_back({1.0f, 0.0f, float(c)});
+      pts.push_back({1.0f, 1.0f, float(c)});
+      mesh.points.set_value(pts);
+
+      xformPrim.children().emplace_back(Prim(mesh));
+    }
+
+    stage.root_prims().emplace_back(std::move(xformPrim));
+  }
+
+  std::string expected = stage.ExportToString();
+
+  // Use tiny buffers to exercise flushing and batching.
+  const size_t buffer_sizes[] = {1, 7, 64, 1024 * 1024};
+  for (size_t buffer_size : buffer_sizes) {
+    for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      usda::USDAWriterConfig config;
+      config.buffer_size = buffer_size;
+      config.num_threads = num_threads;
+
+      std::string s;
+      std::string warn;
+      std::string err;
+      TEST_CHECK(usda::SaveAsUSDAToCallback(stage, AppendToString, &s, &warn, &err, config));
+      TEST_CHECK(s == expected);
+      TEST_MSG("buffer_size %d, num_threads %d", int(buffer_size), num_threads);
+    }
+  }
+
+  {
+    std::string warn;
+    std::string err;
+    TEST_CHECK(!usda::SaveAsUSDAToCallback(stage, AbortWrite, nullptr, &warn, &err));
+    TEST_CHECK(err.find("abort") != std::string::npos);
+  }
+}
@@ -0,0 +1,187 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "unit-usdz-writer.h"
+#include "prim-types.hh"
+#include "usdGeom.hh"
+#include "stage.hh"
+#include "io-util.hh"
+#include "usdz-writer.hh"
+
+using namespace tinyusdz;
+
+static bool AppendToVector(const uint8_t *data, size_t nbytes, void *userdata, std::string *err) {
+  (void)err;
+  std::vector<uint8_t> *dst = reinterpret_cast<std::vector<uint8_t> *>(userdata);
+  dst->insert(dst->end(), data, data + nbytes);
+  return true;
+}
+
+static uint32_t ReadU32(const uint8_t *p) {
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+void usdz_writer_test(void) {
+
+  // CRC32
+  {
+    const char *s = "123456789";
+    TEST_CHECK(usdz::UpdateCRC32(0, reinterpret_cast<const uint8_t *>(s), 9) == 0xcbf43926u);
+    TEST_CHECK(usdz::ComputeCRC32(nullptr, 0) == 0);
+
+    std::vector<uint8_t> buf(3 * 1024 * 1024 + 13);
+    for (size_t i = 0; i < buf.size(); i++) {
+      buf[i] = uint8_t((i * 2654435761ull) >> 24);
+    }
+
+    uint32_t ref = usdz::UpdateCRC32(0, buf.data(), buf.size());
+    for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+      TEST_CHECK(usdz::ComputeCRC32(buf.data(), buf.size(), num_threads) == ref);
+    }
+
+    const size_t splits[] = {0, 1, 7, 1000, buf.size() - 1};
+    for (size_t split : splits) {
+      uint32_t a = usdz::UpdateCRC32(0, buf.data(), split);
+      uint32_t b = usdz::UpdateCRC32(0, buf.data() + split, buf.size() - split);
+      TEST_CHECK(usdz::CombineCRC32(a, b, buf.size() - split) == ref);
+      TEST_CHECK(usdz::UpdateCRC32(a, buf.data() + split, buf.size() - split) == ref);
+    }
+  }
+
+  Stage stage;
+  stage.metas().upAxis = Axis::Y;
+  for (size_t r = 0; r < 3; r++) {
+    GeomMesh mesh;
+    mesh.name = "mesh" + std::to_string(r);
+    std::vector<value::point3f> pts;
+    pts.push_back({0.0f, 0.0f, float(r)});
+    pts.push_back({1.0f, 0.0f, float(r)});
+    pts.push_back({1.0f, 1.0f, float(r)});
+    mesh.points.set_value(pts);
+    stage.root_prims().emplace_back(Prim(mesh));
+  }
+
+  std::vector<uint8_t> tex0(1000);
+  std::vector<uint8_t> tex1(70001);
+  for (size_t i = 0; i < tex0.size(); i++) {
+    tex0[i] = uint8_t(i * 7);
+  }
+  for (size_t i = 0; i < tex1.size(); i++) {
+    tex1[i] = uint8_t(i * 13 + 1);
+  }
+
+  const std::string asset_filename = "unit-usdz-writer-asset.bin";
+  TEST_CHECK(io::WriteWholeFile(asset_filename, tex1.data(), tex1.size(), nullptr));
+
+  std::vector<usdz::USDZEntry> assets(3);
+  assets[0].name = "textures/a.png";
+  assets[0].data = tex0.data();
+  assets[0].size = tex0.size();
+  assets[1].name = "textures/bb.bin";
+  assets[1].filename = asset_filename;
+  assets[2].name = "empty.txt";
+
+  usdz::USDZWriterConfig config;
+  config.buffer_size = 4096; // stream the file asset in small chunks
+  config.num_threads = 2;
+  config.root_layer_name = "scene.usda";
+
+  std::vector<uint8_t> usdz_data;
+  {
+    std::string warn;
+    std::string err;
+    bool ret = usdz::SaveAsUSDZToCallback(stage, assets, AppendToVector, &usdz_data, &warn, &err, config);
+    TEST_CHECK(ret);
+    TEST_MSG("%s", err.c_str());
+  }
+
+  {
+    USDZAsset usdz_asset;
+    std::string warn;
+    std::string err;
+    TEST_CHECK(ReadUSDZAssetInfoFromMemory(usdz_data.data(), usdz_data.size(), true, &usdz_asset, &warn, &err));
+    TEST_CHECK(usdz_asset.asset_map.size() == 4);
+
+    for (const auto &item : usdz_asset.asset_map) {
+      TEST_CHECK((item.second.first % 64) == 0);
+
+      // CRC32 in the local file header.
+      size_t header = item.second.first;
+      while (ReadU32(&usdz_data[header]) != 0x04034b50u) {
+        header--;
+      }
+      uint32_t crc = usdz::ComputeCRC32(usdz_data.data() + item.second.first, item.second.second - item.second.first);
+      TEST_CHECK(ReadU32(&usdz_data[header + 14]) == crc);
+    }
+
+    TEST_CHECK(usdz_asset.asset_map.count("scene.usda"));
+    TEST_CHECK(usdz_asset.asset_map.count("empty.txt"));
+
+    const auto &a = usdz_asset.asset_map["textures/a.png"];
+    TEST_CHECK((a.second - a.first) == tex0.size());
+    TEST_CHECK(memcmp(usdz_data.data() + a.first, tex0.data(), tex0.size()) == 0);
+
+    const auto &b = usdz_asset.asset_map["textures/bb.bin"];
+    TEST_CHECK((b.second - b.first) == tex1.size());
+    TEST_CHECK(memcmp(usdz_data.data() + b.first, tex1.data(), tex1.size()) == 0);
+  }
+
+  {
+    Stage loaded;
+    std::string warn;
+    std::string err;
+    bool ret = LoadUSDZFromMemory(usdz_data.data(), usdz_data.size(), "test.usdz", &loaded, &warn, &err);
+    TEST_CHECK(ret);
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(loaded.root_prims().size() == 3);
+  }
+
+  // File output(local file headers are patched after streaming) must be
+  // identical to the callback output.
+  {
+    const std::string usdz_filename = "unit-usdz-writer-output.usdz";
+    std::string warn;
+    std::string err;
+    TEST_CHECK(usdz::SaveAsUSDZ(usdz_filename, stage, assets, &warn, &err, config));
+
+    std::vector<uint8_t> file_data;
+    TEST_CHECK(io::ReadWholeFile(&file_data, &err, usdz_filename));
+    TEST_CHECK(file_data == usdz_data);
+
+    std::remove(usdz_filename.c_str());
+  }
+
+  // Packaging files. The first entry must be a USD file.
+  {
+    std::vector<usdz::USDZEntry> entries = assets;
+    std::vector<uint8_t> out;
+    std::string warn;
+    std::string err;
+    TEST_CHECK(!usdz::PackUSDZToCallback(entries, AppendToVector, &out, &warn, &err, config));
+
+    std::string layer = "#usda 1.0\n";
+    usdz::USDZEntry root;
+    root.name = "root.usda";
+    root.data = reinterpret_cast<const uint8_t *>(layer.data());
+    root.size = layer.size();
+    entries.insert(entries.begin(), root);
+
+    out.clear();
+    err.clear();
+    TEST_CHECK(usdz::PackUSDZToCallback(entries, AppendToVector, &out, &warn, &err, config));
+
+    // Duplicated name
+    entries.push_back(entries[1]);
+    TEST_CHECK(!usdz::PackUSDZToCallback(entries, AppendToVector, &out, &warn, &err, config));
+    TEST_CHECK(err.find("Duplicated") != std::string::npos);
+  }
+
+  std::remove(asset_filename.c_str());
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void usdz_writer_test(void);
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "tinyusdz.hh"
+#include "tydra/progressive-loader.hh"
 #include "tydra/render-data.hh"
 #include "tydra/scene-access.hh"
 
@@ -47,6 +48,51 @@ bool ToRGBA(const std::vector<uint8_t> &src, int channels,
   return true;
 }
 
+emscripten::val ToMesh(const tinyusdz::tydra::RenderMesh &rmesh) {
+  emscripten::val mesh = emscripten::val::object();
+
+  // TODO: Use three.js scene description format?
+  mesh.set("prim_name", rmesh.prim_name);
+  mesh.set("display_name", rmesh.prim_name);
+  mesh.set("abs_path", rmesh.abs_path);
+  const uint32_t *indices_ptr = rmesh.faceVertexIndices().data();
+  mesh.set("faceVertexIndices", emscripten::typed_memory_view(rmesh.faceVertexIndices().size(), indices_ptr));
+  const uint32_t *counts_ptr = rmesh.faceVertexCounts().data();
+  mesh.set("faceVertexCounts", emscripten::typed_memory_view(rmesh.faceVertexCounts().size(), counts_ptr));
+  const float *points_ptr = reinterpret_cast<const float *>(rmesh.points.data());
+  // vec3
+  mesh.set("points", emscripten::typed_memory_view(rmesh.points.size() * 3, points_ptr)); 
+
+  {
+    // slot 0 hardcoded.
+    uint32_t uvSlotId = 0;
+    if (rmesh.texcoords.count(uvSlotId)) {
+      const float *uvs_ptr = reinterpret_cast<const float *>(rmesh.texcoords.at(uvSlotId).data.data());
+
+      // assume vec2
+      mesh.set("texcoords", emscripten::typed_memory_view(rmesh.texcoords.at(uvSlotId).vertex_count() * 2, uvs_ptr)); 
+    }
+  }
+
+  mesh.set("materialId", rmesh.material_id);
+
+  return mesh;
+}
+
+emscripten::val ToImage(const tinyusdz::tydra::TextureImage &i,
+                        const uint8_t *texels, size_t texels_size) {
+  emscripten::val img = emscripten::val::object();
+
+  // TODO: Support HDR
+
+  img.set("data", emscripten::typed_memory_view(texels_size, texels));
+  img.set("width", int(i.width));
+  img.set("height", int(i.height));
+  img.set("channels", int(i.channels));
+
+  return img;
+}
+
 }
 
 ///
@@ -174,13 +220,7 @@ class TinyUSDZLoader {
 
     if ((i.buffer_id >= 0) && (i.buffer_id < render_scene_.buffers.size())) {
       const auto &b = render_scene_.buffers[i.buffer_id];
-
-      // TODO: Support HDR
-      
-      img.set("data", emscripten::typed_memory_view(b.data.size(), b.data.data()));
-      img.set("width", int(i.width));
-      img.set("height", int(i.height));
-      img.set("channels", int(i.channels));
+      img = detail::ToImage(i, b.data.data(), b.data.size());
     }
 
 
@@ -198,35 +238,7 @@ class TinyUSDZLoader {
       return mesh;
     }
 
-    const tinyusdz::tydra::RenderMesh &rmesh = render_scene_.meshes[size_t(mesh_id)];
-
-    // TODO: Use three.js scene description format?
-    mesh.set("prim_name", rmesh.prim_name);
-    mesh.set("display_name", rmesh.prim_name);
-    mesh.set("abs_path", rmesh.abs_path);
-    const uint32_t *indices_ptr = rmesh.faceVertexIndices().data();
-    mesh.set("faceVertexIndices", emscripten::typed_memory_view(rmesh.faceVertexIndices().size(), indices_ptr));
-    const uint32_t *counts_ptr = rmesh.faceVertexCounts().data();
-    mesh.set("faceVertexCounts", emscripten::typed_memory_view(rmesh.faceVertexCounts().size(), counts_ptr));
-    const float *points_ptr = reinterpret_cast<const float *>(rmesh.points.data());
-    // vec3
-    mesh.set("points", emscripten::typed_memory_view(rmesh.points.size() * 3, points_ptr)); 
-
-    {
-      // slot 0 hardcoded.
-      uint32_t uvSlotId = 0;
-      if (rmesh.texcoords.count(uvSlotId)) {
-        const float *uvs_ptr = reinterpret_cast<const float *>(rmesh.texcoords.at(uvSlotId).data.data());
-
-        // assume vec2
-        mesh.set("texcoords", emscripten::typed_memory_view(rmesh.texcoords.at(uvSlotId).vertex_count() * 2, uvs_ptr)); 
-      }
-    }
-
-    mesh.set("materialId", rmesh.material_id);
-
-
-    return mesh;
+    return detail::ToMesh(render_scene_.meshes[size_t(mesh_id)]);
   }
 
   bool ok() const { return loaded_; }
@@ -242,6 +254,123 @@ class TinyUSDZLoader {
   tinyusdz::USDZAsset usdz_asset_;
 };
 
+///
+/// Progressive loader. USD is parsed and converted on a worker thread(when
+/// built with pthreads. see `TINYUSDZ_WASM_PTHREADS` in CMakeLists.txt), and
+/// converted meshes and texture images are received through `pollEvent` while
+/// the conversion is running, so the main thread(browser tab) is not blocked.
+///
+/// JS usage:
+///
+///   const loader = new TinyUSDZ.TinyUSDZProgressiveLoader();
+///   loader.start(usd_binary, "scene.usdz");
+///
+///   // In the animation loop.
+///   let ev;
+///   while ((ev = loader.pollEvent()) !== null) {
+///     if (ev.type === "mesh") { /* ev.mesh */ } else { /* ev.image */ }
+///   }
+///   console.log(loader.progress());
+///
+class TinyUSDZProgressiveLoader {
+ public:
+  TinyUSDZProgressiveLoader() = default;
+  ~TinyUSDZProgressiveLoader() {}
+
+  ///
+  /// Start loading. `binary` is copied, so JS can release it after this call.
+  ///
+  bool start(const std::string &binary, const std::string &filename) {
+    tinyusdz::tydra::ProgressiveLoaderConfig config;
+    config.material_config.preserve_texel_bitdepth = true;
+
+    std::vector<uint8_t> data(binary.begin(), binary.end());
+
+    return loader_.Start(std::move(data),
+                         filename.empty() ? "dummy.usda" : filename, config,
+                         &error_);
+  }
+
+  ///
+  /// Pop converted mesh or texture image. Returns `null` when no event is
+  /// available.
+  ///
+  /// Array views in the returned object refer to the data owned by the
+  /// loader and are valid while the loader is alive.
+  ///
+  emscripten::val pollEvent() {
+    if (!loader_.PollEvent(&event_)) {
+      return emscripten::val::null();
+    }
+
+    emscripten::val ev = emscripten::val::object();
+    ev.set("id", double(event_.id));
+
+    if (event_.type == tinyusdz::tydra::ProgressiveLoaderEvent::Type::Mesh) {
+      ev.set("type", std::string("mesh"));
+      ev.set("mesh", detail::ToMesh(*event_.mesh));
+    } else {
+      ev.set("type", std::string("image"));
+      ev.set("image", detail::ToImage(event_.image, event_.texels,
+                                      event_.texels_size));
+    }
+
+    return ev;
+  }
+
+  emscripten::val progress() const {
+    const tinyusdz::tydra::ProgressiveLoaderProgress p = loader_.GetProgress();
+
+    emscripten::val ret = emscripten::val::object();
+    ret.set("state", tinyusdz::tydra::to_string(p.state));
+    ret.set("inputBytes", double(p.input_bytes));
+    ret.set("numMeshesTotal", double(p.num_meshes_total));
+    ret.set("numMeshesConverted", double(p.num_meshes_converted));
+    ret.set("numImagesLoaded", double(p.num_images_loaded));
+
+    return ret;
+  }
+
+  void cancel() { loader_.Cancel(); }
+
+  bool finished() const { return loader_.IsFinished(); }
+
+  bool ok() const {
+    return loader_.GetProgress().state ==
+           tinyusdz::tydra::ProgressiveLoaderState::Done;
+  }
+
+  const std::string error() const {
+    if (!finished()) {
+      return error_;
+    }
+    return error_ + loader_.GetError();
+  }
+
+  // RenderScene accessors. Valid after the loading has been finished.
+
+  int numMeshes() const {
+    if (!ok()) {
+      return 0;
+    }
+    return int(loader_.GetRenderScene().meshes.size());
+  }
+
+  emscripten::val getMesh(int mesh_id) const {
+    if (!ok() || (mesh_id < 0) ||
+        (size_t(mesh_id) >= loader_.GetRenderScene().meshes.size())) {
+      return emscripten::val::object();
+    }
+
+    return detail::ToMesh(loader_.GetRenderScene().meshes[size_t(mesh_id)]);
+  }
+
+ private:
+  tinyusdz::tydra::ProgressiveLoader loader_;
+  tinyusdz::tydra::ProgressiveLoaderEvent event_;
+  std::string error_;
+};
+
 // Register STL
 EMSCRIPTEN_BINDINGS(stl_wrappters) {
   register_vector<float>("VectorFloat");
@@ -259,4 +388,16 @@ EMSCRIPTEN_BINDINGS(tinyusdz_module) {
       .function("getImage", &TinyUSDZLoader::getImage)
       .function("ok", &TinyUSDZLoader::ok)
       .function("error", &TinyUSDZLoader::error);
+
+  class_<TinyUSDZProgressiveLoader>("TinyUSDZProgressiveLoader")
+      .constructor<>()
+      .function("start", &TinyUSDZProgressiveLoader::start)
+      .function("pollEvent", &TinyUSDZProgressiveLoader::pollEvent)
+      .function("progress", &TinyUSDZProgressiveLoader::progress)
+      .function("cancel", &TinyUSDZProgressiveLoader::cancel)
+      .function("finished", &TinyUSDZProgressiveLoader::finished)
+      .function("ok", &TinyUSDZProgressiveLoader::ok)
+      .function("error", &TinyUSDZProgressiveLoader::error)
+      .function("numMeshes", &TinyUSDZProgressiveLoader::numMeshes)
+      .function("getMesh", &TinyUSDZProgressiveLoader::getMesh);
 }